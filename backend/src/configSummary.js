@@ -0,0 +1,67 @@
+const fs = require('fs');
+const { createHash } = require('crypto');
+const { execFile } = require('child_process');
+
+// The native tool runs the simulator's own XML loader; see tools/trdp_config_summary.cpp.
+const summaryBinary = process.env.TRDP_CONFIG_SUMMARY || 'trdp_config_summary';
+const maxCachedSummaries = 64;
+
+const cache = new Map();
+const pending = new Map();
+
+function runSummaryTool(filePath) {
+  return new Promise((resolve, reject) => {
+    execFile(summaryBinary, [filePath], { maxBuffer: 64 * 1024 * 1024 }, (error, stdout, stderr) => {
+      // Exit status 1 is a configuration with errors: the summary lists them and is still served.
+      if (error && error.code !== 1) {
+        reject(new Error(`${summaryBinary} failed: ${stderr.trim() || error.message}`));
+        return;
+      }
+      try {
+        resolve(JSON.parse(stdout));
+      } catch (parseError) {
+        reject(new Error(`${summaryBinary} printed no summary: ${parseError.message}`));
+      }
+    });
+  });
+}
+
+function remember(hash, summary) {
+  // Map order is insertion order, so the first key is the least recently used.
+  cache.delete(hash);
+  cache.set(hash, summary);
+  if (cache.size > maxCachedSummaries) {
+    cache.delete(cache.keys().next().value);
+  }
+}
+
+/**
+ * Summary of the configuration at `filePath`, cached by the SHA-256 of its content, so a file is
+ * parsed once however often it is asked for and under however many names it was uploaded.
+ * Parsing runs in a child process and never blocks the event loop; concurrent requests for the
+ * same content share one run.
+ */
+async function loadSummary(filePath) {
+  const content = await fs.promises.readFile(filePath);
+  const hash = createHash('sha256').update(content).digest('hex');
+
+  const cached = cache.get(hash);
+  if (cached) {
+    remember(hash, cached);
+    return cached;
+  }
+
+  let run = pending.get(hash);
+  if (!run) {
+    run = runSummaryTool(filePath)
+      .then((summary) => {
+        remember(hash, summary);
+        return summary;
+      })
+      .finally(() => pending.delete(hash));
+    pending.set(hash, run);
+  }
+  return run;
+}
+
+module.exports = { loadSummary };
@@ -1,7 +1,20 @@
-class EngineController {
-  constructor() {
+const net = require('net');
+const { EventEmitter } = require('events');
+
+/**
+ * Talks to the simulator's control socket (`trdp_simulator --control PATH`, JSON lines).
+ * Replies arrive in request order, so pending requests are kept in a FIFO; `{"event":...}`
+ * lines are state deltas and are emitted as `delta` events instead.
+ */
+class EngineController extends EventEmitter {
+  constructor(socketPath = process.env.TRDP_CONTROL_SOCKET || '/tmp/trdp_simulator.sock') {
+    super();
+    this.socketPath = socketPath;
     this.activeConfig = null;
     this.running = false;
+    this.socket = null;
+    this.buffer = '';
+    this.pending = [];
   }
 
   async loadConfig(xmlContent) {
@@ -13,6 +26,69 @@ class EngineController {
     await new Promise((resolve) => setTimeout(resolve, 25));
     this.running = true;
   }
+
+  connect() {
+    if (this.socket) {
+      return this.socket;
+    }
+
+    const socket = net.createConnection(this.socketPath);
+    socket.setEncoding('utf8');
+    socket.on('data', (chunk) => this.onData(chunk));
+    socket.on('error', (error) => this.onClose(error));
+    socket.on('close', () => this.onClose(new Error('Control socket closed.')));
+    this.socket = socket;
+    return socket;
+  }
+
+  onData(chunk) {
+    this.buffer += chunk;
+    let newline = this.buffer.indexOf('\n');
+    while (newline !== -1) {
+      const line = this.buffer.slice(0, newline);
+      this.buffer = this.buffer.slice(newline + 1);
+      newline = this.buffer.indexOf('\n');
+
+      let message;
+      try {
+        message = JSON.parse(line);
+      } catch (error) {
+        console.error('Invalid reply on the control socket', error);
+        continue;
+      }
+      if (message && message.event) {
+        this.emit('delta', message);
+      } else if (this.pending.length > 0) {
+        this.pending.shift().resolve(message);
+      }
+    }
+  }
+
+  onClose(error) {
+    if (!this.socket) {
+      return;
+    }
+    this.socket.destroy();
+    this.socket = null;
+    this.buffer = '';
+    for (const { reject } of this.pending.splice(0)) {
+      reject(error);
+    }
+  }
+
+  /** Sends one operation or an array of them as a single batch; resolves with the reply. */
+  request(operations) {
+    const socket = this.connect();
+    return new Promise((resolve, reject) => {
+      this.pending.push({ resolve, reject });
+      socket.write(`${JSON.stringify(operations)}\n`);
+    });
+  }
+
+  /** Starts `delta` events every `intervalMs`; only telegrams that changed are included. */
+  subscribe(intervalMs = 100, payloads = false) {
+    return this.request({ op: 'subscribe', intervalMs, payloads });
+  }
 }
 
 module.exports = new EngineController();
@@ -0,0 +1,196 @@
+const fs = require('fs');
+const { EventEmitter } = require('events');
+
+// Layout of the simulator's `--state-export` segment; see src/shard/state_export.h.
+const MAGIC = 0x53445054;
+const VERSION = 1;
+const HEADER_BYTES = 64;
+const DESCRIPTOR_BYTES = 32;
+const PAYLOAD_BYTES = 1432;
+const DIRECTIONS = ['Unknown', 'Outgoing', 'Incoming', 'Loopback'];
+
+const nsToMs = (ns) => Number(ns / 1000000n);
+
+/**
+ * Polls /dev/shm/NAME and emits `delta` with the telegrams whose slots changed since the last
+ * poll. Changes between two polls are coalesced into the latest state, so the update rate is
+ * bounded by `intervalMs` however fast the simulator runs; an idle poll reads only the header.
+ */
+class PdStateReader extends EventEmitter {
+  constructor({ name, intervalMs = 200 }) {
+    super();
+    this.path = `/dev/shm/${name}`;
+    this.intervalMs = intervalMs;
+    this.timer = null;
+    this.fd = null;
+    this.inode = null;
+    this.layout = null;
+    this.generation = -1n;
+    this.sequences = [];
+    this.telegrams = [];
+  }
+
+  start() {
+    if (!this.timer) {
+      this.timer = setInterval(() => this.poll(), this.intervalMs);
+      this.timer.unref();
+      this.poll();
+    }
+  }
+
+  stop() {
+    clearInterval(this.timer);
+    this.timer = null;
+    this.close();
+  }
+
+  /** Every telegram as last read; empty while no simulator exports. */
+  snapshot() {
+    return this.telegrams.filter(Boolean);
+  }
+
+  connected() {
+    return this.layout !== null;
+  }
+
+  close() {
+    if (this.fd !== null) {
+      fs.closeSync(this.fd);
+    }
+    const wasConnected = this.layout !== null;
+    this.fd = null;
+    this.inode = null;
+    this.layout = null;
+    this.generation = -1n;
+    this.sequences = [];
+    this.telegrams = [];
+    if (wasConnected) {
+      this.emit('reset');
+    }
+  }
+
+  read(length, position) {
+    const buffer = Buffer.allocUnsafe(length);
+    fs.readSync(this.fd, buffer, 0, length, position);
+    return buffer;
+  }
+
+  /** Opens the segment, or reopens it after the simulator restarted and replaced it. */
+  attach() {
+    let inode;
+    try {
+      inode = fs.statSync(this.path).ino;
+    } catch {
+      this.close();
+      return false;
+    }
+    if (this.layout !== null && inode === this.inode) {
+      return true;
+    }
+
+    this.close();
+    this.fd = fs.openSync(this.path, 'r');
+    this.inode = inode;
+    const header = this.read(HEADER_BYTES, 0);
+    if (header.readUInt32LE(0) !== MAGIC || header.readUInt32LE(4) !== VERSION) {
+      // Not set up yet, or another version: try again on the next poll.
+      this.close();
+      return false;
+    }
+
+    const layout = {
+      slotCount: header.readUInt32LE(8),
+      stride: header.readUInt32LE(12),
+      descriptorOffset: header.readUInt32LE(16),
+      sequenceOffset: header.readUInt32LE(20),
+      slotOffset: header.readUInt32LE(24),
+      descriptors: [],
+    };
+    const table = this.read(layout.slotCount * DESCRIPTOR_BYTES, layout.descriptorOffset);
+    for (let slot = 0; slot < layout.slotCount; slot += 1) {
+      const base = slot * DESCRIPTOR_BYTES;
+      const name = table.subarray(base + 12, base + 32);
+      const end = name.indexOf(0);
+      layout.descriptors.push({
+        comId: table.readUInt32LE(base),
+        datasetId: table.readUInt32LE(base + 4),
+        direction: DIRECTIONS[table.readUInt8(base + 8)] || 'Unknown',
+        interface: name.subarray(0, end === -1 ? name.length : end).toString('utf8'),
+      });
+    }
+    this.layout = layout;
+    this.sequences = new Array(layout.slotCount).fill(-1);
+    this.telegrams = new Array(layout.slotCount).fill(null);
+    return true;
+  }
+
+  decode(slot, bytes) {
+    const descriptor = this.layout.descriptors[slot];
+    const txSize = Math.min(bytes.readUInt16LE(48), PAYLOAD_BYTES);
+    const rxSize = Math.min(bytes.readUInt16LE(50), PAYLOAD_BYTES);
+    const linkLost = bytes.readUInt8(53) !== 0;
+    const lastReceive = bytes.readUInt8(56) !== 0 ? nsToMs(bytes.readBigInt64LE(32)) : null;
+    return {
+      slot,
+      ...descriptor,
+      publishing: bytes.readUInt8(52) !== 0,
+      publishCount: Number(bytes.readBigUInt64LE(0)),
+      receiveCount: Number(bytes.readBigUInt64LE(8)),
+      linkLost,
+      linkLostCount: Number(bytes.readBigUInt64LE(16)),
+      destinations: bytes.readUInt32LE(40),
+      fixedPayloadSize: bytes.readUInt8(54) !== 0 ? bytes.readUInt32LE(44) : null,
+      lastPublish: bytes.readUInt8(55) !== 0 ? nsToMs(bytes.readBigInt64LE(24)) : null,
+      lastReceive,
+      lastRxTime: lastReceive,
+      status: linkLost ? 'Timeout' : 'OK',
+      tx: bytes.subarray(64, 64 + txSize).toString('hex'),
+      rx: bytes.subarray(64 + PAYLOAD_BYTES, 64 + PAYLOAD_BYTES + rxSize).toString('hex'),
+    };
+  }
+
+  poll() {
+    try {
+      if (!this.attach()) {
+        return;
+      }
+
+      const generation = this.read(8, 40).readBigUInt64LE(0);
+      if (generation === this.generation) {
+        return;
+      }
+
+      // A slot is taken only if its sequence was even before and after the copy.
+      const { slotCount, stride, sequenceOffset, slotOffset } = this.layout;
+      const sequences = this.read(slotCount * 4, sequenceOffset);
+      const changed = [];
+      let complete = true;
+      for (let slot = 0; slot < slotCount; slot += 1) {
+        const sequence = sequences.readUInt32LE(slot * 4);
+        if (sequence === this.sequences[slot]) {
+          continue;
+        }
+        const bytes = (sequence & 1) === 0 ? this.read(stride, slotOffset + slot * stride) : null;
+        if (bytes === null || this.read(4, sequenceOffset + slot * 4).readUInt32LE(0) !== sequence) {
+          complete = false;
+          continue;
+        }
+        this.sequences[slot] = sequence;
+        this.telegrams[slot] = this.decode(slot, bytes);
+        changed.push(this.telegrams[slot]);
+      }
+      // Slots caught mid-write are read again on the next poll even if nothing else changes.
+      if (complete) {
+        this.generation = generation;
+      }
+      if (changed.length > 0) {
+        this.emit('delta', changed);
+      }
+    } catch (error) {
+      console.error('Failed to read the PD state export', error);
+      this.close();
+    }
+  }
+}
+
+module.exports = PdStateReader;
@@ -3,8 +3,9 @@ const multer = require('multer');
 const fs = require('fs');
 const path = require('path');
 const { randomUUID } = require('crypto');
-const TrdpConfigLoader = require('./trdpConfigLoader');
+const configSummary = require('./configSummary');
 const engineController = require('./engineController');
+const PdStateReader = require('./pdStateReader');
 
 const app = express();
 const port = process.env.PORT || 3001;
@@ -41,6 +42,40 @@ async function saveMetadata(entries) {
 
 ensureDataDirectory();
 
+const pdState = new PdStateReader({
+  name: process.env.TRDP_STATE_EXPORT || 'trdp_state',
+  intervalMs: Number(process.env.TRDP_STATE_INTERVAL_MS) || 200,
+});
+const pdStreamClients = new Set();
+
+function writeEvent(client, event, data) {
+  // A client that cannot keep up skips deltas and gets a fresh snapshot once its socket drains.
+  if (client.stale) {
+    return;
+  }
+  if (!client.res.write(`event: ${event}\ndata: ${data}\n\n`)) {
+    client.stale = true;
+    client.res.once('drain', () => {
+      client.stale = false;
+      writeEvent(client, 'snapshot', JSON.stringify(pdState.snapshot()));
+    });
+  }
+}
+
+// Each delta is serialized once, however many browsers are watching.
+pdState.on('delta', (telegrams) => {
+  const data = JSON.stringify(telegrams);
+  for (const client of pdStreamClients) {
+    writeEvent(client, 'delta', data);
+  }
+});
+pdState.on('reset', () => {
+  for (const client of pdStreamClients) {
+    writeEvent(client, 'snapshot', '[]');
+  }
+});
+pdState.start();
+
 const upload = multer({
   storage: multer.memoryStorage(),
   fileFilter: (_req, file, cb) => {
@@ -80,10 +115,7 @@ app.get('/api/configs/:id/summary', async (req, res) => {
     }
 
     const filePath = path.join(configsDir, entry.storedName || entry.filename);
-    const loader = new TrdpConfigLoader();
-    const summary = await loader.loadSummary(filePath);
-
-    res.json(summary);
+    res.json(await configSummary.loadSummary(filePath));
   } catch (error) {
     console.error('Failed to load configuration summary', error);
     res.status(500).json({ message: 'Failed to parse configuration file.' });
@@ -108,6 +140,11 @@ app.post('/api/configs/upload', upload.single('file'), async (req, res) => {
     metadata.push({ id, filename: originalname, storedName, uploadedAt, active: false });
     await saveMetadata(metadata);
 
+    // Parse in the background so the first summary request is usually served from cache.
+    configSummary.loadSummary(filePath).catch((error) => {
+      console.error('Failed to summarize uploaded configuration', error);
+    });
+
     res.status(201).json({ id, filename: originalname, uploadedAt });
   } catch (error) {
     console.error('Failed to save uploaded file', error);
@@ -155,6 +192,36 @@ app.post('/api/configs/:id/activate', async (req, res) => {
   }
 });
 
+app.get('/api/pd/telegrams', (_req, res) => {
+  res.json(pdState.snapshot());
+});
+
+app.get('/api/pd/stream', (req, res) => {
+  res.writeHead(200, {
+    'Content-Type': 'text/event-stream',
+    'Cache-Control': 'no-cache',
+    Connection: 'keep-alive',
+  });
+  const client = { res, stale: false };
+  pdStreamClients.add(client);
+  writeEvent(client, 'snapshot', JSON.stringify(pdState.snapshot()));
+  req.on('close', () => pdStreamClients.delete(client));
+});
+
+app.post('/api/engine/commands', express.json({ limit: '1mb' }), async (req, res) => {
+  const operations = req.body;
+  if (!operations || typeof operations !== 'object') {
+    return res.status(400).json({ message: 'Expected an operation object or an array of them.' });
+  }
+
+  try {
+    res.json(await engineController.request(operations));
+  } catch (error) {
+    console.error('Control socket request failed', error);
+    res.status(502).json({ message: 'The simulator control socket is not available.' });
+  }
+});
+
 app.use((err, _req, res, _next) => {
   if (err) {
     console.error('Unhandled error', err);
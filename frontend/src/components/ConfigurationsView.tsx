@@ -27,6 +27,7 @@ type ConfigSummary = {
   device: { hostName: string; type: string }
   interfaces: InterfaceSummary[]
   datasets: DatasetSummary[]
+  errors?: string[]
 }
 
 const formatTimestamp = (value: string) => {
@@ -65,6 +66,13 @@ function SummaryModal({
 
         {!loading && summary && !error && (
           <div className="modal__content">
+            {summary.errors && summary.errors.length > 0 && (
+              <div className="alert alert--error">
+                {summary.errors.map((message) => (
+                  <p key={message}>{message}</p>
+                ))}
+              </div>
+            )}
             <div className="summary-grid">
               <div className="panel">
                 <h3>Device</h3>
@@ -79,8 +87,8 @@ function SummaryModal({
               <div className="panel">
                 <h3>Interfaces ({summary.interfaces.length})</h3>
                 <ul className="summary-list">
-                  {summary.interfaces.map((iface) => (
-                    <li key={`${iface.name}-${iface.hostIp}`}>
+                  {summary.interfaces.map((iface, index) => (
+                    <li key={`iface-${index}`}>
                       <div className="summary-list__title">{iface.name || 'Unnamed interface'}</div>
                       <div className="pill-row">
                         <span className="pill">Network ID: {iface.networkId ?? '—'}</span>
@@ -91,8 +99,8 @@ function SummaryModal({
                           <div className="pill pill--muted">PD telegrams</div>
                           <ul className="summary-sublist">
                             {iface.pdTelegrams.length === 0 && <li>None</li>}
-                            {iface.pdTelegrams.map((telegram) => (
-                              <li key={`pd-${telegram.name}-${telegram.comId}`}>
+                            {iface.pdTelegrams.map((telegram, index) => (
+                              <li key={`pd-${index}`}>
                                 <span className="highlight">{telegram.name || 'Telegram'}</span> (ComId:{' '}
                                 {telegram.comId ?? '—'}) — {telegram.direction}
                               </li>
@@ -103,8 +111,8 @@ function SummaryModal({
                           <div className="pill pill--muted">MD telegrams</div>
                           <ul className="summary-sublist">
                             {iface.mdTelegrams.length === 0 && <li>None</li>}
-                            {iface.mdTelegrams.map((telegram) => (
-                              <li key={`md-${telegram.name}-${telegram.comId}`}>
+                            {iface.mdTelegrams.map((telegram, index) => (
+                              <li key={`md-${index}`}>
                                 <span className="highlight">{telegram.name || 'Telegram'}</span> (ComId:{' '}
                                 {telegram.comId ?? '—'}) — {telegram.direction}
                               </li>
@@ -11,6 +11,8 @@ type TelegramRow = {
   direction: string
   lastRxTime: string
   status: 'OK' | 'Timeout' | string
+  txCount: string
+  rxCount: string
 }
 
 type DatasetField = {
@@ -124,9 +126,23 @@ const normalizeTelegram = (telegram: RawTelegram, index: number): TelegramRow =>
     direction,
     lastRxTime,
     status,
+    txCount: toStringValue(telegram.publishCount ?? '—'),
+    rxCount: toStringValue(telegram.receiveCount ?? '—'),
   }
 }
 
+/** Replaces the rows named in `changed` and keeps the order; unknown rows are appended. */
+const mergeTelegrams = (rows: TelegramRow[], changed: TelegramRow[]): TelegramRow[] => {
+  const updates = new Map(changed.map((row) => [row.id, row]))
+  const merged = rows.map((row) => {
+    const update = updates.get(row.id)
+    if (!update) return row
+    updates.delete(row.id)
+    return update
+  })
+  return updates.size === 0 ? merged : [...merged, ...updates.values()]
+}
+
 export function PdView() {
   const [telegrams, setTelegrams] = useState<TelegramRow[]>([])
   const [selectedId, setSelectedId] = useState<string | null>(null)
@@ -174,8 +190,28 @@ export function PdView() {
 
     fetchTelegrams()
 
+    // Live updates: a snapshot, then only the telegrams that changed, at most every few hundred ms.
+    const stream = new EventSource('/api/pd/stream')
+    const parse = (event: MessageEvent<string>) =>
+      (JSON.parse(event.data) as RawTelegram[]).map((item, index) => normalizeTelegram(item, index))
+    stream.addEventListener('snapshot', (event) => {
+      if (!mounted) return
+      const rows = parse(event as MessageEvent<string>)
+      if (rows.length === 0) return
+      setTelegrams(rows)
+      setSelectedId((prev) => prev ?? rows[0]?.id ?? null)
+      setLoading(false)
+      setError('')
+    })
+    stream.addEventListener('delta', (event) => {
+      if (!mounted) return
+      const changed = parse(event as MessageEvent<string>)
+      setTelegrams((prev) => mergeTelegrams(prev, changed))
+    })
+
     return () => {
       mounted = false
+      stream.close()
     }
   }, [])
 
@@ -346,13 +382,15 @@ export function PdView() {
                 <th>Name</th>
                 <th>Direction</th>
                 <th>Last Rx Time</th>
+                <th>Tx</th>
+                <th>Rx</th>
                 <th>Status</th>
               </tr>
             </thead>
             <tbody>
               {telegrams.length === 0 && !loading ? (
                 <tr>
-                  <td colSpan={6} className="pd-table__empty">
+                  <td colSpan={8} className="pd-table__empty">
                     No telegrams available.
                   </td>
                 </tr>
@@ -375,6 +413,8 @@ export function PdView() {
                       <span className="pill pill--muted">{telegram.direction}</span>
                     </td>
                     <td>{telegram.lastRxTime}</td>
+                    <td>{telegram.txCount}</td>
+                    <td>{telegram.rxCount}</td>
                     <td>
                       <span className={`pill ${isTimeout ? 'pill--danger' : 'pill--success'}`}>
                         {isTimeout ? 'Timeout' : 'OK'}
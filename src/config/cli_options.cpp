@@ -0,0 +1,592 @@
+#include "config/cli_options.h"
+
+#include "util/cpu_list.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+namespace trdp::config
+{
+namespace
+{
+std::optional<long> parseNumber(const std::string &text, long min, long max)
+{
+    char *end = nullptr;
+    const long value = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < min || value > max)
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::optional<model::SchedulingPolicy> parsePolicy(const std::string &text)
+{
+    if (text == "fifo")
+    {
+        return model::SchedulingPolicy::Fifo;
+    }
+    if (text == "rr")
+    {
+        return model::SchedulingPolicy::RoundRobin;
+    }
+    if (text == "other")
+    {
+        return model::SchedulingPolicy::Other;
+    }
+    if (text == "xml")
+    {
+        return model::SchedulingPolicy::XmlPriority;
+    }
+    return std::nullopt;
+}
+
+/** "INDEX:STATEFD:COMMANDFD:WAKEFD:LOGFD", as written by shard::ShardProcess. */
+bool parseWorkerSpec(const std::string &text, model::ShardOptions &shard)
+{
+    std::vector<std::string> fields;
+    std::size_t start = 0U;
+    for (auto colon = text.find(':'); colon != std::string::npos; colon = text.find(':', start))
+    {
+        fields.push_back(text.substr(start, colon - start));
+        start = colon + 1U;
+    }
+    fields.push_back(text.substr(start));
+    if (fields.size() != 5U)
+    {
+        return false;
+    }
+    const auto index = parseNumber(fields[0], 0, 1023);
+    const auto stateFd = parseNumber(fields[1], 0, 1 << 20);
+    const auto commandFd = parseNumber(fields[2], 0, 1 << 20);
+    const auto wakeFd = parseNumber(fields[3], 0, 1 << 20);
+    const auto logFd = parseNumber(fields[4], 0, 1 << 20);
+    if (!index || !stateFd || !commandFd || !wakeFd || !logFd)
+    {
+        return false;
+    }
+    shard.workerInterface = static_cast<int>(*index);
+    shard.stateFd = static_cast<int>(*stateFd);
+    shard.commandFd = static_cast<int>(*commandFd);
+    shard.wakeFd = static_cast<int>(*wakeFd);
+    shard.logFd = static_cast<int>(*logFd);
+    return true;
+}
+
+struct GeneratorSignature
+{
+    const char *name;
+    model::FieldGeneratorKind kind;
+    std::size_t minArgs;
+    std::size_t maxArgs;
+    /** Values for the optional trailing arguments, in order. */
+    std::vector<double> defaults;
+};
+
+const std::vector<GeneratorSignature> &generatorSignatures()
+{
+    static const std::vector<GeneratorSignature> signatures{
+        {"const", model::FieldGeneratorKind::Constant, 1U, 1U, {}},
+        {"counter", model::FieldGeneratorKind::Counter, 0U, 2U, {0.0, 1.0}},
+        {"ramp", model::FieldGeneratorKind::Ramp, 2U, 3U, {1.0}},
+        {"sine", model::FieldGeneratorKind::Sine, 3U, 3U, {}},
+        {"random", model::FieldGeneratorKind::Random, 2U, 3U, {1.0}},
+        {"toggle", model::FieldGeneratorKind::Toggle, 1U, 2U, {0.0}},
+        {"table", model::FieldGeneratorKind::Table, 1U, 4096U, {}},
+    };
+    return signatures;
+}
+
+bool isWholeNumber(double value)
+{
+    return value >= 0.0 && value <= 9007199254740992.0 && std::floor(value) == value;
+}
+
+/** "COMID:FIELD=KIND(ARG,...)", e.g. "1001:speed=sine(0,120,500)"; numbers may be written in hex. */
+bool parseGeneratorRule(const std::string &text, model::FieldGeneratorRule &rule, std::string &error)
+{
+    const auto colon = text.find(':');
+    const auto equals = text.find('=', colon == std::string::npos ? 0U : colon);
+    const auto comId = colon == std::string::npos ? std::nullopt : parseNumber(text.substr(0, colon), 1, 0xFFFFFFFFL);
+    if (!comId || equals == std::string::npos || equals == colon + 1U)
+    {
+        error = "expected COMID:FIELD=GENERATOR";
+        return false;
+    }
+    rule.comId = static_cast<std::uint32_t>(*comId);
+    rule.field = text.substr(colon + 1U, equals - colon - 1U);
+
+    auto call = text.substr(equals + 1U);
+    const auto open = call.find('(');
+    std::string arguments;
+    if (open != std::string::npos)
+    {
+        if (call.back() != ')')
+        {
+            error = "missing ')'";
+            return false;
+        }
+        arguments = call.substr(open + 1U, call.size() - open - 2U);
+        call.erase(open);
+    }
+
+    const auto &signatures = generatorSignatures();
+    const auto signature =
+        std::find_if(signatures.begin(), signatures.end(),
+                     [&call](const GeneratorSignature &candidate) { return call == candidate.name; });
+    if (signature == signatures.end())
+    {
+        error = "unknown generator '" + call + "' (expected const, counter, ramp, sine, random, toggle or table)";
+        return false;
+    }
+    rule.kind = signature->kind;
+
+    rule.args.clear();
+    std::istringstream list(arguments);
+    for (std::string item; !arguments.empty() && std::getline(list, item, ',');)
+    {
+        char *end = nullptr;
+        const double value = std::strtod(item.c_str(), &end);
+        if (item.empty() || *end != '\0' || !std::isfinite(value))
+        {
+            error = "invalid number '" + item + "'";
+            return false;
+        }
+        rule.args.push_back(value);
+    }
+    if (!arguments.empty() && arguments.back() == ',')
+    {
+        error = "empty argument";
+        return false;
+    }
+    if (rule.args.size() < signature->minArgs || rule.args.size() > signature->maxArgs)
+    {
+        error = std::string(signature->name) + " takes " + std::to_string(signature->minArgs) +
+                (signature->maxArgs != signature->minArgs ? " to " + std::to_string(signature->maxArgs) : "") +
+                " argument(s)";
+        return false;
+    }
+    for (auto index = rule.args.size() - signature->minArgs; index < signature->defaults.size(); ++index)
+    {
+        rule.args.push_back(signature->defaults[index]);
+    }
+
+    const auto &args = rule.args;
+    switch (rule.kind)
+    {
+    case model::FieldGeneratorKind::Ramp:
+        if (!(args[0] < args[1]) || args[2] == 0.0)
+        {
+            error = "ramp needs MIN < MAX and a non-zero STEP";
+            return false;
+        }
+        break;
+    case model::FieldGeneratorKind::Sine:
+        if (!isWholeNumber(args[2]) || args[2] < 2.0)
+        {
+            error = "sine PERIOD is a whole number of cycles, at least 2";
+            return false;
+        }
+        break;
+    case model::FieldGeneratorKind::Random:
+        if (args[0] > args[1] || !isWholeNumber(args[2]))
+        {
+            error = "random needs MIN <= MAX and a whole-number SEED";
+            return false;
+        }
+        break;
+    case model::FieldGeneratorKind::Toggle:
+        if (!isWholeNumber(args[0]) || !isWholeNumber(args[1]))
+        {
+            error = "toggle MASK and START are whole numbers";
+            return false;
+        }
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+bool takesValue(const std::string &name)
+{
+    return name == "--rt-policy" || name == "--rt-priority" || name == "--rt-cpus" || name == "--prefault-stack" ||
+           name == "--raw-batch" || name == "--raw-speedup" || name == "--shard-worker" ||
+           name == "--trace" || name == "--log-capacity" || name == "--log-file" || name == "--log-file-size" ||
+           name == "--record" || name == "--record-segment" || name == "--record-codec" || name == "--export" ||
+           name == "--export-format" || name == "--gen" || name == "--scenario" || name == "--scenario-report" ||
+           name == "--control" || name == "--state-export" || name == "--state-export-interval";
+}
+} // namespace
+
+CommandLineParseResult parseCommandLine(int argc, const char *const *argv)
+{
+    CommandLineParseResult result{};
+    auto &options = result.options;
+    bool configSeen = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const int first = i;
+        std::string name = argv[i];
+        std::optional<std::string> value;
+        const auto equals = name.find('=');
+        if (name.rfind("--", 0) == 0 && equals != std::string::npos)
+        {
+            value = name.substr(equals + 1U);
+            name.erase(equals);
+        }
+
+        if (takesValue(name) && !value)
+        {
+            if (i + 1 >= argc)
+            {
+                result.errors.push_back("Missing value for " + name);
+                break;
+            }
+            value = argv[++i];
+        }
+
+        if (name != "--shard-worker")
+        {
+            options.shard.forwardedArguments.insert(options.shard.forwardedArguments.end(), argv + first, argv + i + 1);
+        }
+
+        if (name == "-h" || name == "--help")
+        {
+            result.showHelp = true;
+        }
+        else if (name == "--rt-policy")
+        {
+            const auto policy = parsePolicy(*value);
+            if (policy)
+            {
+                options.realtime.policy = *policy;
+            }
+            else
+            {
+                result.errors.push_back("Unknown scheduling policy '" + *value + "' (expected fifo, rr, other or xml)");
+            }
+        }
+        else if (name == "--rt-priority")
+        {
+            const auto priority = parseNumber(*value, 1, 99);
+            if (priority)
+            {
+                options.realtime.priority = static_cast<int>(*priority);
+            }
+            else
+            {
+                result.errors.push_back("Real-time priority must be 1..99, got '" + *value + "'");
+            }
+        }
+        else if (name == "--rt-cpus")
+        {
+            // "LIST" applies to every session, "IFACE=LIST" to the named interface only.
+            const auto separator = value->find('=');
+            const auto list = separator == std::string::npos ? *value : value->substr(separator + 1U);
+            const auto cpus = util::parseCpuList(list);
+            if (!cpus || cpus->empty())
+            {
+                result.errors.push_back("Invalid CPU list '" + list + "'");
+            }
+            else if (separator == std::string::npos)
+            {
+                options.realtime.cpus = *cpus;
+            }
+            else
+            {
+                options.interfaceCpus[value->substr(0, separator)] = *cpus;
+            }
+        }
+        else if (name == "--rt-isolate")
+        {
+            options.isolateCpus = true;
+        }
+        else if (name == "--mlock")
+        {
+            options.realtime.lockMemory = true;
+        }
+        else if (name == "--prefault-stack")
+        {
+            const auto kib = parseNumber(*value, 1, 65536);
+            if (kib)
+            {
+                options.realtime.prefaultStackBytes = static_cast<std::size_t>(*kib) * 1024U;
+            }
+            else
+            {
+                result.errors.push_back("Stack prefault size must be 1..65536 KiB, got '" + *value + "'");
+            }
+        }
+        else if (name == "--raw-gen")
+        {
+            options.rawGenerator.enabled = true;
+        }
+        else if (name == "--raw-batch")
+        {
+            const auto batch = parseNumber(*value, 1, 1024);
+            if (batch)
+            {
+                options.rawGenerator.batchSize = static_cast<std::uint32_t>(*batch);
+            }
+            else
+            {
+                result.errors.push_back("Raw generator batch size must be 1..1024, got '" + *value + "'");
+            }
+        }
+        else if (name == "--raw-txtime")
+        {
+            options.rawGenerator.txTime = true;
+        }
+        else if (name == "--raw-speedup")
+        {
+            const auto speedup = parseNumber(*value, 1, 100000);
+            if (speedup)
+            {
+                options.rawGenerator.speedup = static_cast<std::uint32_t>(*speedup);
+            }
+            else
+            {
+                result.errors.push_back("Raw generator speedup must be 1..100000, got '" + *value + "'");
+            }
+        }
+        else if (name == "--trace")
+        {
+            options.tracePath = *value;
+        }
+        else if (name == "--log-capacity")
+        {
+            const auto capacity = parseNumber(*value, 1024, 1L << 24);
+            if (capacity)
+            {
+                options.logging.capacity = static_cast<std::size_t>(*capacity);
+            }
+            else
+            {
+                result.errors.push_back("Log capacity must be 1024..16777216 messages, got '" + *value + "'");
+            }
+        }
+        else if (name == "--log-file")
+        {
+            options.logging.spillPath = *value;
+        }
+        else if (name == "--log-file-size")
+        {
+            const auto mib = parseNumber(*value, 1, 4096);
+            if (mib)
+            {
+                options.logging.spillFileBytes = static_cast<std::size_t>(*mib) << 20U;
+            }
+            else
+            {
+                result.errors.push_back("Log file size must be 1..4096 MiB, got '" + *value + "'");
+            }
+        }
+        else if (name == "--record")
+        {
+            options.recording.path = *value;
+        }
+        else if (name == "--record-segment")
+        {
+            const auto mib = parseNumber(*value, 1, 1024);
+            if (mib)
+            {
+                options.recording.segmentBytes = static_cast<std::size_t>(*mib) << 20U;
+            }
+            else
+            {
+                result.errors.push_back("Recording segment size must be 1..1024 MiB, got '" + *value + "'");
+            }
+        }
+        else if (name == "--record-codec")
+        {
+            if (*value == "raw")
+            {
+                options.recording.codec = model::RecordingCodec::Raw;
+            }
+            else if (*value == "delta")
+            {
+                options.recording.codec = model::RecordingCodec::Delta;
+            }
+            else if (*value == "lz")
+            {
+                options.recording.codec = model::RecordingCodec::DeltaLz;
+            }
+            else
+            {
+                result.errors.push_back("Recording codec must be raw, delta or lz, got '" + *value + "'");
+            }
+        }
+        else if (name == "--export")
+        {
+            options.valueExport.directory = *value;
+        }
+        else if (name == "--export-format")
+        {
+            if (*value == "csv")
+            {
+                options.valueExport.format = model::ExportFormat::Csv;
+            }
+            else if (*value == "npy")
+            {
+                options.valueExport.format = model::ExportFormat::Npy;
+            }
+            else
+            {
+                result.errors.push_back("Export format must be csv or npy, got '" + *value + "'");
+            }
+        }
+        else if (name == "--gen")
+        {
+            model::FieldGeneratorRule rule;
+            std::string error;
+            if (parseGeneratorRule(*value, rule, error))
+            {
+                options.generators.push_back(std::move(rule));
+            }
+            else
+            {
+                result.errors.push_back("Invalid generator '" + *value + "': " + error);
+            }
+        }
+        else if (name == "--scenario")
+        {
+            options.scenario.path = *value;
+        }
+        else if (name == "--scenario-report")
+        {
+            options.scenario.reportPath = *value;
+        }
+        else if (name == "--control")
+        {
+            options.control.socketPath = *value;
+        }
+        else if (name == "--state-export")
+        {
+            options.stateExport.name = *value;
+        }
+        else if (name == "--state-export-interval")
+        {
+            const auto ms = parseNumber(*value, 10, 10000);
+            if (ms)
+            {
+                options.stateExport.interval = std::chrono::milliseconds(*ms);
+            }
+            else
+            {
+                result.errors.push_back("State export interval must be 10..10000 ms, got '" + *value + "'");
+            }
+        }
+        else if (name == "--headless")
+        {
+            options.headless = true;
+        }
+        else if (name == "--shard")
+        {
+            options.shard.enabled = true;
+        }
+        else if (name == "--shard-worker")
+        {
+            if (!parseWorkerSpec(*value, options.shard))
+            {
+                result.errors.push_back("Invalid shard worker specification '" + *value + "'");
+            }
+        }
+        else if (name.rfind("-", 0) == 0)
+        {
+            result.errors.push_back("Unknown option " + name);
+        }
+        else if (!configSeen)
+        {
+            options.configPath = name;
+            configSeen = true;
+        }
+        else
+        {
+            result.errors.push_back("Unexpected argument " + name);
+        }
+    }
+
+    if (options.shard.enabled && options.rawGenerator.enabled)
+    {
+        result.errors.push_back("--shard cannot be combined with --raw-gen");
+    }
+
+    if (!options.scenario.reportPath.empty() && options.scenario.path.empty())
+    {
+        result.errors.push_back("--scenario-report needs a --scenario");
+    }
+
+    if (options.realtime.priority != 0 && options.realtime.policy == model::SchedulingPolicy::XmlPriority)
+    {
+        result.errors.push_back("--rt-priority cannot be combined with --rt-policy xml");
+    }
+    else if (options.realtime.priority != 0 && options.realtime.policy == model::SchedulingPolicy::Inherit)
+    {
+        options.realtime.policy = model::SchedulingPolicy::Fifo;
+    }
+    if ((options.realtime.policy == model::SchedulingPolicy::Fifo ||
+         options.realtime.policy == model::SchedulingPolicy::RoundRobin) &&
+        options.realtime.priority == 0)
+    {
+        options.realtime.priority = 50;
+    }
+    return result;
+}
+
+std::string commandLineUsage(const std::string &program)
+{
+    std::ostringstream oss;
+    oss << "Usage: " << program << " [options] [config.xml]\n"
+        << "\n"
+        << "Real-time profile for the TRDP process threads:\n"
+        << "  --rt-policy POLICY          fifo, rr, other, or xml for FIFO at the XML process priority\n"
+        << "                              (default: inherit the simulator's scheduling)\n"
+        << "  --rt-priority N             real-time priority 1..99 (implies fifo; default 50 with fifo/rr)\n"
+        << "  --rt-cpus [IFACE=]LIST      pin session threads to CPUs, e.g. 2,3 or eth0=2-3 (repeatable)\n"
+        << "  --rt-isolate                keep the UI and helper threads off the pinned CPUs\n"
+        << "  --mlock                     lock all current and future memory (mlockall)\n"
+        << "  --prefault-stack KIB        touch KIB of process thread stack before the first cycle\n"
+        << "\n"
+        << "Load generation:\n"
+        << "  --raw-gen                   send outgoing telegrams with the raw sendmmsg generator instead of the stack\n"
+        << "  --raw-batch N               frames per sendmmsg call, 1..1024 (default 64)\n"
+        << "  --raw-txtime                pace frames with SO_TXTIME (needs the fq qdisc)\n"
+        << "  --raw-speedup N             divide every telegram cycle by N\n"
+        << "  --gen COMID:FIELD=GEN       fill FIELD of a published telegram from a generator every cycle\n"
+        << "                              (repeatable). GEN is const(V), counter([START[,STEP]]),\n"
+        << "                              ramp(MIN,MAX[,STEP]), sine(OFFSET,AMPLITUDE,PERIOD_CYCLES),\n"
+        << "                              random(MIN,MAX[,SEED]), toggle(MASK[,START]) or table(V,...)\n"
+        << "\n"
+        << "Scripting:\n"
+        << "  --scenario FILE             run the timed publisher and payload changes in FILE\n"
+        << "  --scenario-report FILE      write the planned and actual time of every scenario event as CSV\n"
+        << "  --control PATH              accept JSON or binary commands on the Unix socket PATH\n"
+        << "  --state-export NAME         publish live telegram state in the shared memory /dev/shm/NAME\n"
+        << "  --state-export-interval MS  how often the exported state is refreshed, 10..10000 (default 50)\n"
+        << "  --headless                  run without the TUI until the scenario ends, a control client\n"
+        << "                              sends quit, SIGINT or SIGTERM\n"
+        << "\n"
+        << "Process layout:\n"
+        << "  --shard                     run each interface's session in its own worker process\n"
+        << "\n"
+        << "Diagnostics:\n"
+        << "  --trace FILE                record a Chrome/Perfetto trace, written on exit and with F12\n"
+        << "                              (needs a build with TRDP_ENABLE_TRACING)\n"
+        << "  --log-capacity N            messages kept for the Logs page (default 262144)\n"
+        << "  --log-file PATH             also write every message to PATH, rotated as PATH.1 .. PATH.3\n"
+        << "  --log-file-size MIB         rotate the log file at this size (default 16)\n"
+        << "  --record FILE               record every received PD telegram to FILE (query with trdp_query)\n"
+        << "  --record-segment MIB        close and index a recording segment at this size (default 8)\n"
+        << "  --record-codec raw|delta|lz store payloads verbatim, as XOR deltas, or deltas + LZ (default lz)\n"
+        << "  --export DIR                write decoded RX values to DIR, one table per ComID\n"
+        << "  --export-format csv|npy     CSV files or NumPy column files (default csv)\n"
+        << "  -h, --help                  show this help\n";
+    return oss.str();
+}
+} // namespace trdp::config
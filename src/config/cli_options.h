@@ -0,0 +1,21 @@
+#pragma once
+
+#include "model/runtime_options.h"
+
+#include <string>
+#include <vector>
+
+namespace trdp::config
+{
+struct CommandLineParseResult
+{
+    model::RuntimeOptions options;
+    std::vector<std::string> errors;
+    bool showHelp{false};
+
+    [[nodiscard]] bool hasErrors() const { return !errors.empty(); }
+};
+
+CommandLineParseResult parseCommandLine(int argc, const char *const *argv);
+std::string commandLineUsage(const std::string &program);
+} // namespace trdp::config
@@ -0,0 +1,163 @@
+#include "config/dataset_codec.h"
+
+namespace trdp::config
+{
+void storeScalar(ElementType type, const DatasetScalar &value, std::uint8_t *out)
+{
+    switch (type)
+    {
+    case ElementType::Bitset8:
+    case ElementType::UInt8:
+        storeBig(out, static_cast<std::uint8_t>(value.integer));
+        break;
+    case ElementType::Char8:
+    case ElementType::Int8:
+        storeBig(out, static_cast<std::int8_t>(value.integer));
+        break;
+    case ElementType::Utf16:
+    case ElementType::UInt16:
+        storeBig(out, static_cast<std::uint16_t>(value.integer));
+        break;
+    case ElementType::Int16:
+        storeBig(out, static_cast<std::int16_t>(value.integer));
+        break;
+    case ElementType::Int32:
+        storeBig(out, static_cast<std::int32_t>(value.integer));
+        break;
+    case ElementType::UInt32:
+    case ElementType::TimeDate32:
+        storeBig(out, static_cast<std::uint32_t>(value.integer));
+        break;
+    case ElementType::Int64:
+    case ElementType::UInt64:
+        storeBig(out, value.integer);
+        break;
+    case ElementType::Real32:
+        storeBig(out, static_cast<float>(value.real));
+        break;
+    case ElementType::Real64:
+        storeBig(out, value.real);
+        break;
+    case ElementType::TimeDate48:
+        storeBig(out, TimeDate48{static_cast<std::uint32_t>(value.integer >> 16),
+                                 static_cast<std::uint16_t>(value.integer)});
+        break;
+    case ElementType::TimeDate64:
+        storeBig(out, TimeDate64{static_cast<std::int32_t>(value.integer >> 32),
+                                 static_cast<std::int32_t>(value.integer)});
+        break;
+    case ElementType::Dataset:
+        break;
+    }
+}
+
+namespace
+{
+DatasetScalar loadScalar(ElementType type, const std::uint8_t *in)
+{
+    DatasetScalar value;
+    switch (type)
+    {
+    case ElementType::Bitset8:
+    case ElementType::UInt8:
+        value.integer = loadBig<std::uint8_t>(in);
+        break;
+    case ElementType::Char8:
+    case ElementType::Int8:
+        value.integer = loadBig<std::int8_t>(in);
+        break;
+    case ElementType::Utf16:
+    case ElementType::UInt16:
+        value.integer = loadBig<std::uint16_t>(in);
+        break;
+    case ElementType::Int16:
+        value.integer = loadBig<std::int16_t>(in);
+        break;
+    case ElementType::Int32:
+        value.integer = loadBig<std::int32_t>(in);
+        break;
+    case ElementType::UInt32:
+    case ElementType::TimeDate32:
+        value.integer = loadBig<std::uint32_t>(in);
+        break;
+    case ElementType::Int64:
+    case ElementType::UInt64:
+        value.integer = loadBig<std::int64_t>(in);
+        break;
+    case ElementType::Real32:
+        value.real = loadBig<float>(in);
+        break;
+    case ElementType::Real64:
+        value.real = loadBig<double>(in);
+        break;
+    case ElementType::TimeDate48:
+    {
+        const auto time = loadBig<TimeDate48>(in);
+        value.integer = static_cast<std::int64_t>(time.seconds) << 16 | time.ticks;
+        break;
+    }
+    case ElementType::TimeDate64:
+    {
+        const auto time = loadBig<TimeDate64>(in);
+        const auto seconds = static_cast<std::uint64_t>(static_cast<std::uint32_t>(time.seconds));
+        value.integer = static_cast<std::int64_t>(seconds << 32U | static_cast<std::uint32_t>(time.microseconds));
+        break;
+    }
+    case ElementType::Dataset:
+        break;
+    }
+    return value;
+}
+} // namespace
+
+std::size_t scalarCount(const DatasetLayout &layout)
+{
+    std::size_t count = 0U;
+    for (const auto &field : layout.fields)
+    {
+        count += field.count;
+    }
+    return count;
+}
+
+bool marshalDataset(const DatasetLayout &layout, const std::vector<DatasetScalar> &values, std::uint8_t *out,
+                    std::size_t size)
+{
+    if (size < layout.wireSize || values.size() != scalarCount(layout))
+    {
+        return false;
+    }
+
+    auto value = values.begin();
+    for (const auto &field : layout.fields)
+    {
+        const auto step = elementTypeSize(field.type);
+        for (std::uint32_t index = 0U; index < field.count; ++index)
+        {
+            storeScalar(field.type, *value++, out + field.offset + index * step);
+        }
+    }
+    return true;
+}
+
+bool unmarshalDataset(const DatasetLayout &layout, const std::uint8_t *in, std::size_t size,
+                      std::vector<DatasetScalar> &values)
+{
+    if (size < layout.wireSize)
+    {
+        return false;
+    }
+
+    values.clear();
+    values.reserve(scalarCount(layout));
+    for (const auto &field : layout.fields)
+    {
+        const auto step = elementTypeSize(field.type);
+        for (std::uint32_t index = 0U; index < field.count; ++index)
+        {
+            values.push_back(loadScalar(field.type, in + field.offset + index * step));
+        }
+    }
+    return true;
+}
+} // namespace trdp::config
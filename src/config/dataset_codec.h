@@ -0,0 +1,38 @@
+#pragma once
+
+#include "config/dataset_layout.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace trdp::config
+{
+/**
+ * One element value in the generic (schema-interpreting) codec. Integer, character and TIMEDATE32
+ * elements use `integer`, REAL32/REAL64 use `real`; TIMEDATE48 packs seconds << 16 | ticks and
+ * TIMEDATE64 seconds << 32 | microseconds into `integer`.
+ */
+struct DatasetScalar
+{
+    std::int64_t integer{0};
+    double real{0.0};
+};
+
+/** Writes one element of `type` in network byte order; the integer is truncated to the element width. */
+void storeScalar(ElementType type, const DatasetScalar &value, std::uint8_t *out);
+
+/** Number of scalars a layout marshals: the sum of its field counts. */
+std::size_t scalarCount(const DatasetLayout &layout);
+
+/**
+ * Generic marshalling driven by a flattened layout, one scalar per element in field order.
+ * Returns false when `values` or `size` do not match the layout.
+ */
+bool marshalDataset(const DatasetLayout &layout, const std::vector<DatasetScalar> &values, std::uint8_t *out,
+                    std::size_t size);
+
+/** Inverse of marshalDataset(); `values` is resized to scalarCount(layout). */
+bool unmarshalDataset(const DatasetLayout &layout, const std::uint8_t *in, std::size_t size,
+                      std::vector<DatasetScalar> &values);
+} // namespace trdp::config
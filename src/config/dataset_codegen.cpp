@@ -0,0 +1,483 @@
+#include "config/dataset_codegen.h"
+
+#include "config/dataset_layout.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string_view>
+
+namespace trdp::config
+{
+namespace
+{
+constexpr std::string_view kReservedWords[] = {
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+    "char", "char16_t", "char32_t", "char8_t", "class", "compl", "concept", "const", "const_cast", "consteval",
+    "constexpr", "constinit", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete",
+    "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+    "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+    "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+    "requires", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch",
+    "template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union",
+    "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq", "std",
+};
+
+/** The generated namespace also declares this alias next to the structs. */
+constexpr std::string_view kAllDatasetsAlias = "AllDatasets";
+
+bool isReserved(const std::string &name)
+{
+    return std::find(std::begin(kReservedWords), std::end(kReservedWords), name) != std::end(kReservedWords) ||
+           // Double underscores and a leading underscore plus capital belong to the implementation.
+           name.find("__") != std::string::npos ||
+           (name.size() > 1U && name[0] == '_' && std::isupper(static_cast<unsigned char>(name[1])) != 0);
+}
+
+/** `raw` with everything outside [A-Za-z0-9_] replaced, or empty if nothing usable is left. */
+std::string sanitizeIdentifier(const std::string &raw)
+{
+    std::string name;
+    for (const char c : raw)
+    {
+        name.push_back(std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_' ? c : '_');
+    }
+    if (name.find_first_not_of('_') == std::string::npos)
+    {
+        return {};
+    }
+    if (std::isdigit(static_cast<unsigned char>(name.front())) != 0)
+    {
+        name.insert(0U, "_");
+    }
+    return name;
+}
+
+bool validNamespace(const std::string &nameSpace)
+{
+    std::size_t start = 0U;
+    while (true)
+    {
+        const auto end = nameSpace.find("::", start);
+        const auto part = nameSpace.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (part.empty() || sanitizeIdentifier(part) != part || isReserved(part))
+        {
+            return false;
+        }
+        if (end == std::string::npos)
+        {
+            return true;
+        }
+        start = end + 2U;
+    }
+}
+
+const char *cppTypeName(ElementType type)
+{
+    switch (type)
+    {
+    case ElementType::Bitset8:
+    case ElementType::UInt8:
+        return "std::uint8_t";
+    case ElementType::Char8:
+        return "char";
+    case ElementType::Utf16:
+    case ElementType::UInt16:
+        return "std::uint16_t";
+    case ElementType::Int8:
+        return "std::int8_t";
+    case ElementType::Int16:
+        return "std::int16_t";
+    case ElementType::Int32:
+        return "std::int32_t";
+    case ElementType::Int64:
+        return "std::int64_t";
+    case ElementType::UInt32:
+    case ElementType::TimeDate32:
+        return "std::uint32_t";
+    case ElementType::UInt64:
+        return "std::uint64_t";
+    case ElementType::Real32:
+        return "float";
+    case ElementType::Real64:
+        return "double";
+    case ElementType::TimeDate48:
+        return "::trdp::config::TimeDate48";
+    case ElementType::TimeDate64:
+        return "::trdp::config::TimeDate64";
+    case ElementType::Dataset:
+        break;
+    }
+    return "";
+}
+
+const char *elementTypeEnumerator(ElementType type)
+{
+    switch (type)
+    {
+    case ElementType::Bitset8:
+        return "Bitset8";
+    case ElementType::Char8:
+        return "Char8";
+    case ElementType::Utf16:
+        return "Utf16";
+    case ElementType::Int8:
+        return "Int8";
+    case ElementType::Int16:
+        return "Int16";
+    case ElementType::Int32:
+        return "Int32";
+    case ElementType::Int64:
+        return "Int64";
+    case ElementType::UInt8:
+        return "UInt8";
+    case ElementType::UInt16:
+        return "UInt16";
+    case ElementType::UInt32:
+        return "UInt32";
+    case ElementType::UInt64:
+        return "UInt64";
+    case ElementType::Real32:
+        return "Real32";
+    case ElementType::Real64:
+        return "Real64";
+    case ElementType::TimeDate32:
+        return "TimeDate32";
+    case ElementType::TimeDate48:
+        return "TimeDate48";
+    case ElementType::TimeDate64:
+        return "TimeDate64";
+    case ElementType::Dataset:
+        break;
+    }
+    return "Dataset";
+}
+
+std::string quoted(const std::string &text)
+{
+    std::string out = "\"";
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out.push_back('\\');
+        }
+        out.push_back(std::isprint(static_cast<unsigned char>(c)) != 0 ? c : '?');
+    }
+    return out + "\"";
+}
+
+/** One top-level element of a generated struct. */
+struct MemberPlan
+{
+    std::string name;
+    std::string xmlName;
+    ElementType type{ElementType::UInt8};
+    std::uint32_t nestedId{0};
+    std::uint32_t count{1};
+    std::size_t offset{0};
+    std::size_t elementSize{0};
+};
+
+struct DatasetPlan
+{
+    const model::Dataset *dataset{nullptr};
+    std::string structName;
+    std::size_t wireSize{0};
+    std::vector<MemberPlan> members;
+};
+
+class HeaderWriter
+{
+public:
+    HeaderWriter(const model::SimulatorConfig &config, const DatasetCodegenOptions &options)
+        : config_(config), options_(options), qualifier_("::" + options.nameSpace + "::")
+    {
+    }
+
+    DatasetCodegenResult run()
+    {
+        DatasetCodegenResult result;
+        if (!validNamespace(options_.nameSpace))
+        {
+            result.errors.push_back("Invalid C++ namespace: " + options_.nameSpace);
+            return result;
+        }
+
+        planDatasets(result);
+        for (const auto &dataset : config_.datasets)
+        {
+            emitInOrder(dataset.id, result.generated);
+        }
+
+        std::ostringstream out;
+        writePreamble(out);
+        writeStructs(out, result);
+        writeCodecs(out, result);
+        result.header = out.str();
+        return result;
+    }
+
+private:
+    void planDatasets(DatasetCodegenResult &result)
+    {
+        std::set<std::string> structNames;
+        std::set<std::uint32_t> seen;
+        for (const auto &dataset : config_.datasets)
+        {
+            const auto label = std::to_string(dataset.id) + " (" + dataset.name + ")";
+            if (!seen.insert(dataset.id).second)
+            {
+                result.skipped.push_back(label + ": duplicate dataset id");
+                continue;
+            }
+
+            std::string reason;
+            const auto layout = flattenDataset(config_, dataset.id, &reason);
+            if (!layout || layout->wireSize == 0U)
+            {
+                result.skipped.push_back(label + ": " + (layout ? std::string("dataset has no elements") : reason));
+                continue;
+            }
+
+            DatasetPlan plan;
+            plan.dataset = &dataset;
+            plan.wireSize = layout->wireSize;
+            plan.structName = sanitizeIdentifier(dataset.name);
+            if (plan.structName.empty())
+            {
+                plan.structName = "Dataset" + std::to_string(dataset.id);
+            }
+            if (isReserved(plan.structName) || plan.structName == kAllDatasetsAlias ||
+                structNames.count(plan.structName) != 0U)
+            {
+                plan.structName += "_" + std::to_string(dataset.id);
+            }
+            structNames.insert(plan.structName);
+            planMembers(plan);
+            plans_.emplace(dataset.id, std::move(plan));
+        }
+
+        // A nested dataset can still be missing here when it has no elements or a duplicate id.
+        for (bool dropped = true; dropped;)
+        {
+            dropped = false;
+            for (auto it = plans_.begin(); it != plans_.end() && !dropped; ++it)
+            {
+                for (const auto &member : it->second.members)
+                {
+                    if (member.type == ElementType::Dataset && plans_.count(member.nestedId) == 0U)
+                    {
+                        result.skipped.push_back(std::to_string(it->first) + " (" + it->second.dataset->name +
+                                                 "): nests dataset " + std::to_string(member.nestedId) +
+                                                 ", which is not generated");
+                        plans_.erase(it);
+                        dropped = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    void planMembers(DatasetPlan &plan) const
+    {
+        std::set<std::string> names;
+        std::size_t offset = 0U;
+        for (std::size_t index = 0; index < plan.dataset->elements.size(); ++index)
+        {
+            const auto &element = plan.dataset->elements[index];
+            MemberPlan member;
+            member.xmlName = element.name;
+            member.type = *parseElementType(element.type);
+            member.count = element.arraySize;
+            member.offset = offset;
+            if (member.type == ElementType::Dataset)
+            {
+                member.nestedId = static_cast<std::uint32_t>(std::stoul(element.type.substr(8U)));
+                member.elementSize = *datasetWireSize(config_, member.nestedId);
+            }
+            else
+            {
+                member.elementSize = elementTypeSize(member.type);
+            }
+            offset += member.elementSize * member.count;
+
+            member.name = sanitizeIdentifier(element.name);
+            if (member.name.empty())
+            {
+                member.name = "element" + std::to_string(index);
+            }
+            if (isReserved(member.name) || member.name == plan.structName || names.count(member.name) != 0U)
+            {
+                member.name += "_" + std::to_string(index);
+            }
+            names.insert(member.name);
+            plan.members.push_back(std::move(member));
+        }
+    }
+
+    /** Post-order over nested datasets so every struct is complete before it is used as a member. */
+    void emitInOrder(std::uint32_t datasetId, std::vector<std::uint32_t> &order)
+    {
+        const auto plan = plans_.find(datasetId);
+        if (plan == plans_.end() || std::find(order.begin(), order.end(), datasetId) != order.end())
+        {
+            return;
+        }
+        for (const auto &member : plan->second.members)
+        {
+            if (member.type == ElementType::Dataset)
+            {
+                emitInOrder(member.nestedId, order);
+            }
+        }
+        order.push_back(datasetId);
+    }
+
+    std::string qualified(std::uint32_t datasetId) const { return qualifier_ + plans_.at(datasetId).structName; }
+
+    void writePreamble(std::ostringstream &out) const
+    {
+        out << "// Generated by trdp_gen_datasets"
+            << (options_.source.empty() ? std::string{} : " from " + options_.source) << ". Do not edit.\n"
+            << "#pragma once\n\n"
+            << "#include \"config/dataset_wire.h\"\n\n"
+            << "#include <array>\n#include <cstddef>\n#include <cstdint>\n#include <cstring>\n#include <tuple>\n\n";
+    }
+
+    void writeStructs(std::ostringstream &out, const DatasetCodegenResult &result) const
+    {
+        out << "namespace " << options_.nameSpace << "\n{\n#pragma pack(push, 1)\n";
+        for (const auto id : result.generated)
+        {
+            const auto &plan = plans_.at(id);
+            out << "/** Dataset " << id << " \"" << plan.dataset->name << "\", " << plan.wireSize
+                << " bytes on the wire. */\nstruct " << plan.structName << "\n{\n";
+            for (const auto &member : plan.members)
+            {
+                out << "    "
+                    << (member.type == ElementType::Dataset ? qualified(member.nestedId) : cppTypeName(member.type))
+                    << ' ' << member.name;
+                if (member.count != 1U)
+                {
+                    out << '[' << member.count << ']';
+                }
+                out << ";\n";
+            }
+            out << "};\n\n";
+        }
+        out << "#pragma pack(pop)\n\n";
+        for (const auto &skipped : result.skipped)
+        {
+            out << "// Not generated: dataset " << skipped << "\n";
+        }
+        if (!result.skipped.empty())
+        {
+            out << "\n";
+        }
+        out << "using AllDatasets = std::tuple<";
+        for (std::size_t index = 0; index < result.generated.size(); ++index)
+        {
+            out << (index == 0U ? "" : ", ") << plans_.at(result.generated[index]).structName;
+        }
+        out << ">;\n} // namespace " << options_.nameSpace << "\n\n";
+    }
+
+    void writeCodecs(std::ostringstream &out, const DatasetCodegenResult &result) const
+    {
+        out << "namespace trdp::config\n{\n";
+        for (const auto id : result.generated)
+        {
+            const auto &plan = plans_.at(id);
+            const auto type = qualified(id);
+            out << "template <>\nstruct DatasetCodec<" << type << ">\n{\n"
+                << "    static constexpr std::uint32_t kId = " << id << "U;\n"
+                << "    static constexpr std::size_t kWireSize = " << plan.wireSize << "U;\n"
+                << "    static constexpr std::array<FieldOffset, " << plan.members.size() << "> kFields{{\n";
+            for (const auto &member : plan.members)
+            {
+                out << "        {" << quoted(member.xmlName) << ", " << member.offset << "U, " << member.count
+                    << "U, ElementType::" << elementTypeEnumerator(member.type) << "},\n";
+            }
+            out << "    }};\n\n";
+
+            out << "    static void encode(const " << type << " &value, std::uint8_t *out) noexcept\n    {\n";
+            for (const auto &member : plan.members)
+            {
+                writeMember(out, member, true);
+            }
+            out << "    }\n\n";
+            out << "    static void decode(const std::uint8_t *in, " << type << " &value) noexcept\n    {\n";
+            for (const auto &member : plan.members)
+            {
+                writeMember(out, member, false);
+            }
+            out << "    }\n};\n"
+                << "static_assert(sizeof(" << type << ") == DatasetCodec<" << type << ">::kWireSize);\n\n"
+                << "template <>\nstruct DatasetById<" << id << "U>\n{\n    using type = " << type << ";\n};\n\n";
+        }
+        out << "} // namespace trdp::config\n";
+    }
+
+    void writeMember(std::ostringstream &out, const MemberPlan &member, bool encode) const
+    {
+        const auto offset = std::to_string(member.offset) + "U";
+        const bool bytes = member.type != ElementType::Dataset && member.elementSize == 1U;
+        if (member.count != 1U && bytes)
+        {
+            out << "        std::memcpy(" << (encode ? "out + " + offset + ", value." + member.name
+                                                     : "value." + member.name + ", in + " + offset)
+                << ", " << member.count << "U);\n";
+            return;
+        }
+
+        auto element = "value." + member.name;
+        auto position = offset;
+        std::string indent = "        ";
+        if (member.count != 1U)
+        {
+            out << indent << "for (std::size_t i = 0; i < " << member.count << "U; ++i)\n" << indent << "{\n";
+            element += "[i]";
+            position += " + i * " + std::to_string(member.elementSize) + "U";
+            indent += "    ";
+        }
+
+        out << indent;
+        if (member.type == ElementType::Dataset)
+        {
+            out << "DatasetCodec<" << qualified(member.nestedId) << ">::"
+                << (encode ? "encode(" + element + ", out + " + position + ")"
+                           : "decode(in + " + position + ", " + element + ")");
+        }
+        else if (encode)
+        {
+            out << "storeBig(out + " << position << ", " << element << ")";
+        }
+        else
+        {
+            out << element << " = loadBig<" << cppTypeName(member.type) << ">(in + " << position << ")";
+        }
+        out << ";\n";
+
+        if (member.count != 1U)
+        {
+            out << "        }\n";
+        }
+    }
+
+    const model::SimulatorConfig &config_;
+    const DatasetCodegenOptions &options_;
+    std::string qualifier_;
+    std::map<std::uint32_t, DatasetPlan> plans_;
+};
+} // namespace
+
+DatasetCodegenResult generateDatasetHeader(const model::SimulatorConfig &config, const DatasetCodegenOptions &options)
+{
+    return HeaderWriter(config, options).run();
+}
+} // namespace trdp::config
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "model/sim_config.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace trdp::config
+{
+struct DatasetCodegenOptions
+{
+    /** Namespace of the generated structs, e.g. "trdp::datasets". */
+    std::string nameSpace{"trdp::datasets"};
+    /** Configuration file named in the header banner. */
+    std::string source;
+};
+
+struct DatasetCodegenResult
+{
+    /** Complete header text; empty when `errors` is not. */
+    std::string header;
+    /** Dataset ids that got a struct and codec, in emission order. */
+    std::vector<std::uint32_t> generated;
+    /** Datasets left out and why, e.g. "2002 (variable): element data is a variable-length array". */
+    std::vector<std::string> skipped;
+    std::vector<std::string> errors;
+
+    [[nodiscard]] bool hasErrors() const { return !errors.empty(); }
+};
+
+/**
+ * Writes a header with one packed struct per fixed-size dataset plus DatasetCodec and DatasetById
+ * specialisations: constexpr field offsets and inline big-endian encode/decode with every offset and
+ * array length baked in. Variable-length, recursive and untyped datasets (and those nesting them)
+ * are listed in `skipped` and left to the generic codec.
+ */
+DatasetCodegenResult generateDatasetHeader(const model::SimulatorConfig &config, const DatasetCodegenOptions &options);
+} // namespace trdp::config
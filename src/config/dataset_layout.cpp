@@ -0,0 +1,245 @@
+#include "config/dataset_layout.h"
+
+#include <array>
+#include <charconv>
+#include <cstdlib>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace trdp::config
+{
+namespace
+{
+constexpr std::string_view kDatasetPrefix = "DATASET ";
+constexpr int kMaxNestingDepth = 8;
+
+constexpr std::array<std::pair<std::string_view, ElementType>, 16> kElementTypes{{
+    {"BITSET8", ElementType::Bitset8},
+    {"CHAR8", ElementType::Char8},
+    {"UTF16", ElementType::Utf16},
+    {"INT8", ElementType::Int8},
+    {"INT16", ElementType::Int16},
+    {"INT32", ElementType::Int32},
+    {"INT64", ElementType::Int64},
+    {"UINT8", ElementType::UInt8},
+    {"UINT16", ElementType::UInt16},
+    {"UINT32", ElementType::UInt32},
+    {"UINT64", ElementType::UInt64},
+    {"REAL32", ElementType::Real32},
+    {"REAL64", ElementType::Real64},
+    {"TIMEDATE32", ElementType::TimeDate32},
+    {"TIMEDATE48", ElementType::TimeDate48},
+    {"TIMEDATE64", ElementType::TimeDate64},
+}};
+
+const model::Dataset *findDataset(const model::SimulatorConfig &config, std::uint32_t datasetId)
+{
+    for (const auto &dataset : config.datasets)
+    {
+        if (dataset.id == datasetId)
+        {
+            return &dataset;
+        }
+    }
+    return nullptr;
+}
+
+std::optional<std::uint32_t> nestedDatasetId(const std::string &type)
+{
+    if (type.compare(0, kDatasetPrefix.size(), kDatasetPrefix) != 0)
+    {
+        return std::nullopt;
+    }
+
+    std::uint32_t id = 0U;
+    const auto *first = type.data() + kDatasetPrefix.size();
+    const auto *last = type.data() + type.size();
+    const auto [end, error] = std::from_chars(first, last, id);
+    if (error != std::errc{} || end != last)
+    {
+        return std::nullopt;
+    }
+    return id;
+}
+
+/** Appends the fields of `datasetId` at `base`; returns the dataset's size or nullopt with `error` set. */
+std::optional<std::size_t> appendFields(const model::SimulatorConfig &config, std::uint32_t datasetId,
+                                        const std::string &prefix, std::size_t base, int depth,
+                                        std::vector<FieldLayout> *fields, std::string &error)
+{
+    const auto *dataset = findDataset(config, datasetId);
+    if (dataset == nullptr)
+    {
+        error = "unknown dataset " + std::to_string(datasetId);
+        return std::nullopt;
+    }
+    if (depth > kMaxNestingDepth)
+    {
+        error = "dataset " + std::to_string(datasetId) + " nests too deeply or recursively";
+        return std::nullopt;
+    }
+
+    std::size_t total = 0U;
+    for (const auto &element : dataset->elements)
+    {
+        const auto path = prefix + element.name;
+        if (element.arraySize == 0U)
+        {
+            error = "element " + path + " is a variable-length array";
+            return std::nullopt;
+        }
+
+        const auto type = parseElementType(element.type);
+        if (!type)
+        {
+            error = "element " + path + " has unknown type " + element.type;
+            return std::nullopt;
+        }
+        if (*type != ElementType::Dataset)
+        {
+            if (fields != nullptr)
+            {
+                fields->push_back(FieldLayout{path, *type, base + total, element.arraySize});
+            }
+            total += elementTypeSize(*type) * element.arraySize;
+            continue;
+        }
+
+        const auto nested = *nestedDatasetId(element.type);
+        for (std::uint32_t index = 0U; index < element.arraySize; ++index)
+        {
+            const auto nestedPrefix =
+                (element.arraySize == 1U ? path : path + "[" + std::to_string(index) + "]") + ".";
+            const auto size = appendFields(config, nested, nestedPrefix, base + total, depth + 1, fields, error);
+            if (!size)
+            {
+                return std::nullopt;
+            }
+            total += *size;
+        }
+    }
+    return total;
+}
+} // namespace
+
+std::optional<std::size_t> elementTypeSize(const std::string &type)
+{
+    const auto parsed = parseElementType(type);
+    if (!parsed || *parsed == ElementType::Dataset)
+    {
+        return std::nullopt;
+    }
+    return elementTypeSize(*parsed);
+}
+
+std::size_t elementTypeSize(ElementType type)
+{
+    switch (type)
+    {
+    case ElementType::Bitset8:
+    case ElementType::Char8:
+    case ElementType::Int8:
+    case ElementType::UInt8:
+        return 1U;
+    case ElementType::Utf16:
+    case ElementType::Int16:
+    case ElementType::UInt16:
+        return 2U;
+    case ElementType::Int32:
+    case ElementType::UInt32:
+    case ElementType::Real32:
+    case ElementType::TimeDate32:
+        return 4U;
+    case ElementType::TimeDate48:
+        return 6U;
+    case ElementType::Int64:
+    case ElementType::UInt64:
+    case ElementType::Real64:
+    case ElementType::TimeDate64:
+        return 8U;
+    case ElementType::Dataset:
+        break;
+    }
+    return 0U;
+}
+
+std::optional<ElementType> parseElementType(const std::string &type)
+{
+    for (const auto &[name, value] : kElementTypes)
+    {
+        if (type == name)
+        {
+            return value;
+        }
+    }
+    if (nestedDatasetId(type))
+    {
+        return ElementType::Dataset;
+    }
+    return std::nullopt;
+}
+
+std::optional<std::size_t> datasetWireSize(const model::SimulatorConfig &config, std::uint32_t datasetId)
+{
+    std::string error;
+    return appendFields(config, datasetId, {}, 0U, 0, nullptr, error);
+}
+
+std::optional<DatasetLayout> flattenDataset(const model::SimulatorConfig &config, std::uint32_t datasetId,
+                                            std::string *error)
+{
+    DatasetLayout layout;
+    std::string reason;
+    const auto size = appendFields(config, datasetId, {}, 0U, 0, &layout.fields, reason);
+    if (!size)
+    {
+        if (error != nullptr)
+        {
+            *error = reason;
+        }
+        return std::nullopt;
+    }
+    layout.datasetId = datasetId;
+    layout.name = findDataset(config, datasetId)->name;
+    layout.wireSize = *size;
+    return layout;
+}
+
+const FieldLayout *findField(const DatasetLayout &layout, const std::string &path, std::uint32_t &first,
+                             std::uint32_t &count)
+{
+    for (const auto &field : layout.fields)
+    {
+        if (field.path == path)
+        {
+            first = 0U;
+            count = field.count;
+            return &field;
+        }
+    }
+
+    const auto open = path.rfind('[');
+    if (open == std::string::npos || path.back() != ']' || open + 2U >= path.size())
+    {
+        return nullptr;
+    }
+    const auto digits = path.substr(open + 1U, path.size() - open - 2U);
+    if (digits.find_first_not_of("0123456789") != std::string::npos || digits.size() > 9U)
+    {
+        return nullptr;
+    }
+    const auto index = static_cast<std::uint32_t>(std::strtoul(digits.c_str(), nullptr, 10));
+    const auto base = path.substr(0, open);
+    for (const auto &field : layout.fields)
+    {
+        if (field.path == base && index < field.count)
+        {
+            first = index;
+            count = 1U;
+            return &field;
+        }
+    }
+    return nullptr;
+}
+} // namespace trdp::config
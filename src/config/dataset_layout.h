@@ -0,0 +1,65 @@
+#pragma once
+
+#include "config/dataset_wire.h"
+#include "model/sim_config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace trdp::config
+{
+/** Largest PD user-data size the stack accepts (TRDP_MAX_PD_DATA_SIZE). */
+constexpr std::size_t kMaxPdDataSize = 1432U;
+
+/** Marshalled size in bytes of one primitive dataset element type, e.g. "UINT32" → 4. */
+std::optional<std::size_t> elementTypeSize(const std::string &type);
+
+/** Marshalled size of one primitive element; 0 for ElementType::Dataset. */
+std::size_t elementTypeSize(ElementType type);
+
+/** Element type for an XML type name; "DATASET n" maps to ElementType::Dataset. */
+std::optional<ElementType> parseElementType(const std::string &type);
+
+/** One primitive field of a flattened dataset: `count` consecutive elements starting at `offset`. */
+struct FieldLayout
+{
+    /** Element names from the outer dataset inwards, e.g. "header.time" or "cars[2].speed". */
+    std::string path;
+    ElementType type{ElementType::UInt8};
+    std::size_t offset{0};
+    std::uint32_t count{1};
+};
+
+/** A dataset with every nested "DATASET n" expanded in place, in marshalling order. */
+struct DatasetLayout
+{
+    std::uint32_t datasetId{0};
+    std::string name;
+    std::size_t wireSize{0};
+    std::vector<FieldLayout> fields;
+};
+
+/**
+ * Marshalled (packed, network order) size of a dataset, resolving nested "DATASET n" elements.
+ * Returns std::nullopt for unknown datasets or types, variable-length arrays (arraySize 0) and
+ * recursive definitions.
+ */
+std::optional<std::size_t> datasetWireSize(const model::SimulatorConfig &config, std::uint32_t datasetId);
+
+/**
+ * Field-by-field layout of a dataset for generic marshalling. Fails where datasetWireSize() does;
+ * `error`, when given, then names the offending element.
+ */
+std::optional<DatasetLayout> flattenDataset(const model::SimulatorConfig &config, std::uint32_t datasetId,
+                                            std::string *error = nullptr);
+
+/**
+ * The field `path` names in `layout` and the elements it covers: all of them, or only element
+ * `first` for "path[i]". Returns nullptr when there is no such field or index.
+ */
+const FieldLayout *findField(const DatasetLayout &layout, const std::string &path, std::uint32_t &first,
+                             std::uint32_t &count);
+} // namespace trdp::config
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace trdp::config
+{
+/** TRDP dataset element types (TRDP_DATA_TYPE_T); Dataset stands for a nested "DATASET n". */
+enum class ElementType : std::uint8_t
+{
+    Bitset8,
+    Char8,
+    Utf16,
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    UInt8,
+    UInt16,
+    UInt32,
+    UInt64,
+    Real32,
+    Real64,
+    TimeDate32,
+    TimeDate48,
+    TimeDate64,
+    Dataset,
+};
+
+#pragma pack(push, 1)
+/** TIMEDATE48: seconds since 1970 and 1/65536 s ticks. */
+struct TimeDate48
+{
+    std::uint32_t seconds;
+    std::uint16_t ticks;
+};
+
+/** TIMEDATE64: seconds and microseconds since 1970. */
+struct TimeDate64
+{
+    std::int32_t seconds;
+    std::int32_t microseconds;
+};
+#pragma pack(pop)
+
+/** Where one element of a generated dataset sits in its marshalled (packed, big-endian) form. */
+struct FieldOffset
+{
+    const char *name;
+    std::size_t offset;
+    std::uint32_t count;
+    ElementType type;
+};
+
+/** Writes one element in network byte order; the byte-wise shifts compile to a single swap and store. */
+template <typename T>
+inline void storeBig(std::uint8_t *out, T value) noexcept
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        storeBig(out, bits);
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        storeBig(out, bits);
+    }
+    else if constexpr (std::is_same_v<T, TimeDate48>)
+    {
+        storeBig(out, value.seconds);
+        storeBig(out + 4, value.ticks);
+    }
+    else if constexpr (std::is_same_v<T, TimeDate64>)
+    {
+        storeBig(out, value.seconds);
+        storeBig(out + 4, value.microseconds);
+    }
+    else
+    {
+        static_assert(std::is_integral_v<T>, "storeBig needs an integer, float, double or TIMEDATE type");
+        const auto bits = static_cast<std::make_unsigned_t<T>>(value);
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            out[i] = static_cast<std::uint8_t>(bits >> (8U * (sizeof(T) - 1U - i)));
+        }
+    }
+}
+
+/** Reads one element in network byte order. */
+template <typename T>
+inline T loadBig(const std::uint8_t *in) noexcept
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        const auto bits = loadBig<std::uint32_t>(in);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        const auto bits = loadBig<std::uint64_t>(in);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    else if constexpr (std::is_same_v<T, TimeDate48>)
+    {
+        return TimeDate48{loadBig<std::uint32_t>(in), loadBig<std::uint16_t>(in + 4)};
+    }
+    else if constexpr (std::is_same_v<T, TimeDate64>)
+    {
+        return TimeDate64{loadBig<std::int32_t>(in), loadBig<std::int32_t>(in + 4)};
+    }
+    else
+    {
+        static_assert(std::is_integral_v<T>, "loadBig needs an integer, float, double or TIMEDATE type");
+        std::make_unsigned_t<T> bits = 0U;
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            bits = static_cast<std::make_unsigned_t<T>>((bits << 8U) | in[i]);
+        }
+        return static_cast<T>(bits);
+    }
+}
+
+/**
+ * Marshalling of one generated dataset struct. Headers written by trdp_gen_datasets specialise it
+ * with kId, kWireSize, a constexpr kFields table and inline encode()/decode().
+ */
+template <typename Dataset>
+struct DatasetCodec;
+
+/** Maps a dataset id to its generated struct (`type`). */
+template <std::uint32_t Id>
+struct DatasetById;
+
+/** Writes `value` as DatasetCodec<Dataset>::kWireSize bytes. */
+template <typename Dataset>
+inline void encodeDataset(const Dataset &value, std::uint8_t *out) noexcept
+{
+    DatasetCodec<Dataset>::encode(value, out);
+}
+
+/** Reads DatasetCodec<Dataset>::kWireSize bytes into `value`. */
+template <typename Dataset>
+inline void decodeDataset(const std::uint8_t *in, Dataset &value) noexcept
+{
+    DatasetCodec<Dataset>::decode(in, value);
+}
+} // namespace trdp::config
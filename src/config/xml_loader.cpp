@@ -1,6 +1,7 @@
 #include "config/xml_loader.h"
 
 #include <cstdint>
+#include <iterator>
 #include <sstream>
 
 #include <tau_xml.h>
@@ -33,6 +34,20 @@ std::string exchangeTypeToString(TRDP_EXCHG_OPTION_T type)
     }
 }
 
+model::TimeoutBehavior convertTimeoutBehavior(TRDP_TO_BEHAVIOR_T behavior)
+{
+    switch (behavior)
+    {
+    case TRDP_TO_SET_TO_ZERO:
+        return model::TimeoutBehavior::SetToZero;
+    case TRDP_TO_KEEP_LAST_VALUE:
+        return model::TimeoutBehavior::KeepLastValue;
+    case TRDP_TO_DEFAULT:
+    default:
+        return model::TimeoutBehavior::Default;
+    }
+}
+
 std::string makeErrorMessage(const std::string &context, TRDP_ERR_T error)
 {
     std::ostringstream ss;
@@ -145,6 +160,18 @@ model::TelegramConfig convertTelegram(const TRDP_EXCHG_PAR_T &telegram)
     {
         cfg.sources.push_back(convertSrc(telegram.pSrc[i]));
     }
+
+    if (telegram.pPdPar != nullptr)
+    {
+        model::PdParameters pd{};
+        pd.cycleUs = telegram.pPdPar->cycle;
+        pd.timeoutUs = telegram.pPdPar->timeout;
+        pd.redundant = telegram.pPdPar->redundant;
+        pd.timeoutBehavior = convertTimeoutBehavior(telegram.pPdPar->toBehav);
+        pd.flags = telegram.pPdPar->flags;
+        pd.offset = telegram.pPdPar->offset;
+        cfg.pd = pd;
+    }
     return cfg;
 }
 
@@ -190,6 +217,11 @@ SimulatorConfigLoadResult loadSimulatorConfigFromXml(const std::string &path)
     {
         result.errors.emplace_back(makeErrorMessage("Device configuration missing or invalid", deviceErr));
     }
+    else
+    {
+        result.config.memory.size = memConfig.size;
+        result.config.memory.preallocate.assign(std::begin(memConfig.prealloc), std::end(memConfig.prealloc));
+    }
 
     UINT32 numComId = 0U;
     TRDP_COMID_DSID_MAP_T *pComIdDsIdMap = nullptr;
@@ -243,6 +275,17 @@ SimulatorConfigLoadResult loadSimulatorConfigFromXml(const std::string &path)
             &pExchgPar);
         if (ifErr == TRDP_NO_ERR)
         {
+            interfaceCfg.process.cycleTimeUs = processConfig.cycleTime;
+            interfaceCfg.process.priority = processConfig.priority;
+            interfaceCfg.process.options = processConfig.options;
+
+            interfaceCfg.pdDefaults.timeoutUs = pdConfig.timeout;
+            interfaceCfg.pdDefaults.timeoutBehavior = convertTimeoutBehavior(pdConfig.toBehavior);
+            interfaceCfg.pdDefaults.flags = pdConfig.flags;
+            interfaceCfg.pdDefaults.port = pdConfig.port;
+            interfaceCfg.pdDefaults.qos = pdConfig.sendParam.qos;
+            interfaceCfg.pdDefaults.ttl = pdConfig.sendParam.ttl;
+
             for (std::uint32_t t = 0; t < numExchgPar; ++t)
             {
                 interfaceCfg.telegrams.push_back(convertTelegram(pExchgPar[t]));
@@ -0,0 +1,869 @@
+#include "control/control_server.h"
+
+#include "util/logging.h"
+#include "util/trace.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+namespace trdp::control
+{
+namespace
+{
+constexpr std::uint8_t kStatusOk = 0U;
+constexpr std::uint8_t kStatusError = 1U;
+constexpr std::uint8_t kStatusEvent = 2U;
+
+enum BinaryOp : std::uint8_t
+{
+    kOpStart = 1U,
+    kOpStop = 2U,
+    kOpSet = 3U,
+    kOpFixed = 4U,
+    kOpUnfix = 5U,
+    kOpJson = 6U,
+};
+
+std::uint32_t loadU32(const char *data)
+{
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(data);
+    return (std::uint32_t{bytes[0]} << 24U) | (std::uint32_t{bytes[1]} << 16U) | (std::uint32_t{bytes[2]} << 8U) |
+           std::uint32_t{bytes[3]};
+}
+
+void appendU32(std::string &out, std::uint32_t value)
+{
+    out.push_back(static_cast<char>(value >> 24U));
+    out.push_back(static_cast<char>(value >> 16U));
+    out.push_back(static_cast<char>(value >> 8U));
+    out.push_back(static_cast<char>(value));
+}
+
+const char *directionName(runtime::PdDirection direction)
+{
+    switch (direction)
+    {
+    case runtime::PdDirection::Outgoing:
+        return "out";
+    case runtime::PdDirection::Incoming:
+        return "in";
+    case runtime::PdDirection::Loopback:
+        return "loopback";
+    case runtime::PdDirection::Unknown:
+        break;
+    }
+    return "unknown";
+}
+
+/** A whole number in [minimum, maximum], from a JSON number. */
+bool wholeNumber(const util::JsonValue *value, double minimum, double maximum, std::uint64_t &out)
+{
+    if (value == nullptr || value->type != util::JsonType::Number || std::floor(value->number) != value->number ||
+        value->number < minimum || value->number > maximum)
+    {
+        return false;
+    }
+    out = static_cast<std::uint64_t>(value->number);
+    return true;
+}
+
+void appendId(std::string &out, const util::JsonValue &id)
+{
+    out += "\"id\":";
+    if (id.type == util::JsonType::String)
+    {
+        util::appendJsonString(out, id.string);
+    }
+    else if (id.type == util::JsonType::Number)
+    {
+        std::ostringstream oss;
+        oss.precision(17);
+        oss << id.number;
+        out += oss.str();
+    }
+    else
+    {
+        out += "null";
+    }
+    out.push_back(',');
+}
+} // namespace
+
+bool ControlServer::TelegramState::operator==(const TelegramState &other) const
+{
+    return publishing == other.publishing && linkLost == other.linkLost && publishCount == other.publishCount &&
+           receiveCount == other.receiveCount && linkLostCount == other.linkLostCount &&
+           destinations == other.destinations;
+}
+
+ControlServer::~ControlServer()
+{
+    stop();
+}
+
+void ControlServer::add(std::uint32_t comId, std::shared_ptr<runtime::PdEndpointControl> endpoint)
+{
+    if (endpoint == nullptr)
+    {
+        return;
+    }
+    slotsByComId_[comId].push_back(telegrams_.size());
+    telegrams_.push_back(Telegram{comId, std::move(endpoint)});
+}
+
+void ControlServer::setPauseHandler(PauseHandler handler)
+{
+    pauseHandler_ = std::move(handler);
+}
+
+bool ControlServer::start(const std::string &path, std::string &error)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        error = "control socket path must have 1 to " + std::to_string(sizeof(address.sun_path) - 1U) + " characters";
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+
+    // Only a socket left behind by an earlier run is replaced, never some other file.
+    struct stat existing{};
+    if (::lstat(path.c_str(), &existing) == 0)
+    {
+        if (!S_ISSOCK(existing.st_mode))
+        {
+            error = path + " exists and is not a socket";
+            return false;
+        }
+        ::unlink(path.c_str());
+    }
+
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    wakeFd_ = ::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+    bool bound = false;
+    if (listenFd_ >= 0 && wakeFd_ >= 0)
+    {
+        // The socket file is created 0600 by bind() itself, so no other user can connect in between.
+        const auto previousMask = ::umask(0077);
+        bound = ::bind(listenFd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0;
+        ::umask(previousMask);
+    }
+    if (!bound || ::listen(listenFd_, 16) != 0)
+    {
+        error = "control socket " + path + ": " + std::strerror(errno);
+        if (bound)
+        {
+            ::unlink(path.c_str());
+        }
+        if (listenFd_ >= 0)
+        {
+            ::close(listenFd_);
+            listenFd_ = -1;
+        }
+        if (wakeFd_ >= 0)
+        {
+            ::close(wakeFd_);
+            wakeFd_ = -1;
+        }
+        return false;
+    }
+
+    path_ = path;
+    running_.store(true);
+    thread_ = std::thread([this] { serve(); });
+    util::logInfo("Control socket listening on " + path_ + " for " + std::to_string(telegrams_.size()) + " telegram(s)");
+    return true;
+}
+
+void ControlServer::stop()
+{
+    if (!running_.exchange(false))
+    {
+        return;
+    }
+    const std::uint64_t one = 1U;
+    (void)::write(wakeFd_, &one, sizeof(one));
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+
+    for (auto &client : clients_)
+    {
+        ::close(client->fd);
+    }
+    clients_.clear();
+    ::close(listenFd_);
+    ::close(wakeFd_);
+    listenFd_ = -1;
+    wakeFd_ = -1;
+    ::unlink(path_.c_str());
+
+    const auto totals = stats();
+    std::ostringstream oss;
+    oss << "Control socket closed after " << totals.connections << " connection(s), " << totals.requests
+        << " request(s), " << totals.operations << " operation(s)";
+    util::logInfo(oss.str());
+}
+
+ControlServerStats ControlServer::stats() const
+{
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return stats_;
+}
+
+void ControlServer::serve()
+{
+    TRDP_TRACE_THREAD_NAME("control");
+    std::vector<pollfd> fds;
+    while (running_.load())
+    {
+        const auto now = std::chrono::steady_clock::now();
+        int timeoutMs = -1;
+        fds.clear();
+        fds.push_back(pollfd{wakeFd_, POLLIN, 0});
+        fds.push_back(pollfd{listenFd_, POLLIN, 0});
+        for (const auto &client : clients_)
+        {
+            const bool pending = client->written < client->output.size();
+            fds.push_back(pollfd{client->fd, static_cast<short>(POLLIN | (pending ? POLLOUT : 0)), 0});
+            if (client->subscribed)
+            {
+                const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(client->nextDelta - now);
+                const int ms = static_cast<int>(std::clamp<std::int64_t>(wait.count(), 0, 1000));
+                timeoutMs = timeoutMs < 0 ? ms : std::min(timeoutMs, ms);
+            }
+        }
+
+        if (::poll(fds.data(), fds.size(), timeoutMs) < 0 && errno != EINTR)
+        {
+            util::logError(std::string("Control socket poll failed: ") + std::strerror(errno));
+            break;
+        }
+        if ((fds[0].revents & POLLIN) != 0)
+        {
+            std::uint64_t drained = 0U;
+            (void)::read(wakeFd_, &drained, sizeof(drained));
+        }
+        if (!running_.load())
+        {
+            break;
+        }
+
+        // Clients accepted below are not in `fds` yet; they are polled from the next pass on.
+        const auto polled = clients_.size();
+        if ((fds[1].revents & POLLIN) != 0)
+        {
+            acceptClients();
+        }
+        for (std::size_t i = 0; i < polled; ++i)
+        {
+            auto &client = *clients_[i];
+            const auto revents = fds[i + 2U].revents;
+            if ((revents & (POLLIN | POLLHUP | POLLERR)) != 0)
+            {
+                readClient(client);
+            }
+        }
+
+        const auto after = std::chrono::steady_clock::now();
+        for (auto &client : clients_)
+        {
+            if (client->subscribed && !client->closing)
+            {
+                pushDeltas(*client, after);
+            }
+            if (!client->closing && client->written < client->output.size())
+            {
+                writeClient(*client);
+            }
+            if (client->output.size() - client->written > kMaxPendingReplyBytes)
+            {
+                util::logWarn("Control client dropped: more than " + std::to_string(kMaxPendingReplyBytes >> 20U) +
+                              " MiB of replies unread");
+                std::lock_guard<std::mutex> lock(statsMutex_);
+                ++stats_.dropped;
+                client->closing = true;
+            }
+        }
+
+        const auto closed = std::remove_if(clients_.begin(), clients_.end(), [](const std::unique_ptr<Client> &client) {
+            if (client->closing)
+            {
+                ::close(client->fd);
+            }
+            return client->closing;
+        });
+        if (closed != clients_.end())
+        {
+            clients_.erase(closed, clients_.end());
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_.clients = clients_.size();
+        }
+    }
+}
+
+void ControlServer::acceptClients()
+{
+    while (true)
+    {
+        const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                util::logWarn(std::string("Control socket accept failed: ") + std::strerror(errno));
+            }
+            return;
+        }
+        auto client = std::make_unique<Client>();
+        client->fd = fd;
+        clients_.push_back(std::move(client));
+
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        ++stats_.connections;
+        stats_.clients = clients_.size();
+    }
+}
+
+void ControlServer::readClient(Client &client)
+{
+    char buffer[65536];
+    while (true)
+    {
+        const auto count = ::recv(client.fd, buffer, sizeof(buffer), 0);
+        if (count > 0)
+        {
+            client.input.append(buffer, static_cast<std::size_t>(count));
+            continue;
+        }
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        // EOF or error: whatever is buffered is still executed, but nobody reads the replies.
+        client.closing = true;
+        break;
+    }
+
+    // A request may switch the client to binary mode, so each one is split off after the previous ran.
+    std::size_t consumed = 0U;
+    while (consumed < client.input.size())
+    {
+        const std::string_view rest(client.input.data() + consumed, client.input.size() - consumed);
+        if (client.binary)
+        {
+            if (rest.size() < 4U)
+            {
+                break;
+            }
+            const auto length = loadU32(rest.data());
+            if (length < 5U || length > kMaxRequestBytes)
+            {
+                util::logWarn("Control client dropped: invalid frame length " + std::to_string(length));
+                std::lock_guard<std::mutex> lock(statsMutex_);
+                ++stats_.dropped;
+                client.closing = true;
+                return;
+            }
+            if (rest.size() < 4U + length)
+            {
+                break;
+            }
+            handleFrame(client, static_cast<std::uint8_t>(rest[4]), loadU32(rest.data() + 5), rest.substr(9U, length - 5U));
+            consumed += 4U + length;
+        }
+        else
+        {
+            const auto newline = rest.find('\n');
+            if (newline == std::string_view::npos)
+            {
+                break;
+            }
+            handleJsonLine(client, rest.substr(0, newline));
+            consumed += newline + 1U;
+        }
+    }
+    client.input.erase(0, consumed);
+
+    if (client.input.size() > kMaxRequestBytes)
+    {
+        util::logWarn("Control client dropped: request longer than " + std::to_string(kMaxRequestBytes) + " bytes");
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        ++stats_.dropped;
+        client.closing = true;
+    }
+}
+
+void ControlServer::writeClient(Client &client)
+{
+    while (client.written < client.output.size())
+    {
+        const auto count = ::send(client.fd, client.output.data() + client.written,
+                                  client.output.size() - client.written, MSG_NOSIGNAL);
+        if (count > 0)
+        {
+            client.written += static_cast<std::size_t>(count);
+            continue;
+        }
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return;
+        }
+        client.closing = true;
+        return;
+    }
+    client.output.clear();
+    client.written = 0U;
+}
+
+void ControlServer::handleJsonLine(Client &client, std::string_view line)
+{
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1U);
+    }
+    if (line.find_first_not_of(" \t") == std::string_view::npos)
+    {
+        return;
+    }
+
+    util::JsonValue request;
+    std::string error;
+    std::string reply;
+    std::size_t operations = 0U;
+    if (!util::parseJson(line, request, error))
+    {
+        reply = "{\"ok\":false,\"error\":";
+        util::appendJsonString(reply, "invalid JSON: " + error);
+        reply.push_back('}');
+    }
+    else
+    {
+        // {"op":"binary"} switches after its own reply, which is still a JSON line.
+        const bool binary = client.binary;
+        operations = executeAll(client, request, reply);
+        if (binary)
+        {
+            appendFrame(client, kStatusOk, 0U, reply);
+            reply.clear();
+        }
+    }
+    if (!reply.empty())
+    {
+        client.output += reply;
+        client.output.push_back('\n');
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    ++stats_.requests;
+    stats_.operations += operations;
+}
+
+void ControlServer::handleFrame(Client &client, std::uint8_t op, std::uint32_t comId, std::string_view body)
+{
+    if (op == kOpJson)
+    {
+        util::JsonValue request;
+        std::string error;
+        std::string reply;
+        std::size_t operations = 1U;
+        if (!util::parseJson(body, request, error))
+        {
+            appendFrame(client, kStatusError, 0U, "invalid JSON: " + error);
+        }
+        else
+        {
+            operations = executeAll(client, request, reply);
+            appendFrame(client, kStatusOk, 0U, reply);
+        }
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        ++stats_.requests;
+        stats_.operations += operations;
+        return;
+    }
+
+    std::string name;
+    std::vector<std::uint8_t> payload;
+    std::chrono::microseconds cycle{0};
+    switch (op)
+    {
+    case kOpStart:
+        name = "start";
+        if (body.size() >= 4U)
+        {
+            cycle = std::chrono::microseconds(loadU32(body.data()));
+        }
+        break;
+    case kOpStop:
+        name = "stop";
+        break;
+    case kOpSet:
+    case kOpFixed:
+        name = op == kOpSet ? "set" : "fixed";
+        payload.assign(body.begin(), body.end());
+        break;
+    case kOpUnfix:
+        name = "unfix";
+        break;
+    default:
+        appendFrame(client, kStatusError, comId, "unknown op " + std::to_string(op));
+        return;
+    }
+
+    std::size_t endpoints = 0U;
+    std::string error;
+    if (applyOperation(name, comId, payload, cycle, endpoints, error))
+    {
+        appendFrame(client, kStatusOk, comId, {});
+    }
+    else
+    {
+        appendFrame(client, kStatusError, comId, error);
+    }
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    ++stats_.requests;
+    ++stats_.operations;
+}
+
+std::size_t ControlServer::executeAll(Client &client, const util::JsonValue &request, std::string &out)
+{
+    if (request.type != util::JsonType::Array)
+    {
+        execute(client, request, out);
+        return 1U;
+    }
+    out.push_back('[');
+    for (std::size_t i = 0; i < request.items.size(); ++i)
+    {
+        if (i != 0U)
+        {
+            out.push_back(',');
+        }
+        execute(client, request.items[i], out);
+    }
+    out.push_back(']');
+    return request.items.size();
+}
+
+void ControlServer::execute(Client &client, const util::JsonValue &request, std::string &out)
+{
+    std::string body;
+    std::string error;
+    const auto *opValue = request.find("op");
+    const std::string op = opValue != nullptr && opValue->type == util::JsonType::String ? opValue->string : "";
+    std::uint64_t comId = 0U;
+    const bool hasComId = wholeNumber(request.find("comId"), 0.0, 4294967295.0, comId);
+    const auto *payloadsValue = request.find("payloads");
+    const bool payloads = payloadsValue != nullptr && payloadsValue->type == util::JsonType::Bool && payloadsValue->boolean;
+
+    bool ok = true;
+    if (op == "start" || op == "stop" || op == "set" || op == "fixed" || op == "unfix")
+    {
+        std::vector<std::uint8_t> payload;
+        std::uint64_t cycleUs = 0U;
+        const auto *cycleValue = request.find("cycleUs");
+        const auto *payloadValue = request.find("payload");
+        std::size_t endpoints = 0U;
+        if (!hasComId)
+        {
+            ok = false;
+            error = "'" + op + "' needs a numeric \"comId\"";
+        }
+        else if (op == "start" && cycleValue != nullptr && !wholeNumber(cycleValue, 1.0, 4294967295.0, cycleUs))
+        {
+            ok = false;
+            error = "\"cycleUs\" must be a whole number of microseconds above zero";
+        }
+        else if ((op == "set" || op == "fixed") &&
+                 (payloadValue == nullptr || payloadValue->type != util::JsonType::String ||
+                  !util::parseHexBytes(payloadValue->string, payload)))
+        {
+            ok = false;
+            error = "'" + op + "' needs \"payload\" as a string of hex bytes";
+        }
+        else
+        {
+            ok = applyOperation(op, static_cast<std::uint32_t>(comId), payload,
+                                std::chrono::microseconds(static_cast<std::int64_t>(cycleUs)), endpoints, error);
+            body = ",\"endpoints\":" + std::to_string(endpoints);
+        }
+    }
+    else if (op == "stats" || op == "list")
+    {
+        body = ",\"telegrams\":[";
+        bool first = true;
+        for (std::size_t slot = 0; slot < telegrams_.size(); ++slot)
+        {
+            if (hasComId && telegrams_[slot].comId != comId)
+            {
+                continue;
+            }
+            if (!first)
+            {
+                body.push_back(',');
+            }
+            first = false;
+            if (op == "stats")
+            {
+                appendTelegram(body, slot, sample(slot), payloads);
+            }
+            else
+            {
+                body += "{\"slot\":" + std::to_string(slot) + ",\"comId\":" + std::to_string(telegrams_[slot].comId) +
+                        ",\"direction\":\"" + directionName(telegrams_[slot].endpoint->direction()) + "\"}";
+            }
+        }
+        body.push_back(']');
+    }
+    else if (op == "subscribe")
+    {
+        std::uint64_t intervalMs = 100U;
+        const auto *intervalValue = request.find("intervalMs");
+        if (intervalValue != nullptr && !wholeNumber(intervalValue, 10.0, 60000.0, intervalMs))
+        {
+            ok = false;
+            error = "\"intervalMs\" must be a whole number from 10 to 60000";
+        }
+        else
+        {
+            client.subscribed = true;
+            client.payloads = payloads;
+            client.interval = std::chrono::milliseconds(intervalMs);
+            client.nextDelta = std::chrono::steady_clock::now();
+            // The first delta after subscribing carries every telegram.
+            client.sent.assign(telegrams_.size(), TelegramState{});
+            client.known.assign(telegrams_.size(), false);
+        }
+    }
+    else if (op == "pause" || op == "resume")
+    {
+        const auto *interfaceValue = request.find("interface");
+        if (interfaceValue != nullptr && interfaceValue->type != util::JsonType::String)
+        {
+            ok = false;
+            error = "\"interface\" must be a string";
+        }
+        else
+        {
+            const auto interfaceName = interfaceValue != nullptr ? interfaceValue->string : std::string{};
+            const std::size_t sessions = pauseHandler_ ? pauseHandler_(op == "pause", interfaceName) : 0U;
+            ok = sessions != 0U;
+            if (ok)
+            {
+                body = ",\"sessions\":" + std::to_string(sessions);
+            }
+            else
+            {
+                error = interfaceName.empty() ? "no sessions" : "no session on interface '" + interfaceName + "'";
+            }
+        }
+    }
+    else if (op == "unsubscribe")
+    {
+        client.subscribed = false;
+    }
+    else if (op == "binary")
+    {
+        client.binary = true;
+    }
+    else if (op == "quit")
+    {
+        util::logInfo("Quit requested on the control socket");
+        quit_.store(true);
+    }
+    else
+    {
+        ok = false;
+        error = op.empty() ? "missing \"op\"" : "unknown op '" + op + "'";
+    }
+
+    out.push_back('{');
+    if (const auto *id = request.find("id"))
+    {
+        appendId(out, *id);
+    }
+    if (ok)
+    {
+        out += "\"ok\":true";
+        out += body;
+    }
+    else
+    {
+        out += "\"ok\":false,\"error\":";
+        util::appendJsonString(out, error);
+    }
+    out.push_back('}');
+}
+
+bool ControlServer::applyOperation(const std::string &op, std::uint32_t comId, const std::vector<std::uint8_t> &payload,
+                                   std::chrono::microseconds cycle, std::size_t &endpoints, std::string &error)
+{
+    TRDP_TRACE_SCOPE_ARG("control op", "comId", comId);
+    endpoints = 0U;
+    const auto slots = slotsByComId_.find(comId);
+    if (slots == slotsByComId_.end())
+    {
+        error = "unknown ComID " + std::to_string(comId);
+        return false;
+    }
+
+    std::size_t failed = 0U;
+    for (const auto slot : slots->second)
+    {
+        const auto &endpoint = telegrams_[slot].endpoint;
+        if (!endpoint->canTransmit())
+        {
+            continue;
+        }
+        ++endpoints;
+        bool applied = false;
+        if (op == "start")
+        {
+            const auto configured = endpoint->configuredCycle().value_or(std::chrono::microseconds(1000000));
+            applied = endpoint->startPublishing(cycle.count() != 0 ? cycle : configured);
+        }
+        else if (op == "stop")
+        {
+            applied = endpoint->stopPublishing();
+        }
+        else if (op == "set")
+        {
+            applied = endpoint->setTxPayload(payload);
+        }
+        else if (op == "fixed")
+        {
+            applied = endpoint->setFixedPayload(payload);
+        }
+        else
+        {
+            applied = endpoint->clearFixedPayload();
+        }
+        if (!applied)
+        {
+            ++failed;
+        }
+    }
+
+    if (endpoints == 0U)
+    {
+        error = "ComID " + std::to_string(comId) + " is not transmitted by this device";
+        return false;
+    }
+    if (failed != 0U)
+    {
+        error = "ComID " + std::to_string(comId) + ": '" + op + "' failed on " + std::to_string(failed) + " of " +
+                std::to_string(endpoints) + " endpoint(s)";
+        return false;
+    }
+    return true;
+}
+
+ControlServer::TelegramState ControlServer::sample(std::size_t slot) const
+{
+    const auto &endpoint = *telegrams_[slot].endpoint;
+    TelegramState state;
+    state.publishing = endpoint.isPublishing();
+    state.linkLost = endpoint.isLinkLost();
+    state.publishCount = endpoint.publishCount();
+    state.receiveCount = endpoint.receiveCount();
+    state.linkLostCount = endpoint.linkLostCount();
+    state.destinations = endpoint.destinationCount();
+    return state;
+}
+
+void ControlServer::appendTelegram(std::string &out, std::size_t slot, const TelegramState &state, bool payloads) const
+{
+    out += "{\"slot\":" + std::to_string(slot) + ",\"comId\":" + std::to_string(telegrams_[slot].comId) +
+           ",\"publishing\":" + (state.publishing ? "true" : "false") +
+           ",\"publishCount\":" + std::to_string(state.publishCount) +
+           ",\"receiveCount\":" + std::to_string(state.receiveCount) +
+           ",\"linkLost\":" + (state.linkLost ? "true" : "false") +
+           ",\"linkLostCount\":" + std::to_string(state.linkLostCount) +
+           ",\"destinations\":" + std::to_string(state.destinations);
+    if (payloads)
+    {
+        const auto &endpoint = *telegrams_[slot].endpoint;
+        const auto rx = endpoint.rxPayload();
+        const auto tx = endpoint.txPayload();
+        out += ",\"rx\":\"";
+        util::appendHex(out, rx.data(), rx.size());
+        out += "\",\"tx\":\"";
+        util::appendHex(out, tx.data(), tx.size());
+        out.push_back('"');
+    }
+    out.push_back('}');
+}
+
+void ControlServer::appendFrame(Client &client, std::uint8_t status, std::uint32_t comId, std::string_view body)
+{
+    appendU32(client.output, static_cast<std::uint32_t>(5U + body.size()));
+    client.output.push_back(static_cast<char>(status));
+    appendU32(client.output, comId);
+    client.output.append(body.data(), body.size());
+}
+
+void ControlServer::pushDeltas(Client &client, std::chrono::steady_clock::time_point now)
+{
+    if (now < client.nextDelta)
+    {
+        return;
+    }
+    client.nextDelta = now + client.interval;
+
+    std::string event = "{\"event\":\"state\",\"telegrams\":[";
+    bool changed = false;
+    for (std::size_t slot = 0; slot < telegrams_.size(); ++slot)
+    {
+        const auto state = sample(slot);
+        if (client.known[slot] && client.sent[slot] == state)
+        {
+            continue;
+        }
+        if (changed)
+        {
+            event.push_back(',');
+        }
+        changed = true;
+        appendTelegram(event, slot, state, client.payloads);
+        client.sent[slot] = state;
+        client.known[slot] = true;
+    }
+    if (!changed)
+    {
+        return;
+    }
+    event += "]}";
+
+    if (client.binary)
+    {
+        appendFrame(client, kStatusEvent, 0U, event);
+    }
+    else
+    {
+        client.output += event;
+        client.output.push_back('\n');
+    }
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    ++stats_.deltas;
+}
+} // namespace trdp::control
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "trdp/pd_endpoint_control.h"
+#include "util/json.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace trdp::control
+{
+struct ControlServerStats
+{
+    std::size_t clients{0};
+    std::uint64_t connections{0};
+    /** Request lines or frames, a batch counting once... */
+    std::uint64_t requests{0};
+    /** ...and the operations they carried. */
+    std::uint64_t operations{0};
+    std::uint64_t deltas{0};
+    /** Clients dropped for oversized requests or for not reading their replies. */
+    std::uint64_t dropped{0};
+};
+
+/**
+ * Lets scripts drive the simulator over a Unix domain socket (`--control PATH`), without the TUI.
+ *
+ * JSON lines: each request is one line, an object or an array of objects executed as one batch
+ * with one reply line (an array of results). Every result has "ok" and echoes the request "id":
+ *
+ *   {"id":1,"op":"start","comId":300,"cycleUs":100000}      start publishing (default: XML cycle)
+ *   {"op":"stop","comId":300}
+ *   {"op":"set","comId":300,"payload":"00ff10"}            TX payload, hex; "fixed"/"unfix" likewise
+ *   {"op":"stats"} / {"op":"stats","comId":300}             counters per telegram
+ *   {"op":"list"}                                           telegrams with slot, ComID and direction
+ *   {"op":"subscribe","intervalMs":100,"payloads":true}     push {"event":"state",...} deltas
+ *   {"op":"pause"} / {"op":"pause","interface":"eth0"}      stop all traffic, handles kept; "resume"
+ *   {"op":"unsubscribe"}, {"op":"quit"} (ends --headless), {"op":"binary"}
+ *
+ * Binary mode (after {"op":"binary"}), for high request rates: a request frame is a big-endian u32
+ * length of the rest, a u8 op and a big-endian u32 ComID, then the body: 1 start (optional u32
+ * cycle in us), 2 stop, 3 set (payload), 4 fixed (payload), 5 unfix, 6 json (one JSON request
+ * line). A reply frame has the same length/u8/u32 header with the status (0 ok, 1 error with the
+ * message as body) and the ComID; the json op replies with its JSON text, and state deltas arrive
+ * as status 2 frames with the JSON event as body.
+ *
+ * One thread serves every client with poll(); operations run on that thread in request order.
+ * Start/stop wait for the owning session, set/fixed/unfix return at once.
+ */
+class ControlServer
+{
+public:
+    /** Pauses or resumes one interface's session, or all if the name is empty; returns how many. */
+    using PauseHandler = std::function<std::size_t(bool paused, const std::string &interfaceName)>;
+
+    static constexpr std::size_t kMaxRequestBytes = 1U << 20U;
+    static constexpr std::size_t kMaxPendingReplyBytes = 16U << 20U;
+
+    ControlServer() = default;
+    ~ControlServer();
+
+    ControlServer(const ControlServer &) = delete;
+    ControlServer &operator=(const ControlServer &) = delete;
+
+    /** Makes a telegram controllable; call before start(). Slots are numbered in the order added. */
+    void add(std::uint32_t comId, std::shared_ptr<runtime::PdEndpointControl> endpoint);
+    /** Serves the pause/resume ops; call before start(). Without a handler they fail. */
+    void setPauseHandler(PauseHandler handler);
+
+    /** Binds the socket (replacing a stale one at `path`) and starts the server thread. */
+    bool start(const std::string &path, std::string &error);
+    /** Disconnects every client, removes the socket file and joins the thread. */
+    void stop();
+
+    /** A client sent {"op":"quit"}. */
+    [[nodiscard]] bool quitRequested() const { return quit_.load(); }
+    [[nodiscard]] ControlServerStats stats() const;
+    [[nodiscard]] const std::string &path() const { return path_; }
+
+private:
+    struct Telegram
+    {
+        std::uint32_t comId{0};
+        std::shared_ptr<runtime::PdEndpointControl> endpoint;
+    };
+
+    /** What a subscriber was last told about one telegram. */
+    struct TelegramState
+    {
+        bool publishing{false};
+        bool linkLost{false};
+        std::uint64_t publishCount{0};
+        std::uint64_t receiveCount{0};
+        std::uint64_t linkLostCount{0};
+        std::size_t destinations{0};
+
+        bool operator==(const TelegramState &other) const;
+    };
+
+    struct Client
+    {
+        int fd{-1};
+        bool binary{false};
+        bool closing{false};
+        std::string input;
+        std::string output;
+        /** Bytes of `output` already written. */
+        std::size_t written{0};
+        bool subscribed{false};
+        bool payloads{false};
+        std::chrono::milliseconds interval{100};
+        std::chrono::steady_clock::time_point nextDelta{};
+        std::vector<TelegramState> sent;
+        std::vector<bool> known;
+    };
+
+    void serve();
+    void acceptClients();
+    void readClient(Client &client);
+    void writeClient(Client &client);
+    void handleJsonLine(Client &client, std::string_view line);
+    void handleFrame(Client &client, std::uint8_t op, std::uint32_t comId, std::string_view body);
+    /** Executes a request or a batch (array) of them; returns the number of operations. */
+    std::size_t executeAll(Client &client, const util::JsonValue &request, std::string &out);
+    /** Executes one request object and appends its result object to `out`. */
+    void execute(Client &client, const util::JsonValue &request, std::string &out);
+    bool applyOperation(const std::string &op, std::uint32_t comId, const std::vector<std::uint8_t> &payload,
+                        std::chrono::microseconds cycle, std::size_t &endpoints, std::string &error);
+    void appendTelegram(std::string &out, std::size_t slot, const TelegramState &state, bool payloads) const;
+    void appendFrame(Client &client, std::uint8_t status, std::uint32_t comId, std::string_view body);
+    void pushDeltas(Client &client, std::chrono::steady_clock::time_point now);
+    [[nodiscard]] TelegramState sample(std::size_t slot) const;
+
+    std::vector<Telegram> telegrams_;
+    std::unordered_map<std::uint32_t, std::vector<std::size_t>> slotsByComId_;
+    PauseHandler pauseHandler_;
+    std::string path_;
+    int listenFd_{-1};
+    int wakeFd_{-1};
+    std::vector<std::unique_ptr<Client>> clients_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> quit_{false};
+    mutable std::mutex statsMutex_;
+    ControlServerStats stats_;
+    std::thread thread_;
+};
+} // namespace trdp::control
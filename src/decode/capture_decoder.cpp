@@ -0,0 +1,103 @@
+#include "decode/capture_decoder.h"
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace trdp::decode
+{
+namespace
+{
+struct ChunkResult
+{
+    std::size_t rangeEnd{0};
+    std::size_t start{0};
+    std::size_t stop{0};
+    DecodeReport report;
+};
+
+/** Decodes the records starting in [from, until); returns the offset after the last one decoded. */
+std::size_t decodeRange(const CaptureFile &file,
+                        std::size_t from,
+                        std::size_t until,
+                        const PdExpectations &expectations,
+                        std::uint16_t port,
+                        DecodeReport &report)
+{
+    PdValidator validator(expectations, report);
+    auto offset = from;
+    while (offset < until)
+    {
+        const auto record = file.recordAt(offset);
+        if (!record)
+        {
+            break; // truncated or corrupt tail; a sequential reader stops here as well
+        }
+        decodeFrame(file.linkType(), record->data, record->size, port, validator);
+        offset = record->nextOffset;
+    }
+    return offset;
+}
+} // namespace
+
+void decodeFrame(std::uint32_t linkType,
+                 const std::uint8_t *frame,
+                 std::size_t size,
+                 std::uint16_t port,
+                 PdValidator &validator)
+{
+    const auto udp = extractUdp(linkType, frame, size);
+    if (!udp || udp->dstPort != port)
+    {
+        validator.skip();
+        return;
+    }
+    (void)validator.validate(udp->payload, udp->size, udp->srcIp, udp->dstIp);
+}
+
+DecodeReport decodeCapture(const CaptureFile &file, const PdExpectations &expectations, const DecodeOptions &options)
+{
+    const auto first = CaptureFile::firstRecordOffset();
+    const auto body = file.size() > first ? file.size() - first : 0U;
+    const auto workers = options.threads != 0U ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+    const auto chunks = static_cast<std::size_t>(
+        std::clamp<std::size_t>(body / std::max<std::size_t>(options.minChunkBytes, 1U), 1U, workers));
+
+    std::vector<ChunkResult> results(chunks);
+    std::vector<std::future<void>> pending;
+    pending.reserve(chunks);
+    for (std::size_t i = 0; i < chunks; ++i)
+    {
+        pending.push_back(std::async(std::launch::async, [&, i] {
+            auto &result = results[i];
+            const auto rangeBegin = first + body * i / chunks;
+            result.rangeEnd = i + 1U == chunks ? file.size() : first + body * (i + 1U) / chunks;
+            result.start = i == 0U ? first : file.findRecordStart(rangeBegin, result.rangeEnd).value_or(result.rangeEnd);
+            result.stop = decodeRange(file, result.start, result.rangeEnd, expectations, options.port, result.report);
+        }));
+    }
+    for (auto &future : pending)
+    {
+        future.wait();
+    }
+
+    // A range must begin exactly where the previous one stopped. Resynchronisation is heuristic, so
+    // any range that guessed a different boundary is decoded again from the right offset.
+    DecodeReport merged = std::move(results.front().report);
+    for (std::size_t i = 1; i < chunks; ++i)
+    {
+        auto &result = results[i];
+        const auto expectedStart = results[i - 1U].stop;
+        if (result.start != expectedStart)
+        {
+            result.report = DecodeReport{};
+            result.start = expectedStart;
+            result.stop = decodeRange(file, expectedStart, result.rangeEnd, expectations, options.port, result.report);
+            result.stop = std::max(result.stop, expectedStart);
+        }
+        merged.merge(result.report);
+    }
+    return merged;
+}
+} // namespace trdp::decode
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "decode/capture_file.h"
+#include "decode/pd_validator.h"
+#include "trdp/pd_frame.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace trdp::decode
+{
+struct DecodeOptions
+{
+    /** Worker threads; 0 uses every hardware thread. */
+    unsigned threads{0};
+    std::uint16_t port{runtime::kPdDefaultPort};
+    /** Files smaller than this per worker are not worth splitting further. */
+    std::size_t minChunkBytes{8U * 1024U * 1024U};
+};
+
+/** Validates one captured link-layer frame if it is a UDP datagram to the PD port. */
+void decodeFrame(std::uint32_t linkType,
+                 const std::uint8_t *frame,
+                 std::size_t size,
+                 std::uint16_t port,
+                 PdValidator &validator);
+
+/**
+ * Decodes a whole capture. The file is split into byte ranges decoded concurrently; each worker
+ * resynchronises on the first record boundary in its range, and the per-range reports are
+ * merged in file order. The result is identical to a single sequential pass.
+ */
+DecodeReport decodeCapture(const CaptureFile &file, const PdExpectations &expectations, const DecodeOptions &options);
+} // namespace trdp::decode
@@ -0,0 +1,228 @@
+#include "decode/capture_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace trdp::decode
+{
+namespace
+{
+constexpr std::uint32_t kMagicMicros = 0xA1B2C3D4U;
+constexpr std::uint32_t kMagicNanos = 0xA1B23C4DU;
+constexpr std::uint16_t kEtherTypeIpv4 = 0x0800U;
+constexpr std::uint16_t kEtherTypeVlan = 0x8100U;
+constexpr std::uint16_t kEtherTypeQinQ = 0x88A8U;
+constexpr std::uint8_t kIpProtocolUdp = 17U;
+constexpr int kResyncRecords = 4;
+constexpr std::uint32_t kMaxRecordBytes = 262144U;
+
+std::uint16_t be16(const std::uint8_t *at)
+{
+    return static_cast<std::uint16_t>((at[0] << 8U) | at[1]);
+}
+
+std::uint32_t be32(const std::uint8_t *at)
+{
+    return (static_cast<std::uint32_t>(at[0]) << 24U) | (static_cast<std::uint32_t>(at[1]) << 16U) |
+           (static_cast<std::uint32_t>(at[2]) << 8U) | at[3];
+}
+
+std::uint32_t bswap32(std::uint32_t value)
+{
+    return __builtin_bswap32(value);
+}
+
+std::optional<UdpView> parseIpv4(const std::uint8_t *packet, std::size_t size)
+{
+    if (size < 20U || (packet[0] >> 4U) != 4U)
+    {
+        return std::nullopt;
+    }
+    const std::size_t headerLength = (packet[0] & 0x0FU) * 4U;
+    const std::size_t totalLength = be16(packet + 2);
+    const auto fragmentOffset = be16(packet + 6) & 0x1FFFU;
+    if (headerLength < 20U || size < headerLength + 8U || packet[9] != kIpProtocolUdp || fragmentOffset != 0U)
+    {
+        return std::nullopt;
+    }
+
+    // Captures may be padded (short Ethernet frames) or truncated by the snap length.
+    const auto ipEnd = std::min(size, std::max(totalLength, headerLength + 8U));
+    const auto *udp = packet + headerLength;
+    const std::size_t udpLength = be16(udp + 4);
+    UdpView view{};
+    view.srcIp = be32(packet + 12);
+    view.dstIp = be32(packet + 16);
+    view.srcPort = be16(udp);
+    view.dstPort = be16(udp + 2);
+    view.payload = udp + 8;
+    view.size = std::min(ipEnd - headerLength, std::max<std::size_t>(udpLength, 8U)) - 8U;
+    return view;
+}
+} // namespace
+
+std::optional<UdpView> extractUdp(std::uint32_t linkType, const std::uint8_t *frame, std::size_t size)
+{
+    switch (linkType)
+    {
+    case kLinkTypeEthernet:
+    {
+        std::size_t offset = 12U;
+        while (offset + 2U <= size)
+        {
+            const auto etherType = be16(frame + offset);
+            if (etherType == kEtherTypeVlan || etherType == kEtherTypeQinQ)
+            {
+                offset += 4U;
+                continue;
+            }
+            if (etherType != kEtherTypeIpv4)
+            {
+                return std::nullopt;
+            }
+            return parseIpv4(frame + offset + 2U, size - offset - 2U);
+        }
+        return std::nullopt;
+    }
+    case kLinkTypeLinuxSll:
+        if (size < 16U || be16(frame + 14) != kEtherTypeIpv4)
+        {
+            return std::nullopt;
+        }
+        return parseIpv4(frame + 16, size - 16U);
+    case kLinkTypeRaw:
+    case kLinkTypeIpv4:
+        return parseIpv4(frame, size);
+    default:
+        return std::nullopt;
+    }
+}
+
+CaptureFile::~CaptureFile()
+{
+    if (data_ != nullptr)
+    {
+        ::munmap(const_cast<std::uint8_t *>(data_), size_);
+    }
+}
+
+bool CaptureFile::open(const std::string &path, std::string &error)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        error = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(kFileHeaderSize))
+    {
+        error = path + " is too short to be a pcap file";
+        ::close(fd);
+        return false;
+    }
+
+    size_ = static_cast<std::size_t>(info.st_size);
+    void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        error = "Cannot map " + path + ": " + std::strerror(errno);
+        size_ = 0U;
+        return false;
+    }
+    // Records are read front to back by every worker.
+    (void)::madvise(mapped, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const std::uint8_t *>(mapped);
+
+    std::uint32_t magic = 0U;
+    std::memcpy(&magic, data_, sizeof(magic));
+    if (magic == kMagicMicros || magic == kMagicNanos)
+    {
+        swapped_ = false;
+    }
+    else if (bswap32(magic) == kMagicMicros || bswap32(magic) == kMagicNanos)
+    {
+        swapped_ = true;
+    }
+    else
+    {
+        error = path + " is not a libpcap capture (pcapng is not supported; convert with editcap -F pcap)";
+        return false;
+    }
+
+    snapLength_ = read32(16U);
+    linkType_ = read32(20U) & 0x0FFFFFFFU;
+    return true;
+}
+
+std::uint32_t CaptureFile::read32(std::size_t offset) const
+{
+    std::uint32_t value = 0U;
+    std::memcpy(&value, data_ + offset, sizeof(value));
+    return swapped_ ? bswap32(value) : value;
+}
+
+std::optional<CaptureRecord> CaptureFile::recordAt(std::size_t offset) const
+{
+    if (offset + kRecordHeaderSize > size_)
+    {
+        return std::nullopt;
+    }
+
+    const auto captured = read32(offset + 8U);
+    const auto original = read32(offset + 12U);
+    const auto end = offset + kRecordHeaderSize + captured;
+    if (captured > original || captured > std::max(snapLength_, kMaxRecordBytes) || end > size_)
+    {
+        return std::nullopt;
+    }
+    return CaptureRecord{data_ + offset + kRecordHeaderSize, captured, end};
+}
+
+std::optional<std::size_t> CaptureFile::findRecordStart(std::size_t from, std::size_t limit) const
+{
+    limit = std::min(limit, size_);
+    for (auto candidate = std::max(from, kFileHeaderSize); candidate < limit; ++candidate)
+    {
+        if (candidate + kRecordHeaderSize > size_)
+        {
+            break;
+        }
+        // Timestamps in the fraction field stay below one second.
+        if (read32(candidate + 4U) >= 1000000000U || !recordAt(candidate))
+        {
+            continue;
+        }
+
+        auto offset = candidate;
+        int chained = 0;
+        while (chained < kResyncRecords)
+        {
+            const auto record = recordAt(offset);
+            if (!record)
+            {
+                break;
+            }
+            ++chained;
+            offset = record->nextOffset;
+            if (offset == size_)
+            {
+                chained = kResyncRecords; // reached the end of the file consistently
+            }
+        }
+        if (chained >= kResyncRecords)
+        {
+            return candidate;
+        }
+    }
+    return std::nullopt;
+}
+} // namespace trdp::decode
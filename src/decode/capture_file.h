@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace trdp::decode
+{
+constexpr std::uint32_t kLinkTypeEthernet = 1U;
+constexpr std::uint32_t kLinkTypeRaw = 101U;
+constexpr std::uint32_t kLinkTypeLinuxSll = 113U;
+constexpr std::uint32_t kLinkTypeIpv4 = 228U;
+
+/** The UDP datagram inside a captured link-layer frame; addresses in host byte order. */
+struct UdpView
+{
+    const std::uint8_t *payload{nullptr};
+    std::size_t size{0};
+    std::uint32_t srcIp{0};
+    std::uint32_t dstIp{0};
+    std::uint16_t srcPort{0};
+    std::uint16_t dstPort{0};
+};
+
+/**
+ * Finds the UDP datagram in an Ethernet (optionally VLAN-tagged), Linux cooked or raw IPv4 frame.
+ * Returns std::nullopt for anything else, including IP fragments after the first.
+ */
+std::optional<UdpView> extractUdp(std::uint32_t linkType, const std::uint8_t *frame, std::size_t size);
+
+/** One record of a capture file. */
+struct CaptureRecord
+{
+    const std::uint8_t *data{nullptr};
+    std::size_t size{0};
+    std::size_t nextOffset{0};
+};
+
+/**
+ * A classic libpcap capture file, memory-mapped read-only so that worker threads can decode
+ * disjoint byte ranges of it concurrently. pcapng is not supported.
+ */
+class CaptureFile
+{
+public:
+    CaptureFile() = default;
+    ~CaptureFile();
+
+    CaptureFile(const CaptureFile &) = delete;
+    CaptureFile &operator=(const CaptureFile &) = delete;
+
+    bool open(const std::string &path, std::string &error);
+
+    [[nodiscard]] std::uint32_t linkType() const { return linkType_; }
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] static constexpr std::size_t firstRecordOffset() { return kFileHeaderSize; }
+
+    /** The record starting at `offset`, or std::nullopt if it is malformed or runs past the end. */
+    [[nodiscard]] std::optional<CaptureRecord> recordAt(std::size_t offset) const;
+
+    /**
+     * First offset in [from, limit) where a record plausibly starts: it and the next few records
+     * parse consistently. Used to begin decoding in the middle of the file.
+     */
+    [[nodiscard]] std::optional<std::size_t> findRecordStart(std::size_t from, std::size_t limit) const;
+
+private:
+    static constexpr std::size_t kFileHeaderSize = 24U;
+    static constexpr std::size_t kRecordHeaderSize = 16U;
+
+    [[nodiscard]] std::uint32_t read32(std::size_t offset) const;
+
+    const std::uint8_t *data_{nullptr};
+    std::size_t size_{0};
+    bool swapped_{false};
+    std::uint32_t snapLength_{0};
+    std::uint32_t linkType_{0};
+};
+} // namespace trdp::decode
@@ -0,0 +1,164 @@
+#include "decode/live_capture.h"
+
+#include <arpa/inet.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace trdp::decode
+{
+namespace
+{
+constexpr std::size_t kBlockSize = 1U << 22U;
+constexpr std::size_t kBlockCount = 64U;
+constexpr std::size_t kFrameSize = 2048U;
+constexpr unsigned kBlockTimeoutMs = 10U;
+} // namespace
+
+LiveCapture::LiveCapture(std::string interfaceName) : interfaceName_(std::move(interfaceName))
+{
+}
+
+LiveCapture::~LiveCapture()
+{
+    close();
+}
+
+bool LiveCapture::open(std::string &error)
+{
+    const auto fail = [this, &error](const std::string &what) {
+        error = what + ": " + std::strerror(errno);
+        close();
+        return false;
+    };
+
+    const auto ifIndex = ::if_nametoindex(interfaceName_.c_str());
+    if (ifIndex == 0U)
+    {
+        error = "Unknown interface " + interfaceName_;
+        return false;
+    }
+
+    socket_ = ::socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons(ETH_P_IP));
+    if (socket_ < 0)
+    {
+        return fail("Cannot open raw socket (needs CAP_NET_RAW)");
+    }
+
+    const int version = TPACKET_V3;
+    if (::setsockopt(socket_, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0)
+    {
+        return fail("TPACKET_V3 unavailable");
+    }
+
+    tpacket_req3 request{};
+    request.tp_block_size = static_cast<unsigned>(kBlockSize);
+    request.tp_block_nr = static_cast<unsigned>(kBlockCount);
+    request.tp_frame_size = static_cast<unsigned>(kFrameSize);
+    request.tp_frame_nr = static_cast<unsigned>(kBlockSize * kBlockCount / kFrameSize);
+    // A partly filled block is handed over after this many milliseconds, bounding the latency.
+    request.tp_retire_blk_tov = kBlockTimeoutMs;
+    if (::setsockopt(socket_, SOL_PACKET, PACKET_RX_RING, &request, sizeof(request)) != 0)
+    {
+        return fail("Cannot set up the receive ring");
+    }
+
+    void *ring = ::mmap(nullptr, kBlockSize * kBlockCount, PROT_READ | PROT_WRITE, MAP_SHARED, socket_, 0);
+    if (ring == MAP_FAILED)
+    {
+        return fail("Cannot map the receive ring");
+    }
+    ring_ = static_cast<std::uint8_t *>(ring);
+    blockSize_ = kBlockSize;
+    blockCount_ = kBlockCount;
+    nextBlock_ = 0U;
+
+    sockaddr_ll address{};
+    address.sll_family = AF_PACKET;
+    address.sll_protocol = htons(ETH_P_IP);
+    address.sll_ifindex = static_cast<int>(ifIndex);
+    if (::bind(socket_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        return fail("Cannot bind to " + interfaceName_);
+    }
+    return true;
+}
+
+void LiveCapture::close()
+{
+    if (ring_ != nullptr)
+    {
+        ::munmap(ring_, blockSize_ * blockCount_);
+        ring_ = nullptr;
+    }
+    if (socket_ >= 0)
+    {
+        ::close(socket_);
+        socket_ = -1;
+    }
+}
+
+std::size_t LiveCapture::poll(const FrameHandler &handler, std::chrono::milliseconds timeout)
+{
+    if (ring_ == nullptr)
+    {
+        return 0U;
+    }
+
+    std::size_t frames = 0U;
+    bool waited = false;
+    while (true)
+    {
+        auto *block = reinterpret_cast<tpacket_block_desc *>(ring_ + nextBlock_ * blockSize_);
+        if ((block->hdr.bh1.block_status & TP_STATUS_USER) == 0U)
+        {
+            if (frames != 0U || waited)
+            {
+                break;
+            }
+            pollfd descriptor{socket_, POLLIN | POLLERR, 0};
+            (void)::poll(&descriptor, 1, static_cast<int>(timeout.count()));
+            waited = true;
+            continue;
+        }
+
+        const auto count = block->hdr.bh1.num_pkts;
+        auto *packet = reinterpret_cast<tpacket3_hdr *>(reinterpret_cast<std::uint8_t *>(block) +
+                                                        block->hdr.bh1.offset_to_first_pkt);
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            handler(reinterpret_cast<const std::uint8_t *>(packet) + packet->tp_mac, packet->tp_snaplen);
+            packet = reinterpret_cast<tpacket3_hdr *>(reinterpret_cast<std::uint8_t *>(packet) + packet->tp_next_offset);
+        }
+        frames += count;
+        stats_.packets += count;
+
+        // Hand the block back to the kernel.
+        __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        nextBlock_ = (nextBlock_ + 1U) % blockCount_;
+    }
+    return frames;
+}
+
+LiveCaptureStats LiveCapture::stats()
+{
+    if (socket_ >= 0)
+    {
+        tpacket_stats_v3 kernel{};
+        socklen_t length = sizeof(kernel);
+        if (::getsockopt(socket_, SOL_PACKET, PACKET_STATISTICS, &kernel, &length) == 0)
+        {
+            // The kernel resets its counters on every read.
+            stats_.kernelDrops += kernel.tp_drops;
+        }
+    }
+    return stats_;
+}
+} // namespace trdp::decode
@@ -0,0 +1,228 @@
+#include "decode/pd_validator.h"
+
+#include "config/dataset_layout.h"
+#include "trdp/pd_frame.h"
+
+namespace trdp::decode
+{
+namespace
+{
+constexpr std::array<const char *, kPdIssueKinds> kIssueNames{
+    "truncated", "bad version", "bad msg type", "bad FCS", "length mismatch",
+    "dataset size", "unknown comId", "sequence gap", "sequence repeat",
+};
+
+constexpr std::uint16_t kMsgTypePull = 0x5070U;    // "Pp"
+constexpr std::uint16_t kMsgTypeRequest = 0x5072U; // "Pr"
+constexpr std::uint16_t kMsgTypeError = 0x5065U;   // "Pe"
+
+bool isPdMsgType(std::uint16_t msgType)
+{
+    return msgType == runtime::kPdMsgTypeData || msgType == kMsgTypePull || msgType == kMsgTypeRequest ||
+           msgType == kMsgTypeError;
+}
+
+constexpr std::uint32_t bit(PdIssue issue)
+{
+    return static_cast<std::uint32_t>(issue);
+}
+
+void countIssues(std::array<std::uint64_t, kPdIssueKinds> &counters, std::uint32_t issues)
+{
+    for (std::size_t i = 0; i < kPdIssueKinds; ++i)
+    {
+        if ((issues & (1U << i)) != 0U)
+        {
+            ++counters[i];
+        }
+    }
+}
+} // namespace
+
+const char *pdIssueName(std::size_t index)
+{
+    return index < kIssueNames.size() ? kIssueNames[index] : "?";
+}
+
+PdExpectations PdExpectations::fromConfig(const model::SimulatorConfig &config)
+{
+    PdExpectations expectations{};
+    for (const auto &mapping : config.comIdDatasetMappings)
+    {
+        expectations.datasetSize[mapping.comId] = config::datasetWireSize(config, mapping.datasetId);
+    }
+    for (const auto &iface : config.interfaces)
+    {
+        for (const auto &telegram : iface.telegrams)
+        {
+            expectations.datasetSize[telegram.comId] = config::datasetWireSize(config, telegram.datasetId);
+        }
+    }
+    return expectations;
+}
+
+std::uint32_t checkSequenceStep(std::uint32_t previous, std::uint32_t next, PdFlowStats &stats)
+{
+    const auto step = next - previous; // modulo 2^32, so counter wrap-around is a normal step
+    if (step == 1U)
+    {
+        return 0U;
+    }
+    if (step == 0U)
+    {
+        ++stats.repeats;
+        return bit(PdIssue::SequenceRepeat);
+    }
+
+    ++stats.gaps;
+    // A backwards jump is a publisher restart or reordering, not a number of lost frames.
+    if (step < 0x80000000U)
+    {
+        stats.missing += step - 1U;
+    }
+    return bit(PdIssue::SequenceGap);
+}
+
+void DecodeReport::merge(const DecodeReport &later)
+{
+    packets += later.packets;
+    pdFrames += later.pdFrames;
+    validFrames += later.validFrames;
+    skipped += later.skipped;
+    bytes += later.bytes;
+    for (std::size_t i = 0; i < issues.size(); ++i)
+    {
+        issues[i] += later.issues[i];
+    }
+    for (const auto &[comId, stats] : later.comIds)
+    {
+        auto &merged = comIds[comId];
+        merged.frames += stats.frames;
+        merged.invalid += stats.invalid;
+        merged.bytes += stats.bytes;
+    }
+
+    for (const auto &[key, stats] : later.flows)
+    {
+        const auto it = flows.find(key);
+        if (it == flows.end())
+        {
+            flows.emplace(key, stats);
+            continue;
+        }
+
+        // The later chunk's first frame continues this chunk's last one; a discontinuity there makes
+        // that frame invalid, exactly as a single sequential pass would have counted it.
+        auto &merged = it->second;
+        const auto boundary = checkSequenceStep(merged.lastSequence, stats.firstSequence, merged);
+        countIssues(issues, boundary);
+        if (boundary != 0U && stats.firstFrameIssues == 0U)
+        {
+            --validFrames;
+            ++comIds[key.comId].invalid;
+        }
+        merged.frames += stats.frames;
+        merged.gaps += stats.gaps;
+        merged.missing += stats.missing;
+        merged.repeats += stats.repeats;
+        merged.lastSequence = stats.lastSequence;
+    }
+}
+
+PdValidator::PdValidator(const PdExpectations &expectations, DecodeReport &report)
+    : expectations_(expectations), report_(report)
+{
+}
+
+std::uint32_t PdValidator::validate(const std::uint8_t *payload,
+                                    std::size_t size,
+                                    std::uint32_t srcIp,
+                                    std::uint32_t dstIp)
+{
+    ++report_.packets;
+    bool validFcs = false;
+    const auto header = runtime::decodePdHeader(payload, size, &validFcs);
+    if (!header)
+    {
+        record(0U, size, bit(PdIssue::Truncated));
+        return bit(PdIssue::Truncated);
+    }
+
+    std::uint32_t issues = 0U;
+    if (!validFcs)
+    {
+        // Nothing else in a header with a broken checksum can be trusted.
+        issues |= bit(PdIssue::BadFcs);
+        record(header->comId, size, issues);
+        return issues;
+    }
+    if ((header->protocolVersion & 0xFF00U) != (runtime::kPdProtocolVersion & 0xFF00U))
+    {
+        issues |= bit(PdIssue::BadVersion);
+    }
+    if (!isPdMsgType(header->msgType))
+    {
+        issues |= bit(PdIssue::BadMsgType);
+    }
+    // Up to three padding bytes after the dataset are tolerated.
+    const auto dataBytes = size - runtime::kPdHeaderSize;
+    if (header->datasetLength > dataBytes)
+    {
+        issues |= bit(PdIssue::Truncated);
+    }
+    else if (dataBytes - header->datasetLength >= 4U)
+    {
+        issues |= bit(PdIssue::LengthMismatch);
+    }
+
+    const auto expected = expectations_.datasetSize.find(header->comId);
+    if (expected == expectations_.datasetSize.end())
+    {
+        issues |= expectations_.strictComIds ? bit(PdIssue::UnknownComId) : 0U;
+    }
+    else if (expected->second && header->msgType != kMsgTypeRequest && header->datasetLength != *expected->second)
+    {
+        issues |= bit(PdIssue::DatasetSizeMismatch);
+    }
+
+    issues |= checkSequence(PdFlowKey{srcIp, dstIp, header->comId, header->msgType}, header->sequenceCounter, issues);
+    record(header->comId, size, issues);
+    return issues;
+}
+
+std::uint32_t PdValidator::checkSequence(const PdFlowKey &key, std::uint32_t sequence, std::uint32_t frameIssues)
+{
+    auto [it, inserted] = report_.flows.try_emplace(key);
+    auto &flow = it->second;
+    std::uint32_t issues = 0U;
+    if (inserted)
+    {
+        flow.firstSequence = sequence;
+        flow.firstFrameIssues = frameIssues;
+    }
+    else
+    {
+        issues = checkSequenceStep(flow.lastSequence, sequence, flow);
+    }
+    flow.lastSequence = sequence;
+    ++flow.frames;
+    return issues;
+}
+
+void PdValidator::record(std::uint32_t comId, std::size_t size, std::uint32_t issues)
+{
+    ++report_.pdFrames;
+    report_.bytes += size;
+    auto &stats = report_.comIds[comId];
+    ++stats.frames;
+    stats.bytes += size;
+    if (issues == 0U)
+    {
+        ++report_.validFrames;
+        return;
+    }
+
+    ++stats.invalid;
+    countIssues(report_.issues, issues);
+}
+} // namespace trdp::decode
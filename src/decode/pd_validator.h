@@ -0,0 +1,137 @@
+#pragma once
+
+#include "model/sim_config.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+namespace trdp::decode
+{
+/** Problems found in a PD frame; a frame may have several. */
+enum class PdIssue : std::uint32_t
+{
+    Truncated = 1U << 0U,
+    BadVersion = 1U << 1U,
+    BadMsgType = 1U << 2U,
+    BadFcs = 1U << 3U,
+    LengthMismatch = 1U << 4U,
+    DatasetSizeMismatch = 1U << 5U,
+    UnknownComId = 1U << 6U,
+    SequenceGap = 1U << 7U,
+    SequenceRepeat = 1U << 8U,
+};
+
+constexpr std::size_t kPdIssueKinds = 9U;
+
+/** Short label of the issue at bit `index`, e.g. "bad FCS". */
+const char *pdIssueName(std::size_t index);
+
+/** What the configuration says a comId's frames must look like. */
+struct PdExpectations
+{
+    /** Dataset wire size per comId; std::nullopt for variable-length datasets. */
+    std::unordered_map<std::uint32_t, std::optional<std::size_t>> datasetSize;
+    /** Flag comIds the configuration does not know. */
+    bool strictComIds{false};
+
+    /** From the XML telegrams and `<com-id-dataset-map>`; telegrams take precedence. */
+    static PdExpectations fromConfig(const model::SimulatorConfig &config);
+};
+
+/** One publisher's sequence counter stream: source, destination, comId and message type. */
+struct PdFlowKey
+{
+    std::uint32_t srcIp{0};
+    std::uint32_t dstIp{0};
+    std::uint32_t comId{0};
+    std::uint16_t msgType{0};
+
+    bool operator==(const PdFlowKey &other) const
+    {
+        return srcIp == other.srcIp && dstIp == other.dstIp && comId == other.comId && msgType == other.msgType;
+    }
+};
+
+struct PdFlowKeyHash
+{
+    std::size_t operator()(const PdFlowKey &key) const
+    {
+        const auto a = (static_cast<std::uint64_t>(key.srcIp) << 32U) | key.dstIp;
+        const auto b = (static_cast<std::uint64_t>(key.comId) << 16U) | key.msgType;
+        return std::hash<std::uint64_t>{}(a * 0x9E3779B97F4A7C15ULL ^ b);
+    }
+};
+
+struct PdFlowStats
+{
+    std::uint64_t frames{0};
+    std::uint32_t firstSequence{0};
+    std::uint32_t lastSequence{0};
+    std::uint64_t gaps{0};
+    std::uint64_t missing{0};
+    std::uint64_t repeats{0};
+    /** Issues other than sequence ones of the flow's first frame, for merging chunk reports. */
+    std::uint32_t firstFrameIssues{0};
+};
+
+struct PdComIdStats
+{
+    std::uint64_t frames{0};
+    std::uint64_t invalid{0};
+    std::uint64_t bytes{0};
+};
+
+/**
+ * Result of decoding part or all of a capture. Reports of consecutive capture chunks merge in
+ * order; sequence continuity across the chunk boundary is checked during the merge.
+ */
+struct DecodeReport
+{
+    std::uint64_t packets{0};
+    std::uint64_t pdFrames{0};
+    std::uint64_t validFrames{0};
+    std::uint64_t skipped{0};
+    std::uint64_t bytes{0};
+    std::array<std::uint64_t, kPdIssueKinds> issues{};
+    std::map<std::uint32_t, PdComIdStats> comIds;
+    std::unordered_map<PdFlowKey, PdFlowStats, PdFlowKeyHash> flows;
+
+    void merge(const DecodeReport &later);
+    [[nodiscard]] std::uint64_t invalidFrames() const { return pdFrames - validFrames; }
+};
+
+/** Validates PD frames (UDP payloads) and accumulates the findings in a report. */
+class PdValidator
+{
+public:
+    PdValidator(const PdExpectations &expectations, DecodeReport &report);
+
+    /** Returns the PdIssue mask of the frame; 0 means valid. */
+    std::uint32_t validate(const std::uint8_t *payload, std::size_t size, std::uint32_t srcIp, std::uint32_t dstIp);
+
+    /** Counts a capture record that carried no PD frame. */
+    void skip()
+    {
+        ++report_.packets;
+        ++report_.skipped;
+    }
+
+private:
+    std::uint32_t checkSequence(const PdFlowKey &key, std::uint32_t sequence, std::uint32_t frameIssues);
+    void record(std::uint32_t comId, std::size_t size, std::uint32_t issues);
+
+    const PdExpectations &expectations_;
+    DecodeReport &report_;
+};
+
+/**
+ * Continuity between two consecutive sequence numbers of one flow, as PdIssue bits, adding to
+ * `stats` the gap and the number of missing frames.
+ */
+std::uint32_t checkSequenceStep(std::uint32_t previous, std::uint32_t next, PdFlowStats &stats);
+} // namespace trdp::decode
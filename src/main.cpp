@@ -1,18 +1,93 @@
+#include "config/cli_options.h"
 #include "config/xml_loader.h"
+#include "shard/shard_worker.h"
 #include "ui/tui_app.h"
+#include "util/log_store.h"
+#include "util/logging.h"
+#include "util/trace.h"
 
 #include <ftxui/component/screen_interactive.hpp>
 #include <iostream>
+#include <memory>
 
 int main(int argc, char **argv)
 {
-    const std::string configPath = argc > 1 ? argv[1] : "config.xml";
+    const auto commandLine = trdp::config::parseCommandLine(argc, argv);
+    if (commandLine.showHelp || commandLine.hasErrors())
+    {
+        for (const auto &error : commandLine.errors)
+        {
+            std::cerr << error << '\n';
+        }
+        (commandLine.hasErrors() ? std::cerr : std::cout) << trdp::config::commandLineUsage(argv[0]);
+        return commandLine.hasErrors() ? 2 : 0;
+    }
 
-    auto result = trdp::config::loadSimulatorConfigFromXml(configPath);
+    const auto &tracePath = commandLine.options.tracePath;
+    if (!tracePath.empty())
+    {
+        if (trdp::util::trace::kProbesCompiledIn)
+        {
+            trdp::util::trace::setEnabled(true);
+        }
+        else
+        {
+            trdp::util::logWarn("--trace ignored: this build has no trace probes (configure with -DTRDP_ENABLE_TRACING=ON)");
+        }
+    }
 
+    const auto &logging = commandLine.options.logging;
+    const auto &shard = commandLine.options.shard;
+    auto logStore = std::make_shared<trdp::util::LogStore>(logging.capacity);
+    trdp::util::setLogStore(logStore);
+    if (!logging.spillPath.empty())
+    {
+        // Workers inherit the command line, so each one writes a file of its own.
+        const auto path =
+            shard.isWorker() ? logging.spillPath + ".shard" + std::to_string(shard.workerInterface) : logging.spillPath;
+        std::string error;
+        if (!logStore->startSpill(trdp::util::LogSpillOptions{path, logging.spillFileBytes}, error))
+        {
+            trdp::util::logWarn("--log-file ignored: " + error);
+        }
+    }
+
+    if (shard.isWorker())
+    {
+        // Outside --headless the UI owns the terminal; worker messages reach its Logs page through the log pipe.
+        if (!commandLine.options.headless)
+        {
+            trdp::util::setConsoleEcho(false);
+        }
+        const auto status = trdp::shard::runShardWorker(commandLine.options);
+        logStore->stopSpill();
+        return status;
+    }
+
+    auto result = trdp::config::loadSimulatorConfigFromXml(commandLine.options.configPath);
+    if (commandLine.options.headless)
+    {
+        const auto status = trdp::ui::RunHeadless(result, commandLine.options);
+        logStore->stopSpill();
+        if (trdp::util::trace::enabled())
+        {
+            trdp::util::trace::dumpToFile(tracePath);
+        }
+        return status;
+    }
+
+    // From here on the TUI owns the terminal; messages are read on the Logs page until quit.
+    trdp::util::setConsoleEcho(false);
+    TRDP_TRACE_THREAD_NAME("ui");
     auto screen = ftxui::ScreenInteractive::TerminalOutput();
-    auto app = trdp::ui::MakeTuiApp(result, configPath, screen.ExitLoopClosure());
+    auto app = trdp::ui::MakeTuiApp(result, commandLine.options, screen.ExitLoopClosure());
     screen.Loop(app);
+    trdp::util::setConsoleEcho(true);
+    logStore->stopSpill();
 
+    if (trdp::util::trace::enabled())
+    {
+        trdp::util::trace::dumpToFile(tracePath);
+    }
     return 0;
 }
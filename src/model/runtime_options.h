@@ -0,0 +1,171 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trdp::model
+{
+enum class SchedulingPolicy
+{
+    Inherit,
+    Other,
+    Fifo,
+    RoundRobin,
+    /** SCHED_FIFO at the XML process priority for session threads; inherit where the XML sets none. */
+    XmlPriority,
+};
+
+/** Scheduling and memory settings applied to a session's process thread when it starts. */
+struct RealtimeProfile
+{
+    SchedulingPolicy policy{SchedulingPolicy::Inherit};
+    int priority{0};
+    std::vector<int> cpus;
+    bool lockMemory{false};
+    std::size_t prefaultStackBytes{0};
+};
+
+/** Raw PD generator (sendmmsg, bypassing the stack) used instead of stack publishers for load tests. */
+struct RawGeneratorOptions
+{
+    bool enabled{false};
+    std::uint32_t batchSize{64};
+    bool txTime{false};
+    /** Divides every telegram's cycle time. */
+    std::uint32_t speedup{1};
+};
+
+/** Sharded mode: one worker process per interface, each owning that interface's session. */
+struct ShardOptions
+{
+    bool enabled{false};
+    /** Set in a worker process only: the interface it owns and the shared-memory descriptors it inherited. */
+    int workerInterface{-1};
+    int stateFd{-1};
+    int commandFd{-1};
+    /** eventfd the UI writes after queueing commands. */
+    int wakeFd{-1};
+    /** Write end of the pipe the worker's log messages go to the UI through. */
+    int logFd{-1};
+    /** The command line minus the program name and any `--shard-worker`, repeated for each worker. */
+    std::vector<std::string> forwardedArguments;
+
+    [[nodiscard]] bool isWorker() const { return workerInterface >= 0; }
+};
+
+/** In-memory log behind the Logs panel and its optional rotating spill file. */
+struct LogOptions
+{
+    std::size_t capacity{1U << 18U};
+    /** Empty keeps messages in memory only. */
+    std::string spillPath;
+    std::size_t spillFileBytes{16U << 20U};
+};
+
+/** How closed recording segments are stored; record/ maps it to the on-disk codec. */
+enum class RecordingCodec
+{
+    Raw,
+    Delta,
+    DeltaLz,
+};
+
+/** PD recording written from the receive path (see record/recording_format.h). */
+struct RecordOptions
+{
+    /** Empty records nothing. */
+    std::string path;
+    std::size_t segmentBytes{8U << 20U};
+    RecordingCodec codec{RecordingCodec::DeltaLz};
+};
+
+enum class ExportFormat
+{
+    Csv,
+    Npy,
+};
+
+/** Decoded RX values written per ComID (see record/value_export.h). */
+struct ExportOptions
+{
+    /** Empty exports nothing. */
+    std::string directory;
+    ExportFormat format{ExportFormat::Csv};
+};
+
+enum class FieldGeneratorKind
+{
+    Constant,
+    Counter,
+    Ramp,
+    Sine,
+    Random,
+    Toggle,
+    Table,
+};
+
+/**
+ * `--gen COMID:FIELD=KIND(ARGS)`: how one field of a published telegram changes from cycle to cycle
+ * (see trdp/payload_generator.h). The command line fills in defaulted arguments, so `args` is complete.
+ */
+struct FieldGeneratorRule
+{
+    std::uint32_t comId{0};
+    /** A flattened field path such as "speed" or "cars[2].speed"; "path[i]" selects one array element. */
+    std::string field;
+    FieldGeneratorKind kind{FieldGeneratorKind::Constant};
+    std::vector<double> args;
+};
+
+/** `--scenario`: timed publisher and payload changes (see scenario/scenario.h). */
+struct ScenarioOptions
+{
+    /** Empty runs no scenario. */
+    std::string path;
+    /** CSV of planned against actual event times, written when the run ends; empty writes none. */
+    std::string reportPath;
+};
+
+/** `--control`: the Unix socket control server (see control/control_server.h). */
+struct ControlOptions
+{
+    /** Empty serves no control socket. */
+    std::string socketPath;
+};
+
+/** `--state-export`: live telegram state in shared memory (see shard/state_export.h). */
+struct StateExportOptions
+{
+    /** Segment name under /dev/shm; empty exports nothing. */
+    std::string name;
+    std::chrono::milliseconds interval{50};
+};
+
+/** Options taken from the command line. */
+struct RuntimeOptions
+{
+    std::string configPath{"config.xml"};
+    RealtimeProfile realtime;
+    /** Per-interface CPU sets overriding `realtime.cpus`, keyed by interface name. */
+    std::unordered_map<std::string, std::vector<int>> interfaceCpus;
+    /** Keep the UI and helper threads off the CPUs given to session threads. */
+    bool isolateCpus{false};
+    RawGeneratorOptions rawGenerator;
+    ShardOptions shard;
+    /** Chrome trace JSON written on exit and on demand; empty when not tracing. */
+    std::string tracePath;
+    LogOptions logging;
+    RecordOptions recording;
+    ExportOptions valueExport;
+    std::vector<FieldGeneratorRule> generators;
+    ScenarioOptions scenario;
+    ControlOptions control;
+    StateExportOptions stateExport;
+    /** Run without the TUI until the scenario ends, a control client quits or a signal arrives. */
+    bool headless{false};
+};
+} // namespace trdp::model
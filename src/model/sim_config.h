@@ -3,6 +3,7 @@
 #include "model/dataset_model.h"
 
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -15,6 +16,24 @@ struct TelegramEndpoint
     std::string uriHost;
 };
 
+enum class TimeoutBehavior
+{
+    Default,
+    SetToZero,
+    KeepLastValue,
+};
+
+/** `<pd-parameter>` of a telegram; times are in microseconds, 0 means "use the interface default". */
+struct PdParameters
+{
+    std::uint32_t cycleUs{0};
+    std::uint32_t timeoutUs{0};
+    std::uint32_t redundant{0};
+    TimeoutBehavior timeoutBehavior{TimeoutBehavior::Default};
+    std::uint8_t flags{0};
+    std::uint16_t offset{0};
+};
+
 struct TelegramConfig
 {
     std::uint32_t comId{0};
@@ -25,6 +44,26 @@ struct TelegramConfig
     std::uint32_t serviceId{0};
     std::vector<TelegramEndpoint> destinations;
     std::vector<TelegramEndpoint> sources;
+    std::optional<PdParameters> pd;
+};
+
+/** `<process-config>` of an interface; zero values fall back to the stack defaults. */
+struct ProcessSettings
+{
+    std::uint32_t cycleTimeUs{0};
+    std::uint32_t priority{0};
+    std::uint8_t options{0};
+};
+
+/** Interface-wide PD defaults (`<pd-com-parameter>`); zero values fall back to the stack defaults. */
+struct PdDefaults
+{
+    std::uint32_t timeoutUs{0};
+    TimeoutBehavior timeoutBehavior{TimeoutBehavior::Default};
+    std::uint8_t flags{0};
+    std::uint16_t port{0};
+    std::uint8_t qos{0};
+    std::uint8_t ttl{0};
 };
 
 struct InterfaceConfig
@@ -33,11 +72,37 @@ struct InterfaceConfig
     std::uint8_t networkId{0U};
     std::string hostIp;
     std::string leaderIp;
+    ProcessSettings process;
+    PdDefaults pdDefaults;
     std::vector<TelegramConfig> telegrams;
 };
 
+/** Device-level TRDP memory settings (`<mem-config>`); all zero when the XML does not provide them. */
+struct MemoryConfig
+{
+    std::uint32_t size{0U};
+    std::vector<std::uint32_t> preallocate;
+
+    [[nodiscard]] bool present() const
+    {
+        if (size != 0U)
+        {
+            return true;
+        }
+        for (const auto count : preallocate)
+        {
+            if (count != 0U)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
 struct SimulatorConfig
 {
+    MemoryConfig memory;
     std::vector<InterfaceConfig> interfaces;
     std::vector<Dataset> datasets;
     std::vector<ComIdDatasetMapping> comIdDatasetMappings;
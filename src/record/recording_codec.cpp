@@ -0,0 +1,583 @@
+#include "record/recording_codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+
+namespace trdp::record
+{
+namespace
+{
+constexpr std::uint8_t kKeyframe = 0x01U;
+constexpr std::uint8_t kAddresses = 0x02U;
+constexpr std::uint8_t kSequence = 0x04U;
+constexpr std::uint8_t kKnownFlags = kKeyframe | kAddresses | kSequence;
+
+constexpr unsigned kHashBits = 14U;
+constexpr std::size_t kMinMatch = 4U;
+constexpr std::size_t kMaxOffset = 0xFFFFU;
+
+void putVarint(std::vector<std::uint8_t> &out, std::uint64_t value)
+{
+    while (value >= 0x80U)
+    {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80U));
+        value >>= 7U;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+void putU32(std::vector<std::uint8_t> &out, std::uint32_t value)
+{
+    for (unsigned shift = 0U; shift < 32U; shift += 8U)
+    {
+        out.push_back(static_cast<std::uint8_t>(value >> shift));
+    }
+}
+
+std::uint64_t zigzag(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1U) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1U) ^ -static_cast<std::int64_t>(value & 1U);
+}
+
+/** Bounds-checked reads over a packed stream; any failure sticks. */
+class Cursor
+{
+public:
+    Cursor(const std::uint8_t *data, std::size_t bytes) : data_(data), bytes_(bytes) {}
+
+    bool varint(std::uint64_t &value)
+    {
+        value = 0U;
+        for (unsigned shift = 0U; shift < 64U && pos_ < bytes_; shift += 7U)
+        {
+            const auto byte = data_[pos_++];
+            value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+            if ((byte & 0x80U) == 0U)
+            {
+                return true;
+            }
+        }
+        ok_ = false;
+        return false;
+    }
+
+    bool u32(std::uint32_t &value)
+    {
+        if (bytes_ - pos_ < 4U)
+        {
+            ok_ = false;
+            return false;
+        }
+        value = 0U;
+        for (unsigned shift = 0U; shift < 32U; shift += 8U)
+        {
+            value |= static_cast<std::uint32_t>(data_[pos_++]) << shift;
+        }
+        return true;
+    }
+
+    const std::uint8_t *take(std::size_t count)
+    {
+        if (bytes_ - pos_ < count)
+        {
+            ok_ = false;
+            return nullptr;
+        }
+        const auto *start = data_ + pos_;
+        pos_ += count;
+        return start;
+    }
+
+    [[nodiscard]] bool ok() const { return ok_; }
+    [[nodiscard]] bool done() const { return pos_ == bytes_; }
+    [[nodiscard]] std::size_t remaining() const { return bytes_ - pos_; }
+
+private:
+    const std::uint8_t *data_;
+    std::size_t bytes_;
+    std::size_t pos_{0};
+    bool ok_{true};
+};
+
+/** Unchanged/changed runs of `current` against `previous`; a changed run absorbs gaps under 4 bytes. */
+void encodeXor(const std::uint8_t *current, const std::uint8_t *previous, std::size_t size,
+               std::vector<std::uint8_t> &out)
+{
+    std::size_t pos = 0U;
+    while (pos < size)
+    {
+        auto same = pos;
+        while (same < size && current[same] == previous[same])
+        {
+            ++same;
+        }
+        putVarint(out, same - pos);
+        pos = same;
+        if (pos == size)
+        {
+            break;
+        }
+
+        auto end = pos;
+        while (end < size)
+        {
+            if (current[end] != previous[end])
+            {
+                ++end;
+                continue;
+            }
+            auto run = end;
+            while (run < size && current[run] == previous[run] && run - end < 4U)
+            {
+                ++run;
+            }
+            if (run - end >= 4U || run == size)
+            {
+                break;
+            }
+            end = run;
+        }
+        putVarint(out, end - pos);
+        for (; pos < end; ++pos)
+        {
+            out.push_back(current[pos] ^ previous[pos]);
+        }
+    }
+}
+
+bool decodeXor(Cursor &in, const std::uint8_t *previous, std::uint8_t *current, std::size_t size)
+{
+    std::size_t pos = 0U;
+    while (pos < size)
+    {
+        std::uint64_t same = 0U;
+        if (!in.varint(same) || same > size - pos)
+        {
+            return false;
+        }
+        std::memcpy(current + pos, previous + pos, same);
+        pos += same;
+        if (pos == size)
+        {
+            break;
+        }
+
+        std::uint64_t changed = 0U;
+        if (!in.varint(changed) || changed == 0U || changed > size - pos)
+        {
+            return false;
+        }
+        const auto *bytes = in.take(changed);
+        if (bytes == nullptr)
+        {
+            return false;
+        }
+        for (std::uint64_t i = 0U; i < changed; ++i, ++pos)
+        {
+            current[pos] = previous[pos] ^ bytes[i];
+        }
+    }
+    return true;
+}
+
+std::uint32_t load32(const std::uint8_t *bytes)
+{
+    std::uint32_t value = 0U;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+void putLength(std::vector<std::uint8_t> &out, std::size_t length)
+{
+    for (; length >= 255U; length -= 255U)
+    {
+        out.push_back(255U);
+    }
+    out.push_back(static_cast<std::uint8_t>(length));
+}
+
+void putSequence(std::vector<std::uint8_t> &out, const std::uint8_t *literals, std::size_t literalBytes,
+                 std::size_t offset, std::size_t matchBytes)
+{
+    const auto matchCode = matchBytes != 0U ? matchBytes - kMinMatch : 0U;
+    out.push_back(static_cast<std::uint8_t>((std::min<std::size_t>(literalBytes, 15U) << 4U) |
+                                            std::min<std::size_t>(matchCode, 15U)));
+    if (literalBytes >= 15U)
+    {
+        putLength(out, literalBytes - 15U);
+    }
+    out.insert(out.end(), literals, literals + literalBytes);
+    if (matchBytes == 0U)
+    {
+        return;
+    }
+    out.push_back(static_cast<std::uint8_t>(offset));
+    out.push_back(static_cast<std::uint8_t>(offset >> 8U));
+    if (matchCode >= 15U)
+    {
+        putLength(out, matchCode - 15U);
+    }
+}
+
+bool readLength(Cursor &in, std::size_t &length, std::size_t limit)
+{
+    while (true)
+    {
+        const auto *byte = in.take(1U);
+        if (byte == nullptr)
+        {
+            return false;
+        }
+        length += *byte;
+        if (length > limit)
+        {
+            return false;
+        }
+        if (*byte != 255U)
+        {
+            return true;
+        }
+    }
+}
+
+struct ComIdState
+{
+    /** Offset of the previous payload in the record area. */
+    std::size_t payload{0};
+    std::uint32_t payloadBytes{0};
+    std::uint32_t sequence{0};
+    std::uint32_t srcIp{0};
+    std::uint32_t destIp{0};
+};
+} // namespace
+
+std::vector<std::uint8_t> packRecords(const std::uint8_t *records, std::size_t bytes)
+{
+    std::vector<std::uint8_t> out;
+    out.reserve(bytes / 4U + 64U);
+    std::vector<std::uint8_t> delta;
+    std::unordered_map<std::uint32_t, ComIdState> states;
+    std::int64_t previousNs = 0;
+
+    std::size_t offset = 0U;
+    while (bytes - offset >= sizeof(RecordHeader))
+    {
+        RecordHeader header{};
+        std::memcpy(&header, records + offset, sizeof(header));
+        const auto padded = paddedRecordBytes(header.payloadBytes);
+        if (padded > bytes - offset)
+        {
+            break;
+        }
+        const auto payload = offset + sizeof(RecordHeader);
+
+        const auto found = states.find(header.comId);
+        const bool known = found != states.end();
+        std::uint8_t flags = 0U;
+        if (!known || found->second.srcIp != header.srcIp || found->second.destIp != header.destIp)
+        {
+            flags |= kAddresses;
+        }
+        if (!known || found->second.sequence + 1U != header.sequence)
+        {
+            flags |= kSequence;
+        }
+        delta.clear();
+        if (known && found->second.payloadBytes == header.payloadBytes)
+        {
+            encodeXor(records + payload, records + found->second.payload, header.payloadBytes, delta);
+        }
+        if (!known || found->second.payloadBytes != header.payloadBytes || delta.size() >= header.payloadBytes)
+        {
+            flags |= kKeyframe;
+        }
+
+        putVarint(out, zigzag(header.timeNs - previousNs));
+        putVarint(out, header.comId);
+        out.push_back(flags);
+        if ((flags & kAddresses) != 0U)
+        {
+            putU32(out, header.srcIp);
+            putU32(out, header.destIp);
+        }
+        if ((flags & kSequence) != 0U)
+        {
+            putVarint(out, header.sequence);
+        }
+        if ((flags & kKeyframe) != 0U)
+        {
+            putVarint(out, header.payloadBytes);
+            out.insert(out.end(), records + payload, records + payload + header.payloadBytes);
+        }
+        else
+        {
+            out.insert(out.end(), delta.begin(), delta.end());
+        }
+
+        previousNs = header.timeNs;
+        states[header.comId] = ComIdState{payload, header.payloadBytes, header.sequence, header.srcIp, header.destIp};
+        offset += padded;
+    }
+    return out;
+}
+
+bool unpackRecords(const std::uint8_t *packed, std::size_t bytes, std::uint32_t count,
+                   std::vector<std::uint8_t> &records)
+{
+    records.clear();
+    std::unordered_map<std::uint32_t, ComIdState> states;
+    std::int64_t previousNs = 0;
+    Cursor in(packed, bytes);
+
+    for (std::uint32_t index = 0U; index < count; ++index)
+    {
+        std::uint64_t timeDelta = 0U;
+        std::uint64_t comId = 0U;
+        const auto *flags = in.varint(timeDelta) && in.varint(comId) ? in.take(1U) : nullptr;
+        if (flags == nullptr || comId > UINT32_MAX || (*flags & ~kKnownFlags) != 0U)
+        {
+            return false;
+        }
+
+        RecordHeader header{};
+        header.timeNs = previousNs + unzigzag(timeDelta);
+        header.comId = static_cast<std::uint32_t>(comId);
+        const auto found = states.find(header.comId);
+        const bool known = found != states.end();
+        if (!known && (*flags & kKnownFlags) != kKnownFlags)
+        {
+            return false;
+        }
+
+        if ((*flags & kAddresses) != 0U)
+        {
+            if (!in.u32(header.srcIp) || !in.u32(header.destIp))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            header.srcIp = found->second.srcIp;
+            header.destIp = found->second.destIp;
+        }
+
+        std::uint64_t sequence = known ? found->second.sequence + 1U : 0U;
+        if ((*flags & kSequence) != 0U && (!in.varint(sequence) || sequence > UINT32_MAX))
+        {
+            return false;
+        }
+        header.sequence = static_cast<std::uint32_t>(sequence);
+
+        std::uint64_t payloadBytes = known ? found->second.payloadBytes : 0U;
+        if ((*flags & kKeyframe) != 0U && (!in.varint(payloadBytes) || payloadBytes > in.remaining()))
+        {
+            return false;
+        }
+        header.payloadBytes = static_cast<std::uint32_t>(payloadBytes);
+
+        const auto start = records.size();
+        const auto payload = start + sizeof(RecordHeader);
+        records.resize(start + paddedRecordBytes(header.payloadBytes));
+        std::memcpy(records.data() + start, &header, sizeof(header));
+        if ((*flags & kKeyframe) != 0U)
+        {
+            std::memcpy(records.data() + payload, in.take(header.payloadBytes), header.payloadBytes);
+        }
+        else if (!decodeXor(in, records.data() + found->second.payload, records.data() + payload, header.payloadBytes))
+        {
+            return false;
+        }
+
+        previousNs = header.timeNs;
+        states[header.comId] = ComIdState{payload, header.payloadBytes, header.sequence, header.srcIp, header.destIp};
+    }
+    return in.ok() && in.done();
+}
+
+std::vector<std::uint8_t> compressBlock(const std::uint8_t *data, std::size_t bytes)
+{
+    std::vector<std::uint8_t> out;
+    out.reserve(bytes / 2U + 16U);
+    putU32(out, static_cast<std::uint32_t>(bytes));
+
+    // Positions + 1, so that 0 means empty.
+    std::vector<std::uint32_t> table(std::size_t{1} << kHashBits, 0U);
+    std::size_t anchor = 0U;
+    std::size_t pos = 0U;
+    while (bytes >= kMinMatch && pos <= bytes - kMinMatch)
+    {
+        const auto sequence = load32(data + pos);
+        auto &slot = table[(sequence * 2654435761U) >> (32U - kHashBits)];
+        const auto candidate = static_cast<std::size_t>(slot);
+        slot = static_cast<std::uint32_t>(pos + 1U);
+        if (candidate != 0U && pos - (candidate - 1U) <= kMaxOffset && load32(data + candidate - 1U) == sequence)
+        {
+            const auto match = candidate - 1U;
+            auto length = kMinMatch;
+            while (pos + length < bytes && data[match + length] == data[pos + length])
+            {
+                ++length;
+            }
+            putSequence(out, data + anchor, pos - anchor, pos - match, length);
+            pos += length;
+            anchor = pos;
+            continue;
+        }
+        // Step faster through data that does not compress.
+        pos += 1U + ((pos - anchor) >> 6U);
+    }
+    putSequence(out, data + anchor, bytes - anchor, 0U, 0U);
+    return out;
+}
+
+bool decompressBlock(const std::uint8_t *data, std::size_t bytes, std::vector<std::uint8_t> &out)
+{
+    Cursor in(data, bytes);
+    std::uint32_t size = 0U;
+    // A length byte of 255 expands to at most 255 bytes, which bounds what a block can claim.
+    if (!in.u32(size) || size / 256U > bytes)
+    {
+        return false;
+    }
+    out.resize(size);
+
+    std::size_t written = 0U;
+    while (true)
+    {
+        const auto *token = in.take(1U);
+        if (token == nullptr)
+        {
+            return false;
+        }
+        std::size_t literals = *token >> 4U;
+        if (literals == 15U && !readLength(in, literals, size - written))
+        {
+            return false;
+        }
+        if (literals != 0U)
+        {
+            const auto *source = literals <= size - written ? in.take(literals) : nullptr;
+            if (source == nullptr)
+            {
+                return false;
+            }
+            std::memcpy(out.data() + written, source, literals);
+            written += literals;
+        }
+        if (in.done())
+        {
+            return written == size;
+        }
+
+        const auto *offsetBytes = in.take(2U);
+        if (offsetBytes == nullptr)
+        {
+            return false;
+        }
+        const std::size_t offset = offsetBytes[0] | (static_cast<std::size_t>(offsetBytes[1]) << 8U);
+        std::size_t length = *token & 0x0FU;
+        if (offset == 0U || offset > written || (length == 15U && !readLength(in, length, size - written)))
+        {
+            return false;
+        }
+        length += kMinMatch;
+        if (length > size - written)
+        {
+            return false;
+        }
+        // Byte by byte: a match may overlap the bytes it produces.
+        for (std::size_t i = 0U; i < length; ++i, ++written)
+        {
+            out[written] = out[written - offset];
+        }
+    }
+}
+
+bool expandSegment(const std::uint8_t *segment, std::vector<std::uint8_t> &image)
+{
+    SegmentHeader header{};
+    std::memcpy(&header, segment, sizeof(header));
+    const auto *directory = segment + header.comIdIndexOffset;
+    const auto *body = directory + std::size_t{header.comIdCount} * sizeof(ComIdDirectoryEntry);
+
+    std::vector<std::uint8_t> decompressed;
+    const std::uint8_t *packed = body;
+    std::size_t packedBytes = header.bodyBytes;
+    if (header.codec == SegmentCodec::DeltaLz)
+    {
+        if (!decompressBlock(body, header.bodyBytes, decompressed))
+        {
+            return false;
+        }
+        packed = decompressed.data();
+        packedBytes = decompressed.size();
+    }
+    else if (header.codec != SegmentCodec::Delta)
+    {
+        return false;
+    }
+
+    std::vector<std::uint8_t> records;
+    if (!unpackRecords(packed, packedBytes, header.recordCount, records) || records.size() != header.recordsBytes)
+    {
+        return false;
+    }
+
+    std::vector<IndexEntry> timeIndex;
+    std::map<std::uint32_t, std::vector<IndexEntry>> byComId;
+    for (std::size_t offset = 0U, index = 0U; offset < records.size(); ++index)
+    {
+        RecordHeader record{};
+        std::memcpy(&record, records.data() + offset, sizeof(record));
+        const IndexEntry entry{record.timeNs, sizeof(SegmentHeader) + offset};
+        if (index % kTimeIndexStride == 0U)
+        {
+            timeIndex.push_back(entry);
+        }
+        byComId[record.comId].push_back(entry);
+        offset += paddedRecordBytes(record.payloadBytes);
+    }
+    if (byComId.size() != header.comIdCount)
+    {
+        return false;
+    }
+
+    SegmentHeader raw = header;
+    raw.codec = SegmentCodec::Raw;
+    raw.bodyBytes = 0U;
+    raw.timeIndexCount = static_cast<std::uint32_t>(timeIndex.size());
+    raw.timeIndexOffset = sizeof(SegmentHeader) + records.size();
+    raw.comIdIndexOffset = raw.timeIndexOffset + timeIndex.size() * sizeof(IndexEntry);
+    auto entriesOffset = raw.comIdIndexOffset + byComId.size() * sizeof(ComIdDirectoryEntry);
+    std::vector<ComIdDirectoryEntry> rebuilt;
+    rebuilt.reserve(byComId.size());
+    for (const auto &[comId, entries] : byComId)
+    {
+        rebuilt.push_back(ComIdDirectoryEntry{comId, static_cast<std::uint32_t>(entries.size()), entriesOffset,
+                                              entries.front().timeNs, entries.back().timeNs});
+        entriesOffset += entries.size() * sizeof(IndexEntry);
+    }
+    raw.segmentBytes = entriesOffset;
+
+    image.resize(raw.segmentBytes);
+    auto *out = image.data();
+    std::memcpy(out, &raw, sizeof(raw));
+    std::memcpy(out + sizeof(raw), records.data(), records.size());
+    std::memcpy(out + raw.timeIndexOffset, timeIndex.data(), timeIndex.size() * sizeof(IndexEntry));
+    std::memcpy(out + raw.comIdIndexOffset, rebuilt.data(), rebuilt.size() * sizeof(ComIdDirectoryEntry));
+    for (std::size_t index = 0U; index < rebuilt.size(); ++index)
+    {
+        const auto &entries = byComId.at(rebuilt[index].comId);
+        std::memcpy(out + rebuilt[index].entriesOffset, entries.data(), entries.size() * sizeof(IndexEntry));
+    }
+    return true;
+}
+} // namespace trdp::record
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "record/recording_format.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace trdp::record
+{
+/**
+ * Re-encodes a raw record area (RecordHeader + payload, padded) for a delta-coded segment.
+ *
+ * Per record: zigzag varint time delta, varint ComID, a flag byte, then only what the previous
+ * record of that ComID does not already give: the addresses, a sequence counter that is not the
+ * previous + 1, and either a keyframe (length + payload) or the XOR against the previous payload
+ * as alternating varint runs of unchanged and changed bytes. A ComID's first record in the area is
+ * always a keyframe, so the result decodes without any other segment.
+ */
+std::vector<std::uint8_t> packRecords(const std::uint8_t *records, std::size_t bytes);
+
+/** Inverse of packRecords(); false if `packed` is malformed or does not hold exactly `count` records. */
+bool unpackRecords(const std::uint8_t *packed, std::size_t bytes, std::uint32_t count,
+                   std::vector<std::uint8_t> &records);
+
+/**
+ * LZ77 block compression in the style of LZ4: a greedy single-pass matcher over a 16K-entry hash
+ * of 4-byte sequences, 64 KiB window. Fast enough to run behind the receive path on a small ARM
+ * board; the ratio comes mostly from packRecords() beforehand.
+ */
+std::vector<std::uint8_t> compressBlock(const std::uint8_t *data, std::size_t bytes);
+
+/** Inverse of compressBlock(); false on a malformed block. */
+bool decompressBlock(const std::uint8_t *data, std::size_t bytes, std::vector<std::uint8_t> &out);
+
+/**
+ * Decodes a delta-coded segment (`segment` points at its SegmentHeader) into the Raw layout:
+ * header, records, time index, comId directory and entry lists, as RecordingWriter writes them
+ * for SegmentCodec::Raw. False if the segment does not decode to what its header announces.
+ */
+bool expandSegment(const std::uint8_t *segment, std::vector<std::uint8_t> &image);
+} // namespace trdp::record
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace trdp::record
+{
+/*
+ * On-disk layout of a PD recording (*.trec), host byte order:
+ *
+ *   FileHeader
+ *   segment 0: SegmentHeader | records | time index | comId directory | comId entry lists
+ *   segment 1: ...
+ *
+ * Segments are appended whole when they close, so a file is readable while it grows and a crash
+ * loses at most the open segment. Records are RecordHeader + payload, padded to 8 bytes, in
+ * non-decreasing time order. The time index holds every kTimeIndexStride-th record; the comId
+ * directory is sorted by comId and points at a list of IndexEntry for every record of that comId.
+ * A query reads the segment headers, then only the index pages and records it needs.
+ *
+ * A delta-coded segment stores SegmentHeader | comId directory | body instead. The body is the
+ * record area re-encoded by packRecords() (recording_codec.h): each ComID starts the segment with a
+ * keyframe, later payloads are XOR runs against the previous one of that ComID, and header fields
+ * that repeat are left out. DeltaLz adds block compression. The directory's entry lists and the
+ * time index are not stored; the reader rebuilds the raw layout when a query touches the segment,
+ * so every segment decodes on its own.
+ */
+
+constexpr char kFileMagic[8] = {'T', 'R', 'D', 'P', 'R', 'E', 'C', '1'};
+constexpr char kSegmentMagic[4] = {'T', 'S', 'E', 'G'};
+constexpr std::uint32_t kFormatVersion = 2U;
+constexpr std::size_t kRecordAlignment = 8U;
+constexpr std::uint32_t kTimeIndexStride = 64U;
+
+struct FileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t headerBytes;
+    /** Nanoseconds since the Unix epoch. */
+    std::int64_t createdNs;
+    std::uint64_t reserved[5];
+};
+
+enum class SegmentCodec : std::uint32_t
+{
+    Raw = 0,
+    Delta = 1,
+    DeltaLz = 2,
+};
+
+inline const char *segmentCodecName(SegmentCodec codec)
+{
+    switch (codec)
+    {
+    case SegmentCodec::Raw:
+        return "raw";
+    case SegmentCodec::Delta:
+        return "delta";
+    case SegmentCodec::DeltaLz:
+        return "lz";
+    }
+    return "?";
+}
+
+struct SegmentHeader
+{
+    char magic[4];
+    std::uint32_t recordCount;
+    std::uint32_t comIdCount;
+    std::uint32_t timeIndexCount;
+    /** Header, records and indexes; the next segment starts this many bytes further on. */
+    std::uint64_t segmentBytes;
+    std::int64_t firstNs;
+    std::int64_t lastNs;
+    /** Offsets from the start of the segment; timeIndexOffset is 0 in delta-coded segments. */
+    std::uint64_t timeIndexOffset;
+    std::uint64_t comIdIndexOffset;
+    SegmentCodec codec;
+    /** Stored size of a delta-coded body, which follows the directory; 0 for Raw. */
+    std::uint32_t bodyBytes;
+    /** Size of the record area once decoded. */
+    std::uint64_t recordsBytes;
+};
+
+struct RecordHeader
+{
+    std::int64_t timeNs;
+    std::uint32_t comId;
+    std::uint32_t sequence;
+    /** IPv4 addresses in host byte order. */
+    std::uint32_t srcIp;
+    std::uint32_t destIp;
+    std::uint32_t payloadBytes;
+    std::uint32_t reserved;
+};
+
+/** A record by time; `offset` is from the start of its segment. */
+struct IndexEntry
+{
+    std::int64_t timeNs;
+    std::uint64_t offset;
+};
+
+struct ComIdDirectoryEntry
+{
+    std::uint32_t comId;
+    std::uint32_t count;
+    /** Offset of `count` IndexEntry from the start of the segment; 0 in delta-coded segments. */
+    std::uint64_t entriesOffset;
+    std::int64_t firstNs;
+    std::int64_t lastNs;
+};
+
+static_assert(sizeof(FileHeader) == 64U);
+static_assert(sizeof(SegmentHeader) == 72U);
+static_assert(sizeof(RecordHeader) == 32U);
+static_assert(sizeof(IndexEntry) == 16U);
+static_assert(sizeof(ComIdDirectoryEntry) == 32U);
+
+constexpr std::size_t paddedRecordBytes(std::uint32_t payloadBytes)
+{
+    return (sizeof(RecordHeader) + payloadBytes + kRecordAlignment - 1U) & ~(kRecordAlignment - 1U);
+}
+} // namespace trdp::record
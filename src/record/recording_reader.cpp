@@ -0,0 +1,297 @@
+#include "record/recording_reader.h"
+
+#include "record/recording_codec.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <map>
+
+namespace trdp::record
+{
+namespace
+{
+bool earlier(const IndexEntry &entry, std::int64_t timeNs)
+{
+    return entry.timeNs < timeNs;
+}
+} // namespace
+
+RecordingReader::~RecordingReader()
+{
+    if (data_ != nullptr)
+    {
+        ::munmap(const_cast<std::uint8_t *>(data_), size_);
+    }
+}
+
+bool RecordingReader::open(const std::string &path, std::string &error)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        error = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader))
+    {
+        error = path + " is not a PD recording";
+        ::close(fd);
+        return false;
+    }
+
+    size_ = static_cast<std::size_t>(info.st_size);
+    void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        error = "cannot map " + path + ": " + std::strerror(errno);
+        size_ = 0U;
+        return false;
+    }
+    data_ = static_cast<const std::uint8_t *>(mapped);
+    // Queries jump between index and record pages; read-ahead would mostly fetch pages nobody asked for.
+    (void)::madvise(mapped, size_, MADV_RANDOM);
+
+    const auto *header = at<FileHeader>(0U);
+    if (std::memcmp(header->magic, kFileMagic, sizeof(kFileMagic)) != 0 || header->version != kFormatVersion ||
+        header->headerBytes < sizeof(FileHeader) || header->headerBytes % kRecordAlignment != 0U ||
+        header->headerBytes > size_)
+    {
+        error = path + " is not a version " + std::to_string(kFormatVersion) + " PD recording";
+        return false;
+    }
+
+    std::size_t offset = header->headerBytes;
+    SegmentHeader segment{};
+    while (validSegment(offset, segment))
+    {
+        segments_.push_back(Segment{offset, segment});
+        records_ += segment.recordCount;
+        recordBytes_ += segment.recordsBytes;
+        ++codecCounts_[static_cast<std::size_t>(segment.codec)];
+        offset += segment.segmentBytes;
+    }
+    trailingBytes_ = size_ - offset;
+    return true;
+}
+
+bool RecordingReader::validSegment(std::size_t offset, SegmentHeader &header) const
+{
+    if (size_ - offset < sizeof(SegmentHeader))
+    {
+        return false;
+    }
+    header = *at<SegmentHeader>(offset);
+    const auto available = size_ - offset;
+    const auto directoryEnd = header.comIdIndexOffset + std::uint64_t{header.comIdCount} * sizeof(ComIdDirectoryEntry);
+    if (std::memcmp(header.magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0 || header.segmentBytes > available ||
+        header.segmentBytes % kRecordAlignment != 0U || directoryEnd > header.segmentBytes ||
+        header.firstNs > header.lastNs)
+    {
+        return false;
+    }
+    switch (header.codec)
+    {
+    case SegmentCodec::Raw:
+        return header.timeIndexOffset == sizeof(SegmentHeader) + header.recordsBytes &&
+               header.comIdIndexOffset ==
+                   header.timeIndexOffset + std::uint64_t{header.timeIndexCount} * sizeof(IndexEntry);
+    case SegmentCodec::Delta:
+    case SegmentCodec::DeltaLz:
+        return header.comIdIndexOffset == sizeof(SegmentHeader) &&
+               directoryEnd + header.bodyBytes <= header.segmentBytes;
+    }
+    return false;
+}
+
+std::int64_t RecordingReader::createdNs() const
+{
+    return data_ != nullptr ? at<FileHeader>(0U)->createdNs : 0;
+}
+
+std::optional<std::int64_t> RecordingReader::firstNs() const
+{
+    if (segments_.empty())
+    {
+        return std::nullopt;
+    }
+    return segments_.front().header.firstNs;
+}
+
+std::optional<std::int64_t> RecordingReader::lastNs() const
+{
+    if (segments_.empty())
+    {
+        return std::nullopt;
+    }
+    return segments_.back().header.lastNs;
+}
+
+std::vector<ComIdSummary> RecordingReader::comIds() const
+{
+    std::map<std::uint32_t, ComIdSummary> merged;
+    for (const auto &segment : segments_)
+    {
+        const auto *directory = at<ComIdDirectoryEntry>(segment.offset + segment.header.comIdIndexOffset);
+        for (std::uint32_t index = 0U; index < segment.header.comIdCount; ++index)
+        {
+            const auto &entry = directory[index];
+            auto [it, inserted] = merged.try_emplace(entry.comId, ComIdSummary{entry.comId, 0U, entry.firstNs, 0});
+            it->second.count += entry.count;
+            it->second.lastNs = entry.lastNs;
+        }
+    }
+
+    std::vector<ComIdSummary> summaries;
+    summaries.reserve(merged.size());
+    for (const auto &entry : merged)
+    {
+        summaries.push_back(entry.second);
+    }
+    return summaries;
+}
+
+std::uint64_t RecordingReader::query(const RecordingQuery &query, const Visitor &visit) const
+{
+    // Segments are in time order: skip those that end before the window, stop at the first that starts after it.
+    auto segment = std::lower_bound(segments_.begin(), segments_.end(), query.fromNs,
+                                    [](const Segment &candidate, std::int64_t fromNs) {
+                                        return candidate.header.lastNs < fromNs;
+                                    });
+    std::uint64_t visited = 0U;
+    std::vector<std::uint8_t> decoded;
+    for (; segment != segments_.end() && segment->header.firstNs < query.toNs; ++segment)
+    {
+        SegmentView view{data_ + segment->offset, segment->header};
+        if (segment->header.codec != SegmentCodec::Raw)
+        {
+            if (query.comId != 0U && !holdsComId(*segment, query))
+            {
+                continue;
+            }
+            if (!expandSegment(view.base, decoded))
+            {
+                // Damaged inside although its header is sound; the other segments still decode.
+                continue;
+            }
+            view = SegmentView{decoded.data(), *reinterpret_cast<const SegmentHeader *>(decoded.data())};
+        }
+        const bool more = query.comId != 0U ? queryComId(view, query, visit, visited)
+                                            : queryAll(view, query, visit, visited);
+        if (!more)
+        {
+            break;
+        }
+    }
+    return visited;
+}
+
+bool RecordingReader::holdsComId(const Segment &segment, const RecordingQuery &query) const
+{
+    // The directory stays uncompressed, so segments without the ComID are skipped undecoded.
+    const auto *directory = at<ComIdDirectoryEntry>(segment.offset + segment.header.comIdIndexOffset);
+    const auto *directoryEnd = directory + segment.header.comIdCount;
+    const auto *entry = std::lower_bound(directory, directoryEnd, query.comId,
+                                         [](const ComIdDirectoryEntry &candidate, std::uint32_t comId) {
+                                             return candidate.comId < comId;
+                                         });
+    return entry != directoryEnd && entry->comId == query.comId && entry->lastNs >= query.fromNs &&
+           entry->firstNs < query.toNs;
+}
+
+std::optional<PdRecordView> RecordingReader::recordAt(const SegmentView &segment, std::uint64_t offset)
+{
+    if (offset < sizeof(SegmentHeader) || offset + sizeof(RecordHeader) > segment.header.timeIndexOffset)
+    {
+        return std::nullopt;
+    }
+    const auto *header = segment.at<RecordHeader>(offset);
+    if (offset + paddedRecordBytes(header->payloadBytes) > segment.header.timeIndexOffset)
+    {
+        return std::nullopt;
+    }
+    return PdRecordView{header->timeNs,
+                        header->comId,
+                        header->sequence,
+                        header->srcIp,
+                        header->destIp,
+                        segment.base + offset + sizeof(RecordHeader),
+                        header->payloadBytes};
+}
+
+bool RecordingReader::queryComId(const SegmentView &segment, const RecordingQuery &query, const Visitor &visit,
+                                 std::uint64_t &visited)
+{
+    const auto *directory = segment.at<ComIdDirectoryEntry>(segment.header.comIdIndexOffset);
+    const auto *directoryEnd = directory + segment.header.comIdCount;
+    const auto *entry = std::lower_bound(directory, directoryEnd, query.comId,
+                                         [](const ComIdDirectoryEntry &candidate, std::uint32_t comId) {
+                                             return candidate.comId < comId;
+                                         });
+    if (entry == directoryEnd || entry->comId != query.comId || entry->lastNs < query.fromNs ||
+        entry->firstNs >= query.toNs ||
+        entry->entriesOffset + std::uint64_t{entry->count} * sizeof(IndexEntry) > segment.header.segmentBytes)
+    {
+        return true;
+    }
+
+    const auto *entries = segment.at<IndexEntry>(entry->entriesOffset);
+    for (const auto *it = std::lower_bound(entries, entries + entry->count, query.fromNs, earlier);
+         it != entries + entry->count && it->timeNs < query.toNs; ++it)
+    {
+        const auto record = recordAt(segment, it->offset);
+        if (!record)
+        {
+            return true;
+        }
+        ++visited;
+        if (!visit(*record))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RecordingReader::queryAll(const SegmentView &segment, const RecordingQuery &query, const Visitor &visit,
+                               std::uint64_t &visited)
+{
+    // Start at the last sampled record before the window, then walk forward.
+    std::uint64_t offset = sizeof(SegmentHeader);
+    const auto *samples = segment.at<IndexEntry>(segment.header.timeIndexOffset);
+    const auto *sample = std::lower_bound(samples, samples + segment.header.timeIndexCount, query.fromNs, earlier);
+    if (sample != samples)
+    {
+        offset = std::prev(sample)->offset;
+    }
+
+    while (offset < segment.header.timeIndexOffset)
+    {
+        const auto record = recordAt(segment, offset);
+        if (!record || record->timeNs >= query.toNs)
+        {
+            return true;
+        }
+        offset += paddedRecordBytes(record->payloadBytes);
+        if (record->timeNs < query.fromNs)
+        {
+            continue;
+        }
+        ++visited;
+        if (!visit(*record))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace trdp::record
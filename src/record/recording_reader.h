@@ -0,0 +1,116 @@
+#pragma once
+
+#include "record/recording_format.h"
+#include "record/recording_writer.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace trdp::record
+{
+/** Records of one comId (0: every comId) with fromNs <= time < toNs. */
+struct RecordingQuery
+{
+    std::uint32_t comId{0};
+    std::int64_t fromNs{std::numeric_limits<std::int64_t>::min()};
+    std::int64_t toNs{std::numeric_limits<std::int64_t>::max()};
+};
+
+struct ComIdSummary
+{
+    std::uint32_t comId{0};
+    std::uint64_t count{0};
+    std::int64_t firstNs{0};
+    std::int64_t lastNs{0};
+};
+
+/**
+ * A PD recording, memory-mapped read-only. open() walks the segment headers only; queries then
+ * binary-search the per-segment indexes, so their cost follows the number of matching records
+ * rather than the size of the file. A delta-coded segment is decoded as a whole when a query
+ * reaches it, which makes the segment the unit of random access for compressed recordings. A
+ * trailing segment cut short (e.g. by a crash) is ignored. Queries may run concurrently.
+ */
+class RecordingReader
+{
+public:
+    /** Return false to stop a query early. */
+    using Visitor = std::function<bool(const PdRecordView &)>;
+
+    RecordingReader() = default;
+    ~RecordingReader();
+
+    RecordingReader(const RecordingReader &) = delete;
+    RecordingReader &operator=(const RecordingReader &) = delete;
+
+    bool open(const std::string &path, std::string &error);
+
+    [[nodiscard]] std::size_t segmentCount() const { return segments_.size(); }
+    [[nodiscard]] std::uint64_t recordCount() const { return records_; }
+    /** Size of the file, and of its record areas once decoded. */
+    [[nodiscard]] std::size_t fileBytes() const { return size_; }
+    [[nodiscard]] std::uint64_t recordBytes() const { return recordBytes_; }
+    /** Segments stored with each SegmentCodec, indexed by its value. */
+    [[nodiscard]] const std::array<std::size_t, 3> &codecCounts() const { return codecCounts_; }
+    /** Bytes after the last complete segment. */
+    [[nodiscard]] std::size_t trailingBytes() const { return trailingBytes_; }
+    [[nodiscard]] std::int64_t createdNs() const;
+    /** Time of the first and last record; nullopt for an empty recording. */
+    [[nodiscard]] std::optional<std::int64_t> firstNs() const;
+    [[nodiscard]] std::optional<std::int64_t> lastNs() const;
+
+    /** Per-comId totals, merged from the segment directories without touching any record. */
+    [[nodiscard]] std::vector<ComIdSummary> comIds() const;
+
+    /** Calls `visit` for each matching record in time order; returns how many were visited. */
+    std::uint64_t query(const RecordingQuery &query, const Visitor &visit) const;
+
+private:
+    struct Segment
+    {
+        std::size_t offset{0};
+        SegmentHeader header{};
+    };
+
+    /** A segment in the Raw layout: in the mapping, or decoded into a buffer. */
+    struct SegmentView
+    {
+        const std::uint8_t *base{nullptr};
+        SegmentHeader header{};
+
+        template <typename T>
+        [[nodiscard]] const T *at(std::uint64_t offset) const
+        {
+            return reinterpret_cast<const T *>(base + offset);
+        }
+    };
+
+    [[nodiscard]] bool validSegment(std::size_t offset, SegmentHeader &header) const;
+    [[nodiscard]] bool holdsComId(const Segment &segment, const RecordingQuery &query) const;
+    [[nodiscard]] static std::optional<PdRecordView> recordAt(const SegmentView &segment, std::uint64_t offset);
+    static bool queryComId(const SegmentView &segment, const RecordingQuery &query, const Visitor &visit,
+                           std::uint64_t &visited);
+    static bool queryAll(const SegmentView &segment, const RecordingQuery &query, const Visitor &visit,
+                         std::uint64_t &visited);
+
+    template <typename T>
+    [[nodiscard]] const T *at(std::size_t offset) const
+    {
+        return reinterpret_cast<const T *>(data_ + offset);
+    }
+
+    const std::uint8_t *data_{nullptr};
+    std::size_t size_{0};
+    std::vector<Segment> segments_;
+    std::uint64_t records_{0};
+    std::uint64_t recordBytes_{0};
+    std::array<std::size_t, 3> codecCounts_{};
+    std::size_t trailingBytes_{0};
+};
+} // namespace trdp::record
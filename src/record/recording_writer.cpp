@@ -0,0 +1,414 @@
+#include "record/recording_writer.h"
+
+#include "record/recording_codec.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace trdp::record
+{
+namespace
+{
+bool writeAll(int fd, const void *data, std::size_t size)
+{
+    const auto *bytes = static_cast<const std::uint8_t *>(data);
+    while (size > 0U)
+    {
+        const auto written = ::write(fd, bytes, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+/** One writev, finished part by part if it comes back short or interrupted. */
+bool writeParts(int fd, const iovec *parts, int count)
+{
+    std::size_t expected = 0U;
+    for (int index = 0; index < count; ++index)
+    {
+        expected += parts[index].iov_len;
+    }
+    const auto written = ::writev(fd, parts, count);
+    if (written >= 0 && static_cast<std::size_t>(written) == expected)
+    {
+        return true;
+    }
+
+    std::size_t done = written < 0 ? 0U : static_cast<std::size_t>(written);
+    for (int index = 0; index < count; ++index)
+    {
+        const auto &part = parts[index];
+        if (done >= part.iov_len)
+        {
+            done -= part.iov_len;
+            continue;
+        }
+        if (!writeAll(fd, static_cast<const std::uint8_t *>(part.iov_base) + done, part.iov_len - done))
+        {
+            return false;
+        }
+        done = 0U;
+    }
+    return true;
+}
+
+std::int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+} // namespace
+
+SegmentCodec segmentCodecFor(model::RecordingCodec codec)
+{
+    switch (codec)
+    {
+    case model::RecordingCodec::Raw:
+        return SegmentCodec::Raw;
+    case model::RecordingCodec::Delta:
+        return SegmentCodec::Delta;
+    case model::RecordingCodec::DeltaLz:
+        return SegmentCodec::DeltaLz;
+    }
+    return SegmentCodec::DeltaLz;
+}
+
+std::string RecordingStats::summary() const
+{
+    std::ostringstream oss;
+    oss << records << " telegrams in " << segments << " segments, " << std::fixed << std::setprecision(1)
+        << static_cast<double>(bytesWritten) / (1U << 20U) << " MiB";
+    if (bytesWritten != 0U && recordBytes != 0U)
+    {
+        oss << " (" << static_cast<double>(recordBytes) / static_cast<double>(bytesWritten) << "x)";
+    }
+    if (dropped != 0U)
+    {
+        oss << "; " << dropped << " dropped";
+    }
+    if (writeFailed)
+    {
+        oss << "; a write failed, the file ends early";
+    }
+    return oss.str();
+}
+
+RecordingWriter::~RecordingWriter()
+{
+    close();
+}
+
+bool RecordingWriter::open(const RecordingOptions &options, std::string &error)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ >= 0)
+    {
+        error = "recording already open";
+        return false;
+    }
+
+    const int fd = ::open(options.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        error = "cannot create " + options.path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kFileMagic, sizeof(header.magic));
+    header.version = kFormatVersion;
+    header.headerBytes = sizeof(FileHeader);
+    header.createdNs = nowNs();
+    if (!writeAll(fd, &header, sizeof(header)))
+    {
+        error = "cannot write " + options.path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    options_ = options;
+    options_.segmentBytes = std::max<std::size_t>(options_.segmentBytes, 64U << 10U);
+    options_.maxSegmentAge = std::max(options_.maxSegmentAge, std::chrono::milliseconds(10));
+    fd_ = fd;
+    stop_ = false;
+    open_ = Segment{};
+    pending_.clear();
+    pendingBytes_ = 0U;
+    lastNs_ = 0;
+    stats_ = RecordingStats{};
+    stats_.bytesWritten = sizeof(header);
+    thread_ = std::thread([this] { writerLoop(); });
+    return true;
+}
+
+void RecordingWriter::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!thread_.joinable() || stop_)
+        {
+            return;
+        }
+        closeSegmentLocked();
+        stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool RecordingWriter::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fd_ >= 0 && !stop_;
+}
+
+void RecordingWriter::append(const PdRecordView &record)
+{
+    bool segmentClosed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fd_ < 0 || stop_)
+        {
+            return;
+        }
+        if (pendingBytes_ >= kMaxPendingBytes)
+        {
+            ++stats_.dropped;
+            return;
+        }
+
+        auto &segment = open_;
+        const auto timeNs = std::max(record.timeNs, lastNs_);
+        lastNs_ = timeNs;
+        if (segment.count == 0U)
+        {
+            segment.firstNs = timeNs;
+            segment.openedAt = std::chrono::steady_clock::now();
+            segment.records.reserve(options_.segmentBytes + paddedRecordBytes(record.payloadBytes));
+        }
+
+        const auto offset = sizeof(SegmentHeader) + segment.records.size();
+        if (segment.count % kTimeIndexStride == 0U)
+        {
+            segment.timeIndex.push_back(IndexEntry{timeNs, offset});
+        }
+        segment.byComId[record.comId].push_back(IndexEntry{timeNs, offset});
+
+        RecordHeader header{timeNs, record.comId, record.sequence, record.srcIp, record.destIp, record.payloadBytes, 0U};
+        const auto start = segment.records.size();
+        segment.records.resize(start + paddedRecordBytes(record.payloadBytes));
+        std::memcpy(segment.records.data() + start, &header, sizeof(header));
+        if (record.payloadBytes != 0U)
+        {
+            std::memcpy(segment.records.data() + start + sizeof(header), record.payload, record.payloadBytes);
+        }
+        segment.lastNs = timeNs;
+        ++segment.count;
+        ++stats_.records;
+
+        if (segment.records.size() >= options_.segmentBytes)
+        {
+            closeSegmentLocked();
+            segmentClosed = true;
+        }
+    }
+    if (segmentClosed)
+    {
+        wake_.notify_one();
+    }
+}
+
+RecordingStats RecordingWriter::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void RecordingWriter::closeSegmentLocked()
+{
+    if (open_.count == 0U)
+    {
+        return;
+    }
+    pendingBytes_ += open_.records.size();
+    pending_.push_back(std::move(open_));
+    open_ = Segment{};
+}
+
+void RecordingWriter::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        wake_.wait_for(lock, options_.maxSegmentAge, [this] { return stop_ || !pending_.empty(); });
+        if (open_.count != 0U && std::chrono::steady_clock::now() - open_.openedAt >= options_.maxSegmentAge)
+        {
+            closeSegmentLocked();
+        }
+
+        while (!pending_.empty())
+        {
+            auto segment = std::move(pending_.front());
+            pending_.pop_front();
+            pendingBytes_ -= segment.records.size();
+            if (stats_.writeFailed)
+            {
+                // The file ends in a partial segment now; anything appended after it would be unreachable.
+                stats_.dropped += segment.count;
+                continue;
+            }
+            lock.unlock();
+            const bool written = writeSegment(segment);
+            lock.lock();
+            if (!written)
+            {
+                stats_.writeFailed = true;
+            }
+        }
+        if (stop_)
+        {
+            return;
+        }
+    }
+}
+
+bool RecordingWriter::writeSegment(const Segment &segment)
+{
+    SegmentHeader header{};
+    std::memcpy(header.magic, kSegmentMagic, sizeof(header.magic));
+    header.recordCount = segment.count;
+    header.comIdCount = static_cast<std::uint32_t>(segment.byComId.size());
+    header.firstNs = segment.firstNs;
+    header.lastNs = segment.lastNs;
+    header.codec = options_.codec;
+    header.recordsBytes = segment.records.size();
+
+    const bool written = options_.codec == SegmentCodec::Raw ? writeRawSegment(segment, header)
+                                                             : writeDeltaSegment(segment, header);
+    if (!written)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.segments;
+    stats_.bytesWritten += header.segmentBytes;
+    stats_.recordBytes += header.recordsBytes;
+    return true;
+}
+
+std::vector<std::uint32_t> RecordingWriter::sortedComIds(const Segment &segment)
+{
+    std::vector<std::uint32_t> comIds;
+    comIds.reserve(segment.byComId.size());
+    for (const auto &entry : segment.byComId)
+    {
+        comIds.push_back(entry.first);
+    }
+    std::sort(comIds.begin(), comIds.end());
+    return comIds;
+}
+
+bool RecordingWriter::writeRawSegment(const Segment &segment, SegmentHeader &header)
+{
+    const auto comIds = sortedComIds(segment);
+    header.timeIndexCount = static_cast<std::uint32_t>(segment.timeIndex.size());
+    header.timeIndexOffset = sizeof(SegmentHeader) + segment.records.size();
+    header.comIdIndexOffset = header.timeIndexOffset + segment.timeIndex.size() * sizeof(IndexEntry);
+
+    std::vector<ComIdDirectoryEntry> directory;
+    directory.reserve(comIds.size());
+    auto entriesOffset = header.comIdIndexOffset + comIds.size() * sizeof(ComIdDirectoryEntry);
+    for (const auto comId : comIds)
+    {
+        const auto &entries = segment.byComId.at(comId);
+        directory.push_back(ComIdDirectoryEntry{comId, static_cast<std::uint32_t>(entries.size()), entriesOffset,
+                                                entries.front().timeNs, entries.back().timeNs});
+        entriesOffset += entries.size() * sizeof(IndexEntry);
+    }
+    header.segmentBytes = entriesOffset;
+
+    // Header, records, time index and directory in one writev; the entry lists follow.
+    const iovec parts[4] = {
+        {&header, sizeof(header)},
+        {const_cast<std::uint8_t *>(segment.records.data()), segment.records.size()},
+        {const_cast<IndexEntry *>(segment.timeIndex.data()), segment.timeIndex.size() * sizeof(IndexEntry)},
+        {directory.data(), directory.size() * sizeof(ComIdDirectoryEntry)},
+    };
+    if (!writeParts(fd_, parts, 4))
+    {
+        return false;
+    }
+    for (const auto comId : comIds)
+    {
+        const auto &entries = segment.byComId.at(comId);
+        if (!writeAll(fd_, entries.data(), entries.size() * sizeof(IndexEntry)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RecordingWriter::writeDeltaSegment(const Segment &segment, SegmentHeader &header)
+{
+    const auto comIds = sortedComIds(segment);
+    std::vector<ComIdDirectoryEntry> directory;
+    directory.reserve(comIds.size());
+    for (const auto comId : comIds)
+    {
+        const auto &entries = segment.byComId.at(comId);
+        directory.push_back(ComIdDirectoryEntry{comId, static_cast<std::uint32_t>(entries.size()), 0U,
+                                                entries.front().timeNs, entries.back().timeNs});
+    }
+
+    auto body = packRecords(segment.records.data(), segment.records.size());
+    if (header.codec == SegmentCodec::DeltaLz)
+    {
+        auto compressed = compressBlock(body.data(), body.size());
+        if (compressed.size() < body.size())
+        {
+            body = std::move(compressed);
+        }
+        else
+        {
+            header.codec = SegmentCodec::Delta;
+        }
+    }
+
+    static constexpr std::uint8_t kPadding[kRecordAlignment] = {};
+    const auto padding = (kRecordAlignment - body.size() % kRecordAlignment) % kRecordAlignment;
+    header.comIdIndexOffset = sizeof(SegmentHeader);
+    header.bodyBytes = static_cast<std::uint32_t>(body.size());
+    header.segmentBytes =
+        sizeof(SegmentHeader) + directory.size() * sizeof(ComIdDirectoryEntry) + body.size() + padding;
+
+    const iovec parts[4] = {
+        {&header, sizeof(header)},
+        {directory.data(), directory.size() * sizeof(ComIdDirectoryEntry)},
+        {body.data(), body.size()},
+        {const_cast<std::uint8_t *>(kPadding), padding},
+    };
+    return writeParts(fd_, parts, 4);
+}
+} // namespace trdp::record
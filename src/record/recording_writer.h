@@ -0,0 +1,120 @@
+#pragma once
+
+#include "model/runtime_options.h"
+#include "record/recording_format.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace trdp::record
+{
+/** One recorded PD telegram; `payload` points into the caller's buffer or the mapped file. */
+struct PdRecordView
+{
+    std::int64_t timeNs{0};
+    std::uint32_t comId{0};
+    std::uint32_t sequence{0};
+    std::uint32_t srcIp{0};
+    std::uint32_t destIp{0};
+    const std::uint8_t *payload{nullptr};
+    std::uint32_t payloadBytes{0};
+};
+
+struct RecordingOptions
+{
+    std::string path;
+    /** A segment closes when its records reach this size... */
+    std::size_t segmentBytes{8U << 20U};
+    /** ...or when it is this old, so a reader opening the growing file sees recent traffic. */
+    std::chrono::milliseconds maxSegmentAge{1000};
+    /** How closed segments are stored; encoding runs on the writer thread, not in append(). */
+    SegmentCodec codec{SegmentCodec::DeltaLz};
+};
+
+/** On-disk codec for the --record-codec choice. */
+SegmentCodec segmentCodecFor(model::RecordingCodec codec);
+
+struct RecordingStats
+{
+    std::uint64_t records{0};
+    std::uint64_t segments{0};
+    std::uint64_t bytesWritten{0};
+    /** Size of the written segments' record areas before encoding. */
+    std::uint64_t recordBytes{0};
+    /** Records discarded because more than kMaxPendingBytes of closed segments waited for the disk. */
+    std::uint64_t dropped{0};
+    bool writeFailed{false};
+
+    /** One line for the shutdown log, e.g. "120000 telegrams in 3 segments, 0.4 MiB (41.2x)". */
+    [[nodiscard]] std::string summary() const;
+};
+
+/**
+ * Append-only writer of a PD recording (see recording_format.h).
+ *
+ * append() copies the telegram into the open segment under a mutex and never touches the disk;
+ * closed segments are encoded, indexed and written by a background thread. Several sessions may share one
+ * writer. Times are clamped to be non-decreasing so the indexes stay sorted across threads.
+ */
+class RecordingWriter
+{
+public:
+    static constexpr std::size_t kMaxPendingBytes = 64U << 20U;
+
+    RecordingWriter() = default;
+    ~RecordingWriter();
+
+    RecordingWriter(const RecordingWriter &) = delete;
+    RecordingWriter &operator=(const RecordingWriter &) = delete;
+
+    /** Creates (or truncates) the file and starts the writer thread. */
+    bool open(const RecordingOptions &options, std::string &error);
+    /** Writes the open segment and stops the writer thread; further appends are ignored. */
+    void close();
+    [[nodiscard]] bool isOpen() const;
+
+    void append(const PdRecordView &record);
+
+    [[nodiscard]] RecordingStats stats() const;
+    [[nodiscard]] const std::string &path() const { return options_.path; }
+
+private:
+    struct Segment
+    {
+        std::vector<std::uint8_t> records;
+        std::vector<IndexEntry> timeIndex;
+        std::unordered_map<std::uint32_t, std::vector<IndexEntry>> byComId;
+        std::uint32_t count{0};
+        std::int64_t firstNs{0};
+        std::int64_t lastNs{0};
+        std::chrono::steady_clock::time_point openedAt{};
+    };
+
+    void closeSegmentLocked();
+    void writerLoop();
+    bool writeSegment(const Segment &segment);
+    bool writeRawSegment(const Segment &segment, SegmentHeader &header);
+    bool writeDeltaSegment(const Segment &segment, SegmentHeader &header);
+    static std::vector<std::uint32_t> sortedComIds(const Segment &segment);
+
+    RecordingOptions options_;
+    int fd_{-1};
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    Segment open_;
+    std::deque<Segment> pending_;
+    std::size_t pendingBytes_{0};
+    std::int64_t lastNs_{0};
+    bool stop_{false};
+    RecordingStats stats_;
+    std::thread thread_;
+};
+} // namespace trdp::record
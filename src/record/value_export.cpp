@@ -0,0 +1,572 @@
+#include "record/value_export.h"
+
+#include "config/dataset_codec.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <sstream>
+#include <utility>
+
+namespace trdp::record
+{
+namespace
+{
+using config::DatasetScalar;
+using config::ElementType;
+
+/** NumPy byte-order mark of this host; columns are written in host order. */
+constexpr char kNpyOrder = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? '<' : '>';
+/** Preamble and header dictionary of every .npy file, padded so the shape can grow in place. */
+constexpr std::size_t kNpyHeaderBytes = 128U;
+
+struct NpyType
+{
+    char kind;
+    std::size_t size;
+};
+
+/** TIMEDATE48/64 become REAL64 seconds; everything else keeps its width. */
+NpyType npyType(ElementType type)
+{
+    switch (type)
+    {
+    case ElementType::Bitset8:
+    case ElementType::UInt8:
+        return {'u', 1U};
+    case ElementType::Char8:
+    case ElementType::Int8:
+        return {'i', 1U};
+    case ElementType::Utf16:
+    case ElementType::UInt16:
+        return {'u', 2U};
+    case ElementType::Int16:
+        return {'i', 2U};
+    case ElementType::Int32:
+        return {'i', 4U};
+    case ElementType::UInt32:
+    case ElementType::TimeDate32:
+        return {'u', 4U};
+    case ElementType::Int64:
+        return {'i', 8U};
+    case ElementType::UInt64:
+        return {'u', 8U};
+    case ElementType::Real32:
+        return {'f', 4U};
+    case ElementType::Real64:
+    case ElementType::TimeDate48:
+    case ElementType::TimeDate64:
+    case ElementType::Dataset:
+        return {'f', 8U};
+    }
+    return {'f', 8U};
+}
+
+double timeDateSeconds(ElementType type, const DatasetScalar &value)
+{
+    if (type == ElementType::TimeDate48)
+    {
+        return static_cast<double>(value.integer >> 16) + static_cast<double>(value.integer & 0xFFFF) / 65536.0;
+    }
+    const auto microseconds = static_cast<std::int32_t>(value.integer);
+    return static_cast<double>(value.integer >> 32) + static_cast<double>(microseconds) / 1e6;
+}
+
+void storeNative(ElementType type, const DatasetScalar &value, std::uint8_t *out)
+{
+    const auto store = [out](auto native) { std::memcpy(out, &native, sizeof(native)); };
+    switch (type)
+    {
+    case ElementType::Bitset8:
+    case ElementType::UInt8:
+        store(static_cast<std::uint8_t>(value.integer));
+        break;
+    case ElementType::Char8:
+    case ElementType::Int8:
+        store(static_cast<std::int8_t>(value.integer));
+        break;
+    case ElementType::Utf16:
+    case ElementType::UInt16:
+        store(static_cast<std::uint16_t>(value.integer));
+        break;
+    case ElementType::Int16:
+        store(static_cast<std::int16_t>(value.integer));
+        break;
+    case ElementType::Int32:
+        store(static_cast<std::int32_t>(value.integer));
+        break;
+    case ElementType::UInt32:
+    case ElementType::TimeDate32:
+        store(static_cast<std::uint32_t>(value.integer));
+        break;
+    case ElementType::Int64:
+    case ElementType::UInt64:
+        store(value.integer);
+        break;
+    case ElementType::Real32:
+        store(static_cast<float>(value.real));
+        break;
+    case ElementType::Real64:
+        store(value.real);
+        break;
+    case ElementType::TimeDate48:
+    case ElementType::TimeDate64:
+        store(timeDateSeconds(type, value));
+        break;
+    case ElementType::Dataset:
+        break;
+    }
+}
+
+void appendCsvValue(std::string &out, ElementType type, const DatasetScalar &value)
+{
+    char text[32];
+    switch (type)
+    {
+    case ElementType::UInt64:
+        std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value.integer));
+        break;
+    case ElementType::Real32:
+        std::snprintf(text, sizeof(text), "%.9g", value.real);
+        break;
+    case ElementType::Real64:
+        std::snprintf(text, sizeof(text), "%.17g", value.real);
+        break;
+    case ElementType::TimeDate48:
+    case ElementType::TimeDate64:
+        std::snprintf(text, sizeof(text), "%.6f", timeDateSeconds(type, value));
+        break;
+    default:
+        std::snprintf(text, sizeof(text), "%lld", static_cast<long long>(value.integer));
+        break;
+    }
+    out += text;
+}
+
+/** "2025-10-18T10:00:00.123456Z" */
+void appendIsoTime(std::string &out, std::int64_t ns)
+{
+    const auto seconds = static_cast<std::time_t>(ns / 1000000000);
+    std::tm utc{};
+    ::gmtime_r(&seconds, &utc);
+    char text[40];
+    const auto length = std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &utc);
+    std::snprintf(text + length, sizeof(text) - length, ".%06lldZ",
+                  static_cast<long long>((ns % 1000000000) / 1000));
+    out += text;
+}
+
+std::string fileName(std::string name)
+{
+    std::replace(name.begin(), name.end(), '/', '_');
+    return name;
+}
+
+bool writeAll(int fd, const void *data, std::size_t size)
+{
+    const auto *bytes = static_cast<const std::uint8_t *>(data);
+    while (size > 0U)
+    {
+        const auto written = ::write(fd, bytes, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+bool writeAllAt(int fd, const void *data, std::size_t size, off_t offset)
+{
+    const auto *bytes = static_cast<const std::uint8_t *>(data);
+    while (size > 0U)
+    {
+        const auto written = ::pwrite(fd, bytes, size, offset);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+        offset += written;
+    }
+    return true;
+}
+
+/**
+ * Appends `rows` items to a .npy file holding `previousRows`, then rewrites the header with the
+ * new shape. A file cut short by a crash still loads up to its last complete row group.
+ */
+bool appendNpy(const std::string &path, NpyType type, std::uint64_t previousRows, const std::vector<std::uint8_t> &data,
+               std::size_t rows)
+{
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (previousRows == 0U ? O_TRUNC : 0), 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    std::ostringstream dict;
+    dict << "{'descr': '" << (type.size == 1U ? '|' : kNpyOrder) << type.kind << type.size
+         << "', 'fortran_order': False, 'shape': (" << previousRows + rows << ",), }";
+    std::string header = "\x93NUMPY";
+    header += '\x01';
+    header += '\x00';
+    const auto dictBytes = kNpyHeaderBytes - header.size() - 2U;
+    header += static_cast<char>(dictBytes & 0xFFU);
+    header += static_cast<char>(dictBytes >> 8U);
+    header += dict.str();
+    header.resize(kNpyHeaderBytes - 1U, ' ');
+    header += '\n';
+
+    const auto offset = static_cast<off_t>(kNpyHeaderBytes + previousRows * type.size);
+    const bool ok = writeAllAt(fd, data.data(), data.size(), offset) &&
+                    writeAllAt(fd, header.data(), header.size(), 0);
+    return ::close(fd) == 0 && ok;
+}
+} // namespace
+
+std::string ValueExportStats::summary() const
+{
+    std::ostringstream oss;
+    oss << rows << " rows in " << rowGroups << " row groups";
+    if (mismatched != 0U)
+    {
+        oss << "; " << mismatched << " payloads of the wrong size";
+    }
+    if (dropped != 0U)
+    {
+        oss << "; " << dropped << " dropped";
+    }
+    if (writeFailed)
+    {
+        oss << "; a write failed";
+    }
+    return oss.str();
+}
+
+ValueExporter::~ValueExporter()
+{
+    close();
+}
+
+bool ValueExporter::open(const model::SimulatorConfig &config, const ValueExportOptions &options,
+                         std::string &error)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (open_)
+    {
+        error = "export already open";
+        return false;
+    }
+
+    std::error_code created;
+    std::filesystem::create_directories(options.directory, created);
+    if (created)
+    {
+        error = "cannot create " + options.directory + ": " + created.message();
+        return false;
+    }
+
+    options_ = options;
+    options_.rowGroupRows = std::max<std::size_t>(options_.rowGroupRows, 1U);
+    tables_.clear();
+    byComId_.clear();
+    skipped_.clear();
+    for (const auto &iface : config.interfaces)
+    {
+        for (const auto &telegram : iface.telegrams)
+        {
+            if (byComId_.count(telegram.comId) != 0U)
+            {
+                continue;
+            }
+            std::string why;
+            auto layout = config::flattenDataset(config, telegram.datasetId, &why);
+            if (!layout)
+            {
+                skipped_.push_back("ComID " + std::to_string(telegram.comId) + ": " + why);
+                continue;
+            }
+
+            Table table;
+            table.comId = telegram.comId;
+            for (const auto &field : layout->fields)
+            {
+                for (std::uint32_t index = 0U; index < field.count; ++index)
+                {
+                    table.columns.push_back(Column{
+                        field.count == 1U ? field.path : field.path + "[" + std::to_string(index) + "]", field.type});
+                }
+            }
+            table.layout = std::move(*layout);
+            byComId_.emplace(telegram.comId, tables_.size());
+            tables_.push_back(std::move(table));
+        }
+    }
+
+    pending_.clear();
+    pendingBytes_ = 0U;
+    stats_ = ValueExportStats{};
+    stop_ = false;
+    open_ = true;
+    thread_ = std::thread([this] { exportLoop(); });
+    return true;
+}
+
+void ValueExporter::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!thread_.joinable() || stop_)
+        {
+            return;
+        }
+        for (std::size_t index = 0U; index < tables_.size(); ++index)
+        {
+            queueLocked(index);
+        }
+        stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = false;
+}
+
+bool ValueExporter::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_ && !stop_;
+}
+
+void ValueExporter::append(std::uint32_t comId, std::int64_t timeNs, const std::uint8_t *payload, std::size_t size)
+{
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto found = byComId_.find(comId);
+        if (!open_ || stop_ || found == byComId_.end())
+        {
+            return;
+        }
+        auto &table = tables_[found->second];
+        if (size != table.layout.wireSize)
+        {
+            ++stats_.mismatched;
+            return;
+        }
+        if (pendingBytes_ >= kMaxPendingBytes)
+        {
+            ++stats_.dropped;
+            return;
+        }
+
+        if (table.times.empty())
+        {
+            table.firstQueued = std::chrono::steady_clock::now();
+            table.times.reserve(options_.rowGroupRows);
+            table.payloads.reserve(options_.rowGroupRows * size);
+        }
+        table.times.push_back(timeNs);
+        table.payloads.insert(table.payloads.end(), payload, payload + size);
+        pendingBytes_ += sizeof(timeNs) + size;
+        if (table.times.size() >= options_.rowGroupRows)
+        {
+            queueLocked(found->second);
+            queued = true;
+        }
+    }
+    if (queued)
+    {
+        wake_.notify_one();
+    }
+}
+
+ValueExportStats ValueExporter::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ValueExporter::queueLocked(std::size_t index)
+{
+    auto &table = tables_[index];
+    if (table.times.empty())
+    {
+        return;
+    }
+    RowGroup group;
+    group.table = index;
+    group.times = std::move(table.times);
+    group.payloads = std::move(table.payloads);
+    table.times = {};
+    table.payloads = {};
+    pending_.push_back(std::move(group));
+}
+
+void ValueExporter::exportLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        wake_.wait_for(lock, options_.maxRowGroupAge, [this] { return stop_ || !pending_.empty(); });
+        const auto now = std::chrono::steady_clock::now();
+        for (std::size_t index = 0U; index < tables_.size(); ++index)
+        {
+            if (!tables_[index].times.empty() && now - tables_[index].firstQueued >= options_.maxRowGroupAge)
+            {
+                queueLocked(index);
+            }
+        }
+
+        while (!pending_.empty())
+        {
+            auto group = std::move(pending_.front());
+            pending_.pop_front();
+            lock.unlock();
+            const bool written = writeRowGroup(group);
+            lock.lock();
+            pendingBytes_ -= group.times.size() * sizeof(std::int64_t) + group.payloads.size();
+            if (written)
+            {
+                stats_.rows += group.times.size();
+                ++stats_.rowGroups;
+            }
+            else
+            {
+                stats_.dropped += group.times.size();
+                stats_.writeFailed = true;
+            }
+        }
+        if (stop_)
+        {
+            return;
+        }
+    }
+}
+
+bool ValueExporter::writeRowGroup(const RowGroup &group)
+{
+    auto &table = tables_[group.table];
+    const bool written = options_.format == model::ExportFormat::Npy ? writeNpy(table, group) : writeCsv(table, group);
+    if (written)
+    {
+        table.rowsWritten += group.times.size();
+    }
+    return written;
+}
+
+bool ValueExporter::writeCsv(Table &table, const RowGroup &group)
+{
+    std::string text;
+    text.reserve(group.times.size() * (24U + table.columns.size() * 8U));
+    if (table.rowsWritten == 0U)
+    {
+        text += "time";
+        for (const auto &column : table.columns)
+        {
+            text += ',';
+            text += column.name;
+        }
+        text += '\n';
+    }
+
+    std::vector<DatasetScalar> values;
+    const auto wireSize = table.layout.wireSize;
+    for (std::size_t row = 0U; row < group.times.size(); ++row)
+    {
+        if (!config::unmarshalDataset(table.layout, group.payloads.data() + row * wireSize, wireSize, values))
+        {
+            return false;
+        }
+        appendIsoTime(text, group.times[row]);
+        for (std::size_t column = 0U; column < table.columns.size(); ++column)
+        {
+            text += ',';
+            appendCsvValue(text, table.columns[column].type, values[column]);
+        }
+        text += '\n';
+    }
+
+    const auto path = options_.directory + "/comid_" + std::to_string(table.comId) + ".csv";
+    const int flags = O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (table.rowsWritten == 0U ? O_TRUNC : 0);
+    const int fd = ::open(path.c_str(), flags, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    const bool ok = writeAll(fd, text.data(), text.size());
+    return ::close(fd) == 0 && ok;
+}
+
+bool ValueExporter::writeNpy(Table &table, const RowGroup &group)
+{
+    const auto directory = options_.directory + "/comid_" + std::to_string(table.comId);
+    if (table.rowsWritten == 0U)
+    {
+        std::error_code created;
+        std::filesystem::create_directories(directory, created);
+        if (created)
+        {
+            return false;
+        }
+    }
+
+    // Scatter row-major payloads into one buffer per column.
+    const auto rows = group.times.size();
+    std::vector<std::vector<std::uint8_t>> columns(table.columns.size());
+    std::vector<NpyType> types(table.columns.size());
+    for (std::size_t column = 0U; column < columns.size(); ++column)
+    {
+        types[column] = npyType(table.columns[column].type);
+        columns[column].resize(rows * types[column].size);
+    }
+    std::vector<DatasetScalar> values;
+    const auto wireSize = table.layout.wireSize;
+    for (std::size_t row = 0U; row < rows; ++row)
+    {
+        if (!config::unmarshalDataset(table.layout, group.payloads.data() + row * wireSize, wireSize, values))
+        {
+            return false;
+        }
+        for (std::size_t column = 0U; column < columns.size(); ++column)
+        {
+            storeNative(table.columns[column].type, values[column], columns[column].data() + row * types[column].size);
+        }
+    }
+
+    std::vector<std::uint8_t> times(rows * sizeof(std::int64_t));
+    std::memcpy(times.data(), group.times.data(), times.size());
+    if (!appendNpy(directory + "/time_ns.npy", NpyType{'i', 8U}, table.rowsWritten, times, rows))
+    {
+        return false;
+    }
+    for (std::size_t column = 0U; column < columns.size(); ++column)
+    {
+        const auto path = directory + "/" + fileName(table.columns[column].name) + ".npy";
+        if (!appendNpy(path, types[column], table.rowsWritten, columns[column], rows))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace trdp::record
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "config/dataset_layout.h"
+#include "model/runtime_options.h"
+#include "model/sim_config.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace trdp::record
+{
+struct ValueExportOptions
+{
+    /** Created if missing; one table per ComID goes in here. */
+    std::string directory;
+    model::ExportFormat format{model::ExportFormat::Csv};
+    /** A ComID's rows are decoded and written once this many are queued... */
+    std::size_t rowGroupRows{4096U};
+    /** ...or once the oldest of them is this old. */
+    std::chrono::milliseconds maxRowGroupAge{1000};
+};
+
+struct ValueExportStats
+{
+    std::uint64_t rows{0};
+    std::uint64_t rowGroups{0};
+    /** Payloads whose size is not the dataset's wire size; they are not exported. */
+    std::uint64_t mismatched{0};
+    /** Rows discarded because more than kMaxPendingBytes waited for the disk. */
+    std::uint64_t dropped{0};
+    bool writeFailed{false};
+
+    /** One line for the shutdown log, e.g. "120000 rows in 30 row groups". */
+    [[nodiscard]] std::string summary() const;
+};
+
+/**
+ * Streams received payloads as decoded values: one table per ComID with a time column and one
+ * typed column per dataset element, arrays flattened to "name[i]".
+ *
+ *   Csv: DIR/comid_<ComID>.csv, an ISO-8601 UTC "time" column and one column per element.
+ *   Npy: DIR/comid_<ComID>/<column>.npy, one NumPy array per column plus time_ns.npy, so that
+ *        numpy.load() and pandas get typed columns without parsing text.
+ *
+ * append() copies the raw payload under a mutex; decoding and writing happen on a background
+ * thread in row groups. Telegrams whose dataset has no fixed layout are not exported.
+ */
+class ValueExporter
+{
+public:
+    static constexpr std::size_t kMaxPendingBytes = 64U << 20U;
+
+    ValueExporter() = default;
+    ~ValueExporter();
+
+    ValueExporter(const ValueExporter &) = delete;
+    ValueExporter &operator=(const ValueExporter &) = delete;
+
+    /** Lays out a table for every telegram of `config` and starts the export thread. */
+    bool open(const model::SimulatorConfig &config, const ValueExportOptions &options, std::string &error);
+    /** Writes the queued rows and stops the export thread; further appends are ignored. */
+    void close();
+    [[nodiscard]] bool isOpen() const;
+
+    void append(std::uint32_t comId, std::int64_t timeNs, const std::uint8_t *payload, std::size_t size);
+
+    [[nodiscard]] ValueExportStats stats() const;
+    [[nodiscard]] std::size_t tableCount() const { return tables_.size(); }
+    /** Telegrams left out by open(), with the reason, e.g. a variable-length array. */
+    [[nodiscard]] const std::vector<std::string> &skipped() const { return skipped_; }
+    [[nodiscard]] const std::string &directory() const { return options_.directory; }
+
+private:
+    struct Column
+    {
+        std::string name;
+        config::ElementType type{config::ElementType::UInt8};
+    };
+
+    /** Layout and file state belong to the export thread; `times`/`payloads` are guarded by the mutex. */
+    struct Table
+    {
+        std::uint32_t comId{0};
+        config::DatasetLayout layout;
+        std::vector<Column> columns;
+        std::uint64_t rowsWritten{0};
+        std::vector<std::int64_t> times;
+        std::vector<std::uint8_t> payloads;
+        std::chrono::steady_clock::time_point firstQueued{};
+    };
+
+    struct RowGroup
+    {
+        std::size_t table{0};
+        std::vector<std::int64_t> times;
+        std::vector<std::uint8_t> payloads;
+    };
+
+    void queueLocked(std::size_t index);
+    void exportLoop();
+    bool writeRowGroup(const RowGroup &group);
+    bool writeCsv(Table &table, const RowGroup &group);
+    bool writeNpy(Table &table, const RowGroup &group);
+
+    ValueExportOptions options_;
+    std::vector<Table> tables_;
+    std::unordered_map<std::uint32_t, std::size_t> byComId_;
+    std::vector<std::string> skipped_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<RowGroup> pending_;
+    std::size_t pendingBytes_{0};
+    bool open_{false};
+    bool stop_{false};
+    ValueExportStats stats_;
+    std::thread thread_;
+};
+} // namespace trdp::record
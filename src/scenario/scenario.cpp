@@ -0,0 +1,556 @@
+#include "scenario/scenario.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <unordered_map>
+
+namespace trdp::scenario
+{
+namespace
+{
+std::vector<std::string> splitWords(std::string_view line)
+{
+    std::vector<std::string> words;
+    std::istringstream in{std::string(line)};
+    for (std::string word; in >> word;)
+    {
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+/** "2.5s", "250ms", "1500us", "40ns"; a bare "0" is accepted as well. */
+std::optional<std::chrono::nanoseconds> parseTime(const std::string &text)
+{
+    if (text == "0")
+    {
+        return std::chrono::nanoseconds(0);
+    }
+    errno = 0;
+    char *end = nullptr;
+    const double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || errno != 0 || !std::isfinite(value) || value < 0.0)
+    {
+        return std::nullopt;
+    }
+
+    const std::string unit(end);
+    double scale = 0.0;
+    if (unit == "s")
+    {
+        scale = 1e9;
+    }
+    else if (unit == "ms")
+    {
+        scale = 1e6;
+    }
+    else if (unit == "us")
+    {
+        scale = 1e3;
+    }
+    else if (unit == "ns")
+    {
+        scale = 1.0;
+    }
+    // About 290 years of nanoseconds; anything longer is a typo.
+    if (scale == 0.0 || value * scale > 9e18)
+    {
+        return std::nullopt;
+    }
+    return std::chrono::nanoseconds(std::llround(value * scale));
+}
+
+std::optional<std::uint64_t> parseCount(const std::string &text)
+{
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos || text.size() > 18U)
+    {
+        return std::nullopt;
+    }
+    return std::strtoull(text.c_str(), nullptr, 10);
+}
+
+std::optional<std::vector<std::uint8_t>> parseHex(const std::string &text)
+{
+    if (text.empty() || text.size() % 2U != 0U || text.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+    {
+        return std::nullopt;
+    }
+    std::vector<std::uint8_t> bytes;
+    bytes.reserve(text.size() / 2U);
+    for (std::size_t i = 0; i < text.size(); i += 2U)
+    {
+        bytes.push_back(static_cast<std::uint8_t>(std::strtoul(text.substr(i, 2U).c_str(), nullptr, 16)));
+    }
+    return bytes;
+}
+
+/**
+ * One value for an element of `type`: decimal or 0x-hex integers within the element width (signed or
+ * unsigned), reals for REAL32/REAL64. TIMEDATE48/64 take the packed integer of DatasetScalar.
+ */
+std::optional<config::DatasetScalar> parseValue(config::ElementType type, const std::string &text)
+{
+    config::DatasetScalar value;
+    if (text.empty())
+    {
+        return std::nullopt;
+    }
+    errno = 0;
+    char *end = nullptr;
+    if (type == config::ElementType::Real32 || type == config::ElementType::Real64)
+    {
+        value.real = std::strtod(text.c_str(), &end);
+        if (*end != '\0' || errno != 0 || !std::isfinite(value.real))
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    if (text.front() == '-')
+    {
+        value.integer = std::strtoll(text.c_str(), &end, 0);
+    }
+    else
+    {
+        value.integer = static_cast<std::int64_t>(std::strtoull(text.c_str(), &end, 0));
+    }
+    if (*end != '\0' || errno != 0)
+    {
+        return std::nullopt;
+    }
+
+    const auto bits = config::elementTypeSize(type) * 8U;
+    if (bits < 64U)
+    {
+        const auto minimum = -(std::int64_t{1} << (bits - 1U));
+        const auto maximum = static_cast<std::int64_t>((std::uint64_t{1} << bits) - 1U);
+        if (value.integer < minimum || value.integer > maximum)
+        {
+            return std::nullopt;
+        }
+    }
+    return value;
+}
+
+/** Compiles one scenario line after another; `fail()` records the first error with its line. */
+class Compiler
+{
+public:
+    Compiler(const model::SimulatorConfig &config, std::string name, Scenario &scenario)
+        : config_(config), name_(std::move(name)), scenario_(scenario)
+    {
+    }
+
+    bool compileLine(std::uint32_t line, std::string_view text);
+    [[nodiscard]] const std::string &error() const { return error_; }
+
+private:
+    struct Telegram
+    {
+        std::uint32_t index{0};
+        std::optional<config::DatasetLayout> layout;
+        std::string layoutError;
+    };
+
+    bool fail(const std::string &message)
+    {
+        error_ = name_ + ":" + std::to_string(line_) + ": " + message;
+        return false;
+    }
+
+    bool parseWhen(const std::vector<std::string> &words, std::size_t &next, std::vector<std::chrono::nanoseconds> &times);
+    Telegram *telegram(const std::string &comIdText);
+    bool compileSet(const Telegram &telegram, const std::vector<std::string> &words, std::size_t next,
+                    const std::vector<std::chrono::nanoseconds> &times);
+    void addEvent(ScenarioEvent event, const std::vector<std::chrono::nanoseconds> &times);
+
+    const model::SimulatorConfig &config_;
+    std::string name_;
+    Scenario &scenario_;
+    std::unordered_map<std::uint32_t, Telegram> telegrams_;
+    std::chrono::nanoseconds previous_{0};
+    std::uint32_t line_{0};
+    std::string error_;
+};
+
+bool Compiler::compileLine(std::uint32_t line, std::string_view text)
+{
+    line_ = line;
+    const auto words = splitWords(text.substr(0, text.find('#')));
+    if (words.empty())
+    {
+        return true;
+    }
+
+    std::size_t next = 0U;
+    std::vector<std::chrono::nanoseconds> times;
+    if (!parseWhen(words, next, times))
+    {
+        return false;
+    }
+    previous_ = times.front();
+    if (scenario_.events.size() + times.size() > Scenario::kMaxEvents)
+    {
+        return fail("the scenario expands to more than " + std::to_string(Scenario::kMaxEvents) + " events");
+    }
+
+    if (next + 2U > words.size())
+    {
+        return fail("expected an action and a ComID after the time");
+    }
+    const auto &action = words[next];
+    auto *target = telegram(words[next + 1U]);
+    if (target == nullptr)
+    {
+        return false;
+    }
+    next += 2U;
+
+    ScenarioEvent event;
+    event.telegram = target->index;
+    event.line = line;
+    if (action == "set")
+    {
+        return compileSet(*target, words, next, times);
+    }
+    if (action == "start")
+    {
+        event.action = ScenarioAction::Start;
+        if (next < words.size())
+        {
+            const auto cycle = parseTime(words[next++]);
+            if (!cycle || *cycle < std::chrono::microseconds(1))
+            {
+                return fail("invalid cycle time '" + words[next - 1U] + "'");
+            }
+            event.cycle = std::chrono::duration_cast<std::chrono::microseconds>(*cycle);
+        }
+    }
+    else if (action == "stop" || action == "unfix")
+    {
+        event.action = action == "stop" ? ScenarioAction::Stop : ScenarioAction::Unfix;
+    }
+    else if (action == "tx" || action == "fixed")
+    {
+        event.action = action == "tx" ? ScenarioAction::Tx : ScenarioAction::Fixed;
+        const auto bytes = next < words.size() ? parseHex(words[next++]) : std::nullopt;
+        if (!bytes)
+        {
+            return fail("'" + action + "' expects the payload as hex bytes, e.g. 00FF10AA");
+        }
+        event.first = static_cast<std::uint32_t>(scenario_.bytes.size());
+        event.count = static_cast<std::uint32_t>(bytes->size());
+        scenario_.bytes.insert(scenario_.bytes.end(), bytes->begin(), bytes->end());
+    }
+    else
+    {
+        return fail("unknown action '" + action + "' (start, stop, set, tx, fixed, unfix)");
+    }
+
+    if (next != words.size())
+    {
+        return fail("unexpected '" + words[next] + "' after the " + action + " action");
+    }
+    addEvent(event, times);
+    return true;
+}
+
+bool Compiler::parseWhen(const std::vector<std::string> &words, std::size_t &next,
+                         std::vector<std::chrono::nanoseconds> &times)
+{
+    const auto timeAt = [&](std::size_t index) -> std::optional<std::chrono::nanoseconds> {
+        if (index >= words.size())
+        {
+            fail("missing time after '" + words[index - 1U] + "'");
+            return std::nullopt;
+        }
+        const auto time = parseTime(words[index]);
+        if (!time)
+        {
+            fail("invalid time '" + words[index] + "' (use a unit: s, ms, us or ns)");
+        }
+        return time;
+    };
+
+    const auto &keyword = words.front();
+    if (keyword == "at" || keyword == "after")
+    {
+        const auto time = timeAt(1U);
+        if (!time)
+        {
+            return false;
+        }
+        times.push_back(keyword == "at" ? *time : previous_ + *time);
+        next = 2U;
+        return true;
+    }
+    if (keyword != "every")
+    {
+        return fail("expected 'at', 'after' or 'every' instead of '" + keyword + "'");
+    }
+
+    const auto period = timeAt(1U);
+    if (!period)
+    {
+        return false;
+    }
+    if (period->count() == 0)
+    {
+        return fail("'every' needs a period above zero");
+    }
+    next = 2U;
+    std::chrono::nanoseconds from{0};
+    if (next < words.size() && words[next] == "from")
+    {
+        const auto time = timeAt(next + 1U);
+        if (!time)
+        {
+            return false;
+        }
+        from = *time;
+        next += 2U;
+    }
+
+    std::uint64_t repetitions = 0U;
+    if (next < words.size() && words[next] == "until")
+    {
+        const auto until = timeAt(next + 1U);
+        if (!until)
+        {
+            return false;
+        }
+        if (*until < from)
+        {
+            return fail("'until' lies before the first repetition");
+        }
+        repetitions = static_cast<std::uint64_t>((*until - from) / *period) + 1U;
+    }
+    else if (next < words.size() && words[next] == "times")
+    {
+        const auto count = next + 1U < words.size() ? parseCount(words[next + 1U]) : std::nullopt;
+        if (!count || *count == 0U)
+        {
+            return fail("'times' expects a repetition count above zero");
+        }
+        repetitions = *count;
+    }
+    else
+    {
+        return fail("'every' needs 'until T' or 'times N'");
+    }
+    next += 2U;
+
+    if (repetitions > Scenario::kMaxEvents)
+    {
+        return fail("the scenario expands to more than " + std::to_string(Scenario::kMaxEvents) + " events");
+    }
+    times.reserve(repetitions);
+    for (std::uint64_t k = 0U; k < repetitions; ++k)
+    {
+        times.push_back(from + *period * static_cast<std::int64_t>(k));
+    }
+    return true;
+}
+
+Compiler::Telegram *Compiler::telegram(const std::string &comIdText)
+{
+    const auto comId = parseCount(comIdText);
+    if (!comId || *comId > 0xFFFFFFFFULL)
+    {
+        fail("invalid ComID '" + comIdText + "'");
+        return nullptr;
+    }
+    const auto known = telegrams_.find(static_cast<std::uint32_t>(*comId));
+    if (known != telegrams_.end())
+    {
+        return &known->second;
+    }
+
+    for (const auto &iface : config_.interfaces)
+    {
+        for (const auto &config : iface.telegrams)
+        {
+            if (config.comId != *comId)
+            {
+                continue;
+            }
+            Telegram entry;
+            entry.index = static_cast<std::uint32_t>(scenario_.telegrams.size());
+            entry.layout = config::flattenDataset(config_, config.datasetId, &entry.layoutError);
+            scenario_.telegrams.push_back(ScenarioTelegram{config.comId, entry.layout ? entry.layout->wireSize : 0U});
+            return &telegrams_.emplace(config.comId, std::move(entry)).first->second;
+        }
+    }
+    fail("ComID " + comIdText + " is not a telegram of the configuration");
+    return nullptr;
+}
+
+bool Compiler::compileSet(const Telegram &telegram, const std::vector<std::string> &words, std::size_t next,
+                          const std::vector<std::chrono::nanoseconds> &times)
+{
+    if (!telegram.layout)
+    {
+        return fail("'set' needs a fixed dataset layout: " + telegram.layoutError);
+    }
+    if (next == words.size())
+    {
+        return fail("'set' expects FIELD=VALUE[,VALUE...]");
+    }
+
+    // Per assignment: the elements it covers and its value list, cycled through on repetitions.
+    struct Assignment
+    {
+        const config::FieldLayout *field{nullptr};
+        std::uint32_t first{0};
+        std::uint32_t count{0};
+        std::vector<config::DatasetScalar> values;
+    };
+    std::vector<Assignment> assignments;
+    std::size_t writesPerEvent = 0U;
+    for (; next < words.size(); ++next)
+    {
+        const auto &word = words[next];
+        const auto equals = word.find('=');
+        if (equals == std::string::npos || equals == 0U)
+        {
+            return fail("expected FIELD=VALUE instead of '" + word + "'");
+        }
+        Assignment assignment;
+        const auto path = word.substr(0, equals);
+        assignment.field = config::findField(*telegram.layout, path, assignment.first, assignment.count);
+        if (assignment.field == nullptr)
+        {
+            return fail("dataset " + std::to_string(telegram.layout->datasetId) + " has no field '" + path + "'");
+        }
+
+        std::istringstream list(word.substr(equals + 1U));
+        for (std::string item; std::getline(list, item, ',');)
+        {
+            const auto value = parseValue(assignment.field->type, item);
+            if (!value)
+            {
+                return fail("'" + item + "' is not a valid value for " + path);
+            }
+            assignment.values.push_back(*value);
+        }
+        if (assignment.values.empty())
+        {
+            return fail("no value given for " + path);
+        }
+        writesPerEvent += assignment.count;
+        assignments.push_back(std::move(assignment));
+    }
+
+    if (scenario_.writes.size() + writesPerEvent * times.size() > Scenario::kMaxWrites)
+    {
+        return fail("the scenario writes more than " + std::to_string(Scenario::kMaxWrites) + " elements");
+    }
+    scenario_.writes.reserve(scenario_.writes.size() + writesPerEvent * times.size());
+    for (std::size_t k = 0; k < times.size(); ++k)
+    {
+        ScenarioEvent event;
+        event.at = times[k];
+        event.action = ScenarioAction::Set;
+        event.telegram = telegram.index;
+        event.line = line_;
+        event.first = static_cast<std::uint32_t>(scenario_.writes.size());
+        event.count = static_cast<std::uint32_t>(writesPerEvent);
+        for (const auto &assignment : assignments)
+        {
+            const auto &field = *assignment.field;
+            const auto &value = assignment.values[k % assignment.values.size()];
+            for (auto element = assignment.first; element < assignment.first + assignment.count; ++element)
+            {
+                const auto offset = field.offset + element * config::elementTypeSize(field.type);
+                scenario_.writes.push_back(FieldWrite{static_cast<std::uint32_t>(offset), field.type, value});
+            }
+        }
+        scenario_.events.push_back(event);
+    }
+    return true;
+}
+
+void Compiler::addEvent(ScenarioEvent event, const std::vector<std::chrono::nanoseconds> &times)
+{
+    for (const auto time : times)
+    {
+        event.at = time;
+        scenario_.events.push_back(event);
+    }
+}
+} // namespace
+
+const char *actionName(ScenarioAction action)
+{
+    switch (action)
+    {
+    case ScenarioAction::Start:
+        return "start";
+    case ScenarioAction::Stop:
+        return "stop";
+    case ScenarioAction::Set:
+        return "set";
+    case ScenarioAction::Tx:
+        return "tx";
+    case ScenarioAction::Fixed:
+        return "fixed";
+    case ScenarioAction::Unfix:
+        return "unfix";
+    }
+    return "?";
+}
+
+std::chrono::nanoseconds Scenario::duration() const
+{
+    return events.empty() ? std::chrono::nanoseconds(0) : events.back().at;
+}
+
+bool compileScenario(std::string_view text, const model::SimulatorConfig &config, const std::string &name,
+                     Scenario &scenario, std::string &error)
+{
+    scenario = Scenario{};
+    scenario.name = name;
+    Compiler compiler(config, name, scenario);
+    std::uint32_t line = 0U;
+    while (!text.empty())
+    {
+        const auto end = text.find('\n');
+        ++line;
+        if (!compiler.compileLine(line, text.substr(0, end)))
+        {
+            error = compiler.error();
+            return false;
+        }
+        text = end == std::string_view::npos ? std::string_view{} : text.substr(end + 1U);
+    }
+
+    if (scenario.events.empty())
+    {
+        error = name + ": the scenario has no events";
+        return false;
+    }
+    std::stable_sort(scenario.events.begin(), scenario.events.end(),
+                     [](const ScenarioEvent &lhs, const ScenarioEvent &rhs) { return lhs.at < rhs.at; });
+    return true;
+}
+
+bool loadScenario(const std::string &path, const model::SimulatorConfig &config, Scenario &scenario,
+                  std::string &error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        error = "cannot open scenario " + path;
+        return false;
+    }
+    const std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    return compileScenario(text, config, path, scenario, error);
+}
+} // namespace trdp::scenario
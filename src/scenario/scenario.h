@@ -0,0 +1,104 @@
+#pragma once
+
+#include "config/dataset_codec.h"
+#include "config/dataset_layout.h"
+#include "model/sim_config.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace trdp::scenario
+{
+/**
+ * A scenario file holds one timed action per line; `#` starts a comment:
+ *
+ *   at 2s          set 300 door_state=1
+ *   at 2.5s        stop 301
+ *   after 10s      start 301 100ms
+ *   every 50ms from 1s until 5s  set 300 speed=0,10,20 mode=2
+ *   every 1s times 3             tx 302 00FF10AA
+ *
+ * When:   `at T` from the scenario start, `after T` from the previous line's (first) time, or
+ *         `every P [from T] (until T | times N)` repeating up to and including `until`.
+ *         Times take a unit: s, ms, us or ns, e.g. "2.5s", "250ms", "1500us".
+ * Action: `start COMID [CYCLE]` (default: the XML cycle, else 1 s), `stop COMID`,
+ *         `set COMID FIELD=V[,V...]...` writes dataset fields into the TX payload, a value list
+ *         is stepped through on repetitions; `tx COMID HEX` replaces the TX payload,
+ *         `fixed COMID HEX` / `unfix COMID` set and clear the fixed payload.
+ */
+enum class ScenarioAction : std::uint8_t
+{
+    Start,
+    Stop,
+    Set,
+    Tx,
+    Fixed,
+    Unfix,
+};
+
+/** Lower-case keyword of an action, as written in the file. */
+const char *actionName(ScenarioAction action);
+
+/** One element written by a `set`: the wire offset and type from the dataset layout. */
+struct FieldWrite
+{
+    std::uint32_t offset{0};
+    config::ElementType type{config::ElementType::UInt8};
+    config::DatasetScalar value;
+};
+
+/** A ComID the scenario drives; `wireSize` is 0 when its dataset has no fixed layout. */
+struct ScenarioTelegram
+{
+    std::uint32_t comId{0};
+    std::size_t wireSize{0};
+};
+
+/**
+ * One entry of the compiled timeline. `set` events own `count` writes from Scenario::writes,
+ * `tx`/`fixed` events `count` bytes from Scenario::bytes, both starting at `first`.
+ */
+struct ScenarioEvent
+{
+    std::chrono::nanoseconds at{0};
+    ScenarioAction action{ScenarioAction::Start};
+    std::uint32_t telegram{0};
+    std::uint32_t line{0};
+    std::uint32_t first{0};
+    std::uint32_t count{0};
+    /** `start` only; zero takes the telegram's configured cycle. */
+    std::chrono::microseconds cycle{0};
+};
+
+/** A scenario compiled against the XML configuration: every repetition expanded and sorted by time. */
+struct Scenario
+{
+    static constexpr std::size_t kMaxEvents = std::size_t{1} << 22U;
+    static constexpr std::size_t kMaxWrites = std::size_t{1} << 24U;
+
+    std::string name;
+    std::vector<ScenarioTelegram> telegrams;
+    /** Sorted by time; events at the same time keep their order in the file. */
+    std::vector<ScenarioEvent> events;
+    std::vector<FieldWrite> writes;
+    std::vector<std::uint8_t> bytes;
+
+    /** Time of the last event. */
+    [[nodiscard]] std::chrono::nanoseconds duration() const;
+};
+
+/**
+ * Parses and compiles scenario `text`: ComIDs must be telegrams of `config`, `set` fields elements
+ * of their dataset. Returns false with `error` naming the line ("name:12: ...") on the first problem.
+ */
+bool compileScenario(std::string_view text, const model::SimulatorConfig &config, const std::string &name,
+                     Scenario &scenario, std::string &error);
+
+/** compileScenario() on the contents of the file at `path`. */
+bool loadScenario(const std::string &path, const model::SimulatorConfig &config, Scenario &scenario,
+                  std::string &error);
+} // namespace trdp::scenario
@@ -0,0 +1,334 @@
+#include "scenario/scenario_runner.h"
+
+#include "trdp/realtime_profile.h"
+#include "util/logging.h"
+#include "util/trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace trdp::scenario
+{
+namespace
+{
+double toMicroseconds(std::chrono::nanoseconds value)
+{
+    return std::chrono::duration<double, std::micro>(value).count();
+}
+} // namespace
+
+std::string ScenarioReport::summary() const
+{
+    std::ostringstream oss;
+    oss << executed << " of " << events << " events executed";
+    if (unbound != 0U)
+    {
+        oss << ", " << unbound << " without a transmitting endpoint";
+    }
+    if (pending != 0U)
+    {
+        oss << ", " << pending << " not reached";
+    }
+    if (failed != 0U)
+    {
+        oss << ", " << failed << " not taken by every endpoint";
+    }
+    if (executed != 0U)
+    {
+        oss << std::fixed << std::setprecision(1) << "; late min " << toMicroseconds(minLate) << " us, mean "
+            << toMicroseconds(meanLate) << " us, p50 " << toMicroseconds(p50Late) << " us, p99 "
+            << toMicroseconds(p99Late) << " us, max " << toMicroseconds(maxLate) << " us";
+    }
+    return oss.str();
+}
+
+ScenarioRunner::ScenarioRunner(Scenario scenario)
+    : scenario_(std::move(scenario)),
+      endpoints_(scenario_.telegrams.size()),
+      payloads_(scenario_.telegrams.size()),
+      actualNs_(scenario_.events.size(), -1),
+      failed_(scenario_.events.size(), 0U)
+{
+}
+
+ScenarioRunner::~ScenarioRunner()
+{
+    stop();
+}
+
+bool ScenarioRunner::bind(std::uint32_t comId, std::shared_ptr<runtime::PdEndpointControl> endpoint)
+{
+    for (std::size_t index = 0; index < scenario_.telegrams.size(); ++index)
+    {
+        if (scenario_.telegrams[index].comId == comId && endpoint != nullptr)
+        {
+            endpoints_[index].push_back(std::move(endpoint));
+            return true;
+        }
+    }
+    return false;
+}
+
+void ScenarioRunner::start(const ScenarioRunOptions &options)
+{
+    if (thread_.joinable())
+    {
+        return;
+    }
+
+    for (std::size_t index = 0; index < scenario_.telegrams.size(); ++index)
+    {
+        const auto &telegram = scenario_.telegrams[index];
+        if (endpoints_[index].empty())
+        {
+            util::logWarn("Scenario " + scenario_.name + ": no transmitting endpoint for ComID " +
+                              std::to_string(telegram.comId) + "; its events are skipped",
+                          {std::string{}, telegram.comId});
+            continue;
+        }
+        // `set` events change single fields, so they start from what the telegram sends today.
+        payloads_[index] = endpoints_[index].front()->txPayload();
+        if (telegram.wireSize != 0U)
+        {
+            payloads_[index].resize(telegram.wireSize, 0U);
+        }
+    }
+
+    std::ostringstream oss;
+    oss << "Scenario " << scenario_.name << ": " << scenario_.events.size() << " events over "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(scenario_.duration()).count() << " ms";
+    util::logInfo(oss.str());
+    thread_ = std::thread([this, options] { run(options); });
+}
+
+void ScenarioRunner::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+bool ScenarioRunner::waitFor(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return wake_.wait_for(lock, timeout, [this] { return done_; });
+}
+
+bool ScenarioRunner::finished() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return done_;
+}
+
+void ScenarioRunner::run(ScenarioRunOptions options)
+{
+    TRDP_TRACE_THREAD_NAME("scenario");
+    if (options.realtime.policy != model::SchedulingPolicy::Inherit &&
+        options.realtime.policy != model::SchedulingPolicy::XmlPriority)
+    {
+        options.realtime.cpus.clear();
+        options.realtime.lockMemory = false;
+        const auto report = runtime::applyRealtimeProfile(options.realtime);
+        if (!report.fullyApplied())
+        {
+            util::logWarn("Real-time profile of the scenario thread: " + report.summary());
+        }
+    }
+
+    const auto &events = scenario_.events;
+    const auto origin = Clock::now();
+    std::size_t index = 0U;
+    bool stopped = false;
+    while (index < events.size() && !stopped)
+    {
+        const auto due = origin + events[index].at;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stopped = wake_.wait_until(lock, due - options.spin, [this] { return stop_; });
+        }
+        if (stopped)
+        {
+            break;
+        }
+        while (Clock::now() < due)
+        {
+        }
+
+        // Everything due by now runs as one batch; only then does the thread look at the clock again.
+        do
+        {
+            const auto &event = events[index];
+            if (!endpoints_[event.telegram].empty())
+            {
+                TRDP_TRACE_SCOPE_ARG("scenario event", "line", event.line);
+                actualNs_[index] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin).count();
+                failed_[index] = execute(event) ? 0U : 1U;
+            }
+            next_.store(++index, std::memory_order_release);
+        } while (index < events.size() && origin + events[index].at <= Clock::now());
+    }
+
+    const auto summary = report().summary();
+    util::logInfo("Scenario " + scenario_.name + (stopped ? " stopped: " : " finished: ") + summary);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+    }
+    wake_.notify_all();
+}
+
+bool ScenarioRunner::execute(const ScenarioEvent &event)
+{
+    const auto &endpoints = endpoints_[event.telegram];
+    auto &payload = payloads_[event.telegram];
+    bool ok = true;
+    switch (event.action)
+    {
+    case ScenarioAction::Start:
+        for (const auto &endpoint : endpoints)
+        {
+            const auto cycle = event.cycle.count() != 0
+                                   ? event.cycle
+                                   : endpoint->configuredCycle().value_or(std::chrono::microseconds(1000000));
+            ok = endpoint->startPublishing(cycle) && ok;
+        }
+        break;
+    case ScenarioAction::Stop:
+        for (const auto &endpoint : endpoints)
+        {
+            ok = endpoint->stopPublishing() && ok;
+        }
+        break;
+    case ScenarioAction::Set:
+    {
+        // A shorter `tx` payload before grows back to the dataset size.
+        payload.resize(std::max(payload.size(), scenario_.telegrams[event.telegram].wireSize), 0U);
+        for (auto write = event.first; write < event.first + event.count; ++write)
+        {
+            const auto &field = scenario_.writes[write];
+            config::storeScalar(field.type, field.value, payload.data() + field.offset);
+        }
+        for (const auto &endpoint : endpoints)
+        {
+            ok = endpoint->setTxPayload(payload) && ok;
+        }
+        break;
+    }
+    case ScenarioAction::Tx:
+    case ScenarioAction::Fixed:
+    {
+        const auto begin = scenario_.bytes.begin() + event.first;
+        std::vector<std::uint8_t> bytes(begin, begin + event.count);
+        for (const auto &endpoint : endpoints)
+        {
+            if (event.action == ScenarioAction::Tx)
+            {
+                ok = endpoint->setTxPayload(bytes) && ok;
+            }
+            else
+            {
+                ok = endpoint->setFixedPayload(bytes) && ok;
+            }
+        }
+        if (event.action == ScenarioAction::Tx)
+        {
+            payload = std::move(bytes);
+        }
+        break;
+    }
+    case ScenarioAction::Unfix:
+        for (const auto &endpoint : endpoints)
+        {
+            ok = endpoint->clearFixedPayload() && ok;
+        }
+        break;
+    }
+    return ok;
+}
+
+ScenarioReport ScenarioRunner::report() const
+{
+    const auto &events = scenario_.events;
+    const auto done = next_.load(std::memory_order_acquire);
+    ScenarioReport report;
+    report.events = events.size();
+    report.pending = events.size() - done;
+
+    std::vector<std::int64_t> late;
+    late.reserve(done);
+    for (std::size_t index = 0; index < done; ++index)
+    {
+        if (actualNs_[index] < 0)
+        {
+            ++report.unbound;
+            continue;
+        }
+        late.push_back(actualNs_[index] - events[index].at.count());
+        report.failed += failed_[index];
+    }
+    report.executed = late.size();
+    if (late.empty())
+    {
+        return report;
+    }
+
+    std::sort(late.begin(), late.end());
+    long double sum = 0.0L;
+    for (const auto value : late)
+    {
+        sum += static_cast<long double>(value);
+    }
+    const auto at = [&late](double rank) {
+        return std::chrono::nanoseconds(late[static_cast<std::size_t>(rank * static_cast<double>(late.size() - 1U))]);
+    };
+    report.minLate = std::chrono::nanoseconds(late.front());
+    report.meanLate = std::chrono::nanoseconds(static_cast<std::int64_t>(sum / static_cast<long double>(late.size())));
+    report.p50Late = at(0.50);
+    report.p99Late = at(0.99);
+    report.maxLate = std::chrono::nanoseconds(late.back());
+    return report;
+}
+
+bool ScenarioRunner::writeReport(const std::string &path, std::string &error) const
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        error = "cannot write scenario report " + path;
+        return false;
+    }
+
+    const auto done = next_.load(std::memory_order_acquire);
+    out << "line,action,comid,planned_ns,actual_ns,late_ns\n";
+    for (std::size_t index = 0; index < scenario_.events.size(); ++index)
+    {
+        const auto &event = scenario_.events[index];
+        out << event.line << ',' << actionName(event.action) << ',' << scenario_.telegrams[event.telegram].comId << ','
+            << event.at.count() << ',';
+        if (index < done && actualNs_[index] >= 0)
+        {
+            out << actualNs_[index] << ',' << actualNs_[index] - event.at.count();
+        }
+        else
+        {
+            out << ',';
+        }
+        out << '\n';
+    }
+    out.flush();
+    if (!out)
+    {
+        error = "writing scenario report " + path + " failed";
+        return false;
+    }
+    return true;
+}
+} // namespace trdp::scenario
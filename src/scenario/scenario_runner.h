@@ -0,0 +1,110 @@
+#pragma once
+
+#include "model/runtime_options.h"
+#include "scenario/scenario.h"
+#include "trdp/pd_endpoint_control.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trdp::scenario
+{
+struct ScenarioRunOptions
+{
+    /** Scheduling class of the timing thread; CPU pinning and memory locking are left to the sessions. */
+    model::RealtimeProfile realtime;
+    /** The timing thread sleeps until this long before an event and busy-waits the rest. */
+    std::chrono::microseconds spin{200};
+};
+
+/** Planned against actual execution times of a run; lateness is actual minus planned. */
+struct ScenarioReport
+{
+    std::size_t events{0};
+    std::size_t executed{0};
+    /** Events of ComIDs without a transmitting endpoint; they are not executed. */
+    std::size_t unbound{0};
+    /** Events not reached because the run was stopped early. */
+    std::size_t pending{0};
+    /** Executed events that at least one endpoint did not take, e.g. because a shard queue stayed full. */
+    std::size_t failed{0};
+    std::chrono::nanoseconds minLate{0};
+    std::chrono::nanoseconds meanLate{0};
+    std::chrono::nanoseconds p50Late{0};
+    std::chrono::nanoseconds p99Late{0};
+    std::chrono::nanoseconds maxLate{0};
+
+    [[nodiscard]] bool completed() const { return pending == 0U; }
+    /** One line for the log, e.g. "1200 of 1200 events; late min 2 us, mean 6 us, ...". */
+    [[nodiscard]] std::string summary() const;
+};
+
+/**
+ * Executes a compiled Scenario against PdEndpointControl endpoints from a timing thread of its own.
+ *
+ * The thread sleeps until shortly before the next event and busy-waits the rest, then executes every
+ * event that is due as one batch, so events at the same instant do not wait for each other's wakeup.
+ * `set` events write into a per-telegram copy of the TX payload and hand it to setTxPayload(); a
+ * running publisher sends it from its next cycle on. start/stop wait for the session, which shows up
+ * as lateness of the following events. The actual time of each event is kept for the report.
+ */
+class ScenarioRunner
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ScenarioRunner(Scenario scenario);
+    ~ScenarioRunner();
+
+    ScenarioRunner(const ScenarioRunner &) = delete;
+    ScenarioRunner &operator=(const ScenarioRunner &) = delete;
+
+    /** Sends the events of `comId` to `endpoint` as well; call before start(). Returns false for unknown ComIDs. */
+    bool bind(std::uint32_t comId, std::shared_ptr<runtime::PdEndpointControl> endpoint);
+
+    /** Starts the timing thread; the scenario's time 0 is now. */
+    void start(const ScenarioRunOptions &options = {});
+    /** Stops after the event being executed and joins the timing thread. */
+    void stop();
+    /** Waits until every event ran or stop() was called; returns false when `timeout` passed first. */
+    bool waitFor(std::chrono::milliseconds timeout);
+    [[nodiscard]] bool finished() const;
+
+    /** Report over the events executed so far. */
+    [[nodiscard]] ScenarioReport report() const;
+    /** Writes "line,action,comid,planned_ns,actual_ns,late_ns", one row per event in timeline order. */
+    bool writeReport(const std::string &path, std::string &error) const;
+
+    [[nodiscard]] const Scenario &scenario() const { return scenario_; }
+
+private:
+    void run(ScenarioRunOptions options);
+    /** False if any endpoint did not take the event. */
+    bool execute(const ScenarioEvent &event);
+
+    Scenario scenario_;
+    /** Per telegram index: the bound endpoints and the payload `set` events write into. */
+    std::vector<std::vector<std::shared_ptr<runtime::PdEndpointControl>>> endpoints_;
+    std::vector<std::vector<std::uint8_t>> payloads_;
+    /** Actual execution time of each event relative to the start, -1 until executed. */
+    std::vector<std::int64_t> actualNs_;
+    /** Per event: 1 if execute() reported a failure; written before next_ moves past it. */
+    std::vector<std::uint8_t> failed_;
+    /** Events [0, next_) are done, executed or unbound; published after their actualNs_ entry. */
+    std::atomic<std::size_t> next_{0};
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stop_{false};
+    bool done_{false};
+    std::thread thread_;
+};
+} // namespace trdp::scenario
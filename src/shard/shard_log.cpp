@@ -0,0 +1,170 @@
+#include "shard/shard_log.h"
+
+#include "util/log_store.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace trdp::shard
+{
+namespace
+{
+/** u16 record size, u8 level, u8 reserved, u32 ComID, i64 time, u16 session size; host byte order. */
+constexpr std::size_t kHeaderBytes = 18U;
+
+template <typename T>
+void put(std::string &out, T value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+T get(const std::string &in, std::size_t at)
+{
+    T value{};
+    std::memcpy(&value, in.data() + at, sizeof(value));
+    return value;
+}
+} // namespace
+
+std::string encodeLogRecord(const ShardLogRecord &record)
+{
+    const auto sessionSize = std::min<std::size_t>(record.session.size(), 255U);
+    const auto messageSize = std::min(record.message.size(), kLogRecordBytes - kHeaderBytes - sessionSize);
+    std::string out;
+    out.reserve(kHeaderBytes + sessionSize + messageSize);
+    put(out, static_cast<std::uint16_t>(kHeaderBytes + sessionSize + messageSize));
+    put(out, static_cast<std::uint8_t>(record.level));
+    put(out, std::uint8_t{0});
+    put(out, record.comId);
+    put(out, record.timeNs);
+    put(out, static_cast<std::uint16_t>(sessionSize));
+    out.append(record.session, 0U, sessionSize);
+    out.append(record.message, 0U, messageSize);
+    return out;
+}
+
+bool decodeLogRecord(const std::string &buffer, std::size_t &offset, ShardLogRecord &record)
+{
+    if (buffer.size() - offset < kHeaderBytes)
+    {
+        return false;
+    }
+    const auto size = get<std::uint16_t>(buffer, offset);
+    const auto sessionSize = get<std::uint16_t>(buffer, offset + 16U);
+    if (size < kHeaderBytes + sessionSize)
+    {
+        // Not written by encodeLogRecord(); nothing after it can be framed either.
+        offset = buffer.size();
+        return false;
+    }
+    if (buffer.size() - offset < size)
+    {
+        return false;
+    }
+    record.level = static_cast<util::LogLevel>(std::min<std::uint8_t>(get<std::uint8_t>(buffer, offset + 2U), 3U));
+    record.comId = get<std::uint32_t>(buffer, offset + 4U);
+    record.timeNs = get<std::int64_t>(buffer, offset + 8U);
+    record.session.assign(buffer, offset + kHeaderBytes, sessionSize);
+    record.message.assign(buffer, offset + kHeaderBytes + sessionSize, size - kHeaderBytes - sessionSize);
+    offset += size;
+    return true;
+}
+
+ShardLogWriter::ShardLogWriter(int fd) : fd_(fd)
+{
+    util::setLogForwarder([this](util::LogLevel level, const std::string &message, const std::string &session,
+                                 std::uint32_t comId, std::chrono::system_clock::time_point time) {
+        ShardLogRecord record;
+        record.level = level;
+        record.comId = comId;
+        record.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        record.session = session;
+        record.message = message;
+        write(record);
+    });
+}
+
+ShardLogWriter::~ShardLogWriter()
+{
+    util::setLogForwarder(nullptr);
+    ::close(fd_);
+}
+
+void ShardLogWriter::write(const ShardLogRecord &record)
+{
+    const auto bytes = encodeLogRecord(record);
+    ssize_t written = 0;
+    do
+    {
+        written = ::write(fd_, bytes.data(), bytes.size());
+    } while (written < 0 && errno == EINTR);
+    // Up to PIPE_BUF the write is all or nothing, so a short write cannot happen.
+    if (written != static_cast<ssize_t>(bytes.size()))
+    {
+        dropped_.fetch_add(1U);
+    }
+}
+
+ShardLogReader::~ShardLogReader()
+{
+    join();
+}
+
+void ShardLogReader::start(int fd, std::string session)
+{
+    fd_ = fd;
+    session_ = std::move(session);
+    thread_ = std::thread([this] { run(); });
+}
+
+void ShardLogReader::join()
+{
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void ShardLogReader::run()
+{
+    std::string buffer;
+    char chunk[4U * kLogRecordBytes];
+    while (true)
+    {
+        const auto count = ::read(fd_, chunk, sizeof(chunk));
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            break;
+        }
+        buffer.append(chunk, static_cast<std::size_t>(count));
+
+        std::size_t offset = 0U;
+        ShardLogRecord record;
+        const auto store = util::logStore();
+        while (decodeLogRecord(buffer, offset, record))
+        {
+            if (store)
+            {
+                const auto time = std::chrono::system_clock::time_point(std::chrono::duration_cast<
+                    std::chrono::system_clock::duration>(std::chrono::nanoseconds(record.timeNs)));
+                store->append(record.level, record.message, record.session.empty() ? session_ : record.session,
+                              record.comId, time);
+            }
+        }
+        buffer.erase(0U, offset);
+    }
+}
+} // namespace trdp::shard
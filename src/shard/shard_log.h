@@ -0,0 +1,82 @@
+#pragma once
+
+#include "util/logging.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace trdp::shard
+{
+/** PIPE_BUF on Linux: a record no larger than this reaches the pipe in one piece, whichever thread wrote it. */
+constexpr std::size_t kLogRecordBytes = 4096U;
+
+/** One log message on its way from a worker to the UI. */
+struct ShardLogRecord
+{
+    util::LogLevel level{util::LogLevel::Info};
+    std::uint32_t comId{0};
+    /** system_clock nanoseconds. */
+    std::int64_t timeNs{0};
+    std::string session;
+    std::string message;
+};
+
+/** Serializes `record` into at most kLogRecordBytes, cutting the message to fit. */
+std::string encodeLogRecord(const ShardLogRecord &record);
+/** Decodes the record at `offset` and moves past it; false while `buffer` holds only part of one. */
+bool decodeLogRecord(const std::string &buffer, std::size_t &offset, ShardLogRecord &record);
+
+/**
+ * Worker side: forwards every message logged in this process to the UI through the inherited pipe.
+ * The write end is non-blocking; a message that does not fit while the UI is behind is dropped and
+ * counted instead of stalling the thread that logged it.
+ */
+class ShardLogWriter
+{
+public:
+    /** Takes ownership of `fd` and installs itself as the process's log forwarder. */
+    explicit ShardLogWriter(int fd);
+    ~ShardLogWriter();
+
+    ShardLogWriter(const ShardLogWriter &) = delete;
+    ShardLogWriter &operator=(const ShardLogWriter &) = delete;
+
+    [[nodiscard]] std::uint64_t dropped() const { return dropped_.load(); }
+
+private:
+    void write(const ShardLogRecord &record);
+
+    int fd_{-1};
+    std::atomic<std::uint64_t> dropped_{0};
+};
+
+/**
+ * UI side: reads a worker's records on a thread of its own and appends them to the process's
+ * LogStore, tagged with `session` when the worker left them untagged. Ends when the worker closes
+ * its end of the pipe, i.e. when it exits.
+ */
+class ShardLogReader
+{
+public:
+    ShardLogReader() = default;
+    ~ShardLogReader();
+
+    ShardLogReader(const ShardLogReader &) = delete;
+    ShardLogReader &operator=(const ShardLogReader &) = delete;
+
+    /** Takes ownership of `fd`, the read end of the pipe. */
+    void start(int fd, std::string session);
+    /** Waits for the worker to close the pipe; call once it has exited. */
+    void join();
+
+private:
+    void run();
+
+    int fd_{-1};
+    std::string session_;
+    std::thread thread_;
+};
+} // namespace trdp::shard
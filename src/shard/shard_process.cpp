@@ -0,0 +1,495 @@
+#include "shard/shard_process.h"
+
+#include "trdp/pd_endpoint.h"
+#include "util/logging.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+namespace trdp::shard
+{
+namespace
+{
+constexpr std::chrono::milliseconds kExitPollInterval{5};
+constexpr std::chrono::milliseconds kDestructorBudget{500};
+/** How long send() waits for room in a full command queue; covers a stop whose unpublish times out. */
+constexpr std::chrono::milliseconds kQueueBudget{1000};
+constexpr std::chrono::milliseconds kQueueRetryInterval{1};
+/** Room for bursts, e.g. a message per telegram at start-up, while the UI's reader catches up. */
+constexpr int kLogPipeBytes = 1 << 20;
+
+std::string describeExit(int status)
+{
+    std::ostringstream oss;
+    if (WIFEXITED(status))
+    {
+        oss << "exited with status " << WEXITSTATUS(status);
+    }
+    else if (WIFSIGNALED(status))
+    {
+        oss << "killed by signal " << WTERMSIG(status);
+    }
+    else
+    {
+        oss << "ended (wait status " << status << ")";
+    }
+    return oss.str();
+}
+
+std::optional<std::chrono::system_clock::time_point> toSystemTime(bool present, std::int64_t ns)
+{
+    if (!present)
+    {
+        return std::nullopt;
+    }
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+} // namespace
+
+ShardProcess::ShardProcess(const model::InterfaceConfig &iface, std::size_t interfaceIndex)
+    : interfaceName_(iface.name),
+      hostIp_(iface.hostIp),
+      interfaceIndex_(interfaceIndex),
+      slotCount_(iface.telegrams.size())
+{
+}
+
+ShardProcess::~ShardProcess()
+{
+    if (pid_ > 0 && !exited_)
+    {
+        requestShutdown();
+        awaitExit(std::chrono::steady_clock::now() + kDestructorBudget);
+    }
+    log_.join();
+    if (wakeFd_ >= 0)
+    {
+        ::close(wakeFd_);
+    }
+}
+
+bool ShardProcess::start(const std::vector<std::string> &arguments, bool detachConsole)
+{
+    std::string error;
+    const auto label = "trdp-shard-" + interfaceName_;
+    // The UI only ever reads worker state; a stray write from this side faults instead of corrupting it.
+    if (!stateMemory_.create(label + "-state", ShardStateRegion::bytesFor(slotCount_), false, error) ||
+        !commandMemory_.create(label + "-commands", ShardCommandRing::bytes(), true, error))
+    {
+        util::logError("Shard " + interfaceName_ + ": " + error);
+        return false;
+    }
+    state_ = ShardStateRegion(stateMemory_.data(), slotCount_);
+    commands_ = ShardCommandRing(commandMemory_.data());
+    commands_.initialize();
+    wakeFd_ = ::eventfd(0U, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFd_ < 0)
+    {
+        util::logError("Shard " + interfaceName_ + ": eventfd failed: " + std::strerror(errno));
+        return false;
+    }
+    int logPipe[2];
+    if (::pipe2(logPipe, O_CLOEXEC) != 0)
+    {
+        util::logError("Shard " + interfaceName_ + ": pipe failed: " + std::strerror(errno));
+        return false;
+    }
+    // The worker's end is non-blocking: it drops messages rather than stall its PD path.
+    ::fcntl(logPipe[1], F_SETFL, O_NONBLOCK);
+    (void)::fcntl(logPipe[1], F_SETPIPE_SZ, kLogPipeBytes);
+
+    // Everything the child needs is prepared here: between fork and exec only async-signal-safe calls are allowed.
+    std::vector<std::string> args;
+    args.reserve(arguments.size() + 3U);
+    args.emplace_back("trdp_simulator");
+    args.insert(args.end(), arguments.begin(), arguments.end());
+    args.emplace_back("--shard-worker");
+    args.push_back(std::to_string(interfaceIndex_) + ":" + std::to_string(stateMemory_.fd()) + ":" +
+                   std::to_string(commandMemory_.fd()) + ":" + std::to_string(wakeFd_) + ":" +
+                   std::to_string(logPipe[1]));
+    std::vector<char *> argv;
+    argv.reserve(args.size() + 1U);
+    for (auto &arg : args)
+    {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    const int stateFd = stateMemory_.fd();
+    const int commandFd = commandMemory_.fd();
+    const int wakeFd = wakeFd_;
+    const int logFd = logPipe[1];
+    const pid_t parent = ::getpid();
+    const pid_t pid = ::fork();
+    if (pid < 0)
+    {
+        util::logError("Shard " + interfaceName_ + ": fork failed: " + std::strerror(errno));
+        ::close(logPipe[0]);
+        ::close(logPipe[1]);
+        return false;
+    }
+    if (pid == 0)
+    {
+        // The worker must not outlive the UI, even if it is killed without a chance to clean up.
+        ::prctl(PR_SET_PDEATHSIG, SIGTERM);
+        if (::getppid() != parent)
+        {
+            ::_exit(127);
+        }
+        sigset_t none;
+        ::sigemptyset(&none);
+        ::sigprocmask(SIG_SETMASK, &none, nullptr);
+        ::fcntl(stateFd, F_SETFD, 0);
+        ::fcntl(commandFd, F_SETFD, 0);
+        ::fcntl(wakeFd, F_SETFD, 0);
+        ::fcntl(logFd, F_SETFD, 0);
+        // The terminal's input belongs to the UI, and so does its screen while the TUI runs.
+        const int devNull = ::open("/dev/null", O_RDWR);
+        if (devNull >= 0)
+        {
+            ::dup2(devNull, STDIN_FILENO);
+            if (detachConsole)
+            {
+                ::dup2(devNull, STDOUT_FILENO);
+                ::dup2(devNull, STDERR_FILENO);
+            }
+        }
+        ::execv("/proc/self/exe", argv.data());
+        ::_exit(127);
+    }
+
+    pid_ = pid;
+    // The worker holds the only write end now, so the reader sees end-of-file once it exits.
+    ::close(logPipe[1]);
+    log_.start(logPipe[0], hostIp_);
+    std::ostringstream oss;
+    oss << "Started shard worker " << pid_ << " for interface " << interfaceName_ << " (" << slotCount_
+        << " telegrams)";
+    util::logInfo(oss.str());
+    return true;
+}
+
+bool ShardProcess::pollChild()
+{
+    if (pid_ <= 0 || exited_)
+    {
+        return false;
+    }
+    int status = 0;
+    if (::waitpid(pid_, &status, WNOHANG) == pid_)
+    {
+        exited_ = true;
+        exitDetail_ = describeExit(status);
+        return false;
+    }
+    return true;
+}
+
+void ShardProcess::requestShutdown()
+{
+    ShardCommand command{};
+    command.type = ShardCommandType::Shutdown;
+    if (!send(command))
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pollChild())
+        {
+            ::kill(pid_, SIGTERM);
+        }
+    }
+}
+
+void ShardProcess::awaitExit(std::chrono::steady_clock::time_point deadline)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (pollChild())
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            ::kill(pid_, SIGKILL);
+            int status = 0;
+            ::waitpid(pid_, &status, 0);
+            exited_ = true;
+            exitDetail_ = "killed after the shutdown deadline";
+            util::logWarn("Shard worker for " + interfaceName_ + " did not stop in time and was killed");
+            return;
+        }
+        std::this_thread::sleep_for(kExitPollInterval);
+    }
+}
+
+void ShardProcess::wakeWorker()
+{
+    const std::uint64_t one = 1U;
+    (void)::write(wakeFd_, &one, sizeof(one));
+}
+
+bool ShardProcess::send(const ShardCommand &command)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto deadline = std::chrono::steady_clock::now() + kQueueBudget;
+    while (true)
+    {
+        if (!pollChild())
+        {
+            ++commandsDropped_;
+            return false;
+        }
+        if (commands_.push(command))
+        {
+            break;
+        }
+        // The worker was woken for what is queued already; it frees a slot with every command it applies.
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            ++commandsDropped_;
+            util::logWarn("Shard " + interfaceName_ + ": command queue stayed full, command dropped");
+            return false;
+        }
+        std::this_thread::sleep_for(kQueueRetryInterval);
+    }
+    ++commandsSent_;
+    wakeWorker();
+    return true;
+}
+
+bool ShardProcess::setPaused(bool paused)
+{
+    ShardCommand command{};
+    command.type = paused ? ShardCommandType::PauseSession : ShardCommandType::ResumeSession;
+    if (!send(command))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    paused_ = paused;
+    return true;
+}
+
+bool ShardProcess::isPaused() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return paused_;
+}
+
+bool ShardProcess::readSlot(std::size_t slot, EndpointSlotState &state, std::uint32_t *sequence) const
+{
+    if (slot >= slotCount_ || !state_.ready())
+    {
+        return false;
+    }
+    return state_.load(slot, state, sequence);
+}
+
+std::optional<std::uint32_t> ShardProcess::slotSequence(std::size_t slot) const
+{
+    if (slot >= slotCount_ || !state_.ready())
+    {
+        return std::nullopt;
+    }
+    return state_.sequence(slot);
+}
+
+ShardStatus ShardProcess::status()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ShardStatus status{};
+    status.interfaceName = interfaceName_;
+    status.pid = pid_;
+    status.running = pollChild();
+    status.exitDetail = exitDetail_;
+    status.commandsSent = commandsSent_;
+    status.commandsDropped = commandsDropped_;
+    if (state_.ready())
+    {
+        status.state = state_.workerState();
+        status.commandsApplied = state_.commandsApplied();
+        const auto heartbeat = state_.lastHeartbeat();
+        if (heartbeat)
+        {
+            status.heartbeatAge = std::chrono::steady_clock::now() - *heartbeat;
+        }
+    }
+    return status;
+}
+
+std::optional<std::chrono::steady_clock::time_point> ShardProcess::firstPdReceiveTime() const
+{
+    return state_.ready() ? state_.firstPdReceive() : std::nullopt;
+}
+
+ShardEndpointProxy::ShardEndpointProxy(model::TelegramConfig config,
+                                       const std::string &hostIp,
+                                       std::shared_ptr<ShardProcess> shard,
+                                       std::size_t slot)
+    : config_(std::move(config)),
+      direction_(runtime::PdEndpointRuntime::classifyDirection(hostIp, config_)),
+      shard_(std::move(shard)),
+      slot_(slot)
+{
+}
+
+const EndpointSlotState &ShardEndpointProxy::snapshot() const
+{
+    const auto sequence = shard_->slotSequence(slot_);
+    if (sequence && sequence != cachedSequence_)
+    {
+        std::uint32_t loaded = 0U;
+        if (shard_->readSlot(slot_, cached_, &loaded))
+        {
+            cachedSequence_ = loaded;
+        }
+    }
+    return cached_;
+}
+
+bool ShardEndpointProxy::startPublishing(std::chrono::microseconds cycleTime)
+{
+    ShardCommand command{};
+    command.type = ShardCommandType::StartPublishing;
+    command.slot = static_cast<std::uint32_t>(slot_);
+    command.cycleUs = static_cast<std::uint64_t>(std::max<std::int64_t>(1, cycleTime.count()));
+    return shard_->send(command);
+}
+
+bool ShardEndpointProxy::stopPublishing()
+{
+    ShardCommand command{};
+    command.type = ShardCommandType::StopPublishing;
+    command.slot = static_cast<std::uint32_t>(slot_);
+    return shard_->send(command);
+}
+
+bool ShardEndpointProxy::sendPayload(ShardCommandType type, const std::vector<std::uint8_t> &payload)
+{
+    ShardCommand command{};
+    command.type = type;
+    command.slot = static_cast<std::uint32_t>(slot_);
+    command.size = static_cast<std::uint32_t>(std::min(payload.size(), kSlotPayloadBytes));
+    std::copy_n(payload.begin(), command.size, command.bytes);
+    if (payload.size() > kSlotPayloadBytes)
+    {
+        util::logWarn("ComID " + std::to_string(config_.comId) + ": payload cut to " +
+                      std::to_string(kSlotPayloadBytes) + " bytes for the shard worker");
+    }
+    return shard_->send(command);
+}
+
+std::optional<std::chrono::microseconds> ShardEndpointProxy::configuredCycle() const
+{
+    if (config_.pd && config_.pd->cycleUs != 0U)
+    {
+        return std::chrono::microseconds(config_.pd->cycleUs);
+    }
+    return std::nullopt;
+}
+
+bool ShardEndpointProxy::isPublishing() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot().publishing != 0U;
+}
+
+std::size_t ShardEndpointProxy::destinationCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot().destinationCount;
+}
+
+std::uint64_t ShardEndpointProxy::publishCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot().publishCount;
+}
+
+std::optional<std::chrono::system_clock::time_point> ShardEndpointProxy::lastPublishTime() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto &state = snapshot();
+    return toSystemTime(state.hasLastPublish != 0U, state.lastPublishNs);
+}
+
+std::optional<std::chrono::system_clock::time_point> ShardEndpointProxy::lastReceiveTime() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto &state = snapshot();
+    return toSystemTime(state.hasLastReceive != 0U, state.lastReceiveNs);
+}
+
+std::uint64_t ShardEndpointProxy::receiveCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot().receiveCount;
+}
+
+bool ShardEndpointProxy::isLinkLost() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot().linkLost != 0U;
+}
+
+std::uint64_t ShardEndpointProxy::linkLostCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot().linkLostCount;
+}
+
+bool ShardEndpointProxy::setFixedPayload(std::vector<std::uint8_t> payload)
+{
+    return sendPayload(ShardCommandType::SetFixedPayload, payload);
+}
+
+bool ShardEndpointProxy::clearFixedPayload()
+{
+    ShardCommand command{};
+    command.type = ShardCommandType::ClearFixedPayload;
+    command.slot = static_cast<std::uint32_t>(slot_);
+    return shard_->send(command);
+}
+
+bool ShardEndpointProxy::hasFixedPayload() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot().hasFixedPayload != 0U;
+}
+
+std::optional<std::size_t> ShardEndpointProxy::fixedPayloadSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto &state = snapshot();
+    if (state.hasFixedPayload == 0U)
+    {
+        return std::nullopt;
+    }
+    return state.fixedPayloadSize;
+}
+
+bool ShardEndpointProxy::setTxPayload(std::vector<std::uint8_t> payload)
+{
+    return sendPayload(ShardCommandType::SetTxPayload, payload);
+}
+
+std::vector<std::uint8_t> ShardEndpointProxy::txPayload() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto &state = snapshot();
+    return std::vector<std::uint8_t>(state.tx, state.tx + state.txSize);
+}
+
+std::vector<std::uint8_t> ShardEndpointProxy::rxPayload() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto &state = snapshot();
+    return std::vector<std::uint8_t>(state.rx, state.rx + state.rxSize);
+}
+} // namespace trdp::shard
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "model/sim_config.h"
+#include "shard/shard_log.h"
+#include "shard/shard_region.h"
+#include "trdp/pd_endpoint_control.h"
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace trdp::shard
+{
+/** What the UI knows about one worker, for the Stats panel. */
+struct ShardStatus
+{
+    std::string interfaceName;
+    pid_t pid{-1};
+    bool running{false};
+    WorkerState state{WorkerState::Starting};
+    /** How the worker ended, as reported by waitpid(); empty while it runs. */
+    std::string exitDetail;
+    std::optional<std::chrono::steady_clock::duration> heartbeatAge;
+    std::uint64_t commandsSent{0};
+    std::uint64_t commandsApplied{0};
+    std::uint64_t commandsDropped{0};
+};
+
+/**
+ * UI side of one worker process that owns the session of a single interface. The state region is
+ * mapped read-only here; commands go through the shared ring.
+ */
+class ShardProcess
+{
+public:
+    ShardProcess(const model::InterfaceConfig &iface, std::size_t interfaceIndex);
+    ~ShardProcess();
+
+    ShardProcess(const ShardProcess &) = delete;
+    ShardProcess &operator=(const ShardProcess &) = delete;
+
+    /**
+     * Creates the shared memory, the worker's wakeup eventfd and its log pipe and starts
+     * `/proc/self/exe` with `arguments` plus `--shard-worker INDEX:STATEFD:COMMANDFD:WAKEFD:LOGFD`.
+     * The worker's messages are appended to this process's LogStore. With `detachConsole` (the TUI
+     * owns the terminal) its stdout and stderr go to /dev/null.
+     */
+    bool start(const std::vector<std::string> &arguments, bool detachConsole);
+    /** Asks the worker to tear its session down; see awaitExit(). */
+    void requestShutdown();
+    /** Waits for the worker until `deadline`, then kills it. */
+    void awaitExit(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * Queues `command` and wakes the worker. While the queue is full this waits for the worker to
+     * make room, for up to one second; false if the command was not queued.
+     */
+    bool send(const ShardCommand &command);
+    /** Pauses or resumes the worker's session; see runtime::TrdpSession::setPaused(). */
+    bool setPaused(bool paused);
+    /** As last requested through setPaused(). */
+    [[nodiscard]] bool isPaused() const;
+    /** Consistent copy of a telegram's slot; false before the worker has exported anything. */
+    bool readSlot(std::size_t slot, EndpointSlotState &state, std::uint32_t *sequence = nullptr) const;
+    [[nodiscard]] std::optional<std::uint32_t> slotSequence(std::size_t slot) const;
+
+    [[nodiscard]] ShardStatus status();
+    [[nodiscard]] std::optional<std::chrono::steady_clock::time_point> firstPdReceiveTime() const;
+    [[nodiscard]] const std::string &interfaceName() const { return interfaceName_; }
+
+private:
+    /** Reaps the worker if it has exited; false once it is gone. */
+    bool pollChild();
+    void wakeWorker();
+
+    std::string interfaceName_;
+    std::string hostIp_;
+    std::size_t interfaceIndex_;
+    std::size_t slotCount_;
+    SharedMemory stateMemory_;
+    SharedMemory commandMemory_;
+    ShardStateRegion state_;
+    ShardCommandRing commands_;
+    /** eventfd the worker sleeps on between exports; written after every queued command. */
+    int wakeFd_{-1};
+    ShardLogReader log_;
+    mutable std::mutex mutex_;
+    pid_t pid_{-1};
+    bool exited_{false};
+    std::string exitDetail_;
+    std::uint64_t commandsSent_{0};
+    std::uint64_t commandsDropped_{0};
+    bool paused_{false};
+};
+
+/** A telegram owned by a worker process, seen through its state slot. */
+class ShardEndpointProxy final : public runtime::PdEndpointControl
+{
+public:
+    ShardEndpointProxy(model::TelegramConfig config, const std::string &hostIp, std::shared_ptr<ShardProcess> shard, std::size_t slot);
+
+    bool startPublishing(std::chrono::microseconds cycleTime) override;
+    bool stopPublishing() override;
+    /** The worker releases its own handles. */
+    void detachPublisher() override {}
+
+    [[nodiscard]] std::optional<std::chrono::microseconds> configuredCycle() const override;
+    [[nodiscard]] bool isPublishing() const override;
+    [[nodiscard]] std::size_t destinationCount() const override;
+    [[nodiscard]] std::uint64_t publishCount() const override;
+    [[nodiscard]] std::optional<std::chrono::system_clock::time_point> lastPublishTime() const override;
+    [[nodiscard]] std::optional<std::chrono::system_clock::time_point> lastReceiveTime() const override;
+    [[nodiscard]] std::uint64_t receiveCount() const override;
+    [[nodiscard]] bool isLinkLost() const override;
+    [[nodiscard]] std::uint64_t linkLostCount() const override;
+
+    bool setFixedPayload(std::vector<std::uint8_t> payload) override;
+    bool clearFixedPayload() override;
+    [[nodiscard]] bool hasFixedPayload() const override;
+    [[nodiscard]] std::optional<std::size_t> fixedPayloadSize() const override;
+
+    bool setTxPayload(std::vector<std::uint8_t> payload) override;
+    [[nodiscard]] std::vector<std::uint8_t> txPayload() const override;
+    [[nodiscard]] std::vector<std::uint8_t> rxPayload() const override;
+
+    [[nodiscard]] runtime::PdDirection direction() const override { return direction_; }
+
+private:
+    /** The slot as last exported, re-read only when its sequence moved. */
+    const EndpointSlotState &snapshot() const;
+    bool sendPayload(ShardCommandType type, const std::vector<std::uint8_t> &payload);
+
+    model::TelegramConfig config_;
+    runtime::PdDirection direction_;
+    std::shared_ptr<ShardProcess> shard_;
+    std::size_t slot_;
+    mutable std::mutex mutex_;
+    mutable EndpointSlotState cached_{};
+    mutable std::optional<std::uint32_t> cachedSequence_;
+};
+} // namespace trdp::shard
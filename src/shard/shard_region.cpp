@@ -0,0 +1,364 @@
+#include "shard/shard_region.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <type_traits>
+
+namespace trdp::shard
+{
+namespace
+{
+constexpr std::uint32_t kRegionMagic = 0x54534844U; // "TSHD"
+constexpr std::uint32_t kRegionVersion = 1U;
+/** A writer only holds a slot for a few hundred nanoseconds; a reader this unlucky tries again next frame. */
+constexpr int kLoadAttempts = 64;
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free && std::atomic<std::uint64_t>::is_always_lock_free &&
+                  std::atomic<std::int64_t>::is_always_lock_free,
+              "shared-memory atomics must not fall back to process-local locks");
+static_assert(std::is_trivially_copyable_v<EndpointSlotState>);
+static_assert(std::is_trivially_copyable_v<ShardCommand>);
+
+std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1U) / alignment * alignment;
+}
+
+std::string errnoText(const char *what)
+{
+    return std::string(what) + ": " + std::strerror(errno);
+}
+
+std::int64_t toNs(std::chrono::steady_clock::time_point at)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(at.time_since_epoch()).count();
+}
+
+std::int64_t toNs(std::chrono::system_clock::time_point at)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(at.time_since_epoch()).count();
+}
+
+std::uint16_t copyPayload(const std::vector<std::uint8_t> &payload, std::uint8_t *target)
+{
+    const auto size = std::min(payload.size(), kSlotPayloadBytes);
+    std::copy_n(payload.begin(), size, target);
+    return static_cast<std::uint16_t>(size);
+}
+
+std::optional<std::chrono::steady_clock::time_point> fromNs(std::int64_t ns)
+{
+    if (ns == 0)
+    {
+        return std::nullopt;
+    }
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+} // namespace
+
+void captureEndpointState(const runtime::PdEndpointControl &endpoint, EndpointSlotState &state)
+{
+    state = EndpointSlotState{};
+    state.publishing = endpoint.isPublishing() ? 1U : 0U;
+    state.destinationCount = static_cast<std::uint32_t>(endpoint.destinationCount());
+    state.publishCount = endpoint.publishCount();
+    state.receiveCount = endpoint.receiveCount();
+    state.linkLost = endpoint.isLinkLost() ? 1U : 0U;
+    state.linkLostCount = endpoint.linkLostCount();
+    if (const auto lastPublish = endpoint.lastPublishTime())
+    {
+        state.hasLastPublish = 1U;
+        state.lastPublishNs = toNs(*lastPublish);
+    }
+    if (const auto lastReceive = endpoint.lastReceiveTime())
+    {
+        state.hasLastReceive = 1U;
+        state.lastReceiveNs = toNs(*lastReceive);
+    }
+    if (const auto fixedSize = endpoint.fixedPayloadSize())
+    {
+        state.hasFixedPayload = 1U;
+        state.fixedPayloadSize = static_cast<std::uint32_t>(*fixedSize);
+    }
+    state.txSize = copyPayload(endpoint.txPayload(), state.tx);
+    state.rxSize = copyPayload(endpoint.rxPayload(), state.rx);
+}
+
+void storeSlotState(std::atomic<std::uint32_t> &sequence, std::atomic<std::uint64_t> *words,
+                    const EndpointSlotState &state)
+{
+    std::uint64_t source[kSlotStateWords]{};
+    std::memcpy(source, &state, sizeof(state));
+
+    const auto before = sequence.load(std::memory_order_relaxed);
+    sequence.store(before + 1U, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kSlotStateWords; ++i)
+    {
+        words[i].store(source[i], std::memory_order_relaxed);
+    }
+    sequence.store(before + 2U, std::memory_order_release);
+}
+
+bool loadSlotState(const std::atomic<std::uint32_t> &sequence, const std::atomic<std::uint64_t> *words,
+                   EndpointSlotState &state, std::uint32_t *observed)
+{
+    std::uint64_t copy[kSlotStateWords];
+    for (int attempt = 0; attempt < kLoadAttempts; ++attempt)
+    {
+        const auto before = sequence.load(std::memory_order_acquire);
+        if ((before & 1U) != 0U)
+        {
+            continue;
+        }
+        for (std::size_t i = 0; i < kSlotStateWords; ++i)
+        {
+            copy[i] = words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before)
+        {
+            std::memcpy(&state, copy, sizeof(state));
+            if (observed != nullptr)
+            {
+                *observed = before;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+SharedMemory::~SharedMemory()
+{
+    reset();
+}
+
+bool SharedMemory::create(const std::string &name, std::size_t size, bool writable, std::string &error)
+{
+    reset();
+    // Close-on-exec by default: only the worker the descriptor is meant for gets it, explicitly.
+    fd_ = ::memfd_create(name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd_ < 0)
+    {
+        error = errnoText("memfd_create");
+        return false;
+    }
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+    {
+        error = errnoText("ftruncate");
+        reset();
+        return false;
+    }
+    // A peer that shrank the file would turn our next access into SIGBUS.
+    if (::fcntl(fd_, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) != 0)
+    {
+        error = errnoText("F_ADD_SEALS");
+        reset();
+        return false;
+    }
+    size_ = size;
+    return map(writable, error);
+}
+
+bool SharedMemory::attach(int fd, bool writable, std::string &error)
+{
+    reset();
+    fd_ = fd;
+    struct stat info
+    {
+    };
+    if (::fstat(fd_, &info) != 0)
+    {
+        error = errnoText("fstat");
+        reset();
+        return false;
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    return map(writable, error);
+}
+
+bool SharedMemory::map(bool writable, std::string &error)
+{
+    void *data = ::mmap(nullptr, size_, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED)
+    {
+        error = errnoText("mmap");
+        reset();
+        return false;
+    }
+    data_ = data;
+    return true;
+}
+
+void SharedMemory::reset()
+{
+    if (data_ != nullptr)
+    {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+}
+
+std::size_t ShardStateRegion::bytesFor(std::size_t slotCount)
+{
+    return alignUp(sizeof(ShardRegionHeader), alignof(Slot)) + slotCount * sizeof(Slot);
+}
+
+ShardStateRegion::ShardStateRegion(void *base, std::size_t slotCount) : base_(base), slotCount_(slotCount) {}
+
+ShardRegionHeader *ShardStateRegion::header() const
+{
+    return static_cast<ShardRegionHeader *>(base_);
+}
+
+ShardStateRegion::Slot *ShardStateRegion::slot(std::size_t index) const
+{
+    auto *first = static_cast<unsigned char *>(base_) + alignUp(sizeof(ShardRegionHeader), alignof(Slot));
+    return reinterpret_cast<Slot *>(first) + index;
+}
+
+void ShardStateRegion::initialize()
+{
+    // The memfd starts zero-filled, which is a valid value for every atomic in it.
+    auto *head = header();
+    head->version.store(kRegionVersion, std::memory_order_relaxed);
+    head->slotCount.store(static_cast<std::uint32_t>(slotCount_), std::memory_order_relaxed);
+    head->workerState.store(static_cast<std::uint32_t>(WorkerState::Starting), std::memory_order_relaxed);
+    head->magic.store(kRegionMagic, std::memory_order_release);
+}
+
+void ShardStateRegion::setWorkerState(WorkerState state)
+{
+    header()->workerState.store(static_cast<std::uint32_t>(state), std::memory_order_release);
+}
+
+void ShardStateRegion::heartbeat(std::chrono::steady_clock::time_point now)
+{
+    header()->heartbeatNs.store(toNs(now), std::memory_order_release);
+}
+
+void ShardStateRegion::setFirstPdReceive(std::chrono::steady_clock::time_point at)
+{
+    header()->firstPdReceiveNs.store(toNs(at), std::memory_order_release);
+}
+
+void ShardStateRegion::addCommandsApplied(std::uint64_t count)
+{
+    auto *head = header();
+    head->commandsApplied.store(head->commandsApplied.load(std::memory_order_relaxed) + count,
+                                std::memory_order_release);
+}
+
+void ShardStateRegion::store(std::size_t index, const EndpointSlotState &state)
+{
+    auto *target = slot(index);
+    storeSlotState(target->sequence, target->words, state);
+}
+
+bool ShardStateRegion::ready() const
+{
+    if (base_ == nullptr)
+    {
+        return false;
+    }
+    const auto *head = header();
+    return head->magic.load(std::memory_order_acquire) == kRegionMagic &&
+           head->version.load(std::memory_order_relaxed) == kRegionVersion &&
+           head->slotCount.load(std::memory_order_relaxed) == slotCount_;
+}
+
+WorkerState ShardStateRegion::workerState() const
+{
+    return static_cast<WorkerState>(header()->workerState.load(std::memory_order_acquire));
+}
+
+std::optional<std::chrono::steady_clock::time_point> ShardStateRegion::lastHeartbeat() const
+{
+    return fromNs(header()->heartbeatNs.load(std::memory_order_acquire));
+}
+
+std::optional<std::chrono::steady_clock::time_point> ShardStateRegion::firstPdReceive() const
+{
+    return fromNs(header()->firstPdReceiveNs.load(std::memory_order_acquire));
+}
+
+std::uint64_t ShardStateRegion::commandsApplied() const
+{
+    return header()->commandsApplied.load(std::memory_order_acquire);
+}
+
+std::uint32_t ShardStateRegion::sequence(std::size_t index) const
+{
+    return slot(index)->sequence.load(std::memory_order_acquire);
+}
+
+bool ShardStateRegion::load(std::size_t index, EndpointSlotState &state, std::uint32_t *sequence) const
+{
+    const auto *source = slot(index);
+    return loadSlotState(source->sequence, source->words, state, sequence);
+}
+
+struct ShardCommandRing::Layout
+{
+    std::atomic<std::uint32_t> capacity;
+    alignas(64) std::atomic<std::uint64_t> head;
+    alignas(64) std::atomic<std::uint64_t> tail;
+    alignas(64) ShardCommand commands[kCommandRingCapacity];
+};
+
+std::size_t ShardCommandRing::bytes()
+{
+    return sizeof(Layout);
+}
+
+ShardCommandRing::ShardCommandRing(void *base) : layout_(static_cast<Layout *>(base)) {}
+
+void ShardCommandRing::initialize()
+{
+    layout_->head.store(0U, std::memory_order_relaxed);
+    layout_->tail.store(0U, std::memory_order_relaxed);
+    layout_->capacity.store(static_cast<std::uint32_t>(kCommandRingCapacity), std::memory_order_release);
+}
+
+bool ShardCommandRing::push(const ShardCommand &command)
+{
+    const auto tail = layout_->tail.load(std::memory_order_relaxed);
+    if (tail - layout_->head.load(std::memory_order_acquire) >= kCommandRingCapacity)
+    {
+        return false;
+    }
+    layout_->commands[tail % kCommandRingCapacity] = command;
+    layout_->tail.store(tail + 1U, std::memory_order_release);
+    return true;
+}
+
+bool ShardCommandRing::pop(ShardCommand &command)
+{
+    if (layout_->capacity.load(std::memory_order_acquire) != kCommandRingCapacity)
+    {
+        return false;
+    }
+    const auto head = layout_->head.load(std::memory_order_relaxed);
+    if (head == layout_->tail.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    command = layout_->commands[head % kCommandRingCapacity];
+    layout_->head.store(head + 1U, std::memory_order_release);
+    return true;
+}
+} // namespace trdp::shard
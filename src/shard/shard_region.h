@@ -0,0 +1,206 @@
+#pragma once
+
+#include "trdp/pd_endpoint_control.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace trdp::shard
+{
+/** Largest PD payload TRDP carries; TX/RX buffers and command payloads are cut to this size. */
+constexpr std::size_t kSlotPayloadBytes = 1432U;
+constexpr std::size_t kCommandRingCapacity = 64U;
+
+enum class WorkerState : std::uint32_t
+{
+    Starting,
+    Running,
+    /** The session could not be opened; the worker keeps running so the UI can show why. */
+    Failed,
+    Stopped,
+};
+
+/** Everything the UI shows for one telegram, as a worker last exported it. */
+struct EndpointSlotState
+{
+    std::uint64_t publishCount{0};
+    std::uint64_t receiveCount{0};
+    std::uint64_t linkLostCount{0};
+    /** system_clock nanoseconds; only meaningful with the matching `has…` flag. */
+    std::int64_t lastPublishNs{0};
+    std::int64_t lastReceiveNs{0};
+    std::uint32_t destinationCount{0};
+    std::uint32_t fixedPayloadSize{0};
+    std::uint16_t txSize{0};
+    std::uint16_t rxSize{0};
+    std::uint8_t publishing{0};
+    std::uint8_t linkLost{0};
+    std::uint8_t hasFixedPayload{0};
+    std::uint8_t hasLastPublish{0};
+    std::uint8_t hasLastReceive{0};
+    std::uint8_t reserved[7]{};
+    std::uint8_t tx[kSlotPayloadBytes]{};
+    std::uint8_t rx[kSlotPayloadBytes]{};
+};
+
+/**
+ * Start of the state region. Timestamps are steady_clock nanoseconds, which on Linux is
+ * CLOCK_MONOTONIC and therefore comparable between processes.
+ */
+struct ShardRegionHeader
+{
+    /** Written once by the worker; 0 until it has attached. */
+    std::atomic<std::uint32_t> magic;
+    std::atomic<std::uint32_t> version;
+    std::atomic<std::uint32_t> slotCount;
+    std::atomic<std::uint32_t> workerState;
+    std::atomic<std::int64_t> heartbeatNs;
+    std::atomic<std::int64_t> firstPdReceiveNs;
+    std::atomic<std::uint64_t> commandsApplied;
+};
+
+/** Fills `state` from the endpoint's current counters and payloads (cut to kSlotPayloadBytes). */
+void captureEndpointState(const runtime::PdEndpointControl &endpoint, EndpointSlotState &state);
+
+/** 64-bit words an EndpointSlotState occupies in a slot. */
+constexpr std::size_t kSlotStateWords = (sizeof(EndpointSlotState) + 7U) / 8U;
+
+/**
+ * Seqlock write of one slot, shared by ShardStateRegion and StateExport: the counter is odd while
+ * `words` (kSlotStateWords of them) change. One writer per slot.
+ */
+void storeSlotState(std::atomic<std::uint32_t> &sequence, std::atomic<std::uint64_t> *words,
+                    const EndpointSlotState &state);
+/**
+ * Consistent copy of a slot written by storeSlotState(), or false if the writer kept it busy for
+ * every attempt. `observed` receives the even sequence number the copy belongs to.
+ */
+bool loadSlotState(const std::atomic<std::uint32_t> &sequence, const std::atomic<std::uint64_t> *words,
+                   EndpointSlotState &state, std::uint32_t *observed = nullptr);
+
+enum class ShardCommandType : std::uint32_t
+{
+    StartPublishing,
+    StopPublishing,
+    SetTxPayload,
+    SetFixedPayload,
+    ClearFixedPayload,
+    /** Session-wide; `slot` is ignored. */
+    PauseSession,
+    ResumeSession,
+    Shutdown,
+};
+
+struct ShardCommand
+{
+    ShardCommandType type{ShardCommandType::StopPublishing};
+    std::uint32_t slot{0};
+    std::uint64_t cycleUs{0};
+    std::uint32_t size{0};
+    std::uint8_t bytes[kSlotPayloadBytes]{};
+};
+
+/** A sealed-size memfd and its mapping; the descriptor is what a worker inherits. */
+class SharedMemory
+{
+public:
+    SharedMemory() = default;
+    ~SharedMemory();
+
+    SharedMemory(const SharedMemory &) = delete;
+    SharedMemory &operator=(const SharedMemory &) = delete;
+
+    /** New zero-filled memfd of `size` bytes, mapped writable or read-only. */
+    bool create(const std::string &name, std::size_t size, bool writable, std::string &error);
+    /** Maps an inherited descriptor; takes ownership of `fd`. */
+    bool attach(int fd, bool writable, std::string &error);
+    void reset();
+
+    [[nodiscard]] int fd() const { return fd_; }
+    [[nodiscard]] void *data() const { return data_; }
+    [[nodiscard]] std::size_t size() const { return size_; }
+
+private:
+    bool map(bool writable, std::string &error);
+
+    int fd_{-1};
+    void *data_{nullptr};
+    std::size_t size_{0};
+};
+
+/**
+ * Per-telegram state slots behind a header. One writer (the worker) updates a slot under its
+ * sequence counter; readers (the UI, mapping the region read-only) copy it and retry while the
+ * counter is odd or changed underneath them. The state is kept as atomic words so neither side
+ * ever performs a racy plain access.
+ */
+class ShardStateRegion
+{
+public:
+    static std::size_t bytesFor(std::size_t slotCount);
+
+    ShardStateRegion() = default;
+    ShardStateRegion(void *base, std::size_t slotCount);
+
+    /** Worker side, once after mapping. */
+    void initialize();
+    void setWorkerState(WorkerState state);
+    void heartbeat(std::chrono::steady_clock::time_point now);
+    void setFirstPdReceive(std::chrono::steady_clock::time_point at);
+    void addCommandsApplied(std::uint64_t count);
+    void store(std::size_t slot, const EndpointSlotState &state);
+
+    /** False until the worker has initialized a region of the expected size. */
+    [[nodiscard]] bool ready() const;
+    [[nodiscard]] WorkerState workerState() const;
+    [[nodiscard]] std::optional<std::chrono::steady_clock::time_point> lastHeartbeat() const;
+    [[nodiscard]] std::optional<std::chrono::steady_clock::time_point> firstPdReceive() const;
+    [[nodiscard]] std::uint64_t commandsApplied() const;
+    /** Sequence number of a slot; even and unchanged means the last load() is still current. */
+    [[nodiscard]] std::uint32_t sequence(std::size_t slot) const;
+    /** Consistent copy of a slot, or false if the writer kept it busy for every attempt. */
+    bool load(std::size_t slot, EndpointSlotState &state, std::uint32_t *sequence = nullptr) const;
+
+    [[nodiscard]] std::size_t slotCount() const { return slotCount_; }
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint32_t> sequence;
+        std::atomic<std::uint64_t> words[kSlotStateWords];
+    };
+
+    ShardRegionHeader *header() const;
+    Slot *slot(std::size_t index) const;
+
+    void *base_{nullptr};
+    std::size_t slotCount_{0};
+};
+
+/**
+ * Bounded single-producer/single-consumer queue of commands from the UI to a worker. The UI
+ * serializes its producers; the worker's loop is the only consumer.
+ */
+class ShardCommandRing
+{
+public:
+    static std::size_t bytes();
+
+    ShardCommandRing() = default;
+    explicit ShardCommandRing(void *base);
+
+    void initialize();
+    /** False when the ring is full; the command is not queued. */
+    bool push(const ShardCommand &command);
+    bool pop(ShardCommand &command);
+
+private:
+    struct Layout;
+
+    Layout *layout_{nullptr};
+};
+} // namespace trdp::shard
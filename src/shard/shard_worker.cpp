@@ -0,0 +1,280 @@
+#include "shard/shard_worker.h"
+
+#include "config/xml_loader.h"
+#include "shard/shard_log.h"
+#include "shard/shard_region.h"
+#include "trdp/interface_bringup.h"
+#include "util/logging.h"
+#include "util/trace.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <optional>
+#include <sstream>
+
+namespace trdp::shard
+{
+namespace
+{
+/** How often slots are exported; the UI redraws no faster than this. Commands are applied as they arrive. */
+constexpr std::chrono::milliseconds kExportInterval{20};
+constexpr std::chrono::milliseconds kTeardownBudget{500};
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void onStopSignal(int)
+{
+    stopRequested = 1;
+}
+
+/** Applies one command; false for Shutdown. */
+bool applyCommand(const ShardCommand &command, runtime::InterfaceBringUp &bringUp)
+{
+    if (command.type == ShardCommandType::Shutdown)
+    {
+        return false;
+    }
+    if (command.type == ShardCommandType::PauseSession || command.type == ShardCommandType::ResumeSession)
+    {
+        bringUp.session->setPaused(command.type == ShardCommandType::PauseSession);
+        return true;
+    }
+    if (command.slot >= bringUp.endpoints.size())
+    {
+        util::logWarn("Shard command for unknown slot " + std::to_string(command.slot));
+        return true;
+    }
+
+    auto &endpoint = *bringUp.endpoints[command.slot];
+    const auto size = std::min<std::size_t>(command.size, kSlotPayloadBytes);
+    std::vector<std::uint8_t> payload(command.bytes, command.bytes + size);
+    switch (command.type)
+    {
+    case ShardCommandType::StartPublishing:
+        if (endpoint.canTransmit())
+        {
+            endpoint.startPublishing(std::chrono::microseconds(command.cycleUs));
+        }
+        break;
+    case ShardCommandType::StopPublishing:
+        endpoint.stopPublishing();
+        break;
+    case ShardCommandType::SetTxPayload:
+        if (endpoint.canTransmit())
+        {
+            endpoint.setTxPayload(std::move(payload));
+        }
+        break;
+    case ShardCommandType::SetFixedPayload:
+        endpoint.setFixedPayload(std::move(payload));
+        break;
+    case ShardCommandType::ClearFixedPayload:
+        endpoint.clearFixedPayload();
+        break;
+    case ShardCommandType::PauseSession:
+    case ShardCommandType::ResumeSession:
+    case ShardCommandType::Shutdown:
+        break;
+    }
+    return true;
+}
+
+/** Sleeps until `until` or until the UI signals `wakeFd`, whichever comes first. */
+void waitForCommands(int wakeFd, std::chrono::steady_clock::time_point until)
+{
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(until - std::chrono::steady_clock::now());
+    if (remaining.count() <= 0)
+    {
+        return;
+    }
+    pollfd wake{wakeFd, POLLIN, 0};
+    // EINTR from SIGTERM just ends the wait; the loop then sees the stop request.
+    if (::poll(&wake, 1U, static_cast<int>(remaining.count())) > 0)
+    {
+        std::uint64_t count = 0U;
+        (void)::read(wakeFd, &count, sizeof(count));
+    }
+}
+
+void teardown(runtime::InterfaceBringUp &bringUp)
+{
+    auto pending = bringUp.session->requestTeardown();
+    const auto report = bringUp.session->awaitTeardown(pending, std::chrono::steady_clock::now() + kTeardownBudget);
+    if (!report.complete())
+    {
+        util::logWarn("Shard teardown on " + bringUp.iface->hostIp + " did not release every handle");
+    }
+    for (auto &endpoint : bringUp.endpoints)
+    {
+        endpoint->detachPublisher();
+    }
+    bringUp.session->close();
+}
+} // namespace
+
+int runShardWorker(const model::RuntimeOptions &options)
+{
+    // Normally set before exec already; repeated so a worker started by hand behaves the same.
+    ::prctl(PR_SET_PDEATHSIG, SIGTERM);
+    std::signal(SIGTERM, onStopSignal);
+    std::signal(SIGINT, SIG_IGN);
+
+    const auto &shard = options.shard;
+    std::optional<ShardLogWriter> log;
+    if (shard.logFd >= 0)
+    {
+        log.emplace(shard.logFd);
+    }
+    std::string error;
+    SharedMemory stateMemory;
+    SharedMemory commandMemory;
+    if (!stateMemory.attach(shard.stateFd, true, error) || !commandMemory.attach(shard.commandFd, true, error))
+    {
+        util::logError("Shard worker: " + error);
+        return 1;
+    }
+    if (shard.wakeFd < 0)
+    {
+        util::logError("Shard worker: no wakeup descriptor");
+        return 1;
+    }
+    if (commandMemory.size() < ShardCommandRing::bytes())
+    {
+        util::logError("Shard worker: command region too small");
+        return 1;
+    }
+
+    const auto loaded = config::loadSimulatorConfigFromXml(options.configPath);
+    const auto index = static_cast<std::size_t>(shard.workerInterface);
+    if (index >= loaded.config.interfaces.size())
+    {
+        util::logError("Shard worker: interface " + std::to_string(index) + " is not in " + options.configPath);
+        return 1;
+    }
+    const auto &iface = loaded.config.interfaces[index];
+    if (stateMemory.size() < ShardStateRegion::bytesFor(iface.telegrams.size()))
+    {
+        util::logError("Shard worker: state region does not fit the telegrams of " + iface.name);
+        return 1;
+    }
+
+    ShardStateRegion state(stateMemory.data(), iface.telegrams.size());
+    ShardCommandRing commands(commandMemory.data());
+    state.initialize();
+    state.heartbeat(std::chrono::steady_clock::now());
+
+    // Only this interface's session lives in this process, so only it is budgeted for.
+    auto sizing = loaded.config;
+    sizing.interfaces = {iface};
+    runtime::TrdpSession::configureStackMemory(runtime::planStackMemory(sizing));
+
+    auto bringUp = runtime::prepareInterface(iface, runtime::interfaceRealtimeProfile(options, iface));
+    runtime::attachPayloadGenerators(bringUp, options, sizing);
+    const auto recorder = runtime::openRecording(options);
+    bringUp.session->setPdRecorder(recorder);
+    const auto valueExport = runtime::openValueExport(options, sizing);
+    if (valueExport)
+    {
+        for (std::size_t i = 0; i < bringUp.endpoints.size(); ++i)
+        {
+            const auto comId = iface.telegrams[i].comId;
+            bringUp.endpoints[i]->setSubscriptionSink([valueExport, comId](const runtime::PdMessage &message) {
+                const auto timeNs =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(message.timestamp.time_since_epoch()).count();
+                valueExport->append(comId, timeNs, message.payload.data(), message.payload.size());
+            });
+        }
+    }
+    runtime::routeLinkEvents(bringUp, [&iface](const runtime::PdTimeoutEvent &event) {
+        std::ostringstream oss;
+        oss << iface.name << ": ComID " << event.comId
+            << (event.event == runtime::PdLinkEvent::Lost ? " lost (receive timeout)" : " recovered");
+        util::logInfo(oss.str(), {iface.hostIp, event.comId});
+    });
+    runtime::openAndRegister(bringUp);
+    state.setWorkerState(bringUp.session->isOpen() ? WorkerState::Running : WorkerState::Failed);
+
+    std::vector<EndpointSlotState> exported(bringUp.endpoints.size());
+    EndpointSlotState current{};
+    bool firstReceiveExported = false;
+    bool running = true;
+    auto next = std::chrono::steady_clock::now();
+    TRDP_TRACE_THREAD_NAME("shard " + iface.name);
+    while (running && stopRequested == 0)
+    {
+        ShardCommand command{};
+        std::uint64_t applied = 0U;
+        while (running && commands.pop(command))
+        {
+            running = applyCommand(command, bringUp);
+            ++applied;
+        }
+        if (applied != 0U)
+        {
+            state.addCommandsApplied(applied);
+        }
+
+        if (std::chrono::steady_clock::now() < next)
+        {
+            waitForCommands(shard.wakeFd, next);
+            continue;
+        }
+
+        TRDP_TRACE_SCOPE("shard export");
+        // Unchanged slots are not rewritten, so readers polling an idle telegram never retry.
+        for (std::size_t i = 0; i < bringUp.endpoints.size(); ++i)
+        {
+            captureEndpointState(*bringUp.endpoints[i], current);
+            if (std::memcmp(&current, &exported[i], sizeof(current)) != 0)
+            {
+                exported[i] = current;
+                state.store(i, current);
+            }
+        }
+        if (!firstReceiveExported)
+        {
+            if (const auto first = bringUp.session->firstPdReceiveTime())
+            {
+                state.setFirstPdReceive(*first);
+                firstReceiveExported = true;
+            }
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        state.heartbeat(now);
+        next = std::max(next + kExportInterval, now);
+    }
+
+    teardown(bringUp);
+    util::logInfo("Process loop " + iface.name + " (" + iface.hostIp +
+                  "): " + bringUp.session->processLoopStats().summary());
+    if (recorder)
+    {
+        recorder->close();
+        util::logInfo("Recording " + recorder->path() + ": " + recorder->stats().summary());
+    }
+    if (valueExport)
+    {
+        valueExport->close();
+        util::logInfo("Export " + valueExport->directory() + ": " + valueExport->stats().summary());
+    }
+    if (log && log->dropped() != 0U)
+    {
+        util::logWarn("Shard worker " + iface.name + ": " + std::to_string(log->dropped()) +
+                      " log message(s) were dropped while the UI was behind");
+    }
+    state.setWorkerState(WorkerState::Stopped);
+    if (util::trace::enabled())
+    {
+        // Each worker records its own timeline next to the UI's.
+        util::trace::dumpToFile(options.tracePath + "." + iface.name);
+    }
+    return 0;
+}
+} // namespace trdp::shard
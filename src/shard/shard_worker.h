@@ -0,0 +1,13 @@
+#pragma once
+
+#include "model/runtime_options.h"
+
+namespace trdp::shard
+{
+/**
+ * Body of a `--shard-worker` process: brings up the one interface named by `options.shard`,
+ * exports its telegrams into the inherited state region and applies commands from the inherited
+ * ring until told to shut down or the UI process goes away. Returns the process exit code.
+ */
+int runShardWorker(const model::RuntimeOptions &options);
+} // namespace trdp::shard
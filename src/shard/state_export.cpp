@@ -0,0 +1,347 @@
+#include "shard/state_export.h"
+
+#include "util/logging.h"
+#include "util/trace.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+
+namespace trdp::shard
+{
+namespace
+{
+// backend/src/pdStateReader.js decodes these offsets; changing any of them needs a new kVersion.
+static_assert(sizeof(StateExportHeader) == 64U && sizeof(StateExportDescriptor) == 32U);
+static_assert(offsetof(StateExportHeader, heartbeatNs) == 32U && offsetof(StateExportHeader, generation) == 40U &&
+              offsetof(StateExportHeader, pid) == 48U);
+static_assert(offsetof(EndpointSlotState, lastPublishNs) == 24U && offsetof(EndpointSlotState, destinationCount) == 40U &&
+              offsetof(EndpointSlotState, txSize) == 48U && offsetof(EndpointSlotState, publishing) == 52U &&
+              offsetof(EndpointSlotState, hasLastReceive) == 56U && offsetof(EndpointSlotState, tx) == 64U &&
+              offsetof(EndpointSlotState, rx) == 64U + kSlotPayloadBytes);
+static_assert(std::is_trivially_copyable_v<StateExportDescriptor>);
+
+std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1U) / alignment * alignment;
+}
+
+struct Offsets
+{
+    std::size_t descriptors;
+    std::size_t sequences;
+    std::size_t slots;
+    std::size_t stride;
+    std::size_t total;
+};
+
+Offsets offsetsFor(std::size_t slotCount)
+{
+    Offsets offsets{};
+    offsets.descriptors = sizeof(StateExportHeader);
+    offsets.sequences = alignUp(offsets.descriptors + slotCount * sizeof(StateExportDescriptor), 64U);
+    offsets.slots = alignUp(offsets.sequences + slotCount * sizeof(std::uint32_t), 64U);
+    offsets.stride = alignUp(kSlotStateWords * sizeof(std::uint64_t), 64U);
+    offsets.total = offsets.slots + slotCount * offsets.stride;
+    return offsets;
+}
+
+std::string segmentPath(const std::string &name)
+{
+    return "/" + name;
+}
+
+bool validName(const std::string &name)
+{
+    return !name.empty() && name.size() < 200U && name.find('/') == std::string::npos && name != "." && name != "..";
+}
+
+std::atomic<std::uint32_t> *sequenceAt(void *base, std::size_t slot)
+{
+    const auto *header = static_cast<const StateExportHeader *>(base);
+    auto *first = static_cast<unsigned char *>(base) + header->sequenceOffset.load(std::memory_order_relaxed);
+    return reinterpret_cast<std::atomic<std::uint32_t> *>(first) + slot;
+}
+
+std::atomic<std::uint64_t> *wordsAt(void *base, std::size_t slot)
+{
+    const auto *header = static_cast<const StateExportHeader *>(base);
+    auto *first = static_cast<unsigned char *>(base) + header->slotOffset.load(std::memory_order_relaxed) +
+                  slot * header->slotStride.load(std::memory_order_relaxed);
+    return reinterpret_cast<std::atomic<std::uint64_t> *>(first);
+}
+
+std::int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+} // namespace
+
+std::size_t StateExport::bytesFor(std::size_t slotCount)
+{
+    return offsetsFor(slotCount).total;
+}
+
+StateExport::~StateExport()
+{
+    stop();
+}
+
+void StateExport::add(std::uint32_t comId,
+                      std::uint32_t datasetId,
+                      const std::string &interfaceName,
+                      std::shared_ptr<runtime::PdEndpointControl> endpoint)
+{
+    if (endpoint == nullptr)
+    {
+        return;
+    }
+    Telegram telegram{};
+    telegram.descriptor.comId = comId;
+    telegram.descriptor.datasetId = datasetId;
+    telegram.descriptor.direction = static_cast<std::uint8_t>(endpoint->direction());
+    std::memcpy(telegram.descriptor.interfaceName, interfaceName.data(),
+                std::min(interfaceName.size(), sizeof(telegram.descriptor.interfaceName) - 1U));
+    telegram.endpoint = std::move(endpoint);
+    telegrams_.push_back(std::move(telegram));
+}
+
+bool StateExport::start(const std::string &name, std::chrono::milliseconds interval, std::string &error)
+{
+    if (!validName(name))
+    {
+        error = "invalid shared-memory name '" + name + "' (a single path component, as in /dev/shm/NAME)";
+        return false;
+    }
+
+    // A segment left by a crashed run is replaced; readers still mapping it see its heartbeat stop.
+    ::shm_unlink(segmentPath(name).c_str());
+    const int fd = ::shm_open(segmentPath(name).c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+    const auto offsets = offsetsFor(telegrams_.size());
+    if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(offsets.total)) != 0)
+    {
+        error = "shared memory /dev/shm/" + name + ": " + std::strerror(errno);
+        if (fd >= 0)
+        {
+            ::close(fd);
+            ::shm_unlink(segmentPath(name).c_str());
+        }
+        return false;
+    }
+    void *base = ::mmap(nullptr, offsets.total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED)
+    {
+        error = std::string("mmap: ") + std::strerror(errno);
+        ::shm_unlink(segmentPath(name).c_str());
+        return false;
+    }
+
+    base_ = base;
+    size_ = offsets.total;
+    name_ = name;
+    interval_ = interval;
+
+    // The new segment is zero-filled: every sequence starts even and every slot empty.
+    auto *descriptors = reinterpret_cast<StateExportDescriptor *>(static_cast<unsigned char *>(base_) + offsets.descriptors);
+    for (std::size_t i = 0; i < telegrams_.size(); ++i)
+    {
+        descriptors[i] = telegrams_[i].descriptor;
+    }
+    auto *head = header();
+    head->version.store(kVersion, std::memory_order_relaxed);
+    head->slotCount.store(static_cast<std::uint32_t>(telegrams_.size()), std::memory_order_relaxed);
+    head->slotStride.store(static_cast<std::uint32_t>(offsets.stride), std::memory_order_relaxed);
+    head->descriptorOffset.store(static_cast<std::uint32_t>(offsets.descriptors), std::memory_order_relaxed);
+    head->sequenceOffset.store(static_cast<std::uint32_t>(offsets.sequences), std::memory_order_relaxed);
+    head->slotOffset.store(static_cast<std::uint32_t>(offsets.slots), std::memory_order_relaxed);
+    head->intervalMs.store(static_cast<std::uint32_t>(interval.count()), std::memory_order_relaxed);
+    head->pid.store(static_cast<std::uint32_t>(::getpid()), std::memory_order_relaxed);
+    exportChanged();
+    head->magic.store(kMagic, std::memory_order_release);
+
+    running_ = true;
+    thread_ = std::thread([this] { run(); });
+    std::ostringstream oss;
+    oss << "Exporting " << telegrams_.size() << " telegram(s) to /dev/shm/" << name_ << " every " << interval.count()
+        << " ms (" << (size_ >> 10U) << " KiB)";
+    util::logInfo(oss.str());
+    return true;
+}
+
+void StateExport::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_)
+        {
+            return;
+        }
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+    ::munmap(base_, size_);
+    ::shm_unlink(segmentPath(name_).c_str());
+    base_ = nullptr;
+    size_ = 0U;
+}
+
+std::uint64_t StateExport::generation() const
+{
+    return base_ != nullptr ? header()->generation.load(std::memory_order_acquire) : 0U;
+}
+
+StateExportHeader *StateExport::header() const
+{
+    return static_cast<StateExportHeader *>(base_);
+}
+
+void StateExport::run()
+{
+    TRDP_TRACE_THREAD_NAME("state export");
+    auto next = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_)
+    {
+        next += interval_;
+        if (wake_.wait_until(lock, next, [this] { return !running_; }))
+        {
+            break;
+        }
+        lock.unlock();
+        exportChanged();
+        lock.lock();
+        next = std::max(next, std::chrono::steady_clock::now());
+    }
+}
+
+std::size_t StateExport::exportChanged()
+{
+    TRDP_TRACE_SCOPE("state export");
+    EndpointSlotState current{};
+    std::size_t changed = 0U;
+    for (std::size_t i = 0; i < telegrams_.size(); ++i)
+    {
+        captureEndpointState(*telegrams_[i].endpoint, current);
+        if (std::memcmp(&current, &telegrams_[i].exported, sizeof(current)) != 0)
+        {
+            telegrams_[i].exported = current;
+            store(i, current);
+            ++changed;
+        }
+    }
+
+    auto *head = header();
+    if (changed != 0U)
+    {
+        head->generation.store(head->generation.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+    }
+    head->heartbeatNs.store(nowNs(), std::memory_order_release);
+    return changed;
+}
+
+void StateExport::store(std::size_t slot, const EndpointSlotState &state)
+{
+    storeSlotState(*sequenceAt(base_, slot), wordsAt(base_, slot), state);
+}
+
+StateExportReader::~StateExportReader()
+{
+    close();
+}
+
+bool StateExportReader::open(const std::string &name, std::string &error)
+{
+    close();
+    if (!validName(name))
+    {
+        error = "invalid shared-memory name '" + name + "'";
+        return false;
+    }
+    const int fd = ::shm_open(segmentPath(name).c_str(), O_RDONLY | O_CLOEXEC, 0);
+    struct stat info{};
+    if (fd < 0 || ::fstat(fd, &info) != 0)
+    {
+        error = "/dev/shm/" + name + ": " + std::strerror(errno);
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        return false;
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+    void *base = size >= sizeof(StateExportHeader) ? ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (base == MAP_FAILED)
+    {
+        error = "/dev/shm/" + name + " is not a state export";
+        return false;
+    }
+    base_ = base;
+    size_ = size;
+
+    const auto *head = static_cast<const StateExportHeader *>(base_);
+    if (head->magic.load(std::memory_order_acquire) != StateExport::kMagic ||
+        head->version.load(std::memory_order_relaxed) != StateExport::kVersion)
+    {
+        error = "/dev/shm/" + name + " is not a version " + std::to_string(StateExport::kVersion) +
+                " state export, or not set up yet";
+        close();
+        return false;
+    }
+    slotCount_ = head->slotCount.load(std::memory_order_relaxed);
+    if (StateExport::bytesFor(slotCount_) > size_)
+    {
+        error = "/dev/shm/" + name + " is shorter than its " + std::to_string(slotCount_) + " slots";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void StateExportReader::close()
+{
+    if (base_ != nullptr)
+    {
+        ::munmap(base_, size_);
+    }
+    base_ = nullptr;
+    size_ = 0U;
+    slotCount_ = 0U;
+}
+
+const StateExportDescriptor &StateExportReader::descriptor(std::size_t slot) const
+{
+    const auto *head = static_cast<const StateExportHeader *>(base_);
+    const auto *first = static_cast<const unsigned char *>(base_) + head->descriptorOffset.load(std::memory_order_relaxed);
+    return reinterpret_cast<const StateExportDescriptor *>(first)[slot];
+}
+
+std::uint64_t StateExportReader::generation() const
+{
+    return static_cast<const StateExportHeader *>(base_)->generation.load(std::memory_order_acquire);
+}
+
+std::uint32_t StateExportReader::sequence(std::size_t slot) const
+{
+    return sequenceAt(base_, slot)->load(std::memory_order_acquire);
+}
+
+bool StateExportReader::load(std::size_t slot, EndpointSlotState &state, std::uint32_t *sequence) const
+{
+    return loadSlotState(*sequenceAt(base_, slot), wordsAt(base_, slot), state, sequence);
+}
+} // namespace trdp::shard
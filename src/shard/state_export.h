@@ -0,0 +1,147 @@
+#pragma once
+
+#include "shard/shard_region.h"
+#include "trdp/pd_endpoint_control.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trdp::shard
+{
+/**
+ * Start of an exported segment (64 bytes). Offsets are from the start of the segment; all
+ * integers are in host byte order.
+ */
+struct StateExportHeader
+{
+    /** Written last by the exporter; 0 while the segment is being set up. */
+    std::atomic<std::uint32_t> magic;
+    std::atomic<std::uint32_t> version;
+    std::atomic<std::uint32_t> slotCount;
+    /** Bytes from one slot to the next. */
+    std::atomic<std::uint32_t> slotStride;
+    std::atomic<std::uint32_t> descriptorOffset;
+    std::atomic<std::uint32_t> sequenceOffset;
+    std::atomic<std::uint32_t> slotOffset;
+    std::atomic<std::uint32_t> intervalMs;
+    /** system_clock nanoseconds of the last export pass; a reader seeing it stall knows the exporter is gone. */
+    std::atomic<std::int64_t> heartbeatNs;
+    /** Bumped after every pass that rewrote at least one slot; unchanged means nothing to read. */
+    std::atomic<std::uint64_t> generation;
+    std::atomic<std::uint32_t> pid;
+    std::uint32_t reserved[3];
+};
+
+/** What a slot is, written once before the magic (32 bytes). */
+struct StateExportDescriptor
+{
+    std::uint32_t comId{0};
+    std::uint32_t datasetId{0};
+    /** runtime::PdDirection: 0 unknown, 1 outgoing, 2 incoming, 3 loopback. */
+    std::uint8_t direction{0};
+    std::uint8_t reserved[3]{};
+    /** NUL-padded, cut to 19 characters. */
+    char interfaceName[20]{};
+};
+
+/**
+ * `--state-export NAME`: the state of every telegram in the POSIX shared-memory segment
+ * /dev/shm/NAME, for readers outside the simulator such as the web backend
+ * (backend/src/pdStateReader.js).
+ *
+ * Layout: a StateExportHeader, the StateExportDescriptor table, one u32 sequence per slot, then
+ * the slots, each an EndpointSlotState. A thread samples every telegram once per interval and
+ * rewrites only the slots that changed: sequence odd, state, sequence even. A reader copies a
+ * slot whose sequence is even and differs from what it last saw, then checks the sequence again.
+ * Readers never write to the segment, so any number of them cost the simulator nothing.
+ */
+class StateExport
+{
+public:
+    static constexpr std::uint32_t kMagic = 0x53445054U; // "TPDS"
+    static constexpr std::uint32_t kVersion = 1U;
+    static constexpr std::chrono::milliseconds kDefaultInterval{50};
+
+    StateExport() = default;
+    ~StateExport();
+
+    StateExport(const StateExport &) = delete;
+    StateExport &operator=(const StateExport &) = delete;
+
+    /** Adds a slot; call before start(). */
+    void add(std::uint32_t comId,
+             std::uint32_t datasetId,
+             const std::string &interfaceName,
+             std::shared_ptr<runtime::PdEndpointControl> endpoint);
+
+    /** Creates the segment (replacing one left behind) and starts sampling every `interval`. */
+    bool start(const std::string &name, std::chrono::milliseconds interval, std::string &error);
+    /** Stops sampling and removes the segment; mapped readers keep their last copy. */
+    void stop();
+
+    [[nodiscard]] std::uint64_t generation() const;
+    [[nodiscard]] const std::string &name() const { return name_; }
+
+    /** Segment size for `slotCount` slots. */
+    static std::size_t bytesFor(std::size_t slotCount);
+
+private:
+    struct Telegram
+    {
+        StateExportDescriptor descriptor;
+        std::shared_ptr<runtime::PdEndpointControl> endpoint;
+        EndpointSlotState exported;
+    };
+
+    void run();
+    /** Rewrites the slots whose state changed; returns how many. */
+    std::size_t exportChanged();
+    void store(std::size_t slot, const EndpointSlotState &state);
+    [[nodiscard]] StateExportHeader *header() const;
+
+    std::vector<Telegram> telegrams_;
+    std::string name_;
+    void *base_{nullptr};
+    std::size_t size_{0};
+    std::chrono::milliseconds interval_{kDefaultInterval};
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool running_{false};
+    std::thread thread_;
+};
+
+/** Read-only view of an exported segment, following the protocol described at StateExport. */
+class StateExportReader
+{
+public:
+    StateExportReader() = default;
+    ~StateExportReader();
+
+    StateExportReader(const StateExportReader &) = delete;
+    StateExportReader &operator=(const StateExportReader &) = delete;
+
+    /** Maps /dev/shm/NAME; false if it is missing, not yet set up or of another version. */
+    bool open(const std::string &name, std::string &error);
+    void close();
+
+    [[nodiscard]] std::size_t slotCount() const { return slotCount_; }
+    [[nodiscard]] const StateExportDescriptor &descriptor(std::size_t slot) const;
+    [[nodiscard]] std::uint64_t generation() const;
+    [[nodiscard]] std::uint32_t sequence(std::size_t slot) const;
+    /** Consistent copy of a slot, or false if the exporter kept it busy for every attempt. */
+    bool load(std::size_t slot, EndpointSlotState &state, std::uint32_t *sequence = nullptr) const;
+
+private:
+    void *base_{nullptr};
+    std::size_t size_{0};
+    std::size_t slotCount_{0};
+};
+} // namespace trdp::shard
@@ -0,0 +1,218 @@
+#include "trdp/interface_bringup.h"
+
+#include "config/dataset_layout.h"
+#include "util/logging.h"
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+namespace trdp::runtime
+{
+model::RealtimeProfile interfaceRealtimeProfile(const model::RuntimeOptions &options, const model::InterfaceConfig &iface)
+{
+    auto realtime = options.realtime;
+    const auto cpus = options.interfaceCpus.find(iface.name);
+    if (cpus != options.interfaceCpus.end())
+    {
+        realtime.cpus = cpus->second;
+    }
+    return realtime;
+}
+
+std::shared_ptr<record::RecordingWriter> openRecording(const model::RuntimeOptions &options)
+{
+    const auto &recording = options.recording;
+    if (recording.path.empty())
+    {
+        return nullptr;
+    }
+
+    record::RecordingOptions settings;
+    settings.path = options.shard.isWorker()
+                        ? recording.path + ".shard" + std::to_string(options.shard.workerInterface)
+                        : recording.path;
+    settings.segmentBytes = recording.segmentBytes;
+    settings.codec = record::segmentCodecFor(recording.codec);
+    auto writer = std::make_shared<record::RecordingWriter>();
+    std::string error;
+    if (!writer->open(settings, error))
+    {
+        util::logWarn("--record ignored: " + error);
+        return nullptr;
+    }
+    util::logInfo("Recording received PD telegrams to " + settings.path);
+    return writer;
+}
+
+std::shared_ptr<record::ValueExporter> openValueExport(const model::RuntimeOptions &options,
+                                                       const model::SimulatorConfig &config)
+{
+    const auto &valueExport = options.valueExport;
+    if (valueExport.directory.empty())
+    {
+        return nullptr;
+    }
+
+    record::ValueExportOptions settings;
+    settings.directory = options.shard.isWorker()
+                             ? valueExport.directory + "/shard" + std::to_string(options.shard.workerInterface)
+                             : valueExport.directory;
+    settings.format = valueExport.format;
+    auto exporter = std::make_shared<record::ValueExporter>();
+    std::string error;
+    if (!exporter->open(config, settings, error))
+    {
+        util::logWarn("--export ignored: " + error);
+        return nullptr;
+    }
+    for (const auto &skipped : exporter->skipped())
+    {
+        util::logWarn("Not exported: " + skipped);
+    }
+    util::logInfo("Exporting decoded values of " + std::to_string(exporter->tableCount()) + " ComID(s) to " +
+                  settings.directory);
+    return exporter;
+}
+
+InterfaceBringUp prepareInterface(const model::InterfaceConfig &iface, const model::RealtimeProfile &realtime)
+{
+    InterfaceBringUp bringUp{};
+    bringUp.iface = &iface;
+    bringUp.realtime = realtime;
+    bringUp.session = std::make_shared<TrdpSession>(TrdpSessionConfig{
+        iface.hostIp,
+        iface.leaderIp,
+        iface.networkId,
+        iface.process,
+        iface.pdDefaults,
+        realtime,
+        nullptr,
+    });
+
+    bringUp.endpoints.reserve(iface.telegrams.size());
+    for (const auto &telegram : iface.telegrams)
+    {
+        bringUp.endpoints.push_back(std::make_shared<PdEndpointRuntime>(telegram, bringUp.session, iface.hostIp));
+    }
+    return bringUp;
+}
+
+void attachPayloadGenerators(InterfaceBringUp &bringUp,
+                             const model::RuntimeOptions &options,
+                             const model::SimulatorConfig &config)
+{
+    if (options.generators.empty())
+    {
+        return;
+    }
+
+    for (std::size_t i = 0; i < bringUp.endpoints.size(); ++i)
+    {
+        const auto &telegram = bringUp.iface->telegrams[i];
+        std::vector<model::FieldGeneratorRule> rules;
+        std::copy_if(options.generators.begin(), options.generators.end(), std::back_inserter(rules),
+                     [&telegram](const model::FieldGeneratorRule &rule) { return rule.comId == telegram.comId; });
+        if (rules.empty())
+        {
+            continue;
+        }
+
+        std::string error;
+        const auto layout = config::flattenDataset(config, telegram.datasetId, &error);
+        auto program = layout ? PayloadProgram::compile(*layout, rules, bringUp.endpoints[i]->txPayload(), error)
+                              : nullptr;
+        if (program == nullptr)
+        {
+            util::logWarn("--gen ignored for ComID " + std::to_string(telegram.comId) + ": " + error,
+                          {bringUp.iface->hostIp, telegram.comId});
+            continue;
+        }
+
+        std::ostringstream oss;
+        oss << "Generating " << program->operationCount() << " element(s) of ComID " << telegram.comId
+            << " every cycle";
+        util::logInfo(oss.str(), {bringUp.iface->hostIp, telegram.comId});
+        bringUp.endpoints[i]->setPayloadProgram(std::move(program));
+    }
+}
+
+void routeLinkEvents(InterfaceBringUp &bringUp, PdTimeoutSupervisor::Listener observer)
+{
+    std::unordered_multimap<std::uint32_t, std::shared_ptr<PdEndpointRuntime>> byComId;
+    for (std::size_t i = 0; i < bringUp.endpoints.size(); ++i)
+    {
+        byComId.emplace(bringUp.iface->telegrams[i].comId, bringUp.endpoints[i]);
+    }
+    bringUp.session->setPdTimeoutListener([byComId, observer = std::move(observer)](const PdTimeoutEvent &event) {
+        const auto range = byComId.equal_range(event.comId);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            it->second->handleLinkEvent(event);
+        }
+        if (observer)
+        {
+            observer(event);
+        }
+    });
+}
+
+void openAndRegister(InterfaceBringUp &bringUp)
+{
+    if (!bringUp.session->open())
+    {
+        return;
+    }
+
+    PdRegistrationBatch batch{};
+    batch.subscribers.reserve(bringUp.endpoints.size());
+    for (std::size_t i = 0; i < bringUp.endpoints.size(); ++i)
+    {
+        const auto &telegram = bringUp.iface->telegrams[i];
+        PdSubscriber subscriber{};
+        subscriber.comId = telegram.comId;
+        auto endpoint = bringUp.endpoints[i];
+        if (telegram.pd)
+        {
+            subscriber.timeoutUs = telegram.pd->timeoutUs;
+            subscriber.timeoutBehavior = telegram.pd->timeoutBehavior;
+        }
+        // A telegram this device only sends is still subscribed, but nothing is expected to arrive,
+        // so its silence must not be reported as a lost link.
+        if (!endpoint->canReceive())
+        {
+            subscriber.timeoutUs = TRDP_INFINITE_TIMEOUT;
+        }
+        subscriber.destIp = endpoint->multicastGroup();
+        subscriber.callback = [endpoint](const PdMessage &message) { endpoint->handleSubscription(message); };
+        batch.subscribers.push_back(std::move(subscriber));
+    }
+    (void)bringUp.session->registerBatch(std::move(batch));
+
+    if (!bringUp.autoStartPublishers)
+    {
+        return;
+    }
+
+    // FR-PD-01: transmitting telegrams with a configured cycle start publishing right away.
+    std::vector<PdPublishStart> starts;
+    for (const auto &endpoint : bringUp.endpoints)
+    {
+        const auto cycle = endpoint->configuredCycle();
+        if (endpoint->canTransmit() && cycle)
+        {
+            starts.push_back(PdPublishStart{endpoint, *cycle});
+        }
+    }
+    if (!starts.empty())
+    {
+        const auto started = PdEndpointRuntime::startPublishingBatch(*bringUp.session, starts);
+        std::ostringstream oss;
+        oss << "Auto-started " << started << " of " << starts.size() << " PD publishers at their XML cycle on "
+            << bringUp.iface->hostIp;
+        util::logInfo(oss.str());
+    }
+}
+} // namespace trdp::runtime
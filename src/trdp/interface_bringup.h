@@ -0,0 +1,66 @@
+#pragma once
+
+#include "model/runtime_options.h"
+#include "model/sim_config.h"
+#include "record/value_export.h"
+#include "trdp/pd_endpoint.h"
+#include "trdp/trdp_session.h"
+
+#include <memory>
+#include <vector>
+
+namespace trdp::runtime
+{
+/** One configured interface on its way up: its session and one endpoint per `<telegram>`. */
+struct InterfaceBringUp
+{
+    const model::InterfaceConfig *iface{nullptr};
+    std::shared_ptr<TrdpSession> session;
+    /** Parallel to `iface->telegrams`. */
+    std::vector<std::shared_ptr<PdEndpointRuntime>> endpoints;
+    model::RealtimeProfile realtime;
+    /** Off when the raw generator sends this interface's telegrams instead of the stack. */
+    bool autoStartPublishers{true};
+};
+
+/** The command-line real-time profile with the interface's own `--rt-cpus IFACE=LIST` applied. */
+model::RealtimeProfile interfaceRealtimeProfile(const model::RuntimeOptions &options, const model::InterfaceConfig &iface);
+
+/**
+ * Opens the `--record` file, suffixed ".shardN" in a shard worker. Returns nullptr when not
+ * recording or when the file cannot be created, which is logged.
+ */
+std::shared_ptr<record::RecordingWriter> openRecording(const model::RuntimeOptions &options);
+
+/**
+ * Starts the `--export` of decoded RX values for the telegrams of `config`, into a "shardN"
+ * subdirectory in a shard worker. Returns nullptr when not exporting or on failure, which is logged.
+ */
+std::shared_ptr<record::ValueExporter> openValueExport(const model::RuntimeOptions &options,
+                                                       const model::SimulatorConfig &config);
+
+/** Creates the (not yet opened) session and the endpoints of `iface`. */
+InterfaceBringUp prepareInterface(const model::InterfaceConfig &iface, const model::RealtimeProfile &realtime);
+
+/**
+ * Compiles the `--gen` rules for the telegrams of `bringUp` against their datasets and attaches the
+ * programs to the endpoints. A telegram whose rules do not fit its dataset is logged and keeps its
+ * static payload. Must be called before openAndRegister().
+ */
+void attachPayloadGenerators(InterfaceBringUp &bringUp,
+                             const model::RuntimeOptions &options,
+                             const model::SimulatorConfig &config);
+
+/**
+ * Routes the session's receive-timeout events to the endpoints of the same comId, then to
+ * `observer` if one is given. Must be called before openAndRegister().
+ */
+void routeLinkEvents(InterfaceBringUp &bringUp, PdTimeoutSupervisor::Listener observer = {});
+
+/**
+ * Opens the session, subscribes every telegram in one batch and, unless disabled, starts the
+ * publishers that have a cycle time in the XML. Only telegrams the device receives are supervised
+ * for receive timeouts.
+ */
+void openAndRegister(InterfaceBringUp &bringUp);
+} // namespace trdp::runtime
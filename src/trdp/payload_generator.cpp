@@ -0,0 +1,410 @@
+#include "trdp/payload_generator.h"
+
+#include "config/dataset_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace trdp::runtime
+{
+namespace
+{
+constexpr double kTwoPi = 6.283185307179586476925;
+
+/** Value range of an integer element type; false for REAL32/REAL64. */
+bool integerRange(config::ElementType type, double &minimum, double &maximum)
+{
+    using config::ElementType;
+    switch (type)
+    {
+    case ElementType::Bitset8:
+    case ElementType::UInt8:
+        minimum = 0.0;
+        maximum = 255.0;
+        return true;
+    case ElementType::Char8:
+    case ElementType::Int8:
+        minimum = -128.0;
+        maximum = 127.0;
+        return true;
+    case ElementType::Utf16:
+    case ElementType::UInt16:
+        minimum = 0.0;
+        maximum = 65535.0;
+        return true;
+    case ElementType::Int16:
+        minimum = -32768.0;
+        maximum = 32767.0;
+        return true;
+    case ElementType::Int32:
+        minimum = -2147483648.0;
+        maximum = 2147483647.0;
+        return true;
+    case ElementType::UInt32:
+    case ElementType::TimeDate32:
+        minimum = 0.0;
+        maximum = 4294967295.0;
+        return true;
+    case ElementType::Int64:
+        // The largest doubles that still convert without overflow.
+        minimum = -9223372036854775808.0;
+        maximum = 9223372036854774784.0;
+        return true;
+    case ElementType::UInt64:
+        minimum = 0.0;
+        maximum = 18446744073709549568.0;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isWholeNumber(double value)
+{
+    return std::floor(value) == value && std::fabs(value) <= 9007199254740992.0;
+}
+
+/** splitmix64, so that neighbouring seeds and elements start from unrelated xorshift states. */
+std::uint64_t mixSeed(std::uint64_t seed)
+{
+    seed += 0x9E3779B97F4A7C15ULL;
+    seed = (seed ^ (seed >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    seed = (seed ^ (seed >> 27U)) * 0x94D049BB133111EBULL;
+    seed ^= seed >> 31U;
+    return seed != 0U ? seed : 1U;
+}
+} // namespace
+
+std::shared_ptr<PayloadProgram> PayloadProgram::compile(const config::DatasetLayout &layout,
+                                                        const std::vector<model::FieldGeneratorRule> &rules,
+                                                        std::vector<std::uint8_t> base,
+                                                        std::string &error)
+{
+    auto program = std::make_shared<PayloadProgram>();
+    program->wire_ = std::move(base);
+    program->wire_.resize(layout.wireSize, 0U);
+
+    // Element offset -> operation, so that a later rule for the same element replaces the earlier one.
+    std::unordered_map<std::uint32_t, std::size_t> byOffset;
+    for (const auto &rule : rules)
+    {
+        std::uint32_t first = 0U;
+        std::uint32_t count = 0U;
+        const auto *field = config::findField(layout, rule.field, first, count);
+        if (field == nullptr)
+        {
+            error = "dataset " + std::to_string(layout.datasetId) + " has no field '" + rule.field + "'";
+            return nullptr;
+        }
+
+        const auto tableBegin = static_cast<std::uint32_t>(program->table_.size());
+        if (rule.kind == model::FieldGeneratorKind::Table)
+        {
+            program->table_.insert(program->table_.end(), rule.args.begin(), rule.args.end());
+        }
+
+        for (auto element = first; element < first + count; ++element)
+        {
+            Op op;
+            op.tableBegin = tableBegin;
+            if (!compileRule(*field, element, rule, op, error))
+            {
+                error = rule.field + ": " + error;
+                return nullptr;
+            }
+
+            const auto existing = byOffset.find(op.offset);
+            if (op.kind == model::FieldGeneratorKind::Constant)
+            {
+                program->store(op, op.value);
+                if (existing != byOffset.end())
+                {
+                    program->ops_[existing->second].kind = model::FieldGeneratorKind::Constant;
+                    byOffset.erase(existing);
+                }
+            }
+            else if (existing != byOffset.end())
+            {
+                program->ops_[existing->second] = op;
+            }
+            else
+            {
+                byOffset.emplace(op.offset, program->ops_.size());
+                program->ops_.push_back(op);
+            }
+        }
+    }
+
+    // Constants are already in the buffer; overridden operations were turned into constants above.
+    program->ops_.erase(std::remove_if(program->ops_.begin(), program->ops_.end(),
+                                       [](const Op &op) { return op.kind == model::FieldGeneratorKind::Constant; }),
+                        program->ops_.end());
+    return program;
+}
+
+bool PayloadProgram::compileRule(const config::FieldLayout &field, std::uint32_t element,
+                                 const model::FieldGeneratorRule &rule, Op &op, std::string &error)
+{
+    using model::FieldGeneratorKind;
+    if (field.type == config::ElementType::TimeDate48 || field.type == config::ElementType::TimeDate64 ||
+        field.type == config::ElementType::Dataset)
+    {
+        error = "TIMEDATE48 and TIMEDATE64 elements cannot be generated";
+        return false;
+    }
+
+    op.offset = static_cast<std::uint32_t>(field.offset + element * config::elementTypeSize(field.type));
+    op.type = field.type;
+    op.kind = rule.kind;
+    op.integral = integerRange(field.type, op.minimum, op.maximum);
+    const auto &args = rule.args;
+    switch (rule.kind)
+    {
+    case FieldGeneratorKind::Constant:
+        op.value = args[0];
+        break;
+    case FieldGeneratorKind::Counter:
+        if (op.integral && (!isWholeNumber(args[0]) || !isWholeNumber(args[1])))
+        {
+            error = "counter START and STEP must be whole numbers for an integer element";
+            return false;
+        }
+        op.counter = static_cast<std::uint64_t>(static_cast<std::int64_t>(args[0]));
+        op.increment = static_cast<std::uint64_t>(static_cast<std::int64_t>(args[1]));
+        op.value = args[0];
+        op.step = args[1];
+        break;
+    case FieldGeneratorKind::Ramp:
+        op.low = args[0];
+        op.high = args[1];
+        op.step = args[2];
+        op.value = op.step > 0.0 ? op.low : op.high;
+        break;
+    case FieldGeneratorKind::Sine:
+    {
+        if (args[2] > 4294967295.0)
+        {
+            error = "sine PERIOD is too long";
+            return false;
+        }
+        op.value = args[0];
+        op.step = args[1];
+        op.period = static_cast<std::uint32_t>(args[2]);
+        const auto angle = kTwoPi / static_cast<double>(op.period);
+        op.rotationSine = std::sin(angle);
+        op.rotationCosine = std::cos(angle);
+        break;
+    }
+    case FieldGeneratorKind::Random:
+        if (op.integral)
+        {
+            op.value = std::ceil(args[0]);
+            op.step = std::floor(args[1]) - op.value + 1.0;
+            if (op.step < 1.0)
+            {
+                error = "random range holds no integer";
+                return false;
+            }
+        }
+        else
+        {
+            op.value = args[0];
+            op.step = args[1] - args[0];
+        }
+        op.bits = mixSeed(static_cast<std::uint64_t>(args[2]) ^ (std::uint64_t{op.offset} << 32U));
+        break;
+    case FieldGeneratorKind::Toggle:
+        if (!op.integral)
+        {
+            error = "toggle needs an integer element";
+            return false;
+        }
+        op.mask = static_cast<std::uint64_t>(args[0]);
+        op.bits = static_cast<std::uint64_t>(args[1]);
+        break;
+    case FieldGeneratorKind::Table:
+        op.period = static_cast<std::uint32_t>(args.size());
+        break;
+    }
+    return true;
+}
+
+const std::uint8_t *PayloadProgram::evaluate() noexcept
+{
+    using model::FieldGeneratorKind;
+    for (auto &op : ops_)
+    {
+        switch (op.kind)
+        {
+        case FieldGeneratorKind::Counter:
+            if (op.integral)
+            {
+                storeInteger(op, op.counter);
+                op.counter += op.increment;
+            }
+            else
+            {
+                store(op, op.value);
+                op.value += op.step;
+            }
+            break;
+        case FieldGeneratorKind::Ramp:
+            store(op, op.value);
+            op.value += op.step;
+            if (op.value > op.high)
+            {
+                op.value = op.low;
+            }
+            else if (op.value < op.low)
+            {
+                op.value = op.high;
+            }
+            break;
+        case FieldGeneratorKind::Sine:
+            store(op, op.value + op.step * op.sine);
+            // Rotating the phasor costs four multiplications; it restarts exactly at every period so
+            // that rounding never accumulates.
+            if (++op.phase == op.period)
+            {
+                op.phase = 0U;
+                op.sine = 0.0;
+                op.cosine = 1.0;
+            }
+            else
+            {
+                const auto sine = op.sine * op.rotationCosine + op.cosine * op.rotationSine;
+                op.cosine = op.cosine * op.rotationCosine - op.sine * op.rotationSine;
+                op.sine = sine;
+            }
+            break;
+        case FieldGeneratorKind::Random:
+        {
+            // xorshift64*; the top 53 bits give a uniform double in [0, 1).
+            op.bits ^= op.bits >> 12U;
+            op.bits ^= op.bits << 25U;
+            op.bits ^= op.bits >> 27U;
+            const auto unit = static_cast<double>((op.bits * 0x2545F4914F6CDD1DULL) >> 11U) * 0x1.0p-53;
+            const auto value = op.value + unit * op.step;
+            store(op, op.integral ? std::floor(value) : value);
+            break;
+        }
+        case FieldGeneratorKind::Toggle:
+            storeInteger(op, op.bits);
+            op.bits ^= op.mask;
+            break;
+        case FieldGeneratorKind::Table:
+            store(op, table_[op.tableBegin + op.phase]);
+            if (++op.phase == op.period)
+            {
+                op.phase = 0U;
+            }
+            break;
+        case FieldGeneratorKind::Constant:
+            break;
+        }
+    }
+    ++cycles_;
+    return wire_.data();
+}
+
+void PayloadProgram::store(const Op &op, double value) noexcept
+{
+    config::DatasetScalar scalar;
+    if (op.integral)
+    {
+        // Rounds half away from zero; the conversion truncates, and unlike nearbyint() it needs no libm call.
+        const auto clamped = std::clamp(value, op.minimum, op.maximum);
+        scalar.integer = clamped < 0.0 ? static_cast<std::int64_t>(clamped - 0.5)
+                                       : static_cast<std::int64_t>(static_cast<std::uint64_t>(clamped + 0.5));
+    }
+    else
+    {
+        scalar.real = value;
+    }
+    config::storeScalar(op.type, scalar, wire_.data() + op.offset);
+}
+
+void PayloadProgram::storeInteger(const Op &op, std::uint64_t value) noexcept
+{
+    config::DatasetScalar scalar;
+    scalar.integer = static_cast<std::int64_t>(value);
+    config::storeScalar(op.type, scalar, wire_.data() + op.offset);
+}
+
+PayloadScheduler::PayloadScheduler(std::chrono::microseconds resolution, Clock::time_point epoch)
+    : resolution_(std::max(resolution, std::chrono::microseconds(1))), epoch_(epoch)
+{
+}
+
+std::uint64_t PayloadScheduler::add(std::shared_ptr<PayloadProgram> program,
+                                    std::vector<TRDP_PUB_T> pubHandles,
+                                    std::chrono::microseconds cycle,
+                                    Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto id = nextId_++;
+    Entry entry;
+    entry.program = std::move(program);
+    entry.pubHandles = std::move(pubHandles);
+    entry.cycleTicks = std::max<std::uint64_t>(
+        1U, static_cast<std::uint64_t>((cycle.count() + resolution_.count() / 2) / resolution_.count()));
+    entry.dueTick = toTick(now);
+    entry.timer = wheel_.create(id);
+    wheel_.arm(entry.timer, entry.dueTick);
+    entries_.emplace(id, std::move(entry));
+    stats_.programs = entries_.size();
+    return id;
+}
+
+void PayloadScheduler::remove(std::uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = entries_.find(id);
+    if (it == entries_.end())
+    {
+        return;
+    }
+    wheel_.destroy(it->second.timer);
+    entries_.erase(it);
+    stats_.programs = entries_.size();
+}
+
+void PayloadScheduler::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &entry : entries_)
+    {
+        wheel_.destroy(entry.second.timer);
+    }
+    entries_.clear();
+    stats_.programs = 0U;
+}
+
+std::optional<PayloadScheduler::Clock::time_point> PayloadScheduler::nextDeadline() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto tick = wheel_.nextEventTick();
+    if (!tick)
+    {
+        return std::nullopt;
+    }
+    return epoch_ + resolution_ * static_cast<std::int64_t>(*tick);
+}
+
+PayloadGeneratorStats PayloadScheduler::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::uint64_t PayloadScheduler::toTick(Clock::time_point time) const
+{
+    if (time <= epoch_)
+    {
+        return 0U;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - epoch_);
+    return static_cast<std::uint64_t>(elapsed / resolution_);
+}
+} // namespace trdp::runtime
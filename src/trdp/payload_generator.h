@@ -0,0 +1,192 @@
+#pragma once
+
+#include "config/dataset_layout.h"
+#include "model/runtime_options.h"
+#include "util/timer_wheel.h"
+
+#include <trdp_if_light.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trdp::runtime
+{
+/**
+ * The `--gen` rules of one telegram compiled against its dataset layout: a flat list of operations,
+ * one per generated element, each holding its wire offset, element type and generator state.
+ *
+ * evaluate() runs the list once per cycle and writes every element in network byte order straight
+ * into the wire buffer; it neither allocates nor looks at names. Constants are written once at
+ * compile time, fields without a rule keep the base payload. Not thread-safe: once handed to a
+ * session, only its process thread evaluates the program.
+ */
+class PayloadProgram
+{
+public:
+    /**
+     * Compiles `rules` (all for the same telegram) against `layout`. `base` is the payload around
+     * the generated fields, zero-filled or cut to the wire size. Later rules for the same element
+     * replace earlier ones. Returns nullptr with `error` set when a rule names no field of the
+     * dataset or does not suit its type.
+     */
+    static std::shared_ptr<PayloadProgram> compile(const config::DatasetLayout &layout,
+                                                   const std::vector<model::FieldGeneratorRule> &rules,
+                                                   std::vector<std::uint8_t> base,
+                                                   std::string &error);
+
+    /** Writes this cycle's values into the wire buffer, advances every generator and returns the buffer. */
+    const std::uint8_t *evaluate() noexcept;
+
+    [[nodiscard]] const std::vector<std::uint8_t> &wire() const { return wire_; }
+    [[nodiscard]] std::size_t size() const { return wire_.size(); }
+    /** Elements written per evaluate(); constants are not counted. */
+    [[nodiscard]] std::size_t operationCount() const { return ops_.size(); }
+    [[nodiscard]] std::uint64_t cycles() const { return cycles_; }
+
+private:
+    struct Op
+    {
+        std::uint32_t offset{0};
+        config::ElementType type{config::ElementType::UInt8};
+        model::FieldGeneratorKind kind{model::FieldGeneratorKind::Counter};
+        /** Integer elements take real values rounded and clamped to [minimum, maximum]. */
+        bool integral{true};
+        double minimum{0.0};
+        double maximum{0.0};
+        /** Counter/Ramp: next value; Sine: offset; Random: lower bound. */
+        double value{0.0};
+        /** Counter/Ramp: increment; Sine: amplitude; Random: width of the range. */
+        double step{0.0};
+        /** Ramp bounds. */
+        double low{0.0};
+        double high{0.0};
+        /** Sine: current phasor and the per-cycle rotation. */
+        double sine{0.0};
+        double cosine{1.0};
+        double rotationSine{0.0};
+        double rotationCosine{1.0};
+        /** Integer counters wrap at the element width. */
+        std::uint64_t counter{0};
+        std::uint64_t increment{0};
+        /** Toggle: current bits and the mask flipped every cycle; Random: xorshift state. */
+        std::uint64_t bits{0};
+        std::uint64_t mask{0};
+        /** Sine: cycle within the period; Table: current entry. */
+        std::uint32_t phase{0};
+        std::uint32_t period{0};
+        std::uint32_t tableBegin{0};
+    };
+
+    static bool compileRule(const config::FieldLayout &field, std::uint32_t element,
+                            const model::FieldGeneratorRule &rule, Op &op, std::string &error);
+    void store(const Op &op, double value) noexcept;
+    void storeInteger(const Op &op, std::uint64_t value) noexcept;
+
+    std::vector<Op> ops_;
+    std::vector<double> table_;
+    std::vector<std::uint8_t> wire_;
+    std::uint64_t cycles_{0};
+};
+
+struct PayloadGeneratorStats
+{
+    std::size_t programs{0};
+    std::uint64_t evaluations{0};
+    std::uint64_t puts{0};
+    std::uint64_t putErrors{0};
+    /** Cycles not generated because the process thread came back more than a cycle late. */
+    std::uint64_t skippedCycles{0};
+};
+
+/**
+ * Runs the payload programs of a session's publishers, one timer per program in a timer wheel.
+ *
+ * advance() evaluates every program whose cycle is due and hands the result to `put` once per
+ * publisher handle, so the stack sends the new values with its next telegram. A program that falls
+ * more than a cycle behind skips the missed cycles instead of catching up in a burst. The session's
+ * process thread drives add/remove/advance; stats() may be called from any thread.
+ */
+class PayloadScheduler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit PayloadScheduler(std::chrono::microseconds resolution = std::chrono::microseconds(100),
+                              Clock::time_point epoch = Clock::now());
+
+    /** Schedules `program` every `cycle`, first at `now`; returns the id for remove(). */
+    std::uint64_t add(std::shared_ptr<PayloadProgram> program,
+                      std::vector<TRDP_PUB_T> pubHandles,
+                      std::chrono::microseconds cycle,
+                      Clock::time_point now);
+    void remove(std::uint64_t id);
+    void clear();
+
+    /** `put(handle, data, size)` returns false when the publisher rejected the payload. */
+    template <typename Put>
+    void advance(Clock::time_point now, Put &&put)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto nowTick = toTick(now);
+        wheel_.advance(nowTick, [&](util::TimerWheel::TimerId, std::uint64_t id) {
+            const auto it = entries_.find(id);
+            if (it == entries_.end())
+            {
+                return;
+            }
+
+            auto &entry = it->second;
+            const auto *payload = entry.program->evaluate();
+            for (const auto handle : entry.pubHandles)
+            {
+                if (!put(handle, payload, entry.program->size()))
+                {
+                    ++stats_.putErrors;
+                }
+            }
+            ++stats_.evaluations;
+            stats_.puts += entry.pubHandles.size();
+
+            entry.dueTick += entry.cycleTicks;
+            if (entry.dueTick <= nowTick)
+            {
+                const auto missed = (nowTick - entry.dueTick) / entry.cycleTicks + 1U;
+                stats_.skippedCycles += missed;
+                entry.dueTick += missed * entry.cycleTicks;
+            }
+            wheel_.arm(entry.timer, entry.dueTick);
+        });
+    }
+
+    /** When advance() next has work to do; std::nullopt while no program is scheduled. */
+    [[nodiscard]] std::optional<Clock::time_point> nextDeadline() const;
+    [[nodiscard]] PayloadGeneratorStats stats() const;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<PayloadProgram> program;
+        std::vector<TRDP_PUB_T> pubHandles;
+        util::TimerWheel::TimerId timer{util::TimerWheel::kInvalidTimer};
+        std::uint64_t cycleTicks{1};
+        std::uint64_t dueTick{0};
+    };
+
+    std::uint64_t toTick(Clock::time_point time) const;
+
+    std::chrono::microseconds resolution_;
+    Clock::time_point epoch_;
+    mutable std::mutex mutex_;
+    util::TimerWheel wheel_;
+    std::unordered_map<std::uint64_t, Entry> entries_;
+    std::uint64_t nextId_{1};
+    PayloadGeneratorStats stats_{};
+};
+} // namespace trdp::runtime
@@ -1,15 +1,21 @@
 #include "trdp/pd_endpoint.h"
 
+#include "util/trace.h"
+
 #include <algorithm>
 #include <vos_sock.h>
 
-#include <future>
+#include <iterator>
+#include <limits>
 #include <sstream>
 
 namespace trdp::runtime
 {
 namespace
 {
+// Callers include the UI and control threads, so a stalled process thread must not hang them.
+constexpr auto kUnpublishTimeout = std::chrono::milliseconds(500);
+
 std::vector<std::uint8_t> makePayload(std::uint64_t count)
 {
     std::vector<std::uint8_t> payload(sizeof(count));
@@ -19,8 +25,41 @@ std::vector<std::uint8_t> makePayload(std::uint64_t count)
     }
     return payload;
 }
+
+util::LogTags endpointTags(const std::shared_ptr<TrdpSession> &session, std::uint32_t comId)
+{
+    return util::LogTags{session != nullptr ? session->hostIpString() : std::string{}, comId};
+}
 } // namespace
 
+std::vector<TRDP_IP_ADDR_T> resolvePublishDestinations(const model::TelegramConfig &config, TRDP_IP_ADDR_T fallback)
+{
+    std::vector<TRDP_IP_ADDR_T> destinations;
+    destinations.reserve(config.destinations.size());
+    for (const auto &destination : config.destinations)
+    {
+        const auto address = destination.uriHost.empty() ? 0U : vos_dottedIP(destination.uriHost.c_str());
+        if (address != 0U && std::find(destinations.begin(), destinations.end(), address) == destinations.end())
+        {
+            destinations.push_back(address);
+        }
+    }
+
+    if (destinations.empty() && !config.sources.empty() && !config.sources.front().uriHost.empty())
+    {
+        const auto address = vos_dottedIP(config.sources.front().uriHost.c_str());
+        if (address != 0U)
+        {
+            destinations.push_back(address);
+        }
+    }
+    if (destinations.empty())
+    {
+        destinations.push_back(fallback);
+    }
+    return destinations;
+}
+
 PdEndpointRuntime::PdEndpointRuntime(model::TelegramConfig config,
                                      std::shared_ptr<TrdpSession> session,
                                      std::string hostIp)
@@ -34,128 +73,246 @@ PdEndpointRuntime::~PdEndpointRuntime()
     stopPublishing();
 }
 
-void PdEndpointRuntime::startPublishing(std::chrono::milliseconds cycleTime)
+bool PdEndpointRuntime::startPublishing(std::chrono::microseconds cycleTime)
 {
+    TRDP_TRACE_SCOPE_ARG("startPublishing", "comId", config_.comId);
     stopPublishing();
 
+    if (!sessionReady())
+    {
+        return false;
+    }
+
+    PdRegistrationBatch batch{};
+    batch.publications = preparePublications(cycleTime);
+    return attachPublishers(session_->registerBatch(std::move(batch)).pubHandles, cycleTime);
+}
+
+std::size_t PdEndpointRuntime::startPublishingBatch(TrdpSession &session, const std::vector<PdPublishStart> &starts)
+{
+    TRDP_TRACE_SCOPE_ARG("startPublishingBatch", "publishers", starts.size());
+    PdRegistrationBatch batch{};
+    std::vector<std::pair<const PdPublishStart *, std::size_t>> pending;
+    for (const auto &start : starts)
+    {
+        if (start.endpoint == nullptr || start.endpoint->session_.get() != &session)
+        {
+            continue;
+        }
+
+        start.endpoint->stopPublishing();
+        if (!start.endpoint->sessionReady())
+        {
+            continue;
+        }
+        auto publications = start.endpoint->preparePublications(start.cycleTime);
+        pending.emplace_back(&start, publications.size());
+        std::move(publications.begin(), publications.end(), std::back_inserter(batch.publications));
+    }
+
+    if (pending.empty())
+    {
+        return 0U;
+    }
+
+    const auto result = session.registerBatch(std::move(batch));
+    std::size_t started = 0U;
+    std::size_t offset = 0U;
+    for (const auto &[start, count] : pending)
+    {
+        // Handles are index-aligned with the publications, so each endpoint takes its own slice.
+        const auto first = std::min(offset, result.pubHandles.size());
+        const auto last = std::min(offset + count, result.pubHandles.size());
+        offset += count;
+        if (start->endpoint->attachPublishers(
+                std::vector<TRDP_PUB_T>(result.pubHandles.begin() + first, result.pubHandles.begin() + last),
+                start->cycleTime))
+        {
+            ++started;
+        }
+    }
+    return started;
+}
+
+bool PdEndpointRuntime::sessionReady() const
+{
     if (session_ == nullptr || !session_->isOpen())
     {
-        util::logWarn("Cannot start PD publisher without an open TRDP session");
-        return;
+        util::logWarn("Cannot start PD publisher without an open TRDP session", endpointTags(session_, config_.comId));
+        return false;
     }
 
-    const auto appHandle = session_->appHandle();
-    if (appHandle == nullptr)
+    if (!session_->isVirtual() && session_->appHandle() == nullptr)
     {
-        util::logWarn("TRDP session handle unavailable; skipping publish start");
-        return;
+        util::logWarn("TRDP session handle unavailable; skipping publish start", endpointTags(session_, config_.comId));
+        return false;
     }
+    return true;
+}
 
-    publishCount_.store(0);
+std::vector<PdPublication> PdEndpointRuntime::preparePublications(std::chrono::microseconds cycleTime)
+{
+    sends_->sent.store(0);
+    sends_->lastSentNs.store(0);
     receiveCount_.store(0);
-    lastPublish_.reset();
-    lastReceive_.reset();
-
-    destIp_ = resolveDestinationIp();
-    publishBuffer_ = buildPayload(0U);
-
-    const auto intervalUs = static_cast<UINT32>(std::max<std::int64_t>(1, cycleTime.count()) * 1000);
-    const auto pubErr = tlp_publish(
-        appHandle,
-        &pubHandle_,
-        this,
-        nullptr,
-        config_.serviceId,
-        config_.comId,
-        0U,
-        0U,
-        session_->hostAddress(),
-        destIp_,
-        intervalUs,
-        0U,
-        TRDP_FLAGS_DEFAULT,
-        nullptr,
-        publishBuffer_.data(),
-        static_cast<UINT32>(publishBuffer_.size()));
-
-    if (pubErr != TRDP_NO_ERR)
-    {
-        std::ostringstream err;
-        err << "Failed to publish PD comId " << config_.comId << " (error " << static_cast<int>(pubErr) << ")";
-        util::logError(err.str());
-        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastReceive_.reset();
     }
 
-    const auto updateErr = tlc_updateSession(appHandle);
-    if (updateErr != TRDP_NO_ERR)
+    auto payload = std::make_shared<const std::vector<std::uint8_t>>(buildPayload(0U));
     {
-        std::ostringstream err;
-        err << "tlc_updateSession failed after publish for comId " << config_.comId << " (error "
-            << static_cast<int>(updateErr) << ")";
-        util::logWarn(err.str());
+        std::lock_guard<std::mutex> lock(publisherMutex_);
+        publishBuffer_ = payload;
     }
 
-    { 
+    // A multicast group is one publisher; a unicast list gets one publisher per device, all
+    // sharing the payload buffer above.
+    std::vector<PdPublication> publications;
+    for (const auto destIp : resolvePublishDestinations(config_, session_->hostAddress()))
+    {
+        PdPublication publication{};
+        publication.serviceId = config_.serviceId;
+        publication.comId = config_.comId;
+        publication.destIp = destIp;
+        publication.intervalUs = static_cast<std::uint32_t>(
+            std::clamp<std::int64_t>(cycleTime.count(), 1, std::numeric_limits<std::uint32_t>::max()));
+        publication.redundant = config_.pd ? config_.pd->redundant : 0U;
+        publication.payload = payload;
+        publication.sends = sends_;
+        publications.push_back(std::move(publication));
+    }
+    return publications;
+}
+
+bool PdEndpointRuntime::attachPublishers(const std::vector<TRDP_PUB_T> &pubHandles, std::chrono::microseconds cycleTime)
+{
+    std::lock_guard<std::mutex> publisherLock(publisherMutex_);
+    pubHandles_.clear();
+    std::copy_if(pubHandles.begin(), pubHandles.end(), std::back_inserter(pubHandles_),
+                 [](TRDP_PUB_T handle) { return handle != nullptr; });
+    if (pubHandles_.empty())
+    {
+        publishBuffer_.reset();
+        return false;
+    }
+    if (pubHandles_.size() != pubHandles.size())
+    {
+        std::ostringstream oss;
+        oss << "PD comId " << config_.comId << " reaches only " << pubHandles_.size() << " of " << pubHandles.size()
+            << " destinations";
+        util::logWarn(oss.str(), endpointTags(session_, config_.comId));
+    }
+    destinationCount_.store(pubHandles_.size());
+    std::shared_ptr<PayloadProgram> program;
+    {
         std::lock_guard<std::mutex> lock(mutex_);
-        lastPublish_ = std::chrono::system_clock::now();
-        publishCount_.store(1);
+        if (!fixedPayload_)
+        {
+            program = payloadProgram_;
+        }
+    }
+    if (program != nullptr)
+    {
+        runningProgram_ = session_->runPayloadProgram(std::move(program), pubHandles_, cycleTime);
     }
 
     running_.store(true);
 
     std::ostringstream oss;
-    oss << "Starting PD publisher for comId " << config_.comId << " every " << cycleTime.count() << " ms";
-    util::logInfo(oss.str());
+    oss << "Starting PD publisher for comId " << config_.comId << " every " << cycleTime.count() << " us to "
+        << pubHandles_.size() << " destination(s)";
+    util::logInfo(oss.str(), endpointTags(session_, config_.comId));
+    return true;
 }
 
-void PdEndpointRuntime::stopPublishing()
+bool PdEndpointRuntime::stopPublishing()
 {
-    util::logDebug("stopPublishing invoked");
+    util::logDebug("stopPublishing invoked", endpointTags(session_, config_.comId));
+    std::lock_guard<std::mutex> publisherLock(publisherMutex_);
     const bool wasRunning = running_.exchange(false);
+    bool released = true;
     if (wasRunning)
     {
-        if (session_ != nullptr && session_->appHandle() != nullptr && pubHandle_ != nullptr)
+        if (session_ != nullptr && runningProgram_ != 0U)
         {
-            auto *appHandle = session_->appHandle();
-            auto *pubHandle = pubHandle_;
-            util::logDebug("Calling tlp_unpublish");
-            auto future = std::async(std::launch::async, [appHandle, pubHandle] {
-                return tlp_unpublish(appHandle, pubHandle);
-            });
-
-            if (future.wait_for(std::chrono::milliseconds(500)) == std::future_status::ready)
-            {
-                (void)future.get();
-                util::logDebug("tlp_unpublish completed");
-            }
-            else
-            {
-                util::logWarn("tlp_unpublish timed out; continuing shutdown");
-            }
+            session_->stopPayloadProgram(runningProgram_);
         }
-        pubHandle_ = nullptr;
-        publishBuffer_.clear();
+        runningProgram_ = 0U;
+        if (session_ != nullptr && !pubHandles_.empty())
+        {
+            released = session_->unpublishPd(pubHandles_, std::chrono::steady_clock::now() + kUnpublishTimeout) ==
+                       pubHandles_.size();
+        }
+        pubHandles_.clear();
+        publishBuffer_.reset();
+        destinationCount_.store(0U);
 
         std::ostringstream oss;
         oss << "Stopping PD publisher for comId " << config_.comId;
-        util::logInfo(oss.str());
+        util::logInfo(oss.str(), endpointTags(session_, config_.comId));
+    }
+    return released;
+}
+
+void PdEndpointRuntime::detachPublisher()
+{
+    std::lock_guard<std::mutex> publisherLock(publisherMutex_);
+    if (running_.exchange(false))
+    {
+        runningProgram_ = 0U;
+        pubHandles_.clear();
+        publishBuffer_.reset();
+        destinationCount_.store(0U);
     }
 }
 
+std::optional<std::chrono::microseconds> PdEndpointRuntime::configuredCycle() const
+{
+    if (config_.pd && config_.pd->cycleUs != 0U)
+    {
+        return std::chrono::microseconds(config_.pd->cycleUs);
+    }
+    return std::nullopt;
+}
+
 bool PdEndpointRuntime::isPublishing() const
 {
     return running_.load();
 }
 
+std::size_t PdEndpointRuntime::destinationCount() const
+{
+    return destinationCount_.load();
+}
+
+TRDP_IP_ADDR_T PdEndpointRuntime::multicastGroup() const
+{
+    for (const auto &destination : config_.destinations)
+    {
+        const auto address = destination.uriHost.empty() ? 0U : vos_dottedIP(destination.uriHost.c_str());
+        if (address != 0U && vos_isMulticast(address))
+        {
+            return address;
+        }
+    }
+    return 0U;
+}
+
 std::uint64_t PdEndpointRuntime::publishCount() const
 {
-    return publishCount_.load();
+    return sends_->sent.load();
 }
 
 std::optional<std::chrono::system_clock::time_point> PdEndpointRuntime::lastPublishTime() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return lastPublish_;
+    const auto lastSentNs = sends_->lastSentNs.load();
+    if (lastSentNs == 0)
+    {
+        return std::nullopt;
+    }
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(lastSentNs)));
 }
 
 std::optional<std::chrono::system_clock::time_point> PdEndpointRuntime::lastReceiveTime() const
@@ -171,9 +328,10 @@ std::uint64_t PdEndpointRuntime::receiveCount() const
 
 void PdEndpointRuntime::handleSubscription(const PdMessage &message)
 {
+    TRDP_TRACE_SCOPE_ARG("handleSubscription", "comId", message.comId);
     std::ostringstream oss;
     oss << "Received PD telegram comId=" << message.comId << " payload=" << message.payload.size() << " bytes";
-    util::logDebug(oss.str());
+    util::logDebug(oss.str(), endpointTags(session_, message.comId));
 
     SubscriptionSink sink;
     { 
@@ -194,19 +352,46 @@ void PdEndpointRuntime::setSubscriptionSink(SubscriptionSink sink)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     subscriptionSink_ = std::move(sink);
-    util::logInfo("Registered PD subscription sink");
+    util::logInfo("Registered PD subscription sink", endpointTags(session_, config_.comId));
 }
 
-void PdEndpointRuntime::setFixedPayload(std::vector<std::uint8_t> payload)
+void PdEndpointRuntime::handleLinkEvent(const PdTimeoutEvent &event)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    fixedPayload_ = std::move(payload);
+    const bool lost = event.event == PdLinkEvent::Lost;
+    if (linkLost_.exchange(lost) != lost && lost)
+    {
+        linkLostCount_.fetch_add(1);
+    }
 }
 
-void PdEndpointRuntime::clearFixedPayload()
+bool PdEndpointRuntime::isLinkLost() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    fixedPayload_.reset();
+    return linkLost_.load();
+}
+
+std::uint64_t PdEndpointRuntime::linkLostCount() const
+{
+    return linkLostCount_.load();
+}
+
+bool PdEndpointRuntime::setFixedPayload(std::vector<std::uint8_t> payload)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fixedPayload_ = std::move(payload);
+    }
+    refreshPublishedPayload();
+    return true;
+}
+
+bool PdEndpointRuntime::clearFixedPayload()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fixedPayload_.reset();
+    }
+    refreshPublishedPayload();
+    return true;
 }
 
 bool PdEndpointRuntime::hasFixedPayload() const
@@ -225,10 +410,26 @@ std::optional<std::size_t> PdEndpointRuntime::fixedPayloadSize() const
     return std::nullopt;
 }
 
-void PdEndpointRuntime::setTxPayload(std::vector<std::uint8_t> payload)
+void PdEndpointRuntime::setPayloadProgram(std::shared_ptr<PayloadProgram> program)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    payloadProgram_ = std::move(program);
+}
+
+bool PdEndpointRuntime::hasPayloadProgram() const
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    txPayload_ = std::move(payload);
+    return payloadProgram_ != nullptr;
+}
+
+bool PdEndpointRuntime::setTxPayload(std::vector<std::uint8_t> payload)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        txPayload_ = std::move(payload);
+    }
+    refreshPublishedPayload();
+    return true;
 }
 
 std::vector<std::uint8_t> PdEndpointRuntime::txPayload() const
@@ -248,16 +449,6 @@ PdDirection PdEndpointRuntime::direction() const
     return direction_;
 }
 
-bool PdEndpointRuntime::canTransmit() const
-{
-    return direction_ == PdDirection::Outgoing || direction_ == PdDirection::Loopback;
-}
-
-bool PdEndpointRuntime::canReceive() const
-{
-    return direction_ == PdDirection::Incoming || direction_ == PdDirection::Loopback;
-}
-
 std::vector<std::uint8_t> PdEndpointRuntime::buildPayload(std::uint64_t count)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -266,6 +457,12 @@ std::vector<std::uint8_t> PdEndpointRuntime::buildPayload(std::uint64_t count)
         return *fixedPayload_;
     }
 
+    // The program is not running while publishers are (re)started, so its buffer is stable here.
+    if (payloadProgram_ != nullptr)
+    {
+        return payloadProgram_->wire();
+    }
+
     if (!txPayload_.empty())
     {
         return txPayload_;
@@ -274,6 +471,19 @@ std::vector<std::uint8_t> PdEndpointRuntime::buildPayload(std::uint64_t count)
     return makePayload(count);
 }
 
+void PdEndpointRuntime::refreshPublishedPayload()
+{
+    std::lock_guard<std::mutex> publisherLock(publisherMutex_);
+    // A running program puts its own payload every cycle; it only picks up a fixed payload on restart.
+    if (!running_.load() || pubHandles_.empty() || runningProgram_ != 0U || session_ == nullptr)
+    {
+        return;
+    }
+
+    publishBuffer_ = std::make_shared<const std::vector<std::uint8_t>>(buildPayload(publishCount()));
+    session_->putPd(pubHandles_, publishBuffer_);
+}
+
 PdDirection PdEndpointRuntime::classifyDirection(const std::string &hostIp, const model::TelegramConfig &config)
 {
     const auto matchesHost = [&hostIp](const auto &endpoints) {
@@ -313,19 +523,4 @@ PdDirection PdEndpointRuntime::classifyDirection(const std::string &hostIp, cons
     return PdDirection::Unknown;
 }
 
-TRDP_IP_ADDR_T PdEndpointRuntime::resolveDestinationIp() const
-{
-    if (!config_.destinations.empty() && !config_.destinations.front().uriHost.empty())
-    {
-        return vos_dottedIP(config_.destinations.front().uriHost.c_str());
-    }
-
-    if (!config_.sources.empty() && !config_.sources.front().uriHost.empty())
-    {
-        return vos_dottedIP(config_.sources.front().uriHost.c_str());
-    }
-
-    return session_ != nullptr ? session_->hostAddress() : 0U;
-}
-
 } // namespace trdp::runtime
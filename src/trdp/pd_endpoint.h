@@ -1,6 +1,8 @@
 #pragma once
 
 #include "model/sim_config.h"
+#include "trdp/payload_generator.h"
+#include "trdp/pd_endpoint_control.h"
 #include "trdp/trdp_session.h"
 #include "util/logging.h"
 
@@ -15,74 +17,125 @@
 #include <optional>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace trdp::runtime
 {
-enum class PdDirection
+class PdEndpointRuntime;
+
+/**
+ * Every address a telegram is published to: each distinct `<destination>` URI host, a multicast
+ * group counting as one destination. Falls back to the first source, then to `fallback`.
+ */
+std::vector<TRDP_IP_ADDR_T> resolvePublishDestinations(const model::TelegramConfig &config, TRDP_IP_ADDR_T fallback);
+
+struct PdPublishStart
 {
-    Unknown,
-    Outgoing,
-    Incoming,
-    Loopback,
+    std::shared_ptr<PdEndpointRuntime> endpoint;
+    std::chrono::microseconds cycleTime{1000000};
 };
 
-class PdEndpointRuntime
+class PdEndpointRuntime final : public PdEndpointControl
 {
 public:
     using SubscriptionSink = std::function<void(const PdMessage &)>;
 
     PdEndpointRuntime(model::TelegramConfig config, std::shared_ptr<TrdpSession> session, std::string hostIp);
-    ~PdEndpointRuntime();
+    ~PdEndpointRuntime() override;
 
     PdEndpointRuntime(const PdEndpointRuntime &) = delete;
     PdEndpointRuntime &operator=(const PdEndpointRuntime &) = delete;
 
-    void startPublishing(std::chrono::milliseconds cycleTime);
-    void stopPublishing();
-
-    [[nodiscard]] bool isPublishing() const;
-    [[nodiscard]] std::uint64_t publishCount() const;
-    [[nodiscard]] std::optional<std::chrono::system_clock::time_point> lastPublishTime() const;
-    [[nodiscard]] std::optional<std::chrono::system_clock::time_point> lastReceiveTime() const;
-    [[nodiscard]] std::uint64_t receiveCount() const;
+    bool startPublishing(std::chrono::microseconds cycleTime) override;
+    /** False if the session did not release every publisher handle within 500 ms; they are forgotten anyway. */
+    bool stopPublishing() override;
+
+    /** Forget the publisher handle after the owning session released it (see TrdpSession::requestTeardown). */
+    void detachPublisher() override;
+
+    /**
+     * Start several publishers of the same session with one tlp_publish pass and a single
+     * tlc_updateSession. Returns the number of publishers that were started.
+     */
+    static std::size_t startPublishingBatch(TrdpSession &session, const std::vector<PdPublishStart> &starts);
+
+    /** Cycle time from the telegram's `<pd-parameter>`, if the XML defines one. */
+    [[nodiscard]] std::optional<std::chrono::microseconds> configuredCycle() const override;
+
+    [[nodiscard]] bool isPublishing() const override;
+    /** Number of destinations the running publisher fans out to (0 while stopped). */
+    [[nodiscard]] std::size_t destinationCount() const override;
+    /** First multicast group among the destinations, to subscribe on; 0 for unicast telegrams. */
+    [[nodiscard]] TRDP_IP_ADDR_T multicastGroup() const;
+    /** Telegrams sent since the last start, as the session last read them (every 100 ms on the stack). */
+    [[nodiscard]] std::uint64_t publishCount() const override;
+    /** When that count last grew; empty until the first telegram went out. */
+    [[nodiscard]] std::optional<std::chrono::system_clock::time_point> lastPublishTime() const override;
+    [[nodiscard]] std::optional<std::chrono::system_clock::time_point> lastReceiveTime() const override;
+    [[nodiscard]] std::uint64_t receiveCount() const override;
 
     void handleSubscription(const PdMessage &message);
     void setSubscriptionSink(SubscriptionSink sink);
 
-    void setFixedPayload(std::vector<std::uint8_t> payload);
-    void clearFixedPayload();
-    [[nodiscard]] bool hasFixedPayload() const;
-    [[nodiscard]] std::optional<std::size_t> fixedPayloadSize() const;
+    /** Track the receive-timeout state the session's supervisor reports for this comId. */
+    void handleLinkEvent(const PdTimeoutEvent &event);
+    [[nodiscard]] bool isLinkLost() const override;
+    [[nodiscard]] std::uint64_t linkLostCount() const override;
 
-    void setTxPayload(std::vector<std::uint8_t> payload);
-    [[nodiscard]] std::vector<std::uint8_t> txPayload() const;
-    [[nodiscard]] std::vector<std::uint8_t> rxPayload() const;
+    /** Payload changes reach a running publisher with its next cycle (see refreshPublishedPayload()). */
+    bool setFixedPayload(std::vector<std::uint8_t> payload) override;
+    bool clearFixedPayload() override;
+    [[nodiscard]] bool hasFixedPayload() const override;
+    [[nodiscard]] std::optional<std::size_t> fixedPayloadSize() const override;
 
-    [[nodiscard]] PdDirection direction() const;
-    [[nodiscard]] bool canTransmit() const;
-    [[nodiscard]] bool canReceive() const;
+    /**
+     * Generate the published payload with `program` (see PayloadProgram): the session evaluates it
+     * and puts the result once per cycle while publishing. A fixed payload still takes precedence.
+     * Takes effect on the next startPublishing(); nullptr goes back to the TX payload.
+     */
+    void setPayloadProgram(std::shared_ptr<PayloadProgram> program);
+    [[nodiscard]] bool hasPayloadProgram() const;
 
-private:
+    bool setTxPayload(std::vector<std::uint8_t> payload) override;
+    [[nodiscard]] std::vector<std::uint8_t> txPayload() const override;
+    [[nodiscard]] std::vector<std::uint8_t> rxPayload() const override;
+
+    [[nodiscard]] PdDirection direction() const override;
+
+    /** How a telegram is used by the device at `hostIp`, from its sources, destinations and exchange type. */
     static PdDirection classifyDirection(const std::string &hostIp, const model::TelegramConfig &config);
 
-    TRDP_IP_ADDR_T resolveDestinationIp() const;
+private:
+
+    bool sessionReady() const;
+    std::vector<PdPublication> preparePublications(std::chrono::microseconds cycleTime);
+    bool attachPublishers(const std::vector<TRDP_PUB_T> &pubHandles, std::chrono::microseconds cycleTime);
     std::vector<std::uint8_t> buildPayload(std::uint64_t count);
+    /** Puts the current payload to the running publishers, unless a payload program generates it. */
+    void refreshPublishedPayload();
 
     model::TelegramConfig config_;
     std::shared_ptr<TrdpSession> session_;
     std::string hostIp_;
     PdDirection direction_{PdDirection::Unknown};
-    TRDP_PUB_T pubHandle_{nullptr};
-    TRDP_IP_ADDR_T destIp_{0U};
-    std::vector<std::uint8_t> publishBuffer_{};
+    /** Guards the publisher state below against starts, stops and payload updates from other threads. */
+    mutable std::mutex publisherMutex_;
+    std::vector<TRDP_PUB_T> pubHandles_{};
+    std::shared_ptr<const std::vector<std::uint8_t>> publishBuffer_{};
+    std::atomic<std::size_t> destinationCount_{0};
     std::vector<std::uint8_t> txPayload_{};
     std::vector<std::uint8_t> rxPayload_{};
     std::atomic<bool> running_{false};
-    std::atomic<std::uint64_t> publishCount_{0};
+    /** Handed to every publication of this telegram; the session counts their sends into it. */
+    const std::shared_ptr<PdSendCounter> sends_{std::make_shared<PdSendCounter>()};
     std::atomic<std::uint64_t> receiveCount_{0};
-    std::optional<std::chrono::system_clock::time_point> lastPublish_;
+    std::atomic<bool> linkLost_{false};
+    std::atomic<std::uint64_t> linkLostCount_{0};
     std::optional<std::chrono::system_clock::time_point> lastReceive_;
     std::optional<std::vector<std::uint8_t>> fixedPayload_{};
+    std::shared_ptr<PayloadProgram> payloadProgram_{};
+    /** Id of the program running on the session while publishing; 0 otherwise. */
+    std::uint64_t runningProgram_{0};
     mutable std::mutex mutex_;
     SubscriptionSink subscriptionSink_{};
 };
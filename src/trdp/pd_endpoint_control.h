@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace trdp::runtime
+{
+enum class PdDirection
+{
+    Unknown,
+    Outgoing,
+    Incoming,
+    Loopback,
+};
+
+/**
+ * What the UI needs from one PD telegram: its live state and the publisher controls. Implemented
+ * by PdEndpointRuntime in this process and by shard::ShardEndpointProxy for a telegram owned by a
+ * worker process.
+ *
+ * The commands return false when they did not take effect, e.g. because the session is not open or
+ * a worker's command queue stayed full; callers that answer a request report that as an error.
+ */
+class PdEndpointControl
+{
+public:
+    virtual ~PdEndpointControl() = default;
+
+    virtual bool startPublishing(std::chrono::microseconds cycleTime) = 0;
+    virtual bool stopPublishing() = 0;
+    /** Forget the publisher handles after the owning session released them. */
+    virtual void detachPublisher() = 0;
+
+    [[nodiscard]] virtual std::optional<std::chrono::microseconds> configuredCycle() const = 0;
+    [[nodiscard]] virtual bool isPublishing() const = 0;
+    [[nodiscard]] virtual std::size_t destinationCount() const = 0;
+    [[nodiscard]] virtual std::uint64_t publishCount() const = 0;
+    [[nodiscard]] virtual std::optional<std::chrono::system_clock::time_point> lastPublishTime() const = 0;
+    [[nodiscard]] virtual std::optional<std::chrono::system_clock::time_point> lastReceiveTime() const = 0;
+    [[nodiscard]] virtual std::uint64_t receiveCount() const = 0;
+    [[nodiscard]] virtual bool isLinkLost() const = 0;
+    [[nodiscard]] virtual std::uint64_t linkLostCount() const = 0;
+
+    virtual bool setFixedPayload(std::vector<std::uint8_t> payload) = 0;
+    virtual bool clearFixedPayload() = 0;
+    [[nodiscard]] virtual bool hasFixedPayload() const = 0;
+    [[nodiscard]] virtual std::optional<std::size_t> fixedPayloadSize() const = 0;
+
+    virtual bool setTxPayload(std::vector<std::uint8_t> payload) = 0;
+    [[nodiscard]] virtual std::vector<std::uint8_t> txPayload() const = 0;
+    [[nodiscard]] virtual std::vector<std::uint8_t> rxPayload() const = 0;
+
+    [[nodiscard]] virtual PdDirection direction() const = 0;
+
+    [[nodiscard]] bool canTransmit() const
+    {
+        const auto dir = direction();
+        return dir == PdDirection::Outgoing || dir == PdDirection::Loopback;
+    }
+
+    [[nodiscard]] bool canReceive() const
+    {
+        const auto dir = direction();
+        return dir == PdDirection::Incoming || dir == PdDirection::Loopback;
+    }
+};
+} // namespace trdp::runtime
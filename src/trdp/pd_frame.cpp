@@ -0,0 +1,98 @@
+#include "trdp/pd_frame.h"
+
+#include "util/crc32.h"
+
+namespace trdp::runtime
+{
+namespace
+{
+constexpr std::size_t kFcsOffset = kPdHeaderSize - 4U;
+
+void putBe16(std::uint8_t *out, std::uint16_t value)
+{
+    out[0] = static_cast<std::uint8_t>(value >> 8U);
+    out[1] = static_cast<std::uint8_t>(value);
+}
+
+void putBe32(std::uint8_t *out, std::uint32_t value)
+{
+    out[0] = static_cast<std::uint8_t>(value >> 24U);
+    out[1] = static_cast<std::uint8_t>(value >> 16U);
+    out[2] = static_cast<std::uint8_t>(value >> 8U);
+    out[3] = static_cast<std::uint8_t>(value);
+}
+
+std::uint16_t getBe16(const std::uint8_t *in)
+{
+    return static_cast<std::uint16_t>((in[0] << 8U) | in[1]);
+}
+
+std::uint32_t getBe32(const std::uint8_t *in)
+{
+    return (static_cast<std::uint32_t>(in[0]) << 24U) | (static_cast<std::uint32_t>(in[1]) << 16U) |
+           (static_cast<std::uint32_t>(in[2]) << 8U) | in[3];
+}
+
+// The stack stores the FCS little-endian, unlike every other header field.
+void putLe32(std::uint8_t *out, std::uint32_t value)
+{
+    out[0] = static_cast<std::uint8_t>(value);
+    out[1] = static_cast<std::uint8_t>(value >> 8U);
+    out[2] = static_cast<std::uint8_t>(value >> 16U);
+    out[3] = static_cast<std::uint8_t>(value >> 24U);
+}
+
+std::uint32_t getLe32(const std::uint8_t *in)
+{
+    return in[0] | (static_cast<std::uint32_t>(in[1]) << 8U) | (static_cast<std::uint32_t>(in[2]) << 16U) |
+           (static_cast<std::uint32_t>(in[3]) << 24U);
+}
+} // namespace
+
+void encodePdHeader(const PdFrameHeader &header, std::uint8_t *out)
+{
+    putBe32(out, header.sequenceCounter);
+    putBe16(out + 4, header.protocolVersion);
+    putBe16(out + 6, header.msgType);
+    putBe32(out + 8, header.comId);
+    putBe32(out + 12, header.etbTopoCnt);
+    putBe32(out + 16, header.opTrnTopoCnt);
+    putBe32(out + 20, header.datasetLength);
+    putBe32(out + 24, header.reserved);
+    putBe32(out + 28, header.replyComId);
+    putBe32(out + 32, header.replyIpAddress);
+    putLe32(out + kFcsOffset, util::crc32(out, kFcsOffset));
+}
+
+void updatePdSequence(std::uint8_t *frame, std::uint32_t sequenceCounter)
+{
+    putBe32(frame, sequenceCounter);
+    putLe32(frame + kFcsOffset, util::crc32(frame, kFcsOffset));
+}
+
+std::optional<PdFrameHeader> decodePdHeader(const std::uint8_t *frame, std::size_t size, bool *validFcs)
+{
+    if (frame == nullptr || size < kPdHeaderSize)
+    {
+        return std::nullopt;
+    }
+
+    PdFrameHeader header{};
+    header.sequenceCounter = getBe32(frame);
+    header.protocolVersion = getBe16(frame + 4);
+    header.msgType = getBe16(frame + 6);
+    header.comId = getBe32(frame + 8);
+    header.etbTopoCnt = getBe32(frame + 12);
+    header.opTrnTopoCnt = getBe32(frame + 16);
+    header.datasetLength = getBe32(frame + 20);
+    header.reserved = getBe32(frame + 24);
+    header.replyComId = getBe32(frame + 28);
+    header.replyIpAddress = getBe32(frame + 32);
+    header.frameCheckSum = getLe32(frame + kFcsOffset);
+    if (validFcs != nullptr)
+    {
+        *validFcs = header.frameCheckSum == util::crc32(frame, kFcsOffset);
+    }
+    return header;
+}
+} // namespace trdp::runtime
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace trdp::runtime
+{
+constexpr std::size_t kPdHeaderSize = 40U;
+constexpr std::uint16_t kPdProtocolVersion = 0x0100U;
+constexpr std::uint16_t kPdMsgTypeData = 0x5064U; // "Pd"
+constexpr std::uint16_t kPdDefaultPort = 17224U;
+
+/** TRDP PD header as it appears on the wire (IEC 61375-2-3), in host byte order. */
+struct PdFrameHeader
+{
+    std::uint32_t sequenceCounter{0};
+    std::uint16_t protocolVersion{kPdProtocolVersion};
+    std::uint16_t msgType{kPdMsgTypeData};
+    std::uint32_t comId{0};
+    std::uint32_t etbTopoCnt{0};
+    std::uint32_t opTrnTopoCnt{0};
+    std::uint32_t datasetLength{0};
+    std::uint32_t reserved{0};
+    std::uint32_t replyComId{0};
+    std::uint32_t replyIpAddress{0};
+    std::uint32_t frameCheckSum{0};
+};
+
+/** Writes `header` (fields big-endian) to `out` and seals it with the header FCS. */
+void encodePdHeader(const PdFrameHeader &header, std::uint8_t *out);
+
+/** Rewrites the sequence counter of an encoded header and refreshes its FCS. */
+void updatePdSequence(std::uint8_t *frame, std::uint32_t sequenceCounter);
+
+/** Parses a header; std::nullopt if `size` is too short. `validFcs` reports the checksum result. */
+std::optional<PdFrameHeader> decodePdHeader(const std::uint8_t *frame, std::size_t size, bool *validFcs = nullptr);
+} // namespace trdp::runtime
@@ -0,0 +1,190 @@
+#include "trdp/pd_timeout_supervisor.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace trdp::runtime
+{
+PdTimeoutSupervisor::PdTimeoutSupervisor(std::chrono::microseconds resolution, Clock::time_point epoch)
+    : resolution_(std::max(resolution, std::chrono::microseconds(1))), epoch_(epoch)
+{
+}
+
+void PdTimeoutSupervisor::setListener(Listener listener)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    listener_ = std::move(listener);
+}
+
+void PdTimeoutSupervisor::watch(std::uint32_t comId, std::chrono::microseconds timeout, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &watch = watches_[comId];
+    if (watch.timer == util::TimerWheel::kInvalidTimer)
+    {
+        watch.timer = wheel_.create(comId);
+    }
+    watch.timeoutTicks = std::max<std::uint64_t>(
+        1U, static_cast<std::uint64_t>((timeout.count() + resolution_.count() - 1) / resolution_.count()));
+    watch.lost = false;
+
+    // The first telegram is expected within one timeout of the subscription.
+    wheel_.arm(watch.timer, toTick(now) + watch.timeoutTicks);
+    stats_.watched = watches_.size();
+}
+
+void PdTimeoutSupervisor::unwatch(std::uint32_t comId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = watches_.find(comId);
+    if (it == watches_.end())
+    {
+        return;
+    }
+    if (it->second.lost)
+    {
+        --stats_.lost;
+    }
+    wheel_.destroy(it->second.timer);
+    watches_.erase(it);
+    stats_.watched = watches_.size();
+}
+
+void PdTimeoutSupervisor::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &entry : watches_)
+    {
+        wheel_.destroy(entry.second.timer);
+    }
+    watches_.clear();
+    stats_.watched = 0U;
+    stats_.lost = 0U;
+}
+
+void PdTimeoutSupervisor::onReceive(std::uint32_t comId, Clock::time_point now)
+{
+    std::optional<PdTimeoutEvent> event;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = watches_.find(comId);
+        if (it == watches_.end())
+        {
+            return;
+        }
+
+        auto &watch = it->second;
+        wheel_.arm(watch.timer, toTick(now) + watch.timeoutTicks);
+        if (watch.lost)
+        {
+            watch.lost = false;
+            --stats_.lost;
+            ++stats_.recoveredEvents;
+            event = PdTimeoutEvent{comId, PdLinkEvent::Recovered, now};
+        }
+    }
+
+    if (event)
+    {
+        notify(*event);
+    }
+}
+
+void PdTimeoutSupervisor::onStackTimeout(std::uint32_t comId, Clock::time_point now)
+{
+    bool changed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = watches_.find(comId);
+        if (it != watches_.end())
+        {
+            wheel_.cancel(it->second.timer);
+            changed = markLost(it->second);
+        }
+    }
+
+    if (changed)
+    {
+        notify(PdTimeoutEvent{comId, PdLinkEvent::Lost, now});
+    }
+}
+
+void PdTimeoutSupervisor::advance(Clock::time_point now)
+{
+    std::vector<PdTimeoutEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wheel_.advance(toTick(now), [&](util::TimerWheel::TimerId, std::uint64_t userData) {
+            const auto comId = static_cast<std::uint32_t>(userData);
+            const auto it = watches_.find(comId);
+            if (it != watches_.end() && markLost(it->second))
+            {
+                events.push_back(PdTimeoutEvent{comId, PdLinkEvent::Lost, now});
+            }
+        });
+    }
+
+    for (const auto &event : events)
+    {
+        notify(event);
+    }
+}
+
+std::optional<PdTimeoutSupervisor::Clock::time_point> PdTimeoutSupervisor::nextDeadline() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto tick = wheel_.nextEventTick();
+    if (!tick)
+    {
+        return std::nullopt;
+    }
+    return epoch_ + resolution_ * static_cast<std::int64_t>(*tick);
+}
+
+PdSupervisionStats PdTimeoutSupervisor::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool PdTimeoutSupervisor::isLost(std::uint32_t comId) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = watches_.find(comId);
+    return it != watches_.end() && it->second.lost;
+}
+
+std::uint64_t PdTimeoutSupervisor::toTick(Clock::time_point time) const
+{
+    if (time <= epoch_)
+    {
+        return 0U;
+    }
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(time - epoch_) / resolution_);
+}
+
+bool PdTimeoutSupervisor::markLost(Watch &watch)
+{
+    if (watch.lost)
+    {
+        return false;
+    }
+    watch.lost = true;
+    ++stats_.lost;
+    ++stats_.lostEvents;
+    return true;
+}
+
+void PdTimeoutSupervisor::notify(const PdTimeoutEvent &event)
+{
+    Listener listener;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        listener = listener_;
+    }
+    if (listener)
+    {
+        listener(event);
+    }
+}
+} // namespace trdp::runtime
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "util/timer_wheel.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace trdp::runtime
+{
+enum class PdLinkEvent
+{
+    Lost,
+    Recovered,
+};
+
+struct PdTimeoutEvent
+{
+    std::uint32_t comId{0};
+    PdLinkEvent event{PdLinkEvent::Lost};
+    std::chrono::steady_clock::time_point at{};
+};
+
+struct PdSupervisionStats
+{
+    std::size_t watched{0};
+    std::size_t lost{0};
+    std::uint64_t lostEvents{0};
+    std::uint64_t recoveredEvents{0};
+};
+
+/**
+ * Receive-timeout supervision for PD subscriptions, one deadline per comId in a timer wheel.
+ *
+ * onReceive() re-arms the comId's deadline in O(1); advance() only touches deadlines that actually
+ * expired. A comId is reported lost once when its deadline passes (or the stack reports a timeout)
+ * and recovered on the next telegram. The session's process thread drives watch/onReceive/advance
+ * and receives the listener calls; stats() and isLost() may be called from any thread.
+ */
+class PdTimeoutSupervisor
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Listener = std::function<void(const PdTimeoutEvent &)>;
+
+    explicit PdTimeoutSupervisor(std::chrono::microseconds resolution = std::chrono::milliseconds(1),
+                                 Clock::time_point epoch = Clock::now());
+
+    void setListener(Listener listener);
+
+    void watch(std::uint32_t comId, std::chrono::microseconds timeout, Clock::time_point now);
+    void unwatch(std::uint32_t comId);
+    void clear();
+
+    void onReceive(std::uint32_t comId, Clock::time_point now);
+    void onStackTimeout(std::uint32_t comId, Clock::time_point now);
+    void advance(Clock::time_point now);
+
+    /** When advance() next has work to do; std::nullopt while no deadline is armed. */
+    [[nodiscard]] std::optional<Clock::time_point> nextDeadline() const;
+    [[nodiscard]] PdSupervisionStats stats() const;
+    [[nodiscard]] bool isLost(std::uint32_t comId) const;
+
+private:
+    struct Watch
+    {
+        util::TimerWheel::TimerId timer{util::TimerWheel::kInvalidTimer};
+        std::uint64_t timeoutTicks{1};
+        bool lost{false};
+    };
+
+    std::uint64_t toTick(Clock::time_point time) const;
+    bool markLost(Watch &watch);
+    void notify(const PdTimeoutEvent &event);
+
+    std::chrono::microseconds resolution_;
+    Clock::time_point epoch_;
+    mutable std::mutex mutex_;
+    util::TimerWheel wheel_;
+    std::unordered_map<std::uint32_t, Watch> watches_;
+    PdSupervisionStats stats_{};
+    Listener listener_;
+};
+} // namespace trdp::runtime
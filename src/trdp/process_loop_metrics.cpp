@@ -0,0 +1,75 @@
+#include "trdp/process_loop_metrics.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace trdp::runtime
+{
+namespace
+{
+std::uint64_t toMicros(std::chrono::nanoseconds duration)
+{
+    return static_cast<std::uint64_t>(std::max<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0));
+}
+
+void appendPercentiles(std::ostringstream &oss, const util::LogHistogram &histogram)
+{
+    oss << "p50 " << histogram.percentile(0.5) << " / p99 " << histogram.percentile(0.99) << " / max "
+        << histogram.max() << " us";
+}
+} // namespace
+
+double ProcessLoopSnapshot::idleWakeShare() const
+{
+    return wakes == 0U ? 0.0 : static_cast<double>(timeoutWakes + spuriousWakes) / static_cast<double>(wakes);
+}
+
+std::string ProcessLoopSnapshot::summary() const
+{
+    std::ostringstream oss;
+    oss << wakes << " wakes (" << timeoutWakes << " timeout, " << socketWakes << " socket, " << commandWakes
+        << " command, " << spuriousWakes << " spurious); wakeup lag ";
+    appendPercentiles(oss, wakeupLagUs);
+    oss << "; tlc_process ";
+    appendPercentiles(oss, processUs);
+    oss << "; ready/wake " << std::fixed << std::setprecision(1) << readyDescriptors.mean() << " (max "
+        << readyDescriptors.max() << ')';
+    return oss.str();
+}
+
+void ProcessLoopMetrics::recordIteration(LoopWake wake,
+                                         std::chrono::nanoseconds wakeupLag,
+                                         int readyDescriptors,
+                                         std::chrono::nanoseconds processDuration)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++data_.wakes;
+    switch (wake)
+    {
+    case LoopWake::Timeout:
+        ++data_.timeoutWakes;
+        // Early returns say nothing about scheduling latency; only expired timeouts are measured.
+        data_.wakeupLagUs.record(toMicros(wakeupLag));
+        break;
+    case LoopWake::Socket:
+        ++data_.socketWakes;
+        data_.readyDescriptors.record(static_cast<std::uint64_t>(std::max(readyDescriptors, 0)));
+        break;
+    case LoopWake::Command:
+        ++data_.commandWakes;
+        break;
+    case LoopWake::Spurious:
+        ++data_.spuriousWakes;
+        break;
+    }
+    data_.processUs.record(toMicros(processDuration));
+}
+
+ProcessLoopSnapshot ProcessLoopMetrics::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return data_;
+}
+} // namespace trdp::runtime
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "util/log_histogram.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace trdp::runtime
+{
+/** Why vos_select() returned. */
+enum class LoopWake
+{
+    /** The interval from tlc_getInterval (or the supervision deadline) ran out. */
+    Timeout,
+    /** At least one TRDP socket was readable. */
+    Socket,
+    /** Only the command wake descriptor was readable. */
+    Command,
+    /** select() failed or was interrupted, or reported descriptors without any being set. */
+    Spurious,
+};
+
+struct ProcessLoopSnapshot
+{
+    std::uint64_t wakes{0};
+    std::uint64_t timeoutWakes{0};
+    std::uint64_t socketWakes{0};
+    std::uint64_t commandWakes{0};
+    std::uint64_t spuriousWakes{0};
+    /** How far past the requested deadline timeout wakes returned, in microseconds. */
+    util::LogHistogram wakeupLagUs;
+    /** tlc_process() duration per iteration, in microseconds. */
+    util::LogHistogram processUs;
+    /** TRDP descriptors ready per socket wake. */
+    util::LogHistogram readyDescriptors;
+
+    /** Share of wakes that were timeouts or spurious, 0..1. */
+    [[nodiscard]] double idleWakeShare() const;
+    /** One line for logs: wake mix, lag and tlc_process percentiles, descriptors per wake. */
+    [[nodiscard]] std::string summary() const;
+};
+
+/**
+ * Health of one session's process loop. The process thread records one entry per iteration;
+ * any thread may take a snapshot.
+ */
+class ProcessLoopMetrics
+{
+public:
+    void recordIteration(LoopWake wake,
+                         std::chrono::nanoseconds wakeupLag,
+                         int readyDescriptors,
+                         std::chrono::nanoseconds processDuration);
+    [[nodiscard]] ProcessLoopSnapshot snapshot() const;
+
+private:
+    mutable std::mutex mutex_;
+    ProcessLoopSnapshot data_;
+};
+} // namespace trdp::runtime
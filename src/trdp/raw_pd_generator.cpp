@@ -0,0 +1,371 @@
+#include "trdp/raw_pd_generator.h"
+
+#include "config/dataset_layout.h"
+#include "trdp/pd_endpoint.h"
+#include "util/logging.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#if __has_include(<linux/net_tstamp.h>)
+#include <linux/net_tstamp.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+namespace trdp::runtime
+{
+namespace
+{
+constexpr std::chrono::microseconds kTick{10};
+constexpr std::chrono::microseconds kTxTimeLead{500};
+constexpr std::chrono::milliseconds kIdleSleep{100};
+constexpr std::size_t kFrameAlignment = 64U;
+constexpr int kSendBufferBytes = 4 * 1024 * 1024;
+constexpr std::size_t kDefaultPayloadSize = 8U;
+
+std::size_t roundUp(std::size_t value, std::size_t granularity)
+{
+    return (value + granularity - 1U) / granularity * granularity;
+}
+} // namespace
+
+struct RawPdGenerator::BatchBuffers
+{
+    std::vector<mmsghdr> messages;
+    std::vector<iovec> iovecs;
+    std::vector<std::array<char, CMSG_SPACE(sizeof(std::uint64_t))>> controls;
+    std::vector<sockaddr_in> targets; // per stream
+    std::size_t count{0};
+};
+
+std::vector<RawPdStream> planRawPdStreams(const model::SimulatorConfig &config,
+                                          const std::vector<model::TelegramConfig> &telegrams,
+                                          std::uint32_t fallbackDestination,
+                                          std::uint32_t speedup)
+{
+    std::vector<RawPdStream> streams;
+    for (const auto &telegram : telegrams)
+    {
+        const auto cycleUs = telegram.pd && telegram.pd->cycleUs != 0U ? telegram.pd->cycleUs : 1000000U;
+        const auto payloadSize = std::min<std::size_t>(
+            config::datasetWireSize(config, telegram.datasetId).value_or(kDefaultPayloadSize), config::kMaxPdDataSize);
+
+        for (const auto destIp : resolvePublishDestinations(telegram, fallbackDestination))
+        {
+            RawPdStream stream{};
+            stream.comId = telegram.comId;
+            stream.destIp = destIp;
+            stream.cycle = std::chrono::microseconds(std::max<std::uint32_t>(cycleUs / std::max(speedup, 1U), 1U));
+            stream.payload.assign(payloadSize, 0U);
+            streams.push_back(std::move(stream));
+        }
+    }
+    return streams;
+}
+
+RawPdGenerator::RawPdGenerator(RawPdGeneratorSettings settings, std::vector<RawPdStream> streams)
+    : settings_(std::move(settings)), streams_(std::move(streams))
+{
+    settings_.batchSize = std::max(settings_.batchSize, 1U);
+}
+
+RawPdGenerator::~RawPdGenerator()
+{
+    stop();
+}
+
+bool RawPdGenerator::start()
+{
+    if (running_.load())
+    {
+        return true;
+    }
+    if (streams_.empty())
+    {
+        util::logWarn("Raw PD generator has no telegrams to send");
+        return false;
+    }
+    if (!openSocket())
+    {
+        return false;
+    }
+
+    buildArena();
+
+    // Spread each stream's first send over its cycle so equal cycles do not all fire on one tick.
+    wheel_ = util::TimerWheel{};
+    epoch_ = Clock::now();
+    double framesPerSecond = 0.0;
+    for (std::size_t i = 0; i < states_.size(); ++i)
+    {
+        auto &state = states_[i];
+        state.cycleTicks = std::max<std::uint64_t>(1U, static_cast<std::uint64_t>(streams_[i].cycle / kTick));
+        state.nextDueTick = state.cycleTicks * i / states_.size();
+        state.timer = wheel_.create(i);
+        wheel_.arm(state.timer, state.nextDueTick);
+        framesPerSecond += 1e6 / static_cast<double>(state.cycleTicks * kTick.count());
+    }
+
+    running_.store(true);
+    thread_ = std::thread([this] { run(); });
+
+    std::ostringstream oss;
+    oss << "Raw PD generator on " << settings_.sourceIp << ": " << streams_.size() << " streams, ~"
+        << static_cast<std::uint64_t>(framesPerSecond) << " frames/s in batches of " << settings_.batchSize
+        << (txTime_.load() ? " with SO_TXTIME pacing" : "");
+    util::logInfo(oss.str());
+    return true;
+}
+
+void RawPdGenerator::stop()
+{
+    if (!running_.exchange(false))
+    {
+        return;
+    }
+
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+    if (socket_ >= 0)
+    {
+        ::close(socket_);
+        socket_ = -1;
+    }
+
+    std::ostringstream oss;
+    oss << "Raw PD generator on " << settings_.sourceIp << " stopped after " << framesSent_.load() << " frames ("
+        << sendErrors_.load() << " send errors, " << skippedCycles_.load() << " skipped cycles)";
+    util::logInfo(oss.str());
+}
+
+bool RawPdGenerator::isRunning() const
+{
+    return running_.load();
+}
+
+RawPdGeneratorStats RawPdGenerator::stats() const
+{
+    RawPdGeneratorStats stats{};
+    stats.streams = streams_.size();
+    stats.framesSent = framesSent_.load();
+    stats.batches = batches_.load();
+    stats.sendErrors = sendErrors_.load();
+    stats.skippedCycles = skippedCycles_.load();
+    stats.txTimeActive = txTime_.load();
+    return stats;
+}
+
+RealtimeReport RawPdGenerator::realtimeReport() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return realtimeReport_;
+}
+
+bool RawPdGenerator::openSocket()
+{
+    socket_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (socket_ < 0)
+    {
+        util::logError(std::string("Raw PD generator: socket() failed: ") + std::strerror(errno));
+        return false;
+    }
+
+    const int tos = settings_.qos << 5;
+    const int ttl = settings_.ttl;
+    (void)::setsockopt(socket_, IPPROTO_IP, IP_TOS, &tos, sizeof(tos));
+    (void)::setsockopt(socket_, IPPROTO_IP, IP_TTL, &ttl, sizeof(ttl));
+    (void)::setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    (void)::setsockopt(socket_, SOL_SOCKET, SO_SNDBUF, &kSendBufferBytes, sizeof(kSendBufferBytes));
+
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = 0;
+    if (::inet_pton(AF_INET, settings_.sourceIp.c_str(), &local.sin_addr) != 1 ||
+        ::bind(socket_, reinterpret_cast<const sockaddr *>(&local), sizeof(local)) != 0)
+    {
+        util::logError("Raw PD generator: cannot bind to " + settings_.sourceIp + ": " + std::strerror(errno));
+        ::close(socket_);
+        socket_ = -1;
+        return false;
+    }
+    (void)::setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_IF, &local.sin_addr, sizeof(local.sin_addr));
+
+    txTime_.store(false);
+    if (settings_.txTime)
+    {
+#if defined(SO_TXTIME) && __has_include(<linux/net_tstamp.h>)
+        // The fq qdisc paces on CLOCK_MONOTONIC, which is what steady_clock uses on Linux.
+        const sock_txtime config{CLOCK_MONOTONIC, 0U};
+        if (::setsockopt(socket_, SOL_SOCKET, SO_TXTIME, &config, sizeof(config)) == 0)
+        {
+            txTime_.store(true);
+        }
+        else
+        {
+            util::logWarn(std::string("SO_TXTIME unavailable, sending unpaced: ") + std::strerror(errno));
+        }
+#else
+        util::logWarn("SO_TXTIME is not supported by this build; sending unpaced");
+#endif
+    }
+    return true;
+}
+
+void RawPdGenerator::buildArena()
+{
+    states_.assign(streams_.size(), StreamState{});
+    std::size_t offset = 0U;
+    for (std::size_t i = 0; i < streams_.size(); ++i)
+    {
+        states_[i].frameOffset = offset;
+        states_[i].frameSize = kPdHeaderSize + streams_[i].payload.size();
+        offset += roundUp(states_[i].frameSize, kFrameAlignment);
+    }
+
+    arena_.assign(offset, 0U);
+    batch_ = std::make_unique<BatchBuffers>();
+    batch_->messages.resize(settings_.batchSize);
+    batch_->iovecs.resize(settings_.batchSize);
+    batch_->controls.resize(txTime_.load() ? settings_.batchSize : 0U);
+    batch_->targets.resize(streams_.size());
+
+    for (std::size_t i = 0; i < streams_.size(); ++i)
+    {
+        PdFrameHeader header{};
+        header.comId = streams_[i].comId;
+        header.datasetLength = static_cast<std::uint32_t>(streams_[i].payload.size());
+        auto *frame = arena_.data() + states_[i].frameOffset;
+        encodePdHeader(header, frame);
+        std::copy(streams_[i].payload.begin(), streams_[i].payload.end(), frame + kPdHeaderSize);
+
+        auto &target = batch_->targets[i];
+        target.sin_family = AF_INET;
+        target.sin_port = htons(settings_.port);
+        target.sin_addr.s_addr = htonl(streams_[i].destIp);
+    }
+}
+
+void RawPdGenerator::run()
+{
+    {
+        auto report = applyRealtimeProfile(settings_.realtime);
+        std::lock_guard<std::mutex> lock(mutex_);
+        realtimeReport_ = std::move(report);
+    }
+
+    // With SO_TXTIME the frames are handed over ahead of time and released by the qdisc.
+    const auto lead = txTime_.load() ? std::chrono::duration_cast<Clock::duration>(kTxTimeLead) : Clock::duration{};
+    while (running_.load())
+    {
+        const auto nowTick = toTick(Clock::now() + lead);
+        wheel_.advance(nowTick, [this, nowTick](util::TimerWheel::TimerId, std::uint64_t index) {
+            queueFrame(static_cast<std::size_t>(index), nowTick);
+        });
+        flush();
+
+        const auto now = Clock::now();
+        const auto next = wheel_.nextEventTick();
+        const auto wake = next ? std::min(fromTick(*next) - lead, now + kIdleSleep) : now + kIdleSleep;
+        std::this_thread::sleep_until(wake);
+    }
+}
+
+void RawPdGenerator::queueFrame(std::size_t index, std::uint64_t nowTick)
+{
+    auto &state = states_[index];
+    auto *frame = arena_.data() + state.frameOffset;
+    updatePdSequence(frame, state.sequence++);
+
+    auto &batch = *batch_;
+    const auto slot = batch.count++;
+    batch.iovecs[slot].iov_base = frame;
+    batch.iovecs[slot].iov_len = state.frameSize;
+
+    auto &header = batch.messages[slot].msg_hdr;
+    header = msghdr{};
+    header.msg_name = &batch.targets[index];
+    header.msg_namelen = sizeof(sockaddr_in);
+    header.msg_iov = &batch.iovecs[slot];
+    header.msg_iovlen = 1;
+#if defined(SO_TXTIME) && defined(SCM_TXTIME)
+    if (!batch.controls.empty())
+    {
+        header.msg_control = batch.controls[slot].data();
+        header.msg_controllen = batch.controls[slot].size();
+        auto *control = CMSG_FIRSTHDR(&header);
+        control->cmsg_level = SOL_SOCKET;
+        control->cmsg_type = SCM_TXTIME;
+        control->cmsg_len = CMSG_LEN(sizeof(std::uint64_t));
+        const auto due = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(fromTick(state.nextDueTick).time_since_epoch()).count());
+        std::memcpy(CMSG_DATA(control), &due, sizeof(due));
+    }
+#endif
+
+    // Re-arm for the next cycle; cycles already missed are skipped rather than sent as a burst.
+    state.nextDueTick += state.cycleTicks;
+    if (state.nextDueTick <= nowTick)
+    {
+        const auto missed = (nowTick - state.nextDueTick) / state.cycleTicks + 1U;
+        state.nextDueTick += missed * state.cycleTicks;
+        skippedCycles_.fetch_add(missed);
+    }
+    wheel_.arm(state.timer, state.nextDueTick);
+
+    if (batch.count == batch.messages.size())
+    {
+        flush();
+    }
+}
+
+void RawPdGenerator::flush()
+{
+    auto &batch = *batch_;
+    if (batch.count == 0U)
+    {
+        return;
+    }
+
+    std::size_t done = 0U;
+    std::uint64_t sent = 0U;
+    while (done < batch.count)
+    {
+        const int result = ::sendmmsg(socket_, batch.messages.data() + done, static_cast<unsigned>(batch.count - done), 0);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // sendmmsg reports the error of the first unsent frame; drop that one and go on.
+            sendErrors_.fetch_add(1);
+            ++done;
+            continue;
+        }
+        done += static_cast<std::size_t>(result);
+        sent += static_cast<std::uint64_t>(result);
+    }
+
+    framesSent_.fetch_add(sent);
+    batches_.fetch_add(1);
+    batch.count = 0U;
+}
+
+std::uint64_t RawPdGenerator::toTick(Clock::time_point time) const
+{
+    return time <= epoch_ ? 0U : static_cast<std::uint64_t>((time - epoch_) / kTick);
+}
+
+RawPdGenerator::Clock::time_point RawPdGenerator::fromTick(std::uint64_t tick) const
+{
+    return epoch_ + std::chrono::duration_cast<Clock::duration>(kTick * static_cast<std::int64_t>(tick));
+}
+} // namespace trdp::runtime
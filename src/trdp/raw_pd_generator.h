@@ -0,0 +1,126 @@
+#pragma once
+
+#include "model/runtime_options.h"
+#include "model/sim_config.h"
+#include "trdp/pd_frame.h"
+#include "trdp/realtime_profile.h"
+#include "util/timer_wheel.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trdp::runtime
+{
+/** One telegram to one destination, as sent by the raw generator. */
+struct RawPdStream
+{
+    std::uint32_t comId{0};
+    std::uint32_t destIp{0};
+    std::chrono::microseconds cycle{1000000};
+    std::vector<std::uint8_t> payload;
+};
+
+struct RawPdGeneratorSettings
+{
+    std::string sourceIp;
+    std::uint16_t port{kPdDefaultPort};
+    std::uint32_t batchSize{64};
+    /** Stamp every frame with its due time (SO_TXTIME) so the qdisc paces the batch. */
+    bool txTime{false};
+    std::uint8_t qos{5};
+    std::uint8_t ttl{64};
+    model::RealtimeProfile realtime;
+};
+
+struct RawPdGeneratorStats
+{
+    std::size_t streams{0};
+    std::uint64_t framesSent{0};
+    std::uint64_t batches{0};
+    std::uint64_t sendErrors{0};
+    std::uint64_t skippedCycles{0};
+    bool txTimeActive{false};
+};
+
+/**
+ * Streams for every telegram in `telegrams` and each of its destinations, with the dataset's wire
+ * size as payload. Cycles come from `<pd-parameter>` (1 s otherwise) divided by `speedup`.
+ */
+std::vector<RawPdStream> planRawPdStreams(const model::SimulatorConfig &config,
+                                          const std::vector<model::TelegramConfig> &telegrams,
+                                          std::uint32_t fallbackDestination,
+                                          std::uint32_t speedup = 1U);
+
+/**
+ * PD load generator that bypasses the TRDP stack: frames (header, sequence counter, FCS) are built
+ * once into a preallocated arena and sent in sendmmsg batches from a dedicated thread, scheduled
+ * by a timer wheel. Only the sequence counter and FCS are rewritten per send. Cycles that could not
+ * be met are skipped and counted rather than sent in a burst.
+ */
+class RawPdGenerator
+{
+public:
+    RawPdGenerator(RawPdGeneratorSettings settings, std::vector<RawPdStream> streams);
+    ~RawPdGenerator();
+
+    RawPdGenerator(const RawPdGenerator &) = delete;
+    RawPdGenerator &operator=(const RawPdGenerator &) = delete;
+
+    bool start();
+    void stop();
+
+    [[nodiscard]] bool isRunning() const;
+    [[nodiscard]] RawPdGeneratorStats stats() const;
+    [[nodiscard]] RealtimeReport realtimeReport() const;
+    [[nodiscard]] const RawPdGeneratorSettings &settings() const { return settings_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct StreamState
+    {
+        std::size_t frameOffset{0};
+        std::size_t frameSize{0};
+        std::uint32_t sequence{0};
+        std::uint64_t cycleTicks{1};
+        std::uint64_t nextDueTick{0};
+        util::TimerWheel::TimerId timer{util::TimerWheel::kInvalidTimer};
+    };
+
+    bool openSocket();
+    void buildArena();
+    void run();
+    void queueFrame(std::size_t index, std::uint64_t nowTick);
+    void flush();
+    [[nodiscard]] std::uint64_t toTick(Clock::time_point time) const;
+    [[nodiscard]] Clock::time_point fromTick(std::uint64_t tick) const;
+
+    RawPdGeneratorSettings settings_;
+    std::vector<RawPdStream> streams_;
+    std::vector<StreamState> states_;
+    std::vector<std::uint8_t> arena_;
+    util::TimerWheel wheel_;
+    Clock::time_point epoch_{};
+    int socket_{-1};
+    std::atomic<bool> txTime_{false};
+
+    // Per-batch send descriptors, sized once to the batch size (opaque to avoid socket headers here).
+    struct BatchBuffers;
+    std::unique_ptr<BatchBuffers> batch_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<std::uint64_t> framesSent_{0};
+    std::atomic<std::uint64_t> batches_{0};
+    std::atomic<std::uint64_t> sendErrors_{0};
+    std::atomic<std::uint64_t> skippedCycles_{0};
+    mutable std::mutex mutex_;
+    RealtimeReport realtimeReport_;
+};
+} // namespace trdp::runtime
@@ -0,0 +1,259 @@
+#include "trdp/realtime_profile.h"
+
+#include "util/cpu_list.h"
+
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+namespace trdp::runtime
+{
+namespace
+{
+constexpr std::size_t kPageSize = 4096U;
+constexpr std::size_t kStackGuardBytes = 64U * 1024U;
+
+std::string describeError(int err)
+{
+    std::string detail = std::strerror(err);
+    if (err == EPERM)
+    {
+        detail += " (needs CAP_SYS_NICE/CAP_IPC_LOCK or matching rtprio/memlock limits)";
+    }
+    return detail;
+}
+
+std::string policyName(model::SchedulingPolicy policy)
+{
+    switch (policy)
+    {
+    case model::SchedulingPolicy::Fifo:
+        return "SCHED_FIFO";
+    case model::SchedulingPolicy::RoundRobin:
+        return "SCHED_RR";
+    case model::SchedulingPolicy::Other:
+        return "SCHED_OTHER";
+    case model::SchedulingPolicy::XmlPriority:
+        return "xml";
+    case model::SchedulingPolicy::Inherit:
+    default:
+        return "inherit";
+    }
+}
+
+RealtimeSettingStatus applyScheduling(const model::RealtimeProfile &profile)
+{
+    int policy = SCHED_OTHER;
+    if (profile.policy == model::SchedulingPolicy::Fifo)
+    {
+        policy = SCHED_FIFO;
+    }
+    else if (profile.policy == model::SchedulingPolicy::RoundRobin)
+    {
+        policy = SCHED_RR;
+    }
+
+    sched_param param{};
+    param.sched_priority =
+        policy == SCHED_OTHER ? 0 : std::clamp(profile.priority, sched_get_priority_min(policy), sched_get_priority_max(policy));
+
+    RealtimeSettingStatus status{};
+    status.setting = "scheduling";
+    status.requested = policyName(profile.policy) + (policy == SCHED_OTHER ? "" : " " + std::to_string(param.sched_priority));
+    const int err = pthread_setschedparam(pthread_self(), policy, &param);
+    status.applied = err == 0;
+    status.detail = err == 0 ? "active" : describeError(err);
+    return status;
+}
+
+RealtimeSettingStatus applyAffinity(const std::vector<int> &cpus)
+{
+    RealtimeSettingStatus status{};
+    status.setting = "affinity";
+    status.requested = "CPUs " + util::formatCpuList(cpus);
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const auto cpu : cpus)
+    {
+        if (cpu >= 0 && cpu < CPU_SETSIZE)
+        {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    const int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    status.applied = err == 0;
+    if (err != 0)
+    {
+        status.detail = describeError(err);
+        return status;
+    }
+
+    const auto isolated = kernelIsolatedCpus();
+    const bool allIsolated = std::all_of(cpus.begin(), cpus.end(), [&isolated](int cpu) {
+        return std::binary_search(isolated.begin(), isolated.end(), cpu);
+    });
+    status.detail = allIsolated ? "pinned, CPUs isolated by the kernel" : "pinned, CPUs shared with other tasks (not in isolcpus)";
+    return status;
+}
+
+RealtimeSettingStatus lockProcessMemory()
+{
+    static std::once_flag lockFlag;
+    static RealtimeSettingStatus lockStatus{};
+    std::call_once(lockFlag, [] {
+        lockStatus.setting = "memory lock";
+        lockStatus.requested = "mlockall(MCL_CURRENT | MCL_FUTURE)";
+
+        // Keep freed heap memory mapped so later allocations do not fault in fresh pages.
+        (void)mallopt(M_MMAP_MAX, 0);
+        (void)mallopt(M_TRIM_THRESHOLD, -1);
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+        {
+            lockStatus.applied = true;
+            lockStatus.detail = "all pages locked";
+        }
+        else
+        {
+            lockStatus.detail = describeError(errno);
+        }
+    });
+    return lockStatus;
+}
+
+__attribute__((noinline)) void touchStack(std::size_t bytes)
+{
+    auto *region = static_cast<volatile unsigned char *>(alloca(bytes));
+    for (std::size_t offset = 0; offset < bytes; offset += kPageSize)
+    {
+        region[offset] = 0U;
+    }
+}
+
+RealtimeSettingStatus prefaultStack(std::size_t bytes)
+{
+    RealtimeSettingStatus status{};
+    status.setting = "stack prefault";
+    status.requested = std::to_string(bytes / 1024U) + " KiB";
+
+    std::size_t available = bytes + kStackGuardBytes;
+    pthread_attr_t attr;
+    if (pthread_getattr_np(pthread_self(), &attr) == 0)
+    {
+        void *stackAddr = nullptr;
+        std::size_t stackSize = 0U;
+        if (pthread_attr_getstack(&attr, &stackAddr, &stackSize) == 0)
+        {
+            available = stackSize;
+        }
+        pthread_attr_destroy(&attr);
+    }
+
+    const auto usable = available > kStackGuardBytes ? available - kStackGuardBytes : 0U;
+    const auto touched = std::min(bytes, usable);
+    touchStack(touched);
+    status.applied = touched == bytes;
+    status.detail = status.applied ? "touched" : "clamped to " + std::to_string(touched / 1024U) + " KiB of thread stack";
+    return status;
+}
+} // namespace
+
+bool RealtimeReport::fullyApplied() const
+{
+    return std::all_of(settings.begin(), settings.end(), [](const RealtimeSettingStatus &status) { return status.applied; });
+}
+
+std::string RealtimeReport::summary() const
+{
+    if (settings.empty())
+    {
+        return "default scheduling";
+    }
+
+    std::ostringstream oss;
+    for (std::size_t i = 0; i < settings.size(); ++i)
+    {
+        const auto &status = settings[i];
+        oss << (i == 0 ? "" : "; ") << status.setting << ' ' << status.requested << ": "
+            << (status.applied ? "applied" : "NOT applied") << " (" << status.detail << ')';
+    }
+    return oss.str();
+}
+
+RealtimeReport applyRealtimeProfile(const model::RealtimeProfile &profile)
+{
+    RealtimeReport report{};
+    if (profile.lockMemory)
+    {
+        report.settings.push_back(lockProcessMemory());
+    }
+    // Only a session knows its XML process priority; it resolves XmlPriority before calling this.
+    if (profile.policy != model::SchedulingPolicy::Inherit && profile.policy != model::SchedulingPolicy::XmlPriority)
+    {
+        report.settings.push_back(applyScheduling(profile));
+    }
+    if (!profile.cpus.empty())
+    {
+        report.settings.push_back(applyAffinity(profile.cpus));
+    }
+    if (profile.prefaultStackBytes != 0U)
+    {
+        report.settings.push_back(prefaultStack(profile.prefaultStackBytes));
+    }
+    return report;
+}
+
+RealtimeSettingStatus isolateCallingThreadFrom(const std::vector<int> &reserved)
+{
+    RealtimeSettingStatus status{};
+    status.setting = "isolation";
+    status.requested = "UI off CPUs " + util::formatCpuList(reserved);
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+    {
+        status.detail = describeError(errno);
+        return status;
+    }
+    for (const auto cpu : reserved)
+    {
+        if (cpu >= 0 && cpu < CPU_SETSIZE)
+        {
+            CPU_CLR(cpu, &set);
+        }
+    }
+    if (CPU_COUNT(&set) == 0)
+    {
+        status.detail = "no CPUs left for the UI";
+        return status;
+    }
+
+    const int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    status.applied = err == 0;
+    status.detail = err == 0 ? std::to_string(CPU_COUNT(&set)) + " CPU(s) left for the UI" : describeError(err);
+    return status;
+}
+
+std::vector<int> kernelIsolatedCpus()
+{
+    std::ifstream file("/sys/devices/system/cpu/isolated");
+    std::string line;
+    if (!file || !std::getline(file, line))
+    {
+        return {};
+    }
+    return util::parseCpuList(line).value_or(std::vector<int>{});
+}
+} // namespace trdp::runtime
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "model/runtime_options.h"
+
+#include <string>
+#include <vector>
+
+namespace trdp::runtime
+{
+/** Outcome of one requested real-time setting. */
+struct RealtimeSettingStatus
+{
+    std::string setting;
+    std::string requested;
+    bool applied{false};
+    std::string detail;
+};
+
+struct RealtimeReport
+{
+    std::vector<RealtimeSettingStatus> settings;
+
+    [[nodiscard]] bool fullyApplied() const;
+    [[nodiscard]] std::string summary() const;
+};
+
+/**
+ * Applies a profile to the calling thread: scheduling policy/priority, CPU affinity and stack
+ * prefaulting. Memory locking is process-wide; it is performed once and its result reported to
+ * every caller that requests it. Only requested settings appear in the report.
+ */
+RealtimeReport applyRealtimeProfile(const model::RealtimeProfile &profile);
+
+/** Restricts the calling thread (and threads it creates later) to the online CPUs not in `reserved`. */
+RealtimeSettingStatus isolateCallingThreadFrom(const std::vector<int> &reserved);
+
+/** CPUs the kernel keeps out of general scheduling (isolcpus), from sysfs. */
+std::vector<int> kernelIsolatedCpus();
+} // namespace trdp::runtime
@@ -0,0 +1,175 @@
+#include "trdp/stack_memory.h"
+
+#include "config/dataset_layout.h"
+#include "trdp/pd_endpoint.h"
+#include "util/logging.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace trdp::runtime
+{
+namespace
+{
+constexpr std::array<std::uint32_t, VOS_MEM_NBLOCKSIZES> kBlockSizes = VOS_MEM_BLOCKSIZES;
+
+// Estimates of what the stack allocates from the pool; they only need to land in the right block size.
+constexpr std::uint64_t kBlockHeaderBytes = 16U;   // size/link prefix vos_memAlloc adds to every block
+constexpr std::uint64_t kPdElementBytes = 320U;    // PD_ELE_T bookkeeping per publisher or subscriber
+constexpr std::uint64_t kPdHeaderBytes = 40U;      // PD frame header preceding the dataset
+constexpr std::uint64_t kSessionOverheadBytes = 64U * 1024U;
+constexpr std::uint64_t kBaseReserveBytes = 256U * 1024U;
+constexpr std::uint64_t kHeadroomFactor = 2U;
+constexpr std::uint64_t kPoolGranularity = 64U * 1024U;
+
+std::size_t blockIndexFor(std::uint64_t bytes)
+{
+    for (std::size_t i = 0; i < kBlockSizes.size(); ++i)
+    {
+        if (kBlockSizes[i] >= bytes + kBlockHeaderBytes)
+        {
+            return i;
+        }
+    }
+    return kBlockSizes.size() - 1U;
+}
+
+std::uint64_t roundUp(std::uint64_t value, std::uint64_t granularity)
+{
+    return (value + granularity - 1U) / granularity * granularity;
+}
+
+std::uint64_t preallocatedBytes(const std::array<std::uint32_t, VOS_MEM_NBLOCKSIZES> &preallocate)
+{
+    std::uint64_t total = 0U;
+    for (std::size_t i = 0; i < preallocate.size(); ++i)
+    {
+        total += static_cast<std::uint64_t>(preallocate[i]) * kBlockSizes[i];
+    }
+    return total;
+}
+
+std::uint32_t clampPoolSize(std::uint64_t bytes)
+{
+    return static_cast<std::uint32_t>(std::min<std::uint64_t>(bytes, UINT32_MAX));
+}
+
+std::string formatKiB(std::uint64_t bytes)
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << static_cast<double>(bytes) / 1024.0 << " KiB";
+    return oss.str();
+}
+} // namespace
+
+TRDP_MEM_CONFIG_T StackMemoryPlan::toMemConfig() const
+{
+    TRDP_MEM_CONFIG_T memConfig{};
+    memConfig.p = nullptr;
+    memConfig.size = poolSize;
+    std::copy(preallocate.begin(), preallocate.end(), std::begin(memConfig.prealloc));
+    return memConfig;
+}
+
+std::string StackMemoryPlan::describe() const
+{
+    std::ostringstream oss;
+    oss << formatKiB(poolSize) << " pool, " << formatKiB(preallocatedBytes(preallocate)) << " preallocated ("
+        << (fromXml ? std::string("XML mem-config") : "computed for " + std::to_string(telegrams) + " telegrams") << ")";
+    return oss.str();
+}
+
+StackMemoryPlan planStackMemory(const model::SimulatorConfig &config)
+{
+    StackMemoryPlan plan{};
+    std::array<std::uint32_t, VOS_MEM_NBLOCKSIZES> computed{};
+    for (const auto &iface : config.interfaces)
+    {
+        for (const auto &telegram : iface.telegrams)
+        {
+            ++plan.telegrams;
+            const auto dataSize =
+                std::min(config::datasetWireSize(config, telegram.datasetId).value_or(config::kMaxPdDataSize),
+                         config::kMaxPdDataSize);
+
+            // Every telegram gets a subscription and may be published from the UI, with one publisher
+            // per destination. Receive frames are sized for the largest PD; send frames for the
+            // marshalled dataset, padded to 4 bytes.
+            const auto publishers = static_cast<std::uint32_t>(resolvePublishDestinations(telegram, 0U).size());
+            computed[blockIndexFor(kPdElementBytes)] += 1U + publishers;
+            computed[blockIndexFor(kPdHeaderBytes + config::kMaxPdDataSize)] += 1U;
+            computed[blockIndexFor(kPdHeaderBytes + roundUp(dataSize, 4U))] += publishers;
+        }
+    }
+
+    const auto computedPool = roundUp(preallocatedBytes(computed) * kHeadroomFactor +
+                                          config.interfaces.size() * kSessionOverheadBytes + kBaseReserveBytes,
+                                      kPoolGranularity);
+
+    const auto &memory = config.memory;
+    if (!memory.present())
+    {
+        plan.preallocate = computed;
+        plan.poolSize = clampPoolSize(computedPool);
+        return plan;
+    }
+
+    plan.fromXml = true;
+    const auto xmlPreallocates = std::any_of(memory.preallocate.begin(), memory.preallocate.end(),
+                                             [](std::uint32_t count) { return count != 0U; });
+    if (xmlPreallocates)
+    {
+        const auto count = std::min(memory.preallocate.size(), plan.preallocate.size());
+        std::copy_n(memory.preallocate.begin(), count, plan.preallocate.begin());
+    }
+    else
+    {
+        plan.preallocate = computed;
+    }
+
+    const auto required = preallocatedBytes(plan.preallocate);
+    if (memory.size != 0U)
+    {
+        plan.poolSize = memory.size;
+        if (required > memory.size)
+        {
+            util::logWarn("XML mem-config preallocates " + formatKiB(required) + " but the pool is only " +
+                          formatKiB(memory.size));
+        }
+    }
+    else
+    {
+        plan.poolSize = clampPoolSize(std::max(computedPool, roundUp(required + kBaseReserveBytes, kPoolGranularity)));
+    }
+    return plan;
+}
+
+StackMemoryMonitor::StackMemoryMonitor(StackMemoryPlan plan) : plan_(plan) {}
+
+std::optional<StackMemorySnapshot> StackMemoryMonitor::sample()
+{
+    VOS_MEM_STATISTICS_T stats{};
+    if (vos_getMemStatistics(&stats) != VOS_NO_ERR)
+    {
+        return std::nullopt;
+    }
+
+    StackMemorySnapshot snapshot{};
+    snapshot.total = stats.total;
+    snapshot.used = stats.total - std::min(stats.free, stats.total);
+    snapshot.highWater = stats.total - std::min(stats.minFree, stats.total);
+    snapshot.allocatedBlocks = stats.numAllocBlocks;
+    snapshot.allocErrors = stats.numAllocErr;
+    snapshot.freeErrors = stats.numFreeErr;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot.blocks.reserve(VOS_MEM_NBLOCKSIZES);
+    for (std::size_t i = 0; i < VOS_MEM_NBLOCKSIZES; ++i)
+    {
+        peaks_[i] = std::max(peaks_[i], stats.usedBlockSize[i]);
+        snapshot.blocks.push_back(StackMemoryBlockUsage{stats.blockSize[i], stats.usedBlockSize[i], peaks_[i], plan_.preallocate[i]});
+    }
+    return snapshot;
+}
+} // namespace trdp::runtime
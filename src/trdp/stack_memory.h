@@ -0,0 +1,71 @@
+#pragma once
+
+#include "model/sim_config.h"
+
+#include <trdp_types.h>
+#include <vos_mem.h>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace trdp::runtime
+{
+/** Pool size and per-block-size preallocation handed to tlc_init. */
+struct StackMemoryPlan
+{
+    std::uint32_t poolSize{0U};
+    std::array<std::uint32_t, VOS_MEM_NBLOCKSIZES> preallocate{};
+    bool fromXml{false};
+    std::size_t telegrams{0U};
+
+    [[nodiscard]] TRDP_MEM_CONFIG_T toMemConfig() const;
+    [[nodiscard]] std::string describe() const;
+};
+
+/**
+ * Sizes the stack pool for a configuration. An XML `<mem-config>` wins; otherwise one subscriber and
+ * one publisher per telegram are budgeted from their dataset sizes, plus per-session overhead.
+ */
+StackMemoryPlan planStackMemory(const model::SimulatorConfig &config);
+
+struct StackMemoryBlockUsage
+{
+    std::uint32_t blockSize{0U};
+    std::uint32_t used{0U};
+    std::uint32_t peak{0U};
+    std::uint32_t preallocated{0U};
+};
+
+struct StackMemorySnapshot
+{
+    std::uint32_t total{0U};
+    std::uint32_t used{0U};
+    std::uint32_t highWater{0U};
+    std::uint32_t allocatedBlocks{0U};
+    std::uint32_t allocErrors{0U};
+    std::uint32_t freeErrors{0U};
+    std::vector<StackMemoryBlockUsage> blocks;
+};
+
+/**
+ * Samples vos_getMemStatistics. The pool-wide high-water mark comes from the stack (total - minFree);
+ * per-block-size peaks are the maxima observed across samples.
+ */
+class StackMemoryMonitor
+{
+public:
+    explicit StackMemoryMonitor(StackMemoryPlan plan);
+
+    [[nodiscard]] const StackMemoryPlan &plan() const { return plan_; }
+    std::optional<StackMemorySnapshot> sample();
+
+private:
+    StackMemoryPlan plan_;
+    std::mutex mutex_;
+    std::array<std::uint32_t, VOS_MEM_NBLOCKSIZES> peaks_{};
+};
+} // namespace trdp::runtime
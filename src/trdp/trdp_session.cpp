@@ -1,10 +1,16 @@
 #include "trdp/trdp_session.h"
 
+#include "util/trace.h"
+
 #include <vos_sock.h>
 #include <vos_utils.h>
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <cstring>
+#include <limits>
 #include <sstream>
 
 namespace trdp::runtime
@@ -14,6 +20,51 @@ namespace
 std::atomic_uint32_t g_sessionCount{0U};
 std::once_flag g_stackInitFlag;
 TRDP_ERR_T g_stackInitResult = TRDP_NO_ERR;
+std::mutex g_stackMemoryMutex;
+TRDP_MEM_CONFIG_T g_stackMemory{};
+bool g_stackStarted = false;
+
+/**
+ * Redundancy group of every publisher that has none of its own. Groups are local to the stack, not
+ * part of the telegram, and this one lets a single tlp_setRedundant() silence all of them.
+ */
+constexpr UINT32 kPauseGroup = 0xFFFFFFFFU;
+
+/** How often the process thread reads the stack's per-publication send counters. */
+constexpr auto kSendSampleInterval = std::chrono::milliseconds(100);
+
+/** The stack's publication statistics carry no handle; ComID and destination identify a publisher. */
+std::uint64_t publisherKey(std::uint32_t comId, TRDP_IP_ADDR_T destIp)
+{
+    return (static_cast<std::uint64_t>(comId) << 32U) | destIp;
+}
+
+TRDP_TO_BEHAVIOR_T toTrdpBehavior(model::TimeoutBehavior behavior, TRDP_TO_BEHAVIOR_T fallback)
+{
+    switch (behavior)
+    {
+    case model::TimeoutBehavior::SetToZero:
+        return TRDP_TO_SET_TO_ZERO;
+    case model::TimeoutBehavior::KeepLastValue:
+        return TRDP_TO_KEEP_LAST_VALUE;
+    case model::TimeoutBehavior::Default:
+    default:
+        return fallback;
+    }
+}
+
+/** Virtual wire handles travel in the stack's opaque handle types so the bookkeeping stays shared. */
+template <typename StackHandle>
+StackHandle toStackHandle(VirtualWire::Handle handle)
+{
+    return reinterpret_cast<StackHandle>(static_cast<std::uintptr_t>(handle));
+}
+
+template <typename StackHandle>
+VirtualWire::Handle fromStackHandle(StackHandle handle)
+{
+    return static_cast<VirtualWire::Handle>(reinterpret_cast<std::uintptr_t>(handle));
+}
 
 std::string makeErrorMessage(const std::string &context, TRDP_ERR_T err)
 {
@@ -24,24 +75,45 @@ std::string makeErrorMessage(const std::string &context, TRDP_ERR_T err)
 }
 }
 
-TrdpSession::TrdpSession(TrdpSessionConfig config) : config_(std::move(config)) {}
+TrdpSession::TrdpSession(TrdpSessionConfig config)
+    : config_(std::move(config)),
+      wire_(config_.virtualWire),
+      timeouts_(std::chrono::milliseconds(1), wire_ ? wire_->now() : std::chrono::steady_clock::now()),
+      generators_(std::chrono::microseconds(100), wire_ ? wire_->now() : std::chrono::steady_clock::now())
+{
+}
 
 TrdpSession::~TrdpSession()
 {
     close();
 }
 
+bool TrdpSession::configureStackMemory(const StackMemoryPlan &plan)
+{
+    std::lock_guard<std::mutex> lock(g_stackMemoryMutex);
+    if (g_stackStarted)
+    {
+        util::logWarn("TRDP stack already initialized; memory plan ignored");
+        return false;
+    }
+
+    g_stackMemory = plan.toMemConfig();
+    util::logInfo("TRDP stack memory: " + plan.describe());
+    return true;
+}
+
 bool TrdpSession::initializeStack()
 {
-    std::call_once(g_stackInitFlag, [&] {
-        memConfig_.p = nullptr;
-        memConfig_.size = 0U;
-        std::fill(std::begin(memConfig_.prealloc), std::end(memConfig_.prealloc), 0U);
+    std::call_once(g_stackInitFlag, [] {
+        std::lock_guard<std::mutex> lock(g_stackMemoryMutex);
+        g_stackStarted = true;
 
-        g_stackInitResult = tlc_init(nullptr, nullptr, &memConfig_);
+        g_stackInitResult = tlc_init(nullptr, nullptr, &g_stackMemory);
         if (g_stackInitResult == TRDP_NO_ERR)
         {
-            util::logInfo("Initialized TRDP stack");
+            std::ostringstream oss;
+            oss << "Initialized TRDP stack (pool " << g_stackMemory.size << " bytes)";
+            util::logInfo(oss.str());
         }
         else
         {
@@ -65,7 +137,7 @@ bool TrdpSession::open()
         return true;
     }
 
-    if (!initializeStack())
+    if (wire_ == nullptr && !initializeStack())
     {
         return false;
     }
@@ -76,20 +148,35 @@ bool TrdpSession::open()
     pdConfig_.pfCbFunction = &TrdpSession::pdCallback;
     pdConfig_.pRefCon = this;
     pdConfig_.sendParam = TRDP_PD_DEFAULT_SEND_PARAM;
-    pdConfig_.flags = TRDP_FLAGS_CALLBACK;
-    pdConfig_.timeout = TRDP_PD_DEFAULT_TIMEOUT;
-    pdConfig_.toBehavior = TRDP_TO_SET_TO_ZERO;
-    pdConfig_.port = 0U;
-
-    processConfig_.cycleTime = TRDP_PROCESS_DEFAULT_CYCLE_TIME;
-    processConfig_.priority = 0U;
-    processConfig_.options = TRDP_OPTION_BLOCK;
+    if (config_.pd.qos != 0U)
+    {
+        pdConfig_.sendParam.qos = config_.pd.qos;
+    }
+    if (config_.pd.ttl != 0U)
+    {
+        pdConfig_.sendParam.ttl = config_.pd.ttl;
+    }
+    // Payloads are handed over as raw bytes, so no marshalling is requested even if the XML asks for it.
+    pdConfig_.flags = static_cast<TRDP_FLAGS_T>((config_.pd.flags & ~TRDP_FLAGS_MARSHALL) | TRDP_FLAGS_CALLBACK);
+    pdConfig_.timeout = config_.pd.timeoutUs != 0U ? config_.pd.timeoutUs : TRDP_PD_DEFAULT_TIMEOUT;
+    pdConfig_.toBehavior = toTrdpBehavior(config_.pd.timeoutBehavior, TRDP_TO_SET_TO_ZERO);
+    pdConfig_.port = config_.pd.port;
+
+    processConfig_.cycleTime =
+        config_.process.cycleTimeUs != 0U ? config_.process.cycleTimeUs : TRDP_PROCESS_DEFAULT_CYCLE_TIME;
+    processConfig_.priority = config_.process.priority;
+    processConfig_.options = static_cast<TRDP_OPTION_T>(config_.process.options | TRDP_OPTION_BLOCK);
     std::memset(processConfig_.hostName, 0, sizeof(processConfig_.hostName));
     std::memset(processConfig_.leaderName, 0, sizeof(processConfig_.leaderName));
     std::memset(processConfig_.type, 0, sizeof(processConfig_.type));
     std::strncpy(processConfig_.hostName, config_.hostIp.c_str(), sizeof(processConfig_.hostName) - 1U);
     std::strncpy(processConfig_.leaderName, config_.leaderIp.c_str(), sizeof(processConfig_.leaderName) - 1U);
 
+    if (wire_ != nullptr)
+    {
+        return openVirtual();
+    }
+
     const auto openErr = tlc_openSession(
         &appHandle_,
         hostAddr_,
@@ -104,30 +191,188 @@ bool TrdpSession::open()
         return false;
     }
 
+    wakeFd_.store(::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC));
+    if (wakeFd_.load() < 0)
+    {
+        util::logError("Failed to create process thread wake-up descriptor");
+        (void)tlc_closeSession(appHandle_);
+        appHandle_ = nullptr;
+        return false;
+    }
+    wakePending_.store(false);
+
     g_sessionCount.fetch_add(1U);
+    openedAt_ = std::chrono::steady_clock::now();
+    firstPdReceive_.reset();
     startProcessThread();
 
     opened_ = true;
     std::ostringstream oss;
     oss << "Opened TRDP Light session on host " << config_.hostIp << " (leader " << config_.leaderIp
-        << ", network " << static_cast<int>(config_.networkId) << ")";
+        << ", network " << static_cast<int>(config_.networkId) << ", cycle " << processConfig_.cycleTime
+        << " us, priority " << processConfig_.priority << ")";
     util::logInfo(oss.str());
     return true;
 }
 
+bool TrdpSession::openVirtual()
+{
+    // The wire runs the supervisor and the payload generators on its simulated clock in place of
+    // the process loop.
+    VirtualWire::Station station{};
+    station.hostIp = hostAddr_;
+    station.nextDeadline = [this] {
+        const auto timeout = timeouts_.nextDeadline();
+        const auto generator = generators_.nextDeadline();
+        if (timeout && generator)
+        {
+            return std::optional<std::chrono::steady_clock::time_point>(std::min(*timeout, *generator));
+        }
+        return timeout ? timeout : generator;
+    };
+    station.advance = [this](std::chrono::steady_clock::time_point now) {
+        generators_.advance(now, [this](TRDP_PUB_T pubHandle, const std::uint8_t *data, std::size_t size) {
+            return putPayload(pubHandle, data, size);
+        });
+        timeouts_.advance(now);
+        sampleSends();
+    };
+    wireStation_ = wire_->attach(std::move(station));
+
+    openedAt_ = wire_->now();
+    firstPdReceive_.reset();
+    opened_ = true;
+    util::logInfo("Opened virtual TRDP session on host " + config_.hostIp);
+    return true;
+}
+
+void TrdpSession::closeVirtual()
+{
+    drainCommands();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pdSubscriptions_.clear();
+        // The callbacks go with their subscriptions; they often hold the endpoint that holds this session.
+        pdCallbacks_.clear();
+        pdPublications_.clear();
+    }
+    timeouts_.clear();
+    generators_.clear();
+
+    // Detaching drops the station's publications and subscriptions with it.
+    wire_->detach(wireStation_);
+    wireStation_ = 0U;
+    util::logInfo("Closed virtual TRDP session on host " + config_.hostIp);
+}
+
 void TrdpSession::startProcessThread()
 {
     running_.store(true);
-    processThread_ = std::thread([this] { processLoop(); });
+    threadActive_.store(true);
+    processThread_ = std::thread([this] {
+        processThreadId_.store(std::this_thread::get_id());
+        TRDP_TRACE_THREAD_NAME("trdp " + config_.hostIp);
+        util::setThreadLogSession(config_.hostIp);
+        applyRealtimeProfile();
+        processLoop();
+    });
+}
+
+void TrdpSession::applyRealtimeProfile()
+{
+    // The stack never creates this thread itself, so the XML process priority only takes effect when
+    // the command line asks for it with --rt-policy xml.
+    auto profile = config_.realtime;
+    if (profile.policy == model::SchedulingPolicy::XmlPriority)
+    {
+        profile.policy =
+            processConfig_.priority != 0U ? model::SchedulingPolicy::Fifo : model::SchedulingPolicy::Inherit;
+        profile.priority = static_cast<int>(processConfig_.priority);
+    }
+
+    auto report = runtime::applyRealtimeProfile(profile);
+    const auto message = "Real-time profile on " + config_.hostIp + ": " + report.summary();
+    if (report.fullyApplied())
+    {
+        util::logInfo(message);
+    }
+    else
+    {
+        util::logWarn(message);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    realtimeReport_ = std::move(report);
+}
+
+void TrdpSession::setPdTimeoutListener(PdTimeoutSupervisor::Listener listener)
+{
+    timeouts_.setListener(std::move(listener));
+}
+
+void TrdpSession::setPdRecorder(std::shared_ptr<record::RecordingWriter> recorder)
+{
+    recorder_ = std::move(recorder);
+}
+
+PdSupervisionStats TrdpSession::pdSupervisionStats() const
+{
+    return timeouts_.stats();
+}
+
+bool TrdpSession::isPdLost(std::uint32_t comId) const
+{
+    return timeouts_.isLost(comId);
+}
+
+std::uint64_t TrdpSession::runPayloadProgram(std::shared_ptr<PayloadProgram> program,
+                                             std::vector<TRDP_PUB_T> pubHandles,
+                                             std::chrono::microseconds cycle)
+{
+    if (program == nullptr || !isOpen())
+    {
+        return 0U;
+    }
+    return submit([this, program = std::move(program), pubHandles = std::move(pubHandles), cycle]() mutable {
+               return generators_.add(std::move(program), std::move(pubHandles), cycle, sessionNow());
+           })
+        .get();
+}
+
+void TrdpSession::stopPayloadProgram(std::uint64_t id)
+{
+    if (id != 0U)
+    {
+        enqueue([this, id] { generators_.remove(id); });
+    }
+}
+
+PayloadGeneratorStats TrdpSession::payloadGeneratorStats() const
+{
+    return generators_.stats();
+}
+
+RealtimeReport TrdpSession::realtimeReport() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return realtimeReport_;
+}
+
+ProcessLoopSnapshot TrdpSession::processLoopStats() const
+{
+    return loopMetrics_.snapshot();
 }
 
 void TrdpSession::stopProcessThread()
 {
     running_.store(false);
+    wakeProcessThread();
     if (processThread_.joinable())
     {
         processThread_.join();
     }
+    processThreadId_.store(std::thread::id{});
+    threadActive_.store(false);
 }
 
 void TrdpSession::close()
@@ -145,8 +390,18 @@ void TrdpSession::close()
         handleToClose = appHandle_;
     }
 
+    if (wire_ != nullptr)
+    {
+        closeVirtual();
+        return;
+    }
+
     stopProcessThread();
 
+    // Commands that raced with the shutdown still run (and resolve their futures) before the
+    // handle goes away; the process thread is gone, so this thread is now the only stack caller.
+    drainCommands();
+
     {
         std::lock_guard<std::mutex> lock(mutex_);
         for (auto &entry : pdSubscriptions_)
@@ -154,7 +409,14 @@ void TrdpSession::close()
             (void)tlp_unsubscribe(handleToClose, entry.second);
         }
         pdSubscriptions_.clear();
+        // The callbacks go with their subscriptions; they often hold the endpoint that holds this session.
+        pdCallbacks_.clear();
+        pdPublications_.clear();
     }
+    timeouts_.clear();
+    generators_.clear();
+    redundancyGroups_.clear();
+    pausedRoles_.clear();
 
     if (handleToClose != nullptr)
     {
@@ -163,9 +425,16 @@ void TrdpSession::close()
         {
             util::logError(makeErrorMessage("Failed to close TRDP session", err));
         }
+        std::lock_guard<std::mutex> lock(mutex_);
         appHandle_ = nullptr;
     }
 
+    const int wakeFd = wakeFd_.exchange(-1);
+    if (wakeFd >= 0)
+    {
+        ::close(wakeFd);
+    }
+
     const auto remaining = g_sessionCount.fetch_sub(1U) - 1U;
     if (remaining == 0U)
     {
@@ -195,6 +464,21 @@ TRDP_APP_SESSION_T TrdpSession::appHandle() const
     return appHandle_;
 }
 
+bool TrdpSession::isVirtual() const
+{
+    return wire_ != nullptr;
+}
+
+bool TrdpSession::transportReady() const
+{
+    return appHandle_ != nullptr || wireStation_ != 0U;
+}
+
+std::chrono::steady_clock::time_point TrdpSession::sessionNow() const
+{
+    return wire_ != nullptr ? wire_->now() : std::chrono::steady_clock::now();
+}
+
 TRDP_IP_ADDR_T TrdpSession::hostAddress() const
 {
     return hostAddr_;
@@ -205,80 +489,749 @@ const std::string &TrdpSession::hostIpString() const
     return config_.hostIp;
 }
 
+bool TrdpSession::onSessionThread() const
+{
+    return processThreadId_.load() == std::this_thread::get_id();
+}
+
+std::optional<std::chrono::steady_clock::time_point> TrdpSession::firstPdReceiveTime() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return firstPdReceive_;
+}
+
+void TrdpSession::enqueue(Command command)
+{
+    if (onSessionThread())
+    {
+        command();
+        return;
+    }
+
+    commands_.push(std::move(command));
+    wakeProcessThread();
+
+    // Without a process thread (never opened, virtual, or joined during close) nobody else would run
+    // the command. While the thread is merely stopping it still owns the stack; close() drains what
+    // it leaves behind once it has been joined.
+    if (!threadActive_.load())
+    {
+        drainCommands();
+    }
+}
+
+void TrdpSession::wakeProcessThread()
+{
+    const int wakeFd = wakeFd_.load();
+    if (wakeFd >= 0 && !wakePending_.exchange(true))
+    {
+        const std::uint64_t one = 1U;
+        (void)::write(wakeFd, &one, sizeof(one));
+    }
+}
+
+void TrdpSession::drainWakeSignal()
+{
+    std::uint64_t value = 0U;
+    (void)::read(wakeFd_.load(), &value, sizeof(value));
+    // Cleared before draining so that a push racing with the drain raises a fresh signal.
+    wakePending_.store(false);
+}
+
+void TrdpSession::drainCommands()
+{
+    std::lock_guard<std::mutex> lock(drainMutex_);
+    Command command;
+    while (commands_.tryPop(command))
+    {
+        command();
+    }
+}
+
 void TrdpSession::registerPdSubscriber(std::uint32_t comId, PdCallback callback)
 {
+    PdRegistrationBatch batch{};
+    batch.subscribers.push_back(PdSubscriber{comId, 0U, model::TimeoutBehavior::Default, std::move(callback)});
+    (void)registerBatch(std::move(batch));
+}
+
+TRDP_PUB_T TrdpSession::publishPd(const PdPublication &publication)
+{
+    PdRegistrationBatch batch{};
+    batch.publications.push_back(publication);
+    const auto result = registerBatch(std::move(batch));
+    return result.pubHandles.empty() ? nullptr : result.pubHandles.front();
+}
+
+PdRegistrationResult TrdpSession::registerBatch(PdRegistrationBatch batch)
+{
+    if (!isOpen())
+    {
+        util::logWarn("TRDP session not open; cannot register PD telegrams");
+        PdRegistrationResult result{};
+        result.pubHandles.assign(batch.publications.size(), nullptr);
+        return result;
+    }
+
+    return submit([this, batch = std::move(batch)]() mutable { return registerOnSessionThread(std::move(batch)); })
+        .get();
+}
+
+PdRegistrationResult TrdpSession::registerOnSessionThread(PdRegistrationBatch batch)
+{
+    PdRegistrationResult result{};
+    result.pubHandles.assign(batch.publications.size(), nullptr);
+    if (!transportReady())
+    {
+        util::logWarn("TRDP session not open; cannot register PD telegrams");
+        return result;
+    }
+
+    bool changed = false;
+    for (auto &subscriber : batch.subscribers)
+    {
+        bool subscribed = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pdCallbacks_.emplace(subscriber.comId, std::move(subscriber.callback));
+            subscribed = pdSubscriptions_.find(subscriber.comId) != pdSubscriptions_.end();
+        }
+        if (!subscribed && subscribe(subscriber))
+        {
+            ++result.subscribed;
+            changed = true;
+        }
+    }
+
+    std::vector<std::uint32_t> redundancyGroups;
+    for (std::size_t i = 0; i < batch.publications.size(); ++i)
+    {
+        result.pubHandles[i] = publish(batch.publications[i]);
+        changed = changed || result.pubHandles[i] != nullptr;
+        if (result.pubHandles[i] != nullptr)
+        {
+            const auto redId = batch.publications[i].redundant;
+            redundancyGroups.push_back(redId != 0U ? redId : kPauseGroup);
+        }
+    }
+
+    // Publishers of the pause group lead unless the session is paused. Configured groups keep the role
+    // the stack gives them from the leader IP, except that a paused session makes them follow until it
+    // resumes. Virtual publishers follow their station instead.
+    std::sort(redundancyGroups.begin(), redundancyGroups.end());
+    redundancyGroups.erase(std::unique(redundancyGroups.begin(), redundancyGroups.end()), redundancyGroups.end());
+    for (const auto redId : redundancyGroups)
+    {
+        if (wire_ != nullptr)
+        {
+            break;
+        }
+        const auto known = std::lower_bound(redundancyGroups_.begin(), redundancyGroups_.end(), redId);
+        if (known == redundancyGroups_.end() || *known != redId)
+        {
+            redundancyGroups_.insert(known, redId);
+        }
+        if (redId == kPauseGroup)
+        {
+            setRedundantRole(redId, paused_.load() ? FALSE : TRUE);
+        }
+        else if (paused_.load())
+        {
+            followWhilePaused(redId);
+        }
+    }
+
+    // A single socket/index refresh for the whole batch instead of one per telegram.
+    if (changed && wire_ == nullptr)
+    {
+        updateSession("tlc_updateSession failed after PD registration");
+    }
+
+    if (batch.subscribers.size() + batch.publications.size() > 1U)
+    {
+        std::ostringstream oss;
+        oss << "Registered " << result.subscribed << " PD subscriptions and "
+            << std::count_if(result.pubHandles.begin(), result.pubHandles.end(), [](TRDP_PUB_T h) { return h != nullptr; })
+            << " publishers on " << config_.hostIp;
+        util::logInfo(oss.str());
+    }
+    return result;
+}
+
+bool TrdpSession::subscribe(const PdSubscriber &subscriber)
+{
+    const auto comId = subscriber.comId;
+    const UINT32 timeoutUs = subscriber.timeoutUs != 0U ? subscriber.timeoutUs : pdConfig_.timeout;
+    const auto destIp = subscriber.destIp != 0U ? subscriber.destIp : hostAddr_;
+    TRDP_SUB_T subHandle{};
+    const auto err = wire_ != nullptr ? subscribeVirtual(comId, destIp, subHandle) : tlp_subscribe(
+        appHandle_,
+        &subHandle,
+        this,
+        &TrdpSession::pdCallback,
+        0U,
+        comId,
+        0U,
+        0U,
+        0U,
+        0U,
+        destIp,
+        TRDP_FLAGS_DEFAULT,
+        nullptr,
+        timeoutUs,
+        toTrdpBehavior(subscriber.timeoutBehavior, pdConfig_.toBehavior));
+
+    if (err != TRDP_NO_ERR)
+    {
+        util::logError(makeErrorMessage("Failed to subscribe PD", err), {config_.hostIp, comId});
+        return false;
+    }
+
+    if (timeoutUs != 0U && timeoutUs != TRDP_INFINITE_TIMEOUT)
+    {
+        timeouts_.watch(comId, std::chrono::microseconds(timeoutUs), sessionNow());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pdSubscriptions_.emplace(comId, subHandle);
+    util::logDebug("Subscribed for PD comId " + std::to_string(comId), {config_.hostIp, comId});
+    return true;
+}
+
+TRDP_PUB_T TrdpSession::publish(const PdPublication &publication)
+{
+    TRDP_PUB_T pubHandle{nullptr};
+    const auto err = wire_ != nullptr ? publishVirtual(publication, pubHandle) : tlp_publish(
+        appHandle_,
+        &pubHandle,
+        this,
+        nullptr,
+        publication.serviceId,
+        publication.comId,
+        0U,
+        0U,
+        hostAddr_,
+        publication.destIp,
+        publication.intervalUs,
+        publication.redundant != 0U ? publication.redundant : kPauseGroup,
+        TRDP_FLAGS_DEFAULT,
+        nullptr,
+        publication.payload ? publication.payload->data() : nullptr,
+        publication.payload ? static_cast<UINT32>(publication.payload->size()) : 0U);
+
+    if (err != TRDP_NO_ERR)
+    {
+        util::logError(makeErrorMessage("Failed to publish PD comId " + std::to_string(publication.comId), err),
+                       {config_.hostIp, publication.comId});
+        return nullptr;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
-    if (!opened_ || appHandle_ == nullptr)
+    pdPublications_.emplace(pubHandle, PublisherEntry{publication.comId, publication.destIp, publication.sends, 0U});
+    return pubHandle;
+}
+
+TRDP_ERR_T TrdpSession::unpublishPd(TRDP_PUB_T pubHandle, std::chrono::steady_clock::time_point deadline)
+{
+    auto pending = submit([this, pubHandle] {
+        sampleSends();
+        return unpublish(pubHandle);
+    });
+    if (pending.wait_until(deadline) != std::future_status::ready)
+    {
+        util::logWarn("tlp_unpublish timed out; continuing", {config_.hostIp, 0U});
+        return TRDP_TIMEOUT_ERR;
+    }
+    return pending.get();
+}
+
+std::size_t TrdpSession::unpublishPd(const std::vector<TRDP_PUB_T> &pubHandles,
+                                     std::chrono::steady_clock::time_point deadline)
+{
+    auto pending = submit([this, pubHandles] {
+        // Sends since the last sample are credited before the handles go away.
+        sampleSends();
+        std::size_t released = 0U;
+        for (const auto pubHandle : pubHandles)
+        {
+            if (unpublish(pubHandle) == TRDP_NO_ERR)
+            {
+                ++released;
+            }
+        }
+        return released;
+    });
+    // The pass stays queued and still runs once the process thread gets to it.
+    if (pending.wait_until(deadline) != std::future_status::ready)
+    {
+        util::logWarn("tlp_unpublish of " + std::to_string(pubHandles.size()) + " handle(s) timed out; continuing",
+                      {config_.hostIp, 0U});
+        return 0U;
+    }
+    return pending.get();
+}
+
+void TrdpSession::putPd(std::vector<TRDP_PUB_T> pubHandles, std::shared_ptr<const std::vector<std::uint8_t>> payload)
+{
+    if (payload == nullptr || pubHandles.empty())
+    {
+        return;
+    }
+    enqueue([this, pubHandles = std::move(pubHandles), payload = std::move(payload)] {
+        for (const auto pubHandle : pubHandles)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!transportReady() || pdPublications_.count(pubHandle) == 0U)
+                {
+                    continue;
+                }
+            }
+            if (!putPayload(pubHandle, payload->data(), payload->size()))
+            {
+                util::logWarn("tlp_put of an updated payload failed");
+            }
+        }
+    });
+}
+
+void TrdpSession::setPaused(bool paused)
+{
+    if (paused_.exchange(paused) == paused)
+    {
+        return;
+    }
+    enqueue([this] { applyPause(); });
+    util::logInfo(std::string(paused ? "Paused" : "Resumed") + " PD traffic on " + config_.hostIp);
+}
+
+bool TrdpSession::isPaused() const
+{
+    return paused_.load();
+}
+
+void TrdpSession::applyPause()
+{
+    // Reads the flag rather than capturing it, so that the last queued pass wins.
+    const bool paused = paused_.load();
+    if (wire_ != nullptr)
+    {
+        wire_->setSending(wireStation_, !paused);
+        return;
+    }
+    if (appHandle_ == nullptr)
     {
-        util::logWarn("TRDP session not open; cannot register PD subscriber");
         return;
     }
 
-    pdCallbacks_.emplace(comId, std::move(callback));
+    // Configured groups get back the role they had when the pause began, whatever set it.
+    for (const auto redId : redundancyGroups_)
+    {
+        if (redId == kPauseGroup)
+        {
+            setRedundantRole(redId, paused ? FALSE : TRUE);
+        }
+        else if (paused)
+        {
+            followWhilePaused(redId);
+        }
+    }
+    if (!paused)
+    {
+        for (const auto &[redId, leader] : pausedRoles_)
+        {
+            setRedundantRole(redId, leader);
+        }
+        pausedRoles_.clear();
+    }
+}
+
+void TrdpSession::followWhilePaused(std::uint32_t redId)
+{
+    if (pausedRoles_.find(redId) == pausedRoles_.end())
+    {
+        BOOL8 leader = FALSE;
+        if (tlp_getRedundant(appHandle_, redId, &leader) != TRDP_NO_ERR)
+        {
+            return; // every publisher of the group has been released
+        }
+        pausedRoles_.emplace(redId, leader);
+    }
+    setRedundantRole(redId, FALSE);
+}
 
-    if (pdSubscriptions_.find(comId) == pdSubscriptions_.end())
+void TrdpSession::setRedundantRole(std::uint32_t redId, BOOL8 leader)
+{
+    const auto err = tlp_setRedundant(appHandle_, redId, leader);
+    if (err != TRDP_NO_ERR)
     {
-        TRDP_SUB_T subHandle{};
-        const auto err = tlp_subscribe(
-            appHandle_,
-            &subHandle,
-            this,
-            &TrdpSession::pdCallback,
-            0U,
-            comId,
-            0U,
-            0U,
-            0U,
-            0U,
-            hostAddr_,
-            TRDP_FLAGS_DEFAULT,
-            nullptr,
-            TRDP_PD_DEFAULT_TIMEOUT,
-            TRDP_TO_SET_TO_ZERO);
+        const auto group = redId == kPauseGroup ? std::string("of publishers without one") : std::to_string(redId);
+        util::logWarn(makeErrorMessage("Failed to set the role in redundancy group " + group, err), {config_.hostIp});
+    }
+}
 
-        if (err == TRDP_NO_ERR)
+void TrdpSession::sampleSends()
+{
+    // Current count per handle, read from the stack or the wire without holding mutex_.
+    std::vector<std::pair<TRDP_PUB_T, std::uint32_t>> counts;
+    if (wire_ != nullptr)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto &entry : pdPublications_)
+            {
+                counts.emplace_back(entry.first, 0U);
+            }
+        }
+        for (auto &count : counts)
+        {
+            count.second = static_cast<std::uint32_t>(wire_->sentCount(fromStackHandle(count.first)));
+        }
+    }
+    else if (appHandle_ != nullptr)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pdPublications_.empty())
+            {
+                return;
+            }
+            pubStatistics_.resize(std::max(pubStatistics_.size(), pdPublications_.size()));
+        }
+        auto entries =
+            static_cast<UINT16>(std::min<std::size_t>(pubStatistics_.size(), std::numeric_limits<UINT16>::max()));
+        auto err = tlc_getPubStatistics(appHandle_, &entries, pubStatistics_.data());
+        if (err == TRDP_MEM_ERR)
         {
-            pdSubscriptions_.emplace(comId, subHandle);
-            util::logDebug("Subscribed for PD comId " + std::to_string(comId));
+            // The send queue holds more than our publications, e.g. PD pull replies; it says how many.
+            pubStatistics_.resize(entries);
+            err = tlc_getPubStatistics(appHandle_, &entries, pubStatistics_.data());
+        }
+        if (err != TRDP_NO_ERR)
+        {
+            return;
+        }
 
-            const auto updateErr = tlc_updateSession(appHandle_);
-            if (updateErr != TRDP_NO_ERR)
+        std::unordered_map<std::uint64_t, std::uint32_t> byAddress;
+        for (UINT16 i = 0; i < entries; ++i)
+        {
+            const auto &statistics = pubStatistics_[i];
+            byAddress.emplace(publisherKey(statistics.comId, statistics.destAddr), statistics.numSend);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &entry : pdPublications_)
+        {
+            const auto it = byAddress.find(publisherKey(entry.second.comId, entry.second.destIp));
+            if (it != byAddress.end())
             {
-                util::logWarn(makeErrorMessage("tlc_updateSession failed after subscribe", updateErr));
+                counts.emplace_back(entry.first, it->second);
             }
         }
+    }
+
+    const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &[pubHandle, count] : counts)
+    {
+        const auto it = pdPublications_.find(pubHandle);
+        if (it == pdPublications_.end())
+        {
+            continue;
+        }
+        auto &entry = it->second;
+        const std::uint32_t sent = count - entry.sampled;
+        entry.sampled = count;
+        if (sent != 0U && entry.sends != nullptr)
+        {
+            entry.sends->sent.fetch_add(sent);
+            entry.sends->lastSentNs.store(now);
+        }
+    }
+}
+
+TRDP_ERR_T TrdpSession::unpublish(TRDP_PUB_T pubHandle)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!transportReady() || pdPublications_.erase(pubHandle) == 0U)
+        {
+            return TRDP_NOPUB_ERR;
+        }
+    }
+
+    const auto err = releasePublisher(pubHandle);
+    if (err != TRDP_NO_ERR)
+    {
+        util::logWarn(makeErrorMessage("tlp_unpublish failed", err));
+    }
+    return err;
+}
+
+TRDP_ERR_T TrdpSession::subscribeVirtual(std::uint32_t comId, TRDP_IP_ADDR_T destIp, TRDP_SUB_T &subHandle)
+{
+    const auto handle =
+        wire_->subscribe(wireStation_, comId, destIp, [this](const VirtualPdFrame &frame) { onVirtualFrame(frame); });
+    subHandle = toStackHandle<TRDP_SUB_T>(handle);
+    return handle != 0U ? TRDP_NO_ERR : TRDP_PARAM_ERR;
+}
+
+TRDP_ERR_T TrdpSession::publishVirtual(const PdPublication &publication, TRDP_PUB_T &pubHandle)
+{
+    const auto handle = wire_->publish(wireStation_,
+                                       publication.comId,
+                                       publication.destIp,
+                                       std::chrono::microseconds(publication.intervalUs),
+                                       publication.payload ? *publication.payload : std::vector<std::uint8_t>{});
+    pubHandle = toStackHandle<TRDP_PUB_T>(handle);
+    return handle != 0U ? TRDP_NO_ERR : TRDP_PARAM_ERR;
+}
+
+bool TrdpSession::putPayload(TRDP_PUB_T pubHandle, const std::uint8_t *data, std::size_t size)
+{
+    if (wire_ != nullptr)
+    {
+        return wire_->put(fromStackHandle(pubHandle), std::vector<std::uint8_t>(data, data + size));
+    }
+    return tlp_put(appHandle_, pubHandle, data, static_cast<UINT32>(size)) == TRDP_NO_ERR;
+}
+
+TRDP_ERR_T TrdpSession::releasePublisher(TRDP_PUB_T pubHandle)
+{
+    if (wire_ != nullptr)
+    {
+        return wire_->unpublish(fromStackHandle(pubHandle)) ? TRDP_NO_ERR : TRDP_NOPUB_ERR;
+    }
+    return tlp_unpublish(appHandle_, pubHandle);
+}
+
+TRDP_ERR_T TrdpSession::releaseSubscription(TRDP_SUB_T subHandle)
+{
+    if (wire_ != nullptr)
+    {
+        return wire_->unsubscribe(fromStackHandle(subHandle)) ? TRDP_NO_ERR : TRDP_NOSUB_ERR;
+    }
+    return tlp_unsubscribe(appHandle_, subHandle);
+}
+
+void TrdpSession::updateSession(const std::string &context)
+{
+    const auto updateErr = tlc_updateSession(appHandle_);
+    if (updateErr != TRDP_NO_ERR)
+    {
+        util::logWarn(makeErrorMessage(context, updateErr));
+    }
+}
+
+std::future<PdTeardownReport> TrdpSession::requestTeardown()
+{
+    return submit([this] { return teardownAll(); });
+}
+
+PdTeardownReport TrdpSession::awaitTeardown(std::future<PdTeardownReport> &pending,
+                                            std::chrono::steady_clock::time_point deadline)
+{
+    if (pending.valid() && pending.wait_until(deadline) == std::future_status::ready)
+    {
+        return pending.get();
+    }
+
+    PdTeardownReport report{};
+    report.timedOut = true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &entry : pdPublications_)
+    {
+        report.failedPublishers.push_back(entry.second.comId);
+    }
+    for (const auto &entry : pdSubscriptions_)
+    {
+        report.failedSubscribers.push_back(entry.first);
+    }
+    return report;
+}
+
+PdTeardownReport TrdpSession::releaseAll(std::chrono::steady_clock::time_point deadline)
+{
+    auto pending = requestTeardown();
+    return awaitTeardown(pending, deadline);
+}
+
+PdTeardownReport TrdpSession::teardownAll()
+{
+    PdTeardownReport report{};
+    std::vector<std::pair<TRDP_PUB_T, std::uint32_t>> publications;
+    std::vector<std::pair<std::uint32_t, TRDP_SUB_T>> subscriptions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!transportReady())
+        {
+            return report;
+        }
+        for (const auto &entry : pdPublications_)
+        {
+            publications.emplace_back(entry.first, entry.second.comId);
+        }
+        subscriptions.assign(pdSubscriptions_.begin(), pdSubscriptions_.end());
+    }
+
+    // No handle survives the pass, so nothing is left to put generated payloads to.
+    generators_.clear();
+    sampleSends();
+
+    // Entries are dropped one by one so that a caller whose deadline expires mid-pass can still
+    // report exactly which handles were not reached.
+    for (const auto &publication : publications)
+    {
+        if (releasePublisher(publication.first) == TRDP_NO_ERR)
+        {
+            ++report.unpublished;
+        }
+        else
+        {
+            report.failedPublishers.push_back(publication.second);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        pdPublications_.erase(publication.first);
+    }
+
+    for (const auto &subscription : subscriptions)
+    {
+        if (releaseSubscription(subscription.second) == TRDP_NO_ERR)
+        {
+            ++report.unsubscribed;
+        }
         else
         {
-            util::logError(makeErrorMessage("Failed to subscribe PD", err));
+            report.failedSubscribers.push_back(subscription.first);
         }
+        timeouts_.unwatch(subscription.first);
+        std::lock_guard<std::mutex> lock(mutex_);
+        pdSubscriptions_.erase(subscription.first);
+    }
+
+    std::ostringstream oss;
+    oss << "Released " << report.unpublished << " PD publishers and " << report.unsubscribed << " subscriptions on "
+        << config_.hostIp;
+    if (!report.failedPublishers.empty() || !report.failedSubscribers.empty())
+    {
+        oss << " (" << report.failedPublishers.size() + report.failedSubscribers.size() << " failed)";
+        util::logWarn(oss.str());
+    }
+    else
+    {
+        util::logInfo(oss.str());
     }
+    return report;
 }
 
 void TrdpSession::processLoop()
 {
+    const int wakeFd = wakeFd_.load();
     while (running_.load())
     {
+        drainCommands();
+
         TRDP_TIME_T interval{};
         TRDP_FDS_T rfds{};
         TRDP_SOCK_T noDesc = 0;
         FD_ZERO(&rfds);
 
-        const auto intervalErr = tlc_getInterval(appHandle_, &interval, &rfds, &noDesc);
+        TRDP_ERR_T intervalErr = TRDP_NO_ERR;
+        {
+            TRDP_TRACE_SCOPE("tlc_getInterval");
+            intervalErr = tlc_getInterval(appHandle_, &interval, &rfds, &noDesc);
+        }
         if (intervalErr != TRDP_NO_ERR)
         {
             interval.tv_sec = 0;
             interval.tv_usec = TRDP_PROCESS_DEFAULT_CYCLE_TIME;
         }
 
-        const INT32 ready = vos_select(noDesc, &rfds, nullptr, nullptr, &interval);
-        (void)ready;
+        // Wake up no later than the next PD receive deadline so a lost telegram is reported on
+        // time rather than at the stack's own (possibly much longer) interval, and no later than
+        // the next generator cycle so that generated payloads are fresh for every send.
+        for (const auto &deadline : {timeouts_.nextDeadline(), generators_.nextDeadline()})
+        {
+            if (!deadline)
+            {
+                continue;
+            }
+            const auto untilDeadline = std::max(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                    *deadline - std::chrono::steady_clock::now()),
+                                                std::chrono::microseconds(0));
+            const auto stackInterval = std::chrono::seconds(interval.tv_sec) + std::chrono::microseconds(interval.tv_usec);
+            if (untilDeadline < stackInterval)
+            {
+                interval.tv_sec = static_cast<decltype(interval.tv_sec)>(untilDeadline.count() / 1000000);
+                interval.tv_usec = static_cast<decltype(interval.tv_usec)>(untilDeadline.count() % 1000000);
+            }
+        }
+
+        FD_SET(wakeFd, &rfds);
+        const auto highDesc = std::max<TRDP_SOCK_T>(noDesc, wakeFd) + 1;
+
+        // select() may rewrite the interval, so the deadline it was asked for is taken first.
+        const auto selectDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(interval.tv_sec) +
+                                    std::chrono::microseconds(interval.tv_usec);
+        INT32 ready = 0;
+        {
+            TRDP_TRACE_SCOPE("select");
+            ready = vos_select(highDesc, &rfds, nullptr, nullptr, &interval);
+        }
+        const auto wokeAt = std::chrono::steady_clock::now();
+        bool commandWake = false;
+        if (ready > 0 && FD_ISSET(wakeFd, &rfds))
+        {
+            FD_CLR(wakeFd, &rfds);
+            --ready;
+            drainWakeSignal();
+            commandWake = true;
+        }
+
+        LoopWake wake = LoopWake::Spurious;
+        if (ready > 0)
+        {
+            wake = LoopWake::Socket;
+        }
+        else if (commandWake)
+        {
+            wake = LoopWake::Command;
+        }
+        else if (ready == 0)
+        {
+            wake = LoopWake::Timeout;
+        }
+
+        // Generated payloads go in before tlc_process so that the telegrams it sends carry them.
+        {
+            TRDP_TRACE_SCOPE("generators");
+            generators_.advance(wokeAt, [this](TRDP_PUB_T pubHandle, const std::uint8_t *data, std::size_t size) {
+                return putPayload(pubHandle, data, size);
+            });
+        }
 
-        INT32 count = 0;
-        const auto processErr = tlc_process(appHandle_, &rfds, &count);
+        // tlc_process only inspects the descriptor set when told how many entries are ready.
+        INT32 count = std::max<INT32>(ready, 0);
+        TRDP_ERR_T processErr = TRDP_NO_ERR;
+        const auto processStart = std::chrono::steady_clock::now();
+        {
+            TRDP_TRACE_SCOPE_ARG("tlc_process", "ready", count);
+            processErr = tlc_process(appHandle_, &rfds, &count);
+        }
+        loopMetrics_.recordIteration(wake, wokeAt - selectDeadline, std::max<INT32>(ready, 0),
+                                     std::chrono::steady_clock::now() - processStart);
         if (processErr != TRDP_NO_ERR)
         {
             util::logWarn(makeErrorMessage("tlc_process reported error", processErr));
         }
+
+        timeouts_.advance(std::chrono::steady_clock::now());
+        if (wokeAt >= nextSendSample_)
+        {
+            sampleSends();
+            nextSendSample_ = wokeAt + kSendSampleInterval;
+        }
     }
 }
 
@@ -295,19 +1248,70 @@ void TrdpSession::pdCallback(
     }
 
     auto *session = static_cast<TrdpSession *>(refCon);
-    session->onPdMessage(*pMsg, pData, dataSize);
+    session->onPdMessage(*pMsg, pData, dataSize, std::chrono::steady_clock::now());
 }
 
-void TrdpSession::onPdMessage(const TRDP_PD_INFO_T &msg, const std::uint8_t *data, std::uint32_t size)
+void TrdpSession::onVirtualFrame(const VirtualPdFrame &frame)
 {
+    TRDP_PD_INFO_T info{};
+    info.comId = frame.comId;
+    info.srcIpAddr = frame.srcIp;
+    info.destIpAddr = frame.destIp;
+    info.seqCount = frame.sequenceCounter;
+    info.resultCode = TRDP_NO_ERR;
+    onPdMessage(info, frame.payload->data(), static_cast<std::uint32_t>(frame.payload->size()), wire_->now());
+}
+
+void TrdpSession::onPdMessage(const TRDP_PD_INFO_T &msg,
+                              const std::uint8_t *data,
+                              std::uint32_t size,
+                              std::chrono::steady_clock::time_point now)
+{
+    TRDP_TRACE_SCOPE_ARG("onPdMessage", "comId", msg.comId);
+    if (msg.resultCode == TRDP_TIMEOUT_ERR)
+    {
+        // A stack-side timeout is link state, not a telegram: report it once through the
+        // supervisor instead of logging and dispatching it on every cycle.
+        timeouts_.onStackTimeout(msg.comId, now);
+        return;
+    }
     if (msg.resultCode != TRDP_NO_ERR)
     {
         util::logWarn(makeErrorMessage("PD reception reported error", msg.resultCode));
     }
+    else
+    {
+        timeouts_.onReceive(msg.comId, now);
+    }
+
+    // A paused session keeps its links supervised but hands nothing on.
+    if (paused_.load())
+    {
+        return;
+    }
+    if (msg.resultCode == TRDP_NO_ERR && recorder_)
+    {
+        const auto wallClock = std::chrono::system_clock::now().time_since_epoch();
+        recorder_->append(record::PdRecordView{
+            std::chrono::duration_cast<std::chrono::nanoseconds>(wallClock).count(),
+            msg.comId,
+            msg.seqCount,
+            msg.srcIpAddr,
+            msg.destIpAddr,
+            data,
+            size,
+        });
+    }
 
     std::vector<PdCallback> callbacks;
+    std::optional<std::chrono::steady_clock::duration> firstAfterOpen;
     {
         std::lock_guard<std::mutex> lock(mutex_);
+        if (msg.resultCode == TRDP_NO_ERR && !firstPdReceive_)
+        {
+            firstPdReceive_ = now;
+            firstAfterOpen = *firstPdReceive_ - openedAt_;
+        }
         auto range = pdCallbacks_.equal_range(msg.comId);
         for (auto it = range.first; it != range.second; ++it)
         {
@@ -315,9 +1319,17 @@ void TrdpSession::onPdMessage(const TRDP_PD_INFO_T &msg, const std::uint8_t *dat
         }
     }
 
+    if (firstAfterOpen)
+    {
+        std::ostringstream oss;
+        oss << "First PD telegram on " << config_.hostIp << " (comId " << msg.comId << ") "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(*firstAfterOpen).count() << " ms after session open";
+        util::logInfo(oss.str(), {config_.hostIp, msg.comId});
+    }
+
     if (callbacks.empty())
     {
-        util::logWarn("No PD subscribers registered for comId " + std::to_string(msg.comId));
+        util::logWarn("No PD subscribers registered for comId " + std::to_string(msg.comId), {config_.hostIp, msg.comId});
         return;
     }
 
@@ -1,6 +1,16 @@
 #pragma once
 
+#include "model/runtime_options.h"
+#include "model/sim_config.h"
+#include "record/recording_writer.h"
+#include "trdp/payload_generator.h"
+#include "trdp/pd_timeout_supervisor.h"
+#include "trdp/process_loop_metrics.h"
+#include "trdp/realtime_profile.h"
+#include "trdp/stack_memory.h"
+#include "trdp/virtual_wire.h"
 #include "util/logging.h"
+#include "util/mpsc_queue.h"
 
 #include <trdp_if_light.h>
 
@@ -8,11 +18,15 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace trdp::runtime
@@ -22,6 +36,14 @@ struct TrdpSessionConfig
     std::string hostIp;
     std::string leaderIp;
     std::uint8_t networkId{0U};
+    model::ProcessSettings process;
+    model::PdDefaults pd;
+    model::RealtimeProfile realtime;
+    /**
+     * Exchange telegrams over this in-memory network instead of the TRDP stack. The session then
+     * runs no process thread; the wire's clock drives reception and timeout supervision.
+     */
+    std::shared_ptr<VirtualWire> virtualWire;
 };
 
 struct PdMessage
@@ -31,6 +53,87 @@ struct PdMessage
     std::chrono::system_clock::time_point timestamp{std::chrono::system_clock::now()};
 };
 
+/**
+ * Telegrams sent by a set of publications, as the process thread last read them from the stack
+ * (or the virtual wire). Readers on other threads need no lock.
+ */
+struct PdSendCounter
+{
+    std::atomic<std::uint64_t> sent{0};
+    /** system_clock nanoseconds of the sample that last saw `sent` grow; 0 before the first send. */
+    std::atomic<std::int64_t> lastSentNs{0};
+};
+
+/**
+ * One PD publisher. A telegram sent to several destinations becomes one publication per
+ * destination; they all point at the same payload buffer, which the stack copies on publish, and
+ * at the same send counter.
+ */
+struct PdPublication
+{
+    std::uint32_t serviceId{0};
+    std::uint32_t comId{0};
+    TRDP_IP_ADDR_T destIp{0U};
+    std::uint32_t intervalUs{0};
+    std::uint32_t redundant{0};
+    std::shared_ptr<const std::vector<std::uint8_t>> payload;
+    /** Credited with the publication's sends while it is published; may be null. */
+    std::shared_ptr<PdSendCounter> sends;
+};
+
+/**
+ * One PD subscription; zero/Default parameters use the session's PD defaults. A timeout of
+ * TRDP_INFINITE_TIMEOUT subscribes without receive supervision.
+ */
+struct PdSubscriber
+{
+    std::uint32_t comId{0};
+    std::uint32_t timeoutUs{0};
+    model::TimeoutBehavior timeoutBehavior{model::TimeoutBehavior::Default};
+    std::function<void(const PdMessage &)> callback;
+    /** Multicast group to receive on (the stack joins it); 0 receives on the host address. */
+    TRDP_IP_ADDR_T destIp{0U};
+};
+
+/**
+ * Set of subscriptions and publications registered with a single tlc_updateSession call.
+ * Publication handles in the result are index-aligned with `publications` (nullptr on failure).
+ */
+struct PdRegistrationBatch
+{
+    std::vector<PdSubscriber> subscribers;
+    std::vector<PdPublication> publications;
+};
+
+struct PdRegistrationResult
+{
+    std::size_t subscribed{0};
+    std::vector<TRDP_PUB_T> pubHandles;
+};
+
+/**
+ * Outcome of a session-wide release of all PD handles. Handles that could not be confirmed as
+ * released (stack error or deadline reached) are listed by comId.
+ */
+struct PdTeardownReport
+{
+    std::size_t unpublished{0};
+    std::size_t unsubscribed{0};
+    std::vector<std::uint32_t> failedPublishers;
+    std::vector<std::uint32_t> failedSubscribers;
+    bool timedOut{false};
+
+    [[nodiscard]] bool complete() const { return !timedOut && failedPublishers.empty() && failedSubscribers.empty(); }
+};
+
+/**
+ * One TRDP Light application session plus the thread that drives tlc_process for it.
+ *
+ * The process thread is the only thread that calls into the stack for this session. Other threads
+ * hand work over through submit(): commands go into a lock-free MPSC queue, the process thread is
+ * woken through an eventfd and runs them between two tlc_process calls, and results come back as
+ * futures. Commands submitted from the process thread itself (e.g. from a PD callback) run inline.
+ */
 class TrdpSession
 {
 public:
@@ -39,17 +142,102 @@ public:
     explicit TrdpSession(TrdpSessionConfig config);
     ~TrdpSession();
 
+    /** Sets the memory pool used by tlc_init; only effective before the first session opens. */
+    static bool configureStackMemory(const StackMemoryPlan &plan);
+
     bool open();
     void close();
     [[nodiscard]] bool isOpen() const;
 
+    template <typename Fn>
+    auto submit(Fn &&fn) -> std::future<std::invoke_result_t<Fn>>
+    {
+        using Result = std::invoke_result_t<Fn>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+        auto future = task->get_future();
+        enqueue([task] { (*task)(); });
+        return future;
+    }
+
     void registerPdSubscriber(std::uint32_t comId, PdCallback callback);
+    PdRegistrationResult registerBatch(PdRegistrationBatch batch);
+    TRDP_PUB_T publishPd(const PdPublication &publication);
+
+    /**
+     * Queue a pass that unpublishes and unsubscribes every handle of this session on the process
+     * thread. The returned future becomes ready once the pass has run; use releaseAll() for a
+     * bounded wait.
+     */
+    std::future<PdTeardownReport> requestTeardown();
+    PdTeardownReport awaitTeardown(std::future<PdTeardownReport> &pending, std::chrono::steady_clock::time_point deadline);
+    PdTeardownReport releaseAll(std::chrono::steady_clock::time_point deadline);
+    /** Waits for the process thread until `deadline` at most; TRDP_TIMEOUT_ERR if it did not get to it. */
+    TRDP_ERR_T unpublishPd(TRDP_PUB_T pubHandle, std::chrono::steady_clock::time_point deadline);
+    /**
+     * Unpublish several handles in one process-thread pass; returns how many were released, 0 if the
+     * pass did not run before `deadline`.
+     */
+    std::size_t unpublishPd(const std::vector<TRDP_PUB_T> &pubHandles, std::chrono::steady_clock::time_point deadline);
+    /**
+     * Queue a tlp_put of `payload` to each of `pubHandles` without waiting for the process thread, so
+     * a running publisher sends new data from its next cycle on. Handles released by then are skipped.
+     */
+    void putPd(std::vector<TRDP_PUB_T> pubHandles, std::shared_ptr<const std::vector<std::uint8_t>> payload);
+
+    /**
+     * Pauses or resumes all PD traffic of the session without releasing a handle. Publishers stay
+     * registered but the stack suppresses their sends, as for redundancy followers; received
+     * telegrams are neither recorded nor dispatched, while receive supervision keeps running.
+     * Resuming gives configured redundancy groups back the role they had before the pause.
+     * Returns at once: reception is gated immediately, sending from the next process cycle.
+     */
+    void setPaused(bool paused);
+    [[nodiscard]] bool isPaused() const;
 
     [[nodiscard]] TRDP_APP_SESSION_T appHandle() const;
+    /** True if the session runs on a VirtualWire; appHandle() is then always nullptr. */
+    [[nodiscard]] bool isVirtual() const;
     [[nodiscard]] TRDP_IP_ADDR_T hostAddress() const;
     [[nodiscard]] const std::string &hostIpString() const;
+    [[nodiscard]] std::optional<std::chrono::steady_clock::time_point> firstPdReceiveTime() const;
+    [[nodiscard]] bool onSessionThread() const;
+    /** Receives "telegram lost/recovered" events on the process thread; set before open(). */
+    void setPdTimeoutListener(PdTimeoutSupervisor::Listener listener);
+    /** Appends every telegram received without error to `recorder`; set before open(). */
+    void setPdRecorder(std::shared_ptr<record::RecordingWriter> recorder);
+    [[nodiscard]] PdSupervisionStats pdSupervisionStats() const;
+
+    /**
+     * Re-evaluates `program` every `cycle` on the process thread and puts the result to `pubHandles`
+     * (tlp_put), so that generated fields change from one telegram to the next. Returns the id for
+     * stopPayloadProgram(); 0 when the session is not open.
+     */
+    std::uint64_t runPayloadProgram(std::shared_ptr<PayloadProgram> program,
+                                    std::vector<TRDP_PUB_T> pubHandles,
+                                    std::chrono::microseconds cycle);
+    /** Returns at once; commands run in order, so a later unpublishPd() never races the program. */
+    void stopPayloadProgram(std::uint64_t id);
+    [[nodiscard]] PayloadGeneratorStats payloadGeneratorStats() const;
+    [[nodiscard]] bool isPdLost(std::uint32_t comId) const;
+
+    /** What the process thread's real-time profile achieved; empty until the thread has started. */
+    [[nodiscard]] RealtimeReport realtimeReport() const;
+
+    /** Wakeup lag, tlc_process duration and wake mix of the process loop; empty for virtual sessions. */
+    [[nodiscard]] ProcessLoopSnapshot processLoopStats() const;
 
 private:
+    using Command = std::function<void()>;
+
+    struct PublisherEntry
+    {
+        std::uint32_t comId{0};
+        TRDP_IP_ADDR_T destIp{0U};
+        std::shared_ptr<PdSendCounter> sends;
+        /** Send count the last sample read; the stack's counter is 32 bits wide and wraps. */
+        std::uint32_t sampled{0};
+    };
+
     static void pdCallback(
         void *refCon,
         TRDP_APP_SESSION_T appHandle,
@@ -57,9 +245,39 @@ private:
         UINT8 *pData,
         UINT32 dataSize);
 
-    void onPdMessage(const TRDP_PD_INFO_T &msg, const std::uint8_t *data, std::uint32_t size);
+    void onPdMessage(const TRDP_PD_INFO_T &msg,
+                     const std::uint8_t *data,
+                     std::uint32_t size,
+                     std::chrono::steady_clock::time_point now);
+    void onVirtualFrame(const VirtualPdFrame &frame);
+    bool openVirtual();
+    void closeVirtual();
+    [[nodiscard]] bool transportReady() const;
+    [[nodiscard]] std::chrono::steady_clock::time_point sessionNow() const;
+    PdRegistrationResult registerOnSessionThread(PdRegistrationBatch batch);
+    bool subscribe(const PdSubscriber &subscriber);
+    TRDP_PUB_T publish(const PdPublication &publication);
+    TRDP_ERR_T unpublish(TRDP_PUB_T pubHandle);
+    TRDP_ERR_T subscribeVirtual(std::uint32_t comId, TRDP_IP_ADDR_T destIp, TRDP_SUB_T &subHandle);
+    TRDP_ERR_T publishVirtual(const PdPublication &publication, TRDP_PUB_T &pubHandle);
+    TRDP_ERR_T releasePublisher(TRDP_PUB_T pubHandle);
+    bool putPayload(TRDP_PUB_T pubHandle, const std::uint8_t *data, std::size_t size);
+    TRDP_ERR_T releaseSubscription(TRDP_SUB_T subHandle);
+    void applyPause();
+    /** Makes configured redundancy group `redId` follow, first recording the role it had before the pause. */
+    void followWhilePaused(std::uint32_t redId);
+    void setRedundantRole(std::uint32_t redId, BOOL8 leader);
+    /** Credits each publication's send counter with what it sent since the last sample; process thread only. */
+    void sampleSends();
+    void updateSession(const std::string &context);
+    PdTeardownReport teardownAll();
+    void enqueue(Command command);
+    void wakeProcessThread();
+    void drainWakeSignal();
+    void drainCommands();
     bool initializeStack();
     void startProcessThread();
+    void applyRealtimeProfile();
     void stopProcessThread();
     void processLoop();
 
@@ -67,16 +285,40 @@ private:
     TRDP_APP_SESSION_T appHandle_{nullptr};
     TRDP_PD_CONFIG_T pdConfig_{};
     TRDP_PROCESS_CONFIG_T processConfig_{};
-    TRDP_MEM_CONFIG_T memConfig_{};
     TRDP_IP_ADDR_T hostAddr_{0U};
     TRDP_IP_ADDR_T leaderAddr_{0U};
+    std::shared_ptr<VirtualWire> wire_;
+    VirtualWire::Handle wireStation_{0U};
 
     bool opened_{false};
     std::atomic<bool> running_{false};
+    /** From startProcessThread() until the thread has been joined; other threads drain commands only after. */
+    std::atomic<bool> threadActive_{false};
+    std::atomic<bool> paused_{false};
     std::thread processThread_{};
+    std::atomic<std::thread::id> processThreadId_{};
     mutable std::mutex mutex_;
     std::unordered_multimap<std::uint32_t, PdCallback> pdCallbacks_;
     std::unordered_map<std::uint32_t, TRDP_SUB_T> pdSubscriptions_;
+    std::unordered_map<TRDP_PUB_T, PublisherEntry> pdPublications_;
+    /** Redundancy groups with registered publishers, sorted; process thread only. */
+    std::vector<std::uint32_t> redundancyGroups_;
+    /** Role of each configured redundancy group before the current pause; process thread only. */
+    std::unordered_map<std::uint32_t, BOOL8> pausedRoles_;
+    std::chrono::steady_clock::time_point openedAt_{};
+    std::optional<std::chrono::steady_clock::time_point> firstPdReceive_;
+    RealtimeReport realtimeReport_;
+    PdTimeoutSupervisor timeouts_;
+    PayloadScheduler generators_;
+    ProcessLoopMetrics loopMetrics_;
+    std::shared_ptr<record::RecordingWriter> recorder_;
+    std::vector<TRDP_PUB_STATISTICS_T> pubStatistics_;
+    std::chrono::steady_clock::time_point nextSendSample_{};
+
+    util::MpscQueue<Command> commands_;
+    std::mutex drainMutex_;
+    std::atomic<int> wakeFd_{-1};
+    std::atomic<bool> wakePending_{false};
 };
 
 } // namespace trdp::runtime
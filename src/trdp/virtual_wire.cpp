@@ -0,0 +1,348 @@
+#include "trdp/virtual_wire.h"
+
+#include <algorithm>
+
+namespace trdp::runtime
+{
+VirtualWire::VirtualWire(Clock::time_point start) : now_(start) {}
+
+VirtualWire::Clock::time_point VirtualWire::now() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return now_;
+}
+
+VirtualWire::Handle VirtualWire::attach(Station station)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto handle = nextHandle_++;
+    stations_.emplace(handle, std::move(station));
+    return handle;
+}
+
+void VirtualWire::detach(Handle station)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = publications_.begin(); it != publications_.end();)
+    {
+        if (it->second.station == station)
+        {
+            schedule_.erase({it->second.due, it->first});
+            it = publications_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    for (auto it = subscriptions_.begin(); it != subscriptions_.end();)
+    {
+        if (it->second.station != station)
+        {
+            ++it;
+            continue;
+        }
+        auto range = subscribersByKey_.equal_range(subscriptionKey(it->second.comId, it->second.destIp));
+        for (auto entry = range.first; entry != range.second; ++entry)
+        {
+            if (entry->second == it->first)
+            {
+                subscribersByKey_.erase(entry);
+                break;
+            }
+        }
+        it = subscriptions_.erase(it);
+    }
+    silent_.erase(station);
+    stations_.erase(station);
+}
+
+VirtualWire::Handle VirtualWire::publish(Handle station,
+                                         std::uint32_t comId,
+                                         TRDP_IP_ADDR_T destIp,
+                                         std::chrono::microseconds interval,
+                                         std::vector<std::uint8_t> payload)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto stationIt = stations_.find(station);
+    if (stationIt == stations_.end())
+    {
+        return 0U;
+    }
+
+    Publication publication{};
+    publication.station = station;
+    publication.comId = comId;
+    publication.srcIp = stationIt->second.hostIp;
+    publication.destIp = destIp;
+    publication.interval = std::max(interval, std::chrono::microseconds(1));
+    publication.due = now_ + publication.interval;
+    publication.payload = std::make_shared<const std::vector<std::uint8_t>>(std::move(payload));
+
+    const auto handle = nextHandle_++;
+    schedule_.emplace(publication.due, handle);
+    publications_.emplace(handle, std::move(publication));
+    return handle;
+}
+
+bool VirtualWire::unpublish(Handle publication)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = publications_.find(publication);
+    if (it == publications_.end())
+    {
+        return false;
+    }
+    schedule_.erase({it->second.due, publication});
+    publications_.erase(it);
+    return true;
+}
+
+bool VirtualWire::put(Handle publication, std::vector<std::uint8_t> payload)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = publications_.find(publication);
+    if (it == publications_.end())
+    {
+        return false;
+    }
+    // Frames already handed to receivers keep the buffer they were sent with.
+    it->second.payload = std::make_shared<const std::vector<std::uint8_t>>(std::move(payload));
+    return true;
+}
+
+VirtualWire::Handle VirtualWire::subscribe(Handle station, std::uint32_t comId, TRDP_IP_ADDR_T destIp, Receiver receiver)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stations_.find(station) == stations_.end())
+    {
+        return 0U;
+    }
+
+    const auto handle = nextHandle_++;
+    subscriptions_.emplace(
+        handle, Subscription{station, comId, destIp, std::make_shared<const Receiver>(std::move(receiver))});
+    subscribersByKey_.emplace(subscriptionKey(comId, destIp), handle);
+    return handle;
+}
+
+bool VirtualWire::unsubscribe(Handle subscription)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = subscriptions_.find(subscription);
+    if (it == subscriptions_.end())
+    {
+        return false;
+    }
+    auto range = subscribersByKey_.equal_range(subscriptionKey(it->second.comId, it->second.destIp));
+    for (auto entry = range.first; entry != range.second; ++entry)
+    {
+        if (entry->second == subscription)
+        {
+            subscribersByKey_.erase(entry);
+            break;
+        }
+    }
+    subscriptions_.erase(it);
+    return true;
+}
+
+void VirtualWire::setReachable(TRDP_IP_ADDR_T hostIp, bool reachable)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (reachable)
+    {
+        unreachable_.erase(hostIp);
+    }
+    else
+    {
+        unreachable_.insert(hostIp);
+    }
+}
+
+void VirtualWire::setSending(Handle station, bool sending)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sending)
+    {
+        silent_.erase(station);
+    }
+    else if (stations_.count(station) != 0U)
+    {
+        silent_.insert(station);
+    }
+}
+
+std::vector<VirtualWire::Delivery> VirtualWire::collectDueLocked()
+{
+    std::vector<Delivery> deliveries;
+    std::vector<Handle> matches;
+    while (!schedule_.empty() && schedule_.begin()->first <= now_)
+    {
+        const auto handle = schedule_.begin()->second;
+        schedule_.erase(schedule_.begin());
+        auto &publication = publications_.at(handle);
+
+        // Cycles are kept on the original grid, like the stack's publisher timing.
+        publication.due += publication.interval;
+        schedule_.emplace(publication.due, handle);
+        if (silent_.count(publication.station) != 0U)
+        {
+            ++stats_.suppressed;
+            continue;
+        }
+
+        Delivery delivery{};
+        delivery.payload = publication.payload;
+        delivery.frame.comId = publication.comId;
+        delivery.frame.srcIp = publication.srcIp;
+        delivery.frame.destIp = publication.destIp;
+        delivery.frame.sequenceCounter = publication.sequenceCounter++;
+        ++publication.sent;
+        ++stats_.framesSent;
+
+        matches.clear();
+        auto range = subscribersByKey_.equal_range(subscriptionKey(publication.comId, publication.destIp));
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            matches.push_back(it->second);
+        }
+        // Hash order is not part of the contract; subscription order is.
+        std::sort(matches.begin(), matches.end());
+
+        const bool senderDown = unreachable_.count(publication.srcIp) != 0U;
+        for (const auto match : matches)
+        {
+            const auto &subscription = subscriptions_.at(match);
+            if (senderDown || unreachable_.count(stations_.at(subscription.station).hostIp) != 0U)
+            {
+                ++stats_.dropped;
+                continue;
+            }
+            delivery.receivers.push_back(subscription.receiver);
+        }
+        stats_.deliveries += delivery.receivers.size();
+        if (!delivery.receivers.empty())
+        {
+            deliveries.push_back(std::move(delivery));
+        }
+    }
+    return deliveries;
+}
+
+std::vector<std::function<void(VirtualWire::Clock::time_point)>> VirtualWire::stationTimers() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::function<void(Clock::time_point)>> timers;
+    timers.reserve(stations_.size());
+    for (const auto &entry : stations_)
+    {
+        if (entry.second.advance)
+        {
+            timers.push_back(entry.second.advance);
+        }
+    }
+    return timers;
+}
+
+std::optional<VirtualWire::Clock::time_point> VirtualWire::earliestStationDeadline() const
+{
+    std::vector<std::function<std::optional<Clock::time_point>()>> queries;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &entry : stations_)
+        {
+            if (entry.second.nextDeadline)
+            {
+                queries.push_back(entry.second.nextDeadline);
+            }
+        }
+    }
+
+    std::optional<Clock::time_point> earliest;
+    for (const auto &query : queries)
+    {
+        const auto deadline = query();
+        if (deadline && (!earliest || *deadline < *earliest))
+        {
+            earliest = deadline;
+        }
+    }
+    return earliest;
+}
+
+std::uint64_t VirtualWire::runUntil(Clock::time_point until)
+{
+    std::uint64_t delivered = 0U;
+    while (true)
+    {
+        // Station deadlines are queried without the wire lock: they take the sessions' own locks.
+        const auto deadline = earliestStationDeadline();
+
+        std::vector<Delivery> deliveries;
+        Clock::time_point at{};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::optional<Clock::time_point> next;
+            if (!schedule_.empty())
+            {
+                next = schedule_.begin()->first;
+            }
+            if (deadline && (!next || *deadline < *next))
+            {
+                next = std::max(*deadline, now_);
+            }
+            if (!next || *next > until)
+            {
+                break;
+            }
+            now_ = std::max(now_, *next);
+            at = now_;
+            deliveries = collectDueLocked();
+        }
+
+        for (const auto &delivery : deliveries)
+        {
+            auto frame = delivery.frame;
+            frame.payload = delivery.payload.get();
+            for (const auto &receiver : delivery.receivers)
+            {
+                (*receiver)(frame);
+                ++delivered;
+            }
+        }
+        for (const auto &timer : stationTimers())
+        {
+            timer(at);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        now_ = std::max(now_, until);
+    }
+    for (const auto &timer : stationTimers())
+    {
+        timer(until);
+    }
+    return delivered;
+}
+
+std::uint64_t VirtualWire::advance(std::chrono::microseconds duration)
+{
+    return runUntil(now() + duration);
+}
+
+VirtualWireStats VirtualWire::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::uint64_t VirtualWire::sentCount(Handle publication) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = publications_.find(publication);
+    return it != publications_.end() ? it->second.sent : 0U;
+}
+} // namespace trdp::runtime
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <trdp_if_light.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace trdp::runtime
+{
+/** One PD telegram as it travels over the virtual wire. */
+struct VirtualPdFrame
+{
+    std::uint32_t comId{0};
+    TRDP_IP_ADDR_T srcIp{0U};
+    TRDP_IP_ADDR_T destIp{0U};
+    std::uint32_t sequenceCounter{0};
+    const std::vector<std::uint8_t> *payload{nullptr};
+};
+
+struct VirtualWireStats
+{
+    std::uint64_t framesSent{0};
+    /** One per frame and receiving subscription. */
+    std::uint64_t deliveries{0};
+    /** Deliveries suppressed because the sender or the receiver was unreachable. */
+    std::uint64_t dropped{0};
+    /** Cycles that fell due while their station was not sending. */
+    std::uint64_t suppressed{0};
+};
+
+/**
+ * In-memory network with a simulated clock, standing in for UDP between TrdpSessions that are
+ * configured with it (TrdpSessionConfig::virtualWire).
+ *
+ * Nothing happens on its own: runUntil()/advance() move the clock forward and, in time order, send
+ * every cyclic publication that falls due, deliver it to the subscriptions of its destination
+ * address and let each attached session supervise its receive deadlines at exactly the simulated
+ * time they expire. Callbacks run on the caller's thread with no lock held, so hours of traffic
+ * replay in seconds and the same sequence of calls always yields the same sequence of events.
+ */
+class VirtualWire
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Handle = std::uint64_t;
+    using Receiver = std::function<void(const VirtualPdFrame &)>;
+
+    /** A session on the wire; `advance` runs its timers, `nextDeadline` says when they next expire. */
+    struct Station
+    {
+        TRDP_IP_ADDR_T hostIp{0U};
+        std::function<std::optional<Clock::time_point>()> nextDeadline;
+        std::function<void(Clock::time_point)> advance;
+    };
+
+    explicit VirtualWire(Clock::time_point start = Clock::now());
+
+    VirtualWire(const VirtualWire &) = delete;
+    VirtualWire &operator=(const VirtualWire &) = delete;
+
+    [[nodiscard]] Clock::time_point now() const;
+
+    Handle attach(Station station);
+    /** Removes the station with its publications and subscriptions. */
+    void detach(Handle station);
+
+    /** Cyclic publication; the first telegram goes out one interval from now, as with the stack. */
+    Handle publish(Handle station,
+                   std::uint32_t comId,
+                   TRDP_IP_ADDR_T destIp,
+                   std::chrono::microseconds interval,
+                   std::vector<std::uint8_t> payload);
+    bool unpublish(Handle publication);
+    /** Replaces the payload sent from the next cycle on. */
+    bool put(Handle publication, std::vector<std::uint8_t> payload);
+
+    /** Receives `comId` telegrams addressed to `destIp` (a host address or a multicast group). */
+    Handle subscribe(Handle station, std::uint32_t comId, TRDP_IP_ADDR_T destIp, Receiver receiver);
+    bool unsubscribe(Handle subscription);
+
+    /** Drops every telegram from or to `hostIp` while unreachable, e.g. to provoke receive timeouts. */
+    void setReachable(TRDP_IP_ADDR_T hostIp, bool reachable);
+
+    /**
+     * Suspends or resumes every publication of `station`, like redundancy followers on the stack:
+     * they stay on their cycle grid but send nothing, so the first cycle after resuming goes out.
+     */
+    void setSending(Handle station, bool sending);
+
+    /** Runs the network up to and including `until`; returns the number of frames delivered. */
+    std::uint64_t runUntil(Clock::time_point until);
+    std::uint64_t advance(std::chrono::microseconds duration);
+
+    [[nodiscard]] VirtualWireStats stats() const;
+    /** Telegrams `publication` has sent so far; 0 for an unknown handle. */
+    [[nodiscard]] std::uint64_t sentCount(Handle publication) const;
+
+private:
+    struct Publication
+    {
+        Handle station{0};
+        std::uint32_t comId{0};
+        TRDP_IP_ADDR_T srcIp{0U};
+        TRDP_IP_ADDR_T destIp{0U};
+        std::chrono::microseconds interval{0};
+        Clock::time_point due{};
+        std::uint32_t sequenceCounter{0};
+        std::uint64_t sent{0};
+        std::shared_ptr<const std::vector<std::uint8_t>> payload;
+    };
+
+    struct Subscription
+    {
+        Handle station{0};
+        std::uint32_t comId{0};
+        TRDP_IP_ADDR_T destIp{0U};
+        std::shared_ptr<const Receiver> receiver;
+    };
+
+    struct Delivery
+    {
+        VirtualPdFrame frame;
+        std::shared_ptr<const std::vector<std::uint8_t>> payload;
+        std::vector<std::shared_ptr<const Receiver>> receivers;
+    };
+
+    static std::uint64_t subscriptionKey(std::uint32_t comId, TRDP_IP_ADDR_T destIp)
+    {
+        return (static_cast<std::uint64_t>(comId) << 32U) | destIp;
+    }
+
+    std::vector<Delivery> collectDueLocked();
+    std::vector<std::function<void(Clock::time_point)>> stationTimers() const;
+    std::optional<Clock::time_point> earliestStationDeadline() const;
+
+    mutable std::mutex mutex_;
+    Clock::time_point now_;
+    Handle nextHandle_{1};
+    std::map<Handle, Station> stations_;
+    std::unordered_map<Handle, Publication> publications_;
+    /** Publications by due time; ties go by handle, i.e. in the order they were published. */
+    std::set<std::pair<Clock::time_point, Handle>> schedule_;
+    std::unordered_map<Handle, Subscription> subscriptions_;
+    std::unordered_multimap<std::uint64_t, Handle> subscribersByKey_;
+    std::unordered_set<TRDP_IP_ADDR_T> unreachable_;
+    std::unordered_set<Handle> silent_;
+    VirtualWireStats stats_{};
+};
+} // namespace trdp::runtime
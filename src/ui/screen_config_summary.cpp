@@ -8,12 +8,18 @@
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/event.hpp>
 #include <ftxui/dom/elements.hpp>
+#include <future>
 #include <mutex>
 #include <memory>
 #include <sstream>
 
 namespace trdp::ui
 {
+namespace
+{
+constexpr std::chrono::milliseconds kShutdownBudget{500};
+}
+
 void SimulatorRuntimeContext::shutdown()
 {
     if (shutdownRequested)
@@ -22,11 +28,96 @@ void SimulatorRuntimeContext::shutdown()
     }
 
     shutdownRequested = true;
+
+    if (control)
+    {
+        control->stop();
+    }
+    if (stateExport)
+    {
+        stateExport->stop();
+    }
+
+    // The scenario must not start publishers while their sessions are torn down.
+    if (scenario)
+    {
+        scenario->stop();
+        std::string error;
+        if (!scenarioReportPath.empty() && !scenario->writeReport(scenarioReportPath, error))
+        {
+            util::logWarn(error);
+        }
+    }
+
+    for (auto &generator : rawGenerators)
+    {
+        generator->stop();
+    }
+
+    // Every session releases its handles on its own process thread; all of them share one deadline.
+    const auto deadline = std::chrono::steady_clock::now() + kShutdownBudget;
+    for (auto &shard : shards)
+    {
+        shard->requestShutdown();
+    }
+    std::vector<std::future<runtime::PdTeardownReport>> teardowns;
+    teardowns.reserve(sessions.size());
+    for (auto &session : sessions)
+    {
+        teardowns.push_back(session ? session->requestTeardown() : std::future<runtime::PdTeardownReport>{});
+    }
+
+    for (std::size_t i = 0; i < sessions.size(); ++i)
+    {
+        if (!sessions[i])
+        {
+            continue;
+        }
+
+        const auto report = sessions[i]->awaitTeardown(teardowns[i], deadline);
+        if (!report.complete())
+        {
+            std::ostringstream oss;
+            oss << "Teardown on " << sessions[i]->hostIpString() << (report.timedOut ? " hit the shutdown deadline" : " failed")
+                << "; unreleased publishers:";
+            for (const auto comId : report.failedPublishers)
+            {
+                oss << ' ' << comId;
+            }
+            oss << "; unreleased subscriptions:";
+            for (const auto comId : report.failedSubscribers)
+            {
+                oss << ' ' << comId;
+            }
+            util::logWarn(oss.str());
+        }
+    }
+
     for (auto &row : pdRows)
     {
         if (row.runtime)
         {
-            row.runtime->stopPublishing();
+            row.runtime->detachPublisher();
+        }
+    }
+
+    const auto memory = stackMemory ? stackMemory->sample() : std::nullopt;
+    if (memory)
+    {
+        std::ostringstream oss;
+        oss << "TRDP pool high water " << memory->highWater << " of " << memory->total << " bytes";
+        if (memory->allocErrors != 0U)
+        {
+            oss << "; " << memory->allocErrors << " allocation error(s)";
+        }
+        util::logInfo(oss.str());
+    }
+
+    for (auto &session : sessions)
+    {
+        if (session && !session->isVirtual())
+        {
+            util::logInfo("Process loop " + session->hostIpString() + ": " + session->processLoopStats().summary());
         }
     }
 
@@ -37,6 +128,50 @@ void SimulatorRuntimeContext::shutdown()
             session->close();
         }
     }
+
+    if (recorder)
+    {
+        recorder->close();
+        util::logInfo("Recording " + recorder->path() + ": " + recorder->stats().summary());
+    }
+    if (valueExport)
+    {
+        valueExport->close();
+        util::logInfo("Export " + valueExport->directory() + ": " + valueExport->stats().summary());
+    }
+
+    // Workers tear down in parallel with the local sessions; by now most of them have exited.
+    for (auto &shard : shards)
+    {
+        shard->awaitExit(deadline);
+    }
+}
+
+std::size_t SimulatorRuntimeContext::setPaused(bool paused, const std::string &interfaceName)
+{
+    std::size_t addressed = 0U;
+    for (std::size_t i = 0; i < sessions.size(); ++i)
+    {
+        if (sessions[i] && (interfaceName.empty() || sessionInterfaces[i] == interfaceName))
+        {
+            sessions[i]->setPaused(paused);
+            ++addressed;
+        }
+    }
+    for (auto &shard : shards)
+    {
+        if ((interfaceName.empty() || shard->interfaceName() == interfaceName) && shard->setPaused(paused))
+        {
+            ++addressed;
+        }
+    }
+    return addressed;
+}
+
+bool SimulatorRuntimeContext::anyPaused() const
+{
+    const auto paused = [](const auto &entry) { return entry && entry->isPaused(); };
+    return std::any_of(sessions.begin(), sessions.end(), paused) || std::any_of(shards.begin(), shards.end(), paused);
 }
 
 void SimulatorRuntimeContext::appendSubscriberLog(std::string entry)
@@ -55,6 +190,30 @@ std::vector<std::string> SimulatorRuntimeContext::snapshotSubscriberLog() const
     return subscriberLog;
 }
 
+StartupMetrics SimulatorRuntimeContext::startupMetrics() const
+{
+    StartupMetrics metrics{};
+    metrics.begin = startupBegin;
+    metrics.sessionsReady = sessionsReady;
+    for (const auto &session : sessions)
+    {
+        const auto first = session ? session->firstPdReceiveTime() : std::nullopt;
+        if (first && (!metrics.firstTelegram || *first - startupBegin < *metrics.firstTelegram))
+        {
+            metrics.firstTelegram = *first - startupBegin;
+        }
+    }
+    for (const auto &shard : shards)
+    {
+        const auto first = shard->firstPdReceiveTime();
+        if (first && (!metrics.firstTelegram || *first - startupBegin < *metrics.firstTelegram))
+        {
+            metrics.firstTelegram = *first - startupBegin;
+        }
+    }
+    return metrics;
+}
+
 SimulatorRuntimeContext::~SimulatorRuntimeContext()
 {
     shutdown();
@@ -135,8 +294,12 @@ ftxui::Component MakeConfigSummaryScreen(const config::SimulatorConfigLoadResult
 {
     using namespace ftxui; // NOLINT
 
+    // Suspends every session in place, so resuming costs no re-registration.
+    auto pauseButton = Button("Pause/resume all traffic", [runtime] { runtime->setPaused(!runtime->anyPaused()); });
+
     std::vector<Component> controlRows;
-    controlRows.reserve(runtime->pdRows.size());
+    controlRows.reserve(runtime->pdRows.size() + 1U);
+    controlRows.push_back(pauseButton);
     for (auto &row : runtime->pdRows)
     {
         controlRows.push_back(row.rowRenderer);
@@ -144,7 +307,7 @@ ftxui::Component MakeConfigSummaryScreen(const config::SimulatorConfigLoadResult
 
     auto controlContainer = Container::Vertical(controlRows);
 
-    auto summaryRenderer = Renderer(controlContainer, [result, sourcePath, runtime, controlContainer] {
+    auto summaryRenderer = Renderer(controlContainer, [result, sourcePath, runtime, controlContainer, pauseButton] {
         std::vector<Element> sections;
         sections.push_back(text("Configuration source: " + sourcePath));
         sections.push_back(text("Press 'q' or Esc to quit") | color(Color::Yellow));
@@ -170,6 +333,9 @@ ftxui::Component MakeConfigSummaryScreen(const config::SimulatorConfigLoadResult
         }
 
         std::vector<Element> controlRenders;
+        controlRenders.push_back(
+            hbox({pauseButton->Render(),
+                  text(runtime->anyPaused() ? " PAUSED: nothing is sent or dispatched" : "") | color(Color::Yellow)}));
         if (runtime->pdRows.empty())
         {
             controlRenders.push_back(text("No PD telegrams available."));
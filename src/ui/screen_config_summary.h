@@ -1,35 +1,81 @@
 #pragma once
 
 #include "config/xml_loader.h"
+#include "control/control_server.h"
+#include "record/value_export.h"
+#include "scenario/scenario_runner.h"
+#include "shard/shard_process.h"
+#include "shard/state_export.h"
 #include "trdp/pd_endpoint.h"
+#include "trdp/raw_pd_generator.h"
+#include "trdp/realtime_profile.h"
+#include "trdp/stack_memory.h"
 #include "trdp/trdp_session.h"
 
 #include <ftxui/component/component.hpp>
+#include <chrono>
 #include <functional>
 #include <mutex>
+#include <optional>
 
 namespace trdp::ui
 {
 struct PdControlRow
 {
     model::TelegramConfig config;
-    std::shared_ptr<runtime::PdEndpointRuntime> runtime;
+    std::string interfaceName;
+    std::shared_ptr<runtime::PdEndpointControl> runtime;
     std::shared_ptr<std::string> cycleInput;
     std::shared_ptr<std::string> txInput;
     ftxui::Component rowRenderer;
 };
 
+struct StartupMetrics
+{
+    std::chrono::steady_clock::time_point begin{std::chrono::steady_clock::now()};
+    std::chrono::steady_clock::duration sessionsReady{};
+    std::optional<std::chrono::steady_clock::duration> firstTelegram;
+};
+
 struct SimulatorRuntimeContext
 {
     std::vector<std::shared_ptr<runtime::TrdpSession>> sessions;
+    /** Interface name of each entry of `sessions`. */
+    std::vector<std::string> sessionInterfaces;
+    /** Worker processes in sharded mode; `sessions` is empty then. */
+    std::vector<std::shared_ptr<shard::ShardProcess>> shards;
+    std::shared_ptr<runtime::StackMemoryMonitor> stackMemory;
+    std::vector<std::shared_ptr<runtime::RawPdGenerator>> rawGenerators;
+    /** `--record` writer shared by the local sessions; workers in sharded mode record themselves. */
+    std::shared_ptr<record::RecordingWriter> recorder;
+    /** `--export` of decoded RX values, fed by the subscription sinks. */
+    std::shared_ptr<record::ValueExporter> valueExport;
+    /** `--scenario` run; shutdown() stops it first and writes its report to `scenarioReportPath`. */
+    std::shared_ptr<scenario::ScenarioRunner> scenario;
+    std::string scenarioReportPath;
+    /** `--control` socket; shutdown() closes it before anything else. */
+    std::shared_ptr<control::ControlServer> control;
+    /** `--state-export` segment, removed by shutdown() together with the control socket. */
+    std::shared_ptr<shard::StateExport> stateExport;
+    std::optional<runtime::RealtimeSettingStatus> uiIsolation;
+    std::chrono::steady_clock::time_point startupBegin{std::chrono::steady_clock::now()};
+    std::chrono::steady_clock::duration sessionsReady{};
     std::vector<PdControlRow> pdRows;
     std::vector<std::string> subscriberLog;
     mutable std::mutex subscriberMutex;
     bool shutdownRequested{false};
 
     void shutdown();
+    /**
+     * Pauses or resumes the session of `interfaceName`, or every session if it is empty, keeping all
+     * handles; see runtime::TrdpSession::setPaused(). Returns how many sessions were addressed.
+     */
+    std::size_t setPaused(bool paused, const std::string &interfaceName = {});
+    /** True while any session or worker is paused. */
+    [[nodiscard]] bool anyPaused() const;
     void appendSubscriberLog(std::string entry);
     std::vector<std::string> snapshotSubscriberLog() const;
+    StartupMetrics startupMetrics() const;
     ~SimulatorRuntimeContext();
 };
 
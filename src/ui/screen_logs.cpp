@@ -0,0 +1,208 @@
+#include "ui/screen_logs.h"
+
+#include <ftxui/component/event.hpp>
+#include <ftxui/dom/elements.hpp>
+#include <ftxui/screen/terminal.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace trdp::ui
+{
+namespace
+{
+/** Rows taken by the frame, the filter line and the key help. */
+constexpr int kChromeRows = 8;
+
+struct LogsViewState
+{
+    util::LogFilter filter;
+    /** kLive follows new messages; otherwise the view stays put at this sequence number. */
+    std::uint64_t anchor{util::LogStore::kLive};
+    std::size_t skip{0};
+    /** Matches behind the anchor at the last render, to stop scrolling at the oldest. */
+    std::uint64_t lastTotal{0};
+    bool exactTotal{true};
+};
+
+std::size_t visibleRows()
+{
+    return static_cast<std::size_t>(std::max(ftxui::Terminal::Size().dimy - kChromeRows, 5));
+}
+
+void follow(LogsViewState &state)
+{
+    state.anchor = util::LogStore::kLive;
+    state.skip = 0U;
+}
+
+void scrollBack(LogsViewState &state, const util::LogStore &store, std::size_t rows, std::size_t pageRows)
+{
+    if (state.anchor == util::LogStore::kLive)
+    {
+        state.anchor = store.nextSequence();
+    }
+    state.skip += rows;
+    // Stop where the oldest match fills the last row; combined filters only know a lower bound.
+    if (state.exactTotal)
+    {
+        state.skip = std::min<std::size_t>(state.skip, state.lastTotal > pageRows ? state.lastTotal - pageRows : 0U);
+    }
+}
+
+void scrollForward(LogsViewState &state, std::size_t rows)
+{
+    if (state.skip <= rows)
+    {
+        follow(state);
+        return;
+    }
+    state.skip -= rows;
+}
+
+template <typename T>
+T nextOf(const std::vector<T> &values, const T &current, const T &none)
+{
+    const auto it = std::find(values.begin(), values.end(), current);
+    if (current == none || it == values.end())
+    {
+        return values.empty() ? none : values.front();
+    }
+    return std::next(it) == values.end() ? none : *std::next(it);
+}
+
+std::string timeOfDay(std::chrono::system_clock::time_point time)
+{
+    const auto stamp = util::formatTimestamp(time);
+    const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+    std::ostringstream oss;
+    oss << stamp.substr(stamp.size() > 8U ? stamp.size() - 8U : 0U) << '.' << std::setw(3) << std::setfill('0') << millis;
+    return oss.str();
+}
+
+ftxui::Element BuildLogRow(const util::LogEntry &entry)
+{
+    using namespace ftxui; // NOLINT
+
+    auto level = text(util::logLevelName(entry.level)) | size(WIDTH, EQUAL, 6);
+    switch (entry.level)
+    {
+    case util::LogLevel::Error:
+        level = level | color(Color::Red);
+        break;
+    case util::LogLevel::Warn:
+        level = level | color(Color::Yellow);
+        break;
+    case util::LogLevel::Debug:
+        level = level | dim;
+        break;
+    case util::LogLevel::Info:
+        break;
+    }
+    return hbox({
+        text(timeOfDay(entry.time)) | size(WIDTH, EQUAL, 13),
+        level,
+        text(entry.session) | size(WIDTH, EQUAL, 16),
+        text(entry.comId != 0U ? std::to_string(entry.comId) : "") | size(WIDTH, EQUAL, 8),
+        text(entry.message) | flex,
+    });
+}
+} // namespace
+
+ftxui::Component MakeLogsScreen(const std::shared_ptr<util::LogStore> &store)
+{
+    using namespace ftxui; // NOLINT
+
+    if (!store)
+    {
+        return Renderer([] { return window(text("Logs"), text("No log store attached.")); });
+    }
+
+    auto state = std::make_shared<LogsViewState>();
+    auto view = Renderer([store, state](bool focused) {
+        const auto rows = visibleRows();
+        auto page = store->query(state->filter, state->anchor, state->skip, rows);
+        state->lastTotal = page.total;
+        state->exactTotal = page.exactTotal;
+
+        std::vector<Element> lines;
+        for (const auto &entry : page.entries)
+        {
+            lines.push_back(BuildLogRow(entry));
+        }
+        if (lines.empty())
+        {
+            lines.push_back(text("No matching messages.") | dim);
+        }
+
+        const auto &filter = state->filter;
+        const auto position = state->anchor == util::LogStore::kLive
+                                  ? std::string("following")
+                                  : "scrolled back " + std::to_string(state->skip);
+        auto header = hbox({
+            text(std::string("level >= ") + util::logLevelName(filter.minLevel)) | size(WIDTH, EQUAL, 16),
+            text("session " + (filter.session.empty() ? std::string("all") : filter.session)) | size(WIDTH, EQUAL, 24),
+            text("ComID " + (filter.comId == 0U ? std::string("all") : std::to_string(filter.comId))) |
+                size(WIDTH, EQUAL, 16),
+            text(std::to_string(page.total) + (page.exactTotal ? "" : "+") + " matching of " +
+                 std::to_string(store->size())),
+            filler(),
+            text(position),
+        });
+        auto help = text("l level  s session  c ComID  x clear  Up/Down PgUp/PgDn Home  End follow") | dim;
+        auto title = text(focused ? "Logs (active)" : "Logs (Right arrow to focus)");
+        return window(title, vbox({header, separator(), vbox(std::move(lines)) | flex, separator(), help}));
+    });
+
+    return CatchEvent(view, [store, state](const Event &event) {
+        const auto page = visibleRows();
+        auto &filter = state->filter;
+        if (event == Event::Character('l'))
+        {
+            filter.minLevel = static_cast<util::LogLevel>((static_cast<int>(filter.minLevel) + 1) % 4);
+        }
+        else if (event == Event::Character('s'))
+        {
+            filter.session = nextOf(store->sessions(), filter.session, std::string{});
+        }
+        else if (event == Event::Character('c'))
+        {
+            filter.comId = nextOf(store->comIds(), filter.comId, std::uint32_t{0U});
+        }
+        else if (event == Event::Character('x'))
+        {
+            filter = util::LogFilter{};
+        }
+        else if (event == Event::ArrowUp || event == Event::PageUp)
+        {
+            scrollBack(*state, *store, event == Event::PageUp ? page : 1U, page);
+            return true;
+        }
+        else if (event == Event::ArrowDown || event == Event::PageDown)
+        {
+            scrollForward(*state, event == Event::PageDown ? page : 1U);
+            return true;
+        }
+        else if (event == Event::Home)
+        {
+            scrollBack(*state, *store, static_cast<std::size_t>(state->lastTotal), page);
+            return true;
+        }
+        else if (event == Event::End)
+        {
+            follow(*state);
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+        // A new filter starts again at the newest match.
+        follow(*state);
+        return true;
+    });
+}
+} // namespace trdp::ui
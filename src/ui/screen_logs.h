@@ -0,0 +1,12 @@
+#pragma once
+
+#include "util/log_store.h"
+
+#include <ftxui/component/component.hpp>
+#include <memory>
+
+namespace trdp::ui
+{
+/** Logs page: messages kept by `store`, filtered by level, session and ComID, following the newest or scrolled. */
+ftxui::Component MakeLogsScreen(const std::shared_ptr<util::LogStore> &store);
+} // namespace trdp::ui
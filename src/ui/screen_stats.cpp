@@ -0,0 +1,307 @@
+#include "ui/screen_stats.h"
+
+#include <ftxui/dom/elements.hpp>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace trdp::ui
+{
+namespace
+{
+std::string formatBytes(std::uint32_t bytes)
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << static_cast<double>(bytes) / 1024.0 << " KiB";
+    return oss.str();
+}
+
+std::string formatShare(std::uint32_t part, std::uint32_t total)
+{
+    if (total == 0U)
+    {
+        return "-";
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << 100.0 * static_cast<double>(part) / static_cast<double>(total) << " %";
+    return oss.str();
+}
+
+ftxui::Element BuildMemoryPanel(runtime::StackMemoryMonitor &monitor)
+{
+    using namespace ftxui; // NOLINT
+
+    std::vector<Element> rows;
+    rows.push_back(text("Plan: " + monitor.plan().describe()));
+
+    const auto snapshot = monitor.sample();
+    if (!snapshot)
+    {
+        rows.push_back(text("Pool statistics unavailable (stack not initialized)") | color(Color::Yellow));
+        return window(text("TRDP memory"), vbox(rows));
+    }
+
+    rows.push_back(text("Pool size:   " + formatBytes(snapshot->total)));
+    rows.push_back(text("In use:      " + formatBytes(snapshot->used) + " (" + formatShare(snapshot->used, snapshot->total) + ")"));
+    rows.push_back(text("High water:  " + formatBytes(snapshot->highWater) + " (" +
+                        formatShare(snapshot->highWater, snapshot->total) + ")"));
+    rows.push_back(text("Blocks:      " + std::to_string(snapshot->allocatedBlocks)));
+    auto errors = text("Alloc/free errors: " + std::to_string(snapshot->allocErrors) + " / " +
+                       std::to_string(snapshot->freeErrors));
+    rows.push_back(snapshot->allocErrors != 0U ? errors | color(Color::Red) : errors);
+    rows.push_back(separator());
+
+    std::vector<std::vector<std::string>> table{{"Block size", "Used", "Peak", "Preallocated"}};
+    for (const auto &block : snapshot->blocks)
+    {
+        if (block.used == 0U && block.peak == 0U && block.preallocated == 0U)
+        {
+            continue;
+        }
+        table.push_back({std::to_string(block.blockSize), std::to_string(block.used), std::to_string(block.peak),
+                         std::to_string(block.preallocated)});
+    }
+
+    std::vector<Element> tableRows;
+    for (const auto &line : table)
+    {
+        std::vector<Element> cells;
+        for (const auto &cell : line)
+        {
+            cells.push_back(text(cell) | size(WIDTH, EQUAL, 14));
+        }
+        tableRows.push_back(hbox(std::move(cells)));
+    }
+    rows.push_back(vbox(std::move(tableRows)));
+
+    return window(text("TRDP memory"), vbox(rows));
+}
+
+ftxui::Element BuildSettingRow(const std::string &label, const runtime::RealtimeSettingStatus &status)
+{
+    using namespace ftxui; // NOLINT
+    return hbox({
+        text(label) | size(WIDTH, EQUAL, 18),
+        text(status.setting + " " + status.requested) | size(WIDTH, EQUAL, 40),
+        text(status.applied ? " applied " : " not applied ") |
+            color(status.applied ? Color::Green : Color::Red),
+        text(" " + status.detail),
+    });
+}
+
+ftxui::Element BuildRealtimePanel(const SimulatorRuntimeContext &runtime)
+{
+    using namespace ftxui; // NOLINT
+
+    std::vector<Element> rows;
+    for (const auto &session : runtime.sessions)
+    {
+        if (!session)
+        {
+            continue;
+        }
+
+        const auto report = session->realtimeReport();
+        if (report.settings.empty())
+        {
+            rows.push_back(hbox({text(session->hostIpString()) | size(WIDTH, EQUAL, 18), text("default scheduling")}));
+        }
+        for (const auto &status : report.settings)
+        {
+            rows.push_back(BuildSettingRow(session->hostIpString(), status));
+        }
+    }
+    if (runtime.uiIsolation)
+    {
+        rows.push_back(BuildSettingRow("UI threads", *runtime.uiIsolation));
+    }
+    if (rows.empty())
+    {
+        rows.push_back(text("No TRDP sessions running."));
+    }
+
+    return window(text("Real-time profile"), vbox(rows));
+}
+ftxui::Element BuildRawGeneratorPanel(const SimulatorRuntimeContext &runtime)
+{
+    using namespace ftxui; // NOLINT
+
+    std::vector<Element> rows;
+    for (const auto &generator : runtime.rawGenerators)
+    {
+        const auto stats = generator->stats();
+        const auto perBatch = stats.batches != 0U ? stats.framesSent / stats.batches : 0U;
+        auto errors = text("errors " + std::to_string(stats.sendErrors)) | size(WIDTH, EQUAL, 14);
+        rows.push_back(hbox({
+            text(generator->settings().sourceIp) | size(WIDTH, EQUAL, 18),
+            text("streams " + std::to_string(stats.streams)) | size(WIDTH, EQUAL, 14),
+            text("sent " + std::to_string(stats.framesSent)) | size(WIDTH, EQUAL, 18),
+            text("~" + std::to_string(perBatch) + "/batch") | size(WIDTH, EQUAL, 12),
+            stats.sendErrors != 0U ? errors | color(Color::Red) : errors,
+            text("skipped " + std::to_string(stats.skippedCycles)) | size(WIDTH, EQUAL, 16),
+            text(stats.txTimeActive ? "SO_TXTIME" : "unpaced"),
+        }));
+    }
+    return window(text("Raw PD generator"), vbox(rows));
+}
+
+ftxui::Element BuildSupervisionPanel(const SimulatorRuntimeContext &runtime)
+{
+    using namespace ftxui; // NOLINT
+
+    std::vector<Element> rows;
+    for (const auto &session : runtime.sessions)
+    {
+        if (!session)
+        {
+            continue;
+        }
+
+        const auto stats = session->pdSupervisionStats();
+        auto lost = text("lost now " + std::to_string(stats.lost)) | size(WIDTH, EQUAL, 14);
+        rows.push_back(hbox({
+            text(session->hostIpString()) | size(WIDTH, EQUAL, 18),
+            text("watched " + std::to_string(stats.watched)) | size(WIDTH, EQUAL, 14),
+            stats.lost != 0U ? lost | color(Color::Red) : lost,
+            text("timeouts " + std::to_string(stats.lostEvents)) | size(WIDTH, EQUAL, 16),
+            text("recoveries " + std::to_string(stats.recoveredEvents)),
+        }));
+    }
+    if (rows.empty())
+    {
+        rows.push_back(text("No TRDP sessions running."));
+    }
+
+    return window(text("PD receive supervision"), vbox(rows));
+}
+
+std::string percentOf(std::uint64_t part, std::uint64_t whole)
+{
+    return std::to_string(whole == 0U ? 0U : part * 100U / whole) + "%";
+}
+
+ftxui::Element BuildProcessLoopPanel(const SimulatorRuntimeContext &runtime)
+{
+    using namespace ftxui; // NOLINT
+
+    std::vector<Element> rows;
+    rows.push_back(hbox({
+                       text("session") | size(WIDTH, EQUAL, 18),
+                       text("wakes") | size(WIDTH, EQUAL, 10),
+                       text("timeout/socket/cmd/spur") | size(WIDTH, EQUAL, 26),
+                       text("lag p50/p99/max us") | size(WIDTH, EQUAL, 22),
+                       text("tlc_process p50/p99/max us") | size(WIDTH, EQUAL, 28),
+                       text("ready/wake"),
+                   }) |
+                   bold);
+    for (const auto &session : runtime.sessions)
+    {
+        if (!session || session->isVirtual())
+        {
+            continue;
+        }
+
+        const auto stats = session->processLoopStats();
+        const auto triple = [](const util::LogHistogram &histogram) {
+            return std::to_string(histogram.percentile(0.5)) + "/" + std::to_string(histogram.percentile(0.99)) + "/" +
+                   std::to_string(histogram.max());
+        };
+        std::ostringstream ready;
+        ready << std::fixed << std::setprecision(1) << stats.readyDescriptors.mean() << " (max "
+              << stats.readyDescriptors.max() << ')';
+        rows.push_back(hbox({
+            text(session->hostIpString()) | size(WIDTH, EQUAL, 18),
+            text(std::to_string(stats.wakes)) | size(WIDTH, EQUAL, 10),
+            text(percentOf(stats.timeoutWakes, stats.wakes) + "/" + percentOf(stats.socketWakes, stats.wakes) + "/" +
+                 percentOf(stats.commandWakes, stats.wakes) + "/" + percentOf(stats.spuriousWakes, stats.wakes)) |
+                size(WIDTH, EQUAL, 26),
+            text(triple(stats.wakeupLagUs)) | size(WIDTH, EQUAL, 22),
+            text(triple(stats.processUs)) | size(WIDTH, EQUAL, 28),
+            text(ready.str()),
+        }));
+    }
+    if (rows.size() == 1U)
+    {
+        rows.push_back(text("No TRDP process loops running."));
+    }
+
+    return window(text("Process loop"), vbox(rows));
+}
+
+std::string workerStateLabel(shard::WorkerState state)
+{
+    switch (state)
+    {
+    case shard::WorkerState::Starting:
+        return "starting";
+    case shard::WorkerState::Running:
+        return "running";
+    case shard::WorkerState::Failed:
+        return "session failed";
+    case shard::WorkerState::Stopped:
+    default:
+        return "stopped";
+    }
+}
+
+ftxui::Element BuildShardPanel(const SimulatorRuntimeContext &runtime)
+{
+    using namespace ftxui; // NOLINT
+
+    std::vector<Element> rows;
+    for (const auto &shard : runtime.shards)
+    {
+        const auto status = shard->status();
+        std::string heartbeat = "no heartbeat";
+        if (status.heartbeatAge)
+        {
+            heartbeat = "heartbeat " +
+                        std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(*status.heartbeatAge).count()) +
+                        " ms ago";
+        }
+        const bool healthy = status.running && status.state == shard::WorkerState::Running;
+        auto state = text(status.running ? workerStateLabel(status.state) : status.exitDetail) | size(WIDTH, EQUAL, 28);
+        rows.push_back(hbox({
+            text(status.interfaceName) | size(WIDTH, EQUAL, 18),
+            text("pid " + std::to_string(status.pid)) | size(WIDTH, EQUAL, 12),
+            healthy ? state | color(Color::Green) : state | color(Color::Red),
+            text(heartbeat) | size(WIDTH, EQUAL, 24),
+            text("commands " + std::to_string(status.commandsApplied) + "/" + std::to_string(status.commandsSent)) |
+                size(WIDTH, EQUAL, 18),
+            text("dropped " + std::to_string(status.commandsDropped)),
+        }));
+    }
+    return window(text("Shard workers"), vbox(rows));
+}
+} // namespace
+
+ftxui::Component MakeStatsScreen(const std::shared_ptr<SimulatorRuntimeContext> &runtime)
+{
+    using namespace ftxui; // NOLINT
+    return Renderer([runtime] {
+        std::vector<Element> sections;
+        if (runtime && !runtime->shards.empty())
+        {
+            sections.push_back(BuildShardPanel(*runtime));
+        }
+        if (runtime && runtime->stackMemory)
+        {
+            sections.push_back(BuildRealtimePanel(*runtime));
+            sections.push_back(BuildSupervisionPanel(*runtime));
+            sections.push_back(BuildProcessLoopPanel(*runtime));
+            if (!runtime->rawGenerators.empty())
+            {
+                sections.push_back(BuildRawGeneratorPanel(*runtime));
+            }
+            sections.push_back(BuildMemoryPanel(*runtime->stackMemory));
+        }
+        else if (sections.empty())
+        {
+            sections.push_back(text("No runtime statistics available."));
+        }
+        return vbox(sections) | yframe | flex;
+    });
+}
+} // namespace trdp::ui
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "ui/screen_config_summary.h"
+
+#include <ftxui/component/component.hpp>
+#include <memory>
+
+namespace trdp::ui
+{
+/** Stats panel: shard workers, real-time profile status per session and TRDP stack memory pool usage. */
+ftxui::Component MakeStatsScreen(const std::shared_ptr<SimulatorRuntimeContext> &runtime);
+} // namespace trdp::ui
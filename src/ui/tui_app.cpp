@@ -1,13 +1,23 @@
 #include "ui/tui_app.h"
 
+#include "control/control_server.h"
+#include "scenario/scenario_runner.h"
+#include "shard/shard_process.h"
+#include "trdp/interface_bringup.h"
 #include "ui/screen_config_summary.h"
+#include "ui/screen_logs.h"
+#include "ui/screen_stats.h"
 #include "util/logging.h"
+#include "util/trace.h"
 
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/event.hpp>
 #include <ftxui/dom/elements.hpp>
 #include <cctype>
+#include <csignal>
+#include <chrono>
 #include <cstdint>
+#include <future>
 #include <memory>
 #include <algorithm>
 #include <iomanip>
@@ -102,10 +112,19 @@ std::string directionLabel(runtime::PdDirection direction)
     }
 }
 
-ftxui::Component BuildDashboard(const config::SimulatorConfigLoadResult &result, const std::string &sourcePath)
+std::string formatDuration(std::chrono::steady_clock::duration duration)
 {
-    using namespace ftxui; // NOLINT
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << static_cast<double>(us) / 1000.0 << " ms";
+    return oss.str();
+}
 
+ftxui::Component BuildDashboard(const config::SimulatorConfigLoadResult &result,
+                                const std::string &sourcePath,
+                                const std::shared_ptr<SimulatorRuntimeContext> &context)
+{
+    using namespace ftxui; // NOLINT
     const auto summaryText = [&]() {
         std::vector<Element> rows;
         const auto telegramCount = std::accumulate(
@@ -123,8 +142,14 @@ ftxui::Component BuildDashboard(const config::SimulatorConfigLoadResult &result,
         return rows;
     }();
 
-    return Renderer([summaryText] {
-        return vbox({window(text("Dashboard"), vbox(summaryText)) | flex});
+    return Renderer([summaryText, context] {
+        const auto metrics = context->startupMetrics();
+        std::vector<Element> startupRows;
+        startupRows.push_back(text("Sessions ready after:   " + formatDuration(metrics.sessionsReady)));
+        startupRows.push_back(text("Time to first telegram: " +
+                                   (metrics.firstTelegram ? formatDuration(*metrics.firstTelegram) : std::string("waiting"))));
+
+        return vbox({window(text("Dashboard"), vbox(summaryText)) | flex, window(text("Startup"), vbox(startupRows))});
     });
 }
 
@@ -141,162 +166,436 @@ ftxui::Component BuildPlaceholderPanel(const std::string &title, const std::stri
     });
 }
 
-std::shared_ptr<SimulatorRuntimeContext> BuildRuntimeContext(const config::SimulatorConfigLoadResult &result)
+PdControlRow BuildPdControlRow(const model::TelegramConfig &telegram,
+                               const std::string &interfaceName,
+                               const std::shared_ptr<runtime::PdEndpointControl> &runtime)
 {
-    auto context = std::make_shared<SimulatorRuntimeContext>();
+    const auto configuredCycle = runtime->configuredCycle();
+    auto cycleInput = std::make_shared<std::string>(std::to_string(configuredCycle ? configuredCycle->count() : 1000000));
+    auto cycleInputComponent = ftxui::Input(cycleInput.get(), "cycle µs");
+    auto txInput = std::make_shared<std::string>(bytesToHex(runtime->txPayload()));
+    auto txInputComponent = ftxui::Input(txInput.get(), "TX payload (hex bytes or text)");
+
+    auto startButton = ftxui::Button("Start", [runtime, cycleInput] {
+        if (!runtime->canTransmit())
+        {
+            return;
+        }
 
-    for (const auto &iface : result.config.interfaces)
+        const auto us = std::max(1L, std::strtol(cycleInput->c_str(), nullptr, 10));
+        runtime->startPublishing(std::chrono::microseconds(us));
+    });
+    auto stopButton = ftxui::Button("Stop", [runtime] { runtime->stopPublishing(); });
+    auto applyTxButton = ftxui::Button("Apply TX", [runtime, txInput] {
+        if (!runtime->canTransmit())
+        {
+            return;
+        }
+
+        runtime->setTxPayload(parseHexOrAscii(*txInput));
+    });
+
+    auto controls = ftxui::Container::Horizontal({cycleInputComponent, startButton, stopButton});
+    auto txControls = ftxui::Container::Horizontal({txInputComponent, applyTxButton});
+
+    auto rowRenderer = ftxui::Renderer(ftxui::Container::Vertical({controls, txControls}),
+                                       [runtime, telegram, controls, txControls]() -> ftxui::Element {
+                                           const auto lastPublish = runtime->lastPublishTime();
+                                           const auto lastReceive = runtime->lastReceiveTime();
+                                           auto fixedSize = runtime->fixedPayloadSize();
+
+                                           auto statusBadge = ftxui::text(runtime->isPublishing() ? " RUNNING " : " STOPPED ") |
+                                                             ftxui::bgcolor(runtime->isPublishing()
+                                                                                ? ftxui::Color::Green
+                                                                                : ftxui::Color::Red) |
+                                                             ftxui::color(ftxui::Color::Black);
+
+                                           std::string txStatus = runtime->isPublishing() ? "Publishing" : "Stopped";
+                                           if (lastPublish)
+                                           {
+                                               txStatus += " | last TX: " + util::formatTimestamp(*lastPublish);
+                                           }
+                                           txStatus += " | tx count: " + std::to_string(runtime->publishCount());
+                                           if (runtime->destinationCount() > 1U)
+                                           {
+                                               txStatus += " | " + std::to_string(runtime->destinationCount()) +
+                                                           " destinations";
+                                           }
+                                           if (fixedSize)
+                                           {
+                                               txStatus += " | fixed payload " + std::to_string(*fixedSize) +
+                                                           " bytes";
+                                           }
+
+                                           std::string rxStatus = "RX count: " + std::to_string(runtime->receiveCount());
+                                           if (lastReceive)
+                                           {
+                                               rxStatus += " | last RX: " + util::formatTimestamp(*lastReceive);
+                                           }
+                                           if (runtime->isLinkLost())
+                                           {
+                                               rxStatus += " | LOST";
+                                           }
+                                           if (runtime->linkLostCount() != 0U)
+                                           {
+                                               rxStatus += " | timeouts: " + std::to_string(runtime->linkLostCount());
+                                           }
+
+                                           const auto direction = runtime->direction();
+                                           const auto directionText = directionLabel(direction);
+                                           auto directionBadge = ftxui::text(" " + directionText + " ") |
+                                                                 ftxui::bgcolor(direction == runtime::PdDirection::Loopback
+                                                                                    ? ftxui::Color::Yellow
+                                                                                    : direction == runtime::PdDirection::Outgoing
+                                                                                        ? ftxui::Color::Green
+                                                                                        : direction == runtime::PdDirection::Incoming
+                                                                                            ? ftxui::Color::Blue
+                                                                                            : ftxui::Color::GrayDark) |
+                                                                 ftxui::color(ftxui::Color::Black);
+
+                                           const auto txPayloadBytes = runtime->txPayload();
+                                           const auto rxPayloadBytes = runtime->rxPayload();
+                                           const auto txPayloadHex = bytesToHex(txPayloadBytes);
+                                           const auto rxPayloadHex = bytesToHex(rxPayloadBytes);
+
+                                           auto txPane = runtime->canTransmit()
+                                                             ? ftxui::vbox(ftxui::Elements{
+                                                                   ftxui::text("TX payload (" +
+                                                                               std::to_string(txPayloadBytes.size()) +
+                                                                               " bytes)") |
+                                                                       ftxui::bold,
+                                                                   txControls->Render() | ftxui::xflex,
+                                                                   ftxui::paragraph(txPayloadHex.empty() ? "<empty>" : txPayloadHex),
+                                                               })
+                                                             : ftxui::vbox(ftxui::Elements{ftxui::text("Transmit disabled for this telegram")});
+
+                                           auto rxPane = runtime->canReceive()
+                                                             ? ftxui::vbox(ftxui::Elements{
+                                                                   ftxui::text("Last RX payload (" +
+                                                                               std::to_string(rxPayloadBytes.size()) +
+                                                                               " bytes)") |
+                                                                       ftxui::bold,
+                                                                   ftxui::paragraph(rxPayloadHex.empty() ? "<no data yet>" :
+                                                                                                       rxPayloadHex),
+                                                               })
+                                                             : ftxui::vbox(ftxui::Elements{ftxui::text("Receive disabled for this telegram")});
+
+                                           auto controlRender = runtime->canTransmit()
+                                                                      ? controls->Render()
+                                                                      : ftxui::text("TX controls disabled (receive-only)");
+
+                                           return ftxui::vbox(ftxui::Elements{
+                                               ftxui::hbox(ftxui::Elements{ftxui::text("ComID " + std::to_string(telegram.comId) +
+                                                                                       " (Dataset " +
+                                                                                       std::to_string(telegram.datasetId) + ")" +
+                                                                                       (telegram.pd && telegram.pd->cycleUs != 0U
+                                                                                            ? " | XML cycle " +
+                                                                                                  std::to_string(telegram.pd->cycleUs) + " µs"
+                                                                                            : std::string())),
+                                                           ftxui::separator(),
+                                                           directionBadge}),
+                                               ftxui::separator(),
+                                               ftxui::text(txStatus),
+                                               ftxui::text(rxStatus),
+                                               ftxui::separator(),
+                                               ftxui::hbox(ftxui::Elements{ftxui::window(ftxui::text("TX"), txPane | ftxui::xflex),
+                                                                           ftxui::separator(),
+                                                                           ftxui::window(ftxui::text("RX"), rxPane | ftxui::xflex)}) |
+                                                   ftxui::xflex,
+                                               ftxui::separator(),
+                                               controlRender,
+                                           });
+                                       });
+
+    return PdControlRow{telegram, interfaceName, runtime, cycleInput, txInput, rowRenderer};
+}
+
+void StartRawGenerator(const model::SimulatorConfig &config,
+                       const runtime::InterfaceBringUp &bringUp,
+                       const model::RawGeneratorOptions &options,
+                       SimulatorRuntimeContext &context)
+{
+    std::vector<model::TelegramConfig> outgoing;
+    for (std::size_t i = 0; i < bringUp.endpoints.size(); ++i)
     {
-        auto session = std::make_shared<runtime::TrdpSession>(runtime::TrdpSessionConfig{
-            iface.hostIp,
-            iface.leaderIp,
-            iface.networkId,
-        });
-        session->open();
-        context->sessions.push_back(session);
+        if (bringUp.endpoints[i]->canTransmit())
+        {
+            outgoing.push_back(bringUp.iface->telegrams[i]);
+        }
+    }
+    if (outgoing.empty())
+    {
+        return;
+    }
 
-        for (const auto &telegram : iface.telegrams)
+    const auto &defaults = bringUp.iface->pdDefaults;
+    runtime::RawPdGeneratorSettings settings{};
+    settings.sourceIp = bringUp.iface->hostIp;
+    settings.port = defaults.port != 0U ? defaults.port : runtime::kPdDefaultPort;
+    settings.batchSize = options.batchSize;
+    settings.txTime = options.txTime;
+    settings.qos = defaults.qos != 0U ? defaults.qos : settings.qos;
+    settings.ttl = defaults.ttl != 0U ? defaults.ttl : settings.ttl;
+    settings.realtime = bringUp.realtime;
+
+    auto generator = std::make_shared<runtime::RawPdGenerator>(
+        settings, runtime::planRawPdStreams(config, outgoing, bringUp.session->hostAddress(), options.speedup));
+    if (generator->start())
+    {
+        context.rawGenerators.push_back(std::move(generator));
+    }
+}
+
+void IsolateUiThreads(const std::vector<int> &reservedCpus, SimulatorRuntimeContext &context)
+{
+    // Threads started from here on (UI, capture, helpers) inherit the reduced CPU set.
+    context.uiIsolation = runtime::isolateCallingThreadFrom(reservedCpus);
+    const auto message = "CPU isolation " + context.uiIsolation->requested + ": " + context.uiIsolation->detail;
+    if (context.uiIsolation->applied)
+    {
+        util::logInfo(message);
+    }
+    else
+    {
+        util::logWarn(message);
+    }
+}
+
+/** Loads `--scenario` and starts it on the rows that transmit its ComIDs; failures are logged. */
+void StartScenario(const model::SimulatorConfig &config,
+                   const model::RuntimeOptions &options,
+                   SimulatorRuntimeContext &context)
+{
+    if (options.scenario.path.empty())
+    {
+        return;
+    }
+
+    scenario::Scenario compiled;
+    std::string error;
+    if (!scenario::loadScenario(options.scenario.path, config, compiled, error))
+    {
+        util::logError("--scenario ignored: " + error);
+        return;
+    }
+
+    auto runner = std::make_shared<scenario::ScenarioRunner>(std::move(compiled));
+    for (const auto &row : context.pdRows)
+    {
+        if (row.runtime && row.runtime->canTransmit())
         {
-            auto runtime = std::make_shared<runtime::PdEndpointRuntime>(telegram, session, iface.hostIp);
-            session->registerPdSubscriber(telegram.comId, [runtime](const runtime::PdMessage &message) {
-                runtime->handleSubscription(message);
-            });
+            runner->bind(row.config.comId, row.runtime);
+        }
+    }
+
+    scenario::ScenarioRunOptions runOptions;
+    runOptions.realtime.policy = options.realtime.policy;
+    runOptions.realtime.priority = options.realtime.priority;
+    runner->start(runOptions);
+    context.scenario = std::move(runner);
+    context.scenarioReportPath = options.scenario.reportPath;
+}
+
+/** Serves `--control` for every row; a socket that cannot be bound is logged and left out. */
+void StartControlServer(const model::RuntimeOptions &options, SimulatorRuntimeContext &context)
+{
+    if (options.control.socketPath.empty())
+    {
+        return;
+    }
 
-            runtime->setSubscriptionSink([context, telegram](const runtime::PdMessage &message) {
+    auto server = std::make_shared<control::ControlServer>();
+    for (const auto &row : context.pdRows)
+    {
+        server->add(row.config.comId, row.runtime);
+    }
+    // The server is stopped in shutdown() before the context goes away.
+    server->setPauseHandler([&context](bool paused, const std::string &interfaceName) {
+        return context.setPaused(paused, interfaceName);
+    });
+    std::string error;
+    if (!server->start(options.control.socketPath, error))
+    {
+        util::logError("--control ignored: " + error);
+        return;
+    }
+    context.control = std::move(server);
+}
+
+/** Exports every row to `--state-export`; a segment that cannot be created is logged and left out. */
+void StartStateExport(const model::RuntimeOptions &options, SimulatorRuntimeContext &context)
+{
+    if (options.stateExport.name.empty())
+    {
+        return;
+    }
+
+    auto exporter = std::make_shared<shard::StateExport>();
+    for (const auto &row : context.pdRows)
+    {
+        exporter->add(row.config.comId, row.config.datasetId, row.interfaceName, row.runtime);
+    }
+    std::string error;
+    if (!exporter->start(options.stateExport.name, options.stateExport.interval, error))
+    {
+        util::logError("--state-export ignored: " + error);
+        return;
+    }
+    context.stateExport = std::move(exporter);
+}
+
+/** Sharded mode: every interface runs in a worker process and the rows talk to it through shared memory. */
+std::shared_ptr<SimulatorRuntimeContext> BuildShardedContext(const config::SimulatorConfigLoadResult &result,
+                                                             const model::RuntimeOptions &options)
+{
+    auto context = std::make_shared<SimulatorRuntimeContext>();
+    context->startupBegin = std::chrono::steady_clock::now();
+
+    // Workers are forked before the UI starts any thread of its own.
+    std::vector<int> reservedCpus;
+    for (std::size_t index = 0; index < result.config.interfaces.size(); ++index)
+    {
+        const auto &iface = result.config.interfaces[index];
+        const auto cpus = runtime::interfaceRealtimeProfile(options, iface).cpus;
+        reservedCpus.insert(reservedCpus.end(), cpus.begin(), cpus.end());
+        auto shard = std::make_shared<shard::ShardProcess>(iface, index);
+        if (!shard->start(options.shard.forwardedArguments, !options.headless))
+        {
+            continue;
+        }
+        for (std::size_t slot = 0; slot < iface.telegrams.size(); ++slot)
+        {
+            auto proxy = std::make_shared<shard::ShardEndpointProxy>(iface.telegrams[slot], iface.hostIp, shard, slot);
+            context->pdRows.push_back(BuildPdControlRow(iface.telegrams[slot], iface.name, proxy));
+        }
+        context->shards.push_back(std::move(shard));
+    }
+    context->sessionsReady = std::chrono::steady_clock::now() - context->startupBegin;
+
+    std::ostringstream oss;
+    oss << "Started " << context->shards.size() << " of " << result.config.interfaces.size()
+        << " shard worker(s) in " << std::chrono::duration_cast<std::chrono::milliseconds>(context->sessionsReady).count()
+        << " ms";
+    util::logInfo(oss.str());
+
+    if (options.isolateCpus && !reservedCpus.empty())
+    {
+        IsolateUiThreads(reservedCpus, *context);
+    }
+    return context;
+}
+
+std::shared_ptr<SimulatorRuntimeContext> BuildRuntimeContext(const config::SimulatorConfigLoadResult &result,
+                                                             const model::RuntimeOptions &options)
+{
+    if (options.shard.enabled)
+    {
+        auto context = BuildShardedContext(result, options);
+        StartScenario(result.config, options, *context);
+        StartControlServer(options, *context);
+        StartStateExport(options, *context);
+        return context;
+    }
+
+    auto context = std::make_shared<SimulatorRuntimeContext>();
+    context->startupBegin = std::chrono::steady_clock::now();
+
+    // tlc_init runs once, on the first session open, so the pool must be sized before any bring-up.
+    const auto memoryPlan = runtime::planStackMemory(result.config);
+    runtime::TrdpSession::configureStackMemory(memoryPlan);
+    context->stackMemory = std::make_shared<runtime::StackMemoryMonitor>(memoryPlan);
+    context->recorder = runtime::openRecording(options);
+    context->valueExport = runtime::openValueExport(options, result.config);
+
+    std::vector<runtime::InterfaceBringUp> bringUps;
+    bringUps.reserve(result.config.interfaces.size());
+    std::vector<int> reservedCpus;
+    for (const auto &iface : result.config.interfaces)
+    {
+        const auto realtime = runtime::interfaceRealtimeProfile(options, iface);
+        reservedCpus.insert(reservedCpus.end(), realtime.cpus.begin(), realtime.cpus.end());
+
+        auto bringUp = runtime::prepareInterface(iface, realtime);
+        bringUp.autoStartPublishers = !options.rawGenerator.enabled;
+        runtime::attachPayloadGenerators(bringUp, options, result.config);
+        bringUp.session->setPdRecorder(context->recorder);
+        for (std::size_t i = 0; i < bringUp.endpoints.size(); ++i)
+        {
+            const auto &telegram = iface.telegrams[i];
+            bringUp.endpoints[i]->setSubscriptionSink([context, telegram](const runtime::PdMessage &message) {
                 if (!context)
                 {
                     return;
                 }
+                if (context->valueExport)
+                {
+                    const auto timeNs =
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(message.timestamp.time_since_epoch())
+                            .count();
+                    context->valueExport->append(telegram.comId, timeNs, message.payload.data(),
+                                                 message.payload.size());
+                }
 
                 std::ostringstream oss;
                 oss << util::formatTimestamp(message.timestamp) << " | ComID " << telegram.comId << " → Dataset "
                     << telegram.datasetId << " | " << message.payload.size() << " bytes";
                 context->appendSubscriberLog(oss.str());
             });
+        }
 
-            auto cycleInput = std::make_shared<std::string>("1000");
-            auto cycleInputComponent = ftxui::Input(cycleInput.get(), "cycle ms");
-            auto txInput = std::make_shared<std::string>(bytesToHex(runtime->txPayload()));
-            auto txInputComponent = ftxui::Input(txInput.get(), "TX payload (hex bytes or text)");
-
-            auto startButton = ftxui::Button("Start", [runtime, cycleInput] {
-                if (!runtime->canTransmit())
-                {
-                    return;
-                }
+        runtime::routeLinkEvents(bringUp, [context](const runtime::PdTimeoutEvent &event) {
+            const bool lost = event.event == runtime::PdLinkEvent::Lost;
+            const auto what = "ComID " + std::to_string(event.comId) + (lost ? " lost (receive timeout)" : " recovered");
+            context->appendSubscriberLog(util::formatTimestamp(std::chrono::system_clock::now()) + " | " + what);
+            util::log(lost ? util::LogLevel::Warn : util::LogLevel::Info, what, {std::string{}, event.comId});
+        });
+        bringUps.push_back(std::move(bringUp));
+    }
 
-                const auto ms = std::max(1L, std::strtol(cycleInput->c_str(), nullptr, 10));
-                runtime->startPublishing(std::chrono::milliseconds(ms));
-            });
-            auto stopButton = ftxui::Button("Stop", [runtime] { runtime->stopPublishing(); });
-            auto applyTxButton = ftxui::Button("Apply TX", [runtime, txInput] {
-                if (!runtime->canTransmit())
-                {
-                    return;
-                }
+    // Interfaces do not share sockets or handles, so their sessions are opened and populated concurrently.
+    std::vector<std::future<void>> pending;
+    pending.reserve(bringUps.size());
+    for (auto &bringUp : bringUps)
+    {
+        pending.push_back(std::async(std::launch::async, [&bringUp] { runtime::openAndRegister(bringUp); }));
+    }
+    for (auto &future : pending)
+    {
+        future.wait();
+    }
+    context->sessionsReady = std::chrono::steady_clock::now() - context->startupBegin;
 
-                runtime->setTxPayload(parseHexOrAscii(*txInput));
-            });
+    std::ostringstream oss;
+    oss << "Brought up " << bringUps.size() << " TRDP session(s) in "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(context->sessionsReady).count() << " ms";
+    util::logInfo(oss.str());
 
-            auto controls = ftxui::Container::Horizontal({cycleInputComponent, startButton, stopButton});
-            auto txControls = ftxui::Container::Horizontal({txInputComponent, applyTxButton});
+    if (options.rawGenerator.enabled)
+    {
+        for (const auto &bringUp : bringUps)
+        {
+            StartRawGenerator(result.config, bringUp, options.rawGenerator, *context);
+        }
+    }
 
-            auto rowRenderer = ftxui::Renderer(ftxui::Container::Vertical({controls, txControls}),
-                                               [runtime, telegram, controls, txControls]() -> ftxui::Element {
-                                                   const auto lastPublish = runtime->lastPublishTime();
-                                                   const auto lastReceive = runtime->lastReceiveTime();
-                                                   auto fixedSize = runtime->fixedPayloadSize();
+    if (options.isolateCpus && !reservedCpus.empty())
+    {
+        IsolateUiThreads(reservedCpus, *context);
+    }
 
-                                                   auto statusBadge = ftxui::text(runtime->isPublishing() ? " RUNNING " : " STOPPED ") |
-                                                                     ftxui::bgcolor(runtime->isPublishing()
-                                                                                        ? ftxui::Color::Green
-                                                                                        : ftxui::Color::Red) |
-                                                                     ftxui::color(ftxui::Color::Black);
-
-                                                   std::string txStatus = runtime->isPublishing() ? "Publishing" : "Stopped";
-                                                   if (lastPublish)
-                                                   {
-                                                       txStatus += " | last TX: " + util::formatTimestamp(*lastPublish);
-                                                   }
-                                                   txStatus += " | tx count: " + std::to_string(runtime->publishCount());
-                                                   if (fixedSize)
-                                                   {
-                                                       txStatus += " | fixed payload " + std::to_string(*fixedSize) +
-                                                                   " bytes";
-                                                   }
-
-                                                   std::string rxStatus = "RX count: " + std::to_string(runtime->receiveCount());
-                                                   if (lastReceive)
-                                                   {
-                                                       rxStatus += " | last RX: " + util::formatTimestamp(*lastReceive);
-                                                   }
-
-                                                   const auto direction = runtime->direction();
-                                                   const auto directionText = directionLabel(direction);
-                                                   auto directionBadge = ftxui::text(" " + directionText + " ") |
-                                                                         ftxui::bgcolor(direction == runtime::PdDirection::Loopback
-                                                                                            ? ftxui::Color::Yellow
-                                                                                            : direction == runtime::PdDirection::Outgoing
-                                                                                                ? ftxui::Color::Green
-                                                                                                : direction == runtime::PdDirection::Incoming
-                                                                                                    ? ftxui::Color::Blue
-                                                                                                    : ftxui::Color::GrayDark) |
-                                                                         ftxui::color(ftxui::Color::Black);
-
-                                                   const auto txPayloadBytes = runtime->txPayload();
-                                                   const auto rxPayloadBytes = runtime->rxPayload();
-                                                   const auto txPayloadHex = bytesToHex(txPayloadBytes);
-                                                   const auto rxPayloadHex = bytesToHex(rxPayloadBytes);
-
-                                                   auto txPane = runtime->canTransmit()
-                                                                     ? ftxui::vbox(ftxui::Elements{
-                                                                           ftxui::text("TX payload (" +
-                                                                                       std::to_string(txPayloadBytes.size()) +
-                                                                                       " bytes)") |
-                                                                               ftxui::bold,
-                                                                           txControls->Render() | ftxui::xflex,
-                                                                           ftxui::paragraph(txPayloadHex.empty() ? "<empty>" : txPayloadHex),
-                                                                       })
-                                                                     : ftxui::vbox(ftxui::Elements{ftxui::text("Transmit disabled for this telegram")});
-
-                                                   auto rxPane = runtime->canReceive()
-                                                                     ? ftxui::vbox(ftxui::Elements{
-                                                                           ftxui::text("Last RX payload (" +
-                                                                                       std::to_string(rxPayloadBytes.size()) +
-                                                                                       " bytes)") |
-                                                                               ftxui::bold,
-                                                                           ftxui::paragraph(rxPayloadHex.empty() ? "<no data yet>" :
-                                                                                                               rxPayloadHex),
-                                                                       })
-                                                                     : ftxui::vbox(ftxui::Elements{ftxui::text("Receive disabled for this telegram")});
-
-                                                   auto controlRender = runtime->canTransmit()
-                                                                              ? controls->Render()
-                                                                              : ftxui::text("TX controls disabled (receive-only)");
-
-                                                   return ftxui::vbox(ftxui::Elements{
-                                                       ftxui::hbox(ftxui::Elements{ftxui::text("ComID " + std::to_string(telegram.comId) +
-                                                                                               " (Dataset " +
-                                                                                               std::to_string(telegram.datasetId) + ")"),
-                                                                   ftxui::separator(),
-                                                                   directionBadge}),
-                                                       ftxui::separator(),
-                                                       ftxui::text(txStatus),
-                                                       ftxui::text(rxStatus),
-                                                       ftxui::separator(),
-                                                       ftxui::hbox(ftxui::Elements{ftxui::window(ftxui::text("TX"), txPane | ftxui::xflex),
-                                                                                   ftxui::separator(),
-                                                                                   ftxui::window(ftxui::text("RX"), rxPane | ftxui::xflex)}) |
-                                                           ftxui::xflex,
-                                                       ftxui::separator(),
-                                                       controlRender,
-                                                   });
-                                               });
-
-            context->pdRows.push_back(PdControlRow{telegram, runtime, cycleInput, txInput, rowRenderer});
+    for (auto &bringUp : bringUps)
+    {
+        context->sessions.push_back(bringUp.session);
+        context->sessionInterfaces.push_back(bringUp.iface->name);
+        for (std::size_t i = 0; i < bringUp.endpoints.size(); ++i)
+        {
+            context->pdRows.push_back(BuildPdControlRow(bringUp.iface->telegrams[i], bringUp.iface->name, bringUp.endpoints[i]));
         }
     }
 
+    StartScenario(result.config, options, *context);
+    StartControlServer(options, *context);
+    StartStateExport(options, *context);
     return context;
 }
 
@@ -407,20 +706,21 @@ ftxui::Component BuildDatasetEditor(const config::SimulatorConfigLoadResult &res
 } // namespace
 
 ftxui::Component MakeTuiApp(const config::SimulatorConfigLoadResult &result,
-                            const std::string &sourcePath,
+                            const model::RuntimeOptions &options,
                             std::function<void()> onQuit)
 {
     using namespace ftxui; // NOLINT
 
+    const auto &sourcePath = options.configPath;
     auto navState = std::make_shared<NavigationState>();
-    auto runtime = BuildRuntimeContext(result);
+    auto runtime = BuildRuntimeContext(result, options);
 
-    auto dashboard = BuildDashboard(result, sourcePath);
+    auto dashboard = BuildDashboard(result, sourcePath, runtime);
     auto pdView = MakeConfigSummaryScreen(result, sourcePath, runtime, onQuit);
     auto mdView = BuildPlaceholderPanel("MD View", "MD session monitoring and controls (upcoming)");
     auto datasetEditor = BuildDatasetEditor(result, runtime);
-    auto logs = BuildPlaceholderPanel("Logs", "TRDP runtime logs and filtering (upcoming)");
-    auto stats = BuildPlaceholderPanel("Stats", "PD/MD statistics and counters (upcoming)");
+    auto logs = MakeLogsScreen(util::logStore());
+    auto stats = MakeStatsScreen(runtime);
 
     auto contentPages = Container::Tab({dashboard, pdView, mdView, datasetEditor, logs, stats}, &navState->selected);
     auto menu = Menu(&navState->entries, &navState->selected);
@@ -428,11 +728,17 @@ ftxui::Component MakeTuiApp(const config::SimulatorConfigLoadResult &result,
     auto layout = Container::Horizontal({menu, contentPages});
 
     auto renderer = Renderer(layout, [menu, contentPages] {
+        TRDP_TRACE_SCOPE("ui render");
         return ftxui::hbox({menu->Render() | ftxui::size(ftxui::WIDTH, ftxui::LESS_THAN, 24) | ftxui::border,
                             contentPages->Render() | ftxui::flex});
     });
 
-    auto quitHandler = CatchEvent(renderer, [menu, navState, onQuit, runtime](const Event &event) {
+    auto quitHandler = CatchEvent(renderer, [menu, navState, onQuit, runtime, tracePath = options.tracePath](const Event &event) {
+        if (event == Event::F12 && util::trace::enabled())
+        {
+            util::trace::dumpToFile(tracePath);
+            return true;
+        }
         if (event == Event::Character('k'))
         {
             navState->selected = (navState->selected - 1 + static_cast<int>(navState->entries.size())) %
@@ -446,6 +752,8 @@ ftxui::Component MakeTuiApp(const config::SimulatorConfigLoadResult &result,
         }
         if (event == Event::Character('q') || event == Event::Character('Q') || event == Event::Escape)
         {
+            // The shutdown summary should still reach the terminal.
+            util::setConsoleEcho(true);
             if (runtime)
             {
                 runtime->shutdown();
@@ -461,5 +769,39 @@ ftxui::Component MakeTuiApp(const config::SimulatorConfigLoadResult &result,
 
     return quitHandler;
 }
+
+int RunHeadless(const config::SimulatorConfigLoadResult &result, const model::RuntimeOptions &options)
+{
+    // Blocked before any thread exists, so that every thread inherits the mask and only the wait below sees them.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    auto runtime = BuildRuntimeContext(result, options);
+    const bool started = (options.scenario.path.empty() || runtime->scenario != nullptr) &&
+                         (options.control.socketPath.empty() || runtime->control != nullptr);
+    // With a control socket the client decides when the run ends, even after the scenario is done.
+    const auto done = [&runtime] {
+        return runtime->control ? runtime->control->quitRequested()
+                                : runtime->scenario && runtime->scenario->finished();
+    };
+    bool interrupted = false;
+    while (started && !done())
+    {
+        const timespec poll{0, 100000000L};
+        const int signal = sigtimedwait(&signals, nullptr, &poll);
+        if (signal > 0)
+        {
+            util::logInfo(std::string("Received ") + (signal == SIGINT ? "SIGINT" : "SIGTERM") + ", shutting down");
+            interrupted = true;
+            break;
+        }
+    }
+
+    runtime->shutdown();
+    return started && (!interrupted || !runtime->scenario || runtime->scenario->finished()) ? 0 : 1;
+}
 } // namespace trdp::ui
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "config/xml_loader.h"
+#include "model/runtime_options.h"
 
 #include <ftxui/component/component.hpp>
 #include <functional>
@@ -13,7 +14,15 @@ namespace trdp::ui
  * described in the SRS/SAS (Dashboard, PD, MD, Dataset Editor, Logs, Stats).
  */
 ftxui::Component MakeTuiApp(const config::SimulatorConfigLoadResult &result,
-                            const std::string &sourcePath,
+                            const model::RuntimeOptions &options,
                             std::function<void()> onQuit = {});
+
+/**
+ * Bring up the same runtime as the TUI without a terminal UI and run until the `--scenario` has
+ * executed every event (with `--control`: until a client sends quit), or until SIGINT/SIGTERM.
+ * Returns the exit status: 1 when the scenario or control socket could not be set up, or the
+ * scenario was interrupted.
+ */
+int RunHeadless(const config::SimulatorConfigLoadResult &result, const model::RuntimeOptions &options);
 } // namespace trdp::ui
 
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace trdp::util
+{
+/** Parses a Linux CPU list such as "2,3" or "0-1,4" (the cpuset/sysfs format); empty input → empty set. */
+inline std::optional<std::vector<int>> parseCpuList(const std::string &text)
+{
+    std::vector<int> cpus;
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        item.erase(std::remove_if(item.begin(), item.end(), [](unsigned char c) { return std::isspace(c) != 0; }),
+                   item.end());
+        if (item.empty())
+        {
+            continue;
+        }
+
+        char *end = nullptr;
+        const long first = std::strtol(item.c_str(), &end, 10);
+        long last = first;
+        if (*end == '-')
+        {
+            last = std::strtol(end + 1, &end, 10);
+        }
+        if (*end != '\0' || first < 0 || last < first || last > 4095)
+        {
+            return std::nullopt;
+        }
+        for (long cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+inline std::string formatCpuList(const std::vector<int> &cpus)
+{
+    std::ostringstream oss;
+    for (std::size_t i = 0; i < cpus.size(); ++i)
+    {
+        oss << (i == 0 ? "" : ",") << cpus[i];
+    }
+    return oss.str();
+}
+} // namespace trdp::util
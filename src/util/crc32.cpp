@@ -0,0 +1,226 @@
+#include "util/crc32.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define TRDP_CRC32_ARM 1
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define TRDP_CRC32_PCLMUL 1
+#endif
+
+namespace trdp::util
+{
+namespace
+{
+using Crc32Tables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+constexpr Crc32Tables makeTables()
+{
+    Crc32Tables tables{};
+    for (std::uint32_t i = 0; i < 256U; ++i)
+    {
+        std::uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1U) != 0U ? (crc >> 1U) ^ 0xEDB88320U : crc >> 1U;
+        }
+        tables[0][i] = crc;
+    }
+    for (std::size_t slice = 1; slice < tables.size(); ++slice)
+    {
+        for (std::uint32_t i = 0; i < 256U; ++i)
+        {
+            const auto previous = tables[slice - 1U][i];
+            tables[slice][i] = (previous >> 8U) ^ tables[0][previous & 0xFFU];
+        }
+    }
+    return tables;
+}
+
+constexpr Crc32Tables kTables = makeTables();
+
+std::uint32_t loadLe32(const std::uint8_t *data)
+{
+    return data[0] | (static_cast<std::uint32_t>(data[1]) << 8U) | (static_cast<std::uint32_t>(data[2]) << 16U) |
+           (static_cast<std::uint32_t>(data[3]) << 24U);
+}
+
+/** Slicing-by-8 over the running (inverted) CRC state. */
+std::uint32_t slice8State(std::uint32_t state, const std::uint8_t *data, std::size_t size)
+{
+    while (size >= 8U)
+    {
+        const auto low = state ^ loadLe32(data);
+        const auto high = loadLe32(data + 4);
+        state = kTables[7][low & 0xFFU] ^ kTables[6][(low >> 8U) & 0xFFU] ^ kTables[5][(low >> 16U) & 0xFFU] ^
+                kTables[4][low >> 24U] ^ kTables[3][high & 0xFFU] ^ kTables[2][(high >> 8U) & 0xFFU] ^
+                kTables[1][(high >> 16U) & 0xFFU] ^ kTables[0][high >> 24U];
+        data += 8;
+        size -= 8U;
+    }
+    while (size-- > 0U)
+    {
+        state = kTables[0][(state ^ *data++) & 0xFFU] ^ (state >> 8U);
+    }
+    return state;
+}
+
+#if defined(TRDP_CRC32_ARM)
+std::uint32_t armState(std::uint32_t state, const std::uint8_t *data, std::size_t size)
+{
+    while (size >= 8U)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        state = __crc32d(state, word);
+        data += 8;
+        size -= 8U;
+    }
+    while (size-- > 0U)
+    {
+        state = __crc32b(state, *data++);
+    }
+    return state;
+}
+#endif
+
+#if defined(TRDP_CRC32_PCLMUL)
+constexpr std::size_t kFoldMinimum = 64U;
+
+/**
+ * Carry-less multiplication folding (Intel, "Fast CRC Computation for Generic Polynomials Using
+ * PCLMULQDQ") for the reflected IEEE polynomial. `size` must be a multiple of 16 and >= 64.
+ */
+__attribute__((target("pclmul,sse4.1"))) std::uint32_t foldState(std::uint32_t state, const std::uint8_t *data,
+                                                                  std::size_t size)
+{
+    alignas(16) static const std::uint64_t k1k2[] = {0x0154442bd4U, 0x01c6e41596U};
+    alignas(16) static const std::uint64_t k3k4[] = {0x01751997d0U, 0x00ccaa009eU};
+    alignas(16) static const std::uint64_t k5k0[] = {0x0163cd6124U, 0x0000000000U};
+    alignas(16) static const std::uint64_t poly[] = {0x01db710641U, 0x01f7011641U};
+
+    const auto load = [](const std::uint8_t *at) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(at)); };
+
+    __m128i x1 = _mm_xor_si128(load(data), _mm_cvtsi32_si128(static_cast<int>(state)));
+    __m128i x2 = load(data + 16);
+    __m128i x3 = load(data + 32);
+    __m128i x4 = load(data + 48);
+    __m128i x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k1k2));
+    data += 64;
+    size -= 64U;
+
+    // Four independent 128-bit lanes, each folded 64 bytes forward per iteration.
+    while (size >= 64U)
+    {
+        const __m128i x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        const __m128i x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        const __m128i x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        const __m128i x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x11), x5), load(data));
+        x2 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x2, x0, 0x11), x6), load(data + 16));
+        x3 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x3, x0, 0x11), x7), load(data + 32));
+        x4 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x4, x0, 0x11), x8), load(data + 48));
+        data += 64;
+        size -= 64U;
+    }
+
+    // Fold the four lanes into one, then any remaining 16-byte blocks.
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k3k4));
+    for (const auto &next : {x2, x3, x4})
+    {
+        const __m128i x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x11), next), x5);
+    }
+    while (size >= 16U)
+    {
+        const __m128i x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x11), load(data)), x5);
+        data += 16;
+        size -= 16U;
+    }
+
+    // 128 -> 64 bits.
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), x0, 0x00), x2);
+
+    // Barrett reduction to 32 bits.
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(poly));
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return static_cast<std::uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+std::uint32_t pclmulState(std::uint32_t state, const std::uint8_t *data, std::size_t size)
+{
+    if (size >= kFoldMinimum)
+    {
+        const auto folded = size & ~std::size_t{15U};
+        state = foldState(state, data, folded);
+        data += folded;
+        size -= folded;
+    }
+    return slice8State(state, data, size);
+}
+#endif
+
+using StateFunction = std::uint32_t (*)(std::uint32_t, const std::uint8_t *, std::size_t);
+
+struct Backend
+{
+    StateFunction update;
+    const char *name;
+};
+
+Backend selectBackend()
+{
+#if defined(TRDP_CRC32_ARM)
+    return {&armState, "armv8-crc32"};
+#elif defined(TRDP_CRC32_PCLMUL)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1"))
+    {
+        return {&pclmulState, "pclmul"};
+    }
+    return {&slice8State, "slice-by-8"};
+#else
+    return {&slice8State, "slice-by-8"};
+#endif
+}
+
+const Backend &backend()
+{
+    static const Backend selected = selectBackend();
+    return selected;
+}
+} // namespace
+
+std::uint32_t crc32(const std::uint8_t *data, std::size_t size)
+{
+    return crc32Update(0U, data, size);
+}
+
+std::uint32_t crc32Update(std::uint32_t crc, const std::uint8_t *data, std::size_t size)
+{
+    return ~backend().update(~crc, data, size);
+}
+
+std::uint32_t crc32Slice8(std::uint32_t crc, const std::uint8_t *data, std::size_t size)
+{
+    return ~slice8State(~crc, data, size);
+}
+
+const char *crc32Backend()
+{
+    return backend().name;
+}
+} // namespace trdp::util
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace trdp::util
+{
+/**
+ * CRC-32 (IEEE 802.3, reflected, polynomial 0x04C11DB7) as used for the TRDP header FCS; the same
+ * result as the stack's vos_crc32(0xFFFFFFFF, data, size).
+ *
+ * Uses the ARMv8 CRC32 instructions when the build targets them, PCLMULQDQ folding for long
+ * buffers on x86 CPUs that support it, and table-driven slicing-by-8 otherwise. (The SSE4.2 crc32
+ * instruction implements CRC-32C, a different polynomial, and is therefore not used.)
+ */
+std::uint32_t crc32(const std::uint8_t *data, std::size_t size);
+
+/** Continues a CRC over another buffer; start with 0 and chain the previous result. */
+std::uint32_t crc32Update(std::uint32_t crc, const std::uint8_t *data, std::size_t size);
+
+/** Portable slicing-by-8 implementation, regardless of the CPU. */
+std::uint32_t crc32Slice8(std::uint32_t crc, const std::uint8_t *data, std::size_t size);
+
+/** Name of the implementation crc32() dispatches to on this CPU, e.g. "pclmul". */
+const char *crc32Backend();
+} // namespace trdp::util
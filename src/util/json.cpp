@@ -0,0 +1,447 @@
+#include "util/json.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace trdp::util
+{
+namespace
+{
+constexpr int kMaxDepth = 64;
+
+class Parser
+{
+public:
+    explicit Parser(std::string_view text) : text_(text) {}
+
+    bool parseDocument(JsonValue &value, std::string &error)
+    {
+        if (!parseValue(value, 0))
+        {
+            error = error_ + " at offset " + std::to_string(pos_);
+            return false;
+        }
+        skipSpace();
+        if (pos_ != text_.size())
+        {
+            error = "trailing characters at offset " + std::to_string(pos_);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool fail(const char *message)
+    {
+        error_ = message;
+        return false;
+    }
+
+    void skipSpace()
+    {
+        while (pos_ < text_.size() &&
+               (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r'))
+        {
+            ++pos_;
+        }
+    }
+
+    bool consume(std::string_view literal)
+    {
+        if (text_.substr(pos_, literal.size()) != literal)
+        {
+            return false;
+        }
+        pos_ += literal.size();
+        return true;
+    }
+
+    bool parseValue(JsonValue &value, int depth)
+    {
+        if (depth > kMaxDepth)
+        {
+            return fail("nested too deeply");
+        }
+        skipSpace();
+        if (pos_ >= text_.size())
+        {
+            return fail("unexpected end of input");
+        }
+
+        const char c = text_[pos_];
+        if (c == '{')
+        {
+            return parseObject(value, depth);
+        }
+        if (c == '[')
+        {
+            return parseArray(value, depth);
+        }
+        if (c == '"')
+        {
+            value.type = JsonType::String;
+            return parseString(value.string);
+        }
+        if (consume("true") || consume("false"))
+        {
+            value.type = JsonType::Bool;
+            value.boolean = c == 't';
+            return true;
+        }
+        if (consume("null"))
+        {
+            value.type = JsonType::Null;
+            return true;
+        }
+        return parseNumber(value);
+    }
+
+    bool parseObject(JsonValue &value, int depth)
+    {
+        value.type = JsonType::Object;
+        ++pos_;
+        skipSpace();
+        if (consume("}"))
+        {
+            return true;
+        }
+        while (true)
+        {
+            skipSpace();
+            std::string key;
+            if (pos_ >= text_.size() || text_[pos_] != '"' || !parseString(key))
+            {
+                return error_.empty() ? fail("expected a member name") : false;
+            }
+            skipSpace();
+            if (!consume(":"))
+            {
+                return fail("expected ':'");
+            }
+            value.keys.push_back(std::move(key));
+            value.items.emplace_back();
+            if (!parseValue(value.items.back(), depth + 1))
+            {
+                return false;
+            }
+            skipSpace();
+            if (consume("}"))
+            {
+                return true;
+            }
+            if (!consume(","))
+            {
+                return fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    bool parseArray(JsonValue &value, int depth)
+    {
+        value.type = JsonType::Array;
+        ++pos_;
+        skipSpace();
+        if (consume("]"))
+        {
+            return true;
+        }
+        while (true)
+        {
+            value.items.emplace_back();
+            if (!parseValue(value.items.back(), depth + 1))
+            {
+                return false;
+            }
+            skipSpace();
+            if (consume("]"))
+            {
+                return true;
+            }
+            if (!consume(","))
+            {
+                return fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    bool parseHex4(std::uint32_t &code)
+    {
+        if (pos_ + 4U > text_.size())
+        {
+            return fail("truncated \\u escape");
+        }
+        code = 0U;
+        for (int i = 0; i < 4; ++i)
+        {
+            const char c = text_[pos_++];
+            code <<= 4U;
+            if (c >= '0' && c <= '9')
+            {
+                code |= static_cast<std::uint32_t>(c - '0');
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                code |= static_cast<std::uint32_t>(c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                code |= static_cast<std::uint32_t>(c - 'A' + 10);
+            }
+            else
+            {
+                return fail("invalid \\u escape");
+            }
+        }
+        return true;
+    }
+
+    static void appendUtf8(std::string &out, std::uint32_t code)
+    {
+        if (code < 0x80U)
+        {
+            out.push_back(static_cast<char>(code));
+        }
+        else if (code < 0x800U)
+        {
+            out.push_back(static_cast<char>(0xC0U | (code >> 6U)));
+            out.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+        }
+        else if (code < 0x10000U)
+        {
+            out.push_back(static_cast<char>(0xE0U | (code >> 12U)));
+            out.push_back(static_cast<char>(0x80U | ((code >> 6U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xF0U | (code >> 18U)));
+            out.push_back(static_cast<char>(0x80U | ((code >> 12U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | ((code >> 6U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+        }
+    }
+
+    bool parseString(std::string &out)
+    {
+        ++pos_;
+        while (pos_ < text_.size())
+        {
+            const char c = text_[pos_++];
+            if (c == '"')
+            {
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20U)
+            {
+                return fail("control character in string");
+            }
+            if (c != '\\')
+            {
+                out.push_back(c);
+                continue;
+            }
+            if (pos_ >= text_.size())
+            {
+                break;
+            }
+            const char escape = text_[pos_++];
+            switch (escape)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                out.push_back(escape);
+                break;
+            case 'b':
+                out.push_back('\b');
+                break;
+            case 'f':
+                out.push_back('\f');
+                break;
+            case 'n':
+                out.push_back('\n');
+                break;
+            case 'r':
+                out.push_back('\r');
+                break;
+            case 't':
+                out.push_back('\t');
+                break;
+            case 'u':
+            {
+                std::uint32_t code = 0U;
+                if (!parseHex4(code))
+                {
+                    return false;
+                }
+                // A high surrogate followed by a low one encodes a code point above U+FFFF.
+                if (code >= 0xD800U && code < 0xDC00U && consume("\\u"))
+                {
+                    std::uint32_t low = 0U;
+                    if (!parseHex4(low) || low < 0xDC00U || low >= 0xE000U)
+                    {
+                        return fail("invalid surrogate pair");
+                    }
+                    code = 0x10000U + ((code - 0xD800U) << 10U) + (low - 0xDC00U);
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                return fail("invalid escape");
+            }
+        }
+        return fail("unterminated string");
+    }
+
+    bool parseNumber(JsonValue &value)
+    {
+        const auto start = pos_;
+        if (pos_ < text_.size() && text_[pos_] == '-')
+        {
+            ++pos_;
+        }
+        const auto digits = [this] {
+            const auto first = pos_;
+            while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9')
+            {
+                ++pos_;
+            }
+            return pos_ > first;
+        };
+        if (!digits())
+        {
+            return fail("unexpected character");
+        }
+        if (pos_ < text_.size() && text_[pos_] == '.' && (++pos_, !digits()))
+        {
+            return fail("invalid number");
+        }
+        if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E'))
+        {
+            ++pos_;
+            if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-'))
+            {
+                ++pos_;
+            }
+            if (!digits())
+            {
+                return fail("invalid number");
+            }
+        }
+
+        value.type = JsonType::Number;
+        value.number = std::strtod(std::string(text_.substr(start, pos_ - start)).c_str(), nullptr);
+        if (!std::isfinite(value.number))
+        {
+            return fail("number out of range");
+        }
+        return true;
+    }
+
+    std::string_view text_;
+    std::size_t pos_{0};
+    std::string error_;
+};
+} // namespace
+
+const JsonValue *JsonValue::find(std::string_view key) const
+{
+    if (type != JsonType::Object)
+    {
+        return nullptr;
+    }
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+        if (keys[i] == key)
+        {
+            return &items[i];
+        }
+    }
+    return nullptr;
+}
+
+bool parseJson(std::string_view text, JsonValue &value, std::string &error)
+{
+    value = JsonValue{};
+    return Parser(text).parseDocument(value, error);
+}
+
+void appendJsonString(std::string &out, std::string_view text)
+{
+    static constexpr char kHex[] = "0123456789abcdef";
+    out.push_back('"');
+    for (const char c : text)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\')
+        {
+            out.push_back('\\');
+            out.push_back(c);
+        }
+        else if (c == '\n')
+        {
+            out += "\\n";
+        }
+        else if (byte < 0x20U)
+        {
+            out += "\\u00";
+            out.push_back(kHex[byte >> 4U]);
+            out.push_back(kHex[byte & 0x0FU]);
+        }
+        else
+        {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+void appendHex(std::string &out, const std::uint8_t *data, std::size_t size)
+{
+    static constexpr char kHex[] = "0123456789abcdef";
+    out.reserve(out.size() + size * 2U);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        out.push_back(kHex[data[i] >> 4U]);
+        out.push_back(kHex[data[i] & 0x0FU]);
+    }
+}
+
+bool parseHexBytes(std::string_view text, std::vector<std::uint8_t> &bytes)
+{
+    const auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f')
+        {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F')
+        {
+            return c - 'A' + 10;
+        }
+        return -1;
+    };
+
+    bytes.clear();
+    if (text.size() % 2U != 0U)
+    {
+        return false;
+    }
+    bytes.reserve(text.size() / 2U);
+    for (std::size_t i = 0; i < text.size(); i += 2U)
+    {
+        const int high = nibble(text[i]);
+        const int low = nibble(text[i + 1U]);
+        if (high < 0 || low < 0)
+        {
+            return false;
+        }
+        bytes.push_back(static_cast<std::uint8_t>((high << 4) | low));
+    }
+    return true;
+}
+} // namespace trdp::util
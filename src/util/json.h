@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace trdp::util
+{
+enum class JsonType : std::uint8_t
+{
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object,
+};
+
+/**
+ * A parsed JSON document, for the small requests of the control socket. Numbers are kept as
+ * doubles; an object keeps its members in order, `keys[i]` naming `items[i]`.
+ */
+struct JsonValue
+{
+    JsonType type{JsonType::Null};
+    bool boolean{false};
+    double number{0.0};
+    std::string string;
+    std::vector<JsonValue> items;
+    std::vector<std::string> keys;
+
+    /** Member `key` of an object; nullptr if absent or not an object. */
+    [[nodiscard]] const JsonValue *find(std::string_view key) const;
+};
+
+/** Parses one JSON text (RFC 8259), nested at most 64 levels deep. */
+bool parseJson(std::string_view text, JsonValue &value, std::string &error);
+
+/** Appends `text` as a quoted JSON string, escaping quotes, backslashes and control characters. */
+void appendJsonString(std::string &out, std::string_view text);
+
+/** Appends `size` bytes as lower-case hex digits, without quotes. */
+void appendHex(std::string &out, const std::uint8_t *data, std::size_t size);
+
+/** Parses an even number of hex digits; false for anything else. */
+bool parseHexBytes(std::string_view text, std::vector<std::uint8_t> &bytes);
+} // namespace trdp::util
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace trdp::util
+{
+/**
+ * Log-linear histogram of non-negative integers with a fixed footprint.
+ *
+ * Values below 2 * kSubBuckets are counted exactly; above that every power of two is split into
+ * kSubBuckets equal buckets, so a reported percentile is never more than 1/kSubBuckets (12.5 %)
+ * above the true value. record() is O(1) and never allocates. Not thread-safe.
+ */
+class LogHistogram
+{
+public:
+    static constexpr unsigned kSubBucketBits = 3U;
+    static constexpr std::uint64_t kSubBuckets = 1U << kSubBucketBits;
+    /** Enough buckets for the whole std::uint64_t range. */
+    static constexpr std::size_t kBucketCount = (64U - kSubBucketBits + 1U) * kSubBuckets;
+
+    void record(std::uint64_t value)
+    {
+        ++buckets_[bucketIndex(value)];
+        ++count_;
+        sum_ += value;
+        max_ = std::max(max_, value);
+    }
+
+    void clear() { *this = LogHistogram{}; }
+
+    [[nodiscard]] std::uint64_t count() const { return count_; }
+    [[nodiscard]] std::uint64_t max() const { return max_; }
+    [[nodiscard]] double mean() const { return count_ == 0U ? 0.0 : static_cast<double>(sum_) / count_; }
+
+    /**
+     * Smallest bucket bound that at least `quantile` (0..1) of the samples do not exceed, capped at
+     * the largest sample; 0 when empty.
+     */
+    [[nodiscard]] std::uint64_t percentile(double quantile) const
+    {
+        if (count_ == 0U)
+        {
+            return 0U;
+        }
+        const auto clamped = std::clamp(quantile, 0.0, 1.0);
+        const auto rank = std::max<std::uint64_t>(1U, static_cast<std::uint64_t>(clamped * count_ + 0.999999));
+        std::uint64_t seen = 0U;
+        for (std::size_t i = 0; i < kBucketCount; ++i)
+        {
+            seen += buckets_[i];
+            if (seen >= rank)
+            {
+                return std::min(bucketUpperBound(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    static std::size_t bucketIndex(std::uint64_t value)
+    {
+        if (value < 2U * kSubBuckets)
+        {
+            return static_cast<std::size_t>(value);
+        }
+        const auto msb = 63U - static_cast<unsigned>(__builtin_clzll(value));
+        const auto shift = msb - kSubBucketBits;
+        const auto sub = (value >> shift) & (kSubBuckets - 1U);
+        return static_cast<std::size_t>((shift + 1U) * kSubBuckets + sub);
+    }
+
+    static std::uint64_t bucketUpperBound(std::size_t index)
+    {
+        if (index < 2U * kSubBuckets)
+        {
+            return index;
+        }
+        const auto shift = index / kSubBuckets - 1U;
+        const auto lower = (kSubBuckets + index % kSubBuckets) << shift;
+        const auto width = std::uint64_t{1} << shift;
+        return lower > std::numeric_limits<std::uint64_t>::max() - (width - 1U) ? std::numeric_limits<std::uint64_t>::max()
+                                                                                : lower + width - 1U;
+    }
+
+private:
+    std::array<std::uint64_t, kBucketCount> buckets_{};
+    std::uint64_t count_{0};
+    std::uint64_t sum_{0};
+    std::uint64_t max_{0};
+};
+} // namespace trdp::util
@@ -0,0 +1,552 @@
+#include "util/log_store.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace trdp::util
+{
+namespace
+{
+/** Stands for one argument in a template; messages containing it have it replaced first. */
+constexpr char kArgMarker = '\x1F';
+/** Longest digit run taken as an argument; anything longer might not fit 64 bits. */
+constexpr std::size_t kMaxArgDigits = 19U;
+constexpr std::size_t kSpillBatch = 4096U;
+constexpr std::chrono::milliseconds kSpillInterval{200};
+/** Template id 0 stands in for messages whose template no longer fits the table. */
+const char *const kTableFullText = "(message dropped: log template table full)";
+
+std::size_t levelIndex(LogLevel level)
+{
+    return static_cast<std::size_t>(level);
+}
+
+/** Position of the first entry at or after `sequence`. */
+std::size_t lowerBound(const std::deque<std::uint64_t> &list, std::uint64_t sequence)
+{
+    return static_cast<std::size_t>(std::lower_bound(list.begin(), list.end(), sequence) - list.begin());
+}
+
+std::int64_t toNs(std::chrono::system_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+} // namespace
+
+LogStore::LogStore(std::size_t capacity) : capacity_(std::max<std::size_t>(capacity, 1U)), records_(capacity_)
+{
+    templates_.emplace_back(kTableFullText);
+}
+
+LogStore::~LogStore()
+{
+    stopSpill();
+}
+
+void LogStore::append(LogLevel level,
+                      const std::string &message,
+                      const std::string &session,
+                      std::uint32_t comId,
+                      std::chrono::system_clock::time_point time)
+{
+    Record record{};
+    record.timeNs = toNs(time);
+    record.comId = comId;
+    record.level = static_cast<std::uint8_t>(level);
+
+    // Cut decimal numbers out as arguments. Numbers with a leading zero stay literal so that
+    // decoding prints exactly what was logged.
+    std::string text;
+    text.reserve(message.size());
+    for (std::size_t i = 0; i < message.size();)
+    {
+        const auto c = message[i];
+        if (!std::isdigit(static_cast<unsigned char>(c)))
+        {
+            text.push_back(c == kArgMarker ? '?' : c);
+            ++i;
+            continue;
+        }
+        auto end = i;
+        while (end < message.size() && std::isdigit(static_cast<unsigned char>(message[end])))
+        {
+            ++end;
+        }
+        const auto digits = end - i;
+        if (record.argCount < kMaxArgs && digits <= kMaxArgDigits && (digits == 1U || c != '0'))
+        {
+            std::uint64_t value = 0U;
+            for (auto pos = i; pos < end; ++pos)
+            {
+                value = value * 10U + static_cast<std::uint64_t>(message[pos] - '0');
+            }
+            record.args[record.argCount++] = value;
+            text.push_back(kArgMarker);
+        }
+        else
+        {
+            text.append(message, i, digits);
+        }
+        i = end;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    record.templateId = internTemplate(text);
+    record.session = session.empty() ? 0U : sessionId(session);
+    if (next_ >= capacity_)
+    {
+        evictOldest();
+    }
+
+    const auto sequence = next_++;
+    records_[sequence % capacity_] = record;
+    byLevel_[record.level].push_back(sequence);
+    if (record.session != 0U)
+    {
+        bySession_[record.session - 1U].push_back(sequence);
+    }
+    if (comId != 0U)
+    {
+        byComId_[comId].push_back(sequence);
+    }
+
+    // The spill thread polls; it is only hurried along when the ring is about to lap it.
+    if (spillThread_.joinable() && next_ - spilled_ >= capacity_ / 2U)
+    {
+        spillWake_.notify_one();
+    }
+}
+
+std::uint32_t LogStore::internTemplate(const std::string &text)
+{
+    const auto it = templateIds_.find(text);
+    if (it != templateIds_.end())
+    {
+        return it->second;
+    }
+    if (templates_.size() > kMaxTemplates)
+    {
+        return 0U;
+    }
+    const auto id = static_cast<std::uint32_t>(templates_.size());
+    templates_.push_back(text);
+    templateIds_.emplace(text, id);
+    return id;
+}
+
+std::uint16_t LogStore::sessionId(const std::string &session)
+{
+    const auto it = sessionIds_.find(session);
+    if (it != sessionIds_.end())
+    {
+        return it->second;
+    }
+    if (sessionNames_.size() >= std::numeric_limits<std::uint16_t>::max())
+    {
+        return 0U;
+    }
+    sessionNames_.push_back(session);
+    bySession_.emplace_back();
+    const auto id = static_cast<std::uint16_t>(sessionNames_.size());
+    sessionIds_.emplace(session, id);
+    return id;
+}
+
+void LogStore::evictOldest()
+{
+    // Lists are in sequence order, so the oldest record is at the front of each list it is on.
+    const auto &oldest = records_[(next_ - capacity_) % capacity_];
+    byLevel_[oldest.level].pop_front();
+    if (oldest.session != 0U)
+    {
+        bySession_[oldest.session - 1U].pop_front();
+    }
+    if (oldest.comId != 0U)
+    {
+        const auto it = byComId_.find(oldest.comId);
+        if (it != byComId_.end())
+        {
+            it->second.pop_front();
+            if (it->second.empty())
+            {
+                byComId_.erase(it);
+            }
+        }
+    }
+}
+
+bool LogStore::matches(const Record &record, const LogFilter &filter, std::uint16_t session) const
+{
+    return record.level >= static_cast<std::uint8_t>(filter.minLevel) && (session == 0U || record.session == session) &&
+           (filter.comId == 0U || record.comId == filter.comId);
+}
+
+LogStore::Pending LogStore::pending(std::uint64_t sequence) const
+{
+    const auto &record = records_[sequence % capacity_];
+    return Pending{sequence, record, &templates_[record.templateId],
+                   record.session == 0U ? nullptr : &sessionNames_[record.session - 1U]};
+}
+
+LogEntry LogStore::decode(const Pending &pending)
+{
+    LogEntry entry;
+    entry.sequence = pending.sequence;
+    entry.time = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(pending.record.timeNs)));
+    entry.level = static_cast<LogLevel>(pending.record.level);
+    entry.comId = pending.record.comId;
+    if (pending.session != nullptr)
+    {
+        entry.session = *pending.session;
+    }
+
+    std::size_t arg = 0U;
+    entry.message.reserve(pending.text->size() + 8U);
+    for (const char c : *pending.text)
+    {
+        if (c == kArgMarker && arg < pending.record.argCount)
+        {
+            entry.message += std::to_string(pending.record.args[arg++]);
+        }
+        else
+        {
+            entry.message.push_back(c);
+        }
+    }
+    return entry;
+}
+
+LogPage LogStore::query(const LogFilter &filter, std::uint64_t anchor, std::size_t skipNewest, std::size_t rows) const
+{
+    LogPage page;
+    std::vector<Pending> selected;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto oldest = next_ > capacity_ ? next_ - capacity_ : 0U;
+        const auto end = std::min(anchor, next_);
+        if (end <= oldest)
+        {
+            return page;
+        }
+
+        // Each active criterion contributes the list(s) of sequence numbers it selects.
+        std::vector<std::vector<const SequenceList *>> criteria;
+        std::uint16_t session = 0U;
+        if (filter.minLevel != LogLevel::Debug)
+        {
+            criteria.emplace_back();
+            for (auto level = levelIndex(filter.minLevel); level < byLevel_.size(); ++level)
+            {
+                criteria.back().push_back(&byLevel_[level]);
+            }
+        }
+        if (!filter.session.empty())
+        {
+            const auto it = sessionIds_.find(filter.session);
+            if (it == sessionIds_.end())
+            {
+                return page;
+            }
+            session = it->second;
+            criteria.push_back({&bySession_[session - 1U]});
+        }
+        if (filter.comId != 0U)
+        {
+            const auto it = byComId_.find(filter.comId);
+            if (it == byComId_.end())
+            {
+                return page;
+            }
+            criteria.push_back({&it->second});
+        }
+
+        if (criteria.empty())
+        {
+            page.total = end - oldest;
+            const auto last = end - std::min<std::uint64_t>(skipNewest, page.total);
+            const auto first = last - std::min<std::uint64_t>(rows, last - oldest);
+            for (auto sequence = first; sequence < last; ++sequence)
+            {
+                selected.push_back(pending(sequence));
+            }
+        }
+        else
+        {
+            const auto sizeOf = [](const std::vector<const SequenceList *> &lists) {
+                std::size_t size = 0U;
+                for (const auto *list : lists)
+                {
+                    size += list->size();
+                }
+                return size;
+            };
+            const auto &driver = *std::min_element(
+                criteria.begin(), criteria.end(), [&sizeOf](const auto &a, const auto &b) { return sizeOf(a) < sizeOf(b); });
+
+            // Entries of each driver list before the anchor.
+            std::vector<std::size_t> limits;
+            std::uint64_t total = 0U;
+            for (const auto *list : driver)
+            {
+                limits.push_back(lowerBound(*list, end));
+                total += limits.back();
+            }
+
+            if (criteria.size() == 1U)
+            {
+                // Single criterion: every entry matches, so rows are found by rank.
+                page.total = total;
+                const auto last = total - std::min<std::uint64_t>(skipNewest, total);
+                const auto first = last - std::min<std::uint64_t>(rows, last);
+                if (first < last)
+                {
+                    // The lists are disjoint; find the sequence number of rank `first` among their union.
+                    auto low = oldest;
+                    auto high = end - 1U;
+                    while (low < high)
+                    {
+                        const auto mid = low + (high - low) / 2U;
+                        std::uint64_t atOrBelow = 0U;
+                        for (std::size_t i = 0; i < driver.size(); ++i)
+                        {
+                            atOrBelow += std::min(lowerBound(*driver[i], mid + 1U), limits[i]);
+                        }
+                        if (atOrBelow > first)
+                        {
+                            high = mid;
+                        }
+                        else
+                        {
+                            low = mid + 1U;
+                        }
+                    }
+                    std::vector<std::size_t> positions;
+                    for (const auto *list : driver)
+                    {
+                        positions.push_back(lowerBound(*list, low));
+                    }
+                    for (auto count = first; count < last; ++count)
+                    {
+                        std::size_t pick = driver.size();
+                        for (std::size_t i = 0; i < driver.size(); ++i)
+                        {
+                            if (positions[i] < limits[i] &&
+                                (pick == driver.size() || (*driver[i])[positions[i]] < (*driver[pick])[positions[pick]]))
+                            {
+                                pick = i;
+                            }
+                        }
+                        selected.push_back(pending((*driver[pick])[positions[pick]++]));
+                    }
+                }
+            }
+            else
+            {
+                // Combined criteria: walk the shortest list back from the anchor.
+                page.exactTotal = false;
+                auto positions = limits;
+                std::uint64_t matched = 0U;
+                while (selected.size() < rows)
+                {
+                    std::size_t pick = driver.size();
+                    for (std::size_t i = 0; i < driver.size(); ++i)
+                    {
+                        if (positions[i] == 0U)
+                        {
+                            continue;
+                        }
+                        if (pick == driver.size() || (*driver[i])[positions[i] - 1U] > (*driver[pick])[positions[pick] - 1U])
+                        {
+                            pick = i;
+                        }
+                    }
+                    if (pick == driver.size())
+                    {
+                        page.exactTotal = true;
+                        break;
+                    }
+                    const auto sequence = (*driver[pick])[--positions[pick]];
+                    if (matches(records_[sequence % capacity_], filter, session) && matched++ >= skipNewest)
+                    {
+                        selected.push_back(pending(sequence));
+                    }
+                }
+                std::reverse(selected.begin(), selected.end());
+                page.total = matched;
+            }
+        }
+    }
+
+    page.entries.reserve(selected.size());
+    for (const auto &item : selected)
+    {
+        page.entries.push_back(decode(item));
+    }
+    return page;
+}
+
+std::uint64_t LogStore::nextSequence() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_;
+}
+
+std::size_t LogStore::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<std::size_t>(std::min<std::uint64_t>(next_, capacity_));
+}
+
+std::size_t LogStore::templateCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return templates_.size() - 1U;
+}
+
+std::vector<std::string> LogStore::sessions() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<std::string>(sessionNames_.begin(), sessionNames_.end());
+}
+
+std::vector<std::uint32_t> LogStore::comIds() const
+{
+    std::vector<std::uint32_t> ids;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ids.reserve(byComId_.size());
+        for (const auto &entry : byComId_)
+        {
+            ids.push_back(entry.first);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+std::string LogStore::formatLine(const LogEntry &entry)
+{
+    const auto millis =
+        std::chrono::duration_cast<std::chrono::milliseconds>(entry.time.time_since_epoch()).count() % 1000;
+    std::ostringstream oss;
+    oss << '[' << logLevelName(entry.level) << "] " << formatTimestamp(entry.time) << '.' << std::setw(3)
+        << std::setfill('0') << millis << " -";
+    if (!entry.session.empty())
+    {
+        oss << ' ' << entry.session;
+    }
+    if (entry.comId != 0U)
+    {
+        oss << " ComID " << entry.comId;
+    }
+    oss << (entry.session.empty() && entry.comId == 0U ? " " : " - ") << entry.message;
+    return oss.str();
+}
+
+bool LogStore::startSpill(const LogSpillOptions &options, std::string &error)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (spillThread_.joinable())
+    {
+        error = "log spill already running";
+        return false;
+    }
+    std::ofstream probe(options.path, std::ios::app);
+    if (!probe)
+    {
+        error = "cannot open log file " + options.path;
+        return false;
+    }
+    spill_ = options;
+    spillStop_ = false;
+    // Messages logged before the spill started are written too, as far as the ring still has them.
+    spilled_ = next_ > capacity_ ? next_ - capacity_ : 0U;
+    spillThread_ = std::thread([this] { spillLoop(); });
+    return true;
+}
+
+void LogStore::stopSpill()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!spillThread_.joinable())
+        {
+            return;
+        }
+        spillStop_ = true;
+    }
+    spillWake_.notify_one();
+    spillThread_.join();
+}
+
+std::uint64_t LogStore::spillDropped() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spillDropped_;
+}
+
+void LogStore::spillLoop()
+{
+    std::ofstream out(spill_.path, std::ios::app | std::ios::ate);
+    std::size_t written = static_cast<std::size_t>(std::max<std::streamoff>(out.tellp(), 0));
+    const auto rotate = [this, &out, &written] {
+        out.close();
+        for (auto index = spill_.keepFiles; index > 1U; --index)
+        {
+            const auto from = spill_.path + "." + std::to_string(index - 1U);
+            std::rename(from.c_str(), (spill_.path + "." + std::to_string(index)).c_str());
+        }
+        if (spill_.keepFiles > 0U)
+        {
+            std::rename(spill_.path.c_str(), (spill_.path + ".1").c_str());
+        }
+        out.open(spill_.path, std::ios::trunc);
+        written = 0U;
+    };
+
+    std::vector<Pending> batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        spillWake_.wait_for(lock, kSpillInterval, [this] { return spillStop_ || next_ - spilled_ >= capacity_ / 2U; });
+        const bool stopping = spillStop_;
+
+        const auto oldest = next_ > capacity_ ? next_ - capacity_ : 0U;
+        if (spilled_ < oldest)
+        {
+            spillDropped_ += oldest - spilled_;
+            spilled_ = oldest;
+        }
+        batch.clear();
+        while (spilled_ < next_ && batch.size() < kSpillBatch)
+        {
+            batch.push_back(pending(spilled_++));
+        }
+        const bool drained = spilled_ == next_;
+
+        lock.unlock();
+        for (const auto &item : batch)
+        {
+            const auto line = formatLine(decode(item)) + '\n';
+            if (written + line.size() > spill_.maxFileBytes && written != 0U)
+            {
+                rotate();
+            }
+            out << line;
+            written += line.size();
+        }
+        out.flush();
+        lock.lock();
+
+        if (stopping && drained)
+        {
+            break;
+        }
+    }
+}
+} // namespace trdp::util
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "util/logging.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace trdp::util
+{
+/** One retained message, decoded for display. */
+struct LogEntry
+{
+    std::uint64_t sequence{0};
+    std::chrono::system_clock::time_point time{};
+    LogLevel level{LogLevel::Info};
+    std::string session;
+    std::uint32_t comId{0};
+    std::string message;
+};
+
+struct LogFilter
+{
+    LogLevel minLevel{LogLevel::Debug};
+    /** Session name as passed to append(); empty matches every message. */
+    std::string session;
+    /** 0 matches every message. */
+    std::uint32_t comId{0};
+};
+
+struct LogPage
+{
+    /** Oldest first. */
+    std::vector<LogEntry> entries;
+    /** Matching messages before the anchor. A lower bound when several criteria are combined. */
+    std::uint64_t total{0};
+    bool exactTotal{true};
+};
+
+/** Rotating file the retained messages are copied to in the background. */
+struct LogSpillOptions
+{
+    std::string path;
+    std::size_t maxFileBytes{16U << 20U};
+    /** Rotated files kept next to `path` as path.1 .. path.N. */
+    unsigned keepFiles{3};
+};
+
+/**
+ * Bounded in-memory log for the Logs panel.
+ *
+ * Messages are stored as fixed-size records in a ring: the text is reduced to an interned
+ * template with up to kMaxArgs decimal numbers cut out as arguments, so a message logged for
+ * every telegram costs one record, not one string. Each level, session and ComID keeps a list of
+ * the sequence numbers it owns; evicting the oldest record pops the front of its three lists.
+ *
+ * A query on one criterion positions by rank in its list(s) and decodes only the rows it
+ * returns. Combined criteria walk the shortest list from the anchor and check the others per
+ * record. Thread-safe.
+ */
+class LogStore
+{
+public:
+    static constexpr std::size_t kMaxArgs = 4U;
+    static constexpr std::size_t kMaxTemplates = 1U << 16U;
+    /** Anchor for query() that follows the newest message. */
+    static constexpr std::uint64_t kLive = std::numeric_limits<std::uint64_t>::max();
+
+    explicit LogStore(std::size_t capacity);
+    ~LogStore();
+
+    LogStore(const LogStore &) = delete;
+    LogStore &operator=(const LogStore &) = delete;
+
+    void append(LogLevel level,
+                const std::string &message,
+                const std::string &session = {},
+                std::uint32_t comId = 0U,
+                std::chrono::system_clock::time_point time = std::chrono::system_clock::now());
+
+    /**
+     * Up to `rows` matching messages that end `skipNewest` matches before `anchor` (a sequence
+     * number, exclusive). Keeping the anchor fixed keeps a scrolled view still while messages
+     * arrive.
+     */
+    [[nodiscard]] LogPage query(const LogFilter &filter,
+                                std::uint64_t anchor,
+                                std::size_t skipNewest,
+                                std::size_t rows) const;
+
+    /** Sequence number the next message will get. */
+    [[nodiscard]] std::uint64_t nextSequence() const;
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::size_t capacity() const { return capacity_; }
+    [[nodiscard]] std::size_t templateCount() const;
+    /** Session names in the order they first logged. */
+    [[nodiscard]] std::vector<std::string> sessions() const;
+    /** ComIDs with at least one retained message, ascending. */
+    [[nodiscard]] std::vector<std::uint32_t> comIds() const;
+
+    /** Starts copying messages to `options.path` on a background thread. */
+    bool startSpill(const LogSpillOptions &options, std::string &error);
+    /** Writes what is still pending and stops the spill thread. */
+    void stopSpill();
+    /** Messages evicted from the ring before the spill thread reached them. */
+    [[nodiscard]] std::uint64_t spillDropped() const;
+
+    /** "[LEVEL] time - session ComID n - message", as written to the spill file. */
+    static std::string formatLine(const LogEntry &entry);
+
+private:
+    struct Record
+    {
+        std::int64_t timeNs{0};
+        std::uint32_t templateId{0};
+        std::uint32_t comId{0};
+        std::uint16_t session{0};
+        std::uint8_t level{0};
+        std::uint8_t argCount{0};
+        std::array<std::uint64_t, kMaxArgs> args{};
+    };
+
+    /** A record copied out under the lock; the strings it points to are never moved or freed. */
+    struct Pending
+    {
+        std::uint64_t sequence;
+        Record record;
+        const std::string *text;
+        const std::string *session;
+    };
+
+    using SequenceList = std::deque<std::uint64_t>;
+
+    std::uint32_t internTemplate(const std::string &text);
+    std::uint16_t sessionId(const std::string &session);
+    void evictOldest();
+    bool matches(const Record &record, const LogFilter &filter, std::uint16_t session) const;
+    Pending pending(std::uint64_t sequence) const;
+    static LogEntry decode(const Pending &pending);
+    void spillLoop();
+
+    const std::size_t capacity_;
+    mutable std::mutex mutex_;
+    std::vector<Record> records_;
+    std::uint64_t next_{0};
+
+    std::array<SequenceList, 4> byLevel_;
+    std::vector<SequenceList> bySession_;
+    std::unordered_map<std::uint32_t, SequenceList> byComId_;
+
+    // Deques so that pointers handed out to readers stay valid while new entries are added.
+    std::unordered_map<std::string, std::uint32_t> templateIds_;
+    std::deque<std::string> templates_;
+    std::unordered_map<std::string, std::uint16_t> sessionIds_;
+    std::deque<std::string> sessionNames_;
+
+    LogSpillOptions spill_;
+    std::thread spillThread_;
+    std::condition_variable spillWake_;
+    bool spillStop_{false};
+    std::uint64_t spilled_{0};
+    std::uint64_t spillDropped_{0};
+};
+} // namespace trdp::util
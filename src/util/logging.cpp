@@ -1,5 +1,8 @@
 #include "util/logging.h"
 
+#include "util/log_store.h"
+
+#include <atomic>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
@@ -16,7 +19,40 @@ std::mutex &logMutex()
     return mutex;
 }
 
-std::string levelToString(LogLevel level)
+std::atomic<bool> consoleEcho{true};
+
+std::mutex &storeMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::shared_ptr<LogStore> &storeSlot()
+{
+    static std::shared_ptr<LogStore> store;
+    return store;
+}
+
+std::shared_ptr<const LogForwarder> &forwarderSlot()
+{
+    static std::shared_ptr<const LogForwarder> forwarder;
+    return forwarder;
+}
+
+std::shared_ptr<const LogForwarder> logForwarder()
+{
+    std::lock_guard<std::mutex> lock(storeMutex());
+    return forwarderSlot();
+}
+
+std::string &threadSession()
+{
+    thread_local std::string session;
+    return session;
+}
+}
+
+const char *logLevelName(LogLevel level)
 {
     switch (level)
     {
@@ -32,7 +68,6 @@ std::string levelToString(LogLevel level)
         return "UNKNOWN";
     }
 }
-}
 
 std::string formatTimestamp(std::chrono::system_clock::time_point ts)
 {
@@ -44,11 +79,54 @@ std::string formatTimestamp(std::chrono::system_clock::time_point ts)
     return oss.str();
 }
 
-void log(LogLevel level, const std::string &message)
+void setThreadLogSession(const std::string &session)
 {
+    threadSession() = session;
+}
+
+void setLogStore(std::shared_ptr<LogStore> store)
+{
+    std::lock_guard<std::mutex> lock(storeMutex());
+    storeSlot() = std::move(store);
+}
+
+std::shared_ptr<LogStore> logStore()
+{
+    std::lock_guard<std::mutex> lock(storeMutex());
+    return storeSlot();
+}
+
+void setLogForwarder(LogForwarder forwarder)
+{
+    auto slot = forwarder ? std::make_shared<const LogForwarder>(std::move(forwarder)) : nullptr;
+    std::lock_guard<std::mutex> lock(storeMutex());
+    forwarderSlot() = std::move(slot);
+}
+
+void setConsoleEcho(bool enabled)
+{
+    consoleEcho.store(enabled);
+}
+
+void log(LogLevel level, const std::string &message, const LogTags &tags)
+{
+    const auto now = std::chrono::system_clock::now();
+    const auto &session = tags.session.empty() ? threadSession() : tags.session;
+    if (const auto store = logStore())
+    {
+        store->append(level, message, session, tags.comId, now);
+    }
+    if (const auto forwarder = logForwarder())
+    {
+        (*forwarder)(level, message, session, tags.comId, now);
+    }
+    if (!consoleEcho.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(logMutex());
-    std::cout << "[" << levelToString(level) << "] " << formatTimestamp(std::chrono::system_clock::now()) << " - "
-              << message << std::endl;
+    std::cout << "[" << logLevelName(level) << "] " << formatTimestamp(now) << " - " << message << std::endl;
 }
 
 } // namespace trdp::util
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 
 namespace trdp::util
 {
+class LogStore;
 
 enum class LogLevel
 {
@@ -14,28 +18,59 @@ enum class LogLevel
     Error,
 };
 
-void log(LogLevel level, const std::string &message);
+/** Optional tags that make a message filterable by session and telegram in the Logs panel. */
+struct LogTags
+{
+    /** Session the message belongs to; empty falls back to the calling thread's session. */
+    std::string session;
+    /** 0 when the message is not about one telegram. */
+    std::uint32_t comId{0};
+};
+
+void log(LogLevel level, const std::string &message, const LogTags &tags = {});
 
-inline void logDebug(const std::string &message)
+inline void logDebug(const std::string &message, const LogTags &tags = {})
 {
-    log(LogLevel::Debug, message);
+    log(LogLevel::Debug, message, tags);
 }
 
-inline void logInfo(const std::string &message)
+inline void logInfo(const std::string &message, const LogTags &tags = {})
 {
-    log(LogLevel::Info, message);
+    log(LogLevel::Info, message, tags);
 }
 
-inline void logWarn(const std::string &message)
+inline void logWarn(const std::string &message, const LogTags &tags = {})
 {
-    log(LogLevel::Warn, message);
+    log(LogLevel::Warn, message, tags);
 }
 
-inline void logError(const std::string &message)
+inline void logError(const std::string &message, const LogTags &tags = {})
 {
-    log(LogLevel::Error, message);
+    log(LogLevel::Error, message, tags);
 }
 
+const char *logLevelName(LogLevel level);
+
 std::string formatTimestamp(std::chrono::system_clock::time_point ts);
 
+/** Session name given to untagged messages logged by the calling thread, e.g. a session's process thread. */
+void setThreadLogSession(const std::string &session);
+
+/** Every message is also kept in `store` while one is set; nullptr detaches it. */
+void setLogStore(std::shared_ptr<LogStore> store);
+[[nodiscard]] std::shared_ptr<LogStore> logStore();
+
+/** Sees every message after the store, with the session it was filed under, e.g. to pass it to another process. */
+using LogForwarder = std::function<void(LogLevel level,
+                                        const std::string &message,
+                                        const std::string &session,
+                                        std::uint32_t comId,
+                                        std::chrono::system_clock::time_point time)>;
+
+/** nullptr stops forwarding. */
+void setLogForwarder(LogForwarder forwarder);
+
+/** Messages go to stdout unless echo is turned off, e.g. while the TUI owns the terminal. */
+void setConsoleEcho(bool enabled);
+
 } // namespace trdp::util
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace trdp::util
+{
+/**
+ * Unbounded lock-free multi-producer/single-consumer queue (Vyukov node-based design).
+ *
+ * push() is wait-free for producers: one atomic exchange plus one release store. tryPop() must only
+ * be called by one consumer at a time. A push that is still linking its node may be invisible to a
+ * concurrent tryPop(); callers pair the queue with a wake-up signal raised after push() returns.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue() : head_(new Node{}), tail_(head_.load(std::memory_order_relaxed)) {}
+
+    ~MpscQueue()
+    {
+        T discarded{};
+        while (tryPop(discarded))
+        {
+        }
+        delete tail_;
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    void push(T value)
+    {
+        auto *node = new Node{std::move(value), {nullptr}};
+        Node *previous = head_.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    bool tryPop(T &out)
+    {
+        Node *tail = tail_;
+        Node *next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return false;
+        }
+
+        // `next` becomes the new stub; its value is moved out and the old stub released.
+        out = std::move(next->value);
+        tail_ = next;
+        delete tail;
+        return true;
+    }
+
+    [[nodiscard]] bool empty() const { return tail_->next.load(std::memory_order_acquire) == nullptr; }
+
+private:
+    struct Node
+    {
+        T value{};
+        std::atomic<Node *> next{nullptr};
+    };
+
+    std::atomic<Node *> head_;
+    Node *tail_;
+};
+} // namespace trdp::util
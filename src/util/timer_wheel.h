@@ -0,0 +1,324 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace trdp::util
+{
+/**
+ * Hierarchical timer wheel (four levels of 256 slots) over an abstract tick counter.
+ *
+ * Timers are preallocated handles. arm(), cancel() and re-arming an armed timer are O(1): a timer
+ * is unlinked from one slot list and linked into another. advance() visits one level-0 slot per
+ * elapsed tick and cascades a higher-level slot every 256 ticks, so its cost depends on elapsed
+ * time and expired timers, never on how many timers are armed. Not thread-safe.
+ */
+class TimerWheel
+{
+public:
+    using TimerId = std::uint32_t;
+    static constexpr TimerId kInvalidTimer = std::numeric_limits<TimerId>::max();
+
+    explicit TimerWheel(std::uint64_t startTick = 0U) : current_(startTick) { heads_.fill(kNil); }
+
+    /** Allocates an unarmed timer carrying `userData` for the expiry callback. */
+    TimerId create(std::uint64_t userData)
+    {
+        TimerId id;
+        if (freeList_ != kNil)
+        {
+            id = freeList_;
+            freeList_ = nodes_[id].next;
+            nodes_[id] = Node{};
+        }
+        else
+        {
+            id = static_cast<TimerId>(nodes_.size());
+            nodes_.push_back(Node{});
+        }
+        nodes_[id].userData = userData;
+        nodes_[id].allocated = true;
+        return id;
+    }
+
+    void destroy(TimerId id)
+    {
+        if (!valid(id))
+        {
+            return;
+        }
+        cancel(id);
+        nodes_[id].allocated = false;
+        nodes_[id].next = freeList_;
+        freeList_ = id;
+    }
+
+    /** Arms (or re-arms) `id` to expire at `expiryTick`; ticks in the past expire on the next advance. */
+    void arm(TimerId id, std::uint64_t expiryTick)
+    {
+        if (!valid(id))
+        {
+            return;
+        }
+        unlink(id);
+        nodes_[id].expiry = expiryTick;
+        link(id, slotFor(expiryTick));
+        ++armed_;
+    }
+
+    void cancel(TimerId id)
+    {
+        if (valid(id) && nodes_[id].list != kNil)
+        {
+            unlink(id);
+        }
+    }
+
+    [[nodiscard]] bool isArmed(TimerId id) const { return valid(id) && nodes_[id].list != kNil; }
+    [[nodiscard]] std::size_t armedCount() const { return armed_; }
+    /** Next tick advance() will process. */
+    [[nodiscard]] std::uint64_t currentTick() const { return current_; }
+
+    /**
+     * Processes every tick up to and including `nowTick`, calling `onExpire(id, userData)` for each
+     * expired timer. The callback may arm, cancel or destroy any timer, including the one firing.
+     */
+    template <typename Fn>
+    std::size_t advance(std::uint64_t nowTick, Fn &&onExpire)
+    {
+        std::size_t fired = 0U;
+        while (current_ <= nowTick)
+        {
+            if (armed_ == 0U)
+            {
+                current_ = nowTick + 1U;
+                break;
+            }
+
+            const auto index = static_cast<std::uint32_t>(current_ & kSlotMask);
+            if (index == 0U)
+            {
+                cascade();
+            }
+
+            // Move the due slot to the pending list first, so timers armed from the callback for
+            // this same tick land in the next one instead of being fired again in this loop.
+            movePending(index);
+            ++current_;
+            while (heads_[kPendingList] != kNil)
+            {
+                const TimerId id = heads_[kPendingList];
+                unlink(id);
+                ++fired;
+                onExpire(id, nodes_[id].userData);
+            }
+        }
+        return fired;
+    }
+
+    /**
+     * Earliest tick at which advance() has work to do (an expiry or a cascade), or std::nullopt when
+     * nothing is armed. Never later than the earliest armed expiry.
+     */
+    [[nodiscard]] std::optional<std::uint64_t> nextEventTick() const
+    {
+        if (armed_ == 0U)
+        {
+            return std::nullopt;
+        }
+
+        // Level-0 slots cover the next 256 ticks; scan forward from the current slot.
+        const auto base = current_ & ~kSlotMask;
+        const auto startIndex = static_cast<std::uint32_t>(current_ & kSlotMask);
+        if (startIndex == 0U && higherLevelsOccupied())
+        {
+            return current_; // the cascade for this wrap has not run yet
+        }
+        for (std::uint32_t word = startIndex / 64U; word < kWords; ++word)
+        {
+            auto bits = occupancy_[0][word];
+            if (word == startIndex / 64U)
+            {
+                bits &= ~std::uint64_t{0} << (startIndex % 64U);
+            }
+            if (bits != 0U)
+            {
+                return base + word * 64U + static_cast<std::uint32_t>(__builtin_ctzll(bits));
+            }
+        }
+
+        // Everything else is at or after the next level-0 wrap, where higher levels cascade.
+        if (higherLevelsOccupied())
+        {
+            return base + kSlots;
+        }
+        for (std::uint32_t word = 0U; word <= startIndex / 64U; ++word)
+        {
+            auto bits = occupancy_[0][word];
+            if (word == startIndex / 64U)
+            {
+                bits &= (std::uint64_t{1} << (startIndex % 64U)) - 1U;
+            }
+            if (bits != 0U)
+            {
+                return base + kSlots + word * 64U + static_cast<std::uint32_t>(__builtin_ctzll(bits));
+            }
+        }
+        return base + kSlots;
+    }
+
+private:
+    static constexpr std::uint32_t kNil = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t kLevels = 4U;
+    static constexpr std::uint32_t kBits = 8U;
+    static constexpr std::uint32_t kSlots = 1U << kBits;
+    static constexpr std::uint64_t kSlotMask = kSlots - 1U;
+    static constexpr std::uint32_t kWords = kSlots / 64U;
+    static constexpr std::uint32_t kPendingList = kLevels * kSlots;
+
+    struct Node
+    {
+        std::uint64_t expiry{0U};
+        std::uint64_t userData{0U};
+        std::uint32_t prev{kNil};
+        std::uint32_t next{kNil};
+        std::uint32_t list{kNil};
+        bool allocated{false};
+    };
+
+    [[nodiscard]] bool higherLevelsOccupied() const
+    {
+        for (std::uint32_t level = 1U; level < kLevels; ++level)
+        {
+            for (const auto word : occupancy_[level])
+            {
+                if (word != 0U)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool valid(TimerId id) const { return id < nodes_.size() && nodes_[id].allocated; }
+
+    [[nodiscard]] std::uint32_t slotFor(std::uint64_t expiry) const
+    {
+        if (expiry < current_)
+        {
+            expiry = current_;
+        }
+        const auto delta = expiry - current_;
+        for (std::uint32_t level = 0U; level < kLevels; ++level)
+        {
+            if (delta < (std::uint64_t{1} << (kBits * (level + 1U))))
+            {
+                return level * kSlots + static_cast<std::uint32_t>((expiry >> (kBits * level)) & kSlotMask);
+            }
+        }
+        // Beyond the wheel's span: park in the farthest slot and re-evaluate on cascade.
+        const auto clamped = current_ + (std::uint64_t{1} << (kBits * kLevels)) - 1U;
+        return (kLevels - 1U) * kSlots + static_cast<std::uint32_t>((clamped >> (kBits * (kLevels - 1U))) & kSlotMask);
+    }
+
+    void link(TimerId id, std::uint32_t list)
+    {
+        auto &node = nodes_[id];
+        node.list = list;
+        node.prev = kNil;
+        node.next = heads_[list];
+        if (node.next != kNil)
+        {
+            nodes_[node.next].prev = id;
+        }
+        heads_[list] = id;
+        setOccupied(list, true);
+    }
+
+    void unlink(TimerId id)
+    {
+        auto &node = nodes_[id];
+        if (node.list == kNil)
+        {
+            return;
+        }
+        if (node.prev != kNil)
+        {
+            nodes_[node.prev].next = node.next;
+        }
+        else
+        {
+            heads_[node.list] = node.next;
+        }
+        if (node.next != kNil)
+        {
+            nodes_[node.next].prev = node.prev;
+        }
+        if (heads_[node.list] == kNil)
+        {
+            setOccupied(node.list, false);
+        }
+        node.list = kNil;
+        node.prev = kNil;
+        node.next = kNil;
+        --armed_;
+    }
+
+    void setOccupied(std::uint32_t list, bool occupied)
+    {
+        if (list >= kPendingList)
+        {
+            return;
+        }
+        auto &word = occupancy_[list / kSlots][(list % kSlots) / 64U];
+        const auto bit = std::uint64_t{1} << (list % 64U);
+        word = occupied ? (word | bit) : (word & ~bit);
+    }
+
+    void movePending(std::uint32_t list)
+    {
+        // Pending is empty here; splice the whole slot list over and retag its nodes.
+        heads_[kPendingList] = heads_[list];
+        heads_[list] = kNil;
+        setOccupied(list, false);
+        for (auto id = heads_[kPendingList]; id != kNil; id = nodes_[id].next)
+        {
+            nodes_[id].list = kPendingList;
+        }
+    }
+
+    void cascade()
+    {
+        for (std::uint32_t level = 1U; level < kLevels; ++level)
+        {
+            const auto index = static_cast<std::uint32_t>((current_ >> (kBits * level)) & kSlotMask);
+            const auto list = level * kSlots + index;
+            auto id = heads_[list];
+            heads_[list] = kNil;
+            setOccupied(list, false);
+            while (id != kNil)
+            {
+                const auto next = nodes_[id].next;
+                nodes_[id].list = kNil;
+                link(id, slotFor(nodes_[id].expiry));
+                id = next;
+            }
+            if (index != 0U)
+            {
+                break;
+            }
+        }
+    }
+
+    std::uint64_t current_;
+    std::size_t armed_{0U};
+    std::vector<Node> nodes_;
+    std::uint32_t freeList_{kNil};
+    std::array<std::uint32_t, kLevels * kSlots + 1U> heads_{};
+    std::array<std::array<std::uint64_t, kWords>, kLevels> occupancy_{};
+};
+} // namespace trdp::util
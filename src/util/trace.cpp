@@ -0,0 +1,254 @@
+#include "util/trace.h"
+
+#include "util/logging.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace trdp::util::trace
+{
+namespace
+{
+/**
+ * Events of one thread. Only the owning thread writes; a dump copies the ring and keeps the
+ * entries the writer cannot have touched meanwhile.
+ */
+struct ThreadRing
+{
+    long tid{0};
+    std::string name;
+    std::unique_ptr<Event[]> events{new Event[kRingCapacity]};
+    std::atomic<std::uint64_t> written{0};
+    /** Dumps before this index ignore older entries (see clear()). */
+    std::atomic<std::uint64_t> clearedAt{0};
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+};
+
+std::atomic<bool> recording{false};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+struct ThreadState
+{
+    std::shared_ptr<ThreadRing> ring;
+    std::string name;
+};
+
+ThreadState &threadState()
+{
+    thread_local ThreadState state;
+    return state;
+}
+
+/** The ring is only allocated once the thread records something. */
+ThreadRing &threadRing()
+{
+    auto &state = threadState();
+    if (!state.ring)
+    {
+        // Rings stay registered after their thread exits, so a dump still shows what it did.
+        auto created = std::make_shared<ThreadRing>();
+        created->tid = static_cast<long>(::syscall(SYS_gettid));
+        created->name = state.name;
+        auto &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.rings.push_back(created);
+        state.ring = std::move(created);
+    }
+    return *state.ring;
+}
+
+void writeEscaped(std::ostream &out, const std::string &text)
+{
+    out << '"';
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20U)
+        {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        }
+        else
+        {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+/** Chrome traces count in microseconds; fractions keep the nanosecond resolution. */
+void writeMicros(std::ostream &out, std::int64_t ns)
+{
+    out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << (ns % 1000 + 1000) % 1000;
+}
+} // namespace
+
+void setEnabled(bool enabled)
+{
+    recording.store(enabled, std::memory_order_relaxed);
+}
+
+bool enabled()
+{
+    return recording.load(std::memory_order_relaxed);
+}
+
+void setThreadName(const std::string &name)
+{
+    auto &state = threadState();
+    state.name = name;
+    if (state.ring)
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        state.ring->name = name;
+    }
+}
+
+void record(const Event &event)
+{
+    auto &ring = threadRing();
+    const auto index = ring.written.load(std::memory_order_relaxed);
+    ring.events[index % kRingCapacity] = event;
+    ring.written.store(index + 1U, std::memory_order_release);
+}
+
+void clear()
+{
+    auto &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto &ring : reg.rings)
+    {
+        ring->clearedAt.store(ring->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+long writeChromeJson(const std::string &path)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        return -1;
+    }
+
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    {
+        auto &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        rings = reg.rings;
+    }
+
+    const auto pid = static_cast<long>(::getpid());
+    long count = 0;
+    std::vector<Event> copy;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    const auto separator = [&out, &first] {
+        if (!first)
+        {
+            out << ",\n";
+        }
+        first = false;
+    };
+
+    for (const auto &ring : rings)
+    {
+        std::string name;
+        {
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            name = ring->name;
+        }
+        if (!name.empty())
+        {
+            separator();
+            out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid << ",\"tid\":" << ring->tid
+                << ",\"args\":{\"name\":";
+            writeEscaped(out, name);
+            out << "}}";
+        }
+
+        const auto end = ring->written.load(std::memory_order_acquire);
+        const auto oldest = std::max<std::uint64_t>(end > kRingCapacity ? end - kRingCapacity : 0U,
+                                                    ring->clearedAt.load(std::memory_order_relaxed));
+        copy.clear();
+        for (auto index = oldest; index < end; ++index)
+        {
+            copy.push_back(ring->events[index % kRingCapacity]);
+        }
+        // The writer may have lapped the copy; anything at or below its current slot is suspect.
+        const auto after = ring->written.load(std::memory_order_acquire);
+        const auto firstValid = after >= kRingCapacity ? after - kRingCapacity + 1U : 0U;
+
+        for (std::size_t i = 0; i < copy.size(); ++i)
+        {
+            if (oldest + i < firstValid || copy[i].name == nullptr)
+            {
+                continue;
+            }
+            const auto &event = copy[i];
+            separator();
+            out << "{\"name\":";
+            writeEscaped(out, event.name);
+            out << ",\"pid\":" << pid << ",\"tid\":" << ring->tid << ",\"ts\":";
+            writeMicros(out, event.startNs);
+            switch (event.type)
+            {
+            case EventType::Span:
+                out << ",\"ph\":\"X\",\"dur\":";
+                writeMicros(out, event.durationNs);
+                break;
+            case EventType::Counter:
+                out << ",\"ph\":\"C\"";
+                break;
+            case EventType::Instant:
+                out << ",\"ph\":\"i\",\"s\":\"t\"";
+                break;
+            }
+            if (event.type == EventType::Counter)
+            {
+                out << ",\"args\":{\"value\":" << event.arg << '}';
+            }
+            else if (event.argName != nullptr)
+            {
+                out << ",\"args\":{";
+                writeEscaped(out, event.argName);
+                out << ':' << event.arg << '}';
+            }
+            out << '}';
+            ++count;
+        }
+    }
+    out << "\n]}\n";
+    out.flush();
+    return out ? count : -1;
+}
+
+void dumpToFile(const std::string &path)
+{
+    const auto written = writeChromeJson(path);
+    if (written < 0)
+    {
+        logWarn("Could not write trace file " + path);
+        return;
+    }
+    logInfo("Wrote " + std::to_string(written) + " trace events to " + path);
+}
+} // namespace trdp::util::trace
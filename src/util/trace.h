@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace trdp::util::trace
+{
+enum class EventType : std::uint8_t
+{
+    Span,
+    Counter,
+    Instant,
+};
+
+/** One recorded event. Names must be string literals: only the pointer is stored. */
+struct Event
+{
+    const char *name{nullptr};
+    const char *argName{nullptr};
+    std::int64_t arg{0};
+    std::int64_t startNs{0};
+    std::int64_t durationNs{0};
+    EventType type{EventType::Span};
+};
+
+/** Events kept per thread; older ones are overwritten. */
+constexpr std::size_t kRingCapacity = 1U << 16U;
+
+/** Recording is off until enabled; a disabled probe costs one relaxed load. */
+void setEnabled(bool enabled);
+[[nodiscard]] bool enabled();
+
+/** Names the calling thread in the trace (Chrome "thread_name" metadata). */
+void setThreadName(const std::string &name);
+
+void record(const Event &event);
+
+/**
+ * Writes every retained event of every thread as Chrome Trace Event JSON, which chrome://tracing
+ * and ui.perfetto.dev both load. Safe to call while threads keep recording; events overwritten
+ * during the copy are left out. Returns the number of events written, or -1 if the file could not
+ * be written.
+ */
+long writeChromeJson(const std::string &path);
+
+/** writeChromeJson() with the outcome logged. */
+void dumpToFile(const std::string &path);
+
+/** Drops every retained event, e.g. between two measurements. */
+void clear();
+
+inline std::int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/** Records the enclosing scope as one complete span. */
+class ScopedSpan
+{
+public:
+    explicit ScopedSpan(const char *name, const char *argName = nullptr, std::int64_t arg = 0)
+    {
+        if (enabled())
+        {
+            event_.name = name;
+            event_.argName = argName;
+            event_.arg = arg;
+            event_.startNs = nowNs();
+        }
+    }
+
+    ~ScopedSpan()
+    {
+        if (event_.name != nullptr)
+        {
+            event_.durationNs = nowNs() - event_.startNs;
+            record(event_);
+        }
+    }
+
+    ScopedSpan(const ScopedSpan &) = delete;
+    ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+private:
+    Event event_{};
+};
+
+inline void counter(const char *name, std::int64_t value)
+{
+    if (enabled())
+    {
+        record(Event{name, nullptr, value, nowNs(), 0, EventType::Counter});
+    }
+}
+
+inline void instant(const char *name, const char *argName = nullptr, std::int64_t arg = 0)
+{
+    if (enabled())
+    {
+        record(Event{name, argName, arg, nowNs(), 0, EventType::Instant});
+    }
+}
+} // namespace trdp::util::trace
+
+// Probes for the hot paths. They compile to nothing unless the build sets TRDP_TRACING
+// (CMake option TRDP_ENABLE_TRACING).
+#define TRDP_TRACE_CONCAT_INNER(a, b) a##b
+#define TRDP_TRACE_CONCAT(a, b) TRDP_TRACE_CONCAT_INNER(a, b)
+
+#if defined(TRDP_TRACING) && TRDP_TRACING
+#define TRDP_TRACE_SCOPE(name) ::trdp::util::trace::ScopedSpan TRDP_TRACE_CONCAT(traceSpan, __LINE__)(name)
+#define TRDP_TRACE_SCOPE_ARG(name, argName, arg)                                                                       \
+    ::trdp::util::trace::ScopedSpan TRDP_TRACE_CONCAT(traceSpan, __LINE__)(name, argName,                              \
+                                                                           static_cast<std::int64_t>(arg))
+#define TRDP_TRACE_COUNTER(name, value) ::trdp::util::trace::counter(name, static_cast<std::int64_t>(value))
+#define TRDP_TRACE_INSTANT(name) ::trdp::util::trace::instant(name)
+#define TRDP_TRACE_THREAD_NAME(name) ::trdp::util::trace::setThreadName(name)
+namespace trdp::util::trace
+{
+constexpr bool kProbesCompiledIn = true;
+}
+#else
+#define TRDP_TRACE_SCOPE(name) static_cast<void>(0)
+#define TRDP_TRACE_SCOPE_ARG(name, argName, arg) static_cast<void>(0)
+#define TRDP_TRACE_COUNTER(name, value) static_cast<void>(0)
+#define TRDP_TRACE_INSTANT(name) static_cast<void>(0)
+#define TRDP_TRACE_THREAD_NAME(name) static_cast<void>(0)
+namespace trdp::util::trace
+{
+constexpr bool kProbesCompiledIn = false;
+}
+#endif
@@ -0,0 +1,178 @@
+#include "config/cli_options.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using trdp::config::parseCommandLine;
+using trdp::model::SchedulingPolicy;
+
+namespace
+{
+trdp::config::CommandLineParseResult parse(std::vector<const char *> args)
+{
+    args.insert(args.begin(), "trdp_simulator");
+    return parseCommandLine(static_cast<int>(args.size()), args.data());
+}
+} // namespace
+
+int main()
+{
+    const auto defaults = parse({});
+    if (defaults.hasErrors() || defaults.options.configPath != "config.xml" ||
+        defaults.options.realtime.policy != SchedulingPolicy::Inherit)
+    {
+        std::cerr << "Empty command line should keep the defaults" << std::endl;
+        return 1;
+    }
+
+    const auto full = parse({"--rt-priority", "80", "--rt-cpus", "2-3", "--rt-cpus=eth1=5", "--mlock",
+                             "--prefault-stack", "256", "--rt-isolate", "cfg.xml"});
+    if (full.hasErrors())
+    {
+        for (const auto &error : full.errors)
+        {
+            std::cerr << error << std::endl;
+        }
+        return 1;
+    }
+
+    const auto &options = full.options;
+    if (options.configPath != "cfg.xml" || options.realtime.policy != SchedulingPolicy::Fifo ||
+        options.realtime.priority != 80 || options.realtime.cpus != std::vector<int>{2, 3} ||
+        options.interfaceCpus.count("eth1") != 1U || options.interfaceCpus.at("eth1") != std::vector<int>{5} ||
+        !options.realtime.lockMemory || options.realtime.prefaultStackBytes != 256U * 1024U || !options.isolateCpus)
+    {
+        std::cerr << "Real-time options were not parsed as given" << std::endl;
+        return 1;
+    }
+
+    const auto rr = parse({"--rt-policy", "rr"});
+    if (rr.hasErrors() || rr.options.realtime.policy != SchedulingPolicy::RoundRobin || rr.options.realtime.priority == 0)
+    {
+        std::cerr << "Round-robin without a priority should get a default priority" << std::endl;
+        return 1;
+    }
+
+    const auto xml = parse({"--rt-policy", "xml"});
+    if (xml.hasErrors() || xml.options.realtime.policy != SchedulingPolicy::XmlPriority || xml.options.realtime.priority != 0)
+    {
+        std::cerr << "--rt-policy xml should leave the priority to the XML" << std::endl;
+        return 1;
+    }
+    if (!parse({"--rt-policy", "xml", "--rt-priority", "80"}).hasErrors())
+    {
+        std::cerr << "--rt-policy xml with an explicit priority should be rejected" << std::endl;
+        return 1;
+    }
+
+    const auto invalid = parse({"--rt-priority", "120", "--rt-cpus", "x", "--bogus", "a.xml", "b.xml"});
+    if (invalid.errors.size() != 4U)
+    {
+        std::cerr << "Expected four errors for invalid arguments, got " << invalid.errors.size() << std::endl;
+        return 1;
+    }
+
+    const auto raw = parse({"--raw-gen", "--raw-batch", "128", "--raw-txtime", "--raw-speedup=10"});
+    if (raw.hasErrors() || !raw.options.rawGenerator.enabled || raw.options.rawGenerator.batchSize != 128U ||
+        !raw.options.rawGenerator.txTime || raw.options.rawGenerator.speedup != 10U)
+    {
+        std::cerr << "Raw generator options were not parsed as given" << std::endl;
+        return 1;
+    }
+
+    const auto sharded = parse({"--shard", "--rt-cpus", "eth0=2", "cfg.xml"});
+    if (sharded.hasErrors() || !sharded.options.shard.enabled || sharded.options.shard.isWorker() ||
+        sharded.options.shard.forwardedArguments != std::vector<std::string>{"--shard", "--rt-cpus", "eth0=2", "cfg.xml"})
+    {
+        std::cerr << "--shard should be parsed and the command line kept for the workers" << std::endl;
+        return 1;
+    }
+
+    const auto worker = parse({"--shard", "cfg.xml", "--shard-worker", "1:7:8:9:10"});
+    if (worker.hasErrors() || worker.options.shard.workerInterface != 1 || worker.options.shard.stateFd != 7 ||
+        worker.options.shard.commandFd != 8 || worker.options.shard.wakeFd != 9 || worker.options.shard.logFd != 10 ||
+        worker.options.shard.forwardedArguments.size() != 2U)
+    {
+        std::cerr << "Shard worker specification was not parsed as given" << std::endl;
+        return 1;
+    }
+
+    if (parse({"--shard-worker", "1:7"}).errors.size() != 1U || parse({"--shard-worker", "1:7:8:9"}).errors.size() != 1U ||
+        parse({"--shard", "--raw-gen"}).errors.size() != 1U)
+    {
+        std::cerr << "Invalid shard options should be rejected" << std::endl;
+        return 1;
+    }
+
+    const auto logging = parse({"--log-capacity", "100000", "--log-file=sim.log", "--log-file-size", "4"});
+    if (logging.hasErrors() || logging.options.logging.capacity != 100000U ||
+        logging.options.logging.spillPath != "sim.log" || logging.options.logging.spillFileBytes != 4U << 20U ||
+        parse({"--log-capacity", "10"}).errors.size() != 1U)
+    {
+        std::cerr << "Log options were not parsed as given" << std::endl;
+        return 1;
+    }
+
+    const auto recording = parse({"--record", "run.trec", "--record-segment=16", "--record-codec", "delta"});
+    if (recording.hasErrors() || recording.options.recording.path != "run.trec" ||
+        recording.options.recording.segmentBytes != 16U << 20U ||
+        recording.options.recording.codec != trdp::model::RecordingCodec::Delta ||
+        parse({"--record-segment", "0"}).errors.size() != 1U || parse({"--record-codec", "zip"}).errors.size() != 1U)
+    {
+        std::cerr << "Recording options were not parsed as given" << std::endl;
+        return 1;
+    }
+
+    const auto exported = parse({"--export", "out", "--export-format=npy"});
+    if (exported.hasErrors() || exported.options.valueExport.directory != "out" ||
+        exported.options.valueExport.format != trdp::model::ExportFormat::Npy ||
+        parse({"--export-format", "xlsx"}).errors.size() != 1U)
+    {
+        std::cerr << "Export options were not parsed as given" << std::endl;
+        return 1;
+    }
+
+    const auto generated = parse({"--gen", "1001:speed=sine(0,120,500)", "--gen=1001:flags[2]=toggle(0x05)",
+                                  "--gen", "1001:count=counter"});
+    const auto &rules = generated.options.generators;
+    if (generated.hasErrors() || rules.size() != 3U || rules[0].comId != 1001U || rules[0].field != "speed" ||
+        rules[0].kind != trdp::model::FieldGeneratorKind::Sine ||
+        rules[0].args != std::vector<double>{0.0, 120.0, 500.0} || rules[1].field != "flags[2]" || rules[1].args != std::vector<double>{5.0, 0.0} ||
+        rules[2].args != std::vector<double>{0.0, 1.0})
+    {
+        std::cerr << "Generator rules were not parsed as given" << std::endl;
+        return 1;
+    }
+    for (const char *invalid : {"speed=const(1)", "1001:speed", "1001:speed=wave(1)", "1001:speed=const(1,2)",
+                                "1001:speed=ramp(5,1)", "1001:speed=sine(0,1,2.5)", "1001:speed=table(1,)",
+                                "1001:speed=const(x)", "1001:speed=counter(1"})
+    {
+        if (parse({"--gen", invalid}).errors.size() != 1U)
+        {
+            std::cerr << "--gen " << invalid << " should be rejected" << std::endl;
+            return 1;
+        }
+    }
+
+    const auto scripted =
+        parse({"--scenario", "doors.scn", "--scenario-report=doors.csv", "--headless", "--control", "/tmp/sim.sock"});
+    if (scripted.hasErrors() || scripted.options.scenario.path != "doors.scn" ||
+        scripted.options.control.socketPath != "/tmp/sim.sock" || parse({"--control"}).errors.size() != 1U ||
+        parse({"--state-export", "trdp", "--state-export-interval", "200"}).options.stateExport.interval !=
+            std::chrono::milliseconds(200) ||
+        parse({"--state-export-interval", "5"}).errors.size() != 1U ||
+        scripted.options.scenario.reportPath != "doors.csv" || !scripted.options.headless ||
+        parse({"--scenario-report", "doors.csv"}).errors.size() != 1U)
+    {
+        std::cerr << "Scenario options were not parsed as given" << std::endl;
+        return 1;
+    }
+
+    if (!parse({"--help"}).showHelp)
+    {
+        std::cerr << "--help should request usage output" << std::endl;
+        return 1;
+    }
+    return 0;
+}
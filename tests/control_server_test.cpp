@@ -0,0 +1,352 @@
+#include "control/control_server.h"
+
+#include "fake_endpoint.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using trdp::control::ControlServer;
+using trdp::runtime::PdDirection;
+using trdp::test::FakeEndpoint;
+using trdp::util::JsonType;
+using trdp::util::JsonValue;
+
+namespace
+{
+class Connection
+{
+public:
+    explicit Connection(const std::string &path)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1U);
+        fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        const timeval timeout{5, 0};
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        if (::connect(fd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+    ~Connection()
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    [[nodiscard]] bool connected() const { return fd_ >= 0; }
+
+    void send(const std::string &bytes) { (void)::send(fd_, bytes.data(), bytes.size(), MSG_NOSIGNAL); }
+
+    /** The next reply line, parsed; a Null value on timeout or bad JSON. */
+    JsonValue line()
+    {
+        std::size_t newline = std::string::npos;
+        while ((newline = buffer_.find('\n')) == std::string::npos && fill())
+        {
+        }
+        JsonValue value;
+        if (newline != std::string::npos)
+        {
+            std::string error;
+            trdp::util::parseJson(std::string_view(buffer_).substr(0, newline), value, error);
+            buffer_.erase(0, newline + 1U);
+        }
+        return value;
+    }
+
+    /** The next reply frame as status, ComID and body; status 255 on timeout. */
+    std::uint8_t frame(std::uint32_t &comId, std::string &body)
+    {
+        while ((buffer_.size() < 4U || buffer_.size() < 4U + length()) && fill())
+        {
+        }
+        if (buffer_.size() < 4U || buffer_.size() < 4U + length())
+        {
+            return 255U;
+        }
+        const auto total = length();
+        const auto status = static_cast<std::uint8_t>(buffer_[4]);
+        comId = u32(5U);
+        body = buffer_.substr(9U, total - 5U);
+        buffer_.erase(0, 4U + total);
+        return status;
+    }
+
+private:
+    bool fill()
+    {
+        char chunk[4096];
+        const auto count = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (count <= 0)
+        {
+            return false;
+        }
+        buffer_.append(chunk, static_cast<std::size_t>(count));
+        return true;
+    }
+
+    std::uint32_t u32(std::size_t at) const
+    {
+        const auto *bytes = reinterpret_cast<const std::uint8_t *>(buffer_.data() + at);
+        return (std::uint32_t{bytes[0]} << 24U) | (std::uint32_t{bytes[1]} << 16U) |
+               (std::uint32_t{bytes[2]} << 8U) | std::uint32_t{bytes[3]};
+    }
+    std::uint32_t length() const { return u32(0U); }
+
+    int fd_{-1};
+    std::string buffer_;
+};
+
+void appendU32(std::string &out, std::uint32_t value)
+{
+    out.push_back(static_cast<char>(value >> 24U));
+    out.push_back(static_cast<char>(value >> 16U));
+    out.push_back(static_cast<char>(value >> 8U));
+    out.push_back(static_cast<char>(value));
+}
+
+std::string frame(std::uint8_t op, std::uint32_t comId, const std::string &body)
+{
+    std::string out;
+    appendU32(out, static_cast<std::uint32_t>(5U + body.size()));
+    out.push_back(static_cast<char>(op));
+    appendU32(out, comId);
+    return out + body;
+}
+
+bool okWith(const JsonValue &result, double endpoints)
+{
+    const auto *ok = result.find("ok");
+    const auto *count = result.find("endpoints");
+    return ok != nullptr && ok->boolean && count != nullptr && count->number == endpoints;
+}
+
+std::string errorOf(const JsonValue &result)
+{
+    const auto *error = result.find("error");
+    return error != nullptr ? error->string : "";
+}
+
+bool checkJson()
+{
+    JsonValue value;
+    std::string error;
+    if (!trdp::util::parseJson(R"({"a":[1,-2.5e1,true,null],"b":"x\u00e9\ud83d\ude00\n"})", value, error) ||
+        value.find("a")->items.size() != 4U || value.find("a")->items[1].number != -25.0 ||
+        value.find("b")->string != "x\xC3\xA9\xF0\x9F\x98\x80\n" || trdp::util::parseJson("{\"a\":1,}", value, error) ||
+        trdp::util::parseJson("[1] 2", value, error) || trdp::util::parseJson(std::string(100, '['), value, error))
+    {
+        std::cerr << "JSON parsing is wrong: " << error << std::endl;
+        return false;
+    }
+    std::string quoted;
+    trdp::util::appendJsonString(quoted, "a\"b\\\x01");
+    std::vector<std::uint8_t> bytes;
+    if (quoted != R"("a\"b\\\u0001")" || !trdp::util::parseHexBytes("00fF", bytes) || bytes.size() != 2U ||
+        bytes[1] != 0xFFU || trdp::util::parseHexBytes("0", bytes) || trdp::util::parseHexBytes("zz", bytes))
+    {
+        std::cerr << "JSON/hex formatting is wrong: " << quoted << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkServer(const std::string &path)
+{
+    auto doors = std::make_shared<FakeEndpoint>(PdDirection::Outgoing);
+    auto status = std::make_shared<FakeEndpoint>(PdDirection::Incoming);
+    ControlServer server;
+    server.add(300U, doors);
+    server.add(301U, status);
+    std::vector<std::string> pauses;
+    server.setPauseHandler([&pauses](bool paused, const std::string &interfaceName) -> std::size_t {
+        pauses.push_back((paused ? "pause " : "resume ") + (interfaceName.empty() ? "*" : interfaceName));
+        return interfaceName.empty() || interfaceName == "eth0" ? 2U : 0U;
+    });
+    std::string error;
+    if (!server.start(path, error))
+    {
+        std::cerr << error << std::endl;
+        return false;
+    }
+
+    Connection client(path);
+    if (!client.connected())
+    {
+        std::cerr << "Could not connect to " << path << std::endl;
+        return false;
+    }
+
+    client.send("{\"id\":\"a\",\"op\":\"start\",\"comId\":300}\n");
+    const auto started = client.line();
+    if (!okWith(started, 1.0) || started.find("id")->string != "a")
+    {
+        std::cerr << "start failed: " << errorOf(started) << std::endl;
+        return false;
+    }
+
+    // One line, one batch: every operation runs in order and answers in one array.
+    client.send("[{\"id\":1,\"op\":\"set\",\"comId\":300,\"payload\":\"0102\"},{\"op\":\"stop\",\"comId\":301},"
+                "{\"op\":\"start\",\"comId\":300,\"cycleUs\":5000},{\"op\":\"reboot\"}]\n{oops\n");
+    const auto batch = client.line();
+    const auto invalid = client.line();
+    if (batch.type != JsonType::Array || batch.items.size() != 4U || !okWith(batch.items[0], 1.0) ||
+        batch.items[0].find("id")->number != 1.0 ||
+        errorOf(batch.items[1]) != "ComID 301 is not transmitted by this device" || !okWith(batch.items[2], 1.0) ||
+        errorOf(batch.items[3]) != "unknown op 'reboot'" || errorOf(invalid).rfind("invalid JSON", 0) != 0)
+    {
+        std::cerr << "Unexpected batch reply" << std::endl;
+        return false;
+    }
+    if (doors->callTexts() != std::vector<std::string>{"start 20000", "tx 0102", "start 5000"})
+    {
+        std::cerr << "The endpoint did not see the batch in order" << std::endl;
+        return false;
+    }
+
+    client.send("[{\"op\":\"pause\"},{\"op\":\"resume\",\"interface\":\"eth1\"},{\"op\":\"resume\",\"interface\":7}]\n");
+    const auto paused = client.line();
+    if (paused.items.size() != 3U || paused.items[0].find("sessions")->number != 2.0 ||
+        errorOf(paused.items[1]) != "no session on interface 'eth1'" ||
+        errorOf(paused.items[2]) != "\"interface\" must be a string" ||
+        pauses != std::vector<std::string>{"pause *", "resume eth1"})
+    {
+        std::cerr << "Unexpected pause replies" << std::endl;
+        return false;
+    }
+
+    doors->setAccepting(false);
+    client.send("{\"op\":\"stop\",\"comId\":300}\n");
+    const auto refused = client.line();
+    doors->setAccepting(true);
+    if (errorOf(refused) != "ComID 300: 'stop' failed on 1 of 1 endpoint(s)")
+    {
+        std::cerr << "A command the endpoint did not take was reported as applied" << std::endl;
+        return false;
+    }
+
+    client.send("{\"op\":\"stats\",\"comId\":300,\"payloads\":true}\n");
+    const auto stats = client.line();
+    const auto *telegrams = stats.find("telegrams");
+    if (telegrams == nullptr || telegrams->items.size() != 1U || telegrams->items[0].find("tx")->string != "0102" ||
+        telegrams->items[0].find("destinations")->number != 1.0)
+    {
+        std::cerr << "Unexpected stats reply" << std::endl;
+        return false;
+    }
+
+    // The first delta carries every telegram, later ones only what changed.
+    client.send("{\"op\":\"subscribe\",\"intervalMs\":10}\n");
+    const auto subscribed = client.line();
+    const auto first = client.line();
+    doors->setPublishCount(7U);
+    const auto second = client.line();
+    client.send("{\"op\":\"unsubscribe\"}\n");
+    if (!subscribed.find("ok")->boolean || first.find("event") == nullptr ||
+        first.find("telegrams")->items.size() != 2U || second.find("telegrams") == nullptr ||
+        second.find("telegrams")->items.size() != 1U ||
+        second.find("telegrams")->items[0].find("publishCount")->number != 7.0)
+    {
+        std::cerr << "Unexpected state deltas" << std::endl;
+        return false;
+    }
+    // Deltas already queued before the unsubscribe are skipped up to its reply.
+    while (true)
+    {
+        const auto reply = client.line();
+        if (reply.type == JsonType::Null)
+        {
+            std::cerr << "No reply to unsubscribe" << std::endl;
+            return false;
+        }
+        if (reply.find("event") == nullptr)
+        {
+            break;
+        }
+    }
+
+    client.send("{\"op\":\"binary\"}\n" + frame(4U, 300U, std::string("\x00\xFF", 2)) + frame(2U, 999U, "") +
+                frame(6U, 0U, "[{\"op\":\"list\"},{\"op\":\"quit\"}]"));
+    std::uint32_t comId = 0U;
+    std::string body;
+    const auto binary = client.line();
+    const auto fixed = client.frame(comId, body);
+    const bool fixedOk = fixed == 0U && comId == 300U && body.empty();
+    const auto unknown = client.frame(comId, body);
+    const bool unknownOk = unknown == 1U && comId == 999U && body == "unknown ComID 999";
+    const auto json = client.frame(comId, body);
+    JsonValue listed;
+    if (!binary.find("ok")->boolean || !fixedOk || !unknownOk || json != 0U ||
+        !trdp::util::parseJson(body, listed, error) || listed.items.size() != 2U ||
+        listed.items[0].find("telegrams")->items[1].find("direction")->string != "in" || !server.quitRequested() ||
+        doors->callTexts().back() != "fixed 00ff")
+    {
+        std::cerr << "Unexpected binary replies" << std::endl;
+        return false;
+    }
+
+    server.stop();
+    const auto totals = server.stats();
+    if (totals.connections != 1U || totals.requests != 12U || totals.operations != 17U || totals.deltas < 2U ||
+        std::filesystem::exists(path))
+    {
+        std::cerr << "Unexpected totals: " << totals.requests << " requests, " << totals.operations << " operations"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkStaleSocket(const std::string &path)
+{
+    // A socket file left by a crashed run is replaced; a regular file is not.
+    ControlServer first;
+    std::string error;
+    if (!first.start(path, error))
+    {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    // Only the owner may connect.
+    const auto perms = std::filesystem::status(path).permissions();
+    const bool ownerOnly = (perms & (std::filesystem::perms::group_all | std::filesystem::perms::others_all)) ==
+                           std::filesystem::perms::none;
+    ControlServer second;
+    const bool replaced = second.start(path, error);
+    second.stop();
+    first.stop();
+
+    { std::ofstream(path) << "keep"; }
+    ControlServer third;
+    const bool refused = !third.start(path, error) && error == path + " exists and is not a socket";
+    std::filesystem::remove(path);
+    if (!ownerOnly || !replaced || !refused || ControlServer().start(std::string(200, 'x'), error))
+    {
+        std::cerr << "Socket path handling is wrong: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    const auto path =
+        (std::filesystem::temp_directory_path() / ("control_test_" + std::to_string(::getpid()) + ".sock")).string();
+    const bool ok = checkJson() && checkServer(path) && checkStaleSocket(path);
+    std::filesystem::remove(path);
+    return ok ? 0 : 1;
+}
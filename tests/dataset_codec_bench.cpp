@@ -0,0 +1,108 @@
+// Generated versus generic dataset marshalling for every fixed-size dataset in example.xml.
+//
+//   dataset_codec_bench [ROUNDS]
+//
+// Each round decodes a wire image into host values and encodes it back, once through the generated
+// DatasetCodec specialisation and once through the layout-driven marshalDataset/unmarshalDataset.
+
+#include "config/dataset_codec.h"
+#include "config/xml_loader.h"
+#include "example_datasets/example_datasets.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+using trdp::config::DatasetCodec;
+using trdp::config::DatasetScalar;
+using trdp::model::SimulatorConfig;
+
+namespace
+{
+std::filesystem::path exampleXmlPath()
+{
+    auto path = std::filesystem::path(__FILE__).parent_path();
+    return path / ".." / "external" / "TCNopen" / "trdp" / "example" / "example.xml";
+}
+
+template <typename Body>
+double nanosPerRound(std::size_t rounds, Body &&body)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        body(round);
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(rounds);
+}
+
+template <typename T>
+void benchDataset(const SimulatorConfig &config, std::size_t rounds)
+{
+    using Codec = DatasetCodec<T>;
+    const auto layout = trdp::config::flattenDataset(config, Codec::kId);
+    if (!layout)
+    {
+        return;
+    }
+
+    std::vector<DatasetScalar> values(trdp::config::scalarCount(*layout));
+    for (std::size_t index = 0; index < values.size(); ++index)
+    {
+        values[index].integer = static_cast<std::int64_t>(index * 2654435761U);
+        values[index].real = static_cast<double>(index) * 0.25;
+    }
+    std::vector<std::uint8_t> wire(Codec::kWireSize);
+    std::vector<std::uint8_t> out(Codec::kWireSize);
+    trdp::config::marshalDataset(*layout, values, wire.data(), wire.size());
+
+    // Vary one byte per round so neither loop can be hoisted; the sink keeps the results alive.
+    unsigned sink = 0U;
+    T value{};
+    const auto generated = nanosPerRound(rounds, [&](std::size_t round) {
+        wire[round % wire.size()] ^= 1U;
+        trdp::config::decodeDataset(wire.data(), value);
+        trdp::config::encodeDataset(value, out.data());
+        sink += out[round % out.size()];
+    });
+    const auto generic = nanosPerRound(rounds, [&](std::size_t round) {
+        wire[round % wire.size()] ^= 1U;
+        trdp::config::unmarshalDataset(*layout, wire.data(), wire.size(), values);
+        trdp::config::marshalDataset(*layout, values, out.data(), out.size());
+        sink += out[round % out.size()];
+    });
+
+    std::cout << std::left << std::setw(8) << Codec::kId << std::right << std::setw(8) << Codec::kWireSize
+              << std::setw(8) << values.size() << std::fixed << std::setprecision(1) << std::setw(14) << generated
+              << std::setw(14) << generic << std::setw(9) << generic / generated << "x"
+              << (sink == 0xFFFFFFFFU ? " " : "") << '\n';
+}
+
+template <typename... T>
+void benchAll(const SimulatorConfig &config, std::size_t rounds, std::tuple<T...> *)
+{
+    (benchDataset<T>(config, rounds), ...);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000U;
+    const auto loaded = trdp::config::loadSimulatorConfigFromXml(exampleXmlPath().string());
+    if (loaded.hasErrors() || rounds == 0U)
+    {
+        std::cerr << "Usage: " << argv[0] << " [ROUNDS]; example.xml must load" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::left << std::setw(8) << "dataset" << std::right << std::setw(8) << "bytes" << std::setw(8)
+              << "values" << std::setw(14) << "generated ns" << std::setw(14) << "generic ns" << std::setw(10)
+              << "speedup" << '\n';
+    benchAll(loaded.config, rounds, static_cast<trdp::example::AllDatasets *>(nullptr));
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include "config/dataset_codec.h"
+#include "config/dataset_codegen.h"
+#include "config/xml_loader.h"
+#include "example_datasets/example_datasets.h"
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+using trdp::config::DatasetCodec;
+using trdp::config::DatasetScalar;
+using trdp::config::ElementType;
+using trdp::model::Dataset;
+using trdp::model::SimulatorConfig;
+
+namespace
+{
+std::filesystem::path exampleXmlPath()
+{
+    auto path = std::filesystem::path(__FILE__).parent_path();
+    return path / ".." / "external" / "TCNopen" / "trdp" / "example" / "example.xml";
+}
+
+bool checkGenerator()
+{
+    SimulatorConfig config{};
+    config.datasets.push_back(Dataset{2001, "outer", {{"count", "UINT16", 1}, {"items", "DATASET 2000", 3}, {"text", "CHAR8", 16}}});
+    config.datasets.push_back(Dataset{2000, "inner", {{"flag", "BITSET8", 1}, {"time", "TIMEDATE48", 1}}});
+    config.datasets.push_back(Dataset{2002, "variable", {{"len", "UINT16", 1}, {"data", "UINT8", 0}}});
+    config.datasets.push_back(Dataset{2003, "recursive", {{"self", "DATASET 2003", 1}}});
+    config.datasets.push_back(Dataset{2004, "unknown", {{"raw", "42", 1}}});
+    config.datasets.push_back(Dataset{2005, "class", {{"the value", "REAL64", 2}, {"the-value", "INT8", 1}}});
+
+    trdp::config::DatasetCodegenOptions options;
+    options.nameSpace = "test::gen";
+    const auto result = trdp::config::generateDatasetHeader(config, options);
+    if (result.hasErrors() || result.generated != std::vector<std::uint32_t>{2000, 2001, 2005} ||
+        result.skipped.size() != 3U)
+    {
+        std::cerr << "Expected codecs for 2000, 2001 and 2005 with inner first and three datasets skipped"
+                  << std::endl;
+        return false;
+    }
+
+    const auto &header = result.header;
+    const auto contains = [&header](const char *text) { return header.find(text) != std::string::npos; };
+    if (!contains("struct inner\n") || !contains("::test::gen::inner items[3];") || !contains("char text[16];") ||
+        !contains("kWireSize = 39U;") || !contains("{\"text\", 23U, 16U, ElementType::Char8},") ||
+        !contains("struct class_2005\n") || !contains("double the_value[2];") ||
+        !contains("std::int8_t the_value_1;") || !contains("struct DatasetById<2001U>"))
+    {
+        std::cerr << "Generated header does not declare the expected structs and offsets:\n" << header << std::endl;
+        return false;
+    }
+
+    options.nameSpace = "test::class";
+    if (!trdp::config::generateDatasetHeader(config, options).hasErrors())
+    {
+        std::cerr << "A keyword in the namespace should be rejected" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/** The value a generic scalar takes when `bytes` hold one element in host order, as in a generated struct. */
+DatasetScalar hostScalar(ElementType type, const std::uint8_t *bytes)
+{
+    const auto read = [bytes](auto value) {
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    };
+    DatasetScalar value;
+    switch (type)
+    {
+    case ElementType::Bitset8:
+    case ElementType::UInt8:
+        value.integer = read(std::uint8_t{});
+        break;
+    case ElementType::Char8:
+    case ElementType::Int8:
+        value.integer = read(std::int8_t{});
+        break;
+    case ElementType::Utf16:
+    case ElementType::UInt16:
+        value.integer = read(std::uint16_t{});
+        break;
+    case ElementType::Int16:
+        value.integer = read(std::int16_t{});
+        break;
+    case ElementType::Int32:
+        value.integer = read(std::int32_t{});
+        break;
+    case ElementType::UInt32:
+    case ElementType::TimeDate32:
+        value.integer = read(std::uint32_t{});
+        break;
+    case ElementType::Int64:
+    case ElementType::UInt64:
+        value.integer = read(std::int64_t{});
+        break;
+    case ElementType::Real32:
+        value.real = read(float{});
+        break;
+    case ElementType::Real64:
+        value.real = read(double{});
+        break;
+    case ElementType::TimeDate48:
+    {
+        const auto time = read(trdp::config::TimeDate48{});
+        value.integer = static_cast<std::int64_t>(time.seconds) << 16 | time.ticks;
+        break;
+    }
+    case ElementType::TimeDate64:
+    {
+        const auto time = read(trdp::config::TimeDate64{});
+        const auto seconds = static_cast<std::uint64_t>(static_cast<std::uint32_t>(time.seconds));
+        value.integer = static_cast<std::int64_t>(seconds << 32U | static_cast<std::uint32_t>(time.microseconds));
+        break;
+    }
+    case ElementType::Dataset:
+        break;
+    }
+    return value;
+}
+
+template <typename T>
+bool checkGenerated(const SimulatorConfig &config, std::mt19937_64 &random)
+{
+    using Codec = DatasetCodec<T>;
+    const auto label = "Dataset " + std::to_string(Codec::kId) + ": ";
+    const auto layout = trdp::config::flattenDataset(config, Codec::kId);
+    if (!layout || layout->wireSize != Codec::kWireSize ||
+        !std::is_same_v<typename trdp::config::DatasetById<Codec::kId>::type, T>)
+    {
+        std::cerr << label << "generated size or id does not match the configuration" << std::endl;
+        return false;
+    }
+
+    for (int round = 0; round < 50; ++round)
+    {
+        std::vector<DatasetScalar> values(trdp::config::scalarCount(*layout));
+        for (auto &value : values)
+        {
+            value.integer = static_cast<std::int64_t>(random());
+            value.real = static_cast<double>(static_cast<std::int64_t>(random() % 2000001U) - 1000000) / 64.0;
+        }
+        std::vector<std::uint8_t> generic(Codec::kWireSize);
+        std::vector<DatasetScalar> expected;
+        if (!trdp::config::marshalDataset(*layout, values, generic.data(), generic.size()) ||
+            !trdp::config::unmarshalDataset(*layout, generic.data(), generic.size(), expected))
+        {
+            std::cerr << label << "generic codec rejected its own layout" << std::endl;
+            return false;
+        }
+
+        T decoded{};
+        trdp::config::decodeDataset(generic.data(), decoded);
+        std::vector<std::uint8_t> encoded(Codec::kWireSize);
+        trdp::config::encodeDataset(decoded, encoded.data());
+        if (encoded != generic)
+        {
+            std::cerr << label << "generated encode(decode(x)) differs from the generic wire image" << std::endl;
+            return false;
+        }
+
+        // The packed struct mirrors the wire layout, so each field sits at its wire offset in host order.
+        const auto *bytes = reinterpret_cast<const std::uint8_t *>(&decoded);
+        auto next = expected.begin();
+        for (const auto &field : layout->fields)
+        {
+            const auto size = trdp::config::elementTypeSize(field.type);
+            for (std::uint32_t index = 0U; index < field.count; ++index, ++next)
+            {
+                const auto host = hostScalar(field.type, bytes + field.offset + index * size);
+                if (host.integer != next->integer || host.real != next->real)
+                {
+                    std::cerr << label << "field " << field.path << "[" << index
+                              << "] decoded differently by the generated and generic codecs" << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename... T>
+bool checkAllGenerated(const SimulatorConfig &config, std::tuple<T...> *)
+{
+    std::mt19937_64 random(41U);
+    return (checkGenerated<T>(config, random) && ...);
+}
+} // namespace
+
+int main()
+{
+    if (!checkGenerator())
+    {
+        return 1;
+    }
+
+    const auto loaded = trdp::config::loadSimulatorConfigFromXml(exampleXmlPath().string());
+    if (loaded.hasErrors())
+    {
+        std::cerr << "Failed to load example.xml" << std::endl;
+        return 1;
+    }
+    if (std::tuple_size_v<trdp::example::AllDatasets> == 0U)
+    {
+        std::cerr << "example.xml should yield at least one generated dataset" << std::endl;
+        return 1;
+    }
+    if (!checkAllGenerated(loaded.config, static_cast<trdp::example::AllDatasets *>(nullptr)))
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "trdp/pd_endpoint_control.h"
+#include "util/json.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace trdp::test
+{
+/**
+ * Endpoint double for the tests of code that drives endpoints: records every command it receives, keeps the TX
+ * payload it is given and reports the counters the test sets. Whether commands take effect is up to the test.
+ */
+class FakeEndpoint final : public runtime::PdEndpointControl
+{
+public:
+    struct Call
+    {
+        std::string what;
+        std::vector<std::uint8_t> payload;
+        std::chrono::microseconds cycle{0};
+
+        /** "start 20000", "tx 0102", "stop": the call with its cycle in microseconds and its payload in hex. */
+        [[nodiscard]] std::string text() const
+        {
+            auto out = what;
+            if (cycle.count() != 0)
+            {
+                out += " " + std::to_string(cycle.count());
+            }
+            if (!payload.empty())
+            {
+                out += " ";
+                util::appendHex(out, payload.data(), payload.size());
+            }
+            return out;
+        }
+    };
+
+    explicit FakeEndpoint(runtime::PdDirection direction = runtime::PdDirection::Outgoing,
+                          std::vector<std::uint8_t> tx = {})
+        : direction_(direction), tx_(std::move(tx))
+    {
+    }
+
+    bool startPublishing(std::chrono::microseconds cycleTime) override { return record({"start", {}, cycleTime}); }
+    bool stopPublishing() override { return record({"stop", {}, {}}); }
+    void detachPublisher() override {}
+    [[nodiscard]] std::optional<std::chrono::microseconds> configuredCycle() const override
+    {
+        return std::chrono::microseconds(20000);
+    }
+    [[nodiscard]] bool isPublishing() const override { return publishCount_.load() != 0U; }
+    [[nodiscard]] std::size_t destinationCount() const override { return destinationCount_.load(); }
+    [[nodiscard]] std::uint64_t publishCount() const override { return publishCount_.load(); }
+    [[nodiscard]] std::optional<std::chrono::system_clock::time_point> lastPublishTime() const override { return {}; }
+    [[nodiscard]] std::optional<std::chrono::system_clock::time_point> lastReceiveTime() const override { return {}; }
+    [[nodiscard]] std::uint64_t receiveCount() const override { return 0U; }
+    [[nodiscard]] bool isLinkLost() const override { return false; }
+    [[nodiscard]] std::uint64_t linkLostCount() const override { return 0U; }
+    bool setFixedPayload(std::vector<std::uint8_t> payload) override
+    {
+        return record({"fixed", std::move(payload), {}});
+    }
+    bool clearFixedPayload() override { return record({"unfix", {}, {}}); }
+    [[nodiscard]] bool hasFixedPayload() const override { return false; }
+    [[nodiscard]] std::optional<std::size_t> fixedPayloadSize() const override { return std::nullopt; }
+    bool setTxPayload(std::vector<std::uint8_t> payload) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        calls_.push_back({"tx", payload, {}});
+        if (accepting_.load())
+        {
+            tx_ = std::move(payload);
+        }
+        return accepting_.load();
+    }
+    [[nodiscard]] std::vector<std::uint8_t> txPayload() const override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return tx_;
+    }
+    [[nodiscard]] std::vector<std::uint8_t> rxPayload() const override { return {}; }
+    [[nodiscard]] runtime::PdDirection direction() const override { return direction_; }
+
+    void setPublishCount(std::uint64_t count) { publishCount_.store(count); }
+    void setDestinationCount(std::size_t count) { destinationCount_.store(count); }
+    /** While false, commands are recorded but report that they did not take effect, as with a full shard queue. */
+    void setAccepting(bool accepting) { accepting_.store(accepting); }
+
+    std::vector<Call> calls() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return calls_;
+    }
+    std::vector<std::string> callTexts() const
+    {
+        std::vector<std::string> texts;
+        for (const auto &call : calls())
+        {
+            texts.push_back(call.text());
+        }
+        return texts;
+    }
+
+private:
+    bool record(Call call)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        calls_.push_back(std::move(call));
+        return accepting_.load();
+    }
+
+    runtime::PdDirection direction_;
+    std::atomic<std::uint64_t> publishCount_{0};
+    std::atomic<std::size_t> destinationCount_{1};
+    std::atomic<bool> accepting_{true};
+    mutable std::mutex mutex_;
+    std::vector<std::uint8_t> tx_;
+    std::vector<Call> calls_;
+};
+} // namespace trdp::test
@@ -0,0 +1,231 @@
+#include "util/log_store.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using trdp::util::LogFilter;
+using trdp::util::LogLevel;
+using trdp::util::LogSpillOptions;
+using trdp::util::LogStore;
+
+namespace
+{
+struct Reference
+{
+    std::uint64_t sequence;
+    LogLevel level;
+    std::string session;
+    std::uint32_t comId;
+    std::string message;
+};
+
+bool checkRoundTrip()
+{
+    const std::vector<std::string> messages{
+        "",
+        "plain text",
+        "ComID 1001 lost after 250 ms",
+        "peer 10.0.0.17:17224 sent 007 bytes",
+        "1 2 3 4 5 6 7 8",
+        "big 18446744073709551615 and bigger 123456789012345678901",
+        std::string("marker \x1F inside 42"),
+        "eth0",
+    };
+    LogStore store(16U);
+    for (const auto &message : messages)
+    {
+        store.append(LogLevel::Info, message);
+    }
+    const auto page = store.query(LogFilter{}, LogStore::kLive, 0U, messages.size());
+    for (std::size_t i = 0; i < messages.size(); ++i)
+    {
+        auto expected = messages[i];
+        std::replace(expected.begin(), expected.end(), '\x1F', '?');
+        if (i >= page.entries.size() || page.entries[i].message != expected)
+        {
+            std::cerr << "Message " << i << " came back as '" << (i < page.entries.size() ? page.entries[i].message : "")
+                      << "'" << std::endl;
+            return false;
+        }
+    }
+
+    // Messages that differ only in their numbers share a template.
+    LogStore counted(1024U);
+    for (int i = 0; i < 1000; ++i)
+    {
+        counted.append(LogLevel::Debug, "Received PD telegram comId=" + std::to_string(i) + " payload=64 bytes");
+    }
+    if (counted.templateCount() != 1U)
+    {
+        std::cerr << "Expected one template, got " << counted.templateCount() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/** Random traffic through a small ring, every query compared against a brute-force filter of what should be retained. */
+bool checkAgainstReference()
+{
+    constexpr std::size_t kCapacity = 3000U;
+    const std::vector<std::string> sessions{"", "10.0.0.1", "10.0.0.2", "10.0.1.1"};
+    std::mt19937 rng(11U);
+    LogStore store(kCapacity);
+    std::vector<Reference> all;
+
+    for (std::uint64_t sequence = 0; sequence < 40000U; ++sequence)
+    {
+        Reference ref{sequence,
+                      static_cast<LogLevel>(rng() % 4U),
+                      sessions[rng() % sessions.size()],
+                      static_cast<std::uint32_t>(rng() % 3U == 0U ? 0U : 1000U + rng() % 20U),
+                      "event " + std::to_string(rng() % 100000U)};
+        store.append(ref.level, ref.message, ref.session, ref.comId);
+        all.push_back(ref);
+
+        if (sequence % 97U != 0U)
+        {
+            continue;
+        }
+        LogFilter filter;
+        filter.minLevel = static_cast<LogLevel>(rng() % 4U);
+        filter.session = rng() % 2U == 0U ? std::string{} : sessions[1U + rng() % 3U];
+        filter.comId = rng() % 2U == 0U ? 0U : 1000U + rng() % 20U;
+        const auto anchor =
+            rng() % 3U == 0U ? LogStore::kLive : sequence + 1U - std::min<std::uint64_t>(rng() % 1000U, sequence);
+        const auto skip = static_cast<std::size_t>(rng() % 200U);
+        const auto rows = static_cast<std::size_t>(rng() % 60U);
+
+        std::vector<const Reference *> matching;
+        const auto oldest = all.size() > kCapacity ? all.size() - kCapacity : 0U;
+        for (auto i = oldest; i < all.size(); ++i)
+        {
+            const auto &candidate = all[i];
+            if (candidate.sequence < anchor && candidate.level >= filter.minLevel &&
+                (filter.session.empty() || candidate.session == filter.session) &&
+                (filter.comId == 0U || candidate.comId == filter.comId))
+            {
+                matching.push_back(&candidate);
+            }
+        }
+        const auto last = matching.size() - std::min(skip, matching.size());
+        const auto first = last - std::min(rows, last);
+
+        const auto page = store.query(filter, anchor, skip, rows);
+        bool same = page.entries.size() == last - first;
+        for (std::size_t i = 0; same && i < page.entries.size(); ++i)
+        {
+            const auto &entry = page.entries[i];
+            const auto &expected = *matching[first + i];
+            same = entry.sequence == expected.sequence && entry.message == expected.message &&
+                   entry.session == expected.session && entry.comId == expected.comId && entry.level == expected.level;
+        }
+        if (page.exactTotal && page.total != matching.size())
+        {
+            same = false;
+        }
+        if (!same)
+        {
+            std::cerr << "Query at " << sequence << " (level>=" << static_cast<int>(filter.minLevel) << " session '"
+                      << filter.session << "' comId " << filter.comId << " skip " << skip << " rows " << rows
+                      << ") returned " << page.entries.size() << " rows, expected " << last - first << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/** A page deep inside a million retained messages costs about as much as one at the end. */
+bool checkLargeStore()
+{
+    constexpr std::size_t kCapacity = 1000000U;
+    LogStore store(kCapacity);
+    for (std::uint32_t i = 0; i < kCapacity + kCapacity / 4U; ++i)
+    {
+        const auto level = i % 1000U == 0U ? LogLevel::Warn : LogLevel::Debug;
+        store.append(level, "frame " + std::to_string(i), i % 2U == 0U ? "10.0.0.1" : "10.0.0.2", 1000U + i % 64U);
+    }
+
+    LogFilter warnings;
+    warnings.minLevel = LogLevel::Warn;
+    LogFilter oneComId;
+    oneComId.comId = 1005U;
+    const auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i)
+    {
+        const auto deep = store.query(oneComId, LogStore::kLive, 10000U + static_cast<std::size_t>(i), 50U);
+        const auto sparse = store.query(warnings, LogStore::kLive, 100U, 50U);
+        if (deep.entries.size() != 50U || sparse.entries.size() != 50U || sparse.total != 1000U)
+        {
+            std::cerr << "Large store returned " << deep.entries.size() << "/" << sparse.entries.size() << " rows"
+                      << std::endl;
+            return false;
+        }
+    }
+    const auto perQuery =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started) / 200;
+    std::cout << "Query of 50 rows among " << store.size() << " messages: " << perQuery.count() << " us" << std::endl;
+    if (perQuery > std::chrono::milliseconds(20))
+    {
+        std::cerr << "Queries scale with the store, not the page" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkSpill()
+{
+    const std::string path = "log_store_test.log";
+    LogStore store(100000U);
+    std::string error;
+    if (!store.startSpill(LogSpillOptions{path, 4096U, 50U}, error))
+    {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    for (int i = 0; i < 2000; ++i)
+    {
+        store.append(LogLevel::Info, "line " + std::to_string(i), "10.0.0.1", 7U);
+    }
+    store.stopSpill();
+
+    std::size_t lines = 0U;
+    std::size_t files = 0U;
+    for (unsigned index = 0; index <= 50U; ++index)
+    {
+        const auto name = index == 0U ? path : path + "." + std::to_string(index);
+        std::ifstream in(name);
+        if (!in)
+        {
+            continue;
+        }
+        ++files;
+        for (std::string line; std::getline(in, line);)
+        {
+            ++lines;
+        }
+        in.close();
+        std::remove(name.c_str());
+    }
+    if (lines != 2000U || files < 2U || store.spillDropped() != 0U)
+    {
+        std::cerr << "Spill wrote " << lines << " lines to " << files << " files" << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    if (!checkRoundTrip() || !checkAgainstReference() || !checkLargeStore() || !checkSpill())
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "util/mpsc_queue.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using trdp::util::MpscQueue;
+
+namespace
+{
+constexpr std::uint32_t kProducers = 4U;
+constexpr std::uint32_t kItemsPerProducer = 100000U;
+
+std::uint64_t encode(std::uint32_t producer, std::uint32_t sequence)
+{
+    return (static_cast<std::uint64_t>(producer) << 32U) | sequence;
+}
+} // namespace
+
+int main()
+{
+    MpscQueue<std::uint64_t> queue;
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> producers;
+    for (std::uint32_t p = 0; p < kProducers; ++p)
+    {
+        producers.emplace_back([&queue, &go, p] {
+            while (!go.load())
+            {
+                std::this_thread::yield();
+            }
+            for (std::uint32_t i = 0; i < kItemsPerProducer; ++i)
+            {
+                queue.push(encode(p, i));
+            }
+        });
+    }
+
+    go.store(true);
+
+    std::array<std::uint32_t, kProducers> nextExpected{};
+    std::uint64_t received = 0U;
+    const std::uint64_t total = static_cast<std::uint64_t>(kProducers) * kItemsPerProducer;
+    while (received < total)
+    {
+        std::uint64_t value = 0U;
+        if (!queue.tryPop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const auto producer = static_cast<std::uint32_t>(value >> 32U);
+        const auto sequence = static_cast<std::uint32_t>(value & 0xFFFFFFFFU);
+        if (producer >= kProducers || nextExpected[producer] != sequence)
+        {
+            std::cerr << "Out-of-order item from producer " << producer << ": got " << sequence << std::endl;
+            return 1;
+        }
+        ++nextExpected[producer];
+        ++received;
+    }
+
+    for (auto &thread : producers)
+    {
+        thread.join();
+    }
+
+    if (!queue.empty())
+    {
+        std::cerr << "Queue should be empty after consuming every item" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include "trdp/payload_generator.h"
+
+#include "config/dataset_wire.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+using trdp::config::DatasetLayout;
+using trdp::config::ElementType;
+using trdp::config::loadBig;
+using trdp::model::FieldGeneratorKind;
+using trdp::model::FieldGeneratorRule;
+using trdp::runtime::PayloadProgram;
+using trdp::runtime::PayloadScheduler;
+
+namespace
+{
+/** counter UINT32 | speed REAL32 | temp INT16 | flags BITSET8[4] | mode UINT8 | level UINT8 | wrap UINT8 */
+DatasetLayout makeLayout()
+{
+    DatasetLayout layout;
+    layout.datasetId = 4001U;
+    layout.name = "drive";
+    layout.wireSize = 17U;
+    layout.fields = {{"counter", ElementType::UInt32, 0U, 1U}, {"speed", ElementType::Real32, 4U, 1U},
+                     {"temp", ElementType::Int16, 8U, 1U},     {"flags", ElementType::Bitset8, 10U, 4U},
+                     {"mode", ElementType::UInt8, 14U, 1U},    {"level", ElementType::UInt8, 15U, 1U},
+                     {"wrap", ElementType::UInt8, 16U, 1U}};
+    return layout;
+}
+
+FieldGeneratorRule rule(const std::string &field, FieldGeneratorKind kind, std::vector<double> args)
+{
+    return FieldGeneratorRule{4001U, field, kind, std::move(args)};
+}
+
+bool checkValues()
+{
+    const std::vector<FieldGeneratorRule> rules{
+        rule("counter", FieldGeneratorKind::Counter, {10.0, 5.0}),
+        rule("speed", FieldGeneratorKind::Sine, {0.0, 100.0, 4.0}),
+        rule("temp", FieldGeneratorKind::Ramp, {-2.0, 2.0, 1.0}),
+        rule("flags", FieldGeneratorKind::Counter, {0.0, 1.0}),
+        rule("flags[1]", FieldGeneratorKind::Toggle, {5.0, 0.0}),
+        rule("flags[3]", FieldGeneratorKind::Constant, {7.0}),
+        rule("mode", FieldGeneratorKind::Random, {1.0, 6.0, 42.0}),
+        rule("level", FieldGeneratorKind::Table, {3.0, 1.0, 4.0}),
+        rule("wrap", FieldGeneratorKind::Counter, {254.0, 1.0}),
+    };
+    std::string error;
+    const auto program = PayloadProgram::compile(makeLayout(), rules, std::vector<std::uint8_t>(20U, 0xEEU), error);
+    if (program == nullptr || program->size() != 17U || program->operationCount() != 9U)
+    {
+        std::cerr << "Program did not compile: " << error << std::endl;
+        return false;
+    }
+
+    const float sine[] = {0.0F, 100.0F, 0.0F, -100.0F};
+    const std::int16_t ramp[] = {-2, -1, 0, 1, 2};
+    const std::uint8_t table[] = {3U, 1U, 4U};
+    std::set<std::uint8_t> rolls;
+    for (std::uint32_t cycle = 0U; cycle < 400U; ++cycle)
+    {
+        const auto *wire = program->evaluate();
+        const bool ok = loadBig<std::uint32_t>(wire) == 10U + 5U * cycle &&
+                        std::fabs(loadBig<float>(wire + 4) - sine[cycle % 4U]) < 1e-3F &&
+                        loadBig<std::int16_t>(wire + 8) == ramp[cycle % 5U] && wire[10] == (cycle & 0xFFU) &&
+                        wire[11] == ((cycle % 2U) != 0U ? 5U : 0U) && wire[12] == (cycle & 0xFFU) && wire[13] == 7U &&
+                        wire[14] >= 1U && wire[14] <= 6U && wire[15] == table[cycle % 3U] &&
+                        wire[16] == static_cast<std::uint8_t>(254U + cycle);
+        if (!ok)
+        {
+            std::cerr << "Unexpected generated payload in cycle " << cycle << std::endl;
+            return false;
+        }
+        rolls.insert(wire[14]);
+    }
+    if (rolls.size() != 6U || program->cycles() != 400U)
+    {
+        std::cerr << "random(1,6) should roll every value" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkErrors()
+{
+    const auto layout = makeLayout();
+    for (const auto &bad : {rule("missing", FieldGeneratorKind::Counter, {0.0, 1.0}),
+                            rule("flags[4]", FieldGeneratorKind::Counter, {0.0, 1.0}),
+                            rule("speed", FieldGeneratorKind::Toggle, {1.0, 0.0}),
+                            rule("counter", FieldGeneratorKind::Counter, {0.0, 0.5}),
+                            rule("mode", FieldGeneratorKind::Random, {1.2, 1.8, 1.0})})
+    {
+        std::string error;
+        if (PayloadProgram::compile(layout, {bad}, {}, error) != nullptr || error.empty())
+        {
+            std::cerr << "Rule for '" << bad.field << "' should be rejected" << std::endl;
+            return false;
+        }
+    }
+
+    // Only the base bytes of generated elements change; the rest is sent as given.
+    std::string error;
+    const std::vector<std::uint8_t> base(17U, 0xAAU);
+    const std::vector<FieldGeneratorRule> rules{rule("mode", FieldGeneratorKind::Counter, {0.0, 1.0}),
+                                                rule("mode", FieldGeneratorKind::Constant, {9.0})};
+    const auto program = PayloadProgram::compile(layout, rules, base, error);
+    if (program == nullptr || program->operationCount() != 0U || program->evaluate()[14] != 9U ||
+        program->wire()[13] != 0xAAU)
+    {
+        std::cerr << "A later constant should replace the counter and leave other bytes alone" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkScheduler()
+{
+    const auto start = PayloadScheduler::Clock::now();
+    PayloadScheduler scheduler(std::chrono::microseconds(100), start);
+    std::string error;
+    auto program = PayloadProgram::compile(makeLayout(), {rule("counter", FieldGeneratorKind::Counter, {0.0, 1.0})},
+                                           {}, error);
+    const auto first = reinterpret_cast<TRDP_PUB_T>(std::uintptr_t{0x10});
+    const auto second = reinterpret_cast<TRDP_PUB_T>(std::uintptr_t{0x20});
+    const auto id = scheduler.add(program, {first, second}, std::chrono::milliseconds(1), start);
+
+    std::vector<std::uint32_t> sent;
+    const auto advance = [&](std::chrono::microseconds at) {
+        scheduler.advance(start + at, [&](TRDP_PUB_T handle, const std::uint8_t *data, std::size_t size) {
+            if (size == 17U)
+            {
+                sent.push_back(loadBig<std::uint32_t>(data));
+            }
+            return handle == first;
+        });
+    };
+    advance(std::chrono::microseconds(0));
+    advance(std::chrono::microseconds(500));
+    advance(std::chrono::microseconds(1000));
+    advance(std::chrono::microseconds(5300));
+
+    const auto stats = scheduler.stats();
+    if (sent != std::vector<std::uint32_t>{0U, 0U, 1U, 1U, 2U, 2U} || stats.evaluations != 3U || stats.puts != 6U ||
+        stats.putErrors != 3U || stats.skippedCycles != 3U ||
+        scheduler.nextDeadline() != start + std::chrono::milliseconds(6))
+    {
+        std::cerr << "Scheduler ran the program off its cycle: " << stats.evaluations << " evaluations, "
+                  << stats.skippedCycles << " skipped" << std::endl;
+        return false;
+    }
+
+    scheduler.remove(id);
+    if (scheduler.nextDeadline() || scheduler.stats().programs != 0U)
+    {
+        std::cerr << "A removed program should not be scheduled" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/** 2000 telegrams with 13 generated elements each, evaluated as one cycle of a busy device. */
+void measureCycle()
+{
+    DatasetLayout layout;
+    layout.wireSize = 64U;
+    layout.fields = {{"words", ElementType::UInt32, 0U, 8U}, {"values", ElementType::Real32, 32U, 8U}};
+    const std::vector<FieldGeneratorRule> rules{
+        rule("words[0]", FieldGeneratorKind::Counter, {0.0, 1.0}),
+        rule("words[1]", FieldGeneratorKind::Toggle, {1.0, 0.0}),
+        rule("words[2]", FieldGeneratorKind::Random, {0.0, 1000.0, 7.0}),
+        rule("words[3]", FieldGeneratorKind::Table, {1.0, 2.0, 3.0}),
+        rule("words[4]", FieldGeneratorKind::Ramp, {0.0, 100.0, 0.5}),
+        rule("values", FieldGeneratorKind::Sine, {0.0, 1.0, 100.0}),
+    };
+
+    std::string error;
+    std::vector<std::shared_ptr<PayloadProgram>> programs;
+    for (int telegram = 0; telegram < 2000; ++telegram)
+    {
+        programs.push_back(PayloadProgram::compile(layout, rules, {}, error));
+    }
+
+    const int cycles = 200;
+    std::uint64_t checksum = 0U;
+    const auto started = std::chrono::steady_clock::now();
+    for (int cycle = 0; cycle < cycles; ++cycle)
+    {
+        for (const auto &program : programs)
+        {
+            checksum += program->evaluate()[3];
+        }
+    }
+    const auto perCycle = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started) / cycles;
+    std::cout << programs.size() << " telegrams x " << programs.front()->operationCount() << " elements: "
+              << perCycle.count() << " us per cycle (checksum " << checksum << ")" << std::endl;
+}
+} // namespace
+
+int main()
+{
+    if (!checkValues() || !checkErrors() || !checkScheduler())
+    {
+        return 1;
+    }
+    measureCycle();
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include "decode/capture_decoder.h"
+#include "trdp/pd_frame.h"
+#include "util/crc32.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using trdp::decode::DecodeReport;
+using trdp::decode::PdIssue;
+
+namespace
+{
+constexpr std::uint32_t kSrcIp = 0x0A000001U; // 10.0.0.1
+constexpr std::uint32_t kDstIp = 0xEF010101U; // 239.1.1.1
+
+std::uint32_t referenceCrc(const std::uint8_t *data, std::size_t size)
+{
+    std::uint32_t crc = 0xFFFFFFFFU;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1U) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+bool checkCrcImplementations()
+{
+    std::mt19937 random(42U);
+    std::vector<std::uint8_t> buffer(4096U + 16U);
+    for (auto &byte : buffer)
+    {
+        byte = static_cast<std::uint8_t>(random());
+    }
+
+    for (int round = 0; round < 500; ++round)
+    {
+        const auto offset = random() % 16U;
+        const auto size = random() % 4096U;
+        const auto *data = buffer.data() + offset;
+        const auto expected = referenceCrc(data, size);
+        const auto split = size == 0U ? 0U : random() % size;
+        if (trdp::util::crc32(data, size) != expected || trdp::util::crc32Slice8(0U, data, size) != expected ||
+            trdp::util::crc32Update(trdp::util::crc32(data, split), data + split, size - split) != expected)
+        {
+            std::cerr << "CRC mismatch (" << trdp::util::crc32Backend() << ") at offset " << offset << ", size " << size
+                      << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void put16(std::vector<std::uint8_t> &out, std::size_t at, std::uint16_t value)
+{
+    out[at] = static_cast<std::uint8_t>(value >> 8U);
+    out[at + 1U] = static_cast<std::uint8_t>(value);
+}
+
+void put32(std::vector<std::uint8_t> &out, std::size_t at, std::uint32_t value)
+{
+    put16(out, at, static_cast<std::uint16_t>(value >> 16U));
+    put16(out, at + 2U, static_cast<std::uint16_t>(value));
+}
+
+/** Ethernet/IPv4/UDP frame around `payload`. */
+std::vector<std::uint8_t> makeFrame(const std::vector<std::uint8_t> &payload, std::uint16_t port)
+{
+    std::vector<std::uint8_t> frame(14U + 20U + 8U + payload.size());
+    put16(frame, 12U, 0x0800U);
+    frame[14] = 0x45U;
+    put16(frame, 16U, static_cast<std::uint16_t>(20U + 8U + payload.size()));
+    frame[22] = 64U;
+    frame[23] = 17U;
+    put32(frame, 26U, kSrcIp);
+    put32(frame, 30U, kDstIp);
+    put16(frame, 34U, 40000U);
+    put16(frame, 36U, port);
+    put16(frame, 38U, static_cast<std::uint16_t>(8U + payload.size()));
+    std::memcpy(frame.data() + 42U, payload.data(), payload.size());
+    return frame;
+}
+
+std::vector<std::uint8_t> makePd(std::uint32_t comId, std::uint32_t sequence, std::size_t datasetSize)
+{
+    trdp::runtime::PdFrameHeader header{};
+    header.comId = comId;
+    header.sequenceCounter = sequence;
+    header.datasetLength = static_cast<std::uint32_t>(datasetSize);
+    std::vector<std::uint8_t> pd(trdp::runtime::kPdHeaderSize + datasetSize, 0xA5U);
+    trdp::runtime::encodePdHeader(header, pd.data());
+    return pd;
+}
+
+void appendRecord(std::vector<std::uint8_t> &file, const std::vector<std::uint8_t> &frame, std::uint32_t index)
+{
+    const std::uint32_t header[4] = {1700000000U + index / 1000U, (index % 1000U) * 1000U,
+                                     static_cast<std::uint32_t>(frame.size()), static_cast<std::uint32_t>(frame.size())};
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(header);
+    file.insert(file.end(), bytes, bytes + sizeof(header));
+    file.insert(file.end(), frame.begin(), frame.end());
+}
+
+/**
+ * ComID 1001: 2000 sequence numbers with 500 missing and 700 carrying a broken FCS. ComID 1002:
+ * ten frames with a 12-byte dataset where the configuration says 8. Every tenth record is a
+ * non-PD UDP datagram.
+ */
+std::string writeCapture()
+{
+    std::vector<std::uint8_t> file(24U, 0U);
+    const std::uint32_t fileHeader[6] = {0xA1B2C3D4U, 0x00040002U, 0U, 0U, 65535U, 1U};
+    std::memcpy(file.data(), fileHeader, sizeof(fileHeader));
+
+    std::uint32_t index = 0U;
+    for (std::uint32_t sequence = 0; sequence < 2000U; ++sequence)
+    {
+        if (sequence % 10U == 0U)
+        {
+            appendRecord(file, makeFrame(std::vector<std::uint8_t>(20U, 0U), 9999U), index++);
+        }
+        if (sequence == 500U)
+        {
+            continue;
+        }
+        auto pd = makePd(1001U, sequence, 16U);
+        if (sequence == 700U)
+        {
+            pd[36] ^= 0xFFU;
+        }
+        appendRecord(file, makeFrame(pd, trdp::runtime::kPdDefaultPort), index++);
+        if (sequence % 200U == 0U)
+        {
+            appendRecord(file, makeFrame(makePd(1002U, sequence / 200U, 12U), trdp::runtime::kPdDefaultPort), index++);
+        }
+    }
+
+    char path[] = "/tmp/pd_decoder_testXXXXXX";
+    const int fd = ::mkstemp(path);
+    if (fd < 0 || ::write(fd, file.data(), file.size()) != static_cast<ssize_t>(file.size()))
+    {
+        return {};
+    }
+    ::close(fd);
+    return path;
+}
+
+std::size_t issueCount(const DecodeReport &report, PdIssue issue)
+{
+    return report.issues[static_cast<std::size_t>(__builtin_ctz(static_cast<std::uint32_t>(issue)))];
+}
+
+bool sameReports(const DecodeReport &a, const DecodeReport &b)
+{
+    if (a.packets != b.packets || a.pdFrames != b.pdFrames || a.validFrames != b.validFrames ||
+        a.skipped != b.skipped || a.bytes != b.bytes || a.issues != b.issues || a.comIds.size() != b.comIds.size() ||
+        a.flows.size() != b.flows.size())
+    {
+        return false;
+    }
+    for (const auto &[comId, stats] : a.comIds)
+    {
+        const auto it = b.comIds.find(comId);
+        if (it == b.comIds.end() || it->second.frames != stats.frames || it->second.invalid != stats.invalid ||
+            it->second.bytes != stats.bytes)
+        {
+            return false;
+        }
+    }
+    for (const auto &[key, flow] : a.flows)
+    {
+        const auto it = b.flows.find(key);
+        if (it == b.flows.end() || it->second.frames != flow.frames || it->second.gaps != flow.gaps ||
+            it->second.missing != flow.missing || it->second.lastSequence != flow.lastSequence)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    if (!checkCrcImplementations())
+    {
+        return 1;
+    }
+
+    const auto path = writeCapture();
+    trdp::decode::CaptureFile file;
+    std::string error;
+    if (path.empty() || !file.open(path, error))
+    {
+        std::cerr << "Failed to write or open the test capture: " << error << std::endl;
+        return 1;
+    }
+
+    trdp::decode::PdExpectations expectations{};
+    expectations.datasetSize[1001U] = std::nullopt;
+    expectations.datasetSize[1002U] = 8U;
+
+    trdp::decode::DecodeOptions sequential{};
+    sequential.threads = 1U;
+    const auto report = trdp::decode::decodeCapture(file, expectations, sequential);
+    std::remove(path.c_str());
+
+    const auto &first = report.comIds.at(1001U);
+    const auto &second = report.comIds.at(1002U);
+    if (report.skipped != 200U || first.frames != 1999U || first.invalid != 3U || second.frames != 10U ||
+        second.invalid != 10U || issueCount(report, PdIssue::BadFcs) != 1U ||
+        issueCount(report, PdIssue::SequenceGap) != 2U || issueCount(report, PdIssue::DatasetSizeMismatch) != 10U ||
+        report.invalidFrames() != 13U)
+    {
+        std::cerr << "Unexpected sequential decode result: " << report.pdFrames << " PD frames, "
+                  << report.invalidFrames() << " invalid, " << report.skipped << " skipped" << std::endl;
+        return 1;
+    }
+
+    // Chunk boundaries fall in the middle of records; the merged result must not change.
+    for (const unsigned threads : {2U, 3U, 4U, 7U})
+    {
+        trdp::decode::DecodeOptions parallel{};
+        parallel.threads = threads;
+        parallel.minChunkBytes = 1U;
+        if (!sameReports(report, trdp::decode::decodeCapture(file, expectations, parallel)))
+        {
+            std::cerr << "Parallel decode with " << threads << " threads differs from the sequential pass" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "trdp/process_loop_metrics.h"
+#include "util/log_histogram.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using trdp::runtime::LoopWake;
+using trdp::runtime::ProcessLoopMetrics;
+using trdp::util::LogHistogram;
+
+namespace
+{
+/** Bucket bounds must tile the value range without gaps or overlaps. */
+bool checkBucketLayout()
+{
+    for (std::size_t i = 1; i < LogHistogram::kBucketCount; ++i)
+    {
+        const auto lower = LogHistogram::bucketUpperBound(i - 1U) + 1U;
+        if (LogHistogram::bucketIndex(lower) != i || LogHistogram::bucketIndex(LogHistogram::bucketUpperBound(i)) != i)
+        {
+            std::cerr << "Bucket " << i << " does not start right after bucket " << i - 1U << std::endl;
+            return false;
+        }
+    }
+    if (LogHistogram::bucketIndex(UINT64_MAX) != LogHistogram::kBucketCount - 1U)
+    {
+        std::cerr << "Largest value does not land in the last bucket" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/** Percentiles of a skewed sample stay within the documented relative error of the exact ones. */
+bool checkPercentiles()
+{
+    std::mt19937_64 rng(7U);
+    std::lognormal_distribution<double> latency(4.0, 1.5);
+    LogHistogram histogram;
+    std::vector<std::uint64_t> samples;
+    for (int i = 0; i < 100000; ++i)
+    {
+        const auto value = static_cast<std::uint64_t>(latency(rng));
+        samples.push_back(value);
+        histogram.record(value);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    for (const double quantile : {0.0, 0.5, 0.9, 0.99, 0.999, 1.0})
+    {
+        const auto rank = std::max<std::size_t>(1U, static_cast<std::size_t>(quantile * samples.size() + 0.999999));
+        const auto exact = samples[rank - 1U];
+        const auto reported = histogram.percentile(quantile);
+        if (reported < exact || reported > exact + exact / LogHistogram::kSubBuckets)
+        {
+            std::cerr << "p" << quantile * 100.0 << " reported " << reported << ", exact " << exact << std::endl;
+            return false;
+        }
+    }
+    if (histogram.count() != samples.size() || histogram.max() != samples.back() || histogram.percentile(1.0) != samples.back())
+    {
+        std::cerr << "Count or maximum is off" << std::endl;
+        return false;
+    }
+
+    LogHistogram empty;
+    if (empty.percentile(0.99) != 0U || empty.mean() != 0.0)
+    {
+        std::cerr << "Empty histogram reports samples" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkLoopMetrics()
+{
+    using std::chrono::microseconds;
+    ProcessLoopMetrics metrics;
+    metrics.recordIteration(LoopWake::Timeout, microseconds(120), 0, microseconds(15));
+    metrics.recordIteration(LoopWake::Timeout, microseconds(-3), 0, microseconds(10));
+    metrics.recordIteration(LoopWake::Socket, microseconds(-900), 3, microseconds(40));
+    metrics.recordIteration(LoopWake::Command, microseconds(-500), 0, microseconds(5));
+    metrics.recordIteration(LoopWake::Spurious, microseconds(-700), 0, microseconds(5));
+
+    const auto stats = metrics.snapshot();
+    if (stats.wakes != 5U || stats.timeoutWakes != 2U || stats.socketWakes != 1U || stats.commandWakes != 1U ||
+        stats.spuriousWakes != 1U)
+    {
+        std::cerr << "Wakes were not classified: " << stats.summary() << std::endl;
+        return false;
+    }
+    // Only timeout wakes carry a lag, and waking early counts as no lag at all.
+    if (stats.wakeupLagUs.count() != 2U || stats.wakeupLagUs.max() != 120U || stats.wakeupLagUs.percentile(0.5) != 0U)
+    {
+        std::cerr << "Unexpected wakeup lag: " << stats.summary() << std::endl;
+        return false;
+    }
+    if (stats.readyDescriptors.count() != 1U || stats.readyDescriptors.max() != 3U || stats.processUs.count() != 5U ||
+        stats.processUs.max() != 40U || stats.idleWakeShare() != 0.6)
+    {
+        std::cerr << "Unexpected descriptor or tlc_process figures: " << stats.summary() << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    if (!checkBucketLayout() || !checkPercentiles() || !checkLoopMetrics())
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "trdp/pd_frame.h"
+#include "trdp/raw_pd_generator.h"
+#include "trdp/trdp_session.h"
+#include "util/crc32.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using trdp::runtime::PdFrameHeader;
+using trdp::runtime::PdMessage;
+using trdp::runtime::RawPdGenerator;
+using trdp::runtime::RawPdGeneratorSettings;
+using trdp::runtime::RawPdStream;
+using trdp::runtime::TrdpSession;
+using trdp::runtime::TrdpSessionConfig;
+
+namespace
+{
+bool checkFrameCodec()
+{
+    const char *check = "123456789";
+    if (trdp::util::crc32(reinterpret_cast<const std::uint8_t *>(check), std::strlen(check)) != 0xCBF43926U)
+    {
+        std::cerr << "CRC-32 check value mismatch" << std::endl;
+        return false;
+    }
+
+    PdFrameHeader header{};
+    header.comId = 0xABCDU;
+    header.datasetLength = 24U;
+    std::vector<std::uint8_t> frame(trdp::runtime::kPdHeaderSize);
+    trdp::runtime::encodePdHeader(header, frame.data());
+    trdp::runtime::updatePdSequence(frame.data(), 7U);
+
+    bool validFcs = false;
+    const auto decoded = trdp::runtime::decodePdHeader(frame.data(), frame.size(), &validFcs);
+    if (!decoded || !validFcs || decoded->sequenceCounter != 7U || decoded->comId != 0xABCDU ||
+        decoded->datasetLength != 24U || decoded->msgType != trdp::runtime::kPdMsgTypeData)
+    {
+        std::cerr << "Encoded PD header did not round-trip" << std::endl;
+        return false;
+    }
+
+    frame[9] ^= 0x01U;
+    (void)trdp::runtime::decodePdHeader(frame.data(), frame.size(), &validFcs);
+    if (validFcs)
+    {
+        std::cerr << "Corrupted header should fail the FCS check" << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    if (!checkFrameCodec())
+    {
+        return 1;
+    }
+
+    // Frames built by the generator must be accepted by a regular stack subscriber.
+    TrdpSessionConfig sessionConfig{};
+    sessionConfig.hostIp = "127.0.0.1";
+    sessionConfig.leaderIp = "127.0.0.1";
+    auto session = std::make_shared<TrdpSession>(sessionConfig);
+    if (!session->open())
+    {
+        std::cerr << "Failed to open TRDP session on loopback" << std::endl;
+        return 1;
+    }
+
+    constexpr std::uint32_t kComId = 0x23456U;
+    constexpr std::size_t kPayloadSize = 32U;
+    std::atomic<std::uint64_t> received{0};
+    std::atomic<bool> sizeMismatch{false};
+    session->registerPdSubscriber(kComId, [&](const PdMessage &message) {
+        sizeMismatch = sizeMismatch || message.payload.size() != kPayloadSize;
+        received.fetch_add(1);
+    });
+
+    RawPdStream stream{};
+    stream.comId = kComId;
+    stream.destIp = session->hostAddress();
+    stream.cycle = std::chrono::milliseconds(2);
+    stream.payload.assign(kPayloadSize, 0x5AU);
+
+    RawPdGeneratorSettings settings{};
+    settings.sourceIp = "127.0.0.1";
+    settings.batchSize = 8U;
+    RawPdGenerator generator(settings, {stream});
+    if (!generator.start())
+    {
+        std::cerr << "Raw PD generator failed to start" << std::endl;
+        return 1;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (received.load() < 20U && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    generator.stop();
+    session->close();
+
+    if (received.load() < 20U || sizeMismatch.load())
+    {
+        std::cerr << "Subscriber accepted " << received.load() << " generated telegrams" << std::endl;
+        return 1;
+    }
+    if (generator.stats().sendErrors != 0U)
+    {
+        std::cerr << "Generator reported send errors on loopback" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "record/recording_codec.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace trdp::record;
+
+namespace
+{
+bool roundTripsBlock(const std::vector<std::uint8_t> &data)
+{
+    const auto compressed = compressBlock(data.data(), data.size());
+    std::vector<std::uint8_t> restored;
+    return decompressBlock(compressed.data(), compressed.size(), restored) && restored == data;
+}
+
+/** Telegrams of 40 ComIDs on a 10 ms cycle; only the counter and the odd status byte change. */
+std::vector<std::uint8_t> cyclicRecords(std::size_t count)
+{
+    std::vector<std::uint8_t> records;
+    std::mt19937 random(3U);
+    std::vector<std::vector<std::uint8_t>> payloads(40U);
+    for (std::size_t index = 0U; index < payloads.size(); ++index)
+    {
+        payloads[index].resize(16U + index * 24U);
+        for (auto &byte : payloads[index])
+        {
+            byte = static_cast<std::uint8_t>(random());
+        }
+    }
+
+    for (std::size_t index = 0U; index < count; ++index)
+    {
+        const auto slot = index % payloads.size();
+        auto &payload = payloads[slot];
+        const auto cycle = static_cast<std::uint32_t>(index / payloads.size());
+        std::memcpy(payload.data(), &cycle, sizeof(cycle));
+        if (random() % 50U == 0U)
+        {
+            payload[4U + random() % (payload.size() - 4U)] ^= 0x01U;
+        }
+
+        RecordHeader header{1760000000000000000LL + static_cast<std::int64_t>(index) * 250000 +
+                                static_cast<std::int64_t>(random() % 20000U),
+                            1000U + static_cast<std::uint32_t>(slot),
+                            cycle,
+                            0x0A000001U,
+                            0xEF000000U + static_cast<std::uint32_t>(slot),
+                            static_cast<std::uint32_t>(payload.size()),
+                            0U};
+        const auto start = records.size();
+        records.resize(start + paddedRecordBytes(header.payloadBytes));
+        std::memcpy(records.data() + start, &header, sizeof(header));
+        std::memcpy(records.data() + start + sizeof(header), payload.data(), payload.size());
+    }
+    return records;
+}
+} // namespace
+
+int main()
+{
+    std::mt19937 random(11U);
+    std::vector<std::uint8_t> noise(100000U);
+    for (auto &byte : noise)
+    {
+        byte = static_cast<std::uint8_t>(random());
+    }
+    const std::vector<std::uint8_t> repeated(70000U, 0x5AU);
+    if (!roundTripsBlock({}) || !roundTripsBlock({1U, 2U, 3U}) || !roundTripsBlock(noise) ||
+        !roundTripsBlock(repeated))
+    {
+        std::cerr << "Block compression does not round-trip" << std::endl;
+        return 1;
+    }
+
+    // Damaged blocks must be rejected without reading or writing out of bounds.
+    const auto block = compressBlock(repeated.data(), repeated.size());
+    std::vector<std::uint8_t> restored;
+    for (std::size_t cut = 0U; cut < block.size(); ++cut)
+    {
+        if (decompressBlock(block.data(), cut, restored))
+        {
+            std::cerr << "A block cut to " << cut << " bytes should not decode" << std::endl;
+            return 1;
+        }
+    }
+    for (int round = 0; round < 2000; ++round)
+    {
+        auto damaged = compressBlock(noise.data(), 300U);
+        damaged[random() % damaged.size()] = static_cast<std::uint8_t>(random());
+        (void)decompressBlock(damaged.data(), damaged.size(), restored);
+    }
+
+    const std::size_t count = 200000U;
+    const auto records = cyclicRecords(count);
+    const auto started = std::chrono::steady_clock::now();
+    const auto packed = packRecords(records.data(), records.size());
+    const auto compressed = compressBlock(packed.data(), packed.size());
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::vector<std::uint8_t> unpacked;
+    if (!decompressBlock(compressed.data(), compressed.size(), restored) || restored != packed ||
+        !unpackRecords(packed.data(), packed.size(), count, unpacked) || unpacked != records)
+    {
+        std::cerr << "Packed records do not round-trip" << std::endl;
+        return 1;
+    }
+    if (unpackRecords(packed.data(), packed.size(), count - 1U, unpacked) ||
+        unpackRecords(packed.data(), packed.size() - 1U, count, unpacked))
+    {
+        std::cerr << "A record count or length mismatch should be rejected" << std::endl;
+        return 1;
+    }
+
+    const auto ratio = static_cast<double>(records.size()) / static_cast<double>(compressed.size());
+    std::cout << records.size() << " bytes of records -> " << packed.size() << " packed -> " << compressed.size()
+              << " compressed (" << ratio << "x), " << static_cast<double>(count) / seconds << " telegrams/s"
+              << std::endl;
+    if (ratio < 20.0)
+    {
+        std::cerr << "Cyclic traffic should compress at least 20x" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,286 @@
+#include "record/recording_reader.h"
+#include "record/recording_writer.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using trdp::record::PdRecordView;
+using trdp::record::RecordingQuery;
+using trdp::record::RecordingReader;
+using trdp::record::RecordingWriter;
+
+namespace
+{
+constexpr std::int64_t kStartNs = 1760000000LL * 1000000000LL;
+constexpr std::int64_t kCycleNs = 1000000;
+
+struct Expected
+{
+    std::int64_t timeNs;
+    std::uint32_t comId;
+    std::uint32_t sequence;
+    std::uint32_t srcIp;
+    std::uint32_t payloadBytes;
+};
+
+/** Cyclic-looking payloads: a counter in front, the rest changing every 500 cycles. */
+std::uint8_t payloadByte(const Expected &expected, std::uint32_t index)
+{
+    if (index < 4U)
+    {
+        return static_cast<std::uint8_t>(expected.sequence >> (8U * index));
+    }
+    return static_cast<std::uint8_t>(index + expected.comId + expected.sequence / 500U);
+}
+
+std::string temporaryPath()
+{
+    char path[] = "/tmp/recording_testXXXXXX";
+    const int fd = ::mkstemp(path);
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+    return path;
+}
+
+/** 20000 telegrams of five comIds, 1 ms apart, written with 64 KiB segments. */
+std::vector<Expected> writeRecording(const std::string &path, trdp::record::SegmentCodec codec)
+{
+    RecordingWriter writer;
+    std::string error;
+    trdp::record::RecordingOptions options;
+    options.path = path;
+    options.segmentBytes = 64U << 10U;
+    options.codec = codec;
+    if (!writer.open(options, error))
+    {
+        std::cerr << error << std::endl;
+        return {};
+    }
+
+    std::mt19937 random(42U);
+    std::vector<Expected> expected;
+    std::vector<std::uint8_t> payload(1432U);
+    std::uint32_t sequences[5] = {};
+    for (std::uint32_t index = 0U; index < 20000U; ++index)
+    {
+        const auto slot = random() % 5U;
+        // Now and then a publisher restarts, moves or resizes its telegram.
+        auto &sequence = sequences[slot];
+        sequence += index % 777U == 0U ? 1000U : 1U;
+        const auto srcIp = 0x0A000001U + (index / 5000U);
+        const auto size = static_cast<std::uint32_t>(slot * 300U + (index / 3000U) % 2U);
+
+        const Expected entry{kStartNs + static_cast<std::int64_t>(index) * kCycleNs,
+                             static_cast<std::uint32_t>(1200U + slot), sequence, srcIp, size};
+        for (std::uint32_t byte = 0U; byte < size; ++byte)
+        {
+            payload[byte] = payloadByte(entry, byte);
+        }
+        writer.append(PdRecordView{entry.timeNs, entry.comId, entry.sequence, entry.srcIp, 0xEF010101U,
+                                   payload.data(), size});
+        expected.push_back(entry);
+    }
+    writer.close();
+
+    const auto stats = writer.stats();
+    if (stats.records != expected.size() || stats.segments < 10U || stats.dropped != 0U || stats.writeFailed)
+    {
+        std::cerr << "Writer stats: " << stats.summary() << std::endl;
+        return {};
+    }
+    return expected;
+}
+
+bool matches(const PdRecordView &record, const Expected &expected)
+{
+    if (record.timeNs != expected.timeNs || record.comId != expected.comId || record.sequence != expected.sequence ||
+        record.payloadBytes != expected.payloadBytes || record.srcIp != expected.srcIp || record.destIp != 0xEF010101U)
+    {
+        return false;
+    }
+    for (std::uint32_t index = 0U; index < record.payloadBytes; ++index)
+    {
+        if (record.payload[index] != payloadByte(expected, index))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool checkQueries(const RecordingReader &reader, const std::vector<Expected> &expected)
+{
+    if (reader.recordCount() != expected.size() || reader.trailingBytes() != 0U ||
+        reader.firstNs() != expected.front().timeNs || reader.lastNs() != expected.back().timeNs)
+    {
+        std::cerr << "Recording holds " << reader.recordCount() << " telegrams in " << reader.segmentCount()
+                  << " segments" << std::endl;
+        return false;
+    }
+
+    const auto summaries = reader.comIds();
+    std::uint64_t summed = 0U;
+    for (const auto &summary : summaries)
+    {
+        summed += summary.count;
+    }
+    if (summaries.size() != 5U || summed != expected.size())
+    {
+        std::cerr << "Per-comId summary does not add up" << std::endl;
+        return false;
+    }
+
+    std::mt19937 random(7U);
+    for (int round = 0; round < 200; ++round)
+    {
+        RecordingQuery query;
+        query.comId = round % 3 == 0 ? 0U : static_cast<std::uint32_t>(1200U + random() % 6U);
+        query.fromNs = kStartNs + static_cast<std::int64_t>(random() % 21000U) * kCycleNs - kCycleNs / 2;
+        query.toNs = query.fromNs + static_cast<std::int64_t>(random() % 3000U) * kCycleNs;
+
+        std::vector<Expected> reference;
+        for (const auto &entry : expected)
+        {
+            if ((query.comId == 0U || entry.comId == query.comId) && entry.timeNs >= query.fromNs &&
+                entry.timeNs < query.toNs)
+            {
+                reference.push_back(entry);
+            }
+        }
+
+        std::size_t seen = 0U;
+        bool ok = true;
+        const auto visited = reader.query(query, [&](const PdRecordView &record) {
+            ok = ok && seen < reference.size() && matches(record, reference[seen]);
+            ++seen;
+            return true;
+        });
+        if (!ok || visited != reference.size() || seen != reference.size())
+        {
+            std::cerr << "Query " << round << " (comId " << query.comId << ") returned " << visited << " telegrams, "
+                      << "expected " << reference.size() << std::endl;
+            return false;
+        }
+    }
+
+    std::size_t stopped = 0U;
+    reader.query(RecordingQuery{}, [&stopped](const PdRecordView &) { return ++stopped < 10U; });
+    if (stopped != 10U)
+    {
+        std::cerr << "A visitor returning false should stop the query" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkTruncated(const std::string &path, const std::vector<Expected> &expected)
+{
+    // A crash while a segment is written leaves part of it at the end of the file.
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 100U);
+
+    RecordingReader reader;
+    std::string error;
+    if (!reader.open(path, error) || reader.trailingBytes() == 0U || reader.recordCount() >= expected.size() ||
+        reader.recordCount() == 0U)
+    {
+        std::cerr << "A cut-short last segment should be ignored, not fail the open" << std::endl;
+        return false;
+    }
+    std::uint64_t count = reader.query(RecordingQuery{}, [](const PdRecordView &) { return true; });
+    return count == reader.recordCount();
+}
+
+bool checkConcurrentWriters()
+{
+    const auto path = temporaryPath();
+    RecordingWriter writer;
+    std::string error;
+    trdp::record::RecordingOptions options;
+    options.path = path;
+    options.maxSegmentAge = std::chrono::milliseconds(20);
+    if (!writer.open(options, error))
+    {
+        std::cerr << error << std::endl;
+        return false;
+    }
+
+    // Sessions on different threads share one writer; their clocks need not agree.
+    std::vector<std::thread> sessions;
+    for (std::uint32_t session = 0U; session < 4U; ++session)
+    {
+        sessions.emplace_back([&writer, session] {
+            const std::uint8_t payload[16] = {};
+            for (std::uint32_t index = 0U; index < 5000U; ++index)
+            {
+                const auto timeNs = kStartNs + static_cast<std::int64_t>(index) * kCycleNs + session * 7;
+                writer.append(PdRecordView{timeNs, 1000U + session, index, session, 0U, payload, sizeof(payload)});
+            }
+        });
+    }
+    for (auto &session : sessions)
+    {
+        session.join();
+    }
+    writer.close();
+
+    RecordingReader reader;
+    std::int64_t previous = 0;
+    bool ordered = true;
+    std::uint64_t count = 0U;
+    if (reader.open(path, error))
+    {
+        count = reader.query(RecordingQuery{}, [&](const PdRecordView &record) {
+            ordered = ordered && record.timeNs >= previous;
+            previous = record.timeNs;
+            return true;
+        });
+    }
+    std::remove(path.c_str());
+    if (count != 20000U || !ordered || reader.comIds().size() != 4U)
+    {
+        std::cerr << "Concurrent writers produced " << count << " telegrams, ordered: " << ordered << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    using trdp::record::SegmentCodec;
+    bool ok = true;
+    for (const auto codec : {SegmentCodec::Raw, SegmentCodec::Delta, SegmentCodec::DeltaLz})
+    {
+        const auto path = temporaryPath();
+        const auto expected = writeRecording(path, codec);
+        RecordingReader reader;
+        std::string error;
+        const bool passed = !expected.empty() && reader.open(path, error) && checkQueries(reader, expected) &&
+                            checkTruncated(path, expected);
+        if (!passed)
+        {
+            std::cerr << "Codec " << trdp::record::segmentCodecName(codec) << " failed " << error << std::endl;
+        }
+        else
+        {
+            std::cout << trdp::record::segmentCodecName(codec) << ": " << reader.fileBytes() << " bytes for "
+                      << reader.recordBytes() << " bytes of records" << std::endl;
+        }
+        ok = ok && passed;
+        std::remove(path.c_str());
+    }
+    return ok && checkConcurrentWriters() ? 0 : 1;
+}
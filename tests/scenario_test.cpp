@@ -0,0 +1,241 @@
+#include "scenario/scenario_runner.h"
+
+#include "config/dataset_wire.h"
+
+#include "fake_endpoint.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using trdp::config::loadBig;
+using trdp::model::Dataset;
+using trdp::model::SimulatorConfig;
+using trdp::runtime::PdDirection;
+using trdp::scenario::Scenario;
+using trdp::scenario::ScenarioAction;
+using trdp::scenario::ScenarioRunner;
+using trdp::test::FakeEndpoint;
+
+namespace
+{
+SimulatorConfig makeConfig()
+{
+    SimulatorConfig config{};
+    config.datasets.push_back(
+        Dataset{4001, "doors", {{"door_state", "UINT8", 1}, {"speed", "REAL32", 1}, {"counters", "UINT16", 3}}});
+    config.datasets.push_back(Dataset{4002, "variable", {{"len", "UINT16", 1}, {"data", "UINT8", 0}}});
+    trdp::model::InterfaceConfig iface{};
+    iface.name = "eth0";
+    trdp::model::TelegramConfig doors{};
+    doors.comId = 300U;
+    doors.datasetId = 4001U;
+    trdp::model::TelegramConfig variable{};
+    variable.comId = 301U;
+    variable.datasetId = 4002U;
+    iface.telegrams = {doors, variable};
+    config.interfaces.push_back(iface);
+    return config;
+}
+
+bool compile(const std::string &text, Scenario &scenario, std::string &error)
+{
+    return trdp::scenario::compileScenario(text, makeConfig(), "test.scn", scenario, error);
+}
+
+bool checkCompile()
+{
+    const std::string text = "# door sequence\n"
+                             "at 2s set 300 door_state=1 counters=7\n"
+                             "at 2.5s stop 301\n"
+                             "after 10s start 301 100ms   # resumes at 12.5 s\n"
+                             "every 250ms from 1s until 1.5s set 300 speed=0.5,-2 counters[1]=0x10\n"
+                             "every 1s times 2 fixed 301 00ff\n"
+                             "at 0 unfix 301\n";
+    Scenario scenario;
+    std::string error;
+    if (!compile(text, scenario, error))
+    {
+        std::cerr << "Scenario did not compile: " << error << std::endl;
+        return false;
+    }
+
+    // 0 fixed and unfix, 1 s set and fixed, 1.25 s set, 1.5 s set, 2 s set, 2.5 s stop, 12.5 s start.
+    const std::vector<std::int64_t> expectedMs{0, 0, 1000, 1000, 1250, 1500, 2000, 2500, 12500};
+    std::vector<std::int64_t> times;
+    for (const auto &event : scenario.events)
+    {
+        times.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(event.at).count());
+    }
+    const auto &last = scenario.events.back();
+    if (times != expectedMs || scenario.events[0].action != ScenarioAction::Fixed ||
+        scenario.events[1].action != ScenarioAction::Unfix || scenario.events[2].action != ScenarioAction::Set ||
+        last.action != ScenarioAction::Start || last.cycle != std::chrono::milliseconds(100) || last.line != 4U ||
+        scenario.telegrams.size() != 2U || scenario.telegrams[0].wireSize != 11U ||
+        scenario.duration() != std::chrono::milliseconds(12500))
+    {
+        std::cerr << "Unexpected timeline" << std::endl;
+        return false;
+    }
+
+    // The repeated set steps through its value list; counters=7 covers all three elements.
+    const auto &second = scenario.events[4];
+    const auto &single = scenario.events[6];
+    if (second.count != 2U || scenario.writes[second.first].value.real != -2.0 ||
+        scenario.writes[second.first + 1U].offset != 7U || single.count != 4U ||
+        scenario.writes[single.first + 3U].offset != 9U || scenario.writes[single.first + 3U].value.integer != 7)
+    {
+        std::cerr << "Unexpected field writes" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkErrors()
+{
+    const std::vector<std::pair<std::string, std::string>> cases{
+        {"at 1s set 300 missing=1", "test.scn:1: dataset 4001 has no field 'missing'"},
+        {"\nat 1s set 300 door_state=256", "test.scn:2: '256' is not a valid value for door_state"},
+        {"at 1 stop 300", "test.scn:1: invalid time '1' (use a unit: s, ms, us or ns)"},
+        {"at 1s stop 999", "test.scn:1: ComID 999 is not a telegram of the configuration"},
+        {"every 1s stop 300", "test.scn:1: 'every' needs 'until T' or 'times N'"},
+        {"at 1s tx 300 0F0", "test.scn:1: 'tx' expects the payload as hex bytes, e.g. 00FF10AA"},
+        {"at 1s stop 300 now", "test.scn:1: unexpected 'now' after the stop action"},
+        {"at 1s pause 300", "test.scn:1: unknown action 'pause' (start, stop, set, tx, fixed, unfix)"},
+        {"# nothing\n", "test.scn: the scenario has no events"},
+    };
+    for (const auto &[text, expected] : cases)
+    {
+        Scenario scenario;
+        std::string error;
+        if (compile(text, scenario, error) || error != expected)
+        {
+            std::cerr << "Expected '" << expected << "', got '" << error << "'" << std::endl;
+            return false;
+        }
+    }
+
+    Scenario scenario;
+    std::string error;
+    if (compile("at 1s set 301 len=1", scenario, error) || error.rfind("test.scn:1: 'set' needs a fixed", 0) != 0 ||
+        compile("every 1ns times 5000000 stop 300", scenario, error))
+    {
+        std::cerr << "Variable-length datasets and oversized expansions should be rejected" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/** 1000 events at 2 kHz: every set is executed in order, on time, and lands in the payload. */
+bool checkRunner(const std::filesystem::path &reportPath)
+{
+    const std::string text = "at 0 start 300\n"
+                             "every 500us from 1ms times 1000 set 300 door_state=1,2,3,4 counters[2]=9\n"
+                             "at 600ms stop 300\n"
+                             "at 600ms tx 301 0102\n";
+    Scenario scenario;
+    std::string error;
+    if (!compile(text, scenario, error))
+    {
+        std::cerr << error << std::endl;
+        return false;
+    }
+
+    auto doors = std::make_shared<FakeEndpoint>(PdDirection::Outgoing, std::vector<std::uint8_t>{0xAAU, 0xBBU});
+    ScenarioRunner runner(std::move(scenario));
+    if (!runner.bind(300U, doors) || runner.bind(999U, doors))
+    {
+        std::cerr << "Binding by ComID failed" << std::endl;
+        return false;
+    }
+    runner.start();
+    if (!runner.waitFor(std::chrono::seconds(10)))
+    {
+        std::cerr << "Scenario did not finish" << std::endl;
+        return false;
+    }
+
+    const auto report = runner.report();
+    std::cout << "scenario: " << report.summary() << std::endl;
+    const auto calls = doors->calls();
+    if (report.executed != 1002U || report.unbound != 1U || report.failed != 0U || !report.completed() ||
+        calls.size() != 1002U ||
+        calls.front().what != "start" || calls.front().cycle != std::chrono::milliseconds(20) ||
+        calls.back().what != "stop" || report.minLate.count() < 0 || report.p50Late > std::chrono::milliseconds(5))
+    {
+        std::cerr << "Unexpected run: " << report.summary() << std::endl;
+        return false;
+    }
+    for (std::size_t k = 0; k < 1000U; ++k)
+    {
+        const auto &payload = calls[k + 1U].payload;
+        if (calls[k + 1U].what != "tx" || payload.size() != 11U || payload[0] != 1U + k % 4U || payload[1] != 0xBBU ||
+            loadBig<std::uint16_t>(payload.data() + 9) != 9U)
+        {
+            std::cerr << "Set " << k << " did not write the expected payload" << std::endl;
+            return false;
+        }
+    }
+
+    if (!runner.writeReport(reportPath.string(), error))
+    {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    std::ifstream in(reportPath);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);)
+    {
+        lines.push_back(line);
+    }
+    if (lines.size() != 1004U || lines[0] != "line,action,comid,planned_ns,actual_ns,late_ns" ||
+        lines[2].rfind("2,set,300,1000000,", 0) != 0 || lines[1003] != "4,tx,301,600000000,,")
+    {
+        std::cerr << "Unexpected report:\n" << (lines.size() > 2U ? lines[2] : "") << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkStop()
+{
+    Scenario scenario;
+    std::string error;
+    if (!compile("at 0 stop 300\nat 30s start 300\n", scenario, error))
+    {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    ScenarioRunner runner(std::move(scenario));
+    auto refusing = std::make_shared<FakeEndpoint>();
+    refusing->setAccepting(false);
+    runner.bind(300U, std::make_shared<FakeEndpoint>());
+    runner.bind(300U, refusing);
+    runner.start();
+    const bool early = runner.waitFor(std::chrono::milliseconds(50));
+    runner.stop();
+    const auto report = runner.report();
+    if (early || !runner.finished() || report.executed != 1U || report.pending != 1U || report.failed != 1U ||
+        report.completed())
+    {
+        std::cerr << "stop() should end the run before the second event: " << report.summary() << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    const auto reportPath =
+        std::filesystem::temp_directory_path() / ("scenario_test_" + std::to_string(::getpid()) + ".csv");
+    const bool ok = checkCompile() && checkErrors() && checkRunner(reportPath) && checkStop();
+    std::filesystem::remove(reportPath);
+    return ok ? 0 : 1;
+}
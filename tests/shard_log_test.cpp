@@ -0,0 +1,156 @@
+#include "shard/shard_log.h"
+#include "util/log_store.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+using trdp::shard::decodeLogRecord;
+using trdp::shard::encodeLogRecord;
+using trdp::shard::kLogRecordBytes;
+using trdp::shard::ShardLogReader;
+using trdp::shard::ShardLogRecord;
+using trdp::shard::ShardLogWriter;
+using trdp::util::LogFilter;
+using trdp::util::LogLevel;
+using trdp::util::LogStore;
+
+namespace
+{
+bool checkEncoding()
+{
+    ShardLogRecord first;
+    first.level = LogLevel::Warn;
+    first.comId = 1001U;
+    first.timeNs = 1700000000123456789LL;
+    first.session = "10.0.0.1";
+    first.message = "ComID 1001 lost after 250 ms";
+    ShardLogRecord second;
+    second.message = std::string(2U * kLogRecordBytes, 'x');
+
+    const auto encoded = encodeLogRecord(first) + encodeLogRecord(second);
+    if (encodeLogRecord(second).size() != kLogRecordBytes)
+    {
+        std::cerr << "Long message was not cut to one record" << std::endl;
+        return false;
+    }
+
+    // A partial record decodes to nothing and leaves the offset alone.
+    std::size_t offset = 0U;
+    ShardLogRecord decoded;
+    if (decodeLogRecord(encoded.substr(0U, 10U), offset, decoded) || offset != 0U)
+    {
+        std::cerr << "Partial record was decoded" << std::endl;
+        return false;
+    }
+    if (!decodeLogRecord(encoded, offset, decoded) || decoded.level != first.level || decoded.comId != first.comId ||
+        decoded.timeNs != first.timeNs || decoded.session != first.session || decoded.message != first.message)
+    {
+        std::cerr << "First record did not round-trip" << std::endl;
+        return false;
+    }
+    if (!decodeLogRecord(encoded, offset, decoded) || !decoded.session.empty() ||
+        decoded.message != second.message.substr(0U, decoded.message.size()) || offset != encoded.size())
+    {
+        std::cerr << "Cut record did not round-trip" << std::endl;
+        return false;
+    }
+    return !decodeLogRecord(encoded, offset, decoded);
+}
+
+/** Messages logged while a writer is installed arrive in the reader's store, untagged ones under its session. */
+bool checkPipe()
+{
+    int fds[2];
+    if (::pipe(fds) != 0)
+    {
+        std::cerr << "Could not create a pipe" << std::endl;
+        return false;
+    }
+    ::fcntl(fds[1], F_SETFL, ::fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+    trdp::util::setConsoleEcho(false);
+    {
+        ShardLogWriter writer(fds[1]);
+        trdp::util::logInfo("worker started");
+        trdp::util::logWarn("ComID 2002 timed out", {"10.0.0.2", 2002U});
+        if (writer.dropped() != 0U)
+        {
+            std::cerr << "Messages were dropped from an empty pipe" << std::endl;
+            return false;
+        }
+    }
+    trdp::util::logInfo("after the writer is gone");
+
+    const auto store = std::make_shared<LogStore>(64U);
+    trdp::util::setLogStore(store);
+    ShardLogReader reader;
+    reader.start(fds[0], "10.0.0.1");
+    reader.join();
+    trdp::util::setLogStore(nullptr);
+
+    const auto page = store->query(LogFilter{}, LogStore::kLive, 0U, 10U);
+    if (page.entries.size() != 2U)
+    {
+        std::cerr << "Store holds " << page.entries.size() << " messages, expected 2" << std::endl;
+        return false;
+    }
+    const auto &started = page.entries[0];
+    const auto &timedOut = page.entries[1];
+    if (started.message != "worker started" || started.session != "10.0.0.1" || started.level != LogLevel::Info)
+    {
+        std::cerr << "Untagged message arrived as '" << started.message << "' in '" << started.session << "'"
+                  << std::endl;
+        return false;
+    }
+    if (timedOut.message != "ComID 2002 timed out" || timedOut.session != "10.0.0.2" || timedOut.comId != 2002U ||
+        timedOut.level != LogLevel::Warn)
+    {
+        std::cerr << "Tagged message arrived as '" << timedOut.message << "' in '" << timedOut.session << "'"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/** Nobody reads the pipe: once it is full, messages are counted as dropped instead of blocking the logger. */
+bool checkFullPipe()
+{
+    int fds[2];
+    if (::pipe(fds) != 0)
+    {
+        std::cerr << "Could not create a pipe" << std::endl;
+        return false;
+    }
+    ::fcntl(fds[1], F_SETFL, ::fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+    const auto capacity = ::fcntl(fds[1], F_GETPIPE_SZ);
+    const auto messages = static_cast<std::size_t>(capacity > 0 ? capacity : 1 << 16) / 64U + 16U;
+    std::uint64_t dropped = 0U;
+    {
+        ShardLogWriter writer(fds[1]);
+        for (std::size_t i = 0; i < messages; ++i)
+        {
+            trdp::util::logDebug(std::string(60U, 'y'));
+        }
+        dropped = writer.dropped();
+    }
+    ::close(fds[0]);
+    if (dropped == 0U || dropped >= messages)
+    {
+        std::cerr << dropped << " of " << messages << " messages dropped" << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    if (!checkEncoding() || !checkPipe() || !checkFullPipe())
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include "shard/shard_region.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using trdp::shard::EndpointSlotState;
+using trdp::shard::kCommandRingCapacity;
+using trdp::shard::kSlotPayloadBytes;
+using trdp::shard::SharedMemory;
+using trdp::shard::ShardCommand;
+using trdp::shard::ShardCommandRing;
+using trdp::shard::ShardCommandType;
+using trdp::shard::ShardStateRegion;
+using trdp::shard::WorkerState;
+
+namespace
+{
+constexpr std::size_t kSlots = 4U;
+constexpr std::uint64_t kGenerations = 200000U;
+
+/** Every byte of a generation's state is derived from it, so a torn copy is easy to spot. */
+EndpointSlotState makeState(std::uint64_t generation)
+{
+    EndpointSlotState state{};
+    state.publishCount = generation;
+    state.receiveCount = generation * 3U;
+    state.txSize = static_cast<std::uint16_t>(generation % kSlotPayloadBytes);
+    std::memset(state.tx, static_cast<int>(generation & 0xFFU), sizeof(state.tx));
+    std::memset(state.rx, static_cast<int>((generation >> 8U) & 0xFFU), sizeof(state.rx));
+    return state;
+}
+
+bool consistent(const EndpointSlotState &state)
+{
+    const auto expected = makeState(state.publishCount);
+    return std::memcmp(&state, &expected, sizeof(state)) == 0;
+}
+
+/** A forked writer updates the slots as fast as it can while this process reads them through a read-only mapping. */
+bool checkSeqlockAcrossProcesses()
+{
+    std::string error;
+    SharedMemory memory;
+    if (!memory.create("shard-region-test", ShardStateRegion::bytesFor(kSlots), true, error))
+    {
+        std::cerr << "Could not create the region: " << error << std::endl;
+        return false;
+    }
+    ShardStateRegion writerView(memory.data(), kSlots);
+    writerView.initialize();
+
+    const pid_t pid = ::fork();
+    if (pid == 0)
+    {
+        for (std::uint64_t generation = 1; generation <= kGenerations; ++generation)
+        {
+            writerView.store(generation % kSlots, makeState(generation));
+        }
+        writerView.setWorkerState(WorkerState::Stopped);
+        ::_exit(0);
+    }
+
+    SharedMemory readOnly;
+    if (!readOnly.attach(::dup(memory.fd()), false, error))
+    {
+        std::cerr << "Could not map the region read-only: " << error << std::endl;
+        return false;
+    }
+    ShardStateRegion reader(readOnly.data(), kSlots);
+    if (!reader.ready())
+    {
+        std::cerr << "Initialized region not reported ready" << std::endl;
+        return false;
+    }
+
+    std::uint64_t reads = 0U;
+    std::uint64_t torn = 0U;
+    std::uint64_t lastSeen[kSlots]{};
+    while (reader.workerState() != WorkerState::Stopped)
+    {
+        for (std::size_t slot = 0; slot < kSlots; ++slot)
+        {
+            EndpointSlotState state{};
+            if (!reader.load(slot, state))
+            {
+                continue;
+            }
+            ++reads;
+            if (!consistent(state) || state.publishCount < lastSeen[slot])
+            {
+                ++torn;
+            }
+            lastSeen[slot] = state.publishCount;
+        }
+    }
+
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        std::cerr << "Writer process failed" << std::endl;
+        return false;
+    }
+
+    EndpointSlotState last{};
+    if (torn != 0U || !reader.load(kGenerations % kSlots, last) || last.publishCount != kGenerations)
+    {
+        std::cerr << torn << " of " << reads << " reads were torn or went backwards" << std::endl;
+        return false;
+    }
+    std::cout << reads << " consistent reads while " << kGenerations << " updates were written" << std::endl;
+    return true;
+}
+
+bool checkCommandRing()
+{
+    std::string error;
+    SharedMemory memory;
+    if (!memory.create("shard-ring-test", ShardCommandRing::bytes(), true, error))
+    {
+        std::cerr << "Could not create the ring: " << error << std::endl;
+        return false;
+    }
+    ShardCommandRing producer(memory.data());
+    producer.initialize();
+    ShardCommandRing consumer(memory.data());
+
+    std::uint32_t pushed = 0U;
+    std::uint32_t popped = 0U;
+    for (int round = 0; round < 5; ++round)
+    {
+        ShardCommand command{};
+        command.type = ShardCommandType::SetTxPayload;
+        while (true)
+        {
+            command.slot = pushed;
+            command.size = pushed % kSlotPayloadBytes;
+            if (!producer.push(command))
+            {
+                break;
+            }
+            ++pushed;
+        }
+        if (pushed - popped != kCommandRingCapacity)
+        {
+            std::cerr << "Ring accepted " << pushed - popped << " commands, expected " << kCommandRingCapacity << std::endl;
+            return false;
+        }
+
+        // Drain half, so the next round wraps around the end of the buffer.
+        for (std::size_t i = 0; i < kCommandRingCapacity / 2U; ++i)
+        {
+            if (!consumer.pop(command) || command.slot != popped || command.size != popped % kSlotPayloadBytes)
+            {
+                std::cerr << "Commands came out of order at " << popped << std::endl;
+                return false;
+            }
+            ++popped;
+        }
+    }
+
+    ShardCommand command{};
+    while (consumer.pop(command))
+    {
+        if (command.slot != popped++)
+        {
+            std::cerr << "Commands came out of order while draining" << std::endl;
+            return false;
+        }
+    }
+    if (popped != pushed)
+    {
+        std::cerr << "Lost commands: pushed " << pushed << ", popped " << popped << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    if (!checkSeqlockAcrossProcesses() || !checkCommandRing())
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "shard/state_export.h"
+
+#include "fake_endpoint.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using trdp::runtime::PdDirection;
+using trdp::shard::EndpointSlotState;
+using trdp::shard::StateExport;
+using trdp::shard::StateExportReader;
+using trdp::test::FakeEndpoint;
+
+namespace
+{
+/** Waits until slot 0 shows `publishCount`; the exporter may have picked up the change over two passes. */
+bool waitForPublishCount(const StateExportReader &reader, std::uint64_t publishCount, EndpointSlotState &state)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!reader.load(0U, state) || state.publishCount != publishCount || state.txSize != 1U)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+bool checkExport(const std::string &name)
+{
+    auto doors = std::make_shared<FakeEndpoint>(PdDirection::Outgoing);
+    auto status = std::make_shared<FakeEndpoint>(PdDirection::Incoming);
+    doors->setTxPayload({0x01U, 0x02U});
+    doors->setDestinationCount(2U);
+
+    StateExport exporter;
+    exporter.add(300U, 4001U, "eth0", doors);
+    exporter.add(301U, 4002U, "a-very-long-interface-name", status);
+    std::string error;
+    if (!exporter.start(name, std::chrono::milliseconds(10), error))
+    {
+        std::cerr << error << std::endl;
+        return false;
+    }
+
+    StateExportReader reader;
+    if (!reader.open(name, error) || reader.slotCount() != 2U)
+    {
+        std::cerr << "Could not read the export: " << error << std::endl;
+        return false;
+    }
+    const auto &first = reader.descriptor(0U);
+    const auto &second = reader.descriptor(1U);
+    EndpointSlotState state{};
+    std::uint32_t sequence = 0U;
+    if (first.comId != 300U || first.datasetId != 4001U || first.direction != 1U ||
+        std::string(first.interfaceName) != "eth0" || second.direction != 2U ||
+        std::string(second.interfaceName) != "a-very-long-interfa" || !reader.load(0U, state, &sequence) ||
+        state.txSize != 2U || state.tx[1] != 0x02U || state.destinationCount != 2U || sequence != 2U)
+    {
+        std::cerr << "The first export pass is wrong" << std::endl;
+        return false;
+    }
+
+    // Only the telegram that changed is rewritten.
+    const auto generation = reader.generation();
+    const auto untouched = reader.sequence(1U);
+    doors->setPublishCount(42U);
+    doors->setTxPayload({0xAAU});
+    if (!waitForPublishCount(reader, 42U, state) || state.publishing != 1U || state.tx[0] != 0xAAU ||
+        reader.generation() <= generation || reader.sequence(0U) < 4U || reader.sequence(1U) != untouched)
+    {
+        std::cerr << "The change was not exported" << std::endl;
+        return false;
+    }
+
+    // Idle passes keep the generation, so a reader polling an idle simulator reads 64 bytes.
+    const auto idle = reader.generation();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    if (reader.generation() != idle)
+    {
+        std::cerr << "An idle pass bumped the generation" << std::endl;
+        return false;
+    }
+
+    exporter.stop();
+    StateExportReader gone;
+    if (gone.open(name, error))
+    {
+        std::cerr << "stop() should remove the segment" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkNames(const std::string &name)
+{
+    // A segment left behind by a crashed run is replaced.
+    StateExport crashed;
+    StateExport next;
+    std::string error;
+    if (!crashed.start(name, std::chrono::milliseconds(10), error) ||
+        !next.start(name, std::chrono::milliseconds(10), error))
+    {
+        std::cerr << "A stale segment was not replaced: " << error << std::endl;
+        return false;
+    }
+    next.stop();
+    crashed.stop();
+
+    StateExport invalid;
+    if (invalid.start("a/b", std::chrono::milliseconds(10), error) ||
+        invalid.start("", std::chrono::milliseconds(10), error))
+    {
+        std::cerr << "Names with '/' or empty names should be rejected" << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    const auto name = "trdp_state_export_test_" + std::to_string(::getpid());
+    return checkExport(name) && checkNames(name) ? 0 : 1;
+}
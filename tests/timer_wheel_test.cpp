@@ -0,0 +1,145 @@
+#include "util/timer_wheel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+using trdp::util::TimerWheel;
+
+namespace
+{
+constexpr std::uint32_t kTimers = 2000U;
+constexpr std::uint64_t kSteps = 100000U;
+
+/** Random arm/re-arm/cancel traffic compared against a brute-force reference of expiry times. */
+bool checkAgainstReference()
+{
+    std::mt19937_64 rng(42U);
+    TimerWheel wheel;
+    std::vector<TimerWheel::TimerId> ids;
+    std::map<TimerWheel::TimerId, std::uint64_t> expected;
+    for (std::uint32_t i = 0; i < kTimers; ++i)
+    {
+        ids.push_back(wheel.create(i));
+    }
+
+    // Mix short PD-like timeouts with spans that need the second and third wheel levels.
+    const auto randomDelay = [&rng]() -> std::uint64_t {
+        switch (rng() % 4U)
+        {
+        case 0:
+            return rng() % 8U;
+        case 1:
+            return rng() % 300U;
+        case 2:
+            return rng() % 70000U;
+        default:
+            return rng() % 2000000U;
+        }
+    };
+
+    std::uint64_t now = 0U;
+    for (std::uint64_t step = 0; step < kSteps; ++step)
+    {
+        const auto id = ids[rng() % ids.size()];
+        if (rng() % 5U == 0U)
+        {
+            wheel.cancel(id);
+            expected.erase(id);
+        }
+        else
+        {
+            const auto expiry = now + randomDelay();
+            wheel.arm(id, expiry);
+            // Expiries at or before the current tick are due at the next tick advance() processes.
+            expected[id] = std::max(expiry, wheel.currentTick());
+        }
+
+        const auto next = wheel.nextEventTick();
+        for (const auto &entry : expected)
+        {
+            if (!next || *next > entry.second)
+            {
+                std::cerr << "nextEventTick is later than an armed expiry (step " << step << ")" << std::endl;
+                return false;
+            }
+        }
+
+        now += rng() % 3U == 0U ? rng() % 600U : rng() % 2U;
+        bool ok = true;
+        wheel.advance(now, [&](TimerWheel::TimerId fired, std::uint64_t) {
+            const auto it = expected.find(fired);
+            const auto processedTick = wheel.currentTick() - 1U;
+            if (it == expected.end() || it->second != processedTick)
+            {
+                ok = false;
+            }
+            if (it != expected.end())
+            {
+                expected.erase(it);
+            }
+        });
+        if (!ok)
+        {
+            std::cerr << "Timer fired early, late or while cancelled (step " << step << ")" << std::endl;
+            return false;
+        }
+        for (const auto &entry : expected)
+        {
+            if (entry.second <= now)
+            {
+                std::cerr << "Timer " << entry.first << " due at " << entry.second << " did not fire by " << now << std::endl;
+                return false;
+            }
+        }
+        if (wheel.armedCount() != expected.size())
+        {
+            std::cerr << "Armed count drifted from the reference" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Callbacks may re-arm the firing timer for the same tick without being fired twice in one advance. */
+bool checkRearmFromCallback()
+{
+    TimerWheel wheel;
+    const auto id = wheel.create(7U);
+    wheel.arm(id, 5U);
+
+    std::size_t calls = 0U;
+    wheel.advance(5U, [&](TimerWheel::TimerId fired, std::uint64_t userData) {
+        ++calls;
+        if (fired == id && userData == 7U)
+        {
+            wheel.arm(id, 5U);
+        }
+    });
+    if (calls != 1U || !wheel.isArmed(id))
+    {
+        std::cerr << "Re-arming from the callback should defer the timer to the next tick" << std::endl;
+        return false;
+    }
+
+    wheel.advance(6U, [&](TimerWheel::TimerId, std::uint64_t) { ++calls; });
+    wheel.destroy(id);
+    return calls == 2U && wheel.armedCount() == 0U;
+}
+} // namespace
+
+int main()
+{
+    if (!checkRearmFromCallback())
+    {
+        return 1;
+    }
+    if (!checkAgainstReference())
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "util/trace.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trace = trdp::util::trace;
+
+namespace
+{
+const std::string kPath = "trace_test.json";
+
+std::string dump()
+{
+    if (trace::writeChromeJson(kPath) < 0)
+    {
+        return {};
+    }
+    std::ifstream in(kPath);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+std::size_t occurrences(const std::string &text, const std::string &needle)
+{
+    std::size_t count = 0U;
+    for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + needle.size()))
+    {
+        ++count;
+    }
+    return count;
+}
+
+void work(const std::string &name, int spans)
+{
+    TRDP_TRACE_THREAD_NAME(name);
+    for (int i = 0; i < spans; ++i)
+    {
+        TRDP_TRACE_SCOPE_ARG("dispatch", "comId", i);
+        TRDP_TRACE_COUNTER("queue depth", i);
+    }
+}
+} // namespace
+
+int main()
+{
+    {
+        TRDP_TRACE_SCOPE("not recorded");
+        TRDP_TRACE_INSTANT("not recorded either");
+    }
+    if (occurrences(dump(), "\"ph\":") != 0U)
+    {
+        std::cerr << "Events were recorded while tracing was disabled" << std::endl;
+        return 1;
+    }
+
+    trace::setEnabled(true);
+    std::thread first(work, "worker \"a\"", 1000);
+    std::thread second(work, "worker b", 1000);
+    first.join();
+    second.join();
+
+    const auto json = dump();
+    if (json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) != 0 || json.find("]}") == std::string::npos ||
+        occurrences(json, "\"ph\":\"X\"") != 2000U || occurrences(json, "\"ph\":\"C\"") != 2000U ||
+        occurrences(json, "\"thread_name\"") != 2U || json.find("worker \\\"a\\\"") == std::string::npos ||
+        json.find("\"args\":{\"comId\":999}") == std::string::npos)
+    {
+        std::cerr << "Unexpected trace content:\n" << json.substr(0, 2000) << std::endl;
+        return 1;
+    }
+
+    // A thread that records more than its ring holds keeps the newest events only.
+    trace::clear();
+    std::thread busy([] {
+        for (std::size_t i = 0; i < trace::kRingCapacity + 100U; ++i)
+        {
+            TRDP_TRACE_INSTANT("tick");
+        }
+    });
+    busy.join();
+    // The oldest retained slot is the one a still-running writer would overwrite next, so it is dropped.
+    const auto retained = occurrences(dump(), "\"ph\":\"i\"");
+    if (retained != trace::kRingCapacity - 1U)
+    {
+        std::cerr << "Ring kept " << retained << " events, expected its capacity less one" << std::endl;
+        return 1;
+    }
+
+    // Dumping while a thread keeps writing must stay well-formed.
+    trace::clear();
+    std::thread writer([] { work("writer", 200000); });
+    for (int i = 0; i < 5; ++i)
+    {
+        const auto concurrent = dump();
+        if (concurrent.empty() || concurrent.substr(concurrent.size() - 4U) != "\n]}\n")
+        {
+            std::cerr << "Concurrent dump was truncated" << std::endl;
+            writer.join();
+            return 1;
+        }
+    }
+    writer.join();
+
+    trace::clear();
+    if (occurrences(dump(), "\"ph\":\"X\"") != 0U)
+    {
+        std::cerr << "clear() kept events" << std::endl;
+        return 1;
+    }
+    std::remove(kPath.c_str());
+    return 0;
+}
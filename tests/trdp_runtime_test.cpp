@@ -1,99 +1,242 @@
 #include "trdp/pd_endpoint.h"
 #include "trdp/trdp_session.h"
+#include "trdp/virtual_wire.h"
+
+#include <trdp_if_light.h>
+#include <vos_sock.h>
 
 #include <chrono>
-#include <condition_variable>
 #include <iostream>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <thread>
 
+using trdp::model::PdParameters;
 using trdp::model::TelegramConfig;
 using trdp::model::TelegramEndpoint;
 using trdp::runtime::PdEndpointRuntime;
 using trdp::runtime::PdMessage;
 using trdp::runtime::TrdpSession;
 using trdp::runtime::TrdpSessionConfig;
+using trdp::runtime::VirtualWire;
 
 namespace
 {
-TrdpSessionConfig loopbackSessionConfig()
+TrdpSessionConfig sessionConfig(const char *hostIp, std::shared_ptr<VirtualWire> wire)
 {
     TrdpSessionConfig config{};
-    config.hostIp = "127.0.0.1";
-    config.leaderIp = "127.0.0.1";
+    config.hostIp = hostIp;
+    config.leaderIp = hostIp;
     config.networkId = 0U;
+    config.virtualWire = std::move(wire);
     return config;
 }
 
-TelegramConfig loopbackTelegram(std::uint32_t comId)
+TelegramConfig selfAddressedTelegram(std::uint32_t comId, const char *hostIp)
 {
     TelegramConfig config{};
     config.comId = comId;
     config.serviceId = 0U;
-    config.destinations.push_back(TelegramEndpoint{0U, "", "127.0.0.1"});
-    config.sources.push_back(TelegramEndpoint{0U, "", "127.0.0.1"});
+    config.destinations.push_back(TelegramEndpoint{0U, "", hostIp});
+    config.sources.push_back(TelegramEndpoint{0U, "", hostIp});
     return config;
 }
+
+bool checkPublishDestinations()
+{
+    TelegramConfig config{};
+    config.comId = 0x4242U;
+    for (const auto *host : {"10.0.0.2", "10.0.0.3", "10.0.0.2", "239.1.1.1", ""})
+    {
+        config.destinations.push_back(TelegramEndpoint{0U, "", host});
+    }
+
+    const auto destinations = trdp::runtime::resolvePublishDestinations(config, 0x7F000001U);
+    if (destinations.size() != 3U)
+    {
+        std::cerr << "Expected every distinct destination to get a publisher, got " << destinations.size() << std::endl;
+        return false;
+    }
+
+    PdEndpointRuntime endpoint(config, nullptr, "10.0.0.1");
+    if (endpoint.multicastGroup() != vos_dottedIP("239.1.1.1"))
+    {
+        std::cerr << "Multicast destination should be used as the subscription group" << std::endl;
+        return false;
+    }
+
+    TelegramConfig unaddressed{};
+    const auto fallback = trdp::runtime::resolvePublishDestinations(unaddressed, 0x7F000001U);
+    if (fallback.size() != 1U || fallback.front() != 0x7F000001U)
+    {
+        std::cerr << "Telegram without destinations should fall back to the given address" << std::endl;
+        return false;
+    }
+    return true;
 }
 
-int main()
+/** Only check that touches the stack's sockets: a loopback session opens and closes without waiting on traffic. */
+bool checkLoopbackSession()
 {
-    auto session = std::make_shared<TrdpSession>(loopbackSessionConfig());
+    auto session = std::make_shared<TrdpSession>(sessionConfig("127.0.0.1", nullptr));
+    if (!session->open() || !session->isOpen())
+    {
+        std::cerr << "Failed to open TRDP session on loopback" << std::endl;
+        return false;
+    }
+    session->close();
+    if (session->isOpen())
+    {
+        std::cerr << "TRDP session should report closed after close()" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/** Role of redundancy group `redId` as the stack reports it, read on the process thread. */
+bool isGroupLeader(TrdpSession &session, std::uint32_t redId)
+{
+    return session
+        .submit([&session, redId] {
+            BOOL8 leader = FALSE;
+            return tlp_getRedundant(session.appHandle(), redId, &leader) == TRDP_NO_ERR && leader == TRUE;
+        })
+        .get();
+}
+
+/**
+ * On the stack, a pause silences publishers with and without a redundancy group, and resuming gives a
+ * configured group back the role it had before instead of making the simulator its leader.
+ */
+bool checkStackPause()
+{
+    auto session = std::make_shared<TrdpSession>(sessionConfig("127.0.0.1", nullptr));
     if (!session->open())
     {
         std::cerr << "Failed to open TRDP session on loopback" << std::endl;
-        return 1;
+        return false;
     }
 
-    if (!session->isOpen())
+    constexpr std::uint32_t kGroup = 7U;
+    auto groupedConfig = selfAddressedTelegram(0x12347U, "127.0.0.1");
+    groupedConfig.pd = PdParameters{};
+    groupedConfig.pd->redundant = kGroup;
+    PdEndpointRuntime ungrouped(selfAddressedTelegram(0x12346U, "127.0.0.1"), session, session->hostIpString());
+    PdEndpointRuntime grouped(groupedConfig, session, session->hostIpString());
+    ungrouped.startPublishing(std::chrono::milliseconds(10));
+    grouped.startPublishing(std::chrono::milliseconds(10));
+
+    // Another redundancy manager made this device follow in group 7.
+    session->submit([&session] { return tlp_setRedundant(session->appHandle(), kGroup, FALSE); }).get();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const auto groupedBefore = grouped.publishCount();
+    if (ungrouped.publishCount() == 0U)
     {
-        std::cerr << "TRDP session should report open after successful open()" << std::endl;
-        return 1;
+        std::cerr << "The publisher without a redundancy group did not send" << std::endl;
+        return false;
     }
 
-    constexpr std::uint32_t kTestComId = 0x12345U;
-    auto telegram = loopbackTelegram(kTestComId);
+    // Send counts are sampled every 100 ms, so let one sample pass before taking the paused figures.
+    session->setPaused(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    const auto pausedCount = ungrouped.publishCount();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    if (ungrouped.publishCount() != pausedCount || isGroupLeader(*session, kGroup))
+    {
+        std::cerr << "Paused publishers kept sending" << std::endl;
+        return false;
+    }
 
-    PdEndpointRuntime runtime(telegram, session, session->hostIpString());
+    session->setPaused(false);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const bool groupLeads = isGroupLeader(*session, kGroup);
+    const auto groupedAfter = grouped.publishCount();
+    const auto resumedCount = ungrouped.publishCount();
+    ungrouped.stopPublishing();
+    grouped.stopPublishing();
+    session->close();
+    if (resumedCount <= pausedCount)
+    {
+        std::cerr << "Resumed publisher did not send again" << std::endl;
+        return false;
+    }
+    if (groupLeads || groupedAfter > groupedBefore + 1U)
+    {
+        std::cerr << "Resuming made the simulator lead a group it followed before the pause" << std::endl;
+        return false;
+    }
+    return true;
+}
 
-    std::mutex mutex;
-    std::condition_variable cv;
-    std::uint64_t received{0};
+/** A publisher received by its own session, stopped, restarted and released in one bulk teardown. */
+bool checkPublishAndTeardown()
+{
+    auto wire = std::make_shared<VirtualWire>();
+    auto session = std::make_shared<TrdpSession>(sessionConfig("10.0.0.1", wire));
+    if (!session->open())
+    {
+        std::cerr << "Failed to open virtual TRDP session" << std::endl;
+        return false;
+    }
 
-    session->registerPdSubscriber(kTestComId, [&](const PdMessage &) {
-        std::lock_guard<std::mutex> lock(mutex);
-        ++received;
-        cv.notify_all();
-    });
+    constexpr std::uint32_t kTestComId = 0x12345U;
+    PdEndpointRuntime runtime(selfAddressedTelegram(kTestComId, "10.0.0.1"), session, session->hostIpString());
 
-    std::cout << "Starting publisher" << std::endl;
-    runtime.startPublishing(std::chrono::milliseconds(20));
+    std::uint64_t received{0};
+    session->registerPdSubscriber(kTestComId, [&received](const PdMessage &) { ++received; });
 
+    runtime.startPublishing(std::chrono::milliseconds(20));
+    wire->advance(std::chrono::milliseconds(100));
+    if (received != 5U)
+    {
+        std::cerr << "Expected 5 telegrams in 100 ms at a 20 ms cycle, got " << received << std::endl;
+        return false;
+    }
+    if (runtime.publishCount() != 5U || !runtime.lastPublishTime().has_value())
     {
-        std::unique_lock<std::mutex> lock(mutex);
-        cv.wait_for(lock, std::chrono::milliseconds(500), [&] { return received >= 3U; });
+        std::cerr << "Publisher counted " << runtime.publishCount() << " sends, expected 5" << std::endl;
+        return false;
     }
 
-    std::cout << "Stopping publisher" << std::endl;
     runtime.stopPublishing();
+    wire->advance(std::chrono::milliseconds(100));
+    if (received != 5U || runtime.publishCount() != 5U)
+    {
+        std::cerr << "Stopped publisher kept sending" << std::endl;
+        return false;
+    }
 
-    std::cout << "Closing session" << std::endl;
+    runtime.startPublishing(std::chrono::milliseconds(20));
+    const auto report = session->releaseAll(std::chrono::steady_clock::now() + std::chrono::milliseconds(500));
+    runtime.detachPublisher();
+    if (!report.complete() || report.unpublished != 1U || report.unsubscribed != 1U)
+    {
+        std::cerr << "Bulk teardown should release one publisher and one subscription" << std::endl;
+        return false;
+    }
+    wire->advance(std::chrono::milliseconds(100));
     session->close();
-    std::cout << "Session closed" << std::endl;
 
-    if (!runtime.lastPublishTime().has_value())
+    if (received != 5U || wire->stats().framesSent != 5U)
     {
-        std::cerr << "Publisher did not record a publish timestamp" << std::endl;
-        return 1;
+        std::cerr << "Released publisher kept sending" << std::endl;
+        return false;
+    }
+    if (runtime.lastPublishTime().has_value() || runtime.publishCount() != 0U)
+    {
+        std::cerr << "A restart released before its first cycle should count no sends" << std::endl;
+        return false;
     }
+    return true;
+}
+} // namespace
 
-    if (runtime.publishCount() == 0)
+int main()
+{
+    if (!checkPublishDestinations() || !checkLoopbackSession() || !checkStackPause() ||
+        !checkPublishAndTeardown())
     {
-        std::cerr << "Publisher did not send any payloads" << std::endl;
         return 1;
     }
-
     return 0;
 }
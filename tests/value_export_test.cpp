@@ -0,0 +1,154 @@
+#include "config/dataset_codec.h"
+#include "record/value_export.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using trdp::config::DatasetScalar;
+using trdp::model::Dataset;
+using trdp::model::SimulatorConfig;
+using trdp::record::ValueExporter;
+using trdp::record::ValueExportOptions;
+
+namespace
+{
+constexpr std::int64_t kStartNs = 1760781600LL * 1000000000LL;
+
+SimulatorConfig makeConfig()
+{
+    SimulatorConfig config{};
+    config.datasets.push_back(
+        Dataset{3001, "status", {{"counter", "UINT32", 1}, {"speed", "REAL32", 2}, {"temp", "INT16", 1}}});
+    config.datasets.push_back(Dataset{3002, "variable", {{"len", "UINT16", 1}, {"data", "UINT8", 0}}});
+    trdp::model::InterfaceConfig iface{};
+    iface.name = "eth0";
+    trdp::model::TelegramConfig status{};
+    status.comId = 100U;
+    status.datasetId = 3001U;
+    trdp::model::TelegramConfig variable{};
+    variable.comId = 200U;
+    variable.datasetId = 3002U;
+    iface.telegrams = {status, variable};
+    config.interfaces.push_back(iface);
+    return config;
+}
+
+std::string readFile(const std::filesystem::path &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+/** Exports 50 rows of ComID 100 in row groups of 16, plus one payload of the wrong size. */
+bool exportRows(const SimulatorConfig &config, ValueExportOptions options)
+{
+    ValueExporter exporter;
+    std::string error;
+    options.rowGroupRows = 16U;
+    if (!exporter.open(config, options, error) || exporter.tableCount() != 1U || exporter.skipped().size() != 1U)
+    {
+        std::cerr << "Expected one table and the variable-length dataset skipped " << error << std::endl;
+        return false;
+    }
+
+    const auto layout = trdp::config::flattenDataset(config, 3001U);
+    std::vector<std::uint8_t> payload(layout->wireSize);
+    for (int row = 0; row < 50; ++row)
+    {
+        const std::vector<DatasetScalar> values{{row, 0.0}, {0, row * 0.5}, {0, -1.25}, {-row, 0.0}};
+        trdp::config::marshalDataset(*layout, values, payload.data(), payload.size());
+        exporter.append(100U, kStartNs + row * 10000000LL, payload.data(), payload.size());
+    }
+    exporter.append(100U, kStartNs, payload.data(), payload.size() - 1U);
+    exporter.append(999U, kStartNs, payload.data(), payload.size());
+    exporter.close();
+
+    const auto stats = exporter.stats();
+    if (stats.rows != 50U || stats.rowGroups != 4U || stats.mismatched != 1U || stats.writeFailed)
+    {
+        std::cerr << "Export stats: " << stats.summary() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkCsv(const SimulatorConfig &config, const std::filesystem::path &directory)
+{
+    ValueExportOptions options;
+    options.directory = directory.string();
+    if (!exportRows(config, options))
+    {
+        return false;
+    }
+
+    std::istringstream csv(readFile(directory / "comid_100.csv"));
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(csv, line);)
+    {
+        lines.push_back(line);
+    }
+    if (lines.size() != 51U || lines[0] != "time,counter,speed[0],speed[1],temp" ||
+        lines[4] != "2025-10-18T10:00:00.030000Z,3,1.5,-1.25,-3")
+    {
+        std::cerr << "Unexpected CSV export:\n" << (lines.size() > 4U ? lines[0] + "\n" + lines[4] : "") << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool checkNpy(const SimulatorConfig &config, const std::filesystem::path &directory)
+{
+    ValueExportOptions options;
+    options.directory = directory.string();
+    options.format = trdp::model::ExportFormat::Npy;
+    if (!exportRows(config, options))
+    {
+        return false;
+    }
+
+    const auto table = directory / "comid_100";
+    const auto counter = readFile(table / "counter.npy");
+    const auto speed = readFile(table / "speed[1].npy");
+    const auto times = readFile(table / "time_ns.npy");
+    const auto headerOf = [](const std::string &file) { return file.substr(0U, std::min<std::size_t>(128U, file.size())); };
+    if (counter.size() != 128U + 50U * 4U || speed.size() != 128U + 50U * 4U || times.size() != 128U + 50U * 8U ||
+        counter.compare(0U, 6U, "\x93NUMPY") != 0 || headerOf(counter).find("'descr': '<u4'") == std::string::npos ||
+        headerOf(counter).find("'shape': (50,)") == std::string::npos || headerOf(counter).back() != '\n' ||
+        headerOf(speed).find("'descr': '<f4'") == std::string::npos)
+    {
+        std::cerr << "Unexpected NumPy column files:\n" << headerOf(counter) << std::endl;
+        return false;
+    }
+
+    std::uint32_t row7 = 0U;
+    float speed7 = 0.0F;
+    std::int64_t time7 = 0;
+    std::memcpy(&row7, counter.data() + 128U + 7U * 4U, sizeof(row7));
+    std::memcpy(&speed7, speed.data() + 128U + 7U * 4U, sizeof(speed7));
+    std::memcpy(&time7, times.data() + 128U + 7U * 8U, sizeof(time7));
+    if (row7 != 7U || speed7 != -1.25F || time7 != kStartNs + 70000000LL)
+    {
+        std::cerr << "Row 7 was not exported as written" << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    const auto config = makeConfig();
+    const auto directory =
+        std::filesystem::temp_directory_path() / ("value_export_test_" + std::to_string(::getpid()));
+    const bool ok = checkCsv(config, directory / "csv") && checkNpy(config, directory / "npy");
+    std::filesystem::remove_all(directory);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,350 @@
+#include "trdp/interface_bringup.h"
+#include "trdp/pd_endpoint.h"
+#include "trdp/trdp_session.h"
+#include "trdp/virtual_wire.h"
+
+#include <vos_sock.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+using trdp::model::InterfaceConfig;
+using trdp::model::PdParameters;
+using trdp::model::TelegramConfig;
+using trdp::model::TelegramEndpoint;
+using trdp::runtime::InterfaceBringUp;
+using trdp::runtime::PdEndpointRuntime;
+using trdp::runtime::PdLinkEvent;
+using trdp::runtime::PdMessage;
+using trdp::runtime::PdPublication;
+using trdp::runtime::PdRegistrationBatch;
+using trdp::runtime::PdSubscriber;
+using trdp::runtime::PdTimeoutEvent;
+using trdp::runtime::TrdpSession;
+using trdp::runtime::TrdpSessionConfig;
+using trdp::runtime::VirtualWire;
+
+namespace
+{
+std::shared_ptr<TrdpSession> openVirtualSession(const std::shared_ptr<VirtualWire> &wire, const char *hostIp)
+{
+    TrdpSessionConfig config{};
+    config.hostIp = hostIp;
+    config.leaderIp = hostIp;
+    config.virtualWire = wire;
+    auto session = std::make_shared<TrdpSession>(config);
+    return session->open() ? session : nullptr;
+}
+
+PdSubscriber makeSubscriber(std::uint32_t comId, std::uint32_t timeoutUs, std::uint64_t &received)
+{
+    PdSubscriber subscriber{};
+    subscriber.comId = comId;
+    subscriber.timeoutUs = timeoutUs;
+    subscriber.callback = [&received](const PdMessage &) { ++received; };
+    return subscriber;
+}
+
+/** An endpoint publishing every 10 ms, a peer receiving it, and a receive timeout provoked on the wire. */
+bool checkUnicastAndTimeouts()
+{
+    auto wire = std::make_shared<VirtualWire>();
+    const auto start = wire->now();
+    auto source = openVirtualSession(wire, "10.0.0.1");
+    TrdpSessionConfig sinkConfig{};
+    sinkConfig.hostIp = "10.0.0.2";
+    sinkConfig.leaderIp = "10.0.0.2";
+    sinkConfig.virtualWire = wire;
+    auto sink = std::make_shared<TrdpSession>(sinkConfig);
+    std::vector<PdTimeoutEvent> events;
+    sink->setPdTimeoutListener([&events](const PdTimeoutEvent &event) { events.push_back(event); });
+    if (source == nullptr || !sink->open())
+    {
+        std::cerr << "Failed to open virtual sessions" << std::endl;
+        return false;
+    }
+
+    TelegramConfig telegram{};
+    telegram.comId = 100U;
+    telegram.sources.push_back(TelegramEndpoint{0U, "", "10.0.0.1"});
+    telegram.destinations.push_back(TelegramEndpoint{0U, "", "10.0.0.2"});
+    PdEndpointRuntime endpoint(telegram, source, source->hostIpString());
+    endpoint.setTxPayload({1, 2, 3, 4});
+    endpoint.startPublishing(std::chrono::milliseconds(10));
+
+    std::uint64_t received = 0U;
+    std::vector<std::uint8_t> lastPayload;
+    PdRegistrationBatch batch{};
+    batch.subscribers.push_back(makeSubscriber(100U, 50000U, received));
+    batch.subscribers.back().callback = [&](const PdMessage &message) {
+        ++received;
+        lastPayload = message.payload;
+    };
+    sink->registerBatch(std::move(batch));
+
+    wire->advance(std::chrono::seconds(1));
+    if (received != 100U || lastPayload != std::vector<std::uint8_t>{1, 2, 3, 4})
+    {
+        std::cerr << "Expected 100 telegrams in one simulated second, got " << received << std::endl;
+        return false;
+    }
+
+    // The last telegram arrived at 1000 ms, so the 50 ms receive timeout expires at exactly 1050 ms.
+    wire->setReachable(source->hostAddress(), false);
+    wire->advance(std::chrono::milliseconds(200));
+    if (events.size() != 1U || events.front().event != PdLinkEvent::Lost ||
+        events.front().at - start != std::chrono::milliseconds(1050) || !sink->isPdLost(100U))
+    {
+        std::cerr << "Receive timeout was not reported at 1050 ms of simulated time" << std::endl;
+        return false;
+    }
+
+    wire->setReachable(source->hostAddress(), true);
+    wire->advance(std::chrono::milliseconds(10));
+    if (events.size() != 2U || events.back().event != PdLinkEvent::Recovered ||
+        events.back().at - start != std::chrono::milliseconds(1210) || sink->isPdLost(100U))
+    {
+        std::cerr << "Recovery was not reported with the first telegram after the outage" << std::endl;
+        return false;
+    }
+
+    endpoint.stopPublishing();
+    const auto sent = wire->stats().framesSent;
+    wire->advance(std::chrono::seconds(1));
+    if (wire->stats().framesSent != sent)
+    {
+        std::cerr << "Stopped publisher kept sending" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/** One multicast publication reaches every session subscribed to the group. */
+bool checkMulticast()
+{
+    auto wire = std::make_shared<VirtualWire>();
+    auto source = openVirtualSession(wire, "10.0.0.1");
+    auto first = openVirtualSession(wire, "10.0.0.2");
+    auto second = openVirtualSession(wire, "10.0.0.3");
+    if (source == nullptr || first == nullptr || second == nullptr)
+    {
+        return false;
+    }
+
+    const auto group = vos_dottedIP("239.1.1.1");
+    std::uint64_t firstReceived = 0U;
+    std::uint64_t secondReceived = 0U;
+    for (const auto &[session, counter] : {std::make_pair(first, &firstReceived), std::make_pair(second, &secondReceived)})
+    {
+        PdRegistrationBatch batch{};
+        batch.subscribers.push_back(makeSubscriber(200U, 0U, *counter));
+        batch.subscribers.back().destIp = group;
+        session->registerBatch(std::move(batch));
+    }
+
+    PdPublication publication{};
+    publication.comId = 200U;
+    publication.destIp = group;
+    publication.intervalUs = 100000U;
+    publication.payload = std::make_shared<const std::vector<std::uint8_t>>(16U, 0xAAU);
+    if (source->publishPd(publication) == nullptr)
+    {
+        std::cerr << "Virtual publish failed" << std::endl;
+        return false;
+    }
+
+    wire->advance(std::chrono::seconds(10));
+    second->close();
+    wire->advance(std::chrono::seconds(10));
+    if (firstReceived != 200U || secondReceived != 100U)
+    {
+        std::cerr << "Multicast delivery mismatch: " << firstReceived << " and " << secondReceived << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/** 500 telegrams at 100 ms for ten simulated minutes, with receive supervision on every one. */
+bool checkScale()
+{
+    constexpr std::uint32_t kTelegrams = 500U;
+    auto wire = std::make_shared<VirtualWire>();
+    auto source = openVirtualSession(wire, "10.0.0.1");
+    auto sink = openVirtualSession(wire, "10.0.0.2");
+    if (source == nullptr || sink == nullptr)
+    {
+        return false;
+    }
+
+    std::uint64_t received = 0U;
+    PdRegistrationBatch subscriptions{};
+    PdRegistrationBatch publications{};
+    const auto payload = std::make_shared<const std::vector<std::uint8_t>>(64U, 0x55U);
+    for (std::uint32_t i = 0; i < kTelegrams; ++i)
+    {
+        subscriptions.subscribers.push_back(makeSubscriber(1000U + i, 300000U, received));
+        PdPublication publication{};
+        publication.comId = 1000U + i;
+        publication.destIp = sink->hostAddress();
+        publication.intervalUs = 100000U;
+        publication.payload = payload;
+        publications.publications.push_back(publication);
+    }
+    sink->registerBatch(std::move(subscriptions));
+    source->registerBatch(std::move(publications));
+
+    const auto started = std::chrono::steady_clock::now();
+    wire->advance(std::chrono::minutes(10));
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+    const auto supervision = sink->pdSupervisionStats();
+    std::cout << "Dispatched " << received << " telegrams (10 simulated minutes) in " << elapsed.count() << " s, "
+              << static_cast<std::uint64_t>(received / elapsed.count()) << " telegrams/s" << std::endl;
+    if (received != kTelegrams * 6000U || supervision.watched != kTelegrams || supervision.lostEvents != 0U)
+    {
+        std::cerr << "Scale scenario mismatch: " << received << " received, " << supervision.lostEvents
+                  << " timeouts" << std::endl;
+        return false;
+    }
+    return true;
+}
+/** Pausing 2,000 publishers and subscriptions keeps every handle; resuming takes effect the next cycle. */
+bool checkPause()
+{
+    constexpr std::uint32_t kTelegrams = 2000U;
+    auto wire = std::make_shared<VirtualWire>();
+    auto source = openVirtualSession(wire, "10.0.0.1");
+    auto sink = openVirtualSession(wire, "10.0.0.2");
+    if (source == nullptr || sink == nullptr)
+    {
+        return false;
+    }
+
+    std::uint64_t received = 0U;
+    PdRegistrationBatch subscriptions{};
+    PdRegistrationBatch publications{};
+    const auto payload = std::make_shared<const std::vector<std::uint8_t>>(32U, 0xAAU);
+    for (std::uint32_t i = 0; i < kTelegrams; ++i)
+    {
+        subscriptions.subscribers.push_back(makeSubscriber(5000U + i, 300000U, received));
+        PdPublication publication{};
+        publication.comId = 5000U + i;
+        publication.destIp = sink->hostAddress();
+        publication.intervalUs = 100000U;
+        publication.payload = payload;
+        publications.publications.push_back(publication);
+    }
+    sink->registerBatch(std::move(subscriptions));
+    source->registerBatch(std::move(publications));
+    wire->advance(std::chrono::seconds(1));
+
+    const auto started = std::chrono::steady_clock::now();
+    source->setPaused(true);
+    const auto pausing = std::chrono::steady_clock::now() - started;
+    wire->advance(std::chrono::seconds(1));
+    const auto silent = wire->stats();
+    if (received != kTelegrams * 10U || silent.suppressed != kTelegrams * 10U || !source->isPaused() ||
+        sink->pdSupervisionStats().lostEvents != kTelegrams || pausing > std::chrono::milliseconds(100))
+    {
+        std::cerr << "Paused publishers kept sending: " << received << " received, " << silent.suppressed
+                  << " suppressed" << std::endl;
+        return false;
+    }
+
+    source->setPaused(false);
+    wire->advance(std::chrono::milliseconds(100));
+    if (received != kTelegrams * 11U || sink->pdSupervisionStats().recoveredEvents != kTelegrams)
+    {
+        std::cerr << "Resumed publishers did not send in the next cycle" << std::endl;
+        return false;
+    }
+
+    // A paused receiver drops what arrives but keeps its links supervised.
+    sink->setPaused(true);
+    wire->advance(std::chrono::seconds(1));
+    if (received != kTelegrams * 11U || wire->stats().deliveries != silent.deliveries + kTelegrams * 11U ||
+        sink->pdSupervisionStats().lostEvents != kTelegrams)
+    {
+        std::cerr << "A paused subscription dispatched telegrams or lost its link" << std::endl;
+        return false;
+    }
+    sink->setPaused(false);
+    wire->advance(std::chrono::milliseconds(100));
+    if (received != kTelegrams * 12U)
+    {
+        std::cerr << "The resumed subscriptions did not dispatch" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/** An interface brought up as the simulator does it: only the telegram it receives is supervised. */
+bool checkOutgoingNotSupervised()
+{
+    auto wire = std::make_shared<VirtualWire>();
+    InterfaceConfig iface{};
+    iface.name = "eth0";
+    iface.hostIp = "10.0.0.1";
+    iface.leaderIp = "10.0.0.1";
+    for (const auto &[comId, source, destination] :
+         {std::make_tuple(200U, "10.0.0.1", "10.0.0.2"), std::make_tuple(201U, "10.0.0.2", "10.0.0.1")})
+    {
+        TelegramConfig telegram{};
+        telegram.comId = comId;
+        telegram.sources.push_back(TelegramEndpoint{0U, "", source});
+        telegram.destinations.push_back(TelegramEndpoint{0U, "", destination});
+        telegram.pd = PdParameters{};
+        telegram.pd->cycleUs = 10000U;
+        telegram.pd->timeoutUs = 50000U;
+        iface.telegrams.push_back(telegram);
+    }
+
+    TrdpSessionConfig config{};
+    config.hostIp = iface.hostIp;
+    config.leaderIp = iface.leaderIp;
+    config.virtualWire = wire;
+    InterfaceBringUp bringUp{};
+    bringUp.iface = &iface;
+    bringUp.session = std::make_shared<TrdpSession>(config);
+    for (const auto &telegram : iface.telegrams)
+    {
+        bringUp.endpoints.push_back(std::make_shared<PdEndpointRuntime>(telegram, bringUp.session, iface.hostIp));
+    }
+    std::vector<PdTimeoutEvent> events;
+    trdp::runtime::routeLinkEvents(bringUp, [&events](const PdTimeoutEvent &event) { events.push_back(event); });
+    trdp::runtime::openAndRegister(bringUp);
+
+    // The outgoing telegram auto-starts and loops back to nobody; the incoming one never arrives.
+    wire->advance(std::chrono::milliseconds(500));
+    const auto &outgoing = *bringUp.endpoints[0];
+    const auto &incoming = *bringUp.endpoints[1];
+    if (!outgoing.isPublishing() || outgoing.isLinkLost() || outgoing.linkLostCount() != 0U)
+    {
+        std::cerr << "An outgoing telegram was reported lost" << std::endl;
+        return false;
+    }
+    if (events.size() != 1U || events.front().comId != 201U || events.front().event != PdLinkEvent::Lost ||
+        !incoming.isLinkLost())
+    {
+        std::cerr << "Expected exactly one Lost event, for the incoming telegram; got " << events.size() << std::endl;
+        return false;
+    }
+    bringUp.session->close();
+    // The listener holds the endpoints, which hold the session.
+    bringUp.session->setPdTimeoutListener({});
+    return true;
+}
+} // namespace
+
+int main()
+{
+    if (!checkUnicastAndTimeouts() || !checkMulticast() || !checkScale() || !checkPause() ||
+        !checkOutgoingNotSupervised())
+    {
+        return 1;
+    }
+    return 0;
+}
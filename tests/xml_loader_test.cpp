@@ -1,10 +1,13 @@
+#include "config/dataset_layout.h"
 #include "config/xml_loader.h"
 
+#include <algorithm>
 #include <cassert>
 #include <filesystem>
 #include <iostream>
 #include <optional>
 
+using trdp::config::datasetWireSize;
 using trdp::config::loadSimulatorConfigFromXml;
 using trdp::model::Dataset;
 using trdp::model::InterfaceConfig;
@@ -41,10 +44,39 @@ std::optional<InterfaceConfig> findInterface(const SimulatorConfig &config, cons
     }
     return std::nullopt;
 }
+
+bool checkDatasetWireSizes()
+{
+    SimulatorConfig config{};
+    config.datasets.push_back(Dataset{2000, "inner", {{"flag", "BITSET8", 1}, {"time", "TIMEDATE48", 1}}});
+    config.datasets.push_back(Dataset{2001, "outer", {{"count", "UINT16", 1}, {"items", "DATASET 2000", 3}, {"text", "CHAR8", 16}}});
+    config.datasets.push_back(Dataset{2002, "variable", {{"len", "UINT16", 1}, {"data", "UINT8", 0}}});
+    config.datasets.push_back(Dataset{2003, "recursive", {{"self", "DATASET 2003", 1}}});
+    config.datasets.push_back(Dataset{2004, "unknown", {{"raw", "42", 1}}});
+
+    const auto outer = datasetWireSize(config, 2001);
+    if (!outer.has_value() || *outer != 2U + 3U * (1U + 6U) + 16U)
+    {
+        std::cerr << "Nested dataset 2001 should marshal to 39 bytes" << std::endl;
+        return false;
+    }
+    if (datasetWireSize(config, 2002).has_value() || datasetWireSize(config, 2003).has_value() ||
+        datasetWireSize(config, 2004).has_value() || datasetWireSize(config, 9999).has_value())
+    {
+        std::cerr << "Variable, recursive, untyped and missing datasets have no fixed size" << std::endl;
+        return false;
+    }
+    return true;
+}
 } // namespace
 
 int main()
 {
+    if (!checkDatasetWireSizes())
+    {
+        return 1;
+    }
+
     const auto xmlPath = exampleXmlPath();
     const auto result = loadSimulatorConfigFromXml(xmlPath.string());
 
@@ -85,5 +117,14 @@ int main()
         return 1;
     }
 
+    const auto hasPdCycle = std::any_of(iface->telegrams.begin(), iface->telegrams.end(), [](const auto &telegram) {
+        return telegram.pd.has_value() && telegram.pd->cycleUs != 0U;
+    });
+    if (!hasPdCycle)
+    {
+        std::cerr << "Interface eth0 should carry PD cycle times from <pd-parameter>" << std::endl;
+        return 1;
+    }
+
     return 0;
 }
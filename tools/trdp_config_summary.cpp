@@ -0,0 +1,276 @@
+// Summarizes an XML configuration as JSON, as the simulator itself loads it.
+//
+//   trdp_config_summary CONFIG.xml
+//
+// Prints {"device":{...},"interfaces":[...],"datasets":[...],"errors":[...]} on stdout; the backend serves it for
+// GET /api/configs/:id/summary. A configuration with errors is still summarized as far as it loaded.
+// Exit status: 0 on success, 1 when the configuration has errors, 2 on usage or output errors.
+
+#include "config/dataset_layout.h"
+#include "config/xml_loader.h"
+#include "trdp/pd_endpoint.h"
+#include "util/json.h"
+
+#include <trdp_xml.h>
+#include <vos_utils.h>
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " CONFIG.xml\n";
+}
+
+const char *directionName(trdp::runtime::PdDirection direction)
+{
+    switch (direction)
+    {
+    case trdp::runtime::PdDirection::Outgoing:
+        return "out";
+    case trdp::runtime::PdDirection::Incoming:
+        return "in";
+    case trdp::runtime::PdDirection::Loopback:
+        return "loopback";
+    case trdp::runtime::PdDirection::Unknown:
+        break;
+    }
+    return "unknown";
+}
+
+/**
+ * Attributes TAU parses but does not hand out: the device's host name and type and the telegram
+ * names. Read with the stack's own XML reader, the one behind tau_prepareXmlDoc().
+ */
+class XmlNames
+{
+public:
+    explicit XmlNames(const char *path)
+    {
+        XML_HANDLE_T xml{};
+        if (trdp_XMLOpen(&xml, path) != TRDP_NO_ERR)
+        {
+            return;
+        }
+        trdp_XMLRewind(&xml);
+        trdp_XMLEnter(&xml);
+        if (trdp_XMLSeekStartTag(&xml, "device") == 0)
+        {
+            readAttributes(xml, [this](const CHAR8 *attribute, UINT32, const CHAR8 *value) {
+                if (vos_strnicmp(attribute, "host-name", MAX_TOK_LEN) == 0)
+                {
+                    hostName_ = value;
+                }
+                else if (vos_strnicmp(attribute, "type", MAX_TOK_LEN) == 0)
+                {
+                    type_ = value;
+                }
+            });
+            trdp_XMLEnter(&xml);
+            if (trdp_XMLSeekStartTag(&xml, "bus-interface-list") == 0)
+            {
+                trdp_XMLEnter(&xml);
+                while (trdp_XMLSeekStartTag(&xml, "bus-interface") == 0)
+                {
+                    readInterface(xml);
+                }
+                trdp_XMLLeave(&xml);
+            }
+            trdp_XMLLeave(&xml);
+        }
+        trdp_XMLClose(&xml);
+    }
+
+    [[nodiscard]] const std::string &hostName() const { return hostName_; }
+    [[nodiscard]] const std::string &type() const { return type_; }
+
+    /** Name of the next telegram of `iface` with `comId`, in file order; empty if it has none. */
+    std::string take(const std::string &iface, std::uint32_t comId)
+    {
+        const auto it = telegrams_.find(iface);
+        if (it == telegrams_.end())
+        {
+            return {};
+        }
+        for (auto &telegram : it->second)
+        {
+            if (!telegram.taken && telegram.comId == comId)
+            {
+                telegram.taken = true;
+                return telegram.name;
+            }
+        }
+        return {};
+    }
+
+private:
+    struct Telegram
+    {
+        std::uint32_t comId{0};
+        std::string name;
+        bool taken{false};
+    };
+
+    template <typename Fn>
+    static void readAttributes(XML_HANDLE_T &xml, Fn &&fn)
+    {
+        CHAR8 attribute[MAX_TOK_LEN]{};
+        CHAR8 value[MAX_TOK_LEN]{};
+        UINT32 valueInt = 0U;
+        while (trdp_XMLGetAttribute(&xml, attribute, &valueInt, value) == TOK_ATTRIBUTE)
+        {
+            fn(attribute, valueInt, value);
+        }
+    }
+
+    void readInterface(XML_HANDLE_T &xml)
+    {
+        std::string ifName;
+        readAttributes(xml, [&ifName](const CHAR8 *attribute, UINT32, const CHAR8 *value) {
+            if (vos_strnicmp(attribute, "name", MAX_TOK_LEN) == 0)
+            {
+                ifName = value;
+            }
+        });
+        auto &telegrams = telegrams_[ifName];
+        trdp_XMLEnter(&xml);
+        while (trdp_XMLSeekStartTag(&xml, "telegram") == 0)
+        {
+            Telegram telegram;
+            readAttributes(xml, [&telegram](const CHAR8 *attribute, UINT32 valueInt, const CHAR8 *value) {
+                if (vos_strnicmp(attribute, "com-id", MAX_TOK_LEN) == 0)
+                {
+                    telegram.comId = valueInt;
+                }
+                else if (vos_strnicmp(attribute, "name", MAX_TOK_LEN) == 0)
+                {
+                    telegram.name = value;
+                }
+            });
+            telegrams.push_back(std::move(telegram));
+        }
+        trdp_XMLLeave(&xml);
+    }
+
+    std::string hostName_;
+    std::string type_;
+    /** Per interface name, in file order. */
+    std::unordered_map<std::string, std::vector<Telegram>> telegrams_;
+};
+
+void appendTelegram(std::string &out, const trdp::model::InterfaceConfig &iface,
+                    const trdp::model::TelegramConfig &telegram, XmlNames &names)
+{
+    out += "{\"name\":";
+    trdp::util::appendJsonString(out, names.take(iface.name, telegram.comId));
+    out += ",\"comId\":" + std::to_string(telegram.comId);
+    out += ",\"datasetId\":" + std::to_string(telegram.datasetId);
+    out += ",\"exchangeType\":";
+    trdp::util::appendJsonString(out, telegram.exchangeType);
+    out += ",\"direction\":\"";
+    out += directionName(trdp::runtime::PdEndpointRuntime::classifyDirection(iface.hostIp, telegram));
+    out += "\",\"sources\":" + std::to_string(telegram.sources.size());
+    out += ",\"destinations\":" + std::to_string(telegram.destinations.size());
+    if (telegram.pd.has_value())
+    {
+        out += ",\"cycle\":" + std::to_string(telegram.pd->cycleUs);
+        out += ",\"timeout\":" + std::to_string(telegram.pd->timeoutUs);
+    }
+    out += '}';
+}
+
+void appendTelegrams(std::string &out, const trdp::model::InterfaceConfig &iface, bool pd, XmlNames &names)
+{
+    out += '[';
+    bool first = true;
+    for (const auto &telegram : iface.telegrams)
+    {
+        if (telegram.pd.has_value() != pd)
+        {
+            continue;
+        }
+        if (!first)
+        {
+            out += ',';
+        }
+        first = false;
+        appendTelegram(out, iface, telegram, names);
+    }
+    out += ']';
+}
+
+std::string summarize(const trdp::config::SimulatorConfigLoadResult &loaded, XmlNames &names)
+{
+    const auto &config = loaded.config;
+    std::string out;
+    out += "{\"device\":{\"hostName\":";
+    trdp::util::appendJsonString(out, names.hostName());
+    out += ",\"type\":";
+    trdp::util::appendJsonString(out, names.type());
+    out += ",\"memorySize\":" + std::to_string(config.memory.size) + '}';
+
+    out += ",\"interfaces\":[";
+    for (std::size_t i = 0; i < config.interfaces.size(); ++i)
+    {
+        const auto &iface = config.interfaces[i];
+        out += i == 0U ? "{\"name\":" : ",{\"name\":";
+        trdp::util::appendJsonString(out, iface.name);
+        out += ",\"networkId\":" + std::to_string(iface.networkId);
+        out += ",\"hostIp\":";
+        trdp::util::appendJsonString(out, iface.hostIp);
+        out += ",\"leaderIp\":";
+        trdp::util::appendJsonString(out, iface.leaderIp);
+        out += ",\"pdTelegrams\":";
+        appendTelegrams(out, iface, true, names);
+        out += ",\"mdTelegrams\":";
+        appendTelegrams(out, iface, false, names);
+        out += '}';
+    }
+
+    out += "],\"datasets\":[";
+    for (std::size_t i = 0; i < config.datasets.size(); ++i)
+    {
+        const auto &dataset = config.datasets[i];
+        out += i == 0U ? "{\"id\":" : ",{\"id\":";
+        out += std::to_string(dataset.id) + ",\"name\":";
+        trdp::util::appendJsonString(out, dataset.name);
+        out += ",\"elementCount\":" + std::to_string(dataset.elements.size());
+        // null for variable-length datasets and those that do not resolve.
+        const auto wireSize = trdp::config::datasetWireSize(config, dataset.id);
+        out += ",\"wireSize\":" + (wireSize.has_value() ? std::to_string(*wireSize) : std::string("null"));
+        out += '}';
+    }
+
+    out += "],\"errors\":[";
+    for (std::size_t i = 0; i < loaded.errors.size(); ++i)
+    {
+        if (i != 0U)
+        {
+            out += ',';
+        }
+        trdp::util::appendJsonString(out, loaded.errors[i]);
+    }
+    out += "]}\n";
+    return out;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc != 2 || argv[1][0] == '-')
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    const auto loaded = trdp::config::loadSimulatorConfigFromXml(argv[1]);
+    XmlNames names(argv[1]);
+    std::cout << summarize(loaded, names);
+    std::cout.flush();
+    return !std::cout ? 2 : loaded.hasErrors() ? 1 : 0;
+}
@@ -0,0 +1,293 @@
+// Offline and live validation of TRDP PD traffic against an XML configuration.
+//
+//   trdp_decode [--config FILE] [--threads N] [--port N] [--strict] CAPTURE.pcap
+//   trdp_decode [--config FILE] [--port N] [--strict] [--duration S] --live IFACE
+//
+// Exit status: 0 when every PD frame was valid, 1 when issues were found, 2 on usage or I/O errors.
+
+#include "config/xml_loader.h"
+#include "decode/capture_decoder.h"
+#include "decode/live_capture.h"
+#include "util/crc32.h"
+
+#include <arpa/inet.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace
+{
+std::atomic<bool> stopRequested{false};
+
+struct Arguments
+{
+    std::string configPath;
+    std::string capturePath;
+    std::string liveInterface;
+    trdp::decode::DecodeOptions options{};
+    bool strict{false};
+    double durationSeconds{0.0};
+};
+
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program
+              << " [--config FILE] [--threads N] [--port N] [--strict] [--duration S] (CAPTURE.pcap | --live IFACE)\n"
+                 "  --config FILE  check dataset sizes against the XML configuration\n"
+                 "  --threads N    decoder threads for capture files (default: all CPUs)\n"
+                 "  --port N       PD UDP port (default 17224)\n"
+                 "  --strict       report comIds the configuration does not define\n"
+                 "  --live IFACE   validate traffic on an interface (needs CAP_NET_RAW)\n"
+                 "  --duration S   stop live validation after S seconds (default: until Ctrl+C)\n";
+}
+
+bool parseNumber(const char *text, unsigned long max, unsigned long &out)
+{
+    char *end = nullptr;
+    errno = 0;
+    out = std::strtoul(text, &end, 10);
+    return errno == 0 && end != text && *end == '\0' && out <= max;
+}
+
+bool parseArguments(int argc, char **argv, Arguments &arguments)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool takesValue =
+            arg == "--config" || arg == "--threads" || arg == "--port" || arg == "--live" || arg == "--duration";
+        if (takesValue && i + 1 >= argc)
+        {
+            std::cerr << arg << " needs a value\n";
+            return false;
+        }
+
+        unsigned long number = 0U;
+        if (arg == "--config")
+        {
+            arguments.configPath = argv[++i];
+        }
+        else if (arg == "--live")
+        {
+            arguments.liveInterface = argv[++i];
+        }
+        else if (arg == "--threads")
+        {
+            if (!parseNumber(argv[++i], 1024U, number))
+            {
+                std::cerr << "Invalid thread count " << argv[i] << '\n';
+                return false;
+            }
+            arguments.options.threads = static_cast<unsigned>(number);
+        }
+        else if (arg == "--port")
+        {
+            if (!parseNumber(argv[++i], 65535U, number) || number == 0U)
+            {
+                std::cerr << "Invalid port " << argv[i] << '\n';
+                return false;
+            }
+            arguments.options.port = static_cast<std::uint16_t>(number);
+        }
+        else if (arg == "--duration")
+        {
+            char *end = nullptr;
+            arguments.durationSeconds = std::strtod(argv[++i], &end);
+            if (end == argv[i] || *end != '\0' || arguments.durationSeconds < 0.0)
+            {
+                std::cerr << "Invalid duration " << argv[i] << '\n';
+                return false;
+            }
+        }
+        else if (arg == "--strict")
+        {
+            arguments.strict = true;
+        }
+        else if (arg == "-h" || arg == "--help")
+        {
+            return false;
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            std::cerr << "Unknown option " << arg << '\n';
+            return false;
+        }
+        else
+        {
+            arguments.capturePath = arg;
+        }
+    }
+    // Exactly one source.
+    return arguments.capturePath.empty() != arguments.liveInterface.empty();
+}
+
+std::string ipToString(std::uint32_t ip)
+{
+    in_addr address{htonl(ip)};
+    char text[INET_ADDRSTRLEN] = {};
+    return ::inet_ntop(AF_INET, &address, text, sizeof(text)) != nullptr ? text : "?";
+}
+
+void printReport(const trdp::decode::DecodeReport &report, double seconds)
+{
+    std::cout << "Packets: " << report.packets << "  PD frames: " << report.pdFrames << "  valid: " << report.validFrames
+              << "  invalid: " << report.invalidFrames() << "  other: " << report.skipped << '\n';
+    if (seconds > 0.0)
+    {
+        std::cout << std::fixed << std::setprecision(1) << "Throughput: " << report.packets / seconds / 1e6
+                  << " Mpkt/s, " << report.bytes / seconds / 1e6 << " MB/s PD payload in " << std::setprecision(3)
+                  << seconds << " s (CRC: " << trdp::util::crc32Backend() << ")\n";
+    }
+
+    if (!report.comIds.empty())
+    {
+        std::cout << '\n'
+                  << std::left << std::setw(12) << "ComID" << std::right << std::setw(12) << "frames" << std::setw(14)
+                  << "bytes" << std::setw(10) << "invalid" << std::setw(8) << "gaps" << std::setw(10) << "missing"
+                  << '\n';
+    }
+    for (const auto &[comId, stats] : report.comIds)
+    {
+        std::uint64_t gaps = 0U;
+        std::uint64_t missing = 0U;
+        for (const auto &[key, flow] : report.flows)
+        {
+            if (key.comId == comId)
+            {
+                gaps += flow.gaps;
+                missing += flow.missing;
+            }
+        }
+        std::cout << std::left << std::setw(12) << comId << std::right << std::setw(12) << stats.frames << std::setw(14)
+                  << stats.bytes << std::setw(10) << stats.invalid << std::setw(8) << gaps << std::setw(10) << missing
+                  << '\n';
+    }
+
+    bool header = false;
+    for (std::size_t i = 0; i < trdp::decode::kPdIssueKinds; ++i)
+    {
+        if (report.issues[i] == 0U)
+        {
+            continue;
+        }
+        if (!header)
+        {
+            std::cout << "\nIssues:\n";
+            header = true;
+        }
+        std::cout << "  " << std::left << std::setw(24) << trdp::decode::pdIssueName(i) << std::right
+                  << report.issues[i] << '\n';
+    }
+
+    for (const auto &[key, flow] : report.flows)
+    {
+        if (flow.gaps != 0U)
+        {
+            std::cout << "  ComID " << key.comId << ' ' << ipToString(key.srcIp) << " -> " << ipToString(key.dstIp)
+                      << ": " << flow.gaps << " gaps, " << flow.missing << " frames missing\n";
+        }
+    }
+}
+
+int runFile(const Arguments &arguments, const trdp::decode::PdExpectations &expectations)
+{
+    trdp::decode::CaptureFile file;
+    std::string error;
+    if (!file.open(arguments.capturePath, error))
+    {
+        std::cerr << error << '\n';
+        return 2;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    const auto report = trdp::decode::decodeCapture(file, expectations, arguments.options);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+    printReport(report, elapsed.count());
+    return report.invalidFrames() == 0U ? 0 : 1;
+}
+
+int runLive(const Arguments &arguments, const trdp::decode::PdExpectations &expectations)
+{
+    trdp::decode::LiveCapture capture(arguments.liveInterface);
+    std::string error;
+    if (!capture.open(error))
+    {
+        std::cerr << error << '\n';
+        return 2;
+    }
+
+    std::signal(SIGINT, [](int) { stopRequested = true; });
+    std::signal(SIGTERM, [](int) { stopRequested = true; });
+
+    trdp::decode::DecodeReport report;
+    trdp::decode::PdValidator validator(expectations, report);
+    const auto handler = [&](const std::uint8_t *frame, std::size_t size) {
+        trdp::decode::decodeFrame(trdp::decode::LiveCapture::linkType(), frame, size, arguments.options.port,
+                                  validator);
+    };
+
+    const auto started = std::chrono::steady_clock::now();
+    auto nextSummary = started + std::chrono::seconds(1);
+    std::uint64_t lastPackets = 0U;
+    while (!stopRequested)
+    {
+        capture.poll(handler, std::chrono::milliseconds(100));
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= nextSummary)
+        {
+            const auto stats = capture.stats();
+            std::cout << "pkts " << report.packets << " (+" << report.packets - lastPackets << "/s)  PD "
+                      << report.pdFrames << "  invalid " << report.invalidFrames() << "  kernel drops "
+                      << stats.kernelDrops << std::endl;
+            lastPackets = report.packets;
+            nextSummary += std::chrono::seconds(1);
+        }
+        if (arguments.durationSeconds > 0.0 &&
+            std::chrono::duration<double>(now - started).count() >= arguments.durationSeconds)
+        {
+            break;
+        }
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+    std::cout << '\n';
+    printReport(report, elapsed.count());
+    std::cout << "Kernel drops: " << capture.stats().kernelDrops << '\n';
+    return report.invalidFrames() == 0U ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Arguments arguments;
+    if (!parseArguments(argc, argv, arguments))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    trdp::decode::PdExpectations expectations{};
+    if (!arguments.configPath.empty())
+    {
+        const auto loaded = trdp::config::loadSimulatorConfigFromXml(arguments.configPath);
+        if (loaded.hasErrors())
+        {
+            for (const auto &error : loaded.errors)
+            {
+                std::cerr << error << '\n';
+            }
+            return 2;
+        }
+        expectations = trdp::decode::PdExpectations::fromConfig(loaded.config);
+    }
+    expectations.strictComIds = arguments.strict;
+
+    return arguments.liveInterface.empty() ? runFile(arguments, expectations) : runLive(arguments, expectations);
+}
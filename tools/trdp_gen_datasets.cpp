@@ -0,0 +1,125 @@
+// Build-time generator of dataset structs and marshalling code from an XML configuration.
+//
+//   trdp_gen_datasets [--namespace NS] -o OUT.h CONFIG.xml
+//
+// Exit status: 0 when the header was written (skipped datasets are only reported), 2 on usage, XML or I/O errors.
+
+#include "config/dataset_codegen.h"
+#include "config/xml_loader.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+struct Arguments
+{
+    std::string configPath;
+    std::string outputPath;
+    std::string nameSpace{"trdp::datasets"};
+};
+
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--namespace NS] -o OUT.h CONFIG.xml\n"
+                 "  --namespace NS  C++ namespace of the generated structs (default trdp::datasets)\n"
+                 "  -o OUT.h        header to write\n";
+}
+
+bool parseArguments(int argc, char **argv, Arguments &arguments)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool takesValue = arg == "--namespace" || arg == "-o";
+        if (takesValue && i + 1 >= argc)
+        {
+            std::cerr << arg << " needs a value\n";
+            return false;
+        }
+
+        if (arg == "--namespace")
+        {
+            arguments.nameSpace = argv[++i];
+        }
+        else if (arg == "-o")
+        {
+            arguments.outputPath = argv[++i];
+        }
+        else if (arg == "-h" || arg == "--help")
+        {
+            return false;
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            std::cerr << "Unknown option " << arg << '\n';
+            return false;
+        }
+        else
+        {
+            arguments.configPath = arg;
+        }
+    }
+    return !arguments.configPath.empty() && !arguments.outputPath.empty();
+}
+
+bool writeHeader(const std::string &path, const std::string &content)
+{
+    const auto parent = std::filesystem::path(path).parent_path();
+    std::error_code error;
+    if (!parent.empty())
+    {
+        std::filesystem::create_directories(parent, error);
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << content;
+    return static_cast<bool>(out.flush());
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Arguments arguments;
+    if (!parseArguments(argc, argv, arguments))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    const auto loaded = trdp::config::loadSimulatorConfigFromXml(arguments.configPath);
+    if (loaded.hasErrors())
+    {
+        for (const auto &error : loaded.errors)
+        {
+            std::cerr << arguments.configPath << ": " << error << '\n';
+        }
+        return 2;
+    }
+
+    trdp::config::DatasetCodegenOptions options;
+    options.nameSpace = arguments.nameSpace;
+    options.source = std::filesystem::path(arguments.configPath).filename().string();
+    const auto result = trdp::config::generateDatasetHeader(loaded.config, options);
+    if (result.hasErrors())
+    {
+        for (const auto &error : result.errors)
+        {
+            std::cerr << error << '\n';
+        }
+        return 2;
+    }
+    for (const auto &skipped : result.skipped)
+    {
+        std::cerr << "warning: dataset " << skipped << '\n';
+    }
+
+    if (!writeHeader(arguments.outputPath, result.header))
+    {
+        std::cerr << "Cannot write " << arguments.outputPath << '\n';
+        return 2;
+    }
+    std::cout << "Generated " << result.generated.size() << " dataset codecs into " << arguments.outputPath << '\n';
+    return 0;
+}
@@ -0,0 +1,254 @@
+// Queries a PD recording written by `trdp_simulator --record`.
+//
+//   trdp_query [--comid N] [--from T] [--to T] [--limit N] [--hex] RECORDING.trec
+//   trdp_query --summary RECORDING.trec
+//
+// T is Unix time in seconds (fractions allowed) or +S, seconds after the first record.
+// Exit status: 0 on success, 2 on usage or I/O errors.
+
+#include "record/recording_reader.h"
+
+#include <arpa/inet.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace
+{
+struct Arguments
+{
+    std::string path;
+    std::uint32_t comId{0};
+    std::string from;
+    std::string to;
+    std::uint64_t limit{std::numeric_limits<std::uint64_t>::max()};
+    bool hex{false};
+    bool summary{false};
+};
+
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--comid N] [--from T] [--to T] [--limit N] [--hex] [--summary] FILE\n"
+                 "  --comid N   only telegrams of this ComID\n"
+                 "  --from T    first time to show, inclusive\n"
+                 "  --to T      end of the window, exclusive\n"
+                 "  --limit N   stop after N telegrams\n"
+                 "  --hex       print each payload in hex\n"
+                 "  --summary   print the segments and per-ComID totals instead of telegrams\n"
+                 "T is Unix time in seconds (e.g. 1760781600.25) or +S, seconds after the first record.\n";
+}
+
+bool parseNumber(const char *text, unsigned long long max, unsigned long long &out)
+{
+    char *end = nullptr;
+    errno = 0;
+    out = std::strtoull(text, &end, 10);
+    return errno == 0 && end != text && *end == '\0' && out <= max;
+}
+
+bool parseArguments(int argc, char **argv, Arguments &arguments)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool takesValue = arg == "--comid" || arg == "--from" || arg == "--to" || arg == "--limit";
+        if (takesValue && i + 1 >= argc)
+        {
+            std::cerr << arg << " needs a value\n";
+            return false;
+        }
+
+        unsigned long long number = 0U;
+        if (arg == "--comid")
+        {
+            if (!parseNumber(argv[++i], std::numeric_limits<std::uint32_t>::max(), number) || number == 0U)
+            {
+                std::cerr << "Invalid ComID " << argv[i] << '\n';
+                return false;
+            }
+            arguments.comId = static_cast<std::uint32_t>(number);
+        }
+        else if (arg == "--limit")
+        {
+            if (!parseNumber(argv[++i], std::numeric_limits<std::uint64_t>::max(), number) || number == 0U)
+            {
+                std::cerr << "Invalid limit " << argv[i] << '\n';
+                return false;
+            }
+            arguments.limit = number;
+        }
+        else if (arg == "--from")
+        {
+            arguments.from = argv[++i];
+        }
+        else if (arg == "--to")
+        {
+            arguments.to = argv[++i];
+        }
+        else if (arg == "--hex")
+        {
+            arguments.hex = true;
+        }
+        else if (arg == "--summary")
+        {
+            arguments.summary = true;
+        }
+        else if (arg == "-h" || arg == "--help")
+        {
+            return false;
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            std::cerr << "Unknown option " << arg << '\n';
+            return false;
+        }
+        else
+        {
+            arguments.path = arg;
+        }
+    }
+    return !arguments.path.empty();
+}
+
+/** Nanoseconds since the epoch for a --from/--to value; `origin` anchors the +S form. */
+std::optional<std::int64_t> parseTime(const std::string &text, std::int64_t origin)
+{
+    const bool relative = !text.empty() && text[0] == '+';
+    const char *start = text.c_str() + (relative ? 1 : 0);
+    char *end = nullptr;
+    const double seconds = std::strtod(start, &end);
+    if (end == start || *end != '\0' || !std::isfinite(seconds) || seconds < 0.0 || seconds > 9.2e9)
+    {
+        return std::nullopt;
+    }
+    return (relative ? origin : 0) + static_cast<std::int64_t>(std::llround(seconds * 1e9));
+}
+
+std::string formatTime(std::int64_t ns)
+{
+    const auto seconds = static_cast<std::time_t>(ns / 1000000000);
+    std::tm local{};
+    ::localtime_r(&seconds, &local);
+    std::ostringstream oss;
+    oss << std::put_time(&local, "%Y-%m-%d %H:%M:%S") << '.' << std::setw(6) << std::setfill('0')
+        << (ns % 1000000000) / 1000;
+    return oss.str();
+}
+
+std::string ipToString(std::uint32_t ip)
+{
+    in_addr address{htonl(ip)};
+    char text[INET_ADDRSTRLEN] = {};
+    return ::inet_ntop(AF_INET, &address, text, sizeof(text)) != nullptr ? text : "?";
+}
+
+void printSummary(const trdp::record::RecordingReader &reader)
+{
+    std::cout << "Telegrams: " << reader.recordCount() << " in " << reader.segmentCount() << " segments\n";
+    if (reader.firstNs())
+    {
+        std::cout << "From " << formatTime(*reader.firstNs()) << " to " << formatTime(*reader.lastNs()) << '\n';
+    }
+    const auto &codecs = reader.codecCounts();
+    std::cout << "Stored in " << reader.fileBytes() << " bytes for " << reader.recordBytes() << " bytes of records";
+    if (reader.fileBytes() != 0U)
+    {
+        std::cout << " (" << std::fixed << std::setprecision(1)
+                  << static_cast<double>(reader.recordBytes()) / static_cast<double>(reader.fileBytes()) << "x)";
+    }
+    std::cout << "; segments raw " << codecs[0] << ", delta " << codecs[1] << ", lz " << codecs[2] << '\n';
+    if (reader.trailingBytes() != 0U)
+    {
+        std::cout << reader.trailingBytes() << " bytes after the last complete segment were ignored\n";
+    }
+
+    std::cout << '\n' << std::left << std::setw(12) << "ComID" << std::right << std::setw(12) << "telegrams"
+              << "  " << std::left << std::setw(28) << "first" << "last\n";
+    for (const auto &entry : reader.comIds())
+    {
+        std::cout << std::left << std::setw(12) << entry.comId << std::right << std::setw(12) << entry.count << "  "
+                  << std::left << std::setw(28) << formatTime(entry.firstNs) << formatTime(entry.lastNs) << '\n';
+    }
+}
+
+void printRecord(const trdp::record::PdRecordView &record, bool hex)
+{
+    std::cout << formatTime(record.timeNs) << "  ComID " << record.comId << "  seq " << record.sequence << "  "
+              << ipToString(record.srcIp) << " -> " << ipToString(record.destIp) << "  " << record.payloadBytes
+              << " bytes\n";
+    if (!hex)
+    {
+        return;
+    }
+    std::ostringstream line;
+    line << std::hex << std::setfill('0');
+    for (std::uint32_t i = 0U; i < record.payloadBytes; ++i)
+    {
+        line << (i % 32U == 0U ? "    " : " ") << std::setw(2) << static_cast<unsigned>(record.payload[i]);
+        if (i % 32U == 31U || i + 1U == record.payloadBytes)
+        {
+            line << '\n';
+        }
+    }
+    std::cout << line.str();
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Arguments arguments;
+    if (!parseArguments(argc, argv, arguments))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    trdp::record::RecordingReader reader;
+    std::string error;
+    if (!reader.open(arguments.path, error))
+    {
+        std::cerr << error << '\n';
+        return 2;
+    }
+    if (arguments.summary)
+    {
+        printSummary(reader);
+        return 0;
+    }
+
+    trdp::record::RecordingQuery query;
+    query.comId = arguments.comId;
+    const auto origin = reader.firstNs().value_or(0);
+    for (const auto &[text, bound] : {std::pair{&arguments.from, &query.fromNs}, std::pair{&arguments.to, &query.toNs}})
+    {
+        if (text->empty())
+        {
+            continue;
+        }
+        const auto parsed = parseTime(*text, origin);
+        if (!parsed)
+        {
+            std::cerr << "Invalid time " << *text << '\n';
+            return 2;
+        }
+        *bound = *parsed;
+    }
+
+    std::uint64_t shown = 0U;
+    reader.query(query, [&](const trdp::record::PdRecordView &record) {
+        printRecord(record, arguments.hex);
+        return ++shown < arguments.limit;
+    });
+    std::cerr << shown << " telegram(s)\n";
+    return 0;
+}